@@ -0,0 +1,261 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QImage>
+#include <QPixmap>
+#include "../usagi/src/animecardmodel.h"
+#include "../usagi/src/mylistcardmanager.h"
+#include "../usagi/src/main.h"
+
+/**
+ * Tests for AnimeCardModel over MyListCardManager's card data cache:
+ *   - reload() takes over the manager's anime order, rowForAnime() follows it
+ *   - Display roles and the hidden flag come from the cached card data
+ *   - cardUpdated drops only that anime's cached entry and repaints its row
+ *   - posterThumbnailReady fills PosterRole of cached rows and repaints them
+ */
+class TestAnimeCardModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testReloadFollowsManagerOrder();
+    void testDisplayAndHiddenRoles();
+    void testCardUpdatedDropsOnlyThatRow();
+    void testPosterThumbnailFillsPosterRole();
+
+private:
+    MyListCardManager *manager = nullptr;
+    AnimeCardModel *model = nullptr;
+    QSqlDatabase db;
+
+    void createTestDatabase();
+    void insertTestAnime(int aid, const QString &name, bool hidden = false);
+    void showAnime(const QList<int> &aids);
+};
+
+namespace {
+    QImage posterImage()
+    {
+        QImage image(AnimeCardModel::POSTER_WIDTH, AnimeCardModel::POSTER_HEIGHT, QImage::Format_RGB32);
+        image.fill(Qt::darkBlue);
+        return image;
+    }
+}
+
+void TestAnimeCardModel::initTestCase()
+{
+    qputenv("USAGI_TEST_MODE", "1");
+    adbapi = new myAniDBApi("test", 1);
+
+    // MyListCardManager uses the default connection
+    {
+        QString defaultConn = QSqlDatabase::defaultConnection;
+        if (QSqlDatabase::contains(defaultConn)) {
+            QSqlDatabase existingDb = QSqlDatabase::database(defaultConn, false);
+            if (existingDb.isOpen()) {
+                existingDb.close();
+            }
+            QSqlDatabase::removeDatabase(defaultConn);
+        }
+    }
+
+    db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    if (!db.open()) {
+        QFAIL("Could not open test database");
+    }
+    createTestDatabase();
+}
+
+void TestAnimeCardModel::cleanupTestCase()
+{
+    delete adbapi;
+    adbapi = nullptr;
+
+    if (db.isOpen()) {
+        db.close();
+    }
+    db = QSqlDatabase();
+
+    QString defaultConn = QSqlDatabase::defaultConnection;
+    if (QSqlDatabase::contains(defaultConn)) {
+        QSqlDatabase::removeDatabase(defaultConn);
+    }
+}
+
+void TestAnimeCardModel::init()
+{
+    QSqlQuery q(db);
+    q.exec("DELETE FROM anime");
+    q.exec("DELETE FROM anime_titles");
+
+    manager = new MyListCardManager();
+    model = new AnimeCardModel(manager);
+}
+
+void TestAnimeCardModel::cleanup()
+{
+    delete model;
+    delete manager;
+}
+
+void TestAnimeCardModel::createTestDatabase()
+{
+    QSqlQuery q(db);
+    QVERIFY2(q.exec("CREATE TABLE anime ("
+                    "aid INTEGER PRIMARY KEY, "
+                    "nameromaji TEXT, "
+                    "nameenglish TEXT, "
+                    "eptotal INTEGER, "
+                    "eps INTEGER, "
+                    "typename TEXT, "
+                    "startdate TEXT, "
+                    "enddate TEXT, "
+                    "picname TEXT, "
+                    "poster_image BLOB, "
+                    "category TEXT, "
+                    "rating TEXT, "
+                    "tag_name_list TEXT, "
+                    "tag_id_list TEXT, "
+                    "tag_weight_list TEXT, "
+                    "hidden INTEGER DEFAULT 0, "
+                    "is_18_restricted INTEGER DEFAULT 0, "
+                    "relaidlist TEXT, "
+                    "relaidtype TEXT)"), qPrintable(q.lastError().text()));
+    QVERIFY(q.exec("CREATE TABLE anime_titles (aid INTEGER, type INTEGER, language TEXT, title TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE episode (eid INTEGER PRIMARY KEY, aid INTEGER, epno TEXT, name TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE file (fid INTEGER PRIMARY KEY, filename TEXT, resolution TEXT, "
+                   "quality TEXT, airdate INTEGER, state INTEGER)"));
+    QVERIFY(q.exec("CREATE TABLE `group` (gid INTEGER PRIMARY KEY, name TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE local_files (id INTEGER PRIMARY KEY, path TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE watched_episodes (eid INTEGER PRIMARY KEY)"));
+    QVERIFY(q.exec("CREATE TABLE mylist (lid INTEGER PRIMARY KEY, aid INTEGER, eid INTEGER, fid INTEGER, "
+                   "gid INTEGER, state INTEGER, viewed INTEGER, storage TEXT, local_file INTEGER, "
+                   "last_played INTEGER, local_watched INTEGER)"));
+}
+
+void TestAnimeCardModel::insertTestAnime(int aid, const QString &name, bool hidden)
+{
+    QSqlQuery q(db);
+    q.prepare("INSERT INTO anime (aid, nameromaji, eptotal, typename, startdate, enddate, hidden) "
+              "VALUES (?, ?, 12, 'TV Series', '2020-01-01', '2020-03-31', ?)");
+    q.addBindValue(aid);
+    q.addBindValue(name);
+    q.addBindValue(hidden ? 1 : 0);
+    QVERIFY2(q.exec(), qPrintable(q.lastError().text()));
+}
+
+void TestAnimeCardModel::showAnime(const QList<int> &aids)
+{
+    manager->preloadCardCreationData(aids);
+    manager->setAnimeIdList(aids, false);
+    model->reload();
+}
+
+void TestAnimeCardModel::testReloadFollowsManagerOrder()
+{
+    insertTestAnime(1, "Anime One");
+    insertTestAnime(2, "Anime Two");
+    insertTestAnime(3, "Anime Three");
+
+    QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+    showAnime({3, 1, 2});
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(model->data(model->index(0), AnimeCardModel::AnimeIdRole).toInt(), 3);
+    QCOMPARE(model->data(model->index(2), AnimeCardModel::AnimeIdRole).toInt(), 2);
+    QCOMPARE(model->rowForAnime(3), 0);
+    QCOMPARE(model->rowForAnime(1), 1);
+    QCOMPARE(model->rowForAnime(2), 2);
+    QCOMPARE(model->rowForAnime(99), -1);
+
+    // A filtered list: rows that are no longer shown are gone
+    manager->setAnimeIdList({2}, false);
+    model->reload();
+    QCOMPARE(resetSpy.count(), 2);
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->rowForAnime(2), 0);
+    QCOMPARE(model->rowForAnime(3), -1);
+    QVERIFY(!model->data(model->index(1), AnimeCardModel::AnimeIdRole).isValid());
+}
+
+void TestAnimeCardModel::testDisplayAndHiddenRoles()
+{
+    insertTestAnime(1, "Anime One");
+    insertTestAnime(2, "Anime Two", true);
+    showAnime({1, 2});
+
+    QCOMPARE(model->data(model->index(0), Qt::DisplayRole).toString(), QString("Anime One"));
+    QCOMPARE(model->data(model->index(0), AnimeCardModel::TypeRole).toString(), QString("TV Series"));
+    QCOMPARE(model->data(model->index(0), AnimeCardModel::HiddenRole).toBool(), false);
+    QCOMPARE(model->data(model->index(1), AnimeCardModel::HiddenRole).toBool(), true);
+}
+
+void TestAnimeCardModel::testCardUpdatedDropsOnlyThatRow()
+{
+    insertTestAnime(1, "Anime One");
+    insertTestAnime(2, "Anime Two");
+    showAnime({1, 2});
+
+    // Cache the display data of both rows
+    QCOMPARE(model->data(model->index(0), Qt::DisplayRole).toString(), QString("Anime One"));
+    QCOMPARE(model->data(model->index(1), Qt::DisplayRole).toString(), QString("Anime Two"));
+
+    // Both anime change in the manager's cache, only the second one is reported
+    QSqlQuery q(db);
+    QVERIFY(q.exec("UPDATE anime SET nameromaji = nameromaji || ' Renamed'"));
+    manager->preloadCardCreationData({1, 2});
+
+    QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+    emit manager->cardUpdated(2);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(changedSpy.first().at(1).value<QModelIndex>().row(), 1);
+
+    // Row 0 still paints its cached entry, row 1 was rebuilt
+    QCOMPARE(model->data(model->index(0), Qt::DisplayRole).toString(), QString("Anime One"));
+    QCOMPARE(model->data(model->index(1), Qt::DisplayRole).toString(), QString("Anime Two Renamed"));
+
+    // Updates of anime that are not shown repaint nothing
+    changedSpy.clear();
+    emit manager->cardUpdated(99);
+    QCOMPARE(changedSpy.count(), 0);
+}
+
+void TestAnimeCardModel::testPosterThumbnailFillsPosterRole()
+{
+    insertTestAnime(1, "Anime One");
+    insertTestAnime(2, "Anime Two");
+    showAnime({1, 2});
+
+    // Painted with the placeholder until the thumbnail arrives
+    QVERIFY(model->data(model->index(0), AnimeCardModel::PosterRole).value<QPixmap>().isNull());
+
+    QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+    emit manager->posterThumbnailReady(1, posterImage());
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().at(0).value<QModelIndex>().row(), 0);
+    const QList<int> roles = changedSpy.first().at(2).value<QList<int>>();
+    QCOMPARE(roles, QList<int>{AnimeCardModel::PosterRole});
+
+    const QPixmap poster = model->data(model->index(0), AnimeCardModel::PosterRole).value<QPixmap>();
+    QCOMPARE(poster.size(), QSize(AnimeCardModel::POSTER_WIDTH, AnimeCardModel::POSTER_HEIGHT));
+    QCOMPARE(model->data(model->index(0), Qt::DisplayRole).toString(), QString("Anime One"));
+
+    // Rows without cached display data ignore thumbnails; they request their own when painted
+    changedSpy.clear();
+    emit manager->posterThumbnailReady(2, posterImage());
+    QCOMPARE(changedSpy.count(), 0);
+    QVERIFY(model->data(model->index(1), AnimeCardModel::PosterRole).value<QPixmap>().isNull());
+}
+
+QTEST_MAIN(TestAnimeCardModel)
+#include "test_animecardmodel.moc"
@@ -0,0 +1,432 @@
+#include <QTest>
+#include <QSet>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "../usagi/src/roaringbitmap.h"
+#include "../usagi/src/titlesearchindex.h"
+#include "../usagi/src/animefilterindex.h"
+#include "../usagi/src/animefilter.h"
+#include "../usagi/src/animemetadatacache.h"
+#include "../usagi/src/animestats.h"
+#include "../usagi/src/cachedanimedata.h"
+
+/**
+ * Tests for the bitmap filter engine:
+ *   - RoaringBitmap: point operations, array/bitmap containers, set operations
+ *   - TitleSearchIndex: trigram candidate search with exact verification
+ *   - AnimeFilterIndex: incremental updates and equivalence with CompositeFilter
+ *   - Benchmark: filtering 25k anime
+ */
+class TestAnimeFilterIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // RoaringBitmap
+    void testBitmapPointOperations();
+    void testBitmapContainerConversion();
+    void testBitmapSetOperations();
+    void testBitmapMultipleContainers();
+
+    // TitleSearchIndex
+    void testTitleSearch();
+    void testTitleSearchShortText();
+    void testTitleSearchUpdateAndRemove();
+    void testMetadataCacheFindMatching();
+
+    // AnimeFilterIndex
+    void testIndexUpdateMovesBitmaps();
+    void testIndexRemove();
+    void testMatchesCompositeFilter_data();
+    void testMatchesCompositeFilter();
+
+    // Benchmark
+    void benchmarkFilter();
+
+private:
+    struct SyntheticAnime {
+        int aid;
+        QString title;
+        QString type;
+        bool adult;
+        int eptotal;
+        AnimeStats stats;
+    };
+    static QList<SyntheticAnime> syntheticAnime(int count);
+    static AnimeFilterIndex::Entry entryFor(const SyntheticAnime &anime);
+    static QSet<int> toSet(const RoaringBitmap &bitmap);
+};
+
+QList<TestAnimeFilterIndex::SyntheticAnime> TestAnimeFilterIndex::syntheticAnime(int count)
+{
+    static const QStringList types = {"TV Series", "Movie", "OVA", "Web", "TV Special"};
+    static const QStringList words = {"Sword", "Star", "Moon", "Sky", "Girls", "Academy", "Dragon", "Ghost", "Shell", "Bebop"};
+    QRandomGenerator rng(1234);
+
+    QList<SyntheticAnime> anime;
+    anime.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        SyntheticAnime a;
+        a.aid = 1 + i * 3;  // spread across several containers for large counts
+        a.title = QString("%1 %2 %3").arg(words.at(rng.bounded(words.size())),
+                                           words.at(rng.bounded(words.size())))
+                                      .arg(rng.bounded(100));
+        a.type = types.at(rng.bounded(types.size()));
+        a.adult = rng.bounded(10) == 0;
+        a.eptotal = rng.bounded(3) == 0 ? 0 : rng.bounded(1, 30);
+        const int normal = rng.bounded(0, 30);
+        const int other = rng.bounded(0, 4);
+        a.stats = AnimeStats(normal, a.eptotal, rng.bounded(normal + 1), other, rng.bounded(other + 1));
+        anime.append(a);
+    }
+    return anime;
+}
+
+AnimeFilterIndex::Entry TestAnimeFilterIndex::entryFor(const SyntheticAnime &anime)
+{
+    AnimeFilterIndex::Entry entry;
+    entry.title = anime.title;
+    entry.typeName = anime.type;
+    entry.is18Restricted = anime.adult;
+    entry.normalEpisodes = anime.stats.normalEpisodes();
+    entry.normalViewed = anime.stats.normalViewed();
+    entry.otherEpisodes = anime.stats.otherEpisodes();
+    entry.otherViewed = anime.stats.otherViewed();
+    entry.totalEpisodes = anime.eptotal > 0 ? anime.eptotal : anime.stats.totalNormalEpisodes();
+    return entry;
+}
+
+QSet<int> TestAnimeFilterIndex::toSet(const RoaringBitmap &bitmap)
+{
+    const QList<int> values = bitmap.toList();
+    return QSet<int>(values.cbegin(), values.cend());
+}
+
+// ---------------------------------------------------------------------------
+// RoaringBitmap
+// ---------------------------------------------------------------------------
+
+void TestAnimeFilterIndex::testBitmapPointOperations()
+{
+    RoaringBitmap bitmap;
+    QVERIFY(bitmap.isEmpty());
+
+    bitmap.add(5);
+    bitmap.add(1);
+    bitmap.add(5);
+    QCOMPARE(bitmap.cardinality(), quint64(2));
+    QVERIFY(bitmap.contains(1));
+    QVERIFY(bitmap.contains(5));
+    QVERIFY(!bitmap.contains(2));
+    QCOMPARE(bitmap.toList(), QList<int>({1, 5}));
+
+    QVERIFY(bitmap.remove(1));
+    QVERIFY(!bitmap.remove(1));
+    QCOMPARE(bitmap.toList(), QList<int>({5}));
+
+    QVERIFY(bitmap.remove(5));
+    QVERIFY(bitmap.isEmpty());
+    QCOMPARE(bitmap.containerCount(), 0);
+}
+
+void TestAnimeFilterIndex::testBitmapContainerConversion()
+{
+    RoaringBitmap bitmap;
+    for (quint32 v = 0; v < RoaringBitmap::ARRAY_MAX; ++v) {
+        bitmap.add(v * 2);
+    }
+    QCOMPARE(bitmap.bitmapContainerCount(), 0);
+
+    // One more value switches the container to a bitmap
+    bitmap.add(1);
+    QCOMPARE(bitmap.bitmapContainerCount(), 1);
+    QCOMPARE(bitmap.cardinality(), quint64(RoaringBitmap::ARRAY_MAX + 1));
+    QVERIFY(bitmap.contains(1));
+    QVERIFY(bitmap.contains(8190));
+    QVERIFY(!bitmap.contains(3));
+
+    // Dropping back to the threshold switches back to an array
+    QVERIFY(bitmap.remove(1));
+    QCOMPARE(bitmap.bitmapContainerCount(), 0);
+    QCOMPARE(bitmap.cardinality(), quint64(RoaringBitmap::ARRAY_MAX));
+
+    const QList<int> values = bitmap.toList();
+    QCOMPARE(values.first(), 0);
+    QCOMPARE(values.last(), int(2 * (RoaringBitmap::ARRAY_MAX - 1)));
+    QVERIFY(std::is_sorted(values.cbegin(), values.cend()));
+}
+
+void TestAnimeFilterIndex::testBitmapSetOperations()
+{
+    // Mix of sparse and dense sets so every container pairing is exercised
+    QRandomGenerator rng(99);
+    const QList<int> densities = {50, 3000, 9000, 40000};
+
+    for (int densityA : densities) {
+        for (int densityB : densities) {
+            QSet<int> setA, setB;
+            RoaringBitmap a, b;
+            for (int i = 0; i < densityA; ++i) {
+                const int v = rng.bounded(65536);
+                setA.insert(v);
+                a.add(static_cast<quint32>(v));
+            }
+            for (int i = 0; i < densityB; ++i) {
+                const int v = rng.bounded(65536);
+                setB.insert(v);
+                b.add(static_cast<quint32>(v));
+            }
+
+            QCOMPARE(toSet(a & b), QSet<int>(setA).intersect(setB));
+            QCOMPARE(toSet(a | b), QSet<int>(setA).unite(setB));
+            QCOMPARE(toSet(a.andNot(b)), QSet<int>(setA).subtract(setB));
+            QCOMPARE((a & b).cardinality(), quint64(QSet<int>(setA).intersect(setB).size()));
+            QVERIFY((a | b) == (b | a));
+        }
+    }
+}
+
+void TestAnimeFilterIndex::testBitmapMultipleContainers()
+{
+    const QList<int> values = {3, 70000, 65535, 65536, 200000, 1};
+    RoaringBitmap bitmap = RoaringBitmap::fromList(values);
+    QCOMPARE(bitmap.containerCount(), 3);
+    QCOMPARE(bitmap.toList(), QList<int>({1, 3, 65535, 65536, 70000, 200000}));
+
+    RoaringBitmap other = RoaringBitmap::fromList({65536, 200000, 300000});
+    QCOMPARE((bitmap & other).toList(), QList<int>({65536, 200000}));
+    QCOMPARE(bitmap.andNot(other).toList(), QList<int>({1, 3, 65535, 70000}));
+    QCOMPARE((bitmap | other).cardinality(), quint64(7));
+}
+
+// ---------------------------------------------------------------------------
+// TitleSearchIndex
+// ---------------------------------------------------------------------------
+
+void TestAnimeFilterIndex::testTitleSearch()
+{
+    TitleSearchIndex index;
+    index.setTitles(1, {"Cowboy Bebop", "Kauboi Bibappu"});
+    index.setTitles(2, {"Ghost in the Shell"});
+    index.setTitles(3, {"Bebop Ghost"});
+
+    QCOMPARE(index.search("bebop").toList(), QList<int>({1, 3}));
+    QCOMPARE(index.search("GHOST").toList(), QList<int>({2, 3}));
+    QCOMPARE(index.search("in the shell").toList(), QList<int>({2}));
+    QVERIFY(index.search("nonexistent").isEmpty());
+
+    // All trigrams of "op gh" exist ("bebop", "ghost") but only aid 3 contains the substring
+    QCOMPARE(index.search("op gh").toList(), QList<int>({3}));
+
+    RoaringBitmap within = RoaringBitmap::fromList({2});
+    QCOMPARE(index.search("ghost", &within).toList(), QList<int>({2}));
+
+    QVERIFY(index.matches(1, "bibappu"));
+    QVERIFY(!index.matches(2, "bebop"));
+    QVERIFY(index.matches(2, ""));
+}
+
+void TestAnimeFilterIndex::testTitleSearchShortText()
+{
+    TitleSearchIndex index;
+    index.setTitles(1, {"K-On!"});
+    index.setTitles(2, {"Kanon"});
+    index.setTitles(3, {"Akira"});
+
+    QCOMPARE(index.search("k-").toList(), QList<int>({1}));
+    QCOMPARE(index.search("on").toList(), QList<int>({1, 2}));
+    QCOMPARE(index.search("").toList(), QList<int>({1, 2, 3}));
+}
+
+void TestAnimeFilterIndex::testTitleSearchUpdateAndRemove()
+{
+    TitleSearchIndex index;
+    index.setTitles(1, {"Old Title"});
+    QCOMPARE(index.search("old").toList(), QList<int>({1}));
+
+    index.setTitles(1, {"New Name"});
+    QVERIFY(index.search("old").isEmpty());
+    QCOMPARE(index.search("new").toList(), QList<int>({1}));
+
+    index.remove(1);
+    QVERIFY(index.search("new").isEmpty());
+    QCOMPARE(index.size(), 0);
+}
+
+void TestAnimeFilterIndex::testMetadataCacheFindMatching()
+{
+    AnimeMetadataCache cache;
+    const QList<SyntheticAnime> anime = syntheticAnime(300);
+    for (const SyntheticAnime &a : anime) {
+        cache.addAnime(a.aid, {a.title, a.type});
+    }
+
+    for (const QString &text : {QString("sword"), QString("Sky Moon"), QString("ov"), QString("x")}) {
+        QSet<int> expected;
+        for (const SyntheticAnime &a : anime) {
+            if (cache.matchesAnyTitle(a.aid, text)) {
+                expected.insert(a.aid);
+            }
+        }
+        QCOMPARE(toSet(cache.findMatching(text)), expected);
+    }
+
+    cache.removeAnime(anime.first().aid);
+    QVERIFY(!cache.findMatching(anime.first().title).contains(static_cast<quint32>(anime.first().aid)));
+}
+
+// ---------------------------------------------------------------------------
+// AnimeFilterIndex
+// ---------------------------------------------------------------------------
+
+void TestAnimeFilterIndex::testIndexUpdateMovesBitmaps()
+{
+    AnimeFilterIndex index;
+    AnimeFilterIndex::Entry entry;
+    entry.title = "Test";
+    entry.typeName = "TV Series";
+    entry.normalEpisodes = 12;
+    entry.totalEpisodes = 12;
+    index.update(7, entry);
+
+    QVERIFY(index.typeBitmap("TV Series").contains(7));
+    QVERIFY(index.completionBitmap(CompletionFilter::CompletionStatus::NotStarted).contains(7));
+    QVERIFY(index.unwatchedBitmap().contains(7));
+    QVERIFY(!index.adultBitmap().contains(7));
+
+    // Watching all episodes and changing the type moves the anime between bitmaps
+    entry.typeName = "Movie";
+    entry.normalViewed = 12;
+    entry.is18Restricted = true;
+    index.update(7, entry);
+
+    QVERIFY(index.typeBitmap("TV Series").isEmpty());
+    QVERIFY(index.typeBitmap("Movie").contains(7));
+    QVERIFY(!index.completionBitmap(CompletionFilter::CompletionStatus::NotStarted).contains(7));
+    QVERIFY(index.completionBitmap(CompletionFilter::CompletionStatus::Completed).contains(7));
+    QVERIFY(!index.unwatchedBitmap().contains(7));
+    QVERIFY(index.adultBitmap().contains(7));
+    QCOMPARE(index.size(), 1);
+}
+
+void TestAnimeFilterIndex::testIndexRemove()
+{
+    AnimeFilterIndex index;
+    AnimeFilterIndex::Entry entry;
+    entry.title = "Test";
+    entry.typeName = "OVA";
+    entry.is18Restricted = true;
+    index.update(3, entry);
+    index.remove(3);
+
+    QVERIFY(!index.contains(3));
+    QVERIFY(index.all().isEmpty());
+    QVERIFY(index.typeBitmap("OVA").isEmpty());
+    QVERIFY(index.adultBitmap().isEmpty());
+
+    AnimeFilterIndex::Criteria criteria;
+    criteria.searchText = "test";
+    QVERIFY(index.matching(criteria).isEmpty());
+}
+
+void TestAnimeFilterIndex::testMatchesCompositeFilter_data()
+{
+    QTest::addColumn<QString>("searchText");
+    QTest::addColumn<QString>("typeFilter");
+    QTest::addColumn<QString>("completionFilter");
+    QTest::addColumn<bool>("showOnlyUnwatched");
+    QTest::addColumn<QString>("adultContentFilter");
+
+    QTest::newRow("none") << "" << "" << "" << false << "ignore";
+    QTest::newRow("type") << "" << "Movie" << "" << false << "ignore";
+    QTest::newRow("unknown type") << "" << "Manga" << "" << false << "ignore";
+    QTest::newRow("completed") << "" << "" << "completed" << false << "ignore";
+    QTest::newRow("watching unwatched") << "" << "" << "watching" << true << "ignore";
+    QTest::newRow("notstarted hide adult") << "" << "" << "notstarted" << false << "hide";
+    QTest::newRow("adult only") << "" << "" << "" << false << "showonly";
+    QTest::newRow("search") << "dragon" << "" << "" << false << "ignore";
+    QTest::newRow("short search") << "sk" << "" << "" << false << "hide";
+    QTest::newRow("search alt title") << "alt-" << "" << "" << false << "ignore";
+    QTest::newRow("everything") << "moon" << "TV Series" << "watching" << true << "hide";
+}
+
+void TestAnimeFilterIndex::testMatchesCompositeFilter()
+{
+    QFETCH(QString, searchText);
+    QFETCH(QString, typeFilter);
+    QFETCH(QString, completionFilter);
+    QFETCH(bool, showOnlyUnwatched);
+    QFETCH(QString, adultContentFilter);
+
+    const QList<SyntheticAnime> anime = syntheticAnime(2000);
+    AnimeFilterIndex index;
+    AnimeMetadataCache alternativeTitles;
+    for (const SyntheticAnime &a : anime) {
+        index.update(a.aid, entryFor(a));
+        if (a.aid % 7 == 0) {
+            alternativeTitles.addAnime(a.aid, {QString("Alt-%1").arg(a.aid)});
+        }
+    }
+
+    // Reference: the per-anime virtual filter evaluation
+    CompositeFilter composite;
+    if (!searchText.isEmpty()) {
+        composite.addFilter(new SearchFilter(searchText, &alternativeTitles));
+    }
+    if (!typeFilter.isEmpty()) {
+        composite.addFilter(new TypeFilter(typeFilter));
+    }
+    if (!completionFilter.isEmpty()) {
+        composite.addFilter(new CompletionFilter(completionFilter));
+    }
+    if (showOnlyUnwatched) {
+        composite.addFilter(new UnwatchedFilter(true));
+    }
+    composite.addFilter(new AdultContentFilter(adultContentFilter));
+
+    QSet<int> expected;
+    for (const SyntheticAnime &a : anime) {
+        CachedAnimeData cached(a.title, a.type, QString(), QString(), false, a.adult, a.eptotal, a.stats, 0);
+        AnimeDataAccessor accessor(a.aid, nullptr, cached);
+        if (composite.matches(accessor)) {
+            expected.insert(a.aid);
+        }
+    }
+
+    AnimeFilterIndex::Criteria criteria;
+    criteria.searchText = searchText;
+    criteria.typeFilter = typeFilter;
+    criteria.completionFilter = completionFilter;
+    criteria.showOnlyUnwatched = showOnlyUnwatched;
+    criteria.adultContentFilter = adultContentFilter;
+
+    QCOMPARE(toSet(index.matching(criteria, &alternativeTitles)), expected);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+void TestAnimeFilterIndex::benchmarkFilter()
+{
+    const QList<SyntheticAnime> anime = syntheticAnime(25000);
+    AnimeFilterIndex index;
+    for (const SyntheticAnime &a : anime) {
+        index.update(a.aid, entryFor(a));
+    }
+
+    AnimeFilterIndex::Criteria criteria;
+    criteria.searchText = "dragon";
+    criteria.typeFilter = "TV Series";
+    criteria.completionFilter = "watching";
+    criteria.adultContentFilter = "hide";
+
+    RoaringBitmap result;
+    QBENCHMARK {
+        result = index.matching(criteria);
+    }
+    QVERIFY(result.cardinality() < quint64(anime.size()));
+}
+
+QTEST_MAIN(TestAnimeFilterIndex)
+#include "test_animefilterindex.moc"
@@ -0,0 +1,445 @@
+#include <QTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "../usagi/src/animemetadatastore.h"
+
+/**
+ * Tests for the columnar anime metadata store:
+ *   - Column parsing (dates, ratings) and row maintenance (upsert, remove, hidden flag)
+ *   - Flat sort kernel semantics matching the mylist card view:
+ *     hidden anime last, anime without a value after those with one, ties by title
+ *   - Benchmark: sorting 25k anime by each AnimeChain::SortCriteria
+ */
+class TestAnimeMetadataStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Parsers
+    void testParseDate();
+    void testParseRating();
+
+    // Row maintenance
+    void testUpsertAndColumns();
+    void testUpsertUpdatesExistingRow();
+    void testRemoveKeepsRowsDense();
+    void testSetHidden();
+
+    // Sort kernels
+    void testSortByTitle();
+    void testSortByTypeTiesByTitle();
+    void testSortByDateUnknownLast();
+    void testSortByEpisodeCount();
+    void testSortByCompletion();
+    void testSortByLastPlayedNeverPlayedLast();
+    void testSortByRecentEpisodeAirDate();
+    void testHiddenAlwaysLast_data();
+    void testHiddenAlwaysLast();
+    void testUnknownAidsKeepOrderAtEnd();
+
+    // Benchmark
+    void benchmarkSort_data();
+    void benchmarkSort();
+
+private:
+    static AnimeMetadataStore::Row makeRow(int aid, const QString &title);
+    static void fillSyntheticStore(AnimeMetadataStore &store, int count);
+};
+
+AnimeMetadataStore::Row TestAnimeMetadataStore::makeRow(int aid, const QString &title)
+{
+    AnimeMetadataStore::Row row;
+    row.aid = aid;
+    row.title = title;
+    row.typeName = "TV Series";
+    row.startDate = "2010-01-01Z";
+    return row;
+}
+
+void TestAnimeMetadataStore::fillSyntheticStore(AnimeMetadataStore &store, int count)
+{
+    static const QStringList types = {"TV Series", "Movie", "OVA", "Web", "TV Special", "Music Video", "Other"};
+    QRandomGenerator rng(42);
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    for (int aid = 1; aid <= count; ++aid) {
+        AnimeMetadataStore::Row row;
+        row.aid = aid;
+        row.title = QString("Anime Title %1").arg(rng.bounded(count * 4));
+        row.typeName = types.at(rng.bounded(types.size()));
+        if (rng.bounded(20) != 0) {
+            const QDate start = QDate(1980, 1, 1).addDays(rng.bounded(16000));
+            row.startDate = start.toString(Qt::ISODate) + "Z";
+            row.endDate = start.addDays(rng.bounded(400)).toString(Qt::ISODate) + "Z";
+        }
+        row.rating = QString::number(rng.bounded(100, 1000));
+        row.eptotal = rng.bounded(1, 60);
+        row.normalEpisodes = rng.bounded(row.eptotal + 1);
+        row.normalViewed = rng.bounded(row.normalEpisodes + 1);
+        row.otherEpisodes = rng.bounded(5);
+        row.otherViewed = rng.bounded(row.otherEpisodes + 1);
+        row.lastPlayed = rng.bounded(3) == 0 ? 0 : now - rng.bounded(100000000);
+        row.recentEpisodeAirDate = rng.bounded(10) == 0 ? 0 : now - 50000000 + rng.bounded(60000000);
+        row.hidden = rng.bounded(50) == 0;
+        row.adult = rng.bounded(30) == 0;
+        store.upsert(row);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Parsers
+// ---------------------------------------------------------------------------
+
+void TestAnimeMetadataStore::testParseDate()
+{
+    QCOMPARE(AnimeMetadataStore::parseDate("2003-11-16Z"), 20031116);
+    QCOMPARE(AnimeMetadataStore::parseDate("2003-11-16"), 20031116);
+    QCOMPARE(AnimeMetadataStore::parseDate(""), 0);
+    QCOMPARE(AnimeMetadataStore::parseDate("2003-02-30"), 0);
+    QCOMPARE(AnimeMetadataStore::parseDate("2003-1-16"), 0);
+    QCOMPARE(AnimeMetadataStore::parseDate("20031116"), 0);
+    QCOMPARE(AnimeMetadataStore::parseDate("abcd-11-16"), 0);
+}
+
+void TestAnimeMetadataStore::testParseRating()
+{
+    QCOMPARE(AnimeMetadataStore::parseRating("8.53"), 853);
+    QCOMPARE(AnimeMetadataStore::parseRating("853"), 853);
+    QCOMPARE(AnimeMetadataStore::parseRating(""), 0);
+    QCOMPARE(AnimeMetadataStore::parseRating("n/a"), 0);
+}
+
+// ---------------------------------------------------------------------------
+// Row maintenance
+// ---------------------------------------------------------------------------
+
+void TestAnimeMetadataStore::testUpsertAndColumns()
+{
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(10, "Cowboy Bebop");
+    row.typeName = "Movie";
+    row.startDate = "2001-09-01Z";
+    row.rating = "8.21";
+    row.normalEpisodes = 1;
+    row.adult = true;
+    store.upsert(row);
+
+    QCOMPARE(store.size(), 1);
+    QVERIFY(store.contains(10));
+    const int i = store.indexOf(10);
+    QCOMPARE(i, 0);
+    QCOMPARE(store.aidAt(i), 10);
+    QCOMPARE(store.startDates()[i], 20010901);
+    QCOMPARE(store.endDates()[i], 0);
+    QCOMPARE(store.ratings()[i], 821);
+    QCOMPARE(store.normalEpisodes()[i], 1);
+    QCOMPARE(store.typeName(store.typeCodes()[i]), QString("Movie"));
+    QCOMPARE(store.typeCodeFor("Movie"), int(store.typeCodes()[i]));
+    QCOMPARE(store.typeCodeFor("OVA"), -1);
+    QVERIFY(store.isAdult(i));
+    QVERIFY(!store.isHidden(i));
+}
+
+void TestAnimeMetadataStore::testUpsertUpdatesExistingRow()
+{
+    AnimeMetadataStore store;
+    store.upsert(makeRow(1, "B"));
+    store.upsert(makeRow(2, "C"));
+
+    QList<int> aids = {1, 2};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({1, 2}));
+
+    // Renaming must invalidate the cached title ranks
+    store.upsert(makeRow(2, "A"));
+    QCOMPARE(store.size(), 2);
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({2, 1}));
+}
+
+void TestAnimeMetadataStore::testRemoveKeepsRowsDense()
+{
+    AnimeMetadataStore store;
+    store.upsert(makeRow(1, "A"));
+    store.upsert(makeRow(2, "B"));
+    store.upsert(makeRow(3, "C"));
+
+    QVERIFY(store.remove(1));
+    QVERIFY(!store.remove(1));
+    QCOMPARE(store.size(), 2);
+    QVERIFY(!store.contains(1));
+
+    // The last row moved into the freed slot
+    QCOMPARE(store.indexOf(3), 0);
+    QCOMPARE(store.aidAt(store.indexOf(2)), 2);
+    QCOMPARE(store.aidAt(store.indexOf(3)), 3);
+    QCOMPARE(store.sorted({3, 2}, AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({2, 3}));
+
+    store.clear();
+    QCOMPARE(store.size(), 0);
+    QCOMPARE(store.typeCodeFor("TV Series"), -1);
+}
+
+void TestAnimeMetadataStore::testSetHidden()
+{
+    AnimeMetadataStore store;
+    store.upsert(makeRow(1, "A"));
+    store.upsert(makeRow(2, "B"));
+
+    store.setHidden(1, true);
+    QVERIFY(store.isHidden(store.indexOf(1)));
+    QCOMPARE(store.sorted({1, 2}, AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({2, 1}));
+
+    store.setHidden(1, false);
+    QVERIFY(!store.isHidden(store.indexOf(1)));
+    QCOMPARE(store.sorted({1, 2}, AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({1, 2}));
+
+    // Unknown aid is ignored
+    store.setHidden(99, true);
+    QCOMPARE(store.size(), 2);
+}
+
+// ---------------------------------------------------------------------------
+// Sort kernels
+// ---------------------------------------------------------------------------
+
+void TestAnimeMetadataStore::testSortByTitle()
+{
+    AnimeMetadataStore store;
+    store.upsert(makeRow(1, "Naruto"));
+    store.upsert(makeRow(2, "Bleach"));
+    store.upsert(makeRow(3, "One Piece"));
+
+    const QList<int> aids = {1, 2, 3};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({2, 1, 3}));
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeTitle, false), QList<int>({3, 1, 2}));
+}
+
+void TestAnimeMetadataStore::testSortByTypeTiesByTitle()
+{
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(1, "Zeta");
+    row.typeName = "TV Series";
+    store.upsert(row);
+    row = makeRow(2, "Alpha");
+    row.typeName = "TV Series";
+    store.upsert(row);
+    row = makeRow(3, "Mid");
+    row.typeName = "Movie";
+    store.upsert(row);
+
+    const QList<int> aids = {1, 2, 3};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeType, true), QList<int>({3, 2, 1}));
+    // Ties stay in ascending title order when descending
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeType, false), QList<int>({2, 1, 3}));
+}
+
+void TestAnimeMetadataStore::testSortByDateUnknownLast()
+{
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(1, "Late");
+    row.startDate = "2020-04-01Z";
+    store.upsert(row);
+    row = makeRow(2, "Early");
+    row.startDate = "1998-04-03Z";
+    store.upsert(row);
+    row = makeRow(3, "Unknown");
+    row.startDate = "";
+    store.upsert(row);
+    // Same start, earlier end date sorts first
+    row = makeRow(4, "Late Short");
+    row.startDate = "2020-04-01Z";
+    row.endDate = "2020-06-01Z";
+    store.upsert(row);
+    row = makeRow(5, "Late Long");
+    row.startDate = "2020-04-01Z";
+    row.endDate = "2021-06-01Z";
+    store.upsert(row);
+
+    const QList<int> aids = {1, 2, 3, 4, 5};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeDate, true), QList<int>({2, 1, 4, 5, 3}));
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeDate, false), QList<int>({5, 4, 1, 2, 3}));
+}
+
+void TestAnimeMetadataStore::testSortByEpisodeCount()
+{
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(1, "B");
+    row.normalEpisodes = 12;
+    store.upsert(row);
+    row = makeRow(2, "A");
+    row.normalEpisodes = 10;
+    row.otherEpisodes = 2;
+    store.upsert(row);
+    row = makeRow(3, "C");
+    row.normalEpisodes = 1;
+    store.upsert(row);
+
+    const QList<int> aids = {1, 2, 3};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeEpisodeCount, true), QList<int>({3, 2, 1}));
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeEpisodeCount, false), QList<int>({2, 1, 3}));
+}
+
+void TestAnimeMetadataStore::testSortByCompletion()
+{
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(1, "Half");
+    row.normalEpisodes = 4;
+    row.normalViewed = 2;
+    store.upsert(row);
+    row = makeRow(2, "Done");
+    row.normalEpisodes = 3;
+    row.normalViewed = 3;
+    store.upsert(row);
+    row = makeRow(3, "None");
+    store.upsert(row);
+    row = makeRow(4, "Also Half");
+    row.normalEpisodes = 10;
+    row.normalViewed = 4;
+    row.otherEpisodes = 2;
+    row.otherViewed = 2;
+    store.upsert(row);
+
+    const QList<int> aids = {1, 2, 3, 4};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeCompletion, true), QList<int>({3, 4, 1, 2}));
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeCompletion, false), QList<int>({2, 4, 1, 3}));
+}
+
+void TestAnimeMetadataStore::testSortByLastPlayedNeverPlayedLast()
+{
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(1, "Never B");
+    store.upsert(row);
+    row = makeRow(2, "Old");
+    row.lastPlayed = 1000;
+    store.upsert(row);
+    row = makeRow(3, "Recent");
+    row.lastPlayed = 5000;
+    store.upsert(row);
+    row = makeRow(4, "Never A");
+    store.upsert(row);
+
+    const QList<int> aids = {1, 2, 3, 4};
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeLastPlayed, true), QList<int>({2, 3, 4, 1}));
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeLastPlayed, false), QList<int>({3, 2, 4, 1}));
+}
+
+void TestAnimeMetadataStore::testSortByRecentEpisodeAirDate()
+{
+    const qint64 now = 1700000000;
+    AnimeMetadataStore store;
+    AnimeMetadataStore::Row row = makeRow(1, "Future");
+    row.recentEpisodeAirDate = now + 86400;
+    store.upsert(row);
+    row = makeRow(2, "No Date");
+    store.upsert(row);
+    row = makeRow(3, "Aired Old");
+    row.recentEpisodeAirDate = now - 86400 * 30;
+    store.upsert(row);
+    row = makeRow(4, "Aired New");
+    row.recentEpisodeAirDate = now - 86400;
+    store.upsert(row);
+
+    const QList<int> aids = {1, 2, 3, 4};
+    // Aired first, then no air date, then not yet aired - regardless of direction
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRecentEpisodeAirDate, true, now), QList<int>({3, 4, 2, 1}));
+    QCOMPARE(store.sorted(aids, AnimeChain::SortCriteria::ByRecentEpisodeAirDate, false, now), QList<int>({4, 3, 2, 1}));
+}
+
+void TestAnimeMetadataStore::testHiddenAlwaysLast_data()
+{
+    QTest::addColumn<int>("criteria");
+    QTest::addColumn<bool>("ascending");
+
+    const QList<QPair<const char*, AnimeChain::SortCriteria>> criteria = {
+        {"title", AnimeChain::SortCriteria::ByRepresentativeTitle},
+        {"type", AnimeChain::SortCriteria::ByRepresentativeType},
+        {"date", AnimeChain::SortCriteria::ByRepresentativeDate},
+        {"episodes", AnimeChain::SortCriteria::ByRepresentativeEpisodeCount},
+        {"completion", AnimeChain::SortCriteria::ByRepresentativeCompletion},
+        {"lastPlayed", AnimeChain::SortCriteria::ByRepresentativeLastPlayed},
+        {"recentAirDate", AnimeChain::SortCriteria::ByRecentEpisodeAirDate},
+    };
+    for (const auto &entry : criteria) {
+        QTest::newRow(QByteArray(entry.first).append(" asc").constData()) << static_cast<int>(entry.second) << true;
+        QTest::newRow(QByteArray(entry.first).append(" desc").constData()) << static_cast<int>(entry.second) << false;
+    }
+}
+
+void TestAnimeMetadataStore::testHiddenAlwaysLast()
+{
+    QFETCH(int, criteria);
+    QFETCH(bool, ascending);
+
+    AnimeMetadataStore store;
+    fillSyntheticStore(store, 500);
+    QList<int> aids;
+    for (int aid = 1; aid <= 500; ++aid) {
+        aids.append(aid);
+    }
+
+    const QList<int> result = store.sorted(aids, static_cast<AnimeChain::SortCriteria>(criteria), ascending);
+    QCOMPARE(result.size(), aids.size());
+
+    bool seenHidden = false;
+    for (int aid : result) {
+        const bool hidden = store.isHidden(store.indexOf(aid));
+        QVERIFY2(!seenHidden || hidden, qPrintable(QString("Visible aid %1 sorted after a hidden one").arg(aid)));
+        seenHidden = seenHidden || hidden;
+    }
+}
+
+void TestAnimeMetadataStore::testUnknownAidsKeepOrderAtEnd()
+{
+    AnimeMetadataStore store;
+    store.upsert(makeRow(1, "B"));
+    store.upsert(makeRow(2, "A"));
+
+    QCOMPARE(store.sorted({9, 1, 8, 2}, AnimeChain::SortCriteria::ByRepresentativeTitle, true),
+             QList<int>({2, 1, 9, 8}));
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+void TestAnimeMetadataStore::benchmarkSort_data()
+{
+    QTest::addColumn<int>("criteria");
+
+    QTest::newRow("title") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeTitle);
+    QTest::newRow("date") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeDate);
+    QTest::newRow("type") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeType);
+    QTest::newRow("chainLength") << static_cast<int>(AnimeChain::SortCriteria::ByChainLength);
+    QTest::newRow("id") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeId);
+    QTest::newRow("episodes") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeEpisodeCount);
+    QTest::newRow("completion") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeCompletion);
+    QTest::newRow("lastPlayed") << static_cast<int>(AnimeChain::SortCriteria::ByRepresentativeLastPlayed);
+    QTest::newRow("recentAirDate") << static_cast<int>(AnimeChain::SortCriteria::ByRecentEpisodeAirDate);
+}
+
+void TestAnimeMetadataStore::benchmarkSort()
+{
+    QFETCH(int, criteria);
+    const int animeCount = 25000;
+
+    AnimeMetadataStore store;
+    fillSyntheticStore(store, animeCount);
+
+    // Shuffled input so no criterion starts out presorted
+    QList<int> aids;
+    for (int aid = 1; aid <= animeCount; ++aid) {
+        aids.append(aid);
+    }
+    std::shuffle(aids.begin(), aids.end(), QRandomGenerator(7));
+
+    // Title ranks are built lazily; keep that one-off cost out of the measurement
+    store.titleRank(0);
+
+    QList<int> result;
+    QBENCHMARK {
+        result = store.sorted(aids, static_cast<AnimeChain::SortCriteria>(criteria), true);
+    }
+    QCOMPARE(result.size(), animeCount);
+}
+
+QTEST_MAIN(TestAnimeMetadataStore)
+#include "test_animemetadatastore.moc"
@@ -0,0 +1,345 @@
+#include <QTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTemporaryDir>
+#include <QFile>
+#include "../usagi/src/carddatasnapshot.h"
+#include "../usagi/src/animemetadatacache.h"
+
+/**
+ * Tests for the startup card data snapshot:
+ *   - CardDataSnapshot file format: round-trip, corruption and truncation detection
+ *   - Change tracking triggers: generation counter and dirty anime IDs
+ *   - Snapshots written from a cache that is behind the database keep those anime dirty
+ *   - AnimeMetadataCache stream operators used for the title index
+ */
+class TestCardDataSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    // File format tests
+    void testWriteAndOpenRoundTrip();
+    void testMissingFile();
+    void testCorruptPayloadRejected();
+    void testTruncatedFileRejected();
+    void testOverwriteReplacesSnapshot();
+
+    // Change tracking tests
+    void testFreshDatabaseHasNoCurrentSnapshot();
+    void testAnimeUpdateMarksDirty();
+    void testEpisodeUpdateMarksMylistAnimeDirty();
+    void testNonMylistTitlesIgnored();
+    void testLocalFileUpdateUsesIndex();
+    void testMarkSnapshotWrittenClearsDirty();
+    void testChangesAfterCaptureStayDirty();
+    void testUncoveredChangesStayDirty();
+
+    // Title index serialization
+    void testAnimeMetadataCacheStream();
+
+private:
+    QString snapshotPath() const { return m_dir.filePath("test.cardsnap"); }
+    QTemporaryDir m_dir;
+};
+
+// ---------------------------------------------------------------------------
+// Setup / Teardown
+// ---------------------------------------------------------------------------
+
+void TestCardDataSnapshot::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    // Minimal versions of the tables the card cache reads
+    QSqlQuery q(db);
+    QVERIFY(q.exec("CREATE TABLE anime (aid INTEGER PRIMARY KEY, nameromaji TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE mylist (lid INTEGER PRIMARY KEY, aid INTEGER, eid INTEGER, gid INTEGER, local_file INTEGER)"));
+    QVERIFY(q.exec("CREATE TABLE file (fid INTEGER PRIMARY KEY, aid INTEGER)"));
+    QVERIFY(q.exec("CREATE TABLE episode (eid INTEGER PRIMARY KEY, name TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE watched_episodes (eid INTEGER PRIMARY KEY, watched_at INTEGER)"));
+    QVERIFY(q.exec("CREATE TABLE local_files (id INTEGER PRIMARY KEY, path TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE `group` (gid INTEGER PRIMARY KEY, name TEXT)"));
+    QVERIFY(q.exec("CREATE TABLE anime_titles (aid INTEGER, type INTEGER, language TEXT, title TEXT)"));
+
+    QVERIFY(CardDataSnapshot::ensureChangeTracking());
+    // Calling it again must be harmless
+    QVERIFY(CardDataSnapshot::ensureChangeTracking());
+}
+
+void TestCardDataSnapshot::cleanupTestCase()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+}
+
+void TestCardDataSnapshot::init()
+{
+    QFile::remove(snapshotPath());
+
+    QSqlQuery q(QSqlDatabase::database());
+    q.exec("DELETE FROM anime");
+    q.exec("DELETE FROM mylist");
+    q.exec("DELETE FROM episode");
+    q.exec("DELETE FROM anime_titles");
+    q.exec("DELETE FROM local_files");
+    q.exec("DELETE FROM card_cache_dirty");
+    q.exec("UPDATE card_cache_state SET generation = 0, snapshot_generation = -1");
+}
+
+// ===================================================================
+// File format tests
+// ===================================================================
+
+void TestCardDataSnapshot::testWriteAndOpenRoundTrip()
+{
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(CardDataSnapshot::STREAM_VERSION);
+        out << QString("Cowboy Bebop") << qint32(26) << QList<int>{1, 2, 3};
+    }
+
+    CardDataSnapshot writer(snapshotPath());
+    QVERIFY(writer.write(payload, 42));
+
+    CardDataSnapshot reader(snapshotPath());
+    QVERIFY2(reader.open(), qPrintable(reader.errorString()));
+    QCOMPARE(reader.generation(), qint64(42));
+    QVERIFY(reader.createdAt() > 0);
+    QCOMPARE(reader.payload(), payload);
+
+    QDataStream in(reader.payload());
+    in.setVersion(reader.streamVersion());
+    QString title;
+    qint32 episodes = 0;
+    QList<int> ids;
+    in >> title >> episodes >> ids;
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(title, QString("Cowboy Bebop"));
+    QCOMPARE(episodes, qint32(26));
+    QCOMPARE(ids, QList<int>({1, 2, 3}));
+}
+
+void TestCardDataSnapshot::testMissingFile()
+{
+    CardDataSnapshot reader(snapshotPath());
+    QVERIFY(!reader.open());
+    QVERIFY(!reader.isOpen());
+    QVERIFY(!reader.errorString().isEmpty());
+    QVERIFY(reader.payload().isEmpty());
+}
+
+void TestCardDataSnapshot::testCorruptPayloadRejected()
+{
+    CardDataSnapshot writer(snapshotPath());
+    QVERIFY(writer.write(QByteArray(256, 'x'), 1));
+
+    // Flip a byte in the payload
+    QFile file(snapshotPath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.seek(CardDataSnapshot::HEADER_SIZE + 10);
+    file.write("y", 1);
+    file.close();
+
+    CardDataSnapshot reader(snapshotPath());
+    QVERIFY(!reader.open());
+    QVERIFY(reader.errorString().contains("checksum"));
+}
+
+void TestCardDataSnapshot::testTruncatedFileRejected()
+{
+    CardDataSnapshot writer(snapshotPath());
+    QVERIFY(writer.write(QByteArray(256, 'x'), 1));
+
+    QFile file(snapshotPath());
+    QVERIFY(file.resize(CardDataSnapshot::HEADER_SIZE + 100));
+
+    CardDataSnapshot reader(snapshotPath());
+    QVERIFY(!reader.open());
+
+    QVERIFY(file.resize(10));
+    QVERIFY(!reader.open());
+}
+
+void TestCardDataSnapshot::testOverwriteReplacesSnapshot()
+{
+    CardDataSnapshot snapshot(snapshotPath());
+    QVERIFY(snapshot.write(QByteArray("first"), 1));
+    QVERIFY(snapshot.open());
+    QCOMPARE(snapshot.payload(), QByteArray("first"));
+
+    // Writing while mapped must release the mapping first
+    QVERIFY(snapshot.write(QByteArray("second payload"), 2));
+    QVERIFY(snapshot.open());
+    QCOMPARE(snapshot.generation(), qint64(2));
+    QCOMPARE(snapshot.payload(), QByteArray("second payload"));
+
+    QVERIFY(snapshot.remove());
+    QVERIFY(!QFile::exists(snapshotPath()));
+}
+
+// ===================================================================
+// Change tracking tests
+// ===================================================================
+
+void TestCardDataSnapshot::testFreshDatabaseHasNoCurrentSnapshot()
+{
+    QCOMPARE(CardDataSnapshot::currentGeneration(), qint64(0));
+    QCOMPARE(CardDataSnapshot::snapshotGeneration(), qint64(-1));
+    QVERIFY(!CardDataSnapshot::isCurrent(0));
+    QVERIFY(CardDataSnapshot::dirtyAnimeIds().isEmpty());
+}
+
+void TestCardDataSnapshot::testAnimeUpdateMarksDirty()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO anime (aid, nameromaji) VALUES (10, 'A'), (20, 'B')"));
+    QVERIFY(q.exec("UPDATE anime SET nameromaji = 'B2' WHERE aid = 20"));
+
+    QCOMPARE(CardDataSnapshot::currentGeneration(), qint64(3));
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({10, 20}));
+}
+
+void TestCardDataSnapshot::testEpisodeUpdateMarksMylistAnimeDirty()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO mylist (lid, aid, eid) VALUES (1, 30, 300), (2, 40, 400)"));
+    QVERIFY(q.exec("INSERT INTO episode (eid, name) VALUES (300, 'Ep'), (999, 'Not in mylist')"));
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(CardDataSnapshot::currentGeneration()));
+    QVERIFY(CardDataSnapshot::dirtyAnimeIds().isEmpty());
+
+    QVERIFY(q.exec("UPDATE episode SET name = 'Renamed' WHERE eid = 300"));
+    QVERIFY(q.exec("UPDATE episode SET name = 'Other' WHERE eid = 999"));
+    QVERIFY(q.exec("INSERT INTO watched_episodes (eid, watched_at) VALUES (400, 1)"));
+
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({30, 40}));
+}
+
+void TestCardDataSnapshot::testLocalFileUpdateUsesIndex()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO mylist (lid, aid, eid, local_file) VALUES (1, 70, 700, 7), (2, 80, 800, NULL)"));
+    QVERIFY(q.exec("INSERT INTO local_files (id, path) VALUES (7, '/a.mkv'), (8, '/b.mkv')"));
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(CardDataSnapshot::currentGeneration()));
+
+    QVERIFY(q.exec("UPDATE local_files SET path = '/c.mkv' WHERE id IN (7, 8)"));
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({70}));
+
+    // The trigger's lookup must not scan the whole mylist per local_files write
+    QVERIFY(q.exec("EXPLAIN QUERY PLAN SELECT DISTINCT aid FROM mylist WHERE local_file = 7"));
+    QString plan;
+    while (q.next()) {
+        plan += q.value(3).toString();
+    }
+    QVERIFY2(plan.contains("idx_mylist_local_file"), qPrintable(plan));
+}
+
+void TestCardDataSnapshot::testNonMylistTitlesIgnored()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO mylist (lid, aid, eid) VALUES (1, 50, 500)"));
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(CardDataSnapshot::currentGeneration()));
+    qint64 before = CardDataSnapshot::currentGeneration();
+
+    QVERIFY(q.exec("INSERT INTO anime_titles (aid, type, language, title) VALUES (60, 1, 'x-jat', 'Other')"));
+    QCOMPARE(CardDataSnapshot::currentGeneration(), before);
+    QVERIFY(CardDataSnapshot::dirtyAnimeIds().isEmpty());
+
+    QVERIFY(q.exec("INSERT INTO anime_titles (aid, type, language, title) VALUES (50, 1, 'x-jat', 'Mine')"));
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({50}));
+}
+
+void TestCardDataSnapshot::testMarkSnapshotWrittenClearsDirty()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO anime (aid, nameromaji) VALUES (70, 'A')"));
+
+    qint64 generation = CardDataSnapshot::currentGeneration();
+    QVERIFY(!CardDataSnapshot::isCurrent(generation));
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(generation));
+
+    QVERIFY(CardDataSnapshot::isCurrent(generation));
+    QVERIFY(!CardDataSnapshot::isCurrent(generation - 1));
+    QVERIFY(CardDataSnapshot::dirtyAnimeIds().isEmpty());
+
+    // Later changes keep the snapshot usable but report the anime as dirty
+    QVERIFY(q.exec("UPDATE anime SET nameromaji = 'A2' WHERE aid = 70"));
+    QVERIFY(CardDataSnapshot::isCurrent(generation));
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({70}));
+}
+
+void TestCardDataSnapshot::testChangesAfterCaptureStayDirty()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO anime (aid, nameromaji) VALUES (80, 'A')"));
+    qint64 captured = CardDataSnapshot::currentGeneration();
+
+    // Change made while the snapshot was being serialized
+    QVERIFY(q.exec("INSERT INTO anime (aid, nameromaji) VALUES (90, 'B')"));
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(captured));
+
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({90}));
+}
+
+void TestCardDataSnapshot::testUncoveredChangesStayDirty()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    QVERIFY(q.exec("INSERT INTO anime (aid, nameromaji) VALUES (100, 'A')"));
+    qint64 covered = CardDataSnapshot::currentGeneration();
+
+    // Changed during the session but never re-read into the cache that is written
+    QVERIFY(q.exec("INSERT INTO anime (aid, nameromaji) VALUES (110, 'B')"));
+    qint64 generation = CardDataSnapshot::currentGeneration();
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(generation, covered));
+
+    QVERIFY(CardDataSnapshot::isCurrent(generation));
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({110}));
+
+    // Nothing covered: every dirty anime is kept
+    QVERIFY(q.exec("UPDATE anime SET nameromaji = 'A2' WHERE aid = 100"));
+    QVERIFY(CardDataSnapshot::markSnapshotWritten(CardDataSnapshot::currentGeneration(), -1));
+    QCOMPARE(CardDataSnapshot::dirtyAnimeIds(), QList<int>({100, 110}));
+}
+
+// ===================================================================
+// Title index serialization
+// ===================================================================
+
+void TestCardDataSnapshot::testAnimeMetadataCacheStream()
+{
+    AnimeMetadataCache cache;
+    cache.addAnime(1, {"Cowboy Bebop", "カウボーイビバップ"});
+    cache.addAnime(2, {"Trigun"});
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << cache;
+    }
+
+    AnimeMetadataCache restored;
+    restored.addAnime(3, {"Stale"});
+    QDataStream in(data);
+    in >> restored;
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(restored.size(), 2);
+    QVERIFY(!restored.contains(3));
+    QCOMPARE(restored.getTitles(1), cache.getTitles(1));
+    QVERIFY(restored.matchesAnyTitle(2, "trig"));
+}
+
+QTEST_MAIN(TestCardDataSnapshot)
+#include "test_card_data_snapshot.moc"
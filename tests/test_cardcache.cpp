@@ -0,0 +1,158 @@
+#include <QTest>
+#include "../usagi/src/cardcache.h"
+
+/**
+ * Tests for CardCache:
+ *   - Over the count budget the least recently used entries go first
+ *   - A lookup makes an entry the most recently used one
+ *   - The byte budget follows size updates
+ *   - Pinned (on screen) entries are never evicted, even above budget
+ *   - A full pool hands out its least recently used off-screen entry for rebinding
+ *   - Hits, misses and evictions are counted; clear() keeps the counters
+ */
+class TestCardCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCountBudget();
+    void testTouchRefreshesOrder();
+    void testByteBudget();
+    void testPinned();
+    void testTakeForRebind();
+    void testStats();
+};
+
+void TestCardCache::testCountBudget()
+{
+    CardCache cache;
+    cache.setBudget(3, 0);
+    for (int aid = 1; aid <= 5; ++aid) {
+        cache.insert(aid, 100);
+    }
+
+    QCOMPARE(cache.evict({}), QList<int>({1, 2}));
+    QCOMPARE(cache.size(), 3);
+    QCOMPARE(cache.bytes(), qint64(300));
+    QVERIFY(!cache.contains(1));
+    QVERIFY(cache.contains(5));
+
+    // Within budget: nothing to do
+    QVERIFY(cache.evict({}).isEmpty());
+
+    // No budget at all
+    cache.setBudget(0, 0);
+    cache.insert(6, 100);
+    QVERIFY(cache.evict({}).isEmpty());
+}
+
+void TestCardCache::testTouchRefreshesOrder()
+{
+    CardCache cache;
+    cache.setBudget(2, 0);
+    cache.insert(1, 0);
+    cache.insert(2, 0);
+    QVERIFY(cache.touch(1));
+    cache.insert(3, 0);
+
+    QCOMPARE(cache.evict({}), QList<int>({2}));
+
+    // Re-inserting an entry moves it to the front instead of adding it twice
+    cache.insert(1, 0);
+    cache.insert(4, 0);
+    QCOMPARE(cache.evict({}), QList<int>({3}));
+    QCOMPARE(cache.size(), 2);
+}
+
+void TestCardCache::testByteBudget()
+{
+    CardCache cache;
+    cache.setBudget(0, 1000);
+    cache.insert(1, 300);
+    cache.insert(2, 300);
+    cache.insert(3, 300);
+    QVERIFY(!cache.isOverBudget());
+
+    // A poster arrives for the newest card
+    cache.updateSize(3, 700);
+    QCOMPARE(cache.bytes(), qint64(1300));
+    QCOMPARE(cache.evict({}), QList<int>({1, 2}));
+    QCOMPARE(cache.bytes(), qint64(700));
+
+    cache.remove(3);
+    QCOMPARE(cache.bytes(), qint64(0));
+    cache.updateSize(3, 100);
+    QCOMPARE(cache.bytes(), qint64(0));
+}
+
+void TestCardCache::testPinned()
+{
+    CardCache cache;
+    cache.setBudget(2, 0);
+    for (int aid = 1; aid <= 4; ++aid) {
+        cache.insert(aid, 0);
+    }
+
+    // The oldest card is still on screen
+    QCOMPARE(cache.evict({1}), QList<int>({2, 3}));
+    QVERIFY(cache.contains(1));
+
+    // More cards on screen than the budget allows: all of them stay
+    cache.insert(5, 0);
+    QVERIFY(cache.evict({1, 4, 5}).isEmpty());
+    QCOMPARE(cache.size(), 3);
+    QVERIFY(cache.isOverBudget());
+}
+
+void TestCardCache::testTakeForRebind()
+{
+    CardCache cache;
+    for (int aid = 1; aid <= 3; ++aid) {
+        cache.insert(aid, 100);
+    }
+    QVERIFY(cache.touch(1));
+
+    // Order of use: 1, 3, 2 - the card of 2 is on screen
+    QCOMPARE(cache.takeForRebind({2}), 3);
+    QVERIFY(!cache.contains(3));
+    QCOMPARE(cache.bytes(), qint64(200));
+
+    // The rebound card comes back under its new anime
+    cache.insert(4, 100);
+    QCOMPARE(cache.takeForRebind({}), 2);
+    QCOMPARE(cache.takeForRebind({1, 4}), -1);
+    QCOMPARE(cache.size(), 2);
+    QCOMPARE(cache.stats().rebinds, quint64(2));
+}
+
+void TestCardCache::testStats()
+{
+    CardCache cache;
+    QCOMPARE(cache.stats().hitRate(), 0.0);
+
+    cache.setBudget(1, 0);
+    QVERIFY(!cache.touch(1));
+    cache.insert(1, 50);
+    QVERIFY(cache.touch(1));
+    QVERIFY(cache.touch(1));
+    QVERIFY(!cache.touch(2));
+    cache.insert(2, 70);
+    cache.evict({});
+
+    CardCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, quint64(2));
+    QCOMPARE(stats.misses, quint64(2));
+    QCOMPARE(stats.evictions, quint64(1));
+    QCOMPARE(stats.residentCards, 1);
+    QCOMPARE(stats.residentBytes, qint64(70));
+    QCOMPARE(stats.hitRate(), 0.5);
+
+    cache.clear();
+    stats = cache.stats();
+    QCOMPARE(stats.residentCards, 0);
+    QCOMPARE(stats.residentBytes, qint64(0));
+    QCOMPARE(stats.hits, quint64(2));
+}
+
+QTEST_MAIN(TestCardCache)
+#include "test_cardcache.moc"
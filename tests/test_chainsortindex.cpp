@@ -0,0 +1,344 @@
+#include <QTest>
+#include <QRandomGenerator>
+#include "../usagi/src/chainsortindex.h"
+#include "../usagi/src/animechain.h"
+#include "../usagi/src/animestats.h"
+
+/**
+ * Tests for ChainSortIndex:
+ *   - Order agrees with AnimeChain::compareWith for every criterion and direction
+ *   - Chain data extraction (fully hidden chains, air date of visible anime)
+ *   - Key caching, direction toggling and air date expiry
+ *   - Parallel sort path on large inputs
+ *   - Benchmark: cold sort vs cached direction toggle for 25k chains
+ */
+class TestChainSortIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testOrderMatchesCompareWith_data();
+    void testOrderMatchesCompareWith();
+    void testChainData();
+    void testMissingDataChainsGrouped();
+    void testDescendingKeepsBucketsInPlace();
+    void testCaching();
+    void testAirDateKeysExpire();
+    void testParallelSortMatchesSequential();
+
+    void benchmarkSortChains_data();
+    void benchmarkSortChains();
+};
+
+// Mock CardCreationData structure (fields used by chain sorting)
+struct MockCardData {
+    QString animeTitle;
+    QString typeName;
+    QString startDate;
+    AnimeStats stats;
+    qint64 lastPlayed;
+    qint64 recentEpisodeAirDate;
+    bool isHidden;
+
+    MockCardData() : lastPlayed(0), recentEpisodeAirDate(0), isHidden(false) {}
+};
+
+namespace {
+
+const qint64 NOW = 1700000000;
+
+struct Fixture {
+    QList<AnimeChain> chains;
+    QMap<int, MockCardData> dataCache;
+};
+
+// Random chains of 1-4 anime with values drawn from small ranges so ties are common
+Fixture makeFixture(int chainCount, quint32 seed)
+{
+    static const QStringList titles = {"Akira", "akira", "Bebop", "Clannad", "Durarara", "Eden", "Fate", "gintama"};
+    static const QStringList types = {"TV Series", "Movie", "OVA", "Web"};
+    QRandomGenerator rng(seed);
+
+    Fixture fixture;
+    int nextAid = 1;
+    for (int c = 0; c < chainCount; ++c) {
+        const int length = rng.bounded(1, 5);
+        QList<int> aids;
+        for (int i = 0; i < length; ++i) {
+            const int aid = nextAid++;
+            aids.append(aid);
+
+            MockCardData data;
+            data.animeTitle = titles.at(rng.bounded(titles.size()));
+            data.typeName = types.at(rng.bounded(types.size()));
+            data.startDate = rng.bounded(4) == 0 ? QString() : QString("20%1-01-01Z").arg(rng.bounded(10, 20));
+            const int normal = rng.bounded(0, 13);
+            const int other = rng.bounded(0, 3);
+            data.stats = AnimeStats(normal, normal, rng.bounded(normal + 1), other, rng.bounded(other + 1));
+            data.lastPlayed = rng.bounded(3) == 0 ? 0 : NOW - rng.bounded(1, 1000);
+            const int airKind = rng.bounded(4);
+            data.recentEpisodeAirDate = airKind == 0 ? 0
+                                      : airKind == 1 ? NOW + rng.bounded(1, 1000)
+                                      : NOW - rng.bounded(1, 1000);
+            data.isHidden = rng.bounded(5) == 0;
+            fixture.dataCache.insert(aid, data);
+        }
+        // Some chains entirely hidden
+        if (rng.bounded(8) == 0) {
+            for (int aid : aids) {
+                fixture.dataCache[aid].isHidden = true;
+            }
+        }
+        fixture.chains.append(AnimeChain(aids));
+    }
+    return fixture;
+}
+
+ChainSortIndex indexFor(const Fixture &fixture)
+{
+    QList<ChainSortIndex::ChainData> data;
+    for (const AnimeChain &chain : fixture.chains) {
+        data.append(ChainSortIndex::chainData(chain, fixture.dataCache));
+    }
+    ChainSortIndex index;
+    index.setChains(data);
+    return index;
+}
+
+} // namespace
+
+void TestChainSortIndex::testOrderMatchesCompareWith_data()
+{
+    QTest::addColumn<int>("criteria");
+    QTest::addColumn<bool>("ascending");
+
+    const QList<QPair<const char*, AnimeChain::SortCriteria>> criteria = {
+        {"title", AnimeChain::SortCriteria::ByRepresentativeTitle},
+        {"date", AnimeChain::SortCriteria::ByRepresentativeDate},
+        {"type", AnimeChain::SortCriteria::ByRepresentativeType},
+        {"length", AnimeChain::SortCriteria::ByChainLength},
+        {"id", AnimeChain::SortCriteria::ByRepresentativeId},
+        {"episodes", AnimeChain::SortCriteria::ByRepresentativeEpisodeCount},
+        {"completion", AnimeChain::SortCriteria::ByRepresentativeCompletion},
+        {"lastplayed", AnimeChain::SortCriteria::ByRepresentativeLastPlayed},
+        {"airdate", AnimeChain::SortCriteria::ByRecentEpisodeAirDate}
+    };
+    for (const auto &c : criteria) {
+        QTest::newRow(QByteArray(c.first).append(" asc").constData()) << static_cast<int>(c.second) << true;
+        QTest::newRow(QByteArray(c.first).append(" desc").constData()) << static_cast<int>(c.second) << false;
+    }
+}
+
+void TestChainSortIndex::testOrderMatchesCompareWith()
+{
+    QFETCH(int, criteria);
+    QFETCH(bool, ascending);
+    const auto sortCriteria = static_cast<AnimeChain::SortCriteria>(criteria);
+
+    const Fixture fixture = makeFixture(400, 7);
+    ChainSortIndex index = indexFor(fixture);
+    const QList<int> order = index.order(sortCriteria, ascending, NOW);
+
+    QCOMPARE(order.size(), fixture.chains.size());
+    QList<int> sortedOrder = order;
+    std::sort(sortedOrder.begin(), sortedOrder.end());
+    for (int i = 0; i < sortedOrder.size(); ++i) {
+        QCOMPARE(sortedOrder[i], i);
+    }
+
+    // compareWith never puts a later chain before an earlier one
+    for (int i = 0; i + 1 < order.size(); ++i) {
+        const AnimeChain &a = fixture.chains[order[i]];
+        const AnimeChain &b = fixture.chains[order[i + 1]];
+        if (a.compareWith(b, fixture.dataCache, sortCriteria, ascending) > 0) {
+            QFAIL(qPrintable(QString("Chains %1 and %2 out of order at position %3")
+                             .arg(a.getRepresentativeAnimeId()).arg(b.getRepresentativeAnimeId()).arg(i)));
+        }
+    }
+}
+
+void TestChainSortIndex::testChainData()
+{
+    QMap<int, MockCardData> dataCache;
+    dataCache[1].animeTitle = "First";
+    dataCache[1].recentEpisodeAirDate = 100;
+    dataCache[1].stats = AnimeStats(10, 10, 5, 2, 1);
+    dataCache[2].recentEpisodeAirDate = 300;
+    dataCache[2].isHidden = true;
+    dataCache[3].recentEpisodeAirDate = 200;
+
+    // Visible chain: newest air date among visible anime only
+    ChainSortIndex::ChainData data = ChainSortIndex::chainData(AnimeChain(QList<int>{1, 2, 3}), dataCache);
+    QVERIFY(data.hasData);
+    QVERIFY(!data.fullyHidden);
+    QCOMPARE(data.representativeAid, 1);
+    QCOMPARE(data.length, 3);
+    QCOMPARE(data.title, QString("First"));
+    QCOMPARE(data.episodes, 12);
+    QCOMPARE(data.viewed, 6);
+    QCOMPARE(data.recentEpisodeAirDate, qint64(200));
+
+    // Fully hidden chain: representative's air date
+    dataCache[1].isHidden = true;
+    dataCache[3].isHidden = true;
+    data = ChainSortIndex::chainData(AnimeChain(QList<int>{1, 2, 3}), dataCache);
+    QVERIFY(data.fullyHidden);
+    QCOMPARE(data.recentEpisodeAirDate, qint64(100));
+
+    // Anime missing from the cache count as visible
+    data = ChainSortIndex::chainData(AnimeChain(QList<int>{1, 99}), dataCache);
+    QVERIFY(!data.fullyHidden);
+
+    data = ChainSortIndex::chainData(AnimeChain(QList<int>{99}), dataCache);
+    QVERIFY(!data.hasData);
+}
+
+void TestChainSortIndex::testMissingDataChainsGrouped()
+{
+    QMap<int, MockCardData> dataCache;
+    dataCache[5].animeTitle = "B";
+    dataCache[6].animeTitle = "A";
+
+    QList<ChainSortIndex::ChainData> data;
+    data.append(ChainSortIndex::chainData(AnimeChain(QList<int>{9}), dataCache));   // no data
+    data.append(ChainSortIndex::chainData(AnimeChain(QList<int>{5}), dataCache));
+    data.append(ChainSortIndex::chainData(AnimeChain(QList<int>{3}), dataCache));   // no data
+    data.append(ChainSortIndex::chainData(AnimeChain(QList<int>{6}), dataCache));
+
+    ChainSortIndex index;
+    index.setChains(data);
+
+    // Chains with data first, then chains without data by aid
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, true), QList<int>({3, 1, 2, 0}));
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, false), QList<int>({1, 3, 0, 2}));
+
+    // By ID everything shares one ordering
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeId, true), QList<int>({2, 1, 3, 0}));
+}
+
+void TestChainSortIndex::testDescendingKeepsBucketsInPlace()
+{
+    QList<ChainSortIndex::ChainData> data(5);
+    for (int i = 0; i < data.size(); ++i) {
+        data[i].representativeAid = i + 1;
+        data[i].hasData = true;
+        data[i].length = 1;
+    }
+    data[0].lastPlayed = 300;
+    data[1].lastPlayed = 0;                     // never played
+    data[2].lastPlayed = 100;
+    data[3].lastPlayed = 200;
+    data[3].fullyHidden = true;
+    data[4].lastPlayed = 500;
+    data[4].fullyHidden = true;
+
+    ChainSortIndex index;
+    index.setChains(data);
+
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeLastPlayed, true), QList<int>({2, 0, 1, 3, 4}));
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeLastPlayed, false), QList<int>({0, 2, 1, 4, 3}));
+}
+
+void TestChainSortIndex::testCaching()
+{
+    const Fixture fixture = makeFixture(50, 3);
+    ChainSortIndex index = indexFor(fixture);
+
+    QVERIFY(!index.isCached(AnimeChain::SortCriteria::ByRepresentativeTitle, NOW));
+    const QList<int> ascending = index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, true, NOW);
+    QVERIFY(index.isCached(AnimeChain::SortCriteria::ByRepresentativeTitle, NOW));
+    QVERIFY(!index.isCached(AnimeChain::SortCriteria::ByRepresentativeType, NOW));
+
+    // Toggling direction reuses the cached keys
+    const QList<int> descending = index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, false, NOW);
+    QVERIFY(index.isCached(AnimeChain::SortCriteria::ByRepresentativeTitle, NOW));
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, true, NOW), ascending);
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, false, NOW), descending);
+
+    // New chains drop all cached keys
+    index.setChains(QList<ChainSortIndex::ChainData>());
+    QVERIFY(!index.isCached(AnimeChain::SortCriteria::ByRepresentativeTitle, NOW));
+    QVERIFY(index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, true, NOW).isEmpty());
+}
+
+void TestChainSortIndex::testAirDateKeysExpire()
+{
+    QList<ChainSortIndex::ChainData> data(2);
+    data[0].representativeAid = 1;
+    data[0].hasData = true;
+    data[0].recentEpisodeAirDate = NOW + 100;   // airs later
+    data[1].representativeAid = 2;
+    data[1].hasData = true;
+    data[1].recentEpisodeAirDate = NOW + 50;    // airs sooner
+
+    ChainSortIndex index;
+    index.setChains(data);
+
+    // Both not yet aired: plain date order
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRecentEpisodeAirDate, false, NOW), QList<int>({0, 1}));
+    QVERIFY(index.isCached(AnimeChain::SortCriteria::ByRecentEpisodeAirDate, NOW + 49));
+    QVERIFY(!index.isCached(AnimeChain::SortCriteria::ByRecentEpisodeAirDate, NOW + 50));
+
+    // Once chain 1 has aired it moves ahead of the not-yet-aired chain in both directions
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRecentEpisodeAirDate, false, NOW + 60), QList<int>({1, 0}));
+    QCOMPARE(index.order(AnimeChain::SortCriteria::ByRecentEpisodeAirDate, true, NOW + 60), QList<int>({1, 0}));
+}
+
+void TestChainSortIndex::testParallelSortMatchesSequential()
+{
+    const int count = ChainSortIndex::PARALLEL_THRESHOLD * 3 + 17;
+    const Fixture fixture = makeFixture(count, 11);
+    ChainSortIndex large = indexFor(fixture);
+    const QList<int> order = large.order(AnimeChain::SortCriteria::ByRepresentativeTitle, true, NOW);
+    QCOMPARE(order.size(), count);
+
+    // Same order as sorting small slices of the same data would produce: verify against compareWith
+    // and the index tie-break (equal keys keep input order)
+    for (int i = 0; i + 1 < order.size(); ++i) {
+        const AnimeChain &a = fixture.chains[order[i]];
+        const AnimeChain &b = fixture.chains[order[i + 1]];
+        const int cmp = a.compareWith(b, fixture.dataCache, AnimeChain::SortCriteria::ByRepresentativeTitle, true);
+        QVERIFY(cmp <= 0);
+        if (cmp == 0) {
+            const ChainSortIndex::ChainData da = ChainSortIndex::chainData(a, fixture.dataCache);
+            const ChainSortIndex::ChainData db = ChainSortIndex::chainData(b, fixture.dataCache);
+            if (da.fullyHidden == db.fullyHidden) {
+                QVERIFY(order[i] < order[i + 1]);
+            }
+        }
+    }
+}
+
+void TestChainSortIndex::benchmarkSortChains_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("cold keys") << false;
+    QTest::newRow("cached keys, direction toggle") << true;
+}
+
+void TestChainSortIndex::benchmarkSortChains()
+{
+    QFETCH(bool, cached);
+
+    const Fixture fixture = makeFixture(25000, 5);
+    QList<ChainSortIndex::ChainData> data;
+    for (const AnimeChain &chain : fixture.chains) {
+        data.append(ChainSortIndex::chainData(chain, fixture.dataCache));
+    }
+
+    ChainSortIndex index;
+    index.setChains(data);
+    bool ascending = true;
+    QList<int> order;
+    QBENCHMARK {
+        if (!cached) {
+            index.setChains(data);
+        }
+        order = index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, ascending, NOW);
+        ascending = !ascending;
+    }
+    QCOMPARE(order.size(), fixture.chains.size());
+}
+
+QTEST_MAIN(TestChainSortIndex)
+#include "test_chainsortindex.moc"
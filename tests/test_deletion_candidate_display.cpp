@@ -3,6 +3,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSignalSpy>
+#include <QRandomGenerator>
 #include "../usagi/src/deletionlockmanager.h"
 #include "../usagi/src/factorweightlearner.h"
 #include "../usagi/src/deletionhistorymanager.h"
@@ -10,7 +11,8 @@
 /**
  * Tests for the deletion candidate display infrastructure:
  *   - DeletionLockManager: lock/unlock anime/episode, propagation
- *   - FactorWeightLearner: weight adjustment, score computation, reset
+ *   - FactorWeightLearner: weight adjustment, score computation, reset, batch scoring,
+ *     persistence by factor name
  *   - DeletionHistoryManager: recording, querying, pruning
  */
 class TestDeletionCandidateDisplay : public QObject
@@ -40,6 +42,10 @@ private slots:
     void testIsTrainedRequires50Choices();
     void testResetAllWeights();
     void testMinFactorDifferenceIgnored();
+    void testComputeScoresMatchesComputeScore();
+    void testWeightsPersistByName();
+    void benchmarkComputeScores_data();
+    void benchmarkComputeScores();
 
     // DeletionHistoryManager tests
     void testRecordAndQueryHistory();
@@ -301,19 +307,19 @@ void TestDeletionCandidateDisplay::testRecordChoiceAdjustsWeights()
     FactorWeightLearner learner;
     learner.ensureTablesExist();
 
-    QMap<QString, double> keptFactors;
-    keptFactors["anime_rating"]            = 0.9;
-    keptFactors["size_weighted_distance"]   = 0.3;
-    keptFactors["group_status"]            = 1.0;
-    keptFactors["watch_recency"]           = 0.5;
-    keptFactors["view_percentage"]         = 0.8;
+    FactorVector keptFactors{};
+    keptFactors[DeletionFactor::AnimeRating]          = 0.9;
+    keptFactors[DeletionFactor::SizeWeightedDistance] = 0.3;
+    keptFactors[DeletionFactor::GroupStatus]          = 1.0;
+    keptFactors[DeletionFactor::WatchRecency]         = 0.5;
+    keptFactors[DeletionFactor::ViewPercentage]       = 0.8;
 
-    QMap<QString, double> deletedFactors;
-    deletedFactors["anime_rating"]            = 0.4;
-    deletedFactors["size_weighted_distance"]   = 0.7;
-    deletedFactors["group_status"]            = 0.0;
-    deletedFactors["watch_recency"]           = 0.5;  // same as kept → no adjustment
-    deletedFactors["view_percentage"]         = 0.2;
+    FactorVector deletedFactors{};
+    deletedFactors[DeletionFactor::AnimeRating]          = 0.4;
+    deletedFactors[DeletionFactor::SizeWeightedDistance] = 0.7;
+    deletedFactors[DeletionFactor::GroupStatus]          = 0.0;
+    deletedFactors[DeletionFactor::WatchRecency]         = 0.5;  // same as kept → no adjustment
+    deletedFactors[DeletionFactor::ViewPercentage]       = 0.2;
 
     learner.recordChoice(1, 2, keptFactors, deletedFactors);
 
@@ -334,9 +340,9 @@ void TestDeletionCandidateDisplay::testRecordChoiceAdjustsWeights()
 void TestDeletionCandidateDisplay::testComputeScoreWithZeroWeights()
 {
     FactorWeightLearner learner;
-    QMap<QString, double> factors;
-    factors["anime_rating"] = 0.8;
-    factors["size_weighted_distance"] = 0.5;
+    FactorVector factors{};
+    factors[DeletionFactor::AnimeRating] = 0.8;
+    factors[DeletionFactor::SizeWeightedDistance] = 0.5;
     QCOMPARE(learner.computeScore(factors), 0.0);
 }
 
@@ -346,23 +352,23 @@ void TestDeletionCandidateDisplay::testComputeScoreWithNonZeroWeights()
     learner.ensureTablesExist();
 
     // Manually set weights through multiple choices that push anime_rating positive
-    QMap<QString, double> kf, df;
-    kf["anime_rating"] = 1.0; kf["size_weighted_distance"] = 0.5;
-    kf["group_status"] = 0.5; kf["watch_recency"] = 0.5; kf["view_percentage"] = 0.5;
-    df["anime_rating"] = 0.0; df["size_weighted_distance"] = 0.5;
-    df["group_status"] = 0.5; df["watch_recency"] = 0.5; df["view_percentage"] = 0.5;
+    FactorVector kf{}, df{};
+    kf[DeletionFactor::AnimeRating] = 1.0; kf[DeletionFactor::SizeWeightedDistance] = 0.5;
+    kf[DeletionFactor::GroupStatus] = 0.5; kf[DeletionFactor::WatchRecency] = 0.5; kf[DeletionFactor::ViewPercentage] = 0.5;
+    df[DeletionFactor::AnimeRating] = 0.0; df[DeletionFactor::SizeWeightedDistance] = 0.5;
+    df[DeletionFactor::GroupStatus] = 0.5; df[DeletionFactor::WatchRecency] = 0.5; df[DeletionFactor::ViewPercentage] = 0.5;
 
     // 5 choices pushing anime_rating weight to +0.5
     for (int i = 0; i < 5; ++i) {
         learner.recordChoice(1, 2, kf, df);
     }
 
-    QMap<QString, double> testFactors;
-    testFactors["anime_rating"] = 0.8;
-    testFactors["size_weighted_distance"] = 0.0;
-    testFactors["group_status"] = 0.0;
-    testFactors["watch_recency"] = 0.0;
-    testFactors["view_percentage"] = 0.0;
+    FactorVector testFactors{};
+    testFactors[DeletionFactor::AnimeRating] = 0.8;
+    testFactors[DeletionFactor::SizeWeightedDistance] = 0.0;
+    testFactors[DeletionFactor::GroupStatus] = 0.0;
+    testFactors[DeletionFactor::WatchRecency] = 0.0;
+    testFactors[DeletionFactor::ViewPercentage] = 0.0;
 
     double score = learner.computeScore(testFactors);
     // weight for anime_rating should be ~0.5, score = 0.5 * 0.8 = 0.4
@@ -374,12 +380,12 @@ void TestDeletionCandidateDisplay::testIsTrainedRequires50Choices()
     FactorWeightLearner learner;
     learner.ensureTablesExist();
 
-    QMap<QString, double> kf, df;
-    kf["anime_rating"] = 1.0; df["anime_rating"] = 0.0;
-    kf["size_weighted_distance"] = 0.5; df["size_weighted_distance"] = 0.5;
-    kf["group_status"] = 0.5; df["group_status"] = 0.5;
-    kf["watch_recency"] = 0.5; df["watch_recency"] = 0.5;
-    kf["view_percentage"] = 0.5; df["view_percentage"] = 0.5;
+    FactorVector kf{}, df{};
+    kf[DeletionFactor::AnimeRating] = 1.0; df[DeletionFactor::AnimeRating] = 0.0;
+    kf[DeletionFactor::SizeWeightedDistance] = 0.5; df[DeletionFactor::SizeWeightedDistance] = 0.5;
+    kf[DeletionFactor::GroupStatus] = 0.5; df[DeletionFactor::GroupStatus] = 0.5;
+    kf[DeletionFactor::WatchRecency] = 0.5; df[DeletionFactor::WatchRecency] = 0.5;
+    kf[DeletionFactor::ViewPercentage] = 0.5; df[DeletionFactor::ViewPercentage] = 0.5;
 
     for (int i = 0; i < 49; ++i) {
         learner.recordChoice(1, 2, kf, df);
@@ -396,12 +402,12 @@ void TestDeletionCandidateDisplay::testResetAllWeights()
     FactorWeightLearner learner;
     learner.ensureTablesExist();
 
-    QMap<QString, double> kf, df;
-    kf["anime_rating"] = 1.0; df["anime_rating"] = 0.0;
-    kf["size_weighted_distance"] = 0.5; df["size_weighted_distance"] = 0.5;
-    kf["group_status"] = 0.5; df["group_status"] = 0.5;
-    kf["watch_recency"] = 0.5; df["watch_recency"] = 0.5;
-    kf["view_percentage"] = 0.5; df["view_percentage"] = 0.5;
+    FactorVector kf{}, df{};
+    kf[DeletionFactor::AnimeRating] = 1.0; df[DeletionFactor::AnimeRating] = 0.0;
+    kf[DeletionFactor::SizeWeightedDistance] = 0.5; df[DeletionFactor::SizeWeightedDistance] = 0.5;
+    kf[DeletionFactor::GroupStatus] = 0.5; df[DeletionFactor::GroupStatus] = 0.5;
+    kf[DeletionFactor::WatchRecency] = 0.5; df[DeletionFactor::WatchRecency] = 0.5;
+    kf[DeletionFactor::ViewPercentage] = 0.5; df[DeletionFactor::ViewPercentage] = 0.5;
 
     learner.recordChoice(1, 2, kf, df);
     QVERIFY(learner.getWeight("anime_rating") != 0.0);
@@ -418,13 +424,13 @@ void TestDeletionCandidateDisplay::testMinFactorDifferenceIgnored()
     FactorWeightLearner learner;
     learner.ensureTablesExist();
 
-    QMap<QString, double> kf, df;
+    FactorVector kf{}, df{};
     // All factors differ by less than MIN_FACTOR_DIFFERENCE (0.01)
-    kf["anime_rating"] = 0.500; df["anime_rating"] = 0.505;
-    kf["size_weighted_distance"] = 0.5; df["size_weighted_distance"] = 0.5;
-    kf["group_status"] = 0.5; df["group_status"] = 0.5;
-    kf["watch_recency"] = 0.5; df["watch_recency"] = 0.5;
-    kf["view_percentage"] = 0.5; df["view_percentage"] = 0.5;
+    kf[DeletionFactor::AnimeRating] = 0.500; df[DeletionFactor::AnimeRating] = 0.505;
+    kf[DeletionFactor::SizeWeightedDistance] = 0.5; df[DeletionFactor::SizeWeightedDistance] = 0.5;
+    kf[DeletionFactor::GroupStatus] = 0.5; df[DeletionFactor::GroupStatus] = 0.5;
+    kf[DeletionFactor::WatchRecency] = 0.5; df[DeletionFactor::WatchRecency] = 0.5;
+    kf[DeletionFactor::ViewPercentage] = 0.5; df[DeletionFactor::ViewPercentage] = 0.5;
 
     learner.recordChoice(1, 2, kf, df);
     // No weight should have changed
@@ -433,6 +439,95 @@ void TestDeletionCandidateDisplay::testMinFactorDifferenceIgnored()
     }
 }
 
+void TestDeletionCandidateDisplay::testComputeScoresMatchesComputeScore()
+{
+    QRandomGenerator rng(35);
+    FactorVector weights{};
+    for (double &w : weights) {
+        w = rng.bounded(2.0) - 1.0;
+    }
+    std::vector<FactorVector> factors(1000);
+    for (FactorVector &f : factors) {
+        for (double &v : f) {
+            v = rng.bounded(1.0);
+        }
+    }
+
+    const std::vector<double> scores = FactorWeightLearner::computeScores(weights, factors);
+    QCOMPARE(scores.size(), factors.size());
+    for (std::size_t i = 0; i < factors.size(); ++i) {
+        QCOMPARE(scores[i], FactorWeightLearner::computeScore(weights, factors[i]));
+    }
+    QVERIFY(FactorWeightLearner::computeScores(weights, {}).empty());
+}
+
+void TestDeletionCandidateDisplay::testWeightsPersistByName()
+{
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+
+    FactorVector kf{}, df{};
+    kf[DeletionFactor::GroupStatus] = 1.0;
+    kf[DeletionFactor::ViewPercentage] = 0.0;
+    df[DeletionFactor::GroupStatus] = 0.0;
+    df[DeletionFactor::ViewPercentage] = 1.0;
+    learner.recordChoice(1, 2, kf, df);
+
+    QSqlQuery q;
+    QVERIFY(q.exec("SELECT weight FROM deletion_factor_weights WHERE factor = 'group_status'"));
+    QVERIFY(q.next());
+    QVERIFY(qAbs(q.value(0).toDouble() - 0.1) < 0.001);
+
+    // A fresh learner maps the stored names back onto the same factors
+    FactorWeightLearner reloaded;
+    reloaded.ensureTablesExist();
+    QVERIFY(reloaded.allWeights() == learner.allWeights());
+    QVERIFY(qAbs(reloaded.getWeight(DeletionFactor::GroupStatus) - 0.1) < 0.001);
+    QVERIFY(qAbs(reloaded.getWeight(DeletionFactor::ViewPercentage) - (-0.1)) < 0.001);
+    QCOMPARE(reloaded.getWeight("no_such_factor"), 0.0);
+    QCOMPARE(FactorWeightLearner::factorIndex("view_percentage"), static_cast<int>(DeletionFactor::ViewPercentage));
+}
+
+void TestDeletionCandidateDisplay::benchmarkComputeScores_data()
+{
+    QTest::addColumn<bool>("batch");
+    QTest::newRow("per candidate") << false;
+    QTest::newRow("batch") << true;
+}
+
+void TestDeletionCandidateDisplay::benchmarkComputeScores()
+{
+    QFETCH(bool, batch);
+
+    QRandomGenerator rng(10000);
+    FactorVector weights{};
+    for (double &w : weights) {
+        w = rng.bounded(2.0) - 1.0;
+    }
+    std::vector<FactorVector> factors(10000);
+    for (FactorVector &f : factors) {
+        for (double &v : f) {
+            v = rng.bounded(1.0);
+        }
+    }
+
+    // Rescoring every learned-preference candidate after a choice
+    double total = 0.0;
+    QBENCHMARK {
+        std::vector<double> scores;
+        if (batch) {
+            scores = FactorWeightLearner::computeScores(weights, factors);
+        } else {
+            scores.reserve(factors.size());
+            for (const FactorVector &f : factors) {
+                scores.push_back(FactorWeightLearner::computeScore(weights, f));
+            }
+        }
+        total += scores.back();
+    }
+    QVERIFY(total != 0.0);
+}
+
 // ===================================================================
 // DeletionHistoryManager tests
 // ===================================================================
@@ -0,0 +1,746 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSet>
+#include "../usagi/src/fileattributesnapshot.h"
+#include "../usagi/src/hybriddeletionclassifier.h"
+#include "../usagi/src/deletionqueue.h"
+#include "../usagi/src/deletionlockmanager.h"
+#include "../usagi/src/factorweightlearner.h"
+#include "../usagi/src/watchsessionmanager.h"
+
+/**
+ * Tests for set-based deletion classification:
+ *   - FileAttributeSnapshot loads every local file with one joined query
+ *     (missing file/anime/group rows, NULL quality, deleted entries)
+ *   - Classifying from the snapshot gives the same result as the per-file queries
+ *     on a randomized library (all tiers, locks, factor values, scores)
+ *   - Group status is read from the `group` table
+ *   - Parallel classifyAll() agrees with classifying one file at a time
+ *   - DeletionQueue::rebuild() runs in the background, publishes in one step and
+ *     coalesces requests made while it runs
+ *   - DeletionQueue::rebuild() over 10k local files
+ *   - Incremental refreshes (locks, deleted / linked files, recorded choices) leave
+ *     the queue identical to a full rebuild
+ *   - WatchSessionManager's per-file helpers answer the same from a loaded snapshot
+ *   - Benchmark: lockAnime() on 10k files, incremental refresh vs full rebuild
+ *   - Benchmark: every per-file helper for every local file, per-lid queries vs snapshot
+ */
+class TestDeletionClassification : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testSnapshotLoad();
+    void testSnapshotMatchesPerFileClassification();
+    void testGroupStatusFactor();
+    void testParallelMatchesSequential();
+    void testRebuildPublishesInBackground();
+    void testRebuildCoalescesRequests();
+    void testRebuildLargeLibrary();
+    void testIncrementalMatchesRebuild();
+    void testSessionHelpersMatchSnapshot();
+
+    void benchmarkClassification_data();
+    void benchmarkClassification();
+    void benchmarkLockAnime_data();
+    void benchmarkLockAnime();
+    void benchmarkSessionHelpers_data();
+    void benchmarkSessionHelpers();
+
+private:
+    // WatchSessionManager's helpers are private; this class is its friend
+    static QString sessionHelperAnswers(const WatchSessionManager &manager, int lid,
+                                        const QSet<int> &deletedEpisodes);
+};
+
+namespace {
+
+void createSchema()
+{
+    QSqlQuery q;
+    q.exec("CREATE TABLE mylist (lid INTEGER PRIMARY KEY, fid INTEGER, eid INTEGER, aid INTEGER, "
+           "gid INTEGER, state INTEGER, viewed INTEGER, local_file INTEGER, deletion_locked INTEGER DEFAULT 0)");
+    q.exec("CREATE TABLE local_files (id INTEGER PRIMARY KEY, path TEXT)");
+    q.exec("CREATE TABLE file (fid INTEGER PRIMARY KEY, aid INTEGER, eid INTEGER, gid INTEGER, "
+           "state INTEGER, quality TEXT, codec_video TEXT, bitrate_video INTEGER, resolution TEXT, "
+           "lang_dub TEXT, lang_sub TEXT)");
+    q.exec("CREATE TABLE anime (aid INTEGER PRIMARY KEY, nameromaji TEXT, rating INTEGER, hidden INTEGER)");
+    q.exec("CREATE TABLE `group` (gid INTEGER PRIMARY KEY, name TEXT, shortname TEXT, status INTEGER DEFAULT 0)");
+    q.exec("CREATE TABLE episode (eid INTEGER PRIMARY KEY, epno TEXT)");
+    q.exec("CREATE TABLE settings (name TEXT PRIMARY KEY, value TEXT)");
+    q.exec("INSERT INTO settings VALUES ('preferredAudioLanguages', 'japanese')");
+    q.exec("INSERT INTO settings VALUES ('preferredSubtitleLanguages', 'english, german')");
+}
+
+QVariant pick(QRandomGenerator &rng, const QVariantList &values)
+{
+    return values[rng.bounded(static_cast<int>(values.size()))];
+}
+
+// Random library of about fileCount mylist entries, one or two per episode so the
+// replacement file of every tier is unambiguous
+void populate(int fileCount, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+
+    QSqlQuery q;
+    const int animeCount = qMax(1, fileCount / 24);
+    for (int aid = 1; aid <= animeCount; ++aid) {
+        if (rng.bounded(20) == 0) {
+            continue;  // anime row missing
+        }
+        q.prepare("INSERT INTO anime VALUES (?, ?, ?, ?)");
+        q.addBindValue(aid);
+        q.addBindValue(QString("Anime %1").arg(aid));
+        q.addBindValue(rng.bounded(10) == 0 ? QVariant() : QVariant(rng.bounded(1001)));
+        q.addBindValue(rng.bounded(20) == 0 ? 1 : 0);
+        q.exec();
+    }
+    for (int gid = 1; gid <= 20; ++gid) {
+        q.prepare("INSERT INTO `group` VALUES (?, ?, ?, ?)");
+        q.addBindValue(gid);
+        q.addBindValue(QString("Group %1").arg(gid));
+        q.addBindValue(QString("G%1").arg(gid));
+        q.addBindValue(rng.bounded(4));
+        q.exec();
+    }
+
+    const QVariantList qualities{QVariant(), "low", "med", "high", "very high"};
+    const QVariantList languages{QVariant(), "", "japanese", "english", "japanese'english", "german'french"};
+    const QVariantList states{0, 1, 4, 8, 16, 32, 4 | 1};
+
+    // Episode numbers draw from their own generator so the files stay the same
+    QRandomGenerator episodeRng(seed + 1);
+    QHash<int, int> episodesOfAnime;
+
+    int lid = 0;
+    int eid = 0;
+    while (lid < fileCount) {
+        ++eid;
+        const int aid = 1 + rng.bounded(animeCount);
+        const int copies = 1 + rng.bounded(2);
+        if (episodeRng.bounded(20) != 0) {
+            const int number = ++episodesOfAnime[aid] + episodeRng.bounded(2);  // some gaps
+            q.prepare("INSERT INTO episode VALUES (?, ?)");
+            q.addBindValue(eid);
+            q.addBindValue(episodeRng.bounded(10) == 0 ? QString("S%1").arg(number) : QString::number(number));
+            q.exec();
+        }
+        for (int i = 0; i < copies && lid < fileCount; ++i) {
+            ++lid;
+            const int fid = 100000 + lid;
+            const int gid = rng.bounded(25);  // 21-24: group row missing
+            if (rng.bounded(20) != 0) {
+                q.prepare("INSERT INTO file (fid, aid, eid, gid, state, quality, codec_video, bitrate_video, "
+                          "resolution, lang_dub, lang_sub) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+                q.addBindValue(fid);
+                q.addBindValue(aid);
+                q.addBindValue(eid);
+                q.addBindValue(gid);
+                q.addBindValue(pick(rng, states));
+                q.addBindValue(pick(rng, qualities));
+                q.addBindValue(rng.bounded(2) ? "H264/AVC" : "HEVC");
+                q.addBindValue(500 + rng.bounded(5000));
+                q.addBindValue("1920x1080");
+                q.addBindValue(pick(rng, languages));
+                q.addBindValue(pick(rng, languages));
+                q.exec();
+            }
+            q.prepare("INSERT INTO local_files VALUES (?, ?)");
+            q.addBindValue(lid);
+            q.addBindValue(rng.bounded(20) == 0 ? QVariant() : QVariant(QString("/anime/%1/%2.mkv").arg(aid).arg(lid)));
+            q.exec();
+
+            q.prepare("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) "
+                      "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+            q.addBindValue(lid);
+            q.addBindValue(fid);
+            q.addBindValue(eid);
+            q.addBindValue(aid);
+            q.addBindValue(gid);
+            q.addBindValue(rng.bounded(20) == 0 ? 3 : 1);
+            q.addBindValue(rng.bounded(2));
+            q.addBindValue(lid);
+            q.exec();
+        }
+    }
+    db.commit();
+}
+
+// Lids the per-file rebuild used to classify
+QSet<int> queriedCandidates()
+{
+    QSet<int> lids;
+    QSqlQuery q;
+    q.exec("SELECT m.lid FROM mylist m JOIN local_files lf ON lf.id = m.local_file "
+           "WHERE lf.path IS NOT NULL AND m.state != 3");
+    while (q.next()) {
+        lids.insert(q.value(0).toInt());
+    }
+    return lids;
+}
+
+void compareQueues(const DeletionQueue &actual, const DeletionQueue &expected)
+{
+    QCOMPARE(actual.totalClassified(), expected.totalClassified());
+    QCOMPARE(actual.protectedCount(), expected.protectedCount());
+    QCOMPARE(actual.candidates().size(), expected.candidates().size());
+    for (qsizetype i = 0; i < expected.candidates().size(); ++i) {
+        const DeletionCandidate &a = actual.candidates()[i];
+        const DeletionCandidate &e = expected.candidates()[i];
+        QCOMPARE(a.lid, e.lid);
+        QCOMPARE(a.tier, e.tier);
+        QCOMPARE(a.reason, e.reason);
+        QCOMPARE(a.replacementLid, e.replacementLid);
+        QCOMPARE(a.learnedScore, e.learnedScore);
+    }
+    QCOMPARE(actual.lockedFiles().size(), expected.lockedFiles().size());
+    for (qsizetype i = 0; i < expected.lockedFiles().size(); ++i) {
+        QCOMPARE(actual.lockedFiles()[i].lid, expected.lockedFiles()[i].lid);
+        QCOMPARE(actual.lockedFiles()[i].reason, expected.lockedFiles()[i].reason);
+    }
+    if (expected.next()) {
+        QCOMPARE(actual.next()->lid, expected.next()->lid);
+        QCOMPARE(actual.getAvsBPair().second.lid, expected.getAvsBPair().second.lid);
+    }
+    QCOMPARE(actual.needsUserChoice(), expected.needsUserChoice());
+}
+
+} // namespace
+
+// Every per-file question WatchSessionManager answers about a lid, as one string
+QString TestDeletionClassification::sessionHelperAnswers(const WatchSessionManager &manager, int lid,
+                                                         const QSet<int> &deletedEpisodes)
+{
+    return QStringList{
+        QString::number(manager.getEpisodeNumber(lid)),
+        QString::number(manager.getAnimeIdForFile(lid)),
+        QString::number(manager.getFileVersion(lid)),
+        QString::number(manager.getFileCountForEpisode(lid)),
+        QString::number(manager.getHigherVersionFileCount(lid)),
+        QString::number(manager.matchesPreferredAudioLanguage(lid)),
+        QString::number(manager.matchesPreferredSubtitleLanguage(lid)),
+        manager.getFileQuality(lid),
+        manager.getFileAudioLanguage(lid),
+        manager.getFileSubtitleLanguage(lid),
+        QString::number(manager.getFileRating(lid)),
+        QString::number(manager.getGroupStatus(manager.getFileGroupId(lid))),
+        QString::number(manager.getFileBitrate(lid)),
+        manager.getFileResolution(lid),
+        manager.getFileCodec(lid),
+        QString::number(manager.calculateExpectedBitrate(manager.getFileResolution(lid), manager.getFileCodec(lid))),
+        QString::number(manager.isLastFileForEpisode(lid)),
+        QString::number(manager.getEpisodeIdForFile(lid)),
+        QString::number(manager.wouldCreateGap(lid, deletedEpisodes))
+    }.join('|');
+}
+
+void TestDeletionClassification::init()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+    createSchema();
+}
+
+void TestDeletionClassification::cleanup()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+}
+
+void TestDeletionClassification::testSnapshotLoad()
+{
+    QSqlQuery q;
+    QVERIFY(q.exec("INSERT INTO anime VALUES (1, 'Alpha', 850, 0)"));
+    QVERIFY(q.exec("INSERT INTO `group` VALUES (7, 'Group', 'G', 3)"));
+    QVERIFY(q.exec("INSERT INTO file (fid, gid, state, quality, lang_dub, lang_sub) "
+                   "VALUES (10, 7, 8, 'high', 'japanese''english', 'english')"));
+    QVERIFY(q.exec("INSERT INTO file (fid, gid, state, quality) VALUES (11, 99, 0, NULL)"));
+    QVERIFY(q.exec("INSERT INTO local_files VALUES (1, '/a/1.mkv'), (2, '/a/2.mkv'), (3, '/a/3.mkv'), "
+                   "(4, NULL), (5, '/a/5.mkv')"));
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) VALUES (1, 10, 100, 1, 7, 1, 1, 1)"));
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) VALUES (2, 11, 100, 2, 0, 1, 0, 2)"));
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) VALUES (3, 12, 101, 1, 0, 3, 0, 3)"));   // deleted
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) VALUES (4, 10, 101, 1, 0, 1, 0, 4)"));   // no path
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) VALUES (6, 10, 101, 1, 0, 1, 0, 6)"));   // no local file
+
+    FileAttributeSnapshot snapshot;
+    QVERIFY(snapshot.load());
+    QCOMPARE(snapshot.size(), 3);
+    QCOMPARE(snapshot.deletionCandidates(), QList<int>({1, 2}));
+    QCOMPARE(snapshot.lidsForEpisode(100), QList<int>({1, 2}));
+    QCOMPARE(snapshot.lidsForEpisode(101), QList<int>({3}));
+    QVERIFY(!snapshot.file(4));
+    QVERIFY(!snapshot.file(6));
+
+    const FileAttributeSnapshot::File *first = snapshot.file(1);
+    QVERIFY(first);
+    QCOMPARE(first->path, QString("/a/1.mkv"));
+    QVERIFY(first->hasFile);
+    QCOMPARE(first->version(), 3);
+    QCOMPARE(first->quality, QString("high"));
+    QCOMPARE(first->groupStatus, 3);
+    QVERIFY(first->hasAnime);
+    QCOMPARE(first->animeName, QString("Alpha"));
+    QCOMPARE(first->animeRating, 850);
+    QVERIFY(snapshot.matchesPreferredAudioLanguage(1));
+    QVERIFY(snapshot.matchesPreferredSubtitleLanguage(1));
+
+    const FileAttributeSnapshot::File *second = snapshot.file(2);
+    QVERIFY(second);
+    QVERIFY(second->hasFile);
+    QVERIFY(second->quality.isNull());
+    QCOMPARE(second->groupStatus, 0);
+    QVERIFY(!second->hasAnime);
+    QVERIFY(!snapshot.matchesPreferredAudioLanguage(2));
+
+    // File row missing
+    QVERIFY(!snapshot.file(3)->hasFile);
+
+    QCOMPARE(snapshot.preferredSubtitleLanguages(), QStringList({"english", "german"}));
+}
+
+void TestDeletionClassification::testSnapshotMatchesPerFileClassification()
+{
+    populate(1500, 31);
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    lockManager.lockAnime(3);
+    lockManager.lockAnime(11);
+    lockManager.lockEpisode(40);
+    lockManager.lockEpisode(41);
+
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    FactorVector kept{}, deleted{};
+    kept[DeletionFactor::AnimeRating] = 0.9;
+    kept[DeletionFactor::GroupStatus] = 1.0;
+    deleted[DeletionFactor::AnimeRating] = 0.2;
+    deleted[DeletionFactor::GroupStatus] = 0.0;
+    learner.recordChoice(1, 2, kept, deleted);
+
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+
+    FileAttributeSnapshot snapshot;
+    QVERIFY(snapshot.load());
+    const QList<int> lids = snapshot.deletionCandidates();
+    QCOMPARE(QSet<int>(lids.cbegin(), lids.cend()), queriedCandidates());
+
+    QSet<int> tiers;
+    for (int lid : lids) {
+        const DeletionCandidate expected = classifier.classify(lid);
+        const DeletionCandidate actual = classifier.classify(lid, snapshot);
+        tiers.insert(actual.tier);
+
+        QCOMPARE(actual.lid, expected.lid);
+        QCOMPARE(actual.tier, expected.tier);
+        QCOMPARE(actual.reason, expected.reason);
+        QCOMPARE(actual.locked, expected.locked);
+        QCOMPARE(actual.aid, expected.aid);
+        QCOMPARE(actual.eid, expected.eid);
+        QCOMPARE(actual.filePath, expected.filePath);
+        QCOMPARE(actual.animeName, expected.animeName);
+        QCOMPARE(actual.replacementLid, expected.replacementLid);
+        QCOMPARE(actual.replacementPath, expected.replacementPath);
+        QCOMPARE(actual.learnedScore, expected.learnedScore);
+        QVERIFY(actual.factorValues == expected.factorValues);
+    }
+
+    // The random library exercises every tier
+    QCOMPARE(tiers, QSet<int>({DeletionTier::HIDDEN_ANIME, DeletionTier::SUPERSEDED_REVISION,
+                               DeletionTier::LOW_QUALITY_DUPLICATE, DeletionTier::LANGUAGE_MISMATCH,
+                               DeletionTier::LEARNED_PREFERENCE, DeletionTier::PROTECTED}));
+
+    // Lids without a local file are not part of the snapshot
+    QCOMPARE(classifier.classify(999999, snapshot).tier, DeletionTier::PROTECTED);
+}
+
+void TestDeletionClassification::testGroupStatusFactor()
+{
+    QSqlQuery q;
+    QVERIFY(q.exec("INSERT INTO `group` VALUES (1, 'Active', 'A', 1), (2, 'Disbanded', 'D', 3)"));
+    QVERIFY(q.exec("INSERT INTO file (fid, gid, state) VALUES (10, 1, 1), (11, 2, 1), (12, 5, 1)"));
+    QVERIFY(q.exec("INSERT INTO local_files VALUES (1, '/a/1.mkv'), (2, '/a/2.mkv'), (3, '/a/3.mkv')"));
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) VALUES (1, 10, 100, 1, 1, 1, 1, 1), (2, 11, 200, 1, 2, 1, 1, 2), "
+                   "(3, 12, 300, 1, 5, 1, 1, 3)"));
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    FactorWeightLearner learner;
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+
+    FileAttributeSnapshot snapshot;
+    QVERIFY(snapshot.load());
+    QCOMPARE(classifier.normalizeFactors(1)[DeletionFactor::GroupStatus], 1.0);
+    QCOMPARE(classifier.normalizeFactors(2)[DeletionFactor::GroupStatus], 0.0);
+    QCOMPARE(classifier.normalizeFactors(3)[DeletionFactor::GroupStatus], 0.5);
+    for (int lid : {1, 2, 3}) {
+        QVERIFY(classifier.normalizeFactors(*snapshot.file(lid)) == classifier.normalizeFactors(lid));
+    }
+}
+
+void TestDeletionClassification::testParallelMatchesSequential()
+{
+    populate(3000, 34);
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    lockManager.lockAnime(2);
+    lockManager.lockEpisode(9);
+
+    FileAttributeSnapshot snapshot;
+    QVERIFY(snapshot.load());
+    FactorVector weights{};
+    weights[DeletionFactor::AnimeRating] = 0.3;
+    weights[DeletionFactor::GroupStatus] = -0.2;
+
+    const QList<int> lids = snapshot.deletionCandidates();
+    const QList<DeletionCandidate> parallel = HybridDeletionClassifier::classifyAll(snapshot, weights);
+    QCOMPARE(parallel.size(), lids.size());
+    for (qsizetype i = 0; i < lids.size(); ++i) {
+        const DeletionCandidate expected = HybridDeletionClassifier::classify(lids[i], snapshot, weights);
+        QCOMPARE(parallel[i].lid, lids[i]);
+        QCOMPARE(parallel[i].tier, expected.tier);
+        QCOMPARE(parallel[i].reason, expected.reason);
+        QCOMPARE(parallel[i].locked, expected.locked);
+        QCOMPARE(parallel[i].replacementLid, expected.replacementLid);
+        QCOMPARE(parallel[i].learnedScore, expected.learnedScore);
+    }
+}
+
+void TestDeletionClassification::testRebuildPublishesInBackground()
+{
+    populate(2000, 35);
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+    DeletionQueue queue(classifier, lockManager, learner);
+    QSignalSpy rebuilt(&queue, &DeletionQueue::queueRebuilt);
+
+    // Nothing is published until classification finishes
+    const int expectedCount = static_cast<int>(queriedCandidates().size());
+    queue.rebuild();
+    QVERIFY(queue.candidates().isEmpty());
+    QCOMPARE(queue.totalClassified(), 0);
+
+    // Changes made while the workers run do not leak into the result
+    QSqlQuery q;
+    QVERIFY(q.exec("UPDATE mylist SET state = 3"));
+
+    QVERIFY(rebuilt.wait(10000));
+    QCOMPARE(rebuilt.count(), 1);
+    QVERIFY(!queue.isRebuilding());
+    QCOMPARE(queue.totalClassified(), expectedCount);
+    QCOMPARE(static_cast<int>(queue.candidates().size() + queue.lockedFiles().size()) + queue.protectedCount(),
+             queue.totalClassified());
+
+    const QList<DeletionCandidate> published = rebuilt.first().first().value<QList<DeletionCandidate>>();
+    QCOMPARE(published.size(), queue.candidates().size());
+    for (qsizetype i = 1; i < queue.candidates().size(); ++i) {
+        QVERIFY(!(queue.candidates()[i] < queue.candidates()[i - 1]));
+    }
+
+    // The next rebuild sees the change
+    queue.rebuild();
+    QVERIFY(rebuilt.wait(10000));
+    QCOMPARE(queue.totalClassified(), 0);
+}
+
+void TestDeletionClassification::testRebuildCoalescesRequests()
+{
+    populate(2000, 36);
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+    DeletionQueue queue(classifier, lockManager, learner);
+    QSignalSpy rebuilt(&queue, &DeletionQueue::queueRebuilt);
+
+    queue.rebuild();
+    lockManager.lockAnime(1);
+    queue.rebuild();
+    queue.rebuild();
+
+    // Only the result of the last request is published
+    QTRY_VERIFY_WITH_TIMEOUT(!queue.isRebuilding() && rebuilt.count() > 0, 10000);
+    QTest::qWait(50);
+    QCOMPARE(rebuilt.count(), 1);
+
+    bool animeLocked = false;
+    for (const DeletionCandidate &c : queue.lockedFiles()) {
+        QCOMPARE(c.aid, 1);
+        QCOMPARE(c.reason, QString("Anime locked (highest rated kept)"));
+        animeLocked = true;
+    }
+    QVERIFY(animeLocked);
+    for (const DeletionCandidate &c : queue.candidates()) {
+        QVERIFY(c.aid != 1);
+    }
+}
+
+void TestDeletionClassification::testRebuildLargeLibrary()
+{
+    populate(10000, 32);
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    lockManager.lockAnime(5);
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+    DeletionQueue queue(classifier, lockManager, learner);
+    QSignalSpy rebuilt(&queue, &DeletionQueue::queueRebuilt);
+
+    QElapsedTimer timer;
+    timer.start();
+    queue.rebuild();
+    const qint64 blocked = timer.elapsed();
+    QVERIFY(rebuilt.wait(30000));
+    const qint64 elapsed = timer.elapsed();
+    qDebug() << "rebuild of" << queue.totalClassified() << "local files took" << elapsed
+             << "ms, caller blocked for" << blocked << "ms";
+
+    QCOMPARE(queue.totalClassified(), static_cast<int>(queriedCandidates().size()));
+    QCOMPARE(static_cast<int>(queue.candidates().size() + queue.lockedFiles().size()) + queue.protectedCount(),
+             queue.totalClassified());
+    QVERIFY(!queue.lockedFiles().isEmpty());
+    for (qsizetype i = 1; i < queue.candidates().size(); ++i) {
+        QVERIFY(!(queue.candidates()[i] < queue.candidates()[i - 1]));
+    }
+}
+
+void TestDeletionClassification::testIncrementalMatchesRebuild()
+{
+    populate(2000, 37);
+
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+    DeletionQueue queue(classifier, lockManager, learner);
+    QSignalSpy rebuilt(&queue, &DeletionQueue::queueRebuilt);
+    QSignalSpy updated(&queue, &DeletionQueue::queueUpdated);
+    queue.rebuild();
+    QVERIFY(rebuilt.wait(10000));
+    QVERIFY(!queue.candidates().isEmpty());
+
+    // Locks
+    queue.lockAnime(3);
+    queue.lockAnime(4);
+    queue.unlockAnime(3);
+    const int lockedEid = queue.candidates().last().eid;
+    queue.lockEpisode(lockedEid);
+    queue.lockEpisode(queue.candidates().first().eid);
+    queue.unlockEpisode(lockedEid);
+
+    // The top candidate is deleted
+    const int deletedLid = queue.next()->lid;
+    QSqlQuery q;
+    q.prepare("UPDATE mylist SET state = 3 WHERE lid = ?");
+    q.addBindValue(deletedLid);
+    QVERIFY(q.exec());
+    queue.removeFile(deletedLid);
+    QVERIFY(!queue.candidate(deletedLid));
+
+    // A newer revision of a queued file is linked
+    const DeletionCandidate superseded = queue.candidates().last();
+    QVERIFY(q.exec("INSERT INTO local_files VALUES (90001, '/anime/new.mkv')"));
+    QVERIFY(q.exec("INSERT INTO file (fid, aid, eid, gid, state, quality) "
+                   "VALUES (190001, 1, " + QString::number(superseded.eid) + ", 1, 32, 'high')"));
+    QVERIFY(q.exec("INSERT INTO mylist (lid, fid, eid, aid, gid, state, viewed, local_file) "
+                   "VALUES (90001, 190001, " + QString::number(superseded.eid) + ", "
+                   + QString::number(superseded.aid) + ", 1, 1, 0, 90001)"));
+    queue.refreshFile(90001);
+
+    // A choice changes the learned weights
+    QList<int> learned;
+    for (const DeletionCandidate &c : queue.candidates()) {
+        if (c.tier == DeletionTier::LEARNED_PREFERENCE) learned.append(c.lid);
+    }
+    QVERIFY(learned.size() >= 2);
+    queue.recordChoice(learned[0], learned[1]);
+
+    QCOMPARE(rebuilt.count(), 1);
+    QVERIFY(updated.count() >= 9);
+    QVERIFY(!queue.lockedFiles().isEmpty());
+
+    DeletionQueue reference(classifier, lockManager, learner);
+    QSignalSpy referenceRebuilt(&reference, &DeletionQueue::queueRebuilt);
+    reference.rebuild();
+    QVERIFY(referenceRebuilt.wait(10000));
+    compareQueues(queue, reference);
+}
+
+void TestDeletionClassification::testSessionHelpersMatchSnapshot()
+{
+    populate(1500, 38);
+    QSqlQuery q;
+    QVERIFY(q.exec("INSERT INTO settings VALUES ('preferredBitrate', '5.5')"));
+    QVERIFY(q.exec("UPDATE anime SET rating = '7.45' WHERE aid % 3 = 0"));
+
+    WatchSessionManager manager;
+    QList<int> lids;
+    QVERIFY(q.exec("SELECT lid FROM mylist ORDER BY lid"));
+    while (q.next()) {
+        lids.append(q.value(0).toInt());
+    }
+    const QSet<int> deletedEpisodes{3 * 100000 + 2, 5 * 100000 + 1};
+
+    QStringList perLid;
+    for (int lid : lids) {
+        perLid.append(sessionHelperAnswers(manager, lid, deletedEpisodes));
+    }
+
+    QVERIFY(manager.loadFileAttributes());
+    QVERIFY(manager.hasFileAttributes());
+    for (qsizetype i = 0; i < lids.size(); ++i) {
+        QCOMPARE(sessionHelperAnswers(manager, lids[i], deletedEpisodes), perLid[i]);
+    }
+
+    manager.releaseFileAttributes();
+    QVERIFY(!manager.hasFileAttributes());
+}
+
+void TestDeletionClassification::benchmarkClassification_data()
+{
+    QTest::addColumn<bool>("snapshot");
+    QTest::newRow("per-file queries, 1k files") << false;
+    QTest::newRow("snapshot, 1k files") << true;
+}
+
+void TestDeletionClassification::benchmarkClassification()
+{
+    QFETCH(bool, snapshot);
+
+    populate(1000, 33);
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+
+    int classified = 0;
+    QBENCHMARK {
+        classified = 0;
+        if (snapshot) {
+            FileAttributeSnapshot attributes;
+            attributes.load();
+            for (int lid : attributes.deletionCandidates()) {
+                classifier.classify(lid, attributes);
+                ++classified;
+            }
+        } else {
+            for (int lid : queriedCandidates()) {
+                classifier.classify(lid);
+                ++classified;
+            }
+        }
+    }
+    QCOMPARE(classified, static_cast<int>(queriedCandidates().size()));
+}
+
+void TestDeletionClassification::benchmarkLockAnime_data()
+{
+    QTest::addColumn<bool>("incremental");
+    QTest::newRow("full rebuild, 10k files") << false;
+    QTest::newRow("incremental refresh, 10k files") << true;
+}
+
+void TestDeletionClassification::benchmarkLockAnime()
+{
+    QFETCH(bool, incremental);
+
+    populate(10000, 34);
+    DeletionLockManager lockManager;
+    lockManager.ensureTablesExist();
+    FactorWeightLearner learner;
+    learner.ensureTablesExist();
+    WatchSessionManager sessionManager;
+    HybridDeletionClassifier classifier(lockManager, learner, sessionManager);
+    DeletionQueue queue(classifier, lockManager, learner);
+    QSignalSpy rebuilt(&queue, &DeletionQueue::queueRebuilt);
+    queue.rebuild();
+    QVERIFY(rebuilt.wait(30000));
+
+    // Lock and unlock one anime, then read the next candidate
+    int aid = 1;
+    QBENCHMARK {
+        if (incremental) {
+            queue.lockAnime(aid);
+            queue.unlockAnime(aid);
+        } else {
+            lockManager.lockAnime(aid);
+            queue.rebuild();
+            QVERIFY(rebuilt.wait(30000));
+            lockManager.unlockAnime(aid);
+            queue.rebuild();
+            QVERIFY(rebuilt.wait(30000));
+        }
+        QVERIFY(queue.next());
+        aid = aid % 400 + 1;
+    }
+}
+
+void TestDeletionClassification::benchmarkSessionHelpers_data()
+{
+    QTest::addColumn<int>("fileCount");
+    QTest::addColumn<bool>("snapshot");
+    QTest::newRow("per-lid queries, 2k files") << 2000 << false;
+    QTest::newRow("snapshot, 2k files") << 2000 << true;
+    QTest::newRow("snapshot, 10k files") << 10000 << true;
+}
+
+void TestDeletionClassification::benchmarkSessionHelpers()
+{
+    QFETCH(int, fileCount);
+    QFETCH(bool, snapshot);
+
+    populate(fileCount, 39);
+    WatchSessionManager manager;
+    const QSet<int> lids = queriedCandidates();
+    const QSet<int> deletedEpisodes;
+
+    // One marking pass: load the snapshot (if used) and ask everything about every file
+    int answered = 0;
+    QBENCHMARK {
+        answered = 0;
+        if (snapshot) {
+            manager.loadFileAttributes();
+        }
+        for (int lid : lids) {
+            answered += sessionHelperAnswers(manager, lid, deletedEpisodes).isEmpty() ? 0 : 1;
+        }
+        manager.releaseFileAttributes();
+    }
+    QCOMPARE(answered, static_cast<int>(lids.size()));
+}
+
+QTEST_MAIN(TestDeletionClassification)
+#include "test_deletion_classification.moc"
@@ -0,0 +1,226 @@
+#include <QTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "../usagi/src/deletionpriorityqueue.h"
+
+/**
+ * Tests for DeletionPriorityQueue:
+ *   - Empty queue, top/second of one and two entries
+ *   - Ties on tier + score are broken by lid
+ *   - Random insert / replace / remove sequences agree with a sorted reference list
+ *   - Bulk assign and updateAll (rescoring) restore the heap order
+ *   - Benchmark: one changed candidate in a 10k queue, heap update vs re-sorting the list
+ */
+class TestDeletionPriorityQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmpty();
+    void testTopAndSecond();
+    void testTiesBrokenByLid();
+    void testRandomOperationsMatchSortedList();
+    void testAssignAndUpdateAll();
+
+    void benchmarkUpdateOne_data();
+    void benchmarkUpdateOne();
+};
+
+namespace {
+
+// Few tiers and coarse scores so ties are common
+DeletionCandidate makeCandidate(int lid, QRandomGenerator &rng)
+{
+    static const int tiers[] = {
+        DeletionTier::HIDDEN_ANIME, DeletionTier::SUPERSEDED_REVISION,
+        DeletionTier::LOW_QUALITY_DUPLICATE, DeletionTier::LANGUAGE_MISMATCH,
+        DeletionTier::LEARNED_PREFERENCE
+    };
+    DeletionCandidate c;
+    c.lid = lid;
+    c.aid = lid / 10;
+    c.tier = tiers[rng.bounded(5)];
+    c.learnedScore = c.tier == DeletionTier::LEARNED_PREFERENCE ? rng.bounded(20) / 10.0 : 0.0;
+    return c;
+}
+
+QList<int> lidsOf(const QList<DeletionCandidate> &candidates)
+{
+    QList<int> lids;
+    for (const DeletionCandidate &c : candidates) {
+        lids.append(c.lid);
+    }
+    return lids;
+}
+
+QList<int> sortedLids(QList<DeletionCandidate> candidates)
+{
+    std::sort(candidates.begin(), candidates.end(), &DeletionPriorityQueue::before);
+    return lidsOf(candidates);
+}
+
+} // namespace
+
+void TestDeletionPriorityQueue::testEmpty()
+{
+    DeletionPriorityQueue queue;
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.size(), 0);
+    QVERIFY(queue.top() == nullptr);
+    QVERIFY(queue.second() == nullptr);
+    QVERIFY(queue.find(1) == nullptr);
+    QVERIFY(!queue.remove(1));
+    QVERIFY(queue.sorted().isEmpty());
+}
+
+void TestDeletionPriorityQueue::testTopAndSecond()
+{
+    DeletionPriorityQueue queue;
+    DeletionCandidate learned;
+    learned.lid = 1;
+    learned.tier = DeletionTier::LEARNED_PREFERENCE;
+    learned.learnedScore = 0.5;
+    queue.insert(learned);
+    QCOMPARE(queue.top()->lid, 1);
+    QVERIFY(queue.second() == nullptr);
+
+    DeletionCandidate hidden;
+    hidden.lid = 2;
+    hidden.tier = DeletionTier::HIDDEN_ANIME;
+    queue.insert(hidden);
+    QCOMPARE(queue.top()->lid, 2);
+    QCOMPARE(queue.second()->lid, 1);
+
+    // Replacing an entry moves it to its new place
+    hidden.tier = DeletionTier::LEARNED_PREFERENCE;
+    hidden.learnedScore = 0.9;
+    queue.insert(hidden);
+    QCOMPARE(queue.size(), 2);
+    QCOMPARE(queue.top()->lid, 1);
+    QCOMPARE(queue.second()->lid, 2);
+    QCOMPARE(queue.find(2)->learnedScore, 0.9);
+
+    QVERIFY(queue.remove(1));
+    QVERIFY(!queue.contains(1));
+    QCOMPARE(queue.top()->lid, 2);
+}
+
+void TestDeletionPriorityQueue::testTiesBrokenByLid()
+{
+    DeletionPriorityQueue queue;
+    for (int lid : {5, 3, 9, 1}) {
+        DeletionCandidate c;
+        c.lid = lid;
+        c.tier = DeletionTier::SUPERSEDED_REVISION;
+        queue.insert(c);
+    }
+    QCOMPARE(lidsOf(queue.sorted()), QList<int>({1, 3, 5, 9}));
+    QCOMPARE(queue.top()->lid, 1);
+    QCOMPARE(queue.second()->lid, 3);
+}
+
+void TestDeletionPriorityQueue::testRandomOperationsMatchSortedList()
+{
+    QRandomGenerator rng(33);
+    DeletionPriorityQueue queue;
+    QHash<int, DeletionCandidate> reference;
+
+    for (int step = 0; step < 5000; ++step) {
+        const int lid = rng.bounded(1, 400);
+        if (rng.bounded(3) == 0) {
+            QCOMPARE(queue.remove(lid), reference.remove(lid));
+        } else {
+            const DeletionCandidate c = makeCandidate(lid, rng);
+            queue.insert(c);
+            reference.insert(lid, c);
+        }
+
+        QCOMPARE(queue.size(), static_cast<int>(reference.size()));
+        if (step % 50 != 0) {
+            continue;
+        }
+        const QList<int> expected = sortedLids(reference.values());
+        QCOMPARE(lidsOf(queue.sorted()), expected);
+        if (!expected.isEmpty()) {
+            QCOMPARE(queue.top()->lid, expected.at(0));
+        }
+        if (expected.size() > 1) {
+            QCOMPARE(queue.second()->lid, expected.at(1));
+        }
+    }
+}
+
+void TestDeletionPriorityQueue::testAssignAndUpdateAll()
+{
+    QRandomGenerator rng(7);
+    QList<DeletionCandidate> candidates;
+    for (int lid = 1; lid <= 1000; ++lid) {
+        candidates.append(makeCandidate(lid, rng));
+    }
+
+    DeletionPriorityQueue queue;
+    queue.assign(candidates);
+    QCOMPARE(queue.size(), 1000);
+    QCOMPARE(lidsOf(queue.sorted()), sortedLids(candidates));
+    for (const DeletionCandidate &c : candidates) {
+        QCOMPARE(queue.find(c.lid)->tier, c.tier);
+    }
+
+    // Rescoring reverses the learned-preference order
+    auto rescore = [](DeletionCandidate &c) {
+        if (c.tier == DeletionTier::LEARNED_PREFERENCE) {
+            c.learnedScore = 10.0 - c.learnedScore;
+        }
+    };
+    queue.updateAll(rescore);
+    for (DeletionCandidate &c : candidates) {
+        rescore(c);
+    }
+    QCOMPARE(lidsOf(queue.sorted()), sortedLids(candidates));
+
+    // Positions stay consistent after the bulk update
+    QVERIFY(queue.remove(500));
+    candidates.removeAt(499);
+    QCOMPARE(lidsOf(queue.sorted()), sortedLids(candidates));
+}
+
+void TestDeletionPriorityQueue::benchmarkUpdateOne_data()
+{
+    QTest::addColumn<bool>("heap");
+    QTest::newRow("sorted list") << false;
+    QTest::newRow("indexed heap") << true;
+}
+
+void TestDeletionPriorityQueue::benchmarkUpdateOne()
+{
+    QFETCH(bool, heap);
+
+    QRandomGenerator rng(10000);
+    QList<DeletionCandidate> candidates;
+    for (int lid = 1; lid <= 10000; ++lid) {
+        candidates.append(makeCandidate(lid, rng));
+    }
+    DeletionPriorityQueue queue;
+    queue.assign(candidates);
+
+    // Each iteration: one file changes (lock, deletion, ...) and the top two are read
+    int top = 0;
+    int lid = 1;
+    QBENCHMARK {
+        const DeletionCandidate changed = makeCandidate(lid, rng);
+        if (heap) {
+            queue.insert(changed);
+            top = queue.top()->lid + (queue.second() ? queue.second()->lid : 0);
+        } else {
+            candidates[lid - 1] = changed;
+            QList<DeletionCandidate> list = candidates;
+            std::sort(list.begin(), list.end());
+            top = list.at(0).lid + list.at(1).lid;
+        }
+        lid = lid % 10000 + 1;
+    }
+    QVERIFY(top > 0);
+}
+
+QTEST_MAIN(TestDeletionPriorityQueue)
+#include "test_deletionpriorityqueue.moc"
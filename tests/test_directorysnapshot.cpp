@@ -0,0 +1,359 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "../usagi/src/directorysnapshot.h"
+
+/**
+ * Tests for DirectorySnapshot:
+ *   - A first refresh returns the same files as a QDirIterator walk
+ *   - Unchanged directories are stat'd but not listed again
+ *   - A change deep in the tree relists only the changed directory
+ *   - Files recorded empty are re-stat'd; removed directories drop out
+ *   - Directories modified within the mtime granularity are listed again
+ *   - Rows survive a save/load round trip and only changed rows are written
+ *   - The persisted entry hash does not depend on the process
+ *   - Excluded subtrees (nested watch roots) are neither walked nor loaded nor deleted
+ *   - Benchmark: refresh of an unchanged tree vs. a full walk
+ */
+class TestDirectorySnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testFirstRefreshMatchesWalk();
+    void testUnchangedTreeIsNotListed();
+    void testNestedChangeListsOnlyThatDirectory();
+    void testEmptyFilesAndRemovedDirectories();
+    void testRecentDirectoriesAreNotTrusted();
+    void testPersistence();
+    void testEntryHashIsStable();
+    void testExcludedDirectories();
+    void benchmarkRefresh_data();
+    void benchmarkRefresh();
+};
+
+namespace {
+
+// Far enough in the future that every directory counts as settled
+qint64 settledNow()
+{
+    return QDateTime::currentMSecsSinceEpoch() + 60 * 1000;
+}
+
+bool writeFile(const QString &path, const QByteArray &content = "content")
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(content);
+    file.close();
+    return true;
+}
+
+QHash<QString, qint64> walk(const QString &root)
+{
+    QHash<QString, qint64> files;
+    QDirIterator it(root, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        files.insert(path, it.fileInfo().size());
+    }
+    return files;
+}
+
+// shows/show<N>/season<M>/ep<K>.mkv
+bool makeTree(const QString &root, int shows, int seasons, int episodes)
+{
+    for (int s = 0; s < shows; ++s) {
+        for (int m = 0; m < seasons; ++m) {
+            const QString directory = root + QString("/shows/show%1/season%2").arg(s).arg(m);
+            if (!QDir().mkpath(directory)) {
+                return false;
+            }
+            for (int e = 0; e < episodes; ++e) {
+                if (!writeFile(directory + QString("/ep%1.mkv").arg(e))) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void TestDirectorySnapshot::initTestCase()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+}
+
+void TestDirectorySnapshot::cleanupTestCase()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+}
+
+void TestDirectorySnapshot::testFirstRefreshMatchesWalk()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 3, 2, 4));
+    QVERIFY(writeFile(tempDir.path() + "/top.mkv"));
+    QVERIFY(writeFile(tempDir.path() + "/.hidden.mkv"));
+    QVERIFY(QDir().mkpath(tempDir.path() + "/.cache"));
+    QVERIFY(writeFile(tempDir.path() + "/.cache/skip.mkv"));
+    QVERIFY(QFile::link(tempDir.path() + "/top.mkv", tempDir.path() + "/link.mkv"));
+
+    DirectorySnapshot snapshot;
+    const QHash<QString, qint64> files = snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(files, walk(tempDir.path()));
+    QCOMPARE(files.size(), 3 * 2 * 4 + 1);
+
+    // root, shows, 3 shows, 6 seasons
+    QCOMPARE(snapshot.directoryCount(), 11);
+    QCOMPARE(snapshot.lastStats().directoriesListed, 11);
+}
+
+void TestDirectorySnapshot::testUnchangedTreeIsNotListed()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 3, 2, 4));
+
+    DirectorySnapshot snapshot;
+    const QHash<QString, qint64> first = snapshot.refresh(tempDir.path(), settledNow());
+    const QHash<QString, qint64> second = snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(second, first);
+
+    const DirectorySnapshot::Stats stats = snapshot.lastStats();
+    QCOMPARE(stats.directoriesChecked, 11);
+    QCOMPARE(stats.directoriesListed, 0);
+    QCOMPARE(stats.filesChecked, 0);
+}
+
+void TestDirectorySnapshot::testNestedChangeListsOnlyThatDirectory()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 3, 2, 4));
+
+    DirectorySnapshot snapshot;
+    snapshot.refresh(tempDir.path(), settledNow());
+
+    // Make sure the new mtime differs from the recorded one
+    QTest::qWait(20);
+    const QString season = tempDir.path() + "/shows/show1/season0";
+    QVERIFY(writeFile(season + "/ep9.mkv"));
+    QVERIFY(QFile::remove(season + "/ep0.mkv"));
+
+    const QHash<QString, qint64> files = snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(files, walk(tempDir.path()));
+    QVERIFY(files.contains(season + "/ep9.mkv"));
+    QVERIFY(!files.contains(season + "/ep0.mkv"));
+    QCOMPARE(snapshot.lastStats().directoriesListed, 1);
+    QCOMPARE(snapshot.lastStats().directoriesChecked, 11);
+}
+
+void TestDirectorySnapshot::testEmptyFilesAndRemovedDirectories()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 2, 1, 1));
+    const QString growing = tempDir.path() + "/shows/show0/season0/download.mkv";
+    QVERIFY(writeFile(growing, QByteArray()));
+
+    DirectorySnapshot snapshot;
+    QHash<QString, qint64> files = snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(files.value(growing, -1), qint64(0));
+
+    // Writing to a file does not touch its directory; the empty entry is re-stat'd anyway
+    QVERIFY(writeFile(growing, "now with content"));
+    files = snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(files.value(growing), qint64(16));
+    QCOMPARE(snapshot.lastStats().filesChecked, 1);
+
+    QTest::qWait(20);
+    const QString removed = tempDir.path() + "/shows/show1";
+    QVERIFY(QDir(removed).removeRecursively());
+    files = snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(files, walk(tempDir.path()));
+    QVERIFY(!snapshot.contains(removed));
+    QVERIFY(!snapshot.contains(removed + "/season0"));
+    QCOMPARE(snapshot.directoryCount(), 4);
+}
+
+void TestDirectorySnapshot::testRecentDirectoriesAreNotTrusted()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 1, 1, 2));
+
+    // Listed right after being modified: mtime not recorded
+    DirectorySnapshot snapshot;
+    snapshot.refresh(tempDir.path(), QDateTime::currentMSecsSinceEpoch());
+    QCOMPARE(snapshot.entry(tempDir.path() + "/shows/show0/season0").mtime, qint64(-1));
+
+    snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(snapshot.lastStats().directoriesListed, 4);
+    QVERIFY(snapshot.entry(tempDir.path() + "/shows/show0/season0").mtime > 0);
+
+    snapshot.refresh(tempDir.path(), settledNow());
+    QCOMPARE(snapshot.lastStats().directoriesListed, 0);
+}
+
+void TestDirectorySnapshot::testPersistence()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 2, 2, 3));
+
+    DirectorySnapshot snapshot;
+    const QHash<QString, qint64> files = snapshot.refresh(tempDir.path(), settledNow());
+    QVERIFY(snapshot.save());
+
+    QSqlQuery query(QSqlDatabase::database());
+    QVERIFY(query.exec("SELECT COUNT(*) FROM directory_snapshot") && query.next());
+    QCOMPARE(query.value(0).toInt(), snapshot.directoryCount());
+
+    // A fresh instance picks up the listing and does not list anything
+    DirectorySnapshot loaded;
+    QVERIFY(loaded.load(tempDir.path()));
+    QCOMPARE(loaded.directoryCount(), snapshot.directoryCount());
+    QCOMPARE(loaded.refresh(tempDir.path(), settledNow()), files);
+    QCOMPARE(loaded.lastStats().directoriesListed, 0);
+
+    // Only the changed row is rewritten; the vanished one is deleted
+    QTest::qWait(20);
+    QVERIFY(writeFile(tempDir.path() + "/shows/show0/season0/ep7.mkv"));
+    QVERIFY(QDir(tempDir.path() + "/shows/show1/season1").removeRecursively());
+    loaded.refresh(tempDir.path(), settledNow());
+    QVERIFY(query.exec("UPDATE directory_snapshot SET entries = NULL WHERE path = '" + tempDir.path() + "/shows'"));
+    QVERIFY(loaded.save());
+
+    // The untouched (and here corrupted) row was not rewritten
+    QVERIFY(query.exec("SELECT entries FROM directory_snapshot WHERE path = '" + tempDir.path() + "/shows'") && query.next());
+    QVERIFY(query.value(0).isNull());
+    QVERIFY(query.exec("SELECT COUNT(*) FROM directory_snapshot") && query.next());
+    QCOMPARE(query.value(0).toInt(), loaded.directoryCount());
+
+    // Unreadable rows are listed again
+    DirectorySnapshot reloaded;
+    QVERIFY(reloaded.load(tempDir.path()));
+    QCOMPARE(reloaded.directoryCount(), loaded.directoryCount() - 1);
+    QCOMPARE(reloaded.refresh(tempDir.path(), settledNow()), walk(tempDir.path()));
+    QCOMPARE(reloaded.lastStats().directoriesListed, 1);
+
+    // Rows of other roots are not loaded
+    DirectorySnapshot other;
+    QVERIFY(other.load(tempDir.path() + "/shows/show0"));
+    QCOMPARE(other.directoryCount(), 3);
+
+    QVERIFY(query.exec("DELETE FROM directory_snapshot"));
+}
+
+void TestDirectorySnapshot::testEntryHashIsStable()
+{
+    // Fixed value: qHash() would differ between runs and invalidate every saved row
+    DirectorySnapshot::FileEntry file;
+    file.name = "a.mkv";
+    file.size = 10;
+    QCOMPARE(DirectorySnapshot::hashEntries({file}, {QString::fromUtf8("s\xC3\xBC" "b")}),
+             Q_UINT64_C(0x5941ecddf39f615d));
+
+    // Sizes count, and a file is not mistaken for a subdirectory of the same name
+    const quint64 hash = DirectorySnapshot::hashEntries({file}, {});
+    file.size = 11;
+    QVERIFY(DirectorySnapshot::hashEntries({file}, {}) != hash);
+    QVERIFY(DirectorySnapshot::hashEntries({}, {"a.mkv"}) != hash);
+}
+
+void TestDirectorySnapshot::testExcludedDirectories()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 2, 2, 3));
+    const QString nested = tempDir.path() + "/shows/show1";
+
+    // The nested root's own snapshot
+    DirectorySnapshot inner;
+    QCOMPARE(inner.refresh(nested, settledNow()).size(), 6);
+    QVERIFY(inner.save());
+
+    DirectorySnapshot outer;
+    outer.setExcludedDirectories({nested});
+    const QHash<QString, qint64> files = outer.refresh(tempDir.path(), settledNow());
+    QCOMPARE(files.size(), 6);
+    for (auto it = files.cbegin(); it != files.cend(); ++it) {
+        QVERIFY(!it.key().startsWith(nested + '/'));
+    }
+    QCOMPARE(outer.directoryCount(), 5);  // root, shows, show0 and its two seasons
+    QVERIFY(outer.save());
+
+    // Loading leaves the nested rows out, and saving does not delete them
+    DirectorySnapshot loaded;
+    loaded.setExcludedDirectories({nested});
+    QVERIFY(loaded.load(tempDir.path()));
+    QCOMPARE(loaded.directoryCount(), 5);
+    QVERIFY(loaded.save());
+    QSqlQuery query(QSqlDatabase::database());
+    QVERIFY(query.exec("SELECT COUNT(*) FROM directory_snapshot") && query.next());
+    QCOMPARE(query.value(0).toInt(), 5 + inner.directoryCount());
+
+    // Excluding a directory of a loaded snapshot forgets its rows the same way
+    DirectorySnapshot whole;
+    QVERIFY(whole.load(tempDir.path()));
+    QCOMPARE(whole.directoryCount(), 5 + inner.directoryCount());
+    whole.setExcludedDirectories({nested});
+    QCOMPARE(whole.directoryCount(), 5);
+    QVERIFY(whole.save());
+    QVERIFY(query.exec("SELECT COUNT(*) FROM directory_snapshot") && query.next());
+    QCOMPARE(query.value(0).toInt(), 5 + inner.directoryCount());
+
+    QVERIFY(query.exec("DELETE FROM directory_snapshot"));
+}
+
+void TestDirectorySnapshot::benchmarkRefresh_data()
+{
+    QTest::addColumn<bool>("fullWalk");
+
+    QTest::newRow("full walk, 2400 files") << true;
+    QTest::newRow("snapshot, 2400 files") << false;
+}
+
+void TestDirectorySnapshot::benchmarkRefresh()
+{
+    QFETCH(bool, fullWalk);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(makeTree(tempDir.path(), 50, 2, 24));
+
+    if (fullWalk) {
+        QBENCHMARK {
+            QCOMPARE(walk(tempDir.path()).size(), 2400);
+        }
+    } else {
+        DirectorySnapshot snapshot;
+        snapshot.refresh(tempDir.path(), settledNow());
+        QBENCHMARK {
+            QCOMPARE(snapshot.refresh(tempDir.path(), settledNow()).size(), 2400);
+        }
+    }
+}
+
+QTEST_MAIN(TestDirectorySnapshot)
+#include "test_directorysnapshot.moc"
@@ -1,6 +1,7 @@
 #include <QTest>
 #include <QTemporaryDir>
 #include <QFile>
+#include <QDir>
 #include <QSignalSpy>
 #include <QSqlDatabase>
 #include <QSqlQuery>
@@ -21,6 +22,8 @@ private slots:
     void testProcessedFilesTracking();
     void testDatabaseStatusFiltering();
     void testFileDeletionDetection();
+    void testStabilityDelayHoldsOpenFile();
+    void testExcludedDirectoryNotReported();
 };
 
 void TestDirectoryWatcher::testInitialization()
@@ -273,5 +276,75 @@ void TestDirectoryWatcher::testFileDeletionDetection()
     QVERIFY(deletedFiles.contains(testFilePath));
 }
 
+void TestDirectoryWatcher::testStabilityDelayHoldsOpenFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    
+    DirectoryWatcher watcher;
+    QCOMPARE(watcher.stabilityDelay(), 0);
+    watcher.setStabilityDelay(60000);
+    QSignalSpy spy(&watcher, &DirectoryWatcher::newFilesDetected);
+    watcher.startWatching(tempDir.path());
+    if (!watcher.usesNativeBackend()) {
+        QSKIP("Close-write events need the native backend");
+    }
+    QTest::qWait(500);
+    
+    // Still open for writing: detected but held back
+    QString testFilePath = tempDir.path() + "/downloading.mkv";
+    QFile testFile(testFilePath);
+    QVERIFY(testFile.open(QIODevice::WriteOnly));
+    testFile.write("first part");
+    testFile.flush();
+    QTest::qWait(1500);
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(watcher.pendingStabilityCount(), 1);
+    
+    // Closing it releases the file after the settle time, long before the quiet period
+    testFile.write("second part");
+    testFile.close();
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 1, 5000);
+    QCOMPARE(spy.first().first().toStringList(), QStringList{testFilePath});
+    QCOMPARE(watcher.pendingStabilityCount(), 0);
+}
+
+void TestDirectoryWatcher::testExcludedDirectoryNotReported()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString nested = tempDir.path() + "/nested";
+    QVERIFY(QDir().mkpath(nested));
+    
+    // One file in the watched root, one below a nested root watched by another watcher
+    const QString outerFile = tempDir.path() + "/outer.mkv";
+    const QString nestedFile = nested + "/inner.mkv";
+    for (const QString &path : {outerFile, nestedFile}) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("test content");
+        file.close();
+    }
+    
+    DirectoryWatcher watcher;
+    QSignalSpy spy(&watcher, &DirectoryWatcher::newFilesDetected);
+    watcher.setExcludedDirectories({nested});
+    watcher.startWatching(tempDir.path());
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 1, 5000);
+    
+    // Files created later below the nested root are not reported either
+    QFile laterFile(nested + "/later.mkv");
+    QVERIFY(laterFile.open(QIODevice::WriteOnly));
+    laterFile.write("test content");
+    laterFile.close();
+    QTest::qWait(3000);
+    
+    QStringList detectedFiles;
+    for (int i = 0; i < spy.count(); ++i) {
+        detectedFiles.append(spy.at(i).first().toStringList());
+    }
+    QCOMPARE(detectedFiles, QStringList{outerFile});
+}
+
 QTEST_MAIN(TestDirectoryWatcher)
 #include "test_directorywatcher.moc"
@@ -0,0 +1,252 @@
+#include <QTest>
+#include <QHash>
+#include "../usagi/src/filestabilitytracker.h"
+
+/**
+ * Tests for FileStabilityTracker (with a fake file system and clock):
+ *   - Files untouched for a quiet period are released on their first check
+ *   - Growing files are held until size and mtime stop changing
+ *   - Close-write releases after the settle time unless written again
+ *   - Empty files are held; vanished files are dropped and reported
+ *   - Poll intervals back off but never pass the release moment
+ *   - Released files keep the order they were added in
+ *   - Files added with a quiet first observation are released without a stat
+ */
+class TestFileStabilityTracker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testOldFilesReleasedAtOnce();
+    void testGrowingFileHeldUntilQuiet();
+    void testCloseWriteFastPath();
+    void testEmptyAndVanishedFiles();
+    void testBackoff();
+    void testReleaseOrder();
+    void testAddWithObservation();
+};
+
+namespace {
+
+constexpr qint64 START_MS = 1700000000000LL;
+
+// In-memory file system for the tracker
+struct FakeFiles {
+    QHash<QString, FileStabilityTracker::Observation> files;
+    int stats = 0;
+
+    void write(const QString &path, qint64 size, qint64 nowMs)
+    {
+        files[path] = FileStabilityTracker::Observation{true, size, nowMs};
+    }
+
+    FileStabilityTracker tracker()
+    {
+        return FileStabilityTracker([this](const QString &path) {
+            ++stats;
+            return files.value(path);
+        });
+    }
+};
+
+} // namespace
+
+void TestFileStabilityTracker::testOldFilesReleasedAtOnce()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(10000);
+
+    fs.write("/dl/old.mkv", 100, START_MS - 60000);
+    fs.write("/dl/new.mkv", 100, START_MS - 1000);
+    tracker.add("/dl/old.mkv", START_MS);
+    tracker.add("/dl/new.mkv", START_MS);
+    QCOMPARE(tracker.nextCheckMs(), START_MS);
+
+    QCOMPARE(tracker.poll(START_MS), QStringList{"/dl/old.mkv"});
+    QVERIFY(tracker.contains("/dl/new.mkv"));
+    QCOMPARE(tracker.nextCheckMs(), START_MS + FileStabilityTracker::MIN_POLL_MS);
+
+    // The backed-off check lands exactly where the quiet period ends (mtime + 10 s)
+    QVERIFY(tracker.poll(START_MS + 8999).isEmpty());
+    QCOMPARE(tracker.nextCheckMs(), START_MS + 9000);
+    QCOMPARE(tracker.poll(START_MS + 9000), QStringList{"/dl/new.mkv"});
+    QCOMPARE(tracker.pendingCount(), 0);
+    QCOMPARE(tracker.nextCheckMs(), qint64(-1));
+
+    // Quiet period 0: anything non-empty is released at once
+    tracker.setQuietPeriod(0);
+    fs.write("/dl/fresh.mkv", 1, START_MS + 9000);
+    tracker.add("/dl/fresh.mkv", START_MS + 9000);
+    QCOMPARE(tracker.poll(START_MS + 9000), QStringList{"/dl/fresh.mkv"});
+}
+
+void TestFileStabilityTracker::testGrowingFileHeldUntilQuiet()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(5000);
+
+    qint64 now = START_MS;
+    fs.write("/dl/ep.mkv", 1000, now);
+    tracker.add("/dl/ep.mkv", now);
+
+    // Keeps growing for two minutes: never released
+    qint64 size = 1000;
+    while (now < START_MS + 120000) {
+        now = tracker.nextCheckMs();
+        QVERIFY(tracker.poll(now).isEmpty());
+        size += 1000;
+        fs.write("/dl/ep.mkv", size, now);
+    }
+
+    // Stops changing: released once the quiet period after the last write has passed
+    const qint64 lastWrite = now;
+    QStringList released;
+    while (released.isEmpty()) {
+        now = tracker.nextCheckMs();
+        QVERIFY(now > 0);
+        released = tracker.poll(now);
+    }
+    QCOMPARE(released, QStringList{"/dl/ep.mkv"});
+    QVERIFY(now >= lastWrite + 5000);
+    QVERIFY(now <= lastWrite + 5000 + FileStabilityTracker::MAX_POLL_MS);
+}
+
+void TestFileStabilityTracker::testCloseWriteFastPath()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(60000);
+
+    fs.write("/dl/ep.mkv", 500, START_MS);
+    tracker.add("/dl/ep.mkv", START_MS);
+    QVERIFY(tracker.poll(START_MS).isEmpty());
+
+    // Closed after writing: only the settle time is waited for
+    fs.write("/dl/ep.mkv", 800, START_MS + 1000);
+    tracker.noteClosed("/dl/ep.mkv", START_MS + 1000);
+    QCOMPARE(tracker.nextCheckMs(), START_MS + 1000 + FileStabilityTracker::CLOSE_SETTLE_MS);
+    QVERIFY(tracker.poll(START_MS + 2000).isEmpty());
+    QCOMPARE(tracker.poll(START_MS + 3000), QStringList{"/dl/ep.mkv"});
+
+    // Written again after the close (a client reopening the file): back to waiting
+    fs.write("/dl/other.mkv", 500, START_MS);
+    tracker.noteClosed("/dl/other.mkv", START_MS);
+    QVERIFY(tracker.contains("/dl/other.mkv"));
+    fs.write("/dl/other.mkv", 900, START_MS + 1500);
+    QVERIFY(tracker.poll(START_MS + 2000).isEmpty());
+    QVERIFY(tracker.poll(START_MS + 30000).isEmpty());
+    QVERIFY(tracker.contains("/dl/other.mkv"));
+    QCOMPARE(tracker.poll(START_MS + 1500 + 60000), QStringList{"/dl/other.mkv"});
+}
+
+void TestFileStabilityTracker::testEmptyAndVanishedFiles()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(1000);
+
+    fs.write("/dl/empty.mkv", 0, START_MS - 60000);
+    fs.write("/dl/part.tmp", 10, START_MS);
+    tracker.add("/dl/empty.mkv", START_MS);
+    tracker.add("/dl/part.tmp", START_MS);
+    QVERIFY(tracker.poll(START_MS).isEmpty());
+
+    // Renamed away before it was complete
+    fs.files.remove("/dl/part.tmp");
+    QStringList vanished;
+    QVERIFY(tracker.poll(START_MS + 60000, &vanished).isEmpty());
+    QCOMPARE(vanished, QStringList{"/dl/part.tmp"});
+    QVERIFY(!tracker.contains("/dl/part.tmp"));
+    QVERIFY(tracker.contains("/dl/empty.mkv"));
+
+    fs.write("/dl/empty.mkv", 10, START_MS + 60000);
+    QCOMPARE(tracker.poll(START_MS + 120000), QStringList{"/dl/empty.mkv"});
+
+    tracker.add("/dl/gone.mkv", START_MS);
+    tracker.remove("/dl/gone.mkv");
+    QCOMPARE(tracker.pendingCount(), 0);
+}
+
+void TestFileStabilityTracker::testBackoff()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(24 * 3600 * 1000LL);
+
+    qint64 now = START_MS;
+    fs.write("/dl/ep.mkv", 1, now);
+    tracker.add("/dl/ep.mkv", now);
+
+    // Intervals double up to the cap
+    QList<qint64> intervals;
+    for (int i = 0; i < 10; ++i) {
+        tracker.poll(now);
+        const qint64 next = tracker.nextCheckMs();
+        intervals.append(next - now);
+        now = next;
+        fs.write("/dl/ep.mkv", i + 2, now);
+    }
+    QCOMPARE(intervals.first(), FileStabilityTracker::MIN_POLL_MS);
+    QCOMPARE(intervals.at(1), 2 * FileStabilityTracker::MIN_POLL_MS);
+    QCOMPARE(intervals.last(), FileStabilityTracker::MAX_POLL_MS);
+
+    // A download of an hour costs about a hundred stats, not thousands
+    fs.stats = 0;
+    while (now < START_MS + 3600 * 1000) {
+        tracker.poll(now);
+        now = tracker.nextCheckMs();
+        fs.write("/dl/ep.mkv", now - START_MS, now);
+    }
+    QVERIFY(fs.stats <= 3600 / (FileStabilityTracker::MAX_POLL_MS / 1000) + 1);
+}
+
+void TestFileStabilityTracker::testReleaseOrder()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(1000);
+
+    QStringList expected;
+    for (int i = 0; i < 50; ++i) {
+        const QString path = QString("/dl/ep%1.mkv").arg(i);
+        fs.write(path, 10, START_MS - 5000);
+        tracker.add(path, START_MS);
+        expected.append(path);
+    }
+    QCOMPARE(tracker.poll(START_MS), expected);
+}
+
+void TestFileStabilityTracker::testAddWithObservation()
+{
+    FakeFiles fs;
+    FileStabilityTracker tracker = fs.tracker();
+    tracker.setQuietPeriod(10000);
+
+    // Seen by the scan: one untouched for a minute, one written just now
+    fs.write("/dl/old.mkv", 100, START_MS - 60000);
+    fs.write("/dl/new.mkv", 50, START_MS - 1000);
+    tracker.add("/dl/old.mkv", START_MS, fs.files.value("/dl/old.mkv"));
+    tracker.add("/dl/new.mkv", START_MS, fs.files.value("/dl/new.mkv"));
+    QCOMPARE(tracker.nextCheckMs(), START_MS);
+
+    QCOMPARE(tracker.poll(START_MS), QStringList{"/dl/old.mkv"});
+    QCOMPARE(fs.stats, 0);
+
+    // The recent one is checked once its quiet period could have ended
+    QCOMPARE(tracker.nextCheckMs(), START_MS + 1000);
+    QCOMPARE(tracker.poll(START_MS + 9000), QStringList{"/dl/new.mkv"});
+    QCOMPARE(fs.stats, 1);
+
+    // A close after the add needs a real check again
+    fs.write("/dl/again.mkv", 10, START_MS - 60000);
+    tracker.add("/dl/again.mkv", START_MS + 9000, fs.files.value("/dl/again.mkv"));
+    fs.write("/dl/again.mkv", 20, START_MS + 9000);
+    tracker.noteClosed("/dl/again.mkv", START_MS + 9000);
+    QVERIFY(tracker.poll(START_MS + 10000).isEmpty());
+    QCOMPARE(tracker.poll(START_MS + 11000), QStringList{"/dl/again.mkv"});
+}
+
+QTEST_MAIN(TestFileStabilityTracker)
+#include "test_filestabilitytracker.moc"
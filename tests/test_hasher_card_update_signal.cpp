@@ -4,6 +4,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include "../usagi/src/hashercoordinator.h"
+#include "../usagi/src/hashingjobmodel.h"
 #include "../usagi/src/anidbapi.h"
 #include "../usagi/src/logger.h"
 #include "../usagi/src/main.h"
@@ -14,6 +15,9 @@
  * 
  * This addresses the issue where files already in mylist weren't triggering
  * card updates after being hashed.
+ *
+ * Also covers the batched identification of hashed files: a queued file is
+ * identified, linked and reported to the hasher table when the batch flushes.
  */
 class TestHasherCardUpdateSignal : public QObject
 {
@@ -23,6 +27,7 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void testFileLinkedToMylistSignalEmitted();
+    void testBatchedIdentification();
 
 private:
     QScopedPointer<AniDBApi> m_api;
@@ -115,5 +120,39 @@ void TestHasherCardUpdateSignal::testFileLinkedToMylistSignalEmitted()
     QCOMPARE(arguments.at(0).toInt(), 1);
 }
 
+void TestHasherCardUpdateSignal::testBatchedIdentification()
+{
+    QSignalSpy spy(m_hasher.data(), &HasherCoordinator::fileLinkedToMylist);
+    
+    HashingJobModel *jobs = m_hasher->getHashingJobs();
+    m_hasher->hashesInsertRow(QFileInfo("/test/file.mkv"), Qt::Unchecked, "testhash123");
+    const int jobId = jobs->jobAt(jobs->rowCount() - 1).id;
+    
+    HashingTask task("/test/file.mkv", "file.mkv", "testhash123", 1024);
+    task.setJobId(jobId);
+    task.setAddToMylist(true);
+    m_hasher->queueHashedFileForProcessing(task);
+    
+    // Nothing happens until the batch flushes
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toInt(), 1);
+    
+    // The table got the LocalIdentify result, no API call was needed
+    const HashingJobModel::Job *job = jobs->job(jobId);
+    QVERIFY(job);
+    QVERIFY(job->inLocalDatabase == HashingJobModel::Flag::Yes);
+    QVERIFY(job->inLocalMylist == HashingJobModel::Flag::Yes);
+    QCOMPARE(job->fileTag, QString("0"));
+    QCOMPARE(job->mylistTag, QString("0"));
+    
+    // The hash was stored with the file known to AniDB
+    QSqlQuery query(QSqlDatabase::database());
+    QVERIFY(query.exec("SELECT ed2k_hash, status FROM local_files WHERE path = '/test/file.mkv'"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString("testhash123"));
+    QCOMPARE(query.value(1).toInt(), 2);
+}
+
 QTEST_MAIN(TestHasherCardUpdateSignal)
 #include "test_hasher_card_update_signal.moc"
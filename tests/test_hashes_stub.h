@@ -1,14 +1,14 @@
 #ifndef TEST_HASHES_STUB_H
 #define TEST_HASHES_STUB_H
 
-#include <QTableWidget>
+#include <QTableView>
 #include <QEvent>
 
 /**
  * Minimal declaration of hashes_ class for test purposes
  * This avoids including window.h which would pull in the entire Window class
  */
-class hashes_ : public QTableWidget
+class hashes_ : public QTableView
 {
     Q_OBJECT
 public:
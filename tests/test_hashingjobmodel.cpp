@@ -0,0 +1,235 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QScopedPointer>
+#include <QFile>
+#include <QDir>
+#include "../usagi/src/hashingjobmodel.h"
+
+/**
+ * Tests for HashingJobModel:
+ *   - New jobs are pending, preloaded hashes make them hashed; status text is unchanged
+ *   - A finished hash finds its job by file name and size, assigned jobs first
+ *   - The next file to hash follows root priority, hasher caps and row order
+ *   - API tags map back to their job until replaced or cleared with "0"
+ *   - Removing scattered rows keeps ids, tags and pending files consistent
+ *   - Stopping the hasher puts assigned jobs back in the pending list
+ */
+class TestHashingJobModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testAddJob();
+    void testFindUnhashed();
+    void testNextToHash();
+    void testTagLookup();
+    void testRemoveRows();
+    void testResetAssigned();
+
+private:
+    QString createFile(const QString &relativePath, int size);
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+namespace {
+
+WatchRoot makeRoot(const QString &path, int maxHashers, int priority)
+{
+    WatchRoot root;
+    root.path = path;
+    root.maxHashers = maxHashers;
+    root.priority = priority;
+    return root;
+}
+
+} // namespace
+
+void TestHashingJobModel::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+QString TestHashingJobModel::createFile(const QString &relativePath, int size)
+{
+    const QString path = m_dir->filePath(relativePath);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QByteArray(size, 'x'));
+    }
+    return QFileInfo(path).absoluteFilePath();
+}
+
+void TestHashingJobModel::testAddJob()
+{
+    HashingJobModel model;
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    const int pending = model.addJob(QFileInfo(createFile("a.mkv", 10)));
+    const int hashed = model.addJob(QFileInfo(createFile("b.mkv", 20)), "abcdef");
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(model.rowCount(), 2);
+    QVERIFY(pending != hashed);
+
+    QCOMPARE(model.job(pending)->state, HashingJobModel::State::Pending);
+    QCOMPARE(model.job(hashed)->state, HashingJobModel::State::Hashed);
+    QCOMPARE(model.job(hashed)->size, qint64(20));
+
+    QCOMPARE(model.data(model.index(0, HashingJobModel::FilenameColumn)).toString(), QString("a.mkv"));
+    QCOMPARE(model.data(model.index(0, HashingJobModel::StatusColumn)).toString(), QString("0"));
+    QCOMPARE(model.data(model.index(1, HashingJobModel::StatusColumn)).toString(), QString("1"));
+    QCOMPARE(model.data(model.index(1, HashingJobModel::HashColumn)).toString(), QString("abcdef"));
+    QCOMPARE(model.data(model.index(0, HashingJobModel::RemoteFileColumn)).toString(), QString("?"));
+
+    model.setLocalIdentify(hashed, true, false);
+    QCOMPARE(model.data(model.index(1, HashingJobModel::LocalFileColumn)).toString(), QString("1"));
+    QCOMPARE(model.data(model.index(1, HashingJobModel::LocalListColumn)).toString(), QString("0"));
+
+    QCOMPARE(model.pendingFilePaths(), QStringList{model.job(pending)->filePath});
+}
+
+void TestHashingJobModel::testFindUnhashed()
+{
+    HashingJobModel model;
+    // Same name in two directories, different sizes
+    const int first = model.addJob(QFileInfo(createFile("one/ep01.mkv", 100)));
+    const int second = model.addJob(QFileInfo(createFile("two/ep01.mkv", 200)));
+
+    QCOMPARE(model.findUnhashed("ep01.mkv", 200), second);
+    QCOMPARE(model.findUnhashed("ep01.mkv", 100), first);
+    QCOMPARE(model.findUnhashed("ep02.mkv", 100), 0);
+
+    // An assigned job wins over a pending one of the same size
+    const int third = model.addJob(QFileInfo(createFile("three/ep01.mkv", 100)));
+    model.setState(third, HashingJobModel::State::Assigned);
+    QCOMPARE(model.findUnhashed("ep01.mkv", 100), third);
+
+    // Hashed jobs are no longer candidates
+    model.setState(third, HashingJobModel::State::Hashed);
+    QCOMPARE(model.findUnhashed("ep01.mkv", 100), first);
+
+    // The only assigned job of that name takes a hash whose size changed
+    model.setState(second, HashingJobModel::State::Assigned);
+    QCOMPARE(model.findUnhashed("ep01.mkv", 250), second);
+}
+
+void TestHashingJobModel::testNextToHash()
+{
+    HashingJobModel model;
+    const QString nas = m_dir->filePath("nas");
+    const QString ssd = m_dir->filePath("ssd");
+
+    const int loose = model.addJob(QFileInfo(createFile("loose.mkv", 1)));
+    const int nas1 = model.addJob(QFileInfo(createFile("nas/a.mkv", 1)));
+    const int nas2 = model.addJob(QFileInfo(createFile("nas/b.mkv", 1)));
+    const int ssd1 = model.addJob(QFileInfo(createFile("ssd/a.mkv", 1)));
+
+    // Without roots: row order
+    QCOMPARE(model.nextToHash(QStringList()), loose);
+
+    // Roots set after the jobs were queued regroup them
+    model.setWatchRoots({makeRoot(nas, 1, 10), makeRoot(ssd, 0, 5)});
+    QCOMPARE(model.nextToHash(QStringList()), nas1);
+
+    // The NAS is at its cap while one of its files is hashed
+    model.setState(nas1, HashingJobModel::State::Assigned);
+    const QStringList hashing{model.job(nas1)->filePath};
+    QCOMPARE(model.nextToHash(hashing), ssd1);
+
+    model.setState(ssd1, HashingJobModel::State::Assigned);
+    QCOMPARE(model.nextToHash(hashing), loose);
+
+    model.setState(loose, HashingJobModel::State::Assigned);
+    QCOMPARE(model.nextToHash(hashing), 0);
+    QCOMPARE(model.pendingCount(), 1);
+
+    // Once the NAS file is done its next file is free to go
+    QCOMPARE(model.nextToHash(QStringList()), nas2);
+}
+
+void TestHashingJobModel::testTagLookup()
+{
+    HashingJobModel model;
+    const int first = model.addJob(QFileInfo(createFile("a.mkv", 1)), "hash-a");
+    const int second = model.addJob(QFileInfo(createFile("b.mkv", 1)), "hash-b");
+
+    model.setFileTag(first, "t1");
+    model.setMylistTag(first, "t2");
+    model.setFileTag(second, "0");
+    model.setMylistTag(second, "t3");
+
+    QCOMPARE(model.jobIdForTag("t1"), first);
+    QCOMPARE(model.jobIdForTag("t2"), first);
+    QCOMPARE(model.jobIdForTag("t3"), second);
+    QCOMPARE(model.jobIdForTag("0"), 0);
+    QVERIFY(model.job(first)->hasPendingApiCall());
+    QCOMPARE(model.data(model.index(1, HashingJobModel::RemoteFileColumn)).toString(), QString("0"));
+
+    // A replaced tag no longer points at the job
+    model.setMylistTag(first, "0");
+    QCOMPARE(model.jobIdForTag("t2"), 0);
+    model.setFileTag(first, "0");
+    QVERIFY(!model.job(first)->hasPendingApiCall());
+
+    model.setState(second, HashingJobModel::State::AddedToMylist);
+    QCOMPARE(model.data(model.index(1, HashingJobModel::StatusColumn)).toString(), QString("3"));
+    QVERIFY(model.data(model.index(1, HashingJobModel::FilenameColumn), Qt::BackgroundRole).isValid());
+}
+
+void TestHashingJobModel::testRemoveRows()
+{
+    HashingJobModel model;
+    QList<int> ids;
+    for (int i = 0; i < 6; ++i) {
+        ids.append(model.addJob(QFileInfo(createFile(QString("f%1.mkv").arg(i), 1))));
+    }
+    model.setMylistTag(ids.at(4), "t4");
+
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    // Unsorted, with a duplicate: rows 1 and 2 form one block, row 5 another
+    model.removeRowsAt({5, 1, 2, 1});
+    QCOMPARE(removed.count(), 2);
+    QCOMPARE(model.rowCount(), 3);
+
+    QVERIFY(!model.job(ids.at(1)));
+    QVERIFY(!model.job(ids.at(5)));
+    QCOMPARE(model.rowOf(ids.at(0)), 0);
+    QCOMPARE(model.rowOf(ids.at(3)), 1);
+    QCOMPARE(model.rowOf(ids.at(4)), 2);
+    QCOMPARE(model.jobIdForTag("t4"), ids.at(4));
+    QCOMPARE(model.findUnhashed("f2.mkv", 1), 0);
+    QCOMPARE(model.pendingCount(), 3);
+    QCOMPARE(model.nextToHash(QStringList()), ids.at(0));
+
+    QVERIFY(model.removeRows(0, 2));
+    QCOMPARE(model.rowOf(ids.at(4)), 0);
+    QCOMPARE(model.pendingFilePaths(), QStringList{model.job(ids.at(4))->filePath});
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.jobIdForTag("t4"), 0);
+    QCOMPARE(model.pendingCount(), 0);
+}
+
+void TestHashingJobModel::testResetAssigned()
+{
+    HashingJobModel model;
+    const int first = model.addJob(QFileInfo(createFile("a.mkv", 1)));
+    const int second = model.addJob(QFileInfo(createFile("b.mkv", 1)));
+    model.setState(first, HashingJobModel::State::Assigned);
+    QCOMPARE(model.data(model.index(0, HashingJobModel::StatusColumn)).toString(), QString("0.1"));
+    QCOMPARE(model.nextToHash(QStringList()), second);
+
+    model.resetAssigned();
+    QCOMPARE(model.job(first)->state, HashingJobModel::State::Pending);
+    QCOMPARE(model.pendingCount(), 2);
+    QCOMPARE(model.nextToHash(QStringList()), first);
+}
+
+QTEST_MAIN(TestHashingJobModel)
+#include "test_hashingjobmodel.moc"
@@ -0,0 +1,334 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QDirIterator>
+#include "../usagi/src/filechangequeue.h"
+#include "../usagi/src/inotifywatcher.h"
+
+/**
+ * Tests for the native directory watcher backend:
+ *   - FileChangeQueue keeps the last state per path in first-seen order
+ *   - Created-then-deleted files and repeated events collapse
+ *   - Removed directories and overflow are carried in the batch
+ *   - InotifyWatcher (Linux only): create/close-write, rename, delete,
+ *     new and moved-in subdirectories, deleted subdirectories, hidden files
+ *   - The tree below the root is registered in chunks after start() returns
+ *   - Benchmark: one change via the queue vs. a full walk of the tree
+ */
+class TestInotifyWatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testQueueLastStateWins();
+    void testQueueCollapsesTemporaryFiles();
+    void testQueueDirectoriesAndOverflow();
+    void testWatchFileLifecycle();
+    void testWatchRename();
+    void testWatchNewSubdirectory();
+    void testWatchRemovedSubdirectory();
+    void testWatchIgnoresHiddenFiles();
+    void testWatchRegistersTreeInChunks();
+    void benchmarkSingleChange_data();
+    void benchmarkSingleChange();
+};
+
+namespace {
+
+bool writeFile(const QString &path, const QByteArray &content = "content")
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(content);
+    file.close();
+    return true;
+}
+
+// Wait for the next coalesced batch
+FileChangeQueue::Batch waitForBatch(InotifyWatcher &watcher)
+{
+    QSignalSpy spy(&watcher, &InotifyWatcher::changesReady);
+    spy.wait(InotifyWatcher::COALESCE_MS * 8);
+    return watcher.takeChanges();
+}
+
+} // namespace
+
+void TestInotifyWatcher::testQueueLastStateWins()
+{
+    FileChangeQueue queue;
+    QVERIFY(queue.isEmpty());
+
+    queue.addFile(FileChangeQueue::Change::Created, "/a/one.mkv");
+    queue.addFile(FileChangeQueue::Change::Created, "/a/two.mkv");
+    queue.addFile(FileChangeQueue::Change::Written, "/a/one.mkv");
+    queue.addFile(FileChangeQueue::Change::MovedIn, "/a/three.mkv");
+    queue.addFile(FileChangeQueue::Change::Written, "/a/one.mkv");
+    QCOMPARE(queue.size(), 3);
+
+    const FileChangeQueue::Batch batch = queue.take();
+    QCOMPARE(batch.createdFiles, QStringList{"/a/two.mkv"});
+    QCOMPARE(batch.completedFiles, (QStringList{"/a/one.mkv", "/a/three.mkv"}));
+    QVERIFY(batch.removedFiles.isEmpty());
+    QVERIFY(!batch.overflow);
+
+    QVERIFY(queue.isEmpty());
+    QVERIFY(queue.take().isEmpty());
+}
+
+void TestInotifyWatcher::testQueueCollapsesTemporaryFiles()
+{
+    FileChangeQueue queue;
+    queue.addFile(FileChangeQueue::Change::Created, "/a/part.tmp");
+    queue.addFile(FileChangeQueue::Change::Written, "/a/part.tmp");
+    queue.addFile(FileChangeQueue::Change::MovedOut, "/a/part.tmp");
+    queue.addFile(FileChangeQueue::Change::MovedIn, "/a/episode.mkv");
+    queue.addFile(FileChangeQueue::Change::Deleted, "/a/old.mkv");
+
+    const FileChangeQueue::Batch batch = queue.take();
+    QVERIFY(batch.createdFiles.isEmpty());
+    QCOMPARE(batch.completedFiles, QStringList{"/a/episode.mkv"});
+    // Downstream ignores removed paths it never knew
+    QCOMPARE(batch.removedFiles, (QStringList{"/a/part.tmp", "/a/old.mkv"}));
+
+    // A file replaced within one batch ends up present
+    queue.addFile(FileChangeQueue::Change::Deleted, "/a/old.mkv");
+    queue.addFile(FileChangeQueue::Change::Created, "/a/old.mkv");
+    QCOMPARE(queue.take().createdFiles, QStringList{"/a/old.mkv"});
+}
+
+void TestInotifyWatcher::testQueueDirectoriesAndOverflow()
+{
+    FileChangeQueue queue;
+    queue.addRemovedDirectory("/a/season1");
+    queue.addRemovedDirectory("/a/season1");
+    QVERIFY(!queue.isEmpty());
+    QCOMPARE(queue.size(), 0);
+
+    queue.setOverflow();
+    FileChangeQueue::Batch batch = queue.take();
+    QCOMPARE(batch.removedDirectories, QStringList{"/a/season1"});
+    QVERIFY(batch.overflow);
+    QVERIFY(!batch.isEmpty());
+
+    batch = queue.take();
+    QVERIFY(!batch.overflow);
+    QVERIFY(batch.isEmpty());
+}
+
+void TestInotifyWatcher::testWatchFileLifecycle()
+{
+    if (!InotifyWatcher::isSupported()) {
+        QSKIP("inotify is not available on this platform");
+    }
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    InotifyWatcher watcher;
+    QVERIFY(watcher.start(tempDir.path()));
+    QVERIFY(watcher.isActive());
+    QCOMPARE(watcher.watchCount(), 1);
+
+    const QString path = tempDir.path() + "/episode.mkv";
+    QVERIFY(writeFile(path));
+    FileChangeQueue::Batch batch = waitForBatch(watcher);
+    QCOMPARE(batch.completedFiles, QStringList{path});
+    QVERIFY(batch.createdFiles.isEmpty());
+
+    QVERIFY(QFile::remove(path));
+    batch = waitForBatch(watcher);
+    QCOMPARE(batch.removedFiles, QStringList{path});
+
+    watcher.stop();
+    QVERIFY(!watcher.isActive());
+    QCOMPARE(watcher.watchCount(), 0);
+}
+
+void TestInotifyWatcher::testWatchRename()
+{
+    if (!InotifyWatcher::isSupported()) {
+        QSKIP("inotify is not available on this platform");
+    }
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString oldPath = tempDir.path() + "/download.part";
+    const QString newPath = tempDir.path() + "/episode.mkv";
+    QVERIFY(writeFile(oldPath));
+
+    InotifyWatcher watcher;
+    QVERIFY(watcher.start(tempDir.path()));
+    QVERIFY(QFile::rename(oldPath, newPath));
+
+    const FileChangeQueue::Batch batch = waitForBatch(watcher);
+    QCOMPARE(batch.removedFiles, QStringList{oldPath});
+    QCOMPARE(batch.completedFiles, QStringList{newPath});
+}
+
+void TestInotifyWatcher::testWatchNewSubdirectory()
+{
+    if (!InotifyWatcher::isSupported()) {
+        QSKIP("inotify is not available on this platform");
+    }
+    QTemporaryDir tempDir;
+    QTemporaryDir outside;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(outside.isValid());
+
+    InotifyWatcher watcher;
+    QVERIFY(watcher.start(tempDir.path()));
+
+    // Created inside the tree: watched from now on
+    const QString season = tempDir.path() + "/season1";
+    QVERIFY(QDir().mkdir(season));
+    waitForBatch(watcher);
+    QCOMPARE(watcher.watchCount(), 2);
+
+    const QString episode = season + "/ep01.mkv";
+    QVERIFY(writeFile(episode));
+    FileChangeQueue::Batch batch = waitForBatch(watcher);
+    QCOMPARE(batch.completedFiles, QStringList{episode});
+
+    // Moved in with content: its files are reported without a rescan
+    const QString prepared = outside.path() + "/season2";
+    QVERIFY(QDir().mkpath(prepared + "/extras"));
+    QVERIFY(writeFile(prepared + "/ep01.mkv"));
+    QVERIFY(writeFile(prepared + "/extras/op.mkv"));
+    const QString movedIn = tempDir.path() + "/season2";
+    QVERIFY(QDir().rename(prepared, movedIn));
+
+    batch = waitForBatch(watcher);
+    QCOMPARE(batch.completedFiles.size(), 2);
+    QVERIFY(batch.completedFiles.contains(movedIn + "/ep01.mkv"));
+    QVERIFY(batch.completedFiles.contains(movedIn + "/extras/op.mkv"));
+    QCOMPARE(watcher.watchCount(), 4);
+}
+
+void TestInotifyWatcher::testWatchRemovedSubdirectory()
+{
+    if (!InotifyWatcher::isSupported()) {
+        QSKIP("inotify is not available on this platform");
+    }
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString season = tempDir.path() + "/season1";
+    QVERIFY(QDir().mkpath(season + "/extras"));
+    QVERIFY(writeFile(season + "/ep01.mkv"));
+
+    InotifyWatcher watcher;
+    QSignalSpy watched(&watcher, &InotifyWatcher::treeWatched);
+    QVERIFY(watcher.start(tempDir.path()));
+    QVERIFY(watched.wait());
+    QCOMPARE(watcher.watchCount(), 3);
+
+    QVERIFY(QDir(season).removeRecursively());
+    const FileChangeQueue::Batch batch = waitForBatch(watcher);
+    QVERIFY(batch.removedDirectories.contains(season));
+    QVERIFY(!batch.overflow);
+    QCOMPARE(watcher.watchCount(), 1);
+}
+
+void TestInotifyWatcher::testWatchIgnoresHiddenFiles()
+{
+    if (!InotifyWatcher::isSupported()) {
+        QSKIP("inotify is not available on this platform");
+    }
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    InotifyWatcher watcher;
+    QVERIFY(watcher.start(tempDir.path()));
+
+    QVERIFY(writeFile(tempDir.path() + "/.hidden.mkv"));
+    const QString visible = tempDir.path() + "/visible.mkv";
+    QVERIFY(writeFile(visible));
+
+    const FileChangeQueue::Batch batch = waitForBatch(watcher);
+    QCOMPARE(batch.completedFiles, QStringList{visible});
+}
+
+void TestInotifyWatcher::testWatchRegistersTreeInChunks()
+{
+    if (!InotifyWatcher::isSupported()) {
+        QSKIP("inotify is not available on this platform");
+    }
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    // Two directories per show: several chunks
+    const int showCount = InotifyWatcher::WATCH_CHUNK + 10;
+    for (int i = 0; i < showCount; ++i) {
+        QVERIFY(QDir().mkpath(tempDir.path() + QString("/show%1/season1").arg(i)));
+    }
+
+    InotifyWatcher watcher;
+    QSignalSpy watched(&watcher, &InotifyWatcher::treeWatched);
+    QVERIFY(watcher.start(tempDir.path()));
+
+    // Only the root is watched when start() returns
+    QCOMPARE(watcher.watchCount(), 1);
+    QVERIFY(watcher.isRegistering());
+
+    QVERIFY(watched.wait());
+    QCOMPARE(watched.count(), 1);
+    QVERIFY(watched.first().first().toBool());
+    QVERIFY(!watcher.isRegistering());
+    QCOMPARE(watcher.watchCount(), 1 + showCount * 2);
+
+    // Directories registered after start() returned report their files
+    const QString episode = tempDir.path() + QString("/show%1/season1/ep01.mkv").arg(showCount - 1);
+    QVERIFY(writeFile(episode));
+    const FileChangeQueue::Batch batch = waitForBatch(watcher);
+    QCOMPARE(batch.completedFiles, QStringList{episode});
+}
+
+void TestInotifyWatcher::benchmarkSingleChange_data()
+{
+    QTest::addColumn<bool>("fullScan");
+    QTest::addColumn<int>("fileCount");
+
+    QTest::newRow("full scan, 2000 files") << true << 2000;
+    QTest::newRow("queue, 2000 files") << false << 2000;
+}
+
+void TestInotifyWatcher::benchmarkSingleChange()
+{
+    QFETCH(bool, fullScan);
+    QFETCH(int, fileCount);
+
+    // Cost of turning one new file into "new files" for a tree of fileCount files
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    for (int i = 0; i < fileCount; ++i) {
+        const QString directory = tempDir.path() + QString("/show%1").arg(i / 50);
+        if (i % 50 == 0) {
+            QVERIFY(QDir().mkpath(directory));
+        }
+        QVERIFY(writeFile(directory + QString("/ep%1.mkv").arg(i)));
+    }
+    const QString changed = tempDir.path() + "/show0/ep0.mkv";
+
+    if (fullScan) {
+        QBENCHMARK {
+            QStringList files;
+            QDirIterator it(tempDir.path(), QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                files.append(it.next());
+            }
+            QCOMPARE(files.size(), fileCount);
+        }
+    } else {
+        FileChangeQueue queue;
+        QBENCHMARK {
+            queue.addFile(FileChangeQueue::Change::Created, changed);
+            queue.addFile(FileChangeQueue::Change::Written, changed);
+            const FileChangeQueue::Batch batch = queue.take();
+            QCOMPARE(batch.completedFiles.size(), 1);
+        }
+    }
+}
+
+QTEST_MAIN(TestInotifyWatcher)
+#include "test_inotifywatcher.moc"
@@ -1,13 +1,51 @@
 #include <QTest>
-#include <QSignalSpy>
 #include <QTemporaryDir>
+#include <QFile>
+#include <QThread>
+#include <memory>
+#include <vector>
 #include "../usagi/src/logger.h"
 
+/**
+ * Tests for the asynchronous Logger:
+ *   - Lines reach the UI in batches from the writer thread, with file and line info
+ *   - Messages below the minimum level are filtered before they are built
+ *   - Level names (USAGI_LOG_LEVEL) parse case-insensitively, unknown names give the fallback
+ *   - Messages from several threads all reach the log file
+ *   - AUTH messages are redacted
+ *   - Messages logged while shutdown() runs are not lost (runs last: stops the writer)
+ *
+ * Batches are emitted from the writer thread, so lines are collected through a
+ * queued connection: Logger::flush() and then QTRY_* until the events are delivered.
+ */
 class TestLogger : public QObject
 {
     Q_OBJECT
 
 private slots:
+    void initTestCase()
+    {
+        connect(Logger::instance(), &Logger::logMessages, this, [this](const QStringList &lines) {
+            m_lines.append(lines);
+            ++m_batches;
+        });
+    }
+
+    void init()
+    {
+        // Drop whatever earlier tests left in flight
+        Logger::flush();
+        QCoreApplication::processEvents();
+        m_lines.clear();
+        m_batches = 0;
+    }
+
+    void cleanup()
+    {
+        Logger::setMinimumLevel(Logger::Debug);
+        Logger::setLogFile(QString());
+    }
+
     void testLoggerSingleton()
     {
         // Test that Logger::instance() returns the same instance
@@ -19,19 +57,15 @@ private slots:
 
     void testLoggerSignalEmission()
     {
-        // Test that Logger emits signal when logging
-        Logger* logger = Logger::instance();
-        QSignalSpy spy(logger, &Logger::logMessage);
-        
+        // Test that Logger emits a batch when logging
         QString testMessage = "Test log message";
         LOG(testMessage);
-        
-        // Verify signal was emitted
-        QCOMPARE(spy.count(), 1);
-        
-        // Verify signal argument contains the message and file info
-        QList<QVariant> arguments = spy.takeFirst();
-        QString loggedMessage = arguments.at(0).toString();
+        Logger::flush();
+
+        // Verify the line arrived and contains the message and file info
+        QTRY_COMPARE(m_lines.size(), 1);
+        QVERIFY(m_batches >= 1);
+        QString loggedMessage = m_lines.first();
         QVERIFY(loggedMessage.contains(testMessage));
         QVERIFY(loggedMessage.contains("test_logger.cpp"));
     }
@@ -42,18 +76,13 @@ private slots:
         // Note: This test uses valid parameters. The assertions for empty file/line
         // are intentionally not tested as they would cause test failure - the assertions
         // are meant to catch incorrect usage at runtime during development.
-        Logger* logger = Logger::instance();
-        QSignalSpy spy(logger, &Logger::logMessage);
-        
         QString testMessage = "Test message with context";
         Logger::log(testMessage, "test.cpp", 42);
-        
-        // Verify signal was emitted
-        QCOMPARE(spy.count(), 1);
-        
-        // Verify signal includes file and line info
-        QList<QVariant> arguments = spy.takeFirst();
-        QString loggedMessage = arguments.at(0).toString();
+        Logger::flush();
+
+        // Verify the line includes file and line info
+        QTRY_COMPARE(m_lines.size(), 1);
+        QString loggedMessage = m_lines.first();
         QVERIFY(loggedMessage.contains("test.cpp"));
         QVERIFY(loggedMessage.contains("42"));
         QVERIFY(loggedMessage.contains(testMessage));
@@ -62,17 +91,12 @@ private slots:
     void testLoggerMacro()
     {
         // Test the LOG macro
-        Logger* logger = Logger::instance();
-        QSignalSpy spy(logger, &Logger::logMessage);
-        
         LOG("Test using LOG macro");
-        
-        // Verify signal was emitted
-        QCOMPARE(spy.count(), 1);
-        
+        Logger::flush();
+
         // Verify message includes file info from macro
-        QList<QVariant> arguments = spy.takeFirst();
-        QString loggedMessage = arguments.at(0).toString();
+        QTRY_COMPARE(m_lines.size(), 1);
+        QString loggedMessage = m_lines.first();
         QVERIFY(loggedMessage.contains("test_logger.cpp"));
         QVERIFY(loggedMessage.contains("Test using LOG macro"));
     }
@@ -80,16 +104,145 @@ private slots:
     void testMultipleLogCalls()
     {
         // Test multiple log calls in sequence
-        Logger* logger = Logger::instance();
-        QSignalSpy spy(logger, &Logger::logMessage);
-        
         LOG("Message 1");
         LOG("Message 2");
         LOG("Message 3");
-        
-        // Verify all signals were emitted
-        QCOMPARE(spy.count(), 3);
+        Logger::flush();
+
+        // Verify all lines arrived, in order
+        QTRY_COMPARE(m_lines.size(), 3);
+        QVERIFY(m_lines.at(0).contains("Message 1"));
+        QVERIFY(m_lines.at(2).contains("Message 3"));
+    }
+
+    void testLevelFiltering()
+    {
+        int built = 0;
+        auto message = [&built](const QString &text) {
+            ++built;
+            return text;
+        };
+
+        Logger::setMinimumLevel(Logger::Warning);
+        QVERIFY(!Logger::isEnabled(Logger::Info));
+        LOG_DEBUG(message("Filtered debug"));
+        LOG(message("Filtered info"));
+        LOG_WARNING(message("Kept warning"));
+        LOG_ERROR(message("Kept error"));
+        Logger::flush();
+
+        // Filtered messages were never built
+        QCOMPARE(built, 2);
+        QTRY_COMPARE(m_lines.size(), 2);
+        QVERIFY(m_lines.at(0).contains("[Warning] Kept warning"));
+        QVERIFY(m_lines.at(1).contains("[Error] Kept error"));
+    }
+
+    void testLevelFromName()
+    {
+        QCOMPARE(Logger::levelFromName("debug", Logger::Info), Logger::Debug);
+        QCOMPARE(Logger::levelFromName(" Warning ", Logger::Info), Logger::Warning);
+        QCOMPARE(Logger::levelFromName("ERROR", Logger::Info), Logger::Error);
+        QCOMPARE(Logger::levelFromName("1", Logger::Debug), Logger::Info);
+        QCOMPARE(Logger::levelFromName(QString(), Logger::Info), Logger::Info);
+        QCOMPARE(Logger::levelFromName("verbose", Logger::Warning), Logger::Warning);
+    }
+
+    void testConcurrentProducersToFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("usagi_debug.log");
+        QVERIFY(Logger::setLogFile(path));
+
+        const int threadCount = 4;
+        const int perThread = 500;
+        const quint64 droppedBefore = Logger::droppedCount();
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    LOG(QString("Producer %1 line %2").arg(t).arg(i));
+                }
+            }));
+            threads.back()->start();
+        }
+        for (auto &thread : threads) {
+            QVERIFY(thread->wait(10000));
+        }
+        Logger::flush();
+        QVERIFY(Logger::setLogFile(QString()));
+
+        // Far below the ring capacity: nothing may be dropped
+        QCOMPARE(Logger::droppedCount(), droppedBefore);
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+        const QStringList written = QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+        int producerLines = 0;
+        for (const QString &line : written) {
+            if (line.contains("Producer ")) {
+                ++producerLines;
+            }
+        }
+        QCOMPARE(producerLines, threadCount * perThread);
+        QVERIFY(written.join('\n').contains("Producer 3 line 499"));
     }
+
+    void testAuthRedaction()
+    {
+        LOG("AUTH user=someone&pass=secret");
+        Logger::flush();
+
+        QTRY_COMPARE(m_lines.size(), 1);
+        QVERIFY(m_lines.first().contains("[REDACTED AUTH MESSAGE]"));
+        QVERIFY(!m_lines.first().contains("secret"));
+    }
+
+    void testShutdownKeepsConcurrentMessages()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("usagi_debug.log");
+        QVERIFY(Logger::setLogFile(path));
+
+        const int threadCount = 4;
+        const int perThread = 500;
+        const quint64 droppedBefore = Logger::droppedCount();
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    LOG(QString("Shutdown producer %1 line %2").arg(t).arg(i));
+                }
+            }));
+            threads.back()->start();
+        }
+
+        // Stop the writer while the producers are still running
+        Logger::shutdown();
+        for (auto &thread : threads) {
+            QVERIFY(thread->wait(10000));
+        }
+        QVERIFY(Logger::setLogFile(QString()));
+        QCOMPARE(Logger::droppedCount(), droppedBefore);
+
+        // Queued before the shutdown or written synchronously after it: every line is there
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+        const QStringList written = QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+        int producerLines = 0;
+        for (const QString &line : written) {
+            if (line.contains("Shutdown producer ")) {
+                ++producerLines;
+            }
+        }
+        QCOMPARE(producerLines, threadCount * perThread);
+    }
+
+private:
+    QStringList m_lines;
+    int m_batches = 0;
 };
 
 QTEST_MAIN(TestLogger)
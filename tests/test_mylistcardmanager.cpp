@@ -7,7 +7,61 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTreeWidget>
+#include <QPushButton>
+#include <QFile>
 
+namespace {
+    const QString LOCK_MARK = QString::fromUtf8("\xF0\x9F\x94\x92");  // 🔒
+    
+    // Episode with one file per lid; files with an empty path are missing on disk
+    AnimeCard::EpisodeInfo makeEpisode(int eid, const QString& number, const QString& title,
+                                       const QList<int>& lids, const QString& localPath = QString())
+    {
+        AnimeCard::EpisodeInfo episode(eid, epno(number), title);
+        int version = 1;
+        for (int lid : lids) {
+            AnimeCard::FileInfo file(lid, lid * 10, QString("file%1.mkv").arg(lid));
+            file.setLocalFilePath(localPath);
+            file.setVersion(version++);
+            episode.addFile(file);
+        }
+        return episode;
+    }
+    
+    QString touchFile(const QTemporaryDir& dir, const QString& name)
+    {
+        const QString path = dir.filePath(name);
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write("x");
+        }
+        return path;
+    }
+    
+    QLabel* nextEpisodeLabel(AnimeCard& card)
+    {
+        const QList<QLabel*> labels = card.findChildren<QLabel*>();
+        for (QLabel *label : labels) {
+            if (label->text().startsWith("Next: ")) {
+                return label;
+            }
+        }
+        return nullptr;
+    }
+    
+    QPushButton* playButton(AnimeCard& card)
+    {
+        const QList<QPushButton*> buttons = card.findChildren<QPushButton*>();
+        for (QPushButton *button : buttons) {
+            if (button->text().contains("Play Next")) {
+                return button;
+            }
+        }
+        return nullptr;
+    }
+}
 
 // Global adbapi used by MyListCardManager
 
@@ -19,6 +73,13 @@
  * 2. Individual cards can be updated without reloading all cards
  * 3. Updates are asynchronous and don't block
  * 4. Memory is managed properly (no leaks)
+ * 5. Cards requested before their data is loaded are skeletons filled in by the preload
+ * 6. AnimeCard shows a single summary row until its episode tree is clicked or expanded,
+ *    also when it is painted
+ * 7. The built tree has one row per episode with the file rows under it
+ * 8. Locks set before the tree is built mark the built rows
+ * 9. The next-episode label and the Play button skip watched episodes
+ * 10. Anime in mylist without anime or title data stay in the filtered list
  */
 class TestMyListCardManager : public QObject
 {
@@ -37,6 +98,12 @@ private slots:
     void testBatchUpdates();
     void testAsynchronousOperations();
     void testMemoryManagement();
+    void testSkeletonCardBeforePreload();
+    void testEpisodeSummaryRow();
+    void testEpisodeTreeBuiltOnFirstUse();
+    void testLocksBeforeTreeBuild();
+    void testNextEpisodeSkipsWatched();
+    void testAnimeWithoutDataStaysFiltered();
     
 private:
     MyListCardManager *manager;
@@ -152,7 +219,9 @@ void TestMyListCardManager::createTestDatabase()
            "fid INTEGER PRIMARY KEY, "
            "filename TEXT, "
            "resolution TEXT, "
-           "quality TEXT)");
+           "quality TEXT, "
+           "airdate INTEGER, "
+           "state INTEGER)");
     
     // Create group table
     q.exec("CREATE TABLE `group` ("
@@ -170,7 +239,8 @@ void TestMyListCardManager::createTestDatabase()
            "viewed INTEGER, "
            "storage TEXT, "
            "local_file INTEGER, "
-           "last_played INTEGER)");
+           "last_played INTEGER, "
+           "local_watched INTEGER)");
     
     // Create anime_titles table
     q.exec("CREATE TABLE anime_titles ("
@@ -183,6 +253,10 @@ void TestMyListCardManager::createTestDatabase()
     q.exec("CREATE TABLE local_files ("
            "id INTEGER PRIMARY KEY, "
            "path TEXT)");
+    
+    // Create watched_episodes table
+    q.exec("CREATE TABLE watched_episodes ("
+           "eid INTEGER PRIMARY KEY)");
 }
 
 void TestMyListCardManager::insertTestAnime(int aid, const QString &name)
@@ -397,5 +471,170 @@ void TestMyListCardManager::testMemoryManagement()
     }
 }
 
+void TestMyListCardManager::testSkeletonCardBeforePreload()
+{
+    insertTestAnime(1, "Test Anime 1");
+    insertTestEpisode(1, 1, "Episode 1", "1");
+    insertTestMylistEntry(1, 1, 1);
+    
+    // No preload yet: the card is created at once instead of waiting for the data
+    AnimeCard *card = manager->createCard(1);
+    QVERIFY(card != nullptr);
+    QCOMPARE(card->getAnimeId(), 1);
+    QVERIFY(card->getAnimeTitle().isEmpty());
+    
+    QSignalSpy boundSpy(manager, &MyListCardManager::cardBound);
+    manager->preloadCardCreationData(QList<int>{1});
+    
+    // The same card is filled in
+    QCOMPARE(manager->getCard(1), card);
+    QCOMPARE(card->getAnimeTitle(), QString("Test Anime 1"));
+    QCOMPARE(boundSpy.count(), 1);
+    
+    // Filled once only
+    manager->preloadCardCreationData(QList<int>{1});
+    QCOMPARE(boundSpy.count(), 1);
+}
+
+void TestMyListCardManager::testEpisodeSummaryRow()
+{
+    AnimeCard card;
+    card.setEpisodes({makeEpisode(11, "1", "First", {111, 112}),
+                      makeEpisode(12, "2", "Second", {121})});
+    
+    // Not painted yet: only the summary row
+    QTreeWidget *tree = card.findChild<QTreeWidget*>();
+    QVERIFY(tree != nullptr);
+    QCOMPARE(tree->topLevelItemCount(), 1);
+    QCOMPARE(tree->topLevelItem(0)->text(2), QString("2 episode(s), 3 file(s)"));
+    QCOMPARE(tree->topLevelItem(0)->childCount(), 0);
+}
+
+void TestMyListCardManager::testEpisodeTreeBuiltOnFirstUse()
+{
+    const QList<AnimeCard::EpisodeInfo> episodes = {makeEpisode(11, "1", "First", {111, 112}),
+                                                    makeEpisode(12, "2", "Second", {121})};
+    AnimeCard card;
+    card.setEpisodes(episodes);
+    QTreeWidget *tree = card.findChild<QTreeWidget*>();
+    QVERIFY(tree != nullptr);
+    
+    // Painting (scrolling past the card) keeps the summary row
+    card.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&card));
+    QTest::qWait(50);
+    QCOMPARE(tree->topLevelItemCount(), 1);
+    
+    // The first click into the tree builds the rows
+    QTest::mouseClick(tree->viewport(), Qt::LeftButton, Qt::NoModifier, tree->viewport()->rect().center());
+    QCOMPARE(tree->topLevelItemCount(), 2);
+    
+    // Expanding the summary row builds them too
+    AnimeCard expanded;
+    expanded.setEpisodes(episodes);
+    QTreeWidget *expandedTree = expanded.findChild<QTreeWidget*>();
+    QVERIFY(expandedTree != nullptr);
+    expandedTree->topLevelItem(0)->setExpanded(true);
+    QTRY_COMPARE(expandedTree->topLevelItemCount(), 2);
+    
+    QTreeWidgetItem *first = tree->topLevelItem(0);
+    QTreeWidgetItem *second = tree->topLevelItem(1);
+    QCOMPARE(first->data(2, Qt::UserRole + 1).toInt(), 11);
+    QCOMPARE(second->data(2, Qt::UserRole + 1).toInt(), 12);
+    QCOMPARE(first->childCount(), 2);
+    QCOMPARE(first->child(0)->data(2, Qt::UserRole).toInt(), 111);
+    QCOMPARE(first->child(1)->data(2, Qt::UserRole).toInt(), 112);
+    QCOMPARE(second->childCount(), 1);
+    QCOMPARE(second->child(0)->data(2, Qt::UserRole).toInt(), 121);
+}
+
+void TestMyListCardManager::testLocksBeforeTreeBuild()
+{
+    const QList<AnimeCard::EpisodeInfo> episodes = {makeEpisode(11, "1", "First", {111}),
+                                                    makeEpisode(12, "2", "Second", {121})};
+    
+    // Episode lock set while only the summary row exists
+    AnimeCard episodeLocked;
+    episodeLocked.setEpisodes(episodes);
+    episodeLocked.setEpisodeLocked(12, true);
+    QTreeWidget *tree = episodeLocked.findChild<QTreeWidget*>();
+    QVERIFY(tree != nullptr);
+    tree->topLevelItem(0)->setExpanded(true);
+    QTRY_COMPARE(tree->topLevelItemCount(), 2);
+    QVERIFY(!tree->topLevelItem(0)->text(2).startsWith(LOCK_MARK));
+    QVERIFY(tree->topLevelItem(1)->text(2).startsWith(LOCK_MARK));
+    
+    // Anime lock set before the episodes: every built row is marked
+    AnimeCard animeLocked;
+    animeLocked.setAnimeLocked(true);
+    animeLocked.setEpisodes(episodes);
+    tree = animeLocked.findChild<QTreeWidget*>();
+    QVERIFY(tree != nullptr);
+    tree->topLevelItem(0)->setExpanded(true);
+    QTRY_COMPARE(tree->topLevelItemCount(), 2);
+    QVERIFY(tree->topLevelItem(0)->text(2).startsWith(LOCK_MARK));
+    QVERIFY(tree->topLevelItem(1)->text(2).startsWith(LOCK_MARK));
+    
+    // Unlocking the anime keeps the episode's own lock
+    animeLocked.setEpisodeLocked(12, true);
+    animeLocked.setAnimeLocked(false);
+    QVERIFY(!tree->topLevelItem(0)->text(2).startsWith(LOCK_MARK));
+    QVERIFY(tree->topLevelItem(1)->text(2).startsWith(LOCK_MARK));
+}
+
+void TestMyListCardManager::testNextEpisodeSkipsWatched()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    
+    // Episode 1 watched, episode 2 without a local file, episode 3 is next
+    AnimeCard::EpisodeInfo watched = makeEpisode(11, "1", "First", {111}, touchFile(dir, "ep1.mkv"));
+    watched.setEpisodeWatched(true);
+    AnimeCard::EpisodeInfo missing = makeEpisode(12, "2", "Second", {121});
+    AnimeCard::EpisodeInfo next = makeEpisode(13, "3", "Third", {131}, touchFile(dir, "ep3.mkv"));
+    
+    AnimeCard card;
+    card.setAnimeId(7);
+    card.setEpisodes({watched, missing, next});
+    
+    QLabel *label = nextEpisodeLabel(card);
+    QVERIFY(label != nullptr);
+    QVERIFY(label->text().contains("Third"));
+    
+    QPushButton *play = playButton(card);
+    QVERIFY(play != nullptr);
+    QVERIFY(play->isEnabled());
+    QSignalSpy episodeSpy(&card, &AnimeCard::episodeClicked);
+    play->click();
+    QCOMPARE(episodeSpy.count(), 1);
+    QCOMPARE(episodeSpy.first().at(0).toInt(), 131);
+    
+    // Once the last playable episode is watched there is nothing left to play
+    next.setEpisodeWatched(true);
+    card.setEpisodes({watched, missing, next});
+    QCOMPARE(label->text(), QString("Next: All watched"));
+    QVERIFY(!play->isEnabled());
+}
+
+void TestMyListCardManager::testAnimeWithoutDataStaysFiltered()
+{
+    // Mylist entry whose anime has neither an anime row nor a title yet
+    insertTestEpisode(77, 77, "Episode 1", "1");
+    insertTestMylistEntry(77, 77, 77);
+    insertTestAnime(78, "Test Anime 78");
+    insertTestEpisode(78, 78, "Episode 1", "1");
+    insertTestMylistEntry(78, 78, 78);
+    
+    manager->preloadCardCreationData({77, 78});
+    QVERIFY(!manager->hasCachedData(77));
+    QVERIFY(manager->hasCachedData(78));
+    
+    // Indexed with default keys: kept by an empty filter, matched by its fallback title
+    AnimeFilterIndex::Criteria criteria;
+    QCOMPARE(manager->filterAnimeIds({77, 78}, criteria, nullptr), (QList<int>{77, 78}));
+    criteria.searchText = "Anime #77";
+    QCOMPARE(manager->filterAnimeIds({77, 78}, criteria, nullptr), QList<int>{77});
+}
+
 QTEST_MAIN(TestMyListCardManager)
 #include "test_mylistcardmanager.moc"
@@ -0,0 +1,214 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QBuffer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTimer>
+#include "../usagi/src/postercache.h"
+
+/**
+ * Tests for PosterCache:
+ *   - Thumbnail files are named by anime and device pixel size
+ *   - Posters are scaled to fit the requested size in device pixels, keeping the aspect ratio
+ *   - Thumbnail files round-trip without decoding; corrupt or missing files read as null
+ *   - A request is served from an existing thumbnail file on a worker thread
+ *   - invalidate() deletes every thumbnail file of the anime
+ *   - The directory is pruned to its size cap, oldest files first
+ *   - A worker waits for a database locked by another connection instead of failing
+ */
+class TestPosterCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testThumbnailFileName();
+    void testScaleToFit();
+    void testThumbnailRoundTrip();
+    void testRequestServedFromFile();
+    void testInvalidate();
+    void testPruneDirectory();
+    void testReadWaitsForLockedDatabase();
+
+private:
+    static QImage makeThumbnail(const QSize &size, QColor color);
+};
+
+QImage TestPosterCache::makeThumbnail(const QSize &size, QColor color)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    return image;
+}
+
+void TestPosterCache::testThumbnailFileName()
+{
+    QCOMPARE(PosterCache::thumbnailFileName(42, QSize(240, 330)), QString("42_240x330.thumb"));
+    QCOMPARE(PosterCache::thumbnailFileName(7, QSize(480, 660)), QString("7_480x660.thumb"));
+}
+
+void TestPosterCache::testScaleToFit()
+{
+    const QImage poster = makeThumbnail(QSize(600, 825), Qt::red).convertToFormat(QImage::Format_RGB32);
+
+    const QImage single = PosterCache::scaleToFit(poster, QSize(240, 330), 1.0);
+    QCOMPARE(single.size(), QSize(240, 330));
+    QCOMPARE(single.format(), QImage::Format_ARGB32_Premultiplied);
+
+    // Device pixels at a DPR of 2, same logical size
+    const QImage doubled = PosterCache::scaleToFit(poster, QSize(240, 330), 2.0);
+    QCOMPARE(doubled.size(), QSize(480, 660));
+    QCOMPARE(doubled.devicePixelRatio(), 2.0);
+    QCOMPARE(doubled.deviceIndependentSize().toSize(), QSize(240, 330));
+
+    // Wide posters keep their aspect ratio
+    const QImage wide = PosterCache::scaleToFit(makeThumbnail(QSize(480, 240), Qt::blue), QSize(240, 330), 1.0);
+    QCOMPARE(wide.size(), QSize(240, 120));
+
+    QVERIFY(PosterCache::scaleToFit(QImage(), QSize(240, 330), 1.0).isNull());
+}
+
+void TestPosterCache::testThumbnailRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("1_24x33.thumb");
+
+    const QImage thumbnail = makeThumbnail(QSize(24, 33), QColor(10, 20, 30));
+    QVERIFY(PosterCache::writeThumbnail(path, thumbnail));
+    QCOMPARE(PosterCache::readThumbnail(path), thumbnail);
+
+    // Truncated scan lines
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+    QVERIFY(PosterCache::readThumbnail(path).isNull());
+
+    // Not a thumbnail file
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("JFIF");
+    file.close();
+    QVERIFY(PosterCache::readThumbnail(path).isNull());
+
+    QVERIFY(PosterCache::readThumbnail(dir.filePath("missing.thumb")).isNull());
+}
+
+void TestPosterCache::testRequestServedFromFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QImage thumbnail = makeThumbnail(QSize(24, 33), Qt::green);
+    QVERIFY(PosterCache::writeThumbnail(
+        QDir(dir.path()).filePath(PosterCache::thumbnailFileName(5, QSize(24, 33))), thumbnail));
+
+    // No database: only the file can answer
+    PosterCache cache;
+    cache.setDirectory(dir.path());
+    QSignalSpy spy(&cache, &PosterCache::posterReady);
+    cache.request(5, QSize(24, 33), 1.0, true);
+    QVERIFY(spy.wait(5000));
+
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toInt(), 5);
+    QCOMPARE(spy.at(0).at(1).value<QImage>(), thumbnail);
+    QCOMPARE(cache.pendingCount(), 0);
+
+    // An anime without a file or poster gets a null image
+    cache.request(6, QSize(24, 33), 1.0, false);
+    QVERIFY(spy.wait(5000));
+    QCOMPARE(spy.at(1).at(0).toInt(), 6);
+    QVERIFY(spy.at(1).at(1).value<QImage>().isNull());
+}
+
+void TestPosterCache::testInvalidate()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QDir thumbnails(dir.path());
+    const QImage thumbnail = makeThumbnail(QSize(4, 4), Qt::black);
+    QVERIFY(PosterCache::writeThumbnail(thumbnails.filePath("3_4x4.thumb"), thumbnail));
+    QVERIFY(PosterCache::writeThumbnail(thumbnails.filePath("3_8x8.thumb"), thumbnail));
+    QVERIFY(PosterCache::writeThumbnail(thumbnails.filePath("31_4x4.thumb"), thumbnail));
+
+    PosterCache cache;
+    cache.setDirectory(dir.path());
+    cache.invalidate(3);
+
+    QVERIFY(!thumbnails.exists("3_4x4.thumb"));
+    QVERIFY(!thumbnails.exists("3_8x8.thumb"));
+    QVERIFY(thumbnails.exists("31_4x4.thumb"));
+}
+
+void TestPosterCache::testPruneDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QDir thumbnails(dir.path());
+    const QImage thumbnail = makeThumbnail(QSize(16, 16), Qt::black);
+    const QDateTime base = QDateTime::currentDateTime().addDays(-1);
+    for (int aid = 1; aid <= 8; ++aid) {
+        const QString path = thumbnails.filePath(PosterCache::thumbnailFileName(aid, QSize(16, 16)));
+        QVERIFY(PosterCache::writeThumbnail(path, thumbnail));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(base.addSecs(aid * 60), QFileDevice::FileModificationTime));
+    }
+    const qint64 fileSize = QFileInfo(thumbnails.filePath("1_16x16.thumb")).size();
+
+    // Under the cap: nothing to do
+    QCOMPARE(PosterCache::pruneDirectory(dir.path(), fileSize * 8), 0);
+
+    // Over it: the oldest files go until 3/4 of the cap is left
+    QCOMPARE(PosterCache::pruneDirectory(dir.path(), fileSize * 4), 5);
+    QVERIFY(!thumbnails.exists("1_16x16.thumb"));
+    QVERIFY(!thumbnails.exists("5_16x16.thumb"));
+    QVERIFY(thumbnails.exists("6_16x16.thumb"));
+    QVERIFY(thumbnails.exists("8_16x16.thumb"));
+}
+
+void TestPosterCache::testReadWaitsForLockedDatabase()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString databaseName = dir.filePath("usagi.sqlite");
+
+    QByteArray png;
+    {
+        QBuffer buffer(&png);
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        QVERIFY(makeThumbnail(QSize(60, 80), Qt::red).save(&buffer, "PNG"));
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "writer");
+        db.setDatabaseName(databaseName);
+        QVERIFY(db.open());
+        QSqlQuery q(db);
+        QVERIFY(q.exec("CREATE TABLE anime (aid INTEGER PRIMARY KEY, poster_image BLOB)"));
+        QVERIFY(q.prepare("INSERT INTO anime (aid, poster_image) VALUES (9, ?)"));
+        q.addBindValue(png);
+        QVERIFY(q.exec());
+
+        // A write in progress elsewhere, finished well within the busy timeout
+        QVERIFY(q.exec("BEGIN EXCLUSIVE"));
+        QVERIFY(q.exec("UPDATE anime SET aid = aid WHERE aid = 9"));
+
+        PosterCache cache;
+        cache.setDatabaseName(databaseName);
+        QSignalSpy spy(&cache, &PosterCache::posterReady);
+        cache.request(9, QSize(30, 40), 1.0, true);
+        QTimer::singleShot(500, [&db]() { db.commit(); });
+
+        QVERIFY(spy.wait(PosterCache::BUSY_TIMEOUT_MS * 2));
+        QCOMPARE(spy.at(0).at(0).toInt(), 9);
+        QCOMPARE(spy.at(0).at(1).value<QImage>().size(), QSize(30, 40));
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("writer");
+}
+
+QTEST_MAIN(TestPosterCache)
+#include "test_postercache.moc"
@@ -0,0 +1,356 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QPointer>
+#include <QSqlDatabase>
+#include "../usagi/src/posterdownloader.h"
+
+namespace {
+
+// Minimal HTTP/1.1 server standing in for the AniDB image server. Answers every
+// GET with a body naming the path plus ETag/Last-Modified, or 304 when the
+// request's If-None-Match matches. While holding, responses wait for release.
+class HttpStandIn : public QObject
+{
+public:
+    struct Received {
+        QByteArray path;
+        QHash<QByteArray, QByteArray> headers;  // Lower-case names
+    };
+
+    static constexpr const char *ETAG = "\"v1\"";
+    static constexpr const char *LAST_MODIFIED = "Sat, 01 Jan 2022 00:00:00 GMT";
+
+    bool listen()
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+        return m_server.listen(QHostAddress::LocalHost);
+    }
+
+    QUrl baseUrl() const { return QUrl(QString("http://127.0.0.1:%1/pics/").arg(m_server.serverPort())); }
+
+    void setHolding(bool holding) { m_holding = holding; }
+
+    void releaseOne()
+    {
+        if (!m_held.isEmpty()) {
+            const Held held = m_held.takeFirst();
+            respond(held.socket, held.request);
+        }
+    }
+
+    void releaseAll()
+    {
+        while (!m_held.isEmpty()) {
+            releaseOne();
+        }
+    }
+
+    QList<Received> received;
+
+private:
+    struct Held {
+        QPointer<QTcpSocket> socket;
+        Received request;
+    };
+
+    void onReadyRead(QTcpSocket *socket)
+    {
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        qsizetype end;
+        while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+            const QList<QByteArray> lines = buffer.left(end).split('\n');
+            buffer.remove(0, end + 4);
+
+            Received request;
+            request.path = lines.value(0).split(' ').value(1);
+            for (qsizetype i = 1; i < lines.size(); ++i) {
+                const qsizetype colon = lines.at(i).indexOf(':');
+                if (colon > 0) {
+                    request.headers.insert(lines.at(i).left(colon).trimmed().toLower(),
+                                           lines.at(i).mid(colon + 1).trimmed());
+                }
+            }
+            received.append(request);
+
+            if (m_holding) {
+                m_held.append({socket, request});
+            } else {
+                respond(socket, request);
+            }
+        }
+    }
+
+    void respond(QTcpSocket *socket, const Received &request)
+    {
+        if (!socket) {
+            return;
+        }
+        QByteArray response;
+        if (request.headers.value("if-none-match") == ETAG) {
+            response = QByteArray("HTTP/1.1 304 Not Modified\r\nETag: ") + ETAG + "\r\nContent-Length: 0\r\n\r\n";
+        } else {
+            const QByteArray body = "poster " + request.path;
+            response = QByteArray("HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\nETag: ") + ETAG
+                       + "\r\nLast-Modified: " + LAST_MODIFIED
+                       + "\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+        }
+        socket->write(response);
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QList<Held> m_held;
+    bool m_holding = false;
+};
+
+}
+
+/**
+ * Tests for PosterDownloader (against HttpStandIn on localhost):
+ *   - No more than maxConcurrent() downloads run; the rest are queued
+ *   - Queued downloads start by priority, newest first within a priority
+ *   - Anime sharing a picname wait on a single download
+ *   - Cancelling drops queued downloads and aborts running ones nobody waits for
+ *   - ETag/Last-Modified are stored and sent back on a conditional request (304)
+ *   - An anime without a copy that joins a running conditional request is downloaded again on a 304
+ *   - Validators outlive the downloader in the poster_validators table
+ */
+class TestPosterDownloader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testConcurrencyCap();
+    void testPriorityOrder();
+    void testDedupeByPicname();
+    void testCancel();
+    void testConditionalRequest();
+    void testUnconditionalJoinsConditional();
+    void testValidatorsPersist();
+};
+
+void TestPosterDownloader::initTestCase()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+}
+
+void TestPosterDownloader::cleanupTestCase()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+}
+
+void TestPosterDownloader::testConcurrencyCap()
+{
+    HttpStandIn server;
+    QVERIFY(server.listen());
+    server.setHolding(true);
+
+    PosterDownloader downloader;
+    downloader.setBaseUrl(server.baseUrl());
+    downloader.setMaxConcurrent(2);
+    QSignalSpy spy(&downloader, &PosterDownloader::posterDownloaded);
+
+    for (int aid = 1; aid <= 5; ++aid) {
+        downloader.request(aid, QString("cap%1.jpg").arg(aid), PosterDownloader::Background);
+    }
+    QCOMPARE(downloader.activeCount(), 2);
+    QCOMPARE(downloader.queuedCount(), 3);
+    QTRY_COMPARE(server.received.size(), 2);
+
+    // Each finished download starts the next, never more than two at a time
+    server.setHolding(false);
+    server.releaseAll();
+    QTRY_COMPARE(spy.count(), 5);
+    QCOMPARE(server.received.size(), 5);
+    QCOMPARE(downloader.activeCount(), 0);
+    QCOMPARE(downloader.queuedCount(), 0);
+
+    const QList<QVariant> first = spy.at(0);
+    QCOMPARE(first.at(2).toByteArray(), QByteArray("poster /pics/") + first.at(1).toString().toLatin1());
+}
+
+void TestPosterDownloader::testPriorityOrder()
+{
+    HttpStandIn server;
+    QVERIFY(server.listen());
+    server.setHolding(true);
+
+    PosterDownloader downloader;
+    downloader.setBaseUrl(server.baseUrl());
+    downloader.setMaxConcurrent(1);
+    QSignalSpy spy(&downloader, &PosterDownloader::posterDownloaded);
+
+    // prio-a takes the free slot; the rest queue behind it
+    downloader.request(1, "prio-a.jpg", PosterDownloader::Background);
+    downloader.request(2, "prio-b.jpg", PosterDownloader::Background);
+    downloader.request(3, "prio-c.jpg", PosterDownloader::Background);
+    downloader.request(4, "prio-d.jpg", PosterDownloader::Nearby);
+    downloader.request(5, "prio-e.jpg", PosterDownloader::Background);
+    // Scrolled onto the screen
+    downloader.setPriority(2, PosterDownloader::Visible);
+
+    const QList<QByteArray> expected = {"/pics/prio-a.jpg", "/pics/prio-b.jpg", "/pics/prio-d.jpg",
+                                        "/pics/prio-e.jpg", "/pics/prio-c.jpg"};
+    for (int i = 0; i < expected.size(); ++i) {
+        QTRY_COMPARE(server.received.size(), i + 1);
+        QCOMPARE(server.received.at(i).path, expected.at(i));
+        server.releaseOne();
+    }
+    QTRY_COMPARE(spy.count(), 5);
+}
+
+void TestPosterDownloader::testDedupeByPicname()
+{
+    HttpStandIn server;
+    QVERIFY(server.listen());
+
+    PosterDownloader downloader;
+    downloader.setBaseUrl(server.baseUrl());
+    QSignalSpy spy(&downloader, &PosterDownloader::posterDownloaded);
+
+    downloader.request(10, "shared.jpg", PosterDownloader::Background);
+    downloader.request(11, "shared.jpg", PosterDownloader::Visible);
+    QCOMPARE(downloader.activeCount(), 1);
+    QCOMPARE(downloader.queuedCount(), 0);
+
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(server.received.size(), 1);
+    QSet<int> aids;
+    for (const QList<QVariant> &arguments : std::as_const(spy)) {
+        aids.insert(arguments.at(0).toInt());
+        QCOMPARE(arguments.at(1).toString(), QString("shared.jpg"));
+    }
+    QCOMPARE(aids, QSet<int>({10, 11}));
+}
+
+void TestPosterDownloader::testCancel()
+{
+    HttpStandIn server;
+    QVERIFY(server.listen());
+    server.setHolding(true);
+
+    PosterDownloader downloader;
+    downloader.setBaseUrl(server.baseUrl());
+    downloader.setMaxConcurrent(1);
+    QSignalSpy downloaded(&downloader, &PosterDownloader::posterDownloaded);
+    QSignalSpy failed(&downloader, &PosterDownloader::downloadFailed);
+
+    downloader.request(20, "cancel-a.jpg", PosterDownloader::Visible);
+    downloader.request(21, "cancel-a.jpg", PosterDownloader::Visible);
+    downloader.request(22, "cancel-b.jpg", PosterDownloader::Visible);
+    QTRY_COMPARE(server.received.size(), 1);
+
+    // Queued: dropped without a request
+    downloader.cancel(22);
+    QCOMPARE(downloader.queuedCount(), 0);
+    QVERIFY(!downloader.isPending(22));
+
+    // Running: kept while another anime waits on it, aborted once nobody does
+    downloader.cancel(20);
+    QCOMPARE(downloader.activeCount(), 1);
+    downloader.cancel(21);
+    QCOMPARE(downloader.activeCount(), 0);
+
+    server.releaseAll();
+    QTest::qWait(100);
+    QCOMPARE(downloaded.count(), 0);
+    QCOMPARE(failed.count(), 0);
+    QCOMPARE(server.received.size(), 1);
+}
+
+void TestPosterDownloader::testConditionalRequest()
+{
+    HttpStandIn server;
+    QVERIFY(server.listen());
+
+    PosterDownloader downloader;
+    downloader.setBaseUrl(server.baseUrl());
+    QSignalSpy downloaded(&downloader, &PosterDownloader::posterDownloaded);
+    QSignalSpy notModified(&downloader, &PosterDownloader::posterNotModified);
+
+    // Nothing known yet: a conditional request is a plain one
+    downloader.request(30, "cond.jpg", PosterDownloader::Visible, true);
+    QTRY_COMPARE(downloaded.count(), 1);
+    QVERIFY(!server.received.at(0).headers.contains("if-none-match"));
+    QCOMPARE(downloader.validators("cond.jpg").etag, QByteArray(HttpStandIn::ETAG));
+    QCOMPARE(downloader.validators("cond.jpg").lastModified, QByteArray(HttpStandIn::LAST_MODIFIED));
+
+    downloader.request(30, "cond.jpg", PosterDownloader::Visible, true);
+    QTRY_COMPARE(notModified.count(), 1);
+    QCOMPARE(server.received.at(1).headers.value("if-none-match"), QByteArray(HttpStandIn::ETAG));
+    QCOMPARE(server.received.at(1).headers.value("if-modified-since"), QByteArray(HttpStandIn::LAST_MODIFIED));
+    QCOMPARE(notModified.at(0).at(0).toInt(), 30);
+
+    // Without a copy the poster is downloaded again
+    downloader.request(30, "cond.jpg", PosterDownloader::Visible, false);
+    QTRY_COMPARE(downloaded.count(), 2);
+    QVERIFY(!server.received.at(2).headers.contains("if-none-match"));
+}
+
+void TestPosterDownloader::testUnconditionalJoinsConditional()
+{
+    HttpStandIn server;
+    QVERIFY(server.listen());
+
+    PosterDownloader downloader;
+    downloader.setBaseUrl(server.baseUrl());
+    QSignalSpy downloaded(&downloader, &PosterDownloader::posterDownloaded);
+    QSignalSpy notModified(&downloader, &PosterDownloader::posterNotModified);
+
+    downloader.request(40, "join.jpg", PosterDownloader::Visible, false);
+    QTRY_COMPARE(downloaded.count(), 1);
+
+    // 41 has no copy and joins the conditional request of 40 that is already on its way
+    server.setHolding(true);
+    downloader.request(40, "join.jpg", PosterDownloader::Visible, true);
+    QTRY_COMPARE(server.received.size(), 2);
+    QCOMPARE(server.received.at(1).headers.value("if-none-match"), QByteArray(HttpStandIn::ETAG));
+    downloader.request(41, "join.jpg", PosterDownloader::Visible, false);
+    QCOMPARE(downloader.activeCount(), 1);
+
+    server.setHolding(false);
+    server.releaseAll();
+    QTRY_COMPARE(downloaded.count(), 2);
+    QCOMPARE(notModified.count(), 1);
+    QCOMPARE(notModified.at(0).at(0).toInt(), 40);
+    QCOMPARE(downloaded.at(1).at(0).toInt(), 41);
+    QCOMPARE(server.received.size(), 3);
+    QVERIFY(!server.received.at(2).headers.contains("if-none-match"));
+    QVERIFY(!downloader.isPending(41));
+}
+
+void TestPosterDownloader::testValidatorsPersist()
+{
+    PosterDownloader::Validators stored;
+    stored.etag = "\"abc\"";
+    stored.lastModified = "Sun, 02 Jan 2022 00:00:00 GMT";
+    {
+        PosterDownloader downloader;
+        downloader.setValidators("persist.jpg", stored);
+    }
+
+    PosterDownloader downloader;
+    QCOMPARE(downloader.validators("persist.jpg").etag, stored.etag);
+    QCOMPARE(downloader.validators("persist.jpg").lastModified, stored.lastModified);
+    QVERIFY(downloader.validators("unknown.jpg").isEmpty());
+}
+
+QTEST_MAIN(TestPosterDownloader)
+#include "test_posterdownloader.moc"
@@ -0,0 +1,240 @@
+#include <QTest>
+#include <QRandomGenerator>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSet>
+#include "../usagi/src/relationgraph.h"
+
+/**
+ * Tests for RelationGraph:
+ *   - Parsing of AniDB relation columns (type codes and names)
+ *   - Chain merge on new edges, split on removed or changed edges
+ *   - Prequel -> sequel ordering of chains
+ *   - Affected anime reported by setRelations() and chainsOf() grouping
+ *   - Incremental updates agree with a graph built from scratch
+ *   - Lazy loading of relations from the database and the revision counter
+ */
+class TestRelationGraph : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParseRelations();
+    void testMergeChains();
+    void testSplitChain();
+    void testChainOrder();
+    void testAffectedAnime();
+    void testChainsOf();
+    void testIncrementalMatchesRebuild();
+    void testEnsureLoadedFromDatabase();
+};
+
+namespace {
+
+// Set of anime per chain, independent of chain order
+QSet<QSet<int>> chainSets(const RelationGraph &graph, const QList<int> &aids)
+{
+    QSet<QSet<int>> sets;
+    for (const QList<int> &chain : graph.chainsOf(aids)) {
+        sets.insert(QSet<int>(chain.cbegin(), chain.cend()));
+    }
+    return sets;
+}
+
+} // namespace
+
+void TestRelationGraph::testParseRelations()
+{
+    QCOMPARE(RelationGraph::parseRelations("10'20", "2'1"), qMakePair(10, 20));
+    QCOMPARE(RelationGraph::parseRelations("1'3", "prequel'sequel"), qMakePair(1, 3));
+    QCOMPARE(RelationGraph::parseRelations("5", "Prequel"), qMakePair(5, 0));
+
+    // Other relation types are ignored, the lowest aid wins
+    QCOMPARE(RelationGraph::parseRelations("30'40'20", "1'51'1"), qMakePair(0, 20));
+
+    QCOMPARE(RelationGraph::parseRelations("", ""), qMakePair(0, 0));
+    QCOMPARE(RelationGraph::parseRelations("10'20", "2"), qMakePair(10, 0));
+}
+
+void TestRelationGraph::testMergeChains()
+{
+    RelationGraph graph;
+    graph.setRelations(1, 0, 2);
+    graph.setRelations(3, 0, 4);
+    QVERIFY(graph.sameChain(1, 2));
+    QVERIFY(!graph.sameChain(2, 3));
+    QCOMPARE(graph.chainCount(), 2);
+
+    // 2 -> 3 joins both chains
+    graph.setRelations(2, 1, 3);
+    QVERIFY(graph.sameChain(1, 4));
+    QCOMPARE(graph.chainCount(), 1);
+    QCOMPARE(graph.chainOf(4), QList<int>({1, 2, 3, 4}));
+}
+
+void TestRelationGraph::testSplitChain()
+{
+    RelationGraph graph;
+    graph.setRelations(1, 0, 2);
+    graph.setRelations(2, 1, 3);
+    graph.setRelations(3, 2, 0);
+    QCOMPARE(graph.chainOf(1), QList<int>({1, 2, 3}));
+
+    // Remove both edges between 2 and 3
+    graph.setRelations(2, 1, 0);
+    QCOMPARE(graph.chainOf(1), QList<int>({1, 2, 3}));  // 3 still names 2 as prequel
+    graph.setRelations(3, 0, 0);
+    QCOMPARE(graph.chainOf(1), QList<int>({1, 2}));
+    QCOMPARE(graph.chainOf(3), QList<int>({3}));
+    QVERIFY(!graph.sameChain(2, 3));
+
+    // Changing an edge moves the anime to the other chain
+    graph.setRelations(10, 0, 11);
+    graph.setRelations(3, 11, 0);
+    QCOMPARE(graph.chainOf(3), QList<int>({10, 11, 3}));
+    graph.setRelations(3, 2, 0);
+    QCOMPARE(graph.chainOf(3), QList<int>({1, 2, 3}));
+    QCOMPARE(graph.chainOf(10), QList<int>({10, 11}));
+}
+
+void TestRelationGraph::testChainOrder()
+{
+    RelationGraph graph;
+    // Sequel links only, prequel links only, and inserted out of order
+    graph.setRelations(50, 0, 7);
+    graph.setRelations(7, 0, 300);
+    graph.setRelations(2, 300, 0);
+    QCOMPARE(graph.chainOf(2), QList<int>({50, 7, 300, 2}));
+    QCOMPARE(graph.prequelOf(2), 300);
+    QCOMPARE(graph.sequelOf(50), 7);
+
+    // Two anime claiming the same sequel: roots in aid order
+    graph.setRelations(40, 0, 7);
+    QCOMPARE(graph.chainOf(7), QList<int>({40, 50, 7, 300, 2}));
+
+    // A relation cycle keeps every anime, cycle members in aid order
+    RelationGraph cycle;
+    cycle.setRelations(5, 0, 6);
+    cycle.setRelations(6, 0, 4);
+    cycle.setRelations(4, 0, 5);
+    QCOMPARE(cycle.chainOf(6), QList<int>({4, 5, 6}));
+
+    // Unknown anime form their own chain
+    QCOMPARE(graph.chainOf(999), QList<int>({999}));
+}
+
+void TestRelationGraph::testAffectedAnime()
+{
+    RelationGraph graph;
+    QList<int> affected = graph.setRelations(1, 0, 2);
+    QCOMPARE(QSet<int>(affected.cbegin(), affected.cend()), QSet<int>({1, 2}));
+
+    // Same relations again: nothing changes
+    QVERIFY(graph.setRelations(1, 0, 2).isEmpty());
+    QVERIFY(graph.setRelations(1, "2", "1").isEmpty());
+
+    // First relations of a known anime report its chain even if the edges exist
+    affected = graph.setRelations(2, 1, 0);
+    QCOMPARE(QSet<int>(affected.cbegin(), affected.cend()), QSet<int>({1, 2}));
+
+    graph.setRelations(5, 0, 6);
+    affected = graph.setRelations(2, 1, 5);
+    QCOMPARE(QSet<int>(affected.cbegin(), affected.cend()), QSet<int>({1, 2, 5, 6}));
+
+    // A split reports the whole former chain
+    affected = graph.setRelations(2, 1, 0);
+    QCOMPARE(QSet<int>(affected.cbegin(), affected.cend()), QSet<int>({1, 2, 5, 6}));
+    QVERIFY(!graph.sameChain(2, 5));
+}
+
+void TestRelationGraph::testChainsOf()
+{
+    RelationGraph graph;
+    graph.setRelations(1, 0, 2);
+    graph.setRelations(2, 1, 0);
+    graph.setRelations(10, 0, 0);
+
+    const QList<QList<int>> chains = graph.chainsOf({2, 10, 1, 77, 77});
+    QCOMPARE(chains.size(), 3);
+    QCOMPARE(chains[0], QList<int>({1, 2}));
+    QCOMPARE(chains[1], QList<int>({10}));
+    QCOMPARE(chains[2], QList<int>({77}));
+}
+
+void TestRelationGraph::testIncrementalMatchesRebuild()
+{
+    // Random relation edits applied incrementally must give the same chains as
+    // a graph fed only the final relations
+    QRandomGenerator rng(7);
+    const int animeCount = 200;
+    QHash<int, QPair<int, int>> relations;
+    RelationGraph incremental;
+
+    for (int step = 0; step < 2000; ++step) {
+        const int aid = 1 + rng.bounded(animeCount);
+        const int prequel = rng.bounded(3) == 0 ? 0 : 1 + rng.bounded(animeCount);
+        const int sequel = rng.bounded(3) == 0 ? 0 : 1 + rng.bounded(animeCount);
+        relations[aid] = qMakePair(prequel, sequel);
+        incremental.setRelations(aid, prequel, sequel);
+    }
+
+    RelationGraph rebuilt;
+    for (auto it = relations.constBegin(); it != relations.constEnd(); ++it) {
+        rebuilt.setRelations(it.key(), it.value().first, it.value().second);
+    }
+
+    QList<int> aids;
+    for (int aid = 1; aid <= animeCount; ++aid) {
+        aids.append(aid);
+    }
+    QCOMPARE(chainSets(incremental, aids), chainSets(rebuilt, aids));
+    for (int aid : aids) {
+        QCOMPARE(incremental.chainOf(aid), rebuilt.chainOf(aid));
+    }
+}
+
+void TestRelationGraph::testEnsureLoadedFromDatabase()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+    db.setDatabaseName(":memory:");
+    QVERIFY(db.open());
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec("CREATE TABLE anime (aid INTEGER PRIMARY KEY, relaidlist TEXT, relaidtype TEXT)"));
+    QVERIFY(q.exec("INSERT INTO anime VALUES (1, '2', 'sequel')"));
+    QVERIFY(q.exec("INSERT INTO anime VALUES (2, '1''3', 'prequel''sequel')"));
+    QVERIFY(q.exec("INSERT INTO anime VALUES (3, '2', 'prequel')"));
+    QVERIFY(q.exec("INSERT INTO anime VALUES (4, NULL, NULL)"));
+
+    RelationGraph graph;
+    graph.ensureLoaded(2);
+    QVERIFY(graph.isLoaded(2));
+    QVERIFY(!graph.isLoaded(1));
+    QCOMPARE(graph.prequelOf(2), 1);
+    QCOMPARE(graph.sequelOf(2), 3);
+    QCOMPARE(graph.chainOf(3), QList<int>({1, 2, 3}));
+
+    // Loading known relations again changes nothing
+    const quint64 revision = graph.revision();
+    graph.ensureLoaded(2);
+    QCOMPARE(graph.revision(), revision);
+    graph.ensureLoaded(4);
+    QVERIFY(graph.revision() > revision);
+    QCOMPARE(graph.chainOf(4), QList<int>({4}));
+
+    // Anime without a row are recorded as having no relations
+    graph.ensureLoaded(99);
+    QVERIFY(graph.isLoaded(99));
+    QCOMPARE(graph.sequelOf(99), 0);
+
+    // Relations fed before loading take precedence over the database
+    RelationGraph fed;
+    fed.setRelations(2, 0, 0);
+    fed.ensureLoaded(2);
+    QCOMPARE(fed.sequelOf(2), 0);
+
+    db.close();
+}
+
+QTEST_MAIN(TestRelationGraph)
+#include "test_relationgraph.moc"
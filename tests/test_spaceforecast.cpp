@@ -0,0 +1,188 @@
+#include <QTest>
+#include "../usagi/src/spaceforecast.h"
+
+/**
+ * Tests for SpaceForecast:
+ *   - Rates start at zero and follow a steady inflow towards its true value
+ *   - Outflow lowers the net rate; a shrinking rate decays after inflow stops
+ *   - Time to threshold: already below, not shrinking, and a steady download
+ *   - Idle detection: activity, new files and playback keep the drive busy
+ *   - Deleting ahead only when idle, above the threshold and inside the horizon
+ */
+class TestSpaceForecast : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testInitialState();
+    void testSteadyInflowConverges();
+    void testOutflowAndDecay();
+    void testSecondsUntilThreshold();
+    void testIdle();
+    void testShouldDeleteAhead();
+};
+
+namespace {
+
+constexpr qint64 MINUTE_MS = 60 * 1000;
+constexpr qint64 GB = 1024LL * 1024 * 1024;
+
+// Feed @p bytesPerMinute for @p minutes, advancing once a minute; returns the end time
+qint64 feed(SpaceForecast &forecast, qint64 startMs, int minutes, qint64 bytesPerMinute)
+{
+    qint64 now = startMs;
+    for (int i = 0; i < minutes; ++i) {
+        now += MINUTE_MS;
+        if (bytesPerMinute > 0) {
+            forecast.recordInflow(now, bytesPerMinute);
+        }
+        forecast.advance(now);
+    }
+    return now;
+}
+
+} // namespace
+
+void TestSpaceForecast::testInitialState()
+{
+    SpaceForecast forecast;
+    QCOMPARE(forecast.inflowRate(), 0.0);
+    QCOMPARE(forecast.outflowRate(), 0.0);
+    QVERIFY(forecast.isIdle(0));
+    QCOMPARE(forecast.secondsUntilThreshold(100 * GB, 50 * GB), qint64(-1));
+    QVERIFY(!forecast.shouldDeleteAhead(0, 100 * GB, 50 * GB));
+
+    // The first advance only starts the clock
+    forecast.recordInflow(0, GB);
+    forecast.advance(0);
+    QCOMPARE(forecast.inflowRate(), 0.0);
+}
+
+void TestSpaceForecast::testSteadyInflowConverges()
+{
+    SpaceForecast forecast;
+    forecast.advance(0);
+
+    // 60 MB per minute = 1 MB/s for eight hours (eight time constants)
+    const qint64 perMinute = 60 * 1024 * 1024;
+    const double trueRate = perMinute / 60.0;
+    qint64 now = feed(forecast, 0, 60, perMinute);
+    const double afterOneHour = forecast.inflowRate();
+    QVERIFY(afterOneHour > 0.5 * trueRate);
+    QVERIFY(afterOneHour < trueRate);
+
+    now = feed(forecast, now, 7 * 60, perMinute);
+    QVERIFY(qAbs(forecast.inflowRate() - trueRate) < 0.01 * trueRate);
+    QCOMPARE(forecast.netRate(), forecast.inflowRate());
+
+    // Irregular ticks converge to the same rate
+    SpaceForecast irregular;
+    irregular.advance(0);
+    qint64 t = 0;
+    for (int i = 0; t < 8 * 60 * MINUTE_MS; ++i) {
+        const qint64 step = (i % 3 + 1) * MINUTE_MS;
+        t += step;
+        irregular.recordInflow(t, perMinute * (step / MINUTE_MS));
+        irregular.advance(t);
+    }
+    QVERIFY(qAbs(irregular.inflowRate() - trueRate) < 0.01 * trueRate);
+}
+
+void TestSpaceForecast::testOutflowAndDecay()
+{
+    SpaceForecast forecast;
+    forecast.advance(0);
+    const qint64 perMinute = 60 * 1024 * 1024;
+    qint64 now = feed(forecast, 0, 8 * 60, perMinute);
+    const double inflow = forecast.inflowRate();
+
+    // Deleting as much as arrives brings the net rate to about zero
+    for (int i = 0; i < 8 * 60; ++i) {
+        now += MINUTE_MS;
+        forecast.recordInflow(now, perMinute);
+        forecast.recordOutflow(now, perMinute);
+        forecast.advance(now);
+    }
+    QVERIFY(qAbs(forecast.netRate()) < 0.01 * inflow);
+
+    // Without new files both rates fade
+    now = feed(forecast, now, 5 * 60, 0);
+    QVERIFY(forecast.inflowRate() < 0.01 * inflow);
+    QVERIFY(forecast.outflowRate() < 0.01 * inflow);
+}
+
+void TestSpaceForecast::testSecondsUntilThreshold()
+{
+    SpaceForecast forecast;
+    forecast.advance(0);
+    const qint64 perMinute = 60 * 1024 * 1024;
+    feed(forecast, 0, 10 * 60, perMinute);
+    const double rate = forecast.inflowRate();
+
+    QCOMPARE(forecast.secondsUntilThreshold(40 * GB, 50 * GB), qint64(0));
+    QCOMPARE(forecast.secondsUntilThreshold(50 * GB, 50 * GB), qint64(0));
+
+    const qint64 seconds = forecast.secondsUntilThreshold(60 * GB, 50 * GB);
+    QCOMPARE(seconds, static_cast<qint64>(10 * GB / rate));
+    // About 1 MB/s: 10 GB last close to three hours
+    QVERIFY(seconds > 2 * 3600 && seconds < 4 * 3600);
+}
+
+void TestSpaceForecast::testIdle()
+{
+    SpaceForecast forecast;
+    const qint64 start = 1000 * MINUTE_MS;
+    QVERIFY(forecast.isIdle(start));
+
+    forecast.noteActivity(start);
+    QVERIFY(!forecast.isIdle(start + SpaceForecast::IDLE_AFTER_MS - 1));
+    QVERIFY(forecast.isIdle(start + SpaceForecast::IDLE_AFTER_MS));
+
+    // An older event does not move the last activity back
+    forecast.noteActivity(start - MINUTE_MS);
+    QVERIFY(forecast.isIdle(start + SpaceForecast::IDLE_AFTER_MS));
+
+    forecast.recordInflow(start + 10 * MINUTE_MS, GB);
+    QVERIFY(!forecast.isIdle(start + 11 * MINUTE_MS));
+
+    // Outflow is our own deletion, not activity
+    forecast.recordOutflow(start + 20 * MINUTE_MS, GB);
+    QVERIFY(forecast.isIdle(start + 20 * MINUTE_MS));
+
+    forecast.setPlaybackActive(true);
+    QVERIFY(!forecast.isIdle(start + 100 * MINUTE_MS));
+    forecast.setPlaybackActive(false);
+    QVERIFY(forecast.isIdle(start + 100 * MINUTE_MS));
+}
+
+void TestSpaceForecast::testShouldDeleteAhead()
+{
+    SpaceForecast forecast;
+    forecast.advance(0);
+    const qint64 perMinute = 60 * 1024 * 1024;   // about 3.5 GB per hour
+    qint64 now = feed(forecast, 0, 10 * 60, perMinute);
+
+    // Still downloading: busy
+    QVERIFY(!forecast.shouldDeleteAhead(now, 60 * GB, 50 * GB));
+
+    // Five quiet minutes later the rate is still high
+    now += SpaceForecast::IDLE_AFTER_MS;
+    QVERIFY(forecast.isIdle(now));
+    QVERIFY(forecast.shouldDeleteAhead(now, 60 * GB, 50 * GB));
+
+    // Threshold further away than the horizon, or already crossed
+    QVERIFY(!forecast.shouldDeleteAhead(now, 500 * GB, 50 * GB));
+    QVERIFY(!forecast.shouldDeleteAhead(now, 40 * GB, 50 * GB));
+
+    // Playback blocks deletion
+    forecast.setPlaybackActive(true);
+    QVERIFY(!forecast.shouldDeleteAhead(now, 60 * GB, 50 * GB));
+    forecast.setPlaybackActive(false);
+
+    // Once the inflow has faded there is no reason to delete ahead
+    now = feed(forecast, now, 10 * 60, 0);
+    QVERIFY(!forecast.shouldDeleteAhead(now, 60 * GB, 50 * GB));
+}
+
+QTEST_MAIN(TestSpaceForecast)
+#include "test_spaceforecast.moc"
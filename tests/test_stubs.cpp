@@ -22,5 +22,5 @@ bool hashes_::event(QEvent *e)
     if (!e) {
         return false;
     }
-    return QTableWidget::event(e);
+    return QTableView::event(e);
 }
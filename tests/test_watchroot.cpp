@@ -0,0 +1,92 @@
+#include <QTest>
+#include "../usagi/src/watchroot.h"
+
+/**
+ * Tests for WatchRoot:
+ *   - Roots survive a JSON round trip; bad entries and text are dropped
+ *   - Files map to the deepest containing root, not to name-prefix siblings
+ *   - Roots nested in a root are listed for its watcher to leave out
+ */
+class TestWatchRoot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testJsonRoundTrip();
+    void testIndexOf();
+    void testNestedRoots();
+};
+
+namespace {
+
+WatchRoot makeRoot(const QString &path, int maxHashers, int priority)
+{
+    WatchRoot root;
+    root.path = path;
+    root.maxHashers = maxHashers;
+    root.priority = priority;
+    return root;
+}
+
+} // namespace
+
+void TestWatchRoot::testJsonRoundTrip()
+{
+    WatchRoot download = makeRoot("/ssd/downloads", 0, 10);
+    download.stabilityDelaySecs = 5;
+    WatchRoot nas = makeRoot("/mnt/nas/anime", 1, -5);
+    nas.scanIntervalSecs = 900;
+    nas.stabilityDelaySecs = 60;
+
+    const QList<WatchRoot> roots{download, nas};
+    QCOMPARE(WatchRoot::fromJson(WatchRoot::toJson(roots)), roots);
+
+    // Entries without a path are dropped; missing fields take the defaults
+    const QList<WatchRoot> parsed = WatchRoot::fromJson(
+        R"([{"path":"/archive/"},{"priority":3},{"path":"/x","maxHashers":-2}])");
+    QCOMPARE(parsed.size(), 2);
+    QCOMPARE(parsed.at(0).path, QString("/archive"));
+    QCOMPARE(parsed.at(0).stabilityDelaySecs, WatchRoot::DEFAULT_STABILITY_DELAY_SECS);
+    QCOMPARE(parsed.at(1).maxHashers, 0);
+
+    QVERIFY(WatchRoot::fromJson(QString()).isEmpty());
+    QVERIFY(WatchRoot::fromJson("not json").isEmpty());
+}
+
+void TestWatchRoot::testIndexOf()
+{
+    const QList<WatchRoot> roots{
+        makeRoot("/media/anime", 0, 0),
+        makeRoot("/media/anime/incoming", 0, 0),
+        makeRoot("/", 0, 0),
+    };
+
+    QCOMPARE(WatchRoot::indexOf(roots, "/media/anime/show/ep1.mkv"), 0);
+    QCOMPARE(WatchRoot::indexOf(roots, "/media/anime/incoming/ep2.mkv"), 1);
+    // Same name prefix, different directory
+    QCOMPARE(WatchRoot::indexOf(roots, "/media/anime2/ep3.mkv"), 2);
+    QCOMPARE(WatchRoot::indexOf(roots.mid(0, 2), "/media/anime2/ep3.mkv"), -1);
+    QCOMPARE(WatchRoot::indexOf(roots.mid(0, 2), "/media/anime"), -1);
+}
+
+void TestWatchRoot::testNestedRoots()
+{
+    const QList<WatchRoot> roots{
+        makeRoot("/media", 0, 0),
+        makeRoot("/media/anime", 0, 0),
+        makeRoot("/media/anime/incoming", 0, 0),
+        makeRoot("/media2", 0, 0),
+        makeRoot("/", 0, 0),
+    };
+
+    QCOMPARE(WatchRoot::nestedRoots(roots, 0), QStringList({"/media/anime", "/media/anime/incoming"}));
+    QCOMPARE(WatchRoot::nestedRoots(roots, 1), QStringList({"/media/anime/incoming"}));
+    QVERIFY(WatchRoot::nestedRoots(roots, 2).isEmpty());
+    // Same name prefix is not nesting
+    QVERIFY(WatchRoot::nestedRoots(roots, 3).isEmpty());
+    QCOMPARE(WatchRoot::nestedRoots(roots, 4).size(), 4);
+    QVERIFY(WatchRoot::nestedRoots(roots, 5).isEmpty());
+}
+
+QTEST_MAIN(TestWatchRoot)
+#include "test_watchroot.moc"
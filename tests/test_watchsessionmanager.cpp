@@ -410,6 +410,16 @@ void TestWatchSessionManager::testGetSeriesChain()
     chain = manager->getSeriesChain(4);
     QCOMPARE(chain.size(), 1);
     QCOMPARE(chain[0], 4);
+    
+    // A second sequel of anime 2 is a side branch: its chain is the main line it
+    // descends from, not the whole connected group
+    QSqlQuery q(QSqlDatabase::database());
+    q.exec("INSERT INTO anime (aid, name_romaji, relaidlist, relaidtype, is_hidden) "
+           "VALUES (5, 'Side Story', '2', 'prequel', 0)");
+    chain = manager->getSeriesChain(5);
+    QCOMPARE(chain, QList<int>({1, 2, 3}));
+    QCOMPARE(manager->getOriginalPrequel(5), 1);
+    QCOMPARE(manager->getSeriesChain(3), QList<int>({1, 2, 3}));
 }
 
 void TestWatchSessionManager::testAutoStartSessionsForExistingAnime()
@@ -539,22 +539,22 @@ QString AniDBApi::ParseMessage(QString Message, QString ReplyTo, QString ReplyTo
 			// Common case: "598 UNKNOWN COMMAND" becomes Tag="598", ReplyID="UNKNOWN"
 			ReplyID = Tag;
 			Tag = "0"; // Use default tag since none was provided
-			Logger::log("[AniDB Response] Tagless response detected - Tag: " + Tag + " ReplyID: " + ReplyID, __FILE__, __LINE__);
+			LOG_DEBUG("[AniDB Response] Tagless response detected - Tag: " + Tag + " ReplyID: " + ReplyID);
 		}
 		else
 		{
-			Logger::log("[AniDB Response] Tag: " + Tag + " ReplyID: " + ReplyID, __FILE__, __LINE__);
+			LOG_DEBUG("[AniDB Response] Tag: " + Tag + " ReplyID: " + ReplyID);
 		}
 	}
 	else
 	{
-		Logger::log("[AniDB Response] Tag: " + Tag + " ReplyID: " + ReplyID, __FILE__, __LINE__);
+		LOG_DEBUG("[AniDB Response] Tag: " + Tag + " ReplyID: " + ReplyID);
 	}
 	
 	// Log truncation status
 	if(isTruncated)
 	{
-		Logger::log("[AniDB Response] TRUNCATED response detected for Tag: " + Tag + " ReplyID: " + ReplyID, __FILE__, __LINE__);
+		LOG_DEBUG("[AniDB Response] TRUNCATED response detected for Tag: " + Tag + " ReplyID: " + ReplyID);
 	}
 
 	token.pop_front();
@@ -1007,13 +1007,13 @@ QString AniDBApi::ParseMessage(QString Message, QString ReplyTo, QString ReplyTo
 		}
 		
 		// Debug logging
-		Logger::log("[AniDB Response] 230 ANIME raw data: " + responseData, __FILE__, __LINE__);
-		Logger::log("[AniDB Response] 230 ANIME field count: " + QString::number(token2.size()), __FILE__, __LINE__);
+		LOG_DEBUG("[AniDB Response] 230 ANIME raw data: " + responseData);
+		LOG_DEBUG("[AniDB Response] 230 ANIME field count: " + QString::number(token2.size()));
 		
 		// Log first few fields for debugging
 		for(int i = 0; i < qMin(10, token2.size()); i++)
 		{
-			Logger::log("[AniDB Response] 230 ANIME token[" + QString::number(i) + "]: '" + token2.at(i) + "'", __FILE__, __LINE__);
+			LOG_DEBUG("[AniDB Response] 230 ANIME token[" + QString::number(i) + "]: '" + token2.at(i) + "'");
 		}
 		
 		if(token2.size() >= 1)
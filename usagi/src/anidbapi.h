@@ -420,6 +420,11 @@ public:
 	void setWatcherEnabled(bool enabled);
 	void setWatcherDirectory(QString directory);
 	void setWatcherAutoStart(bool autoStart);
+	int getWatcherStabilityDelay();
+	void setWatcherStabilityDelay(int seconds);
+	// Watched roots as JSON (see WatchRoot); empty until saved once
+	QString getWatcherRoots();
+	void setWatcherRoots(QString roots);
 	
 	// Auto-fetch settings
 	bool getAutoFetchEnabled();
@@ -441,6 +446,10 @@ public:
 	bool getFilterBarVisible();
 	void setFilterBarVisible(bool visible);
 	
+	// Mylist card view: delegate-painted grid instead of card widgets (applies after restart)
+	bool getPaintedCardGrid();
+	void setPaintedCardGrid(bool enabled);
+	
 	// File marking preferences
 	QString getPreferredAudioLanguages();
 	void setPreferredAudioLanguages(const QString& languages);
@@ -115,6 +115,30 @@ void AniDBApi::setWatcherAutoStart(bool autoStart)
 	AniDBApi::watcherAutoStart = autoStart;
 }
 
+int AniDBApi::getWatcherStabilityDelay()
+{
+	// Delegate to ApplicationSettings
+	return m_settings.getWatcherStabilityDelay();
+}
+
+void AniDBApi::setWatcherStabilityDelay(int seconds)
+{
+	// Delegate to ApplicationSettings (which auto-saves)
+	m_settings.setWatcherStabilityDelay(seconds);
+}
+
+QString AniDBApi::getWatcherRoots()
+{
+	// Delegate to ApplicationSettings
+	return m_settings.getWatcherRoots();
+}
+
+void AniDBApi::setWatcherRoots(QString roots)
+{
+	// Delegate to ApplicationSettings (which auto-saves)
+	m_settings.setWatcherRoots(roots);
+}
+
 // Auto-fetch settings
 bool AniDBApi::getAutoFetchEnabled()
 {
@@ -185,6 +209,18 @@ void AniDBApi::setFilterBarVisible(bool visible)
 	saveSetting("filterBarVisible", visible ? "1" : "0");
 }
 
+bool AniDBApi::getPaintedCardGrid()
+{
+	// Delegate to ApplicationSettings
+	return m_settings.getPaintedCardGrid();
+}
+
+void AniDBApi::setPaintedCardGrid(bool enabled)
+{
+	// Delegate to ApplicationSettings (which auto-saves)
+	m_settings.setPaintedCardGrid(enabled);
+}
+
 // File marking preferences
 QString AniDBApi::getPreferredAudioLanguages()
 {
@@ -16,6 +16,62 @@
 // UI icon constants
 namespace {
     const QString DOWNLOAD_ICON = QString::fromUtf8("\xE2\xAC\x87");  // UTF-8 encoded down arrow (⬇)
+    
+    // Poster label contents until a poster is set
+    const QString POSTER_PLACEHOLDER_TEXT = QStringLiteral("No\nImage");
+    const QString POSTER_PLACEHOLDER_STYLE = QStringLiteral("background-color: #f0f0f0; color: #999;");
+    const QString LOADING_TEXT = QStringLiteral("Loading...");
+    
+    // Memory estimate for the card cache: frame, labels, buttons and tree without rows
+    constexpr qint64 CARD_WIDGET_BYTES = 48 * 1024;
+    // One episode or file row of the episode tree (item, texts, data roles)
+    constexpr qint64 EPISODE_ROW_BYTES = 1024;
+    
+    const QString LOCK_PREFIX = QString::fromUtf8("\xF0\x9F\x94\x92 ");  // 🔒
+    
+    // Episode row text ("Ep 3: Title (2 files)"), without the lock marker
+    QString episodeRowText(const CardEpisodeInfo& episode)
+    {
+        QString episodeText;
+        if (episode.episodeNumber().isValid()) {
+            episodeText = QString("Ep %1: %2")
+                .arg(episode.episodeNumber().toDisplayString(), episode.episodeTitle());
+        } else {
+            episodeText = QString("Episode: %1").arg(episode.episodeTitle());
+        }
+        
+        // Show file count
+        if (episode.fileCount() > 1) {
+            episodeText += QString(" (%1 files)").arg(episode.fileCount());
+        }
+        return episodeText;
+    }
+    
+    // Find a local file of an episode for playback (the highest version that exists)
+    bool findPlayableFile(const CardEpisodeInfo& episode, int& lid)
+    {
+        bool anyFileExists = false;
+        int highestFileVersion = -1;  // Start at -1 to handle files with version 0
+        lid = 0;
+        for (const CardFileInfo& file : episode.files()) {
+            if (!file.localFilePath().isEmpty() && QFile::exists(file.localFilePath())) {
+                anyFileExists = true;
+                if (file.version() > highestFileVersion) {
+                    lid = file.lid();
+                    highestFileVersion = file.version();
+                }
+            }
+        }
+        return anyFileExists;
+    }
+    
+    qint64 pixmapBytes(const QPixmap& pixmap)
+    {
+        if (pixmap.isNull()) {
+            return 0;
+        }
+        return static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    }
 }
 
 AnimeCard::AnimeCard(QWidget *parent)
@@ -33,6 +89,10 @@ AnimeCard::AnimeCard(QWidget *parent)
     , m_prequelAid(0)
     , m_sequelAid(0)
     , m_isAnimeLocked(false)
+    , m_episodeTreeBuilt(false)
+    , m_episodeTreeBuildQueued(false)
+    , m_nextEpisodeIndex(-1)
+    , m_nextEpisodeLid(0)
     , m_posterOverlay(nullptr)
 {
     setupUI();
@@ -63,12 +123,12 @@ void AnimeCard::setupUI()
     
     // Poster (left side) - increased by 50%
     m_posterLabel = new QLabel(this);
-    m_posterLabel->setFixedSize(240, 330);  // Increased by 50% from 160x220
+    m_posterLabel->setFixedSize(getPosterSize());  // Increased by 50% from 160x220
     m_posterLabel->setScaledContents(false);  // Changed to false to maintain aspect ratio
     m_posterLabel->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     m_posterLabel->setAlignment(Qt::AlignCenter);
-    m_posterLabel->setText("No\nImage");
-    m_posterLabel->setStyleSheet("background-color: #f0f0f0; color: #999;");
+    m_posterLabel->setText(POSTER_PLACEHOLDER_TEXT);
+    m_posterLabel->setStyleSheet(POSTER_PLACEHOLDER_STYLE);
     m_posterLabel->setMouseTracking(true);
     m_topLayout->addWidget(m_posterLabel);
     
@@ -117,23 +177,10 @@ void AnimeCard::setupUI()
     m_playButton->setStyleSheet("font-size: 9pt; padding: 4px 8px;");
     m_playButton->setToolTip("Play the next unwatched episode");
     connect(m_playButton, &QPushButton::clicked, this, [this]() {
-        // Find first unwatched episode by checking episode-level watch status
-        int topLevelCount = m_episodeTree->topLevelItemCount();
-        
-        for (int i = 0; i < topLevelCount; i++) {
-            QTreeWidgetItem *episodeItem = m_episodeTree->topLevelItem(i);
-            
-            // Check episode-level watch status from the play button column
-            QString episodePlayText = episodeItem->text(1);
-            // Episode is unwatched if it shows play button (▶), not checkmark (✓) or X (✗)
-            if (episodePlayText == "▶") {
-                // Found first unwatched episode - get its lid and emit episodeClicked
-                int lid = episodeItem->data(2, Qt::UserRole).toInt();
-                if (lid > 0) {
-                    emit episodeClicked(lid);
-                    return;
-                }
-            }
+        // First unwatched episode with a local file (see updateNextEpisodeIndicator)
+        if (m_nextEpisodeIndex >= 0 && m_nextEpisodeLid > 0) {
+            emit episodeClicked(m_nextEpisodeLid);
+            return;
         }
         
         // Fallback: emit playAnimeRequested if no unwatched episode found (plays first episode)
@@ -188,8 +235,21 @@ void AnimeCard::setupUI()
     m_episodeTree->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     m_episodeTree->setIndentation(15);  // Indent for file children
     m_episodeTree->setUniformRowHeights(false);  // Allow rows to have different heights
+    m_episodeTree->viewport()->installEventFilter(this);  // Rows are built on the first click
     m_mainLayout->addWidget(m_episodeTree, 1);
     
+    // Expanding the summary row builds the real rows; queued, since the build deletes that row
+    connect(m_episodeTree, &QTreeWidget::itemExpanded, this, [this]() {
+        if (m_episodeTreeBuilt || m_episodeTreeBuildQueued) {
+            return;
+        }
+        m_episodeTreeBuildQueued = true;
+        QMetaObject::invokeMethod(this, [this]() {
+            m_episodeTreeBuildQueued = false;
+            ensureEpisodeTree();
+        }, Qt::QueuedConnection);
+    });
+    
     // Create play button delegate for column 1
     m_playButtonDelegate = new PlayButtonDelegate(this);
     m_episodeTree->setItemDelegateForColumn(1, m_playButtonDelegate);
@@ -359,34 +419,40 @@ void AnimeCard::setRating(const QString& rating)
 }
 
 void AnimeCard::updateStatisticsLabel()
+{
+    m_statsLabel->setText(formatStatistics(m_normalEpisodes, m_totalNormalEpisodes, m_normalViewed,
+                                           m_otherEpisodes, m_otherViewed));
+}
+
+QString AnimeCard::formatStatistics(int normalEpisodes, int totalNormalEpisodes, int normalViewed,
+                                    int otherEpisodes, int otherViewed)
 {
     // Format episode count like tree view: "A/B+C" where A=normalEpisodes, B=totalNormalEpisodes, C=otherEpisodes
     QString episodeText;
-    if (m_totalNormalEpisodes > 0) {
-        if (m_otherEpisodes > 0) {
-            episodeText = QString("%1/%2+%3").arg(m_normalEpisodes).arg(m_totalNormalEpisodes).arg(m_otherEpisodes);
+    if (totalNormalEpisodes > 0) {
+        if (otherEpisodes > 0) {
+            episodeText = QString("%1/%2+%3").arg(normalEpisodes).arg(totalNormalEpisodes).arg(otherEpisodes);
         } else {
-            episodeText = QString("%1/%2").arg(m_normalEpisodes).arg(m_totalNormalEpisodes);
+            episodeText = QString("%1/%2").arg(normalEpisodes).arg(totalNormalEpisodes);
         }
     } else {
-        if (m_otherEpisodes > 0) {
-            episodeText = QString("%1/?+%2").arg(m_normalEpisodes).arg(m_otherEpisodes);
+        if (otherEpisodes > 0) {
+            episodeText = QString("%1/?+%2").arg(normalEpisodes).arg(otherEpisodes);
         } else {
-            episodeText = QString("%1/?").arg(m_normalEpisodes);
+            episodeText = QString("%1/?").arg(normalEpisodes);
         }
     }
     
     // Format viewed count like tree view: "A/B+C" where A=normalViewed, B=normalEpisodes, C=otherViewed
     QString viewedText;
-    if (m_otherEpisodes > 0) {
-        viewedText = QString("%1/%2+%3").arg(m_normalViewed).arg(m_normalEpisodes).arg(m_otherViewed);
+    if (otherEpisodes > 0) {
+        viewedText = QString("%1/%2+%3").arg(normalViewed).arg(normalEpisodes).arg(otherViewed);
     } else {
-        viewedText = QString("%1/%2").arg(m_normalViewed).arg(m_normalEpisodes);
+        viewedText = QString("%1/%2").arg(normalViewed).arg(normalEpisodes);
     }
     
-    QString statsText = QString("Episodes: %1 | Viewed: %2")
+    return QString("Episodes: %1 | Viewed: %2")
         .arg(episodeText, viewedText);
-    m_statsLabel->setText(statsText);
 }
 
 void AnimeCard::setPoster(const QPixmap& pixmap)
@@ -403,23 +469,70 @@ void AnimeCard::setPoster(const QPixmap& pixmap)
     }
 }
 
+void AnimeCard::setPosterThumbnail(const QPixmap& thumbnail)
+{
+    if (!thumbnail.isNull()) {
+        // Already scaled to the poster label (see PosterCache); also used for the overlay
+        m_originalPoster = thumbnail;
+        m_posterLabel->setPixmap(thumbnail);
+        m_posterLabel->setText("");
+        m_posterLabel->setStyleSheet("");
+    }
+}
+
+void AnimeCard::setEpisodes(const QList<EpisodeInfo>& episodes)
+{
+    m_episodeTree->clear();
+    m_episodes = episodes;
+    m_episodeTreeBuilt = false;
+    
+    int fileCount = 0;
+    for (const EpisodeInfo& episode : episodes) {
+        fileCount += episode.fileCount();
+        // Track most recent last played time for this anime
+        for (const FileInfo& file : episode.files()) {
+            m_lastPlayed = qMax(m_lastPlayed, file.lastPlayed());
+        }
+    }
+    
+    // A single summary row until the tree is expanded or clicked; most cards are never
+    // looked at closely, and scrolling past them should not build their rows
+    if (!m_episodes.isEmpty()) {
+        QTreeWidgetItem *summaryItem = new QTreeWidgetItem(m_episodeTree);
+        summaryItem->setText(2, QString("%1 episode(s), %2 file(s)").arg(m_episodes.size()).arg(fileCount));
+        summaryItem->setFlags(Qt::ItemIsEnabled);
+        summaryItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+    
+    updateNextEpisodeIndicator();
+    updateCardBackgroundForUnwatchedEpisodes();
+}
+
 void AnimeCard::addEpisode(const EpisodeInfo& episode)
+{
+    ensureEpisodeTree();
+    m_episodes.append(episode);
+    for (const FileInfo& file : episode.files()) {
+        m_lastPlayed = qMax(m_lastPlayed, file.lastPlayed());
+    }
+    addEpisodeRow(episode);
+    
+    // Update next episode indicator
+    updateNextEpisodeIndicator();
+    
+    // Update card background for unwatched episodes
+    updateCardBackgroundForUnwatchedEpisodes();
+}
+
+void AnimeCard::addEpisodeRow(const EpisodeInfo& episode)
 {
     // Create episode parent item
     QTreeWidgetItem *episodeItem = new QTreeWidgetItem(m_episodeTree);
     
-    // Format episode text
-    QString episodeText;
-    if (episode.episodeNumber().isValid()) {
-        episodeText = QString("Ep %1: %2")
-            .arg(episode.episodeNumber().toDisplayString(), episode.episodeTitle());
-    } else {
-        episodeText = QString("Episode: %1").arg(episode.episodeTitle());
-    }
-    
-    // Show file count
-    if (episode.fileCount() > 1) {
-        episodeText += QString(" (%1 files)").arg(episode.fileCount());
+    // Format episode text; locks applied before the rows were built are shown right away
+    QString episodeText = episodeRowText(episode);
+    if (m_isAnimeLocked || m_lockedEpisodeIds.contains(episode.eid())) {
+        episodeText = LOCK_PREFIX + episodeText;
     }
     
     // Column 0: Empty - expand button only (Qt handles this automatically)
@@ -427,23 +540,8 @@ void AnimeCard::addEpisode(const EpisodeInfo& episode)
     
     // Column 1: Play button for episode - check file availability and episode watch status
     // Find any existing file for playback (prefer highest version)
-    bool anyFileExists = false;
     int existingFileLid = 0;
-    int highestFileVersion = -1;  // Start at -1 to handle files with version 0
-    
-    for (const FileInfo& file : episode.files()) {      
-        if (!file.localFilePath().isEmpty()) {
-            bool exists = QFile::exists(file.localFilePath());
-            if (exists) {
-                anyFileExists = true;
-                // Track highest version file for playback
-                if (file.version() > highestFileVersion) {
-                    existingFileLid = file.lid();
-                    highestFileVersion = file.version();
-                }
-            }
-        } 
-    }
+    bool anyFileExists = findPlayableFile(episode, existingFileLid);
     
     // Set play button based on episode watch status and file availability
     // Watch state is tracked at episode level only (persists across file replacements)
@@ -560,11 +658,6 @@ void AnimeCard::addEpisode(const EpisodeInfo& episode)
         if (file.lastPlayed() > 0) {
             QDateTime lastPlayedTime = QDateTime::fromSecsSinceEpoch(file.lastPlayed());
             tooltip += QString("\nLast Played: %1").arg(lastPlayedTime.toString("yyyy-MM-dd hh:mm"));
-            
-            // Track most recent last played time for this anime
-            if (file.lastPlayed() > m_lastPlayed) {
-                m_lastPlayed = file.lastPlayed();
-            }
         }
         
         fileItem->setToolTip(2, tooltip);
@@ -574,34 +667,43 @@ void AnimeCard::addEpisode(const EpisodeInfo& episode)
     episodeItem->setExpanded(false);
     
     m_episodeTree->addTopLevelItem(episodeItem);
+}
+
+void AnimeCard::ensureEpisodeTree()
+{
+    if (m_episodeTreeBuilt) {
+        return;
+    }
+    m_episodeTreeBuilt = true;
     
-    // Update next episode indicator
-    updateNextEpisodeIndicator();
-    
-    // Update card background for unwatched episodes
-    updateCardBackgroundForUnwatchedEpisodes();
+    m_episodeTree->setUpdatesEnabled(false);
+    m_episodeTree->clear();
+    for (const EpisodeInfo& episode : std::as_const(m_episodes)) {
+        addEpisodeRow(episode);
+    }
+    m_episodeTree->setUpdatesEnabled(true);
 }
 
 void AnimeCard::clearEpisodes()
 {
     m_episodeTree->clear();
+    m_episodes.clear();
+    m_episodeTreeBuilt = false;
 }
 
 void AnimeCard::updateNextEpisodeIndicator()
 {
-    // Find the first unwatched episode (based on episode-level watch status)
-    int topLevelCount = m_episodeTree->topLevelItemCount();
-    
-    for (int i = 0; i < topLevelCount; i++) {
-        QTreeWidgetItem *episodeItem = m_episodeTree->topLevelItem(i);
-        
-        // Check episode-level watch status from the play button column
-        QString episodePlayText = episodeItem->text(1);
-        // Episode is unwatched if it shows play button (▶), not checkmark (✓) or X (✗)
-        if (episodePlayText == "▶") {
-            // Found the first unwatched episode
-            QString episodeText = episodeItem->text(2);
-            m_nextEpisodeLabel->setText("Next: " + episodeText);
+    // Find the first unwatched episode (based on episode-level watch status) with a local file.
+    // Watched episodes are skipped before any file is checked on disk.
+    m_nextEpisodeIndex = -1;
+    m_nextEpisodeLid = 0;
+    for (int i = 0; i < m_episodes.size(); i++) {
+        const EpisodeInfo& episode = m_episodes.at(i);
+        int lid = 0;
+        if (!episode.episodeWatched() && findPlayableFile(episode, lid)) {
+            m_nextEpisodeIndex = i;
+            m_nextEpisodeLid = lid;
+            m_nextEpisodeLabel->setText("Next: " + episodeRowText(episode));
             m_playButton->setEnabled(true);
             return;
         }
@@ -762,6 +864,14 @@ void AnimeCard::leaveEvent(QEvent *event)
 
 bool AnimeCard::eventFilter(QObject *watched, QEvent *event)
 {
+    // First click into the episode tree: build the rows; the click itself only opens the list
+    // (a right click still gets its context menu, which is a separate event)
+    if (watched == m_episodeTree->viewport() && event->type() == QEvent::MouseButtonPress
+        && !m_episodeTreeBuilt && !m_episodes.isEmpty()) {
+        ensureEpisodeTree();
+        return true;
+    }
+    
     // Check if this is a leave event on the poster label
     if (watched == m_posterLabel && event->type() == QEvent::Leave) {
         // Only hide if mouse is not over the overlay
@@ -830,7 +940,7 @@ void AnimeCard::showPosterOverlay()
     }
     
     // Get the original poster size (100% size, no scaling)
-    QSize originalSize = m_originalPoster.size();
+    QSize originalSize = m_originalPoster.deviceIndependentSize().toSize();
     
     // Get poster label position in global coordinates
     QPoint globalPos = m_posterLabel->mapToGlobal(QPoint(0, 0));
@@ -884,21 +994,8 @@ void AnimeCard::hidePosterOverlay()
 
 void AnimeCard::updateCardBackgroundForUnwatchedEpisodes()
 {
-    // Check if there are unwatched episodes
-    bool hasUnwatchedEpisodes = false;
-    int topLevelCount = m_episodeTree->topLevelItemCount();
-    
-    for (int i = 0; i < topLevelCount; i++) {
-        QTreeWidgetItem *episodeItem = m_episodeTree->topLevelItem(i);
-        
-        // Check episode-level watch status from the play button column
-        QString episodePlayText = episodeItem->text(1);
-        // Episode is unwatched if it shows play button (▶)
-        if (episodePlayText == "▶") {
-            hasUnwatchedEpisodes = true;
-            break;
-        }
-    }
+    // An unwatched episode with a local file, as found by updateNextEpisodeIndicator()
+    bool hasUnwatchedEpisodes = (m_nextEpisodeIndex >= 0);
     
     // Apply green background if there are unwatched episodes
     if (hasUnwatchedEpisodes) {
@@ -930,8 +1027,8 @@ void AnimeCard::setAnimeLocked(bool locked)
         }
         m_titleLabel->setText(title);
     }
-    // When anime is locked, mark all episode rows
-    if (m_episodeTree) {
+    // When anime is locked, mark all episode rows (rows built later get the mark from the lock state)
+    if (m_episodeTree && m_episodeTreeBuilt) {
         for (int i = 0; i < m_episodeTree->topLevelItemCount(); ++i) {
             QTreeWidgetItem *item = m_episodeTree->topLevelItem(i);
             if (!item) continue;
@@ -958,7 +1055,7 @@ void AnimeCard::setEpisodeLocked(int eid, bool locked)
         m_lockedEpisodeIds.remove(eid);
     }
     // Update the specific episode row in the tree
-    if (m_episodeTree) {
+    if (m_episodeTree && m_episodeTreeBuilt) {
         for (int i = 0; i < m_episodeTree->topLevelItemCount(); ++i) {
             QTreeWidgetItem *item = m_episodeTree->topLevelItem(i);
             if (!item) continue;
@@ -977,6 +1074,75 @@ void AnimeCard::setEpisodeLocked(int eid, bool locked)
     }
 }
 
+qint64 AnimeCard::estimatedMemoryBytes() const
+{
+    qint64 bytes = CARD_WIDGET_BYTES;
+    bytes += pixmapBytes(m_originalPoster);
+    // A thumbnail is shown as it is, without a scaled copy
+    const QPixmap shownPoster = m_posterLabel->pixmap();
+    if (shownPoster.cacheKey() != m_originalPoster.cacheKey()) {
+        bytes += pixmapBytes(shownPoster);
+    }
+    
+    int rows = m_episodeTree->topLevelItemCount();
+    for (int i = 0; i < m_episodeTree->topLevelItemCount(); ++i) {
+        rows += m_episodeTree->topLevelItem(i)->childCount();
+    }
+    bytes += rows * EPISODE_ROW_BYTES;
+    
+    return bytes;
+}
+
+void AnimeCard::resetContent()
+{
+    hidePosterOverlay();
+    
+    m_animeId = 0;
+    m_animeTitle.clear();
+    m_animeType.clear();
+    m_airedText.clear();
+    m_aired = aired();
+    m_lastPlayed = 0;
+    m_is18Restricted = false;
+    m_prequelAid = 0;
+    m_sequelAid = 0;
+    m_isAnimeLocked = false;
+    m_lockedEpisodeIds.clear();
+    
+    m_originalPoster = QPixmap();
+    m_posterLabel->clear();
+    m_posterLabel->setText(POSTER_PLACEHOLDER_TEXT);
+    m_posterLabel->setStyleSheet(POSTER_PLACEHOLDER_STYLE);
+    
+    m_titleLabel->setText("Anime Title");
+    m_typeLabel->setText("Type: Unknown");
+    m_airedLabel->setText("Aired: Unknown");
+    setRating(QString());
+    setTags(QList<TagInfo>());
+    
+    clearEpisodes();
+    setStatistics(0, 0, 0, 0, 0);
+    updateNextEpisodeIndicator();
+    updateCardBackgroundForUnwatchedEpisodes();
+    
+    setNeedsFetch(false);
+    setHidden(false);
+}
+
+void AnimeCard::showLoadingPlaceholder(int aid)
+{
+    if (m_animeId != 0) {
+        resetContent();
+    }
+    
+    m_animeId = aid;
+    m_titleLabel->setText(LOADING_TEXT);
+    m_typeLabel->setText("Type: " + LOADING_TEXT);
+    m_airedLabel->setText("Aired: " + LOADING_TEXT);
+    m_posterLabel->setText(LOADING_TEXT);
+    m_statsLabel->clear();
+}
+
 QPoint AnimeCard::getLeftConnectionPoint() const
 {
     // Return the center point of the left edge in global coordinates
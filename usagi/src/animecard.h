@@ -72,9 +72,17 @@ public:
     
     // Size management
     static QSize getCardSize() { return QSize(600, 450); }  // Increased from 500x350 to accommodate 50% larger poster
+    static QSize getPosterSize() { return QSize(240, 330); }  // Poster area inside the card
     QSize sizeHint() const override { return getCardSize(); }
     QSize minimumSizeHint() const override { return getCardSize(); }
     
+    // Rough memory footprint (child widgets, poster pixmaps, episode rows), used for the card cache budget
+    qint64 estimatedMemoryBytes() const;
+    
+    // Statistics line as shown on the card ("Episodes: 3/12+1 | Viewed: 2/3+0")
+    static QString formatStatistics(int normalEpisodes, int totalNormalEpisodes, int normalViewed,
+                                    int otherEpisodes, int otherViewed);
+    
 public slots:
     // Slots for anime data updates
     void setAnimeId(int aid);
@@ -84,9 +92,11 @@ public slots:
     void setAiredText(const QString& airedText);
     void setStatistics(int normalEpisodes, int totalNormalEpisodes, int normalViewed, int otherEpisodes, int otherViewed);
     void setPoster(const QPixmap& pixmap);
+    void setPosterThumbnail(const QPixmap& thumbnail);  // Poster already scaled to getPosterSize(), shown as is
     void setRating(const QString& rating);
     void setNeedsFetch(bool needsFetch);
     void setTags(const QList<AnimeCard::TagInfo>& tags);
+    void setEpisodes(const QList<AnimeCard::EpisodeInfo>& episodes);  // Replace all episodes; rows are built when the tree is first used
     void addEpisode(const AnimeCard::EpisodeInfo& episode);
     void clearEpisodes();
     void updateNextEpisodeIndicator();  // Update which episode will play next
@@ -95,6 +105,8 @@ public slots:
     void setSeriesChainInfo(int prequelAid, int sequelAid);  // Set prequel/sequel AIDs for arrow connections
     void setAnimeLocked(bool locked);  // Set anime-level lock state (shows 🔒 in title)
     void setEpisodeLocked(int eid, bool locked);  // Set episode-level lock state (shows 🔒 on episode row)
+    void resetContent();  // Back to the freshly constructed state, so the card can be bound to another anime
+    void showLoadingPlaceholder(int aid);  // Skeleton shown until the anime's card data has been loaded
     
 signals:
     void episodeClicked(int lid);
@@ -127,6 +139,8 @@ private:
     void showPosterOverlay();
     void hidePosterOverlay();
     void updateCardBackgroundForUnwatchedEpisodes();
+    void addEpisodeRow(const EpisodeInfo& episode);
+    void ensureEpisodeTree();  // Build the episode and file rows from m_episodes if still pending
     
     // Data members
     int m_animeId;
@@ -148,6 +162,11 @@ private:
     QPixmap m_originalPoster;  // Store original poster for overlay
     bool m_isAnimeLocked;  // Whether the anime is locked against auto-deletion
     QSet<int> m_lockedEpisodeIds;  // Set of eid values that are episode-locked
+    QList<EpisodeInfo> m_episodes;  // Episodes in display order, source of the tree rows
+    bool m_episodeTreeBuilt;  // False while the tree only shows the summary row
+    bool m_episodeTreeBuildQueued;  // A build is queued after the summary row was expanded
+    int m_nextEpisodeIndex;  // Index in m_episodes of the episode Play starts, -1 if none
+    int m_nextEpisodeLid;  // File Play starts for that episode
     
     // UI elements
     QLabel *m_posterLabel;
@@ -0,0 +1,182 @@
+#include "animecarddelegate.h"
+#include "animecardmodel.h"
+#include "animecard.h"
+#include <QPainter>
+#include <QPixmap>
+
+namespace {
+    // Geometry and colours of AnimeCard::setupUI()
+    constexpr int CARD_MARGIN = 5;
+    constexpr int INFO_SPACING = 6;
+    constexpr int LINE_SPACING = 2;
+    constexpr int TITLE_MAX_HEIGHT = 40;
+    constexpr int HIDDEN_CARD_HEIGHT = 40;
+    const QColor UNWATCHED_BACKGROUND(0xe8, 0xf5, 0xe9);
+    const QColor POSTER_PLACEHOLDER_BACKGROUND(0xf0, 0xf0, 0xf0);
+    const QColor PLACEHOLDER_TEXT(0x99, 0x99, 0x99);
+    const QColor SECONDARY_TEXT(0x66, 0x66, 0x66);
+    const QColor TAGS_TEXT(0x88, 0x88, 0x88);
+    const QColor STATISTICS_TEXT(0x33, 0x33, 0x33);
+
+    QFont scaledFont(const QFont &base, int pointSize, bool bold = false, bool italic = false)
+    {
+        QFont font(base);
+        font.setPointSize(pointSize);
+        font.setBold(bold);
+        font.setItalic(italic);
+        return font;
+    }
+
+    // Draw one text block at the top of rect and return the height it used
+    int drawTextBlock(QPainter *painter, const QRect &rect, const QFont &font, const QColor &color,
+                      const QString &text, int flags, int maxHeight = 0)
+    {
+        if (text.isEmpty() || rect.height() <= 0) {
+            return 0;
+        }
+        painter->setFont(font);
+        painter->setPen(color);
+        QRect bounds = painter->boundingRect(rect, flags, text);
+        if (maxHeight > 0 && bounds.height() > maxHeight) {
+            bounds.setHeight(maxHeight);
+        }
+        bounds.setWidth(rect.width());
+        bounds = bounds.intersected(rect);
+        painter->drawText(bounds, flags, text);
+        return bounds.height() + LINE_SPACING;
+    }
+}
+
+AnimeCardDelegate::AnimeCardDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void AnimeCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                              const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return;
+    }
+
+    painter->save();
+    painter->setClipRect(option.rect);
+
+    const bool hidden = index.data(AnimeCardModel::HiddenRole).toBool();
+    const QString title = index.data(Qt::DisplayRole).toString();
+    const QPalette &palette = option.palette;
+
+    QRect cardRect(option.rect.topLeft(), AnimeCard::getCardSize());
+    if (hidden) {
+        cardRect.setHeight(HIDDEN_CARD_HEIGHT);
+    }
+
+    // Card frame (QFrame::Box | QFrame::Raised, line width 2)
+    const bool unwatched = !hidden && index.data(AnimeCardModel::UnwatchedRole).toBool();
+    painter->fillRect(cardRect, unwatched ? UNWATCHED_BACKGROUND : palette.color(QPalette::Window));
+    painter->setPen(QPen(palette.color(QPalette::Mid), 2));
+    painter->drawRect(cardRect.adjusted(1, 1, -1, -1));
+
+    const QRect content = cardRect.adjusted(CARD_MARGIN, CARD_MARGIN, -CARD_MARGIN, -CARD_MARGIN);
+
+    if (hidden) {
+        // Compact title-only card, as AnimeCard::setHidden(true)
+        painter->setFont(scaledFont(option.font, 10, true));
+        painter->setPen(TAGS_TEXT);
+        painter->drawText(content, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+                          painter->fontMetrics().elidedText(title, Qt::ElideRight, content.width()));
+        painter->restore();
+        return;
+    }
+
+    // Poster column
+    const QRect posterRect(content.topLeft(), QSize(AnimeCardModel::POSTER_WIDTH, AnimeCardModel::POSTER_HEIGHT));
+    const QPixmap poster = index.data(AnimeCardModel::PosterRole).value<QPixmap>();
+    if (poster.isNull()) {
+        painter->fillRect(posterRect, POSTER_PLACEHOLDER_BACKGROUND);
+        painter->setFont(option.font);
+        painter->setPen(PLACEHOLDER_TEXT);
+        painter->drawText(posterRect, Qt::AlignCenter, "No\nImage");
+    } else {
+        QRect target(QPoint(), poster.deviceIndependentSize().toSize());
+        target.moveCenter(posterRect.center());
+        painter->drawPixmap(target, poster);
+    }
+    painter->setPen(palette.color(QPalette::Dark));
+    painter->drawRect(posterRect.adjusted(0, 0, -1, -1));
+
+    // Info column
+    QRect info(posterRect.right() + 1 + INFO_SPACING, content.top(),
+               content.right() - posterRect.right() - INFO_SPACING, posterRect.height());
+    const int wrap = Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap;
+    const int line = Qt::AlignLeft | Qt::AlignTop | Qt::TextSingleLine;
+
+    info.setTop(info.top() + drawTextBlock(painter, info, scaledFont(option.font, 12, true),
+                                           palette.color(QPalette::WindowText), title, wrap, TITLE_MAX_HEIGHT));
+    const QFont smallFont = scaledFont(option.font, 9);
+    info.setTop(info.top() + drawTextBlock(painter, info, smallFont, SECONDARY_TEXT,
+                                           "Type: " + index.data(AnimeCardModel::TypeRole).toString(), line));
+    info.setTop(info.top() + drawTextBlock(painter, info, smallFont, SECONDARY_TEXT,
+                                           "Aired: " + index.data(AnimeCardModel::AiredRole).toString(), line));
+    const QString rating = index.data(AnimeCardModel::RatingRole).toString();
+    if (!rating.isEmpty()) {
+        info.setTop(info.top() + drawTextBlock(painter, info, smallFont, SECONDARY_TEXT,
+                                               "Rating: " + rating, line));
+    }
+    const QStringList tags = index.data(AnimeCardModel::TagsRole).toStringList();
+    if (!tags.isEmpty()) {
+        info.setTop(info.top() + drawTextBlock(painter, info, scaledFont(option.font, 8, false, true), TAGS_TEXT,
+                                               "Tags: " + tags.join(", "), wrap));
+    }
+    drawTextBlock(painter, info, smallFont, STATISTICS_TEXT,
+                  index.data(AnimeCardModel::StatisticsRole).toString(), line);
+
+    // Episode area: filled by the real card once it is pointed at
+    const QRect episodes(content.left(), posterRect.bottom() + 1 + CARD_MARGIN,
+                         content.width(), content.bottom() - posterRect.bottom() - CARD_MARGIN);
+    painter->setPen(palette.color(QPalette::Mid));
+    painter->drawRect(episodes.adjusted(0, 0, -1, -1));
+
+    painter->restore();
+}
+
+QSize AnimeCardDelegate::sizeHint(const QStyleOptionViewItem &option,
+                                  const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    // Uniform slots like VirtualFlowLayout; hidden cards are painted compact at the top
+    return AnimeCard::getCardSize();
+}
+
+QWidget* AnimeCardDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                                         const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    if (!m_editorFactory) {
+        return nullptr;
+    }
+    return m_editorFactory(index.data(AnimeCardModel::AnimeIdRole).toInt(), parent);
+}
+
+void AnimeCardDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    Q_UNUSED(editor);
+    Q_UNUSED(index);
+}
+
+void AnimeCardDelegate::setModelData(QWidget *editor, QAbstractItemModel *model,
+                                     const QModelIndex &index) const
+{
+    Q_UNUSED(editor);
+    Q_UNUSED(model);
+    Q_UNUSED(index);
+}
+
+void AnimeCardDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option,
+                                             const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    // Cards have a fixed size; only the position follows the row
+    editor->move(option.rect.topLeft());
+}
@@ -0,0 +1,50 @@
+#ifndef ANIMECARDDELEGATE_H
+#define ANIMECARDDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <functional>
+
+/**
+ * AnimeCardDelegate - Paints AnimeCardModel rows as mylist cards
+ *
+ * Poster, title, type, aired dates, rating, tags and statistics are drawn
+ * straight from the model roles, with the same geometry and colours as
+ * AnimeCard, so scrolling costs a few draw calls per visible card instead of a
+ * widget tree each. The episode list and buttons are not painted; the card the
+ * user interacts with gets a real AnimeCard as its (persistent) editor, built by
+ * the editor factory.
+ */
+class AnimeCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    // Editor factory callback type: takes the anime ID and the editor parent
+    using EditorFactory = std::function<QWidget*(int aid, QWidget *parent)>;
+
+    explicit AnimeCardDelegate(QObject *parent = nullptr);
+
+    void setEditorFactory(const EditorFactory &factory) { m_editorFactory = factory; }
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+
+    QSize sizeHint(const QStyleOptionViewItem &option,
+                   const QModelIndex &index) const override;
+
+    QWidget* createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+
+    // The card reads its data from the manager; nothing is exchanged with the model
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model,
+                      const QModelIndex &index) const override;
+
+    void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option,
+                              const QModelIndex &index) const override;
+
+private:
+    EditorFactory m_editorFactory;
+};
+
+#endif // ANIMECARDDELEGATE_H
@@ -0,0 +1,154 @@
+#include "animecardmodel.h"
+#include "mylistcardmanager.h"
+#include <QGuiApplication>
+
+namespace {
+    // Default display cache budget: 64 MiB of decoded posters
+    constexpr int DEFAULT_CACHE_KIB = 64 * 1024;
+}
+
+AnimeCardModel::AnimeCardModel(MyListCardManager *manager, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_manager(manager)
+    , m_entries(DEFAULT_CACHE_KIB)
+{
+    connect(m_manager, &MyListCardManager::cardUpdated, this, &AnimeCardModel::onCardDataChanged);
+    connect(m_manager, &MyListCardManager::allCardsLoaded, this, &AnimeCardModel::invalidate);
+    connect(m_manager, &MyListCardManager::posterThumbnailReady, this, &AnimeCardModel::onPosterReady);
+}
+
+int AnimeCardModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_aids.size());
+}
+
+QVariant AnimeCardModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_aids.size()) {
+        return QVariant();
+    }
+    const int aid = m_aids.at(index.row());
+
+    if (role == AnimeIdRole) {
+        return aid;
+    }
+
+    const Entry *cached = entry(aid);
+    if (!cached) {
+        return QVariant();
+    }
+    switch (role) {
+        case Qt::DisplayRole:
+        case Qt::ToolTipRole:
+            return cached->title;
+        case TypeRole:
+            return cached->typeName;
+        case AiredRole:
+            return cached->airedText;
+        case RatingRole:
+            return cached->rating;
+        case TagsRole:
+            return cached->tags;
+        case StatisticsRole:
+            return cached->statistics;
+        case PosterRole:
+            return cached->poster;
+        case UnwatchedRole:
+            return cached->hasUnwatchedEpisodes;
+        case HiddenRole:
+            return cached->hidden;
+        default:
+            return QVariant();
+    }
+}
+
+int AnimeCardModel::rowForAnime(int aid) const
+{
+    return m_rowByAid.value(aid, -1);
+}
+
+void AnimeCardModel::reload()
+{
+    beginResetModel();
+    m_aids = m_manager->getAnimeIdList();
+    m_rowByAid.clear();
+    m_rowByAid.reserve(m_aids.size());
+    for (int row = 0; row < m_aids.size(); ++row) {
+        m_rowByAid.insert(m_aids.at(row), row);
+    }
+    endResetModel();
+}
+
+void AnimeCardModel::onCardDataChanged(int aid)
+{
+    m_entries.remove(aid);
+    const int row = rowForAnime(aid);
+    if (row >= 0) {
+        const QModelIndex changed = index(row);
+        emit dataChanged(changed, changed);
+    }
+}
+
+void AnimeCardModel::onPosterReady(int aid, const QImage &thumbnail)
+{
+    // Only rows whose display data is cached wait for a poster
+    Entry *cached = m_entries.take(aid);
+    if (!cached) {
+        return;
+    }
+    cached->poster = QPixmap::fromImage(thumbnail);
+    insertEntry(aid, cached);
+
+    const int row = rowForAnime(aid);
+    if (row >= 0) {
+        const QModelIndex changed = index(row);
+        emit dataChanged(changed, changed, {PosterRole});
+    }
+}
+
+void AnimeCardModel::invalidate()
+{
+    m_entries.clear();
+    if (!m_aids.isEmpty()) {
+        emit dataChanged(index(0), index(static_cast<int>(m_aids.size()) - 1));
+    }
+}
+
+const AnimeCardModel::Entry* AnimeCardModel::entry(int aid) const
+{
+    if (Entry *cached = m_entries.object(aid)) {
+        return cached;
+    }
+
+    const MyListCardManager::CardDisplayData display = m_manager->getCardDisplayData(aid);
+    if (!display.valid) {
+        return nullptr;
+    }
+
+    Entry *built = new Entry;
+    built->title = display.title;
+    built->typeName = display.typeName;
+    built->airedText = display.airedText;
+    built->rating = display.rating;
+    built->tags = display.tagNames;
+    built->statistics = display.statistics;
+    built->hasUnwatchedEpisodes = display.hasUnwatchedEpisodes;
+    built->hidden = display.isHidden;
+    insertEntry(aid, built);
+
+    // The poster is decoded and scaled on the manager's poster workers; the row is
+    // painted with the placeholder until onPosterReady()
+    if (display.hasPoster) {
+        m_manager->requestPosterThumbnail(aid, QSize(POSTER_WIDTH, POSTER_HEIGHT),
+                                          qGuiApp->devicePixelRatio(), true);
+    }
+    return m_entries.object(aid);
+}
+
+void AnimeCardModel::insertEntry(int aid, Entry *entry) const
+{
+    const qint64 posterBytes = static_cast<qint64>(entry->poster.width()) * entry->poster.height()
+                               * entry->poster.depth() / 8;
+    const int cost = qMax(1, static_cast<int>(posterBytes / 1024));
+    m_entries.insert(aid, entry, cost);
+}
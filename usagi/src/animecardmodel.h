@@ -0,0 +1,95 @@
+#ifndef ANIMECARDMODEL_H
+#define ANIMECARDMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QStringList>
+
+class MyListCardManager;
+
+/**
+ * AnimeCardModel - List model over the mylist card data cache
+ *
+ * Backs the painted card grid (AnimeCardDelegate in a QListView): one row per
+ * anime in MyListCardManager's current order, with the card fields as roles.
+ * No widgets are created; the view only paints the rows it shows.
+ *
+ * Display data is built on first use and kept in a cost-bounded cache together
+ * with the poster thumbnail, which the manager's poster workers decode and scale
+ * to the card's poster size off the GUI thread. The hidden flag is part of the
+ * cached entry, so painting a row never goes back to the manager's anime data.
+ */
+class AnimeCardModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        AnimeIdRole = Qt::UserRole + 1,
+        TypeRole,
+        AiredRole,
+        RatingRole,
+        TagsRole,           // QStringList, highest weight first
+        StatisticsRole,
+        PosterRole,         // QPixmap fitted into POSTER_WIDTH x POSTER_HEIGHT, null without poster
+        UnwatchedRole,
+        HiddenRole
+    };
+
+    static constexpr int POSTER_WIDTH = 240;
+    static constexpr int POSTER_HEIGHT = 330;
+
+    explicit AnimeCardModel(MyListCardManager *manager, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Row of an anime in the current order, -1 if it is not shown
+    int rowForAnime(int aid) const;
+
+    // Budget of the display cache in KiB of decoded posters (default 64 MiB)
+    void setCacheBudget(int kibibytes) { m_entries.setMaxCost(kibibytes); }
+
+public slots:
+    // Take over the manager's current (sorted and filtered) anime list
+    void reload();
+
+    // Drop cached display data of an anime and repaint its row
+    void onCardDataChanged(int aid);
+
+    // Drop all cached display data and repaint (after the manager refreshed every card)
+    void invalidate();
+
+    // Poster thumbnail of an anime arrived; repaint its row if it is cached
+    void onPosterReady(int aid, const QImage &thumbnail);
+
+private:
+    struct Entry {
+        QString title;
+        QString typeName;
+        QString airedText;
+        QString rating;
+        QStringList tags;
+        QString statistics;
+        QPixmap poster;
+        bool hasUnwatchedEpisodes = false;
+        bool hidden = false;
+    };
+
+    // Cached display data of an anime, built on a miss
+    const Entry* entry(int aid) const;
+
+    // Add an entry to the display cache, costed by its poster
+    void insertEntry(int aid, Entry *entry) const;
+
+    MyListCardManager *m_manager;
+    QList<int> m_aids;
+    QHash<int, int> m_rowByAid;
+    mutable QCache<int, Entry> m_entries;  // Cost: KiB, at least 1 per entry
+};
+
+#endif // ANIMECARDMODEL_H
@@ -134,29 +134,6 @@ CompletionFilter::CompletionFilter(const QString& completionFilter)
 {
 }
 
-CompletionFilter::CompletionStatus CompletionFilter::getCompletionStatus(
-    int normalViewed, int normalEpisodes, int totalEpisodes) const
-{
-    // Not started: no episodes viewed
-    if (normalViewed == 0) {
-        return CompletionStatus::NotStarted;
-    }
-    
-    // Determine which total to use
-    // If anime has a known total (from AniDB), use that
-    // Otherwise, use the count of episodes in mylist
-    int effectiveTotal = (totalEpisodes > 0) ? totalEpisodes : normalEpisodes;
-    
-    // Completed: all episodes viewed
-    // Note: effectiveTotal > 0 check ensures we don't mark anime with no episodes as completed
-    if (normalViewed >= effectiveTotal && effectiveTotal > 0) {
-        return CompletionStatus::Completed;
-    }
-    
-    // Watching: some but not all viewed
-    return CompletionStatus::Watching;
-}
-
 bool CompletionFilter::matches(const AnimeDataAccessor& accessor) const
 {
     if (m_completionFilter.isEmpty()) {
@@ -215,7 +192,7 @@ bool UnwatchedFilter::matches(const AnimeDataAccessor& accessor) const
     int otherViewed = accessor.getOtherViewed();
     
     // Show only if there are unwatched episodes (normal or other)
-    return (normalEpisodes > normalViewed) || (otherEpisodes > otherViewed);
+    return hasUnwatchedEpisodes(normalEpisodes, normalViewed, otherEpisodes, otherViewed);
 }
 
 QString UnwatchedFilter::description() const
@@ -119,17 +119,36 @@ public:
     bool matches(const AnimeDataAccessor& accessor) const override;
     QString description() const override;
     
-private:
-    QString m_completionFilter;
-    
-    // Helper to determine completion status
     enum class CompletionStatus {
         NotStarted,
         Watching,
         Completed
     };
     
-    CompletionStatus getCompletionStatus(int normalViewed, int normalEpisodes, int totalEpisodes) const;
+    // Completion status classification (shared with AnimeFilterIndex)
+    static CompletionStatus getCompletionStatus(int normalViewed, int normalEpisodes, int totalEpisodes) {
+        // Not started: no episodes viewed
+        if (normalViewed == 0) {
+            return CompletionStatus::NotStarted;
+        }
+        
+        // Determine which total to use
+        // If anime has a known total (from AniDB), use that
+        // Otherwise, use the count of episodes in mylist
+        int effectiveTotal = (totalEpisodes > 0) ? totalEpisodes : normalEpisodes;
+        
+        // Completed: all episodes viewed
+        // Note: effectiveTotal > 0 check ensures we don't mark anime with no episodes as completed
+        if (normalViewed >= effectiveTotal && effectiveTotal > 0) {
+            return CompletionStatus::Completed;
+        }
+        
+        // Watching: some but not all viewed
+        return CompletionStatus::Watching;
+    }
+    
+private:
+    QString m_completionFilter;
 };
 
 /**
@@ -143,6 +162,11 @@ public:
     bool matches(const AnimeDataAccessor& accessor) const override;
     QString description() const override;
     
+    // True if there are unwatched episodes (normal or other)
+    static bool hasUnwatchedEpisodes(int normalEpisodes, int normalViewed, int otherEpisodes, int otherViewed) {
+        return (normalEpisodes > normalViewed) || (otherEpisodes > otherViewed);
+    }
+    
 private:
     bool m_enabled;
 };
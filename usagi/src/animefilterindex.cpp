@@ -0,0 +1,154 @@
+#include "animefilterindex.h"
+#include "animemetadatacache.h"
+
+// ---------------------------------------------------------------------------
+// Maintenance
+// ---------------------------------------------------------------------------
+
+void AnimeFilterIndex::update(int aid, const Entry &entry)
+{
+    if (aid <= 0) {
+        return;
+    }
+    const quint32 id = static_cast<quint32>(aid);
+
+    State state;
+    state.typeName = entry.typeName;
+    state.completion = CompletionFilter::getCompletionStatus(entry.normalViewed, entry.normalEpisodes, entry.totalEpisodes);
+    state.adult = entry.is18Restricted;
+    state.unwatched = UnwatchedFilter::hasUnwatchedEpisodes(entry.normalEpisodes, entry.normalViewed,
+                                                            entry.otherEpisodes, entry.otherViewed);
+
+    auto it = m_state.find(aid);
+    if (it != m_state.end()) {
+        removeFromBitmaps(aid, it.value());
+        it.value() = state;
+    } else {
+        m_state.insert(aid, state);
+    }
+
+    m_all.add(id);
+    m_byType[state.typeName].add(id);
+    m_completion[static_cast<int>(state.completion)].add(id);
+    if (state.adult) {
+        m_adult.add(id);
+    }
+    if (state.unwatched) {
+        m_unwatched.add(id);
+    }
+    m_titles.setTitles(aid, QStringList{entry.title});
+}
+
+void AnimeFilterIndex::remove(int aid)
+{
+    auto it = m_state.find(aid);
+    if (it == m_state.end()) {
+        return;
+    }
+    removeFromBitmaps(aid, it.value());
+    m_all.remove(static_cast<quint32>(aid));
+    m_titles.remove(aid);
+    m_state.erase(it);
+}
+
+void AnimeFilterIndex::clear()
+{
+    m_state.clear();
+    m_all.clear();
+    m_byType.clear();
+    for (RoaringBitmap &bitmap : m_completion) {
+        bitmap.clear();
+    }
+    m_adult.clear();
+    m_unwatched.clear();
+    m_titles.clear();
+}
+
+void AnimeFilterIndex::removeFromBitmaps(int aid, const State &state)
+{
+    const quint32 id = static_cast<quint32>(aid);
+    auto type = m_byType.find(state.typeName);
+    if (type != m_byType.end()) {
+        type->remove(id);
+        if (type->isEmpty()) {
+            m_byType.erase(type);
+        }
+    }
+    m_completion[static_cast<int>(state.completion)].remove(id);
+    m_adult.remove(id);
+    m_unwatched.remove(id);
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+const RoaringBitmap &AnimeFilterIndex::completionBitmap(CompletionFilter::CompletionStatus status) const
+{
+    return m_completion[static_cast<int>(status)];
+}
+
+RoaringBitmap AnimeFilterIndex::matching(const Criteria &criteria, const AnimeMetadataCache *alternativeTitles) const
+{
+    RoaringBitmap result = m_all;
+
+    if (!criteria.typeFilter.isEmpty()) {
+        result &= m_byType.value(criteria.typeFilter);
+    }
+
+    if (!criteria.completionFilter.isEmpty()) {
+        if (criteria.completionFilter == "completed") {
+            result &= m_completion[static_cast<int>(CompletionFilter::CompletionStatus::Completed)];
+        } else if (criteria.completionFilter == "watching") {
+            result &= m_completion[static_cast<int>(CompletionFilter::CompletionStatus::Watching)];
+        } else if (criteria.completionFilter == "notstarted") {
+            result &= m_completion[static_cast<int>(CompletionFilter::CompletionStatus::NotStarted)];
+        } else {
+            result.clear();  // Unknown value matches nothing (as CompletionFilter does)
+        }
+    }
+
+    if (criteria.showOnlyUnwatched) {
+        result &= m_unwatched;
+    }
+
+    if (criteria.adultContentFilter == "hide") {
+        result = result.andNot(m_adult);
+    } else if (criteria.adultContentFilter == "showonly") {
+        result &= m_adult;
+    }
+
+    // Search last: the cheaper bitmap filters above narrow the set it has to verify
+    if (!criteria.searchText.isEmpty() && !result.isEmpty()) {
+        RoaringBitmap found = m_titles.search(criteria.searchText, &result);
+        if (alternativeTitles) {
+            found |= alternativeTitles->findMatching(criteria.searchText, &result);
+        }
+        result = found;
+    }
+
+    return result;
+}
+
+QString AnimeFilterIndex::Criteria::description() const
+{
+    QStringList parts;
+    if (!searchText.isEmpty()) {
+        parts.append(QString("Search: \"%1\"").arg(searchText));
+    }
+    if (!typeFilter.isEmpty()) {
+        parts.append(QString("Type: %1").arg(typeFilter));
+    }
+    if (!completionFilter.isEmpty()) {
+        parts.append(QString("Completion: %1").arg(completionFilter));
+    }
+    if (showOnlyUnwatched) {
+        parts.append("Show only with unwatched episodes");
+    }
+    if (adultContentFilter == "hide") {
+        parts.append("Hide 18+ content");
+    } else if (adultContentFilter == "showonly") {
+        parts.append("Show only 18+ content");
+    }
+    return parts.isEmpty() ? QString("No filters active") : parts.join(" AND ");
+}
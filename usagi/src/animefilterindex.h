@@ -0,0 +1,103 @@
+#ifndef ANIMEFILTERINDEX_H
+#define ANIMEFILTERINDEX_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include "roaringbitmap.h"
+#include "titlesearchindex.h"
+#include "animefilter.h"
+
+class AnimeMetadataCache;
+
+/**
+ * @brief AnimeFilterIndex - Precomputed bitmap index for the mylist filters
+ *
+ * Keeps one RoaringBitmap of anime IDs per filterable attribute value:
+ *   - anime type (one bitmap per type name)
+ *   - completion status (not started / watching / completed, see CompletionFilter)
+ *   - 18+ restricted
+ *   - has unwatched episodes (see UnwatchedFilter)
+ * plus a trigram index over the display titles.
+ *
+ * Entries are updated one anime at a time as card data changes, so a filter
+ * change only costs bitmap intersections and a search index lookup instead of
+ * evaluating every AnimeFilter against every anime. Results are identical to
+ * CompositeFilter built from the same criteria.
+ *
+ * Usage:
+ *   AnimeFilterIndex index;
+ *   index.update(aid, entry);                // whenever cached anime data changes
+ *   AnimeFilterIndex::Criteria criteria;
+ *   criteria.typeFilter = "Movie";
+ *   criteria.adultContentFilter = "hide";
+ *   RoaringBitmap visible = index.matching(criteria, &alternativeTitles);
+ */
+class AnimeFilterIndex
+{
+public:
+    // Filterable data of one anime (same inputs as AnimeDataAccessor)
+    struct Entry {
+        QString title;
+        QString typeName;
+        bool is18Restricted = false;
+        int normalEpisodes = 0;
+        int normalViewed = 0;
+        int otherEpisodes = 0;
+        int otherViewed = 0;
+        int totalEpisodes = 0;      // eptotal, or mylist normal episode count if unknown
+    };
+
+    // Filter settings (same values as MyListFilterSidebar)
+    struct Criteria {
+        QString searchText;
+        QString typeFilter;
+        QString completionFilter;           // "", "completed", "watching", "notstarted"
+        bool showOnlyUnwatched = false;
+        QString adultContentFilter;         // "hide", "showonly", "ignore"
+
+        QString description() const;
+    };
+
+    AnimeFilterIndex() = default;
+
+    // ── Maintenance ──
+    void update(int aid, const Entry &entry);
+    void remove(int aid);
+    void clear();
+
+    bool contains(int aid) const { return m_state.contains(aid); }
+    int size() const { return m_state.size(); }
+
+    // ── Queries ──
+    const RoaringBitmap &all() const { return m_all; }
+    RoaringBitmap typeBitmap(const QString &typeName) const { return m_byType.value(typeName); }
+    const RoaringBitmap &completionBitmap(CompletionFilter::CompletionStatus status) const;
+    const RoaringBitmap &adultBitmap() const { return m_adult; }
+    const RoaringBitmap &unwatchedBitmap() const { return m_unwatched; }
+
+    // Anime matching all criteria. Search text is matched against the display title
+    // and, if given, the alternative titles in the metadata cache.
+    RoaringBitmap matching(const Criteria &criteria, const AnimeMetadataCache *alternativeTitles = nullptr) const;
+
+private:
+    // Classification currently recorded for an anime (to clear old bitmap bits on update)
+    struct State {
+        QString typeName;
+        CompletionFilter::CompletionStatus completion = CompletionFilter::CompletionStatus::NotStarted;
+        bool adult = false;
+        bool unwatched = false;
+    };
+
+    void removeFromBitmaps(int aid, const State &state);
+
+    QHash<int, State> m_state;
+    RoaringBitmap m_all;
+    QHash<QString, RoaringBitmap> m_byType;
+    RoaringBitmap m_completion[3];          // indexed by CompletionFilter::CompletionStatus
+    RoaringBitmap m_adult;
+    RoaringBitmap m_unwatched;
+    TitleSearchIndex m_titles;
+};
+
+#endif // ANIMEFILTERINDEX_H
@@ -11,6 +11,7 @@ void AnimeMetadataCache::addAnime(int aid, const QStringList& titles)
     }
     
     m_titleCache[aid] = titles;
+    m_searchIndex.setTitles(aid, titles);
 }
 
 QStringList AnimeMetadataCache::getTitles(int aid) const
@@ -20,35 +21,25 @@ QStringList AnimeMetadataCache::getTitles(int aid) const
 
 bool AnimeMetadataCache::matchesAnyTitle(int aid, const QString& searchText) const
 {
-    if (searchText.isEmpty()) {
-        return true; // Empty search matches everything
-    }
-    
-    QStringList titles = getTitles(aid);
-    if (titles.isEmpty()) {
-        return false;
-    }
-    
-    // Case-insensitive search
-    QString lowerSearch = searchText.toLower();
-    
-    for (const QString& title : titles) {
-        if (title.toLower().contains(lowerSearch)) {
-            return true;
-        }
-    }
-    
-    return false;
+    // Empty search matches everything; titles are stored lowercased in the index
+    return m_searchIndex.matches(aid, searchText);
+}
+
+RoaringBitmap AnimeMetadataCache::findMatching(const QString& searchText, const RoaringBitmap* within) const
+{
+    return m_searchIndex.search(searchText, within);
 }
 
 void AnimeMetadataCache::removeAnime(int aid)
 {
     m_titleCache.remove(aid);
+    m_searchIndex.remove(aid);
 }
 
 void AnimeMetadataCache::clear()
 {
     m_titleCache.clear();
+    m_searchIndex.clear();
 }
 
 bool AnimeMetadataCache::contains(int aid) const
@@ -65,3 +56,23 @@ QList<int> AnimeMetadataCache::animeIds() const
 {
     return m_titleCache.keys();
 }
+
+QDataStream& operator<<(QDataStream& out, const AnimeMetadataCache& cache)
+{
+    out << cache.m_titleCache;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, AnimeMetadataCache& cache)
+{
+    QMap<int, QStringList> titles;
+    in >> titles;
+    if (in.status() == QDataStream::Ok) {
+        cache.m_titleCache = titles;
+        cache.m_searchIndex.clear();
+        for (auto it = titles.cbegin(); it != titles.cend(); ++it) {
+            cache.m_searchIndex.setTitles(it.key(), it.value());
+        }
+    }
+    return in;
+}
@@ -4,13 +4,15 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QDataStream>
+#include "titlesearchindex.h"
 
 /**
  * @brief AnimeMetadataCache - Manages cached anime metadata for filtering and searching
  * 
  * This class replaces the AnimeAlternativeTitles struct with:
  * - Proper encapsulation of anime title data
- * - Efficient lookup and filtering capabilities
+ * - Efficient lookup and filtering capabilities (trigram index, see TitleSearchIndex)
  * - Support for multiple title types (romaji, english, alternative)
  * - Thread-safe caching operations
  * 
@@ -59,6 +61,14 @@ public:
      */
     bool matchesAnyTitle(int aid, const QString& searchText) const;
     
+    /**
+     * @brief Find all anime with a title matching search text
+     * @param searchText Text to search for (case-insensitive)
+     * @param within Optional set of anime IDs to restrict the search to
+     * @return Anime IDs for which matchesAnyTitle() is true
+     */
+    RoaringBitmap findMatching(const QString& searchText, const RoaringBitmap* within = nullptr) const;
+    
     /**
      * @brief Remove anime from cache
      * @param aid Anime ID
@@ -89,9 +99,18 @@ public:
      */
     QList<int> animeIds() const;
     
+    /**
+     * @brief Serialize/deserialize the cache (used by the startup card data snapshot)
+     */
+    friend QDataStream& operator<<(QDataStream& out, const AnimeMetadataCache& cache);
+    friend QDataStream& operator>>(QDataStream& in, AnimeMetadataCache& cache);
+    
 private:
     // Internal storage: aid -> list of all titles
     QMap<int, QStringList> m_titleCache;
+    
+    // Search index over m_titleCache, kept in sync by every mutator
+    TitleSearchIndex m_searchIndex;
 };
 
 #endif // ANIMEMETADATACACHE_H
@@ -0,0 +1,370 @@
+#include "animemetadatastore.h"
+#include <QDate>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Sort key computed once per anime before sorting. Ordering is lexicographic:
+// bucket (placement groups such as "hidden" or "no value"), value, tie, aid.
+struct SortKey {
+    quint8 bucket;
+    qint64 value;
+    quint32 tie;
+    int aid;
+
+    bool operator<(const SortKey &other) const {
+        if (bucket != other.bucket) return bucket < other.bucket;
+        if (value != other.value) return value < other.value;
+        if (tie != other.tie) return tie < other.tie;
+        return aid < other.aid;
+    }
+};
+
+// Buckets shared by all criteria
+constexpr quint8 BUCKET_VALUE = 0;
+constexpr quint8 BUCKET_NO_VALUE = 1;      // unknown date, never played, no air date
+constexpr quint8 BUCKET_NOT_YET_AIRED = 2;
+constexpr quint8 BUCKET_HIDDEN = 4;        // added on top: hidden anime keep their relative order below visible ones
+
+// Completion ratios are compared as fixed-point integers
+constexpr double COMPLETION_SCALE = 1e15;
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Row maintenance
+// ---------------------------------------------------------------------------
+
+void AnimeMetadataStore::upsert(const Row &row)
+{
+    int index = m_indexOf.value(row.aid, -1);
+    if (index < 0) {
+        index = size();
+        m_indexOf.insert(row.aid, index);
+        m_aid.push_back(row.aid);
+        m_typeCode.push_back(0);
+        m_startDate.push_back(0);
+        m_endDate.push_back(0);
+        m_rating.push_back(0);
+        m_eptotal.push_back(0);
+        m_normalEpisodes.push_back(0);
+        m_normalViewed.push_back(0);
+        m_otherEpisodes.push_back(0);
+        m_otherViewed.push_back(0);
+        m_lastPlayed.push_back(0);
+        m_recentAirDate.push_back(0);
+        m_flags.push_back(0);
+        m_title.push_back(QString());
+        m_titleRanksValid = false;
+    }
+
+    m_typeCode[index] = internType(row.typeName);
+    m_startDate[index] = parseDate(row.startDate);
+    m_endDate[index] = parseDate(row.endDate);
+    m_rating[index] = parseRating(row.rating);
+    m_eptotal[index] = row.eptotal;
+    m_normalEpisodes[index] = row.normalEpisodes;
+    m_normalViewed[index] = row.normalViewed;
+    m_otherEpisodes[index] = row.otherEpisodes;
+    m_otherViewed[index] = row.otherViewed;
+    m_lastPlayed[index] = row.lastPlayed;
+    m_recentAirDate[index] = row.recentEpisodeAirDate;
+    m_flags[index] = static_cast<quint8>((row.hidden ? FlagHidden : 0) | (row.adult ? FlagAdult : 0));
+
+    if (m_title[index] != row.title) {
+        m_title[index] = row.title;
+        m_titleRanksValid = false;
+    }
+}
+
+bool AnimeMetadataStore::remove(int aid)
+{
+    const int index = m_indexOf.value(aid, -1);
+    if (index < 0) {
+        return false;
+    }
+
+    // Keep the columns dense: move the last row into the freed slot
+    const int last = size() - 1;
+    if (index != last) {
+        m_aid[index] = m_aid[last];
+        m_typeCode[index] = m_typeCode[last];
+        m_startDate[index] = m_startDate[last];
+        m_endDate[index] = m_endDate[last];
+        m_rating[index] = m_rating[last];
+        m_eptotal[index] = m_eptotal[last];
+        m_normalEpisodes[index] = m_normalEpisodes[last];
+        m_normalViewed[index] = m_normalViewed[last];
+        m_otherEpisodes[index] = m_otherEpisodes[last];
+        m_otherViewed[index] = m_otherViewed[last];
+        m_lastPlayed[index] = m_lastPlayed[last];
+        m_recentAirDate[index] = m_recentAirDate[last];
+        m_flags[index] = m_flags[last];
+        m_title[index] = std::move(m_title[last]);
+        m_indexOf[m_aid[index]] = index;
+    }
+
+    m_aid.pop_back();
+    m_typeCode.pop_back();
+    m_startDate.pop_back();
+    m_endDate.pop_back();
+    m_rating.pop_back();
+    m_eptotal.pop_back();
+    m_normalEpisodes.pop_back();
+    m_normalViewed.pop_back();
+    m_otherEpisodes.pop_back();
+    m_otherViewed.pop_back();
+    m_lastPlayed.pop_back();
+    m_recentAirDate.pop_back();
+    m_flags.pop_back();
+    m_title.pop_back();
+    m_indexOf.remove(aid);
+    m_titleRanksValid = false;
+    return true;
+}
+
+void AnimeMetadataStore::clear()
+{
+    m_aid.clear();
+    m_typeCode.clear();
+    m_startDate.clear();
+    m_endDate.clear();
+    m_rating.clear();
+    m_eptotal.clear();
+    m_normalEpisodes.clear();
+    m_normalViewed.clear();
+    m_otherEpisodes.clear();
+    m_otherViewed.clear();
+    m_lastPlayed.clear();
+    m_recentAirDate.clear();
+    m_flags.clear();
+    m_title.clear();
+    m_indexOf.clear();
+    m_typeNames.clear();
+    m_typeCodeOf.clear();
+    m_titleRank.clear();
+    m_typeRank.clear();
+    m_titleRanksValid = true;
+    m_typeRanksValid = true;
+}
+
+void AnimeMetadataStore::setHidden(int aid, bool hidden)
+{
+    const int index = m_indexOf.value(aid, -1);
+    if (index < 0) {
+        return;
+    }
+    if (hidden) {
+        m_flags[index] |= FlagHidden;
+    } else {
+        m_flags[index] &= static_cast<quint8>(~FlagHidden);
+    }
+}
+
+quint16 AnimeMetadataStore::internType(const QString &typeName)
+{
+    auto it = m_typeCodeOf.constFind(typeName);
+    if (it != m_typeCodeOf.constEnd()) {
+        return static_cast<quint16>(it.value());
+    }
+    const int code = m_typeNames.size();
+    m_typeNames.append(typeName);
+    m_typeCodeOf.insert(typeName, code);
+    m_typeRanksValid = false;
+    return static_cast<quint16>(code);
+}
+
+// ---------------------------------------------------------------------------
+// Derived ranks
+// ---------------------------------------------------------------------------
+
+quint32 AnimeMetadataStore::titleRank(int index) const
+{
+    if (!m_titleRanksValid) {
+        rebuildTitleRanks();
+    }
+    return m_titleRank[index];
+}
+
+void AnimeMetadataStore::rebuildTitleRanks() const
+{
+    const int n = size();
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_title[a] < m_title[b];
+    });
+
+    // Equal titles share a rank so ties fall through to the next key
+    m_titleRank.assign(n, 0);
+    quint32 rank = 0;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0 && m_title[order[i]] != m_title[order[i - 1]]) {
+            rank = static_cast<quint32>(i);
+        }
+        m_titleRank[order[i]] = rank;
+    }
+    m_titleRanksValid = true;
+}
+
+void AnimeMetadataStore::rebuildTypeRanks() const
+{
+    const int n = m_typeNames.size();
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_typeNames[a] < m_typeNames[b];
+    });
+
+    m_typeRank.assign(n, 0);
+    for (int i = 0; i < n; ++i) {
+        m_typeRank[order[i]] = static_cast<quint16>(i);
+    }
+    m_typeRanksValid = true;
+}
+
+// ---------------------------------------------------------------------------
+// Sort kernels
+// ---------------------------------------------------------------------------
+
+QList<int> AnimeMetadataStore::sorted(const QList<int> &aids, AnimeChain::SortCriteria criteria,
+                                      bool ascending, qint64 now) const
+{
+    if (!m_titleRanksValid) {
+        rebuildTitleRanks();
+    }
+    if (!m_typeRanksValid) {
+        rebuildTypeRanks();
+    }
+
+    const qint64 direction = ascending ? 1 : -1;
+
+    std::vector<SortKey> keys;
+    keys.reserve(aids.size());
+    QList<int> unknown;
+
+    for (int aid : aids) {
+        const int i = m_indexOf.value(aid, -1);
+        if (i < 0) {
+            unknown.append(aid);
+            continue;
+        }
+
+        SortKey key{BUCKET_VALUE, 0, m_titleRank[i], aid};
+
+        switch (criteria) {
+            case AnimeChain::SortCriteria::ByRepresentativeTitle:
+                key.value = direction * m_titleRank[i];
+                key.tie = 0;
+                break;
+            case AnimeChain::SortCriteria::ByRepresentativeType:
+                key.value = direction * m_typeRank[m_typeCode[i]];
+                break;
+            case AnimeChain::SortCriteria::ByRepresentativeDate:
+                if (m_startDate[i] == 0) {
+                    key.bucket = BUCKET_NO_VALUE;
+                } else {
+                    // Start date first, end date second (unknown end date sorts first)
+                    key.value = direction * (qint64(m_startDate[i]) * 100000000LL + m_endDate[i]);
+                }
+                break;
+            case AnimeChain::SortCriteria::ByRepresentativeEpisodeCount:
+                key.value = direction * (qint64(m_normalEpisodes[i]) + m_otherEpisodes[i]);
+                break;
+            case AnimeChain::SortCriteria::ByRepresentativeCompletion: {
+                const qint64 total = qint64(m_normalEpisodes[i]) + m_otherEpisodes[i];
+                const qint64 viewed = qint64(m_normalViewed[i]) + m_otherViewed[i];
+                const double completion = (total > 0) ? static_cast<double>(viewed) / total : 0.0;
+                key.value = direction * qRound64(completion * COMPLETION_SCALE);
+                break;
+            }
+            case AnimeChain::SortCriteria::ByRepresentativeLastPlayed:
+                if (m_lastPlayed[i] == 0) {
+                    key.bucket = BUCKET_NO_VALUE;
+                } else {
+                    key.value = direction * m_lastPlayed[i];
+                }
+                break;
+            case AnimeChain::SortCriteria::ByRecentEpisodeAirDate:
+                if (m_recentAirDate[i] == 0) {
+                    key.bucket = BUCKET_NO_VALUE;
+                } else {
+                    key.bucket = (m_recentAirDate[i] > now) ? BUCKET_NOT_YET_AIRED : BUCKET_VALUE;
+                    key.value = direction * m_recentAirDate[i];
+                }
+                break;
+            case AnimeChain::SortCriteria::ByRepresentativeId:
+                key.value = direction * aid;
+                break;
+            case AnimeChain::SortCriteria::ByChainLength:
+                // Every anime is its own chain of length 1: title order
+                break;
+        }
+
+        // Hidden cards always go to the bottom
+        if (m_flags[i] & FlagHidden) {
+            key.bucket += BUCKET_HIDDEN;
+        }
+
+        keys.push_back(key);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    QList<int> result;
+    result.reserve(aids.size());
+    for (const SortKey &key : keys) {
+        result.append(key.aid);
+    }
+    result.append(unknown);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Parsers
+// ---------------------------------------------------------------------------
+
+qint32 AnimeMetadataStore::parseDate(const QString &date)
+{
+    // "YYYY-MM-DD" with optional trailing "Z" (same input as aired::parseDate)
+    const int length = date.endsWith(QLatin1Char('Z')) ? date.size() - 1 : date.size();
+    if (length != 10 || date.at(4) != QLatin1Char('-') || date.at(7) != QLatin1Char('-')) {
+        return 0;
+    }
+
+    auto digits = [&date](int from, int count, int &out) {
+        out = 0;
+        for (int k = from; k < from + count; ++k) {
+            const QChar c = date.at(k);
+            if (c < QLatin1Char('0') || c > QLatin1Char('9')) {
+                return false;
+            }
+            out = out * 10 + (c.unicode() - '0');
+        }
+        return true;
+    };
+
+    int year = 0, month = 0, day = 0;
+    if (!digits(0, 4, year) || !digits(5, 2, month) || !digits(8, 2, day)) {
+        return 0;
+    }
+    if (!QDate::isValid(year, month, day)) {
+        return 0;
+    }
+    return year * 10000 + month * 100 + day;
+}
+
+qint32 AnimeMetadataStore::parseRating(const QString &rating)
+{
+    if (rating.isEmpty()) {
+        return 0;
+    }
+    bool ok = false;
+    if (rating.contains(QLatin1Char('.'))) {
+        const double value = rating.toDouble(&ok);
+        return ok ? static_cast<qint32>(qRound(value * 100)) : 0;
+    }
+    const int value = rating.toInt(&ok);
+    return ok ? value : 0;
+}
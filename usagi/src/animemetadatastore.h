@@ -0,0 +1,155 @@
+#ifndef ANIMEMETADATASTORE_H
+#define ANIMEMETADATASTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QDateTime>
+#include <vector>
+#include "animechain.h"
+
+/**
+ * @brief AnimeMetadataStore - Columnar (struct-of-arrays) store of the anime fields used by sorting and filtering
+ *
+ * MyListCardManager::CardCreationData keeps everything needed to build a card
+ * (strings, episodes, poster bytes) in a QMap keyed by aid. Sorting and filtering
+ * only need a handful of scalar fields, so this class mirrors those fields into
+ * dense, contiguous columns indexed by a row number:
+ *   - aid                      -> row index via a hash (rows are kept dense; removal swaps with the last row)
+ *   - type                     -> dictionary-encoded type name (rank follows the type name's string order)
+ *   - start/end date           -> yyyymmdd integers (0 = unknown)
+ *   - rating                   -> fixed-point, rating * 100
+ *   - episode counts, eptotal  -> ints
+ *   - last played, air date    -> qint64 seconds since epoch
+ *   - hidden / 18+             -> flag bytes
+ *   - title                    -> display title plus a cached rank in title order
+ *
+ * Sort kernels first compute a fixed-size key per row in one linear pass over
+ * the columns and then sort the keys with integer-only comparisons. Title ordering
+ * is resolved once into a rank column and reused until a title changes.
+ *
+ * Follows SOLID principles:
+ * - Single Responsibility: Scalar anime metadata for sort/filter kernels only
+ * - Encapsulation: Columns are read-only from outside; rows change via upsert/remove
+ *
+ * Usage:
+ *   AnimeMetadataStore store;
+ *   AnimeMetadataStore::Row row;
+ *   row.aid = 1; row.title = "Cowboy Bebop"; row.typeName = "TV Series";
+ *   store.upsert(row);
+ *   QList<int> ordered = store.sorted(aids, AnimeChain::SortCriteria::ByRepresentativeTitle, true);
+ */
+class AnimeMetadataStore
+{
+public:
+    // Flag bits of the flags column
+    enum Flag : quint8 {
+        FlagHidden = 0x01,
+        FlagAdult = 0x02
+    };
+
+    // Input record for upsert()
+    struct Row {
+        int aid = 0;
+        QString title;                  // Display title (romaji > english > main title)
+        QString typeName;
+        QString startDate;              // AniDB format "YYYY-MM-DDZ"
+        QString endDate;
+        QString rating;                 // "8.53" or AniDB integer form "853"
+        int eptotal = 0;
+        int normalEpisodes = 0;
+        int normalViewed = 0;
+        int otherEpisodes = 0;
+        int otherViewed = 0;
+        qint64 lastPlayed = 0;
+        qint64 recentEpisodeAirDate = 0;
+        bool hidden = false;
+        bool adult = false;
+    };
+
+    AnimeMetadataStore() = default;
+
+    // ── Row maintenance ──
+    void upsert(const Row &row);
+    bool remove(int aid);
+    void clear();
+    void setHidden(int aid, bool hidden);
+
+    int size() const { return static_cast<int>(m_aid.size()); }
+    bool contains(int aid) const { return m_indexOf.contains(aid); }
+    int indexOf(int aid) const { return m_indexOf.value(aid, -1); }
+    int aidAt(int index) const { return m_aid[index]; }
+
+    // ── Columns (indexed by row) ──
+    const std::vector<int> &aids() const { return m_aid; }
+    const std::vector<quint16> &typeCodes() const { return m_typeCode; }
+    const std::vector<qint32> &startDates() const { return m_startDate; }
+    const std::vector<qint32> &endDates() const { return m_endDate; }
+    const std::vector<qint32> &ratings() const { return m_rating; }
+    const std::vector<qint32> &episodeTotals() const { return m_eptotal; }
+    const std::vector<qint32> &normalEpisodes() const { return m_normalEpisodes; }
+    const std::vector<qint32> &normalViewed() const { return m_normalViewed; }
+    const std::vector<qint32> &otherEpisodes() const { return m_otherEpisodes; }
+    const std::vector<qint32> &otherViewed() const { return m_otherViewed; }
+    const std::vector<qint64> &lastPlayed() const { return m_lastPlayed; }
+    const std::vector<qint64> &recentEpisodeAirDates() const { return m_recentAirDate; }
+    const std::vector<quint8> &flags() const { return m_flags; }
+
+    bool isHidden(int index) const { return m_flags[index] & FlagHidden; }
+    bool isAdult(int index) const { return m_flags[index] & FlagAdult; }
+
+    // Type dictionary: code <-> type name (typeCodeFor() returns -1 for unknown names)
+    QString typeName(quint16 code) const { return m_typeNames.value(code); }
+    int typeCodeFor(const QString &typeName) const { return m_typeCodeOf.value(typeName, -1); }
+
+    // Title rank of a row (0 = first in title order)
+    quint32 titleRank(int index) const;
+
+    // ── Sort kernels ──
+
+    // Sort the given anime IDs with the flat (non-chain) mylist semantics:
+    // hidden anime last, anime without a value for the criterion after those with one,
+    // ties broken by title. Unknown aids are appended in their input order.
+    QList<int> sorted(const QList<int> &aids, AnimeChain::SortCriteria criteria, bool ascending,
+                      qint64 now = QDateTime::currentSecsSinceEpoch()) const;
+
+    // ── Parsers (exposed for tests) ──
+    static qint32 parseDate(const QString &date);
+    static qint32 parseRating(const QString &rating);
+
+private:
+    quint16 internType(const QString &typeName);
+    void rebuildTitleRanks() const;
+    void rebuildTypeRanks() const;
+
+    // Row columns
+    std::vector<int> m_aid;
+    std::vector<quint16> m_typeCode;
+    std::vector<qint32> m_startDate;
+    std::vector<qint32> m_endDate;
+    std::vector<qint32> m_rating;
+    std::vector<qint32> m_eptotal;
+    std::vector<qint32> m_normalEpisodes;
+    std::vector<qint32> m_normalViewed;
+    std::vector<qint32> m_otherEpisodes;
+    std::vector<qint32> m_otherViewed;
+    std::vector<qint64> m_lastPlayed;
+    std::vector<qint64> m_recentAirDate;
+    std::vector<quint8> m_flags;
+    std::vector<QString> m_title;
+
+    QHash<int, int> m_indexOf;              // aid -> row
+
+    // Type dictionary
+    QStringList m_typeNames;
+    QHash<QString, int> m_typeCodeOf;
+
+    // Derived ranks, rebuilt lazily after titles or type names change
+    mutable std::vector<quint32> m_titleRank;
+    mutable std::vector<quint16> m_typeRank;  // indexed by type code
+    mutable bool m_titleRanksValid = true;
+    mutable bool m_typeRanksValid = true;
+};
+
+#endif // ANIMEMETADATASTORE_H
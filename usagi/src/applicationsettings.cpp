@@ -44,6 +44,12 @@ void ApplicationSettings::load()
         else if (name == "watcherAutoStart") {
             m_watcher.autoStart = (value == "1");
         }
+        else if (name == "watcherStabilityDelay") {
+            m_watcher.stabilityDelaySecs = value.toInt();
+        }
+        else if (name == "watcherRoots") {
+            m_watcher.roots = value;
+        }
         // Auto-fetch
         else if (name == "autoFetchEnabled") {
             m_autoFetchEnabled = (value == "1");
@@ -69,6 +75,9 @@ void ApplicationSettings::load()
         else if (name == "lastDirectory") {
             m_ui.lastDirectory = value;
         }
+        else if (name == "paintedCardGrid") {
+            m_ui.paintedCardGrid = (value == "1");
+        }
         // File preferences
         else if (name == "preferredAudioLanguages") {
             m_filePrefs.preferredAudioLanguages = value;
@@ -113,6 +122,8 @@ void ApplicationSettings::save()
     saveSetting("watcherEnabled", m_watcher.enabled ? "1" : "0");
     saveSetting("watcherDirectory", m_watcher.directory);
     saveSetting("watcherAutoStart", m_watcher.autoStart ? "1" : "0");
+    saveSetting("watcherStabilityDelay", QString::number(m_watcher.stabilityDelaySecs));
+    saveSetting("watcherRoots", m_watcher.roots);
     
     // Auto-fetch
     saveSetting("autoFetchEnabled", m_autoFetchEnabled ? "1" : "0");
@@ -128,6 +139,7 @@ void ApplicationSettings::save()
     // UI
     saveSetting("filterBarVisible", m_ui.filterBarVisible ? "1" : "0");
     saveSetting("lastDirectory", m_ui.lastDirectory);
+    saveSetting("paintedCardGrid", m_ui.paintedCardGrid ? "1" : "0");
     
     // File preferences
     saveSetting("preferredAudioLanguages", m_filePrefs.preferredAudioLanguages);
@@ -192,6 +204,18 @@ void ApplicationSettings::setWatcherAutoStart(bool autoStart)
     saveSetting("watcherAutoStart", autoStart ? "1" : "0");
 }
 
+void ApplicationSettings::setWatcherStabilityDelay(int seconds)
+{
+    m_watcher.stabilityDelaySecs = seconds;
+    saveSetting("watcherStabilityDelay", QString::number(seconds));
+}
+
+void ApplicationSettings::setWatcherRoots(const QString& roots)
+{
+    m_watcher.roots = roots;
+    saveSetting("watcherRoots", roots);
+}
+
 void ApplicationSettings::setAutoFetchEnabled(bool enabled)
 {
     m_autoFetchEnabled = enabled;
@@ -234,6 +258,12 @@ void ApplicationSettings::setLastDirectory(const QString& directory)
     saveSetting("lastDirectory", directory);
 }
 
+void ApplicationSettings::setPaintedCardGrid(bool enabled)
+{
+    m_ui.paintedCardGrid = enabled;
+    saveSetting("paintedCardGrid", enabled ? "1" : "0");
+}
+
 void ApplicationSettings::setPreferredAudioLanguages(const QString& languages)
 {
     m_filePrefs.preferredAudioLanguages = languages;
@@ -40,8 +40,10 @@ public:
         bool enabled;
         QString directory;
         bool autoStart;
+        int stabilityDelaySecs;  // Quiet period before a new file is hashed
+        QString roots;           // Watched roots as JSON (see WatchRoot); supersedes directory and stabilityDelaySecs
         
-        WatcherSettings() : enabled(false), autoStart(false) {}
+        WatcherSettings() : enabled(false), autoStart(false), stabilityDelaySecs(10) {}
     };
     
     /**
@@ -88,8 +90,9 @@ public:
     struct UISettings {
         bool filterBarVisible;
         QString lastDirectory;
+        bool paintedCardGrid;  // Mylist cards painted by a delegate instead of one widget each
         
-        UISettings() : filterBarVisible(true) {}
+        UISettings() : filterBarVisible(true), paintedCardGrid(false) {}
     };
     
     /**
@@ -146,6 +149,12 @@ public:
     bool getWatcherAutoStart() const { return m_watcher.autoStart; }
     void setWatcherAutoStart(bool autoStart);
     
+    int getWatcherStabilityDelay() const { return m_watcher.stabilityDelaySecs; }
+    void setWatcherStabilityDelay(int seconds);
+    
+    QString getWatcherRoots() const { return m_watcher.roots; }
+    void setWatcherRoots(const QString& roots);
+    
     // === Auto-fetch ===
     
     bool getAutoFetchEnabled() const { return m_autoFetchEnabled; }
@@ -181,6 +190,9 @@ public:
     QString getLastDirectory() const { return m_ui.lastDirectory; }
     void setLastDirectory(const QString& directory);
     
+    bool getPaintedCardGrid() const { return m_ui.paintedCardGrid; }
+    void setPaintedCardGrid(bool enabled);
+    
     // === File Preferences ===
     
     const FilePreferences& filePreferences() const { return m_filePrefs; }
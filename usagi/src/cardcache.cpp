@@ -0,0 +1,117 @@
+#include "cardcache.h"
+
+double CardCache::Stats::hitRate() const
+{
+    const quint64 lookups = hits + misses;
+    return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+}
+
+void CardCache::setBudget(int maxCards, qint64 maxBytes)
+{
+    m_maxCards = qMax(0, maxCards);
+    m_maxBytes = qMax<qint64>(0, maxBytes);
+}
+
+bool CardCache::touch(int aid)
+{
+    auto it = m_entries.find(aid);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    m_order.splice(m_order.begin(), m_order, it->position);
+    return true;
+}
+
+void CardCache::insert(int aid, qint64 bytes)
+{
+    remove(aid);
+    m_order.push_front(aid);
+    Entry entry;
+    entry.position = m_order.begin();
+    entry.bytes = qMax<qint64>(0, bytes);
+    m_entries.insert(aid, entry);
+    m_bytes += entry.bytes;
+}
+
+void CardCache::updateSize(int aid, qint64 bytes)
+{
+    auto it = m_entries.find(aid);
+    if (it == m_entries.end()) {
+        return;
+    }
+    bytes = qMax<qint64>(0, bytes);
+    m_bytes += bytes - it->bytes;
+    it->bytes = bytes;
+}
+
+void CardCache::remove(int aid)
+{
+    auto it = m_entries.find(aid);
+    if (it == m_entries.end()) {
+        return;
+    }
+    m_bytes -= it->bytes;
+    m_order.erase(it->position);
+    m_entries.erase(it);
+}
+
+void CardCache::clear()
+{
+    m_order.clear();
+    m_entries.clear();
+    m_bytes = 0;
+}
+
+bool CardCache::isOverBudget() const
+{
+    return (m_maxCards > 0 && size() > m_maxCards)
+        || (m_maxBytes > 0 && m_bytes > m_maxBytes);
+}
+
+QList<int> CardCache::evict(const QSet<int> &pinned)
+{
+    QList<int> evicted;
+    auto it = m_order.end();
+    while (isOverBudget() && it != m_order.begin()) {
+        --it;
+        const int aid = *it;
+        if (pinned.contains(aid)) {
+            continue;
+        }
+        // Continue from the position after the erased entry; the loop steps back from it
+        auto next = it;
+        ++next;
+        remove(aid);
+        it = next;
+        evicted.append(aid);
+    }
+    m_evictions += static_cast<quint64>(evicted.size());
+    return evicted;
+}
+
+int CardCache::takeForRebind(const QSet<int> &pinned)
+{
+    for (auto it = m_order.crbegin(); it != m_order.crend(); ++it) {
+        const int aid = *it;
+        if (!pinned.contains(aid)) {
+            remove(aid);
+            ++m_rebinds;
+            return aid;
+        }
+    }
+    return -1;
+}
+
+CardCache::Stats CardCache::stats() const
+{
+    Stats result;
+    result.hits = m_hits;
+    result.misses = m_misses;
+    result.evictions = m_evictions;
+    result.rebinds = m_rebinds;
+    result.residentCards = size();
+    result.residentBytes = m_bytes;
+    return result;
+}
@@ -0,0 +1,86 @@
+#ifndef CARDCACHE_H
+#define CARDCACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <list>
+
+/**
+ * @brief LRU bookkeeping for the anime card widgets MyListCardManager keeps alive.
+ *
+ * With virtual scrolling a card is only needed while it is on screen, but
+ * rebuilding one costs a poster decode and an episode tree, so cards that
+ * scrolled away are kept for a while. The cache holds no widgets, only the
+ * anime ID, an estimated size and the order of use:
+ *   - touch() on every lookup counts a hit or a miss and makes the entry the
+ *     most recently used one.
+ *   - evict() names the least recently used entries to delete until the cache
+ *     is within both budgets (count and bytes; 0 disables a budget). Pinned
+ *     entries, the cards on screen, are never named, so the cache may stay
+ *     above budget while more cards are visible than the budget allows.
+ *   - takeForRebind() names the off-screen card to rebind once the card pool
+ *     is full, so scrolling reuses widgets instead of constructing them.
+ */
+class CardCache
+{
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        quint64 rebinds = 0;
+        int residentCards = 0;
+        qint64 residentBytes = 0;
+
+        /// Share of lookups that found a resident card, 0.0 without lookups.
+        double hitRate() const;
+    };
+
+    static constexpr int DEFAULT_MAX_CARDS = 200;
+    static constexpr qint64 DEFAULT_MAX_BYTES = 256LL * 1024 * 1024;
+
+    void setBudget(int maxCards, qint64 maxBytes);
+    int maxCards() const { return m_maxCards; }
+    qint64 maxBytes() const { return m_maxBytes; }
+
+    /// Record a lookup of @p aid; returns whether it is resident.
+    bool touch(int aid);
+    /// Add (or re-add) @p aid as the most recently used entry.
+    void insert(int aid, qint64 bytes);
+    void updateSize(int aid, qint64 bytes);
+    void remove(int aid);
+    /// Forget all entries; the statistics are kept.
+    void clear();
+
+    bool contains(int aid) const { return m_entries.contains(aid); }
+    int size() const { return static_cast<int>(m_entries.size()); }
+    qint64 bytes() const { return m_bytes; }
+    bool isOverBudget() const;
+
+    /// Entries removed to get within budget, least recently used first.
+    QList<int> evict(const QSet<int> &pinned);
+    /// Remove the least recently used unpinned entry, whose card is then bound to
+    /// another anime; -1 if every entry is pinned.
+    int takeForRebind(const QSet<int> &pinned);
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::list<int>::iterator position;  ///< In m_order
+        qint64 bytes = 0;
+    };
+
+    std::list<int> m_order;  ///< Most recently used first
+    QHash<int, Entry> m_entries;
+    qint64 m_bytes = 0;
+    int m_maxCards = DEFAULT_MAX_CARDS;
+    qint64 m_maxBytes = DEFAULT_MAX_BYTES;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+    quint64 m_evictions = 0;
+    quint64 m_rebinds = 0;
+};
+
+#endif // CARDCACHE_H
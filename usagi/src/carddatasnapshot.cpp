@@ -0,0 +1,334 @@
+#include "carddatasnapshot.h"
+#include "logger.h"
+#include <QSaveFile>
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace {
+
+// Tables read by MyListCardManager::preloadCardCreationData() and the title index,
+// with the SQL that maps a changed row (%1 = NEW/OLD) to the affected anime IDs.
+struct TrackedTable {
+    const char *table;
+    const char *aidSource;
+    const char *condition;  // optional WHEN clause
+};
+
+const TrackedTable kTrackedTables[] = {
+    { "anime",            "SELECT %1.aid AS aid WHERE %1.aid > 0", nullptr },
+    { "mylist",           "SELECT %1.aid AS aid WHERE %1.aid > 0", nullptr },
+    { "file",             "SELECT %1.aid AS aid WHERE %1.aid > 0", nullptr },
+    // anime_titles is bulk-imported from the AniDB dump; only titles of mylist anime matter here
+    { "anime_titles",     "SELECT %1.aid AS aid WHERE %1.aid > 0", "%1.aid IN (SELECT aid FROM mylist)" },
+    { "episode",          "SELECT DISTINCT aid FROM mylist WHERE eid = %1.eid", nullptr },
+    { "watched_episodes", "SELECT DISTINCT aid FROM mylist WHERE eid = %1.eid", nullptr },
+    { "local_files",      "SELECT DISTINCT aid FROM mylist WHERE local_file = %1.id", nullptr },
+    { "group",            "SELECT DISTINCT aid FROM mylist WHERE gid = %1.gid", nullptr },
+};
+
+} // namespace
+
+CardDataSnapshot::CardDataSnapshot(const QString &path)
+    : m_path(path)
+    , m_mapped(nullptr)
+    , m_generation(-1)
+    , m_createdAt(0)
+    , m_payloadSize(0)
+    , m_streamVersion(STREAM_VERSION)
+{
+}
+
+CardDataSnapshot::~CardDataSnapshot()
+{
+    close();
+}
+
+// ---------------------------------------------------------------------------
+// File access
+// ---------------------------------------------------------------------------
+
+bool CardDataSnapshot::write(const QByteArray &payload, qint64 generation)
+{
+    if (m_path.isEmpty()) {
+        m_error = "no snapshot path";
+        return false;
+    }
+
+    // A mapped file cannot be replaced on all platforms
+    close();
+
+    QByteArray header;
+    header.reserve(HEADER_SIZE);
+    {
+        QDataStream out(&header, QIODevice::WriteOnly);
+        out << MAGIC
+            << FORMAT_VERSION
+            << qint32(STREAM_VERSION)
+            << quint32(0)
+            << qint64(generation)
+            << qint64(QDateTime::currentSecsSinceEpoch())
+            << qint64(payload.size())
+            << quint32(qChecksum(payload))
+            << quint32(0);
+    }
+    Q_ASSERT(header.size() == HEADER_SIZE);
+
+    // QSaveFile writes to a temporary file and renames on commit, so a crash
+    // mid-write never leaves a truncated snapshot behind
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+    if (file.write(header) != header.size() || file.write(payload) != payload.size()) {
+        m_error = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        m_error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CardDataSnapshot::open()
+{
+    close();
+    m_error.clear();
+
+    if (m_path.isEmpty()) {
+        m_error = "no snapshot path";
+        return false;
+    }
+
+    m_file.setFileName(m_path);
+    if (!m_file.exists()) {
+        m_error = "snapshot file does not exist";
+        return false;
+    }
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize < HEADER_SIZE) {
+        m_error = "snapshot file truncated";
+        close();
+        return false;
+    }
+
+    m_mapped = m_file.map(0, fileSize);
+    if (!m_mapped) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    qint32 streamVersion = 0;
+    quint32 reserved = 0;
+    qint64 generation = -1;
+    qint64 createdAt = 0;
+    qint64 payloadSize = -1;
+    quint32 checksum = 0;
+    {
+        const QByteArray header = QByteArray::fromRawData(reinterpret_cast<const char*>(m_mapped), HEADER_SIZE);
+        QDataStream in(header);
+        in >> magic >> formatVersion >> streamVersion >> reserved
+           >> generation >> createdAt >> payloadSize >> checksum;
+    }
+
+    if (magic != MAGIC) {
+        m_error = "bad magic";
+    } else if (formatVersion != FORMAT_VERSION) {
+        m_error = QString("unsupported format version %1").arg(formatVersion);
+    } else if (streamVersion > QDataStream::Qt_DefaultCompiledVersion) {
+        m_error = QString("unsupported stream version %1").arg(streamVersion);
+    } else if (payloadSize != fileSize - HEADER_SIZE) {
+        m_error = QString("payload size mismatch (%1 vs %2)").arg(payloadSize).arg(fileSize - HEADER_SIZE);
+    } else if (checksum != qChecksum(QByteArrayView(m_mapped + HEADER_SIZE, payloadSize))) {
+        m_error = "checksum mismatch";
+    }
+    if (!m_error.isEmpty()) {
+        close();
+        return false;
+    }
+
+    m_generation = generation;
+    m_createdAt = createdAt;
+    m_payloadSize = payloadSize;
+    m_streamVersion = streamVersion;
+    return true;
+}
+
+void CardDataSnapshot::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_payloadSize = 0;
+}
+
+bool CardDataSnapshot::remove()
+{
+    close();
+    return QFile::remove(m_path);
+}
+
+QByteArray CardDataSnapshot::payload() const
+{
+    if (!m_mapped) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_mapped) + HEADER_SIZE, m_payloadSize);
+}
+
+QString CardDataSnapshot::defaultPath()
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    QString dbName = db.databaseName();
+    if (dbName.isEmpty() || dbName == ":memory:") {
+        return QString();
+    }
+    return dbName + ".cardsnap";
+}
+
+// ---------------------------------------------------------------------------
+// Database change tracking
+// ---------------------------------------------------------------------------
+
+bool CardDataSnapshot::ensureChangeTracking()
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen()) {
+        LOG("CardDataSnapshot: database not open");
+        return false;
+    }
+    QSqlQuery q(db);
+
+    bool ok = q.exec("CREATE TABLE IF NOT EXISTS card_cache_state ("
+                     "id INTEGER PRIMARY KEY CHECK (id = 1),"
+                     "generation INTEGER NOT NULL DEFAULT 0,"
+                     "snapshot_generation INTEGER NOT NULL DEFAULT -1"
+                     ")");
+    ok = ok && q.exec("INSERT OR IGNORE INTO card_cache_state (id, generation, snapshot_generation) VALUES (1, 0, -1)");
+    ok = ok && q.exec("CREATE TABLE IF NOT EXISTS card_cache_dirty ("
+                      "aid INTEGER PRIMARY KEY,"
+                      "generation INTEGER NOT NULL"
+                      ")");
+    if (!ok) {
+        LOG(QString("CardDataSnapshot: failed to create tracking tables: %1").arg(q.lastError().text()));
+        return false;
+    }
+
+    // The local_files triggers look up mylist by local_file on every write to local_files;
+    // without an index each hashed or scanned file would scan the whole mylist
+    if (!q.exec("CREATE INDEX IF NOT EXISTS idx_mylist_local_file ON mylist(local_file)")) {
+        LOG(QString("CardDataSnapshot: failed to create mylist(local_file) index: %1").arg(q.lastError().text()));
+        return false;
+    }
+
+    static const char *const kOperations[] = { "INSERT", "UPDATE", "DELETE" };
+    for (const TrackedTable &tracked : kTrackedTables) {
+        for (const char *operation : kOperations) {
+            const QString op = QString::fromLatin1(operation);
+            const QString row = (op == "DELETE") ? "OLD" : "NEW";
+            const QString table = QString::fromLatin1(tracked.table);
+            const QString name = QString("card_cache_%1_%2").arg(table, op.toLower());
+            const QString when = tracked.condition
+                ? QString(" WHEN ") + QString::fromLatin1(tracked.condition).arg(row)
+                : QString();
+
+            const QString sql = QString(
+                "CREATE TRIGGER IF NOT EXISTS %1 AFTER %2 ON `%3` FOR EACH ROW%4 BEGIN "
+                "UPDATE card_cache_state SET generation = generation + 1 WHERE id = 1; "
+                "INSERT OR REPLACE INTO card_cache_dirty (aid, generation) "
+                "SELECT src.aid, (SELECT generation FROM card_cache_state WHERE id = 1) "
+                "FROM (%5) AS src; "
+                "END")
+                .arg(name, op, table, when,
+                     QString::fromLatin1(tracked.aidSource).arg(row));
+
+            if (!q.exec(sql)) {
+                LOG(QString("CardDataSnapshot: failed to create trigger %1: %2").arg(name, q.lastError().text()));
+                ok = false;
+            }
+        }
+    }
+
+    LOG("CardDataSnapshot: change tracking ensured");
+    return ok;
+}
+
+qint64 CardDataSnapshot::currentGeneration()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    if (q.exec("SELECT generation FROM card_cache_state WHERE id = 1") && q.next()) {
+        return q.value(0).toLongLong();
+    }
+    return -1;
+}
+
+qint64 CardDataSnapshot::snapshotGeneration()
+{
+    QSqlQuery q(QSqlDatabase::database());
+    if (q.exec("SELECT snapshot_generation FROM card_cache_state WHERE id = 1") && q.next()) {
+        return q.value(0).toLongLong();
+    }
+    return -1;
+}
+
+bool CardDataSnapshot::isCurrent(qint64 snapshotGeneration)
+{
+    if (snapshotGeneration < 0) {
+        return false;
+    }
+    return snapshotGeneration == CardDataSnapshot::snapshotGeneration()
+        && snapshotGeneration <= currentGeneration();
+}
+
+QList<int> CardDataSnapshot::dirtyAnimeIds()
+{
+    QList<int> aids;
+    QSqlQuery q(QSqlDatabase::database());
+    if (q.exec("SELECT aid FROM card_cache_dirty ORDER BY aid")) {
+        while (q.next()) {
+            aids.append(q.value(0).toInt());
+        }
+    }
+    return aids;
+}
+
+bool CardDataSnapshot::markSnapshotWritten(qint64 generation, qint64 coveredGeneration)
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen()) {
+        return false;
+    }
+    QSqlQuery q(db);
+
+    db.transaction();
+    q.prepare("DELETE FROM card_cache_dirty WHERE generation <= ?");
+    q.addBindValue(qMin(generation, coveredGeneration));
+    bool ok = q.exec();
+    if (ok) {
+        q.prepare("UPDATE card_cache_state SET snapshot_generation = ? WHERE id = 1");
+        q.addBindValue(generation);
+        ok = q.exec();
+    }
+    if (!ok) {
+        LOG(QString("CardDataSnapshot: failed to record snapshot generation: %1").arg(q.lastError().text()));
+        db.rollback();
+        return false;
+    }
+    return db.commit();
+}
@@ -0,0 +1,115 @@
+#ifndef CARDDATASNAPSHOT_H
+#define CARDDATASNAPSHOT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QDataStream>
+
+/**
+ * @brief CardDataSnapshot - Binary on-disk snapshot of the mylist card data
+ *
+ * Startup normally rebuilds the card creation cache, the anime chains and the
+ * title search index from SQLite. The snapshot stores the result of that work
+ * in a single file next to the database so the next launch can map it and
+ * deserialize it instead of re-running the queries.
+ *
+ * File layout (all header fields big-endian, written with QDataStream):
+ *   magic "USNP" | format version | QDataStream version | reserved
+ *   DB generation | created at | payload size | payload CRC
+ *   payload (opaque QDataStream produced by the caller)
+ *
+ * Validity is tied to the database through a change counter maintained by
+ * SQLite triggers (see ensureChangeTracking()). Every write to a table the
+ * card cache reads bumps card_cache_state.generation and records the affected
+ * anime in card_cache_dirty. A snapshot is usable when its generation matches
+ * the generation recorded when it was written; anime modified since then, or
+ * modified before but not yet re-read into the cache that was written, are
+ * returned by dirtyAnimeIds() and re-read from the database as deltas.
+ *
+ * Usage:
+ *   CardDataSnapshot snapshot(CardDataSnapshot::defaultPath());
+ *   if (snapshot.open() && CardDataSnapshot::isCurrent(snapshot.generation())) {
+ *       QDataStream in(snapshot.payload());
+ *       in.setVersion(snapshot.streamVersion());
+ *       ...
+ *   }
+ */
+class CardDataSnapshot
+{
+public:
+    static constexpr quint32 MAGIC = 0x55534E50;  // "USNP"
+    static constexpr quint32 FORMAT_VERSION = 1;
+    static constexpr int HEADER_SIZE = 48;
+    static constexpr int STREAM_VERSION = QDataStream::Qt_6_0;
+
+    explicit CardDataSnapshot(const QString &path);
+    ~CardDataSnapshot();
+
+    CardDataSnapshot(const CardDataSnapshot&) = delete;
+    CardDataSnapshot& operator=(const CardDataSnapshot&) = delete;
+
+    // ── File access ──
+
+    /// Atomically replace the snapshot file with the given payload.
+    bool write(const QByteArray &payload, qint64 generation);
+
+    /// Map the snapshot file and validate its header and checksum.
+    bool open();
+    void close();
+    bool isOpen() const { return m_mapped != nullptr; }
+
+    /// Delete the snapshot file (e.g. after it failed to deserialize).
+    bool remove();
+
+    // Header fields (valid after open())
+    qint64 generation() const { return m_generation; }
+    qint64 createdAt() const { return m_createdAt; }
+    int streamVersion() const { return m_streamVersion; }
+
+    /// Payload view over the mapped file. Only valid while the snapshot is open.
+    QByteArray payload() const;
+
+    QString path() const { return m_path; }
+    QString errorString() const { return m_error; }
+
+    /// Snapshot path derived from the default database connection.
+    static QString defaultPath();
+
+    // ── Database change tracking ──
+
+    /// Create the generation/dirty tables and the triggers that maintain them.
+    static bool ensureChangeTracking();
+
+    /// Current value of the database change counter.
+    static qint64 currentGeneration();
+
+    /// Generation recorded by the last successful markSnapshotWritten().
+    static qint64 snapshotGeneration();
+
+    /// True if a snapshot with the given header generation matches the database.
+    static bool isCurrent(qint64 snapshotGeneration);
+
+    /// Anime touched since the last snapshot was written.
+    static QList<int> dirtyAnimeIds();
+
+    /// Record a snapshot written at the given generation and drop dirty entries it covers.
+    static bool markSnapshotWritten(qint64 generation) { return markSnapshotWritten(generation, generation); }
+
+    /// Record a snapshot written at the given generation whose content is only known to be
+    /// current up to coveredGeneration; later dirty entries stay for the next startup.
+    static bool markSnapshotWritten(qint64 generation, qint64 coveredGeneration);
+
+private:
+    QString m_path;
+    QString m_error;
+    QFile m_file;
+    uchar *m_mapped;
+    qint64 m_generation;
+    qint64 m_createdAt;
+    qint64 m_payloadSize;
+    int m_streamVersion;
+};
+
+#endif // CARDDATASNAPSHOT_H
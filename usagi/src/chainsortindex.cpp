@@ -0,0 +1,225 @@
+#include "chainsortindex.h"
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+// Map a signed value onto the unsigned 61-bit key range, preserving order
+quint64 orderedValue(qint64 value)
+{
+    const qint64 offset = qint64(1) << 60;
+    const qint64 clamped = std::clamp(value, -offset, offset - 1);
+    return static_cast<quint64>(clamped + offset);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Chains
+// ---------------------------------------------------------------------------
+
+void ChainSortIndex::setChains(const QList<ChainData> &chains)
+{
+    m_chains = chains;
+    m_sorted.clear();
+}
+
+void ChainSortIndex::clear()
+{
+    m_chains.clear();
+    m_sorted.clear();
+}
+
+bool ChainSortIndex::isCached(AnimeChain::SortCriteria criteria, qint64 now) const
+{
+    auto it = m_sorted.constFind(static_cast<int>(criteria));
+    return it != m_sorted.constEnd() && now < it->validUntil;
+}
+
+// ---------------------------------------------------------------------------
+// Ordering
+// ---------------------------------------------------------------------------
+
+QList<int> ChainSortIndex::order(AnimeChain::SortCriteria criteria, bool ascending, qint64 now)
+{
+    auto it = m_sorted.find(static_cast<int>(criteria));
+    if (it == m_sorted.end() || now >= it->validUntil) {
+        it = m_sorted.insert(static_cast<int>(criteria), buildKeys(criteria, now));
+    }
+    const std::vector<Entry> &entries = it->entries;
+
+    QList<int> result;
+    result.reserve(static_cast<qsizetype>(entries.size()));
+    if (ascending) {
+        for (const Entry &entry : entries) {
+            result.append(static_cast<int>(entry.index));
+        }
+        return result;
+    }
+
+    // Descending: buckets stay in place, each bucket's run is reversed
+    size_t begin = 0;
+    while (begin < entries.size()) {
+        const quint64 bucket = bucketOf(entries[begin].key);
+        size_t end = begin + 1;
+        while (end < entries.size() && bucketOf(entries[end].key) == bucket) {
+            ++end;
+        }
+        for (size_t i = end; i > begin; --i) {
+            result.append(static_cast<int>(entries[i - 1].index));
+        }
+        begin = end;
+    }
+    return result;
+}
+
+ChainSortIndex::SortedKeys ChainSortIndex::buildKeys(AnimeChain::SortCriteria criteria, qint64 now) const
+{
+    using SortCriteria = AnimeChain::SortCriteria;
+
+    SortedKeys sorted;
+    sorted.validUntil = std::numeric_limits<qint64>::max();
+
+    std::vector<quint32> ranks;
+    if (criteria == SortCriteria::ByRepresentativeTitle) {
+        ranks = stringRanks(&ChainData::title, Qt::CaseInsensitive);
+    } else if (criteria == SortCriteria::ByRepresentativeDate) {
+        ranks = stringRanks(&ChainData::startDate, Qt::CaseSensitive);
+    } else if (criteria == SortCriteria::ByRepresentativeType) {
+        ranks = stringRanks(&ChainData::typeName, Qt::CaseSensitive);
+    }
+
+    const int n = m_chains.size();
+    sorted.entries.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const ChainData &chain = m_chains.at(i);
+        quint64 bucket = 0;
+        quint64 value = 0;
+
+        if (!chain.hasData) {
+            // compareWith() compares by aid when data is missing
+            bucket = (criteria == SortCriteria::ByRepresentativeId) ? 0 : BUCKET_MISSING_DATA;
+            value = orderedValue(chain.representativeAid);
+        } else {
+            switch (criteria) {
+                case SortCriteria::ByRepresentativeTitle:
+                case SortCriteria::ByRepresentativeDate:
+                case SortCriteria::ByRepresentativeType:
+                    value = ranks[i];
+                    break;
+                case SortCriteria::ByChainLength:
+                    value = orderedValue(chain.length);
+                    break;
+                case SortCriteria::ByRepresentativeEpisodeCount:
+                    value = orderedValue(chain.episodes);
+                    break;
+                case SortCriteria::ByRepresentativeCompletion: {
+                    // Fixed point well below compareWith's 1e-9 epsilon
+                    const double completion = (chain.episodes > 0)
+                        ? static_cast<double>(chain.viewed) / chain.episodes : 0.0;
+                    value = orderedValue(qRound64(completion * 1e15));
+                    break;
+                }
+                case SortCriteria::ByRepresentativeLastPlayed:
+                    // Never played goes last in both directions
+                    if (chain.lastPlayed == 0) {
+                        bucket = 1;
+                    } else {
+                        value = orderedValue(chain.lastPlayed);
+                    }
+                    break;
+                case SortCriteria::ByRecentEpisodeAirDate: {
+                    // Aired, then not yet aired, then no air date - in both directions
+                    const qint64 airDate = chain.recentEpisodeAirDate;
+                    if (airDate == 0) {
+                        bucket = 2;
+                    } else {
+                        if (airDate > now) {
+                            bucket = 1;
+                            sorted.validUntil = std::min(sorted.validUntil, airDate);
+                        }
+                        value = orderedValue(airDate);
+                    }
+                    break;
+                }
+                case SortCriteria::ByRepresentativeId:
+                default:
+                    value = orderedValue(chain.representativeAid);
+                    break;
+            }
+        }
+
+        if (chain.fullyHidden) {
+            bucket += BUCKET_HIDDEN;
+        }
+        sorted.entries[i] = Entry{packKey(bucket, value), static_cast<quint32>(i)};
+    }
+
+    parallelSort(sorted.entries);
+    return sorted;
+}
+
+std::vector<quint32> ChainSortIndex::stringRanks(QString ChainData::*field, Qt::CaseSensitivity cs) const
+{
+    const int n = m_chains.size();
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this, field, cs](int a, int b) {
+        return (m_chains.at(a).*field).compare(m_chains.at(b).*field, cs) < 0;
+    });
+
+    // Equal strings share a rank
+    std::vector<quint32> ranks(n, 0);
+    quint32 rank = 0;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0 && (m_chains.at(order[i]).*field).compare(m_chains.at(order[i - 1]).*field, cs) != 0) {
+            rank = static_cast<quint32>(i);
+        }
+        ranks[order[i]] = rank;
+    }
+    return ranks;
+}
+
+void ChainSortIndex::parallelSort(std::vector<Entry> &entries)
+{
+    const qsizetype n = static_cast<qsizetype>(entries.size());
+    const int threads = QThread::idealThreadCount();
+    if (n < PARALLEL_THRESHOLD || threads <= 1) {
+        std::sort(entries.begin(), entries.end());
+        return;
+    }
+
+    // Sort one chunk per thread concurrently, then merge neighbouring runs level by level
+    using Run = QPair<qsizetype, qsizetype>;
+    const qsizetype chunks = std::min<qsizetype>(threads, n / (PARALLEL_THRESHOLD / 2));
+    const qsizetype chunkSize = (n + chunks - 1) / chunks;
+    QList<Run> runs;
+    for (qsizetype begin = 0; begin < n; begin += chunkSize) {
+        runs.append(Run(begin, std::min(begin + chunkSize, n)));
+    }
+
+    Entry *data = entries.data();
+    QtConcurrent::blockingMap(runs, [data](const Run &run) {
+        std::sort(data + run.first, data + run.second);
+    });
+
+    while (runs.size() > 1) {
+        QList<std::array<qsizetype, 3>> merges;
+        QList<Run> merged;
+        for (qsizetype i = 0; i + 1 < runs.size(); i += 2) {
+            merges.append(std::array<qsizetype, 3>{runs[i].first, runs[i].second, runs[i + 1].second});
+            merged.append(Run(runs[i].first, runs[i + 1].second));
+        }
+        if (runs.size() % 2 != 0) {
+            merged.append(runs.last());
+        }
+        QtConcurrent::blockingMap(merges, [data](const std::array<qsizetype, 3> &merge) {
+            std::inplace_merge(data + merge[0], data + merge[1], data + merge[2]);
+        });
+        runs = merged;
+    }
+}
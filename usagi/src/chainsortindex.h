@@ -0,0 +1,167 @@
+#ifndef CHAINSORTINDEX_H
+#define CHAINSORTINDEX_H
+
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QString>
+#include <QDateTime>
+#include <vector>
+#include "animechain.h"
+
+/**
+ * @brief ChainSortIndex - Decorate-sort-undecorate chain ordering with cached packed keys
+ *
+ * AnimeChain::compareWith() re-scans both chains for "fully hidden", re-reads the
+ * data cache and compares QStrings on every comparison. ChainSortIndex instead
+ * reduces each chain once to a ChainData record (see chainData()), packs it into a
+ * single 64-bit key per sort criterion and sorts (key, chain index) pairs, in
+ * parallel for large inputs.
+ *
+ * Key layout: the top 3 bits are a bucket, the low 61 bits an order-preserving value.
+ *   bucket 0..2  - criterion buckets (e.g. aired / not yet aired / no air date)
+ *   bucket 3     - representative anime missing from the data cache (ordered by aid)
+ *   bucket +4    - fully hidden chains (always after visible ones)
+ * Buckets keep their order in both directions; only the order inside a bucket is
+ * reversed for descending sorts. The ascending order per criterion is cached, so
+ * switching direction or re-applying a criterion is a linear pass.
+ *
+ * The resulting order is consistent with compareWith() (ties are broken by chain
+ * index instead of being left to std::sort). The one exception is a chain whose
+ * representative anime has no cached data: compareWith() falls back to an
+ * intransitive aid comparison there, while the index groups such chains in bucket 3.
+ *
+ * Follows SOLID principles:
+ * - Single Responsibility: Only orders chains; knows nothing about cards or layouts
+ * - Open/Closed: New criteria only need a key mapping in buildKeys()
+ *
+ * Usage:
+ *   ChainSortIndex index;
+ *   QList<ChainSortIndex::ChainData> data;
+ *   for (const AnimeChain &chain : chains)
+ *       data.append(ChainSortIndex::chainData(chain, dataCache));
+ *   index.setChains(data);
+ *   QList<int> order = index.order(AnimeChain::SortCriteria::ByRepresentativeTitle, true);
+ *   // order[i] is an index into 'chains'
+ */
+class ChainSortIndex
+{
+public:
+    // Everything a chain comparison looks at, resolved once per chain
+    struct ChainData {
+        int representativeAid = 0;
+        bool hasData = false;           // representative anime present in the data cache
+        bool fullyHidden = false;       // every anime hidden (as in compareWith)
+        int length = 0;
+        QString title;
+        QString startDate;
+        QString typeName;
+        int episodes = 0;               // normal + other episodes of the representative
+        int viewed = 0;                 // normal + other viewed of the representative
+        qint64 lastPlayed = 0;
+        qint64 recentEpisodeAirDate = 0; // newest air date of the chain's visible anime
+    };
+
+    ChainSortIndex() = default;
+
+    // Reduce a chain to its sort data (same field semantics as AnimeChain::compareWith)
+    template<typename CardCreationData>
+    static ChainData chainData(const AnimeChain &chain, const QMap<int, CardCreationData> &dataCache);
+
+    // Replace the chains; drops all cached keys
+    void setChains(const QList<ChainData> &chains);
+    void clear();
+
+    int size() const { return m_chains.size(); }
+    bool isEmpty() const { return m_chains.isEmpty(); }
+
+    // True if keys for the criterion are cached (next order() call is linear)
+    bool isCached(AnimeChain::SortCriteria criteria, qint64 now = QDateTime::currentSecsSinceEpoch()) const;
+
+    // Chain indices (into the list given to setChains) in sorted order
+    QList<int> order(AnimeChain::SortCriteria criteria, bool ascending,
+                     qint64 now = QDateTime::currentSecsSinceEpoch());
+
+    // Inputs at or above this size are sorted in parallel chunks
+    static constexpr int PARALLEL_THRESHOLD = 8192;
+
+private:
+    struct Entry {
+        quint64 key;
+        quint32 index;
+
+        bool operator<(const Entry &other) const {
+            return key != other.key ? key < other.key : index < other.index;
+        }
+    };
+
+    // Ascending order of one criterion
+    struct SortedKeys {
+        std::vector<Entry> entries;
+        qint64 validUntil = 0;          // keys depend on 'now' (air dates) until this time
+    };
+
+    static constexpr int BUCKET_SHIFT = 61;
+    static constexpr quint64 VALUE_MASK = (quint64(1) << BUCKET_SHIFT) - 1;
+    static constexpr quint64 BUCKET_MISSING_DATA = 3;
+    static constexpr quint64 BUCKET_HIDDEN = 4;
+
+    static quint64 packKey(quint64 bucket, quint64 value) { return (bucket << BUCKET_SHIFT) | (value & VALUE_MASK); }
+    static quint64 bucketOf(quint64 key) { return key >> BUCKET_SHIFT; }
+
+    SortedKeys buildKeys(AnimeChain::SortCriteria criteria, qint64 now) const;
+    std::vector<quint32> stringRanks(QString ChainData::*field, Qt::CaseSensitivity cs) const;
+    static void parallelSort(std::vector<Entry> &entries);
+
+    QList<ChainData> m_chains;
+    QHash<int, SortedKeys> m_sorted;    // criterion -> cached ascending order
+};
+
+// Template implementation must be in header
+template<typename CardCreationData>
+ChainSortIndex::ChainData ChainSortIndex::chainData(const AnimeChain &chain,
+                                                    const QMap<int, CardCreationData> &dataCache)
+{
+    const QList<int> animeIds = chain.getAnimeIds();
+
+    ChainData data;
+    data.representativeAid = chain.getRepresentativeAnimeId();
+    data.length = chain.size();
+
+    // Missing anime count as visible
+    data.fullyHidden = true;
+    for (int aid : animeIds) {
+        auto it = dataCache.constFind(aid);
+        if (it == dataCache.constEnd() || !it->isHidden) {
+            data.fullyHidden = false;
+            break;
+        }
+    }
+
+    auto rep = dataCache.constFind(data.representativeAid);
+    data.hasData = !animeIds.isEmpty() && rep != dataCache.constEnd();
+    if (!data.hasData) {
+        return data;
+    }
+
+    data.title = rep->animeTitle;
+    data.startDate = rep->startDate;
+    data.typeName = rep->typeName;
+    data.episodes = rep->stats.normalEpisodes() + rep->stats.otherEpisodes();
+    data.viewed = rep->stats.normalViewed() + rep->stats.otherViewed();
+    data.lastPlayed = rep->lastPlayed;
+
+    if (data.fullyHidden) {
+        data.recentEpisodeAirDate = rep->recentEpisodeAirDate;
+    } else {
+        for (int aid : animeIds) {
+            auto it = dataCache.constFind(aid);
+            if (it != dataCache.constEnd() && !it->isHidden && it->recentEpisodeAirDate > data.recentEpisodeAirDate) {
+                data.recentEpisodeAirDate = it->recentEpisodeAirDate;
+            }
+        }
+    }
+    return data;
+}
+
+#endif // CHAINSORTINDEX_H
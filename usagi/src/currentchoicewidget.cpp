@@ -360,14 +360,15 @@ void CurrentChoiceWidget::populateWeights()
                                 .arg(total)
                                 .arg(m_learner.isTrained() ? " (trained)" : ""));
 
-    QMap<QString, double> weights = m_learner.allWeights();
-    for (auto it = weights.constBegin(); it != weights.constEnd(); ++it) {
+    const FactorVector weights = m_learner.allWeights();
+    for (int f = 0; f < DeletionFactor::Count; ++f) {
+        const double weight = weights[f];
         QTreeWidgetItem *item = new QTreeWidgetItem(m_weightsTree);
-        item->setText(0, it.key());
-        item->setText(1, QString::number(it.value(), 'f', 2));
+        item->setText(0, FactorWeightLearner::factorNames().at(f));
+        item->setText(1, QString::number(weight, 'f', 2));
         // Simple bar visualization
-        int barLen = static_cast<int>(std::abs(it.value()) * 10);
-        QString bar = (it.value() >= 0)
+        int barLen = static_cast<int>(std::abs(weight) * 10);
+        QString bar = (weight >= 0)
                       ? QString(barLen, QChar(0x2588))   // █
                       : QString(barLen, QChar(0x2591));   // ░
         item->setText(2, bar);
@@ -1,8 +1,8 @@
 #ifndef DELETIONCANDIDATE_H
 #define DELETIONCANDIDATE_H
 
-#include <QMap>
 #include <QString>
+#include <array>
 
 /**
  * @brief Tier constants for the hybrid deletion classifier.
@@ -19,6 +19,26 @@ namespace DeletionTier {
     constexpr int PROTECTED                 = 999;
 }
 
+/**
+ * @brief Learnable factors of the learned-preference tier, in a fixed order.
+ *
+ * The index of a factor in FactorVector. FactorWeightLearner::factorNames()
+ * lists the names in the same order; they are only used for persistence and display.
+ */
+namespace DeletionFactor {
+    enum Index : int {
+        AnimeRating = 0,
+        SizeWeightedDistance,
+        GroupStatus,
+        WatchRecency,
+        ViewPercentage,
+        Count
+    };
+}
+
+/// One value per DeletionFactor (normalized factors, or their weights).
+using FactorVector = std::array<double, DeletionFactor::Count>;
+
 /**
  * @brief Value type holding the classification result for a single file.
  */
@@ -28,7 +48,7 @@ struct DeletionCandidate {
     int eid             = -1;
     int tier            = DeletionTier::PROTECTED;
     double learnedScore = 0.0;   ///< From factor weights (tier 3 only; 0.0 for procedural)
-    QMap<QString, double> factorValues;  ///< Normalized factor values for this file
+    FactorVector factorValues{};  ///< Normalized factor values for this file
     QString reason;              ///< Human-readable reason with actual values
     QString filePath;
     QString animeName;
@@ -0,0 +1,158 @@
+#include "deletionpriorityqueue.h"
+#include <algorithm>
+#include <utility>
+
+bool DeletionPriorityQueue::before(const DeletionCandidate &a, const DeletionCandidate &b)
+{
+    if (a < b) return true;
+    if (b < a) return false;
+    return a.lid < b.lid;
+}
+
+// ---------------------------------------------------------------------------
+// Bulk operations
+// ---------------------------------------------------------------------------
+
+void DeletionPriorityQueue::assign(const QList<DeletionCandidate> &candidates)
+{
+    m_heap.assign(candidates.cbegin(), candidates.cend());
+    heapify();
+}
+
+void DeletionPriorityQueue::clear()
+{
+    m_heap.clear();
+    m_position.clear();
+}
+
+void DeletionPriorityQueue::updateAll(const std::function<void(DeletionCandidate &)> &update)
+{
+    for (DeletionCandidate &candidate : m_heap) {
+        update(candidate);
+    }
+    heapify();
+}
+
+QList<DeletionCandidate> DeletionPriorityQueue::sorted() const
+{
+    QList<DeletionCandidate> result(m_heap.cbegin(), m_heap.cend());
+    std::sort(result.begin(), result.end(), &DeletionPriorityQueue::before);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Single candidates
+// ---------------------------------------------------------------------------
+
+void DeletionPriorityQueue::insert(const DeletionCandidate &candidate)
+{
+    auto it = m_position.constFind(candidate.lid);
+    if (it != m_position.constEnd()) {
+        const int index = it.value();
+        const bool better = before(candidate, m_heap[index]);
+        m_heap[index] = candidate;
+        if (better) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+        return;
+    }
+
+    const int index = size();
+    m_heap.push_back(candidate);
+    m_position.insert(candidate.lid, index);
+    siftUp(index);
+}
+
+bool DeletionPriorityQueue::remove(int lid)
+{
+    auto it = m_position.constFind(lid);
+    if (it == m_position.constEnd()) {
+        return false;
+    }
+    const int index = it.value();
+    const int last = size() - 1;
+    if (index != last) {
+        swapEntries(index, last);
+    }
+    m_heap.pop_back();
+    m_position.remove(lid);
+    if (index < size()) {
+        // The moved entry can belong either above or below its new slot
+        siftUp(index);
+        siftDown(index);
+    }
+    return true;
+}
+
+const DeletionCandidate *DeletionPriorityQueue::find(int lid) const
+{
+    auto it = m_position.constFind(lid);
+    return it == m_position.constEnd() ? nullptr : &m_heap[it.value()];
+}
+
+const DeletionCandidate *DeletionPriorityQueue::top() const
+{
+    return m_heap.empty() ? nullptr : &m_heap[0];
+}
+
+const DeletionCandidate *DeletionPriorityQueue::second() const
+{
+    if (m_heap.size() < 2) return nullptr;
+    if (m_heap.size() == 2) return &m_heap[1];
+    return before(m_heap[1], m_heap[2]) ? &m_heap[1] : &m_heap[2];
+}
+
+// ---------------------------------------------------------------------------
+// Heap maintenance
+// ---------------------------------------------------------------------------
+
+void DeletionPriorityQueue::heapify()
+{
+    m_position.clear();
+    m_position.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        m_position.insert(m_heap[i].lid, i);
+    }
+    for (int i = size() / 2 - 1; i >= 0; --i) {
+        siftDown(i);
+    }
+}
+
+void DeletionPriorityQueue::siftUp(int index)
+{
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!before(m_heap[index], m_heap[parent])) {
+            break;
+        }
+        swapEntries(index, parent);
+        index = parent;
+    }
+}
+
+void DeletionPriorityQueue::siftDown(int index)
+{
+    const int count = size();
+    for (;;) {
+        const int left = 2 * index + 1;
+        if (left >= count) {
+            break;
+        }
+        const int right = left + 1;
+        const int child = (right < count && before(m_heap[right], m_heap[left])) ? right : left;
+        if (!before(m_heap[child], m_heap[index])) {
+            break;
+        }
+        swapEntries(index, child);
+        index = child;
+    }
+}
+
+void DeletionPriorityQueue::swapEntries(int a, int b)
+{
+    std::swap(m_heap[a], m_heap[b]);
+    m_position[m_heap[a].lid] = a;
+    m_position[m_heap[b].lid] = b;
+}
@@ -0,0 +1,68 @@
+#ifndef DELETIONPRIORITYQUEUE_H
+#define DELETIONPRIORITYQUEUE_H
+
+#include <QHash>
+#include <QList>
+#include <functional>
+#include <vector>
+#include "deletioncandidate.h"
+
+/**
+ * @brief Indexed binary min-heap of deletion candidates.
+ *
+ * Ordered like DeletionCandidate::operator< (tier, then score), ties broken by
+ * lid so the order is deterministic. A lid -> heap position map lets a single
+ * candidate be inserted, replaced or removed in O(log n), and the best and
+ * second-best candidates are read in O(1) (the second best is a child of the root).
+ *
+ * Used by DeletionQueue so lock changes, choices and deletions only touch the
+ * affected files instead of re-sorting the whole queue.
+ */
+class DeletionPriorityQueue
+{
+public:
+    /// Replace the contents (O(n) heapify).
+    void assign(const QList<DeletionCandidate> &candidates);
+    void clear();
+
+    /// Insert a candidate, or replace the one with the same lid. O(log n).
+    void insert(const DeletionCandidate &candidate);
+
+    /// Remove a candidate by lid. O(log n). Returns false if not queued.
+    bool remove(int lid);
+
+    bool contains(int lid) const { return m_position.contains(lid); }
+    const DeletionCandidate *find(int lid) const;
+
+    /// Best candidate (deleted first), nullptr if empty. O(1).
+    const DeletionCandidate *top() const;
+
+    /// Second-best candidate, nullptr if fewer than two. O(1).
+    const DeletionCandidate *second() const;
+
+    int size() const { return static_cast<int>(m_heap.size()); }
+    bool isEmpty() const { return m_heap.empty(); }
+
+    /// Apply an update to every candidate, then restore the heap (O(n)).
+    /// Candidates are visited in entries() order.
+    void updateAll(const std::function<void(DeletionCandidate &)> &update);
+
+    /// All candidates in heap order (unsorted).
+    const std::vector<DeletionCandidate> &entries() const { return m_heap; }
+
+    /// All candidates in deletion order. O(n log n).
+    QList<DeletionCandidate> sorted() const;
+
+    static bool before(const DeletionCandidate &a, const DeletionCandidate &b);
+
+private:
+    void heapify();
+    void siftUp(int index);
+    void siftDown(int index);
+    void swapEntries(int a, int b);
+
+    std::vector<DeletionCandidate> m_heap;
+    QHash<int, int> m_position;     ///< lid -> index into m_heap
+};
+
+#endif // DELETIONPRIORITYQUEUE_H
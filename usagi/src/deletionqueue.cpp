@@ -2,11 +2,12 @@
 #include "hybriddeletionclassifier.h"
 #include "deletionlockmanager.h"
 #include "factorweightlearner.h"
+#include "fileattributesnapshot.h"
 #include "logger.h"
+#include <QElapsedTimer>
 #include <QSqlDatabase>
 #include <QSqlQuery>
-#include <QSqlError>
-#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 #include <algorithm>
 
 DeletionQueue::DeletionQueue(HybridDeletionClassifier &classifier,
@@ -18,6 +19,15 @@ DeletionQueue::DeletionQueue(HybridDeletionClassifier &classifier,
     , m_lockManager(lockManager)
     , m_learner(learner)
 {
+    connect(&m_watcher, &QFutureWatcher<Classification>::finished,
+            this, &DeletionQueue::onClassificationFinished);
+}
+
+DeletionQueue::~DeletionQueue()
+{
+    // Workers only hold their own snapshot, but the result slot must not outlive us
+    m_watcher.disconnect(this);
+    m_watcher.waitForFinished();
 }
 
 // ---------------------------------------------------------------------------
@@ -26,75 +36,211 @@ DeletionQueue::DeletionQueue(HybridDeletionClassifier &classifier,
 
 void DeletionQueue::rebuild()
 {
-    LOG(QString("DeletionQueue::rebuild() entered, thread=%1")
-        .arg((quintptr)QThread::currentThreadId()));
+    if (m_watcher.isRunning()) {
+        // The running result is already stale; start over when it finishes
+        m_rebuildPending = true;
+        return;
+    }
+
+    // Load the attributes of every local file in one pass on this thread, so the
+    // snapshot reflects the database at the time of the request
+    FileAttributeSnapshot snapshot;
+    if (!snapshot.load()) {
+        LOG(QString("DeletionQueue::rebuild() ERROR: failed to load file attributes"));
+        return;
+    }
+    LOG(QString("DeletionQueue: classifying %1 local file(s) in the background")
+        .arg(snapshot.deletionCandidates().size()));
+
+    const FactorVector weights = m_learner.allWeights();
+    m_watcher.setFuture(QtConcurrent::run([snapshot = std::move(snapshot), weights]() {
+        return classifySnapshot(snapshot, weights);
+    }));
+}
 
-    m_candidates.clear();
-    m_lockedFiles.clear();
+DeletionQueue::Classification DeletionQueue::classifySnapshot(const FileAttributeSnapshot &snapshot,
+                                                              const FactorVector &weights)
+{
+    QElapsedTimer timer;
+    timer.start();
 
-    QSqlDatabase db = QSqlDatabase::database();
-    if (!db.isValid()) {
-        LOG(QString("DeletionQueue::rebuild() ERROR: default database connection is INVALID"));
+    Classification result;
+    const QList<DeletionCandidate> classified = HybridDeletionClassifier::classifyAll(snapshot, weights);
+    QList<DeletionCandidate> candidates;
+    for (const DeletionCandidate &c : classified) {
+        if (c.locked || c.tier == DeletionTier::PROTECTED) {
+            result.entries.add(c);
+        } else {
+            // Heapified once below instead of n inserts
+            result.entries.index(c);
+            candidates.append(c);
+        }
+    }
+    result.entries.candidates.assign(candidates);
+
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+void DeletionQueue::onClassificationFinished()
+{
+    if (m_rebuildPending) {
+        m_rebuildPending = false;
+        rebuild();
         return;
     }
-    if (!db.isOpen()) {
-        LOG(QString("DeletionQueue::rebuild() ERROR: default database connection is NOT OPEN"));
+
+    // Publish the new entries in one step
+    Classification result = m_watcher.result();
+    m_entries = std::move(result.entries);
+    m_sortedValid = false;
+
+    LOG(QString("DeletionQueue: rebuilt — %1 candidates, %2 locked, %3 protected (classified in %4 ms)")
+        .arg(m_entries.candidates.size()).arg(m_entries.lockedFiles.size())
+        .arg(m_entries.protectedLids.size()).arg(result.elapsedMs));
+
+    emit queueRebuilt(candidates());
+
+    if (needsUserChoice()) {
+        emit choiceNeeded();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Entries
+// ---------------------------------------------------------------------------
+
+void DeletionQueue::Entries::add(const DeletionCandidate &c)
+{
+    remove(c.lid);
+    index(c);
+
+    if (c.locked) {
+        lockedFiles.insert(c.lid, c);
+    } else if (c.tier != DeletionTier::PROTECTED) {
+        candidates.insert(c);
+    } else {
+        protectedLids.insert(c.lid);
+    }
+}
+
+void DeletionQueue::Entries::index(const DeletionCandidate &c)
+{
+    animeOfLid.insert(c.lid, c.aid);
+    episodeOfLid.insert(c.lid, c.eid);
+    lidsOfAnime[c.aid].insert(c.lid);
+    lidsOfEpisode[c.eid].insert(c.lid);
+}
+
+void DeletionQueue::Entries::remove(int lid)
+{
+    auto anime = animeOfLid.find(lid);
+    if (anime == animeOfLid.end()) {
         return;
     }
+    auto lids = lidsOfAnime.find(anime.value());
+    lids->remove(lid);
+    if (lids->isEmpty()) lidsOfAnime.erase(lids);
+    animeOfLid.erase(anime);
+
+    const int eid = episodeOfLid.take(lid);
+    lids = lidsOfEpisode.find(eid);
+    lids->remove(lid);
+    if (lids->isEmpty()) lidsOfEpisode.erase(lids);
 
-    LOG(QString("DeletionQueue::rebuild() db connection='%1' driver='%2'")
-        .arg(db.connectionName(), db.driverName()));
+    if (!candidates.remove(lid) && !lockedFiles.remove(lid)) {
+        protectedLids.remove(lid);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Incremental refresh
+// ---------------------------------------------------------------------------
 
-    QSqlQuery q(db);
-    // Fetch all local files with non-null paths (i.e. files that exist on disk)
-    if (!q.exec("SELECT m.lid FROM mylist m "
-           "JOIN local_files lf ON lf.id = m.local_file "
-           "WHERE lf.path IS NOT NULL AND m.state != 3")) {
-        LOG(QString("DeletionQueue::rebuild() ERROR: query failed: %1").arg(q.lastError().text()));
+void DeletionQueue::refreshAnime(int aid)
+{
+    if (m_watcher.isRunning()) {
+        // The running rebuild may predate this change; restart it
+        m_rebuildPending = true;
         return;
     }
-    QList<int> lids;
-    while (q.next()) {
-        lids.append(q.value(0).toInt());
+
+    FileAttributeSnapshot snapshot;
+    if (!snapshot.loadAnime(aid)) {
+        LOG(QString("DeletionQueue::refreshAnime() ERROR: failed to load file attributes of aid=%1").arg(aid));
+        return;
     }
+    applyPartial(m_entries.lidsOfAnime.value(aid), snapshot);
+}
 
-    LOG(QString("DeletionQueue: found %1 local file(s) for classification").arg(lids.size()));
+void DeletionQueue::refreshEpisodes(const QList<int> &eids)
+{
+    if (m_watcher.isRunning()) {
+        m_rebuildPending = true;
+        return;
+    }
 
-    m_protectedCount  = 0;
-    m_totalClassified = lids.size();
-    int classifiedCount = 0;
-    int lastReportedLid = 0;
-    for (int lid : lids) {
-        lastReportedLid = lid;
-        DeletionCandidate c = m_classifier.classify(lid);
-        if (c.locked) {
-            m_lockedFiles.append(c);
-        } else if (c.tier != DeletionTier::PROTECTED) {
-            m_candidates.append(c);
-        } else {
-            ++m_protectedCount;
-        }
-        ++classifiedCount;
-        if (classifiedCount % 50 == 0) {
-            LOG(QString("DeletionQueue: classified %1/%2 (last lid=%3, candidates=%4, locked=%5, protected=%6)")
-                .arg(classifiedCount).arg(lids.size()).arg(lid)
-                .arg(m_candidates.size()).arg(m_lockedFiles.size()).arg(m_protectedCount));
+    FileAttributeSnapshot snapshot;
+    if (!snapshot.loadEpisodes(eids)) {
+        LOG(QString("DeletionQueue::refreshEpisodes() ERROR: failed to load file attributes of %1 episode(s)")
+            .arg(eids.size()));
+        return;
+    }
+    QSet<int> lids;
+    for (int eid : eids) {
+        lids.unite(m_entries.lidsOfEpisode.value(eid));
+    }
+    applyPartial(lids, snapshot);
+}
+
+void DeletionQueue::refreshFile(int lid)
+{
+    int eid = m_entries.episodeOfLid.value(lid, 0);
+    if (eid == 0) {
+        // Not classified yet (e.g. just linked to mylist)
+        QSqlQuery q(QSqlDatabase::database());
+        q.prepare("SELECT eid FROM mylist WHERE lid = ?");
+        q.addBindValue(lid);
+        if (q.exec() && q.next()) {
+            eid = q.value(0).toInt();
         }
     }
-    if (classifiedCount % 50 != 0) {
-        LOG(QString("DeletionQueue: classified %1/%2 (last lid=%3, candidates=%4, locked=%5, protected=%6)")
-            .arg(classifiedCount).arg(lids.size()).arg(lastReportedLid)
-            .arg(m_candidates.size()).arg(m_lockedFiles.size()).arg(m_protectedCount));
+    if (eid != 0) {
+        refreshEpisodes({eid});
     }
+}
 
-    std::sort(m_candidates.begin(), m_candidates.end());
-    std::sort(m_lockedFiles.begin(), m_lockedFiles.end());
+void DeletionQueue::removeFile(int lid)
+{
+    const int eid = m_entries.episodeOfLid.value(lid, 0);
+    m_entries.remove(lid);
+    if (eid != 0 && !m_watcher.isRunning()) {
+        // Siblings may have been superseded by / duplicates of the deleted file
+        refreshEpisodes({eid});
+        return;
+    }
+    if (m_watcher.isRunning()) {
+        m_rebuildPending = true;
+    }
+    publishUpdate();
+}
 
-    LOG(QString("DeletionQueue: rebuilt — %1 candidates, %2 locked, %3 protected")
-        .arg(m_candidates.size()).arg(m_lockedFiles.size()).arg(m_protectedCount));
+void DeletionQueue::applyPartial(const QSet<int> &lids, const FileAttributeSnapshot &snapshot)
+{
+    for (int lid : lids) {
+        m_entries.remove(lid);
+    }
+    const FactorVector weights = m_learner.allWeights();
+    for (int lid : snapshot.deletionCandidates()) {
+        m_entries.add(HybridDeletionClassifier::classify(lid, snapshot, weights));
+    }
+    publishUpdate();
+}
 
-    LOG(QString("DeletionQueue::rebuild() completed"));
-    emit queueRebuilt();
+void DeletionQueue::publishUpdate()
+{
+    m_sortedValid = false;
+    emit queueUpdated();
 
     if (needsUserChoice()) {
         emit choiceNeeded();
@@ -107,49 +253,60 @@ void DeletionQueue::rebuild()
 
 const DeletionCandidate *DeletionQueue::next() const
 {
-    return m_candidates.isEmpty() ? nullptr : &m_candidates.first();
+    return m_entries.candidates.top();
+}
+
+const QList<DeletionCandidate> &DeletionQueue::candidates() const
+{
+    if (!m_sortedValid) {
+        m_sortedCandidates = m_entries.candidates.sorted();
+        m_sortedLockedFiles = m_entries.lockedFiles.values();
+        std::sort(m_sortedLockedFiles.begin(), m_sortedLockedFiles.end(), &DeletionPriorityQueue::before);
+        m_sortedValid = true;
+    }
+    return m_sortedCandidates;
+}
+
+const QList<DeletionCandidate> &DeletionQueue::lockedFiles() const
+{
+    candidates();
+    return m_sortedLockedFiles;
 }
 
 QList<DeletionCandidate> DeletionQueue::allCandidates() const
 {
     QList<DeletionCandidate> combined;
-    combined.reserve(m_candidates.size() + m_lockedFiles.size());
-    combined.append(m_candidates);
-    combined.append(m_lockedFiles);
+    combined.reserve(m_entries.candidates.size() + m_entries.lockedFiles.size());
+    combined.append(candidates());
+    combined.append(lockedFiles());
     return combined;
 }
 
 bool DeletionQueue::needsUserChoice() const
 {
-    if (m_candidates.isEmpty()) return false;
-    const auto &top = m_candidates.first();
+    const DeletionCandidate *top = m_entries.candidates.top();
+    if (!top) return false;
     // Procedural tiers don't need user choice
-    if (top.tier < DeletionTier::LEARNED_PREFERENCE) return false;
+    if (top->tier < DeletionTier::LEARNED_PREFERENCE) return false;
     // Not enough training — always ask
     if (!m_learner.isTrained()) return true;
-    // Only one Tier-3 candidate — show single confirmation
-    int tier3Count = 0;
-    for (const auto &c : m_candidates) {
-        if (c.tier == DeletionTier::LEARNED_PREFERENCE) ++tier3Count;
-        if (tier3Count >= 2) break;
-    }
-    if (tier3Count < 2) return true;
+    // Only one Tier-3 candidate — show single confirmation (the top is T4, so every
+    // candidate is)
+    const DeletionCandidate *second = m_entries.candidates.second();
+    if (!second) return true;
     // Check confidence
-    return m_learner.scoreDifference(
-               m_candidates[0].factorValues,
-               m_candidates[1].factorValues) < FactorWeightLearner::CONFIDENCE_THRESHOLD;
+    return m_learner.scoreDifference(top->factorValues, second->factorValues)
+           < FactorWeightLearner::CONFIDENCE_THRESHOLD;
 }
 
 QPair<DeletionCandidate, DeletionCandidate> DeletionQueue::getAvsBPair() const
 {
-    if (m_candidates.size() >= 2) {
-        return qMakePair(m_candidates[0], m_candidates[1]);
+    const DeletionCandidate *top = m_entries.candidates.top();
+    if (!top) {
+        return {};
     }
-    if (m_candidates.size() == 1) {
-        DeletionCandidate empty;
-        return qMakePair(m_candidates[0], empty);
-    }
-    return {};
+    const DeletionCandidate *second = m_entries.candidates.second();
+    return qMakePair(*top, second ? *second : DeletionCandidate());
 }
 
 // ---------------------------------------------------------------------------
@@ -159,25 +316,25 @@ QPair<DeletionCandidate, DeletionCandidate> DeletionQueue::getAvsBPair() const
 void DeletionQueue::lockAnime(int aid)
 {
     m_lockManager.lockAnime(aid);
-    rebuild();
+    refreshAnime(aid);
 }
 
 void DeletionQueue::unlockAnime(int aid)
 {
     m_lockManager.unlockAnime(aid);
-    rebuild();
+    refreshAnime(aid);
 }
 
 void DeletionQueue::lockEpisode(int eid)
 {
     m_lockManager.lockEpisode(eid);
-    rebuild();
+    refreshEpisodes({eid});
 }
 
 void DeletionQueue::unlockEpisode(int eid)
 {
     m_lockManager.unlockEpisode(eid);
-    rebuild();
+    refreshEpisodes({eid});
 }
 
 // ---------------------------------------------------------------------------
@@ -187,9 +344,33 @@ void DeletionQueue::unlockEpisode(int eid)
 void DeletionQueue::recordChoice(int keptLid, int deletedLid)
 {
     // Find factor values for both files
-    QMap<QString, double> keptFactors   = m_classifier.normalizeFactors(keptLid);
-    QMap<QString, double> deletedFactors = m_classifier.normalizeFactors(deletedLid);
+    const FactorVector keptFactors    = m_classifier.normalizeFactors(keptLid);
+    const FactorVector deletedFactors = m_classifier.normalizeFactors(deletedLid);
 
     m_learner.recordChoice(keptLid, deletedLid, keptFactors, deletedFactors);
-    rebuild();
+
+    if (m_watcher.isRunning()) {
+        m_rebuildPending = true;
+        return;
+    }
+
+    // Only the weights changed: rescore the learned-preference entries in one
+    // batch, then write the scores back in the same (heap) order
+    std::vector<FactorVector> factors;
+    factors.reserve(m_entries.candidates.entries().size());
+    for (const DeletionCandidate &c : m_entries.candidates.entries()) {
+        if (c.tier == DeletionTier::LEARNED_PREFERENCE) {
+            factors.push_back(c.factorValues);
+        }
+    }
+    const std::vector<double> scores =
+        FactorWeightLearner::computeScores(m_learner.allWeights(), factors);
+    std::size_t next = 0;
+    m_entries.candidates.updateAll([&scores, &next](DeletionCandidate &c) {
+        if (c.tier == DeletionTier::LEARNED_PREFERENCE) {
+            c.learnedScore = scores[next++];
+            c.reason = QString("Score: %1").arg(c.learnedScore, 0, 'f', 2);
+        }
+    });
+    publishUpdate();
 }
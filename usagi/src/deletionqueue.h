@@ -3,19 +3,41 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QSet>
 #include <QPair>
+#include <QFutureWatcher>
 #include "deletioncandidate.h"
+#include "deletionpriorityqueue.h"
 
 class HybridDeletionClassifier;
 class DeletionLockManager;
 class FactorWeightLearner;
+class FileAttributeSnapshot;
 
 /**
  * @brief Maintains the ranked list of deletion candidates and locked files.
  *
- * rebuild() classifies ALL local files and populates two disjoint lists:
- *   m_candidates  – deletable files (T0-T3), sorted by tier + score
- *   m_lockedFiles – locked files shown for visibility
+ * rebuild() loads a FileAttributeSnapshot of all local files (one joined query)
+ * and classifies it in parallel on the global thread pool. The result is three
+ * disjoint sets:
+ *   candidates  – deletable files (T0-T4) in an indexed heap ordered by tier + score
+ *   lockedFiles – locked files shown for visibility
+ *   protected   – everything else (only counted)
+ *
+ * Every classified lid is also indexed by anime and episode, so changes that only
+ * affect some files (lock/unlock, a deleted or newly linked file) reload and
+ * re-classify just those files' episodes and patch the heap in O(k log n) instead
+ * of re-classifying the library. A recorded choice only changes the learned weights,
+ * so it rescores the T4 entries in memory. next() and getAvsBPair() read the top of
+ * the heap; queueUpdated() signals an incremental change.
+ *
+ * The workers only see the snapshot and a copy of the factor weights, so lock
+ * changes or choices made while they run cannot tear the result. The entries are
+ * swapped in on the GUI thread in one step and queueRebuilt() is emitted; until
+ * then the previous entries stay valid. A rebuild requested while one is running
+ * is coalesced: the running result is dropped and classification starts again.
+ * Incremental refreshes requested during a rebuild are folded into that restart.
  */
 class DeletionQueue : public QObject
 {
@@ -26,27 +48,34 @@ public:
                            DeletionLockManager &lockManager,
                            FactorWeightLearner &learner,
                            QObject *parent = nullptr);
+    ~DeletionQueue() override;
 
-    /// Re-classify every local file.
+    /// Re-classify every local file in the background; queueRebuilt() signals the result.
     void rebuild();
 
+    /// True while a rebuild is classifying.
+    bool isRebuilding() const { return m_watcher.isRunning(); }
+
     /// Top candidate (nullptr if empty).
     const DeletionCandidate *next() const;
 
     /// Combined list: candidates + locked files. Locked entries have locked=true.
     QList<DeletionCandidate> allCandidates() const;
 
-    /// Only unlocked candidates.
-    const QList<DeletionCandidate> &candidates() const { return m_candidates; }
+    /// Only unlocked candidates, in deletion order (sorted lazily after a change).
+    const QList<DeletionCandidate> &candidates() const;
 
     /// Only locked files.
-    const QList<DeletionCandidate> &lockedFiles() const { return m_lockedFiles; }
+    const QList<DeletionCandidate> &lockedFiles() const;
+
+    /// Queued candidate for a lid (nullptr if locked, protected or unknown).
+    const DeletionCandidate *candidate(int lid) const { return m_entries.candidates.find(lid); }
 
     /// Number of files classified as protected (not shown in candidates or locked lists).
-    int protectedCount() const { return m_protectedCount; }
+    int protectedCount() const { return static_cast<int>(m_entries.protectedLids.size()); }
 
-    /// Total number of local files classified in the last rebuild.
-    int totalClassified() const { return m_totalClassified; }
+    /// Total number of local files currently classified.
+    int totalClassified() const { return m_entries.size(); }
 
     /// True if the top candidate requires user input (A vs B).
     bool needsUserChoice() const;
@@ -54,7 +83,15 @@ public:
     /// The A vs B pair (top two Tier-3 candidates).
     QPair<DeletionCandidate, DeletionCandidate> getAvsBPair() const;
 
-    // ── Lock actions (delegates + rebuilds) ──
+    // ── Incremental refresh (re-classify only the affected files) ──
+    void refreshAnime(int aid);
+    void refreshEpisodes(const QList<int> &eids);
+    /// A file was linked, changed or deleted; re-classifies its episode.
+    void refreshFile(int lid);
+    /// A file was deleted; drops it and re-classifies its former siblings.
+    void removeFile(int lid);
+
+    // ── Lock actions (delegates + incremental refresh) ──
     void lockAnime(int aid);
     void unlockAnime(int aid);
     void lockEpisode(int eid);
@@ -64,17 +101,49 @@ public:
     void recordChoice(int keptLid, int deletedLid);
 
 signals:
-    void queueRebuilt();
+    void queueRebuilt(const QList<DeletionCandidate> &candidates);
+    void queueUpdated();
     void choiceNeeded();
 
 private:
-    QList<DeletionCandidate> m_candidates;
-    QList<DeletionCandidate> m_lockedFiles;
-    int m_protectedCount  = 0;
-    int m_totalClassified = 0;
+    /// Every classified lid, partitioned and indexed by anime / episode.
+    struct Entries {
+        DeletionPriorityQueue candidates;
+        QHash<int, DeletionCandidate> lockedFiles;  // lid -> locked entry
+        QSet<int> protectedLids;
+        QHash<int, int> animeOfLid;
+        QHash<int, int> episodeOfLid;
+        QHash<int, QSet<int>> lidsOfAnime;
+        QHash<int, QSet<int>> lidsOfEpisode;
+
+        void add(const DeletionCandidate &c);
+        void index(const DeletionCandidate &c);     // scope maps only
+        void remove(int lid);
+        int size() const { return static_cast<int>(animeOfLid.size()); }
+    };
+
+    struct Classification {
+        Entries entries;
+        qint64 elapsedMs = 0;
+    };
+
+    static Classification classifySnapshot(const FileAttributeSnapshot &snapshot,
+                                           const FactorVector &weights);
+    void onClassificationFinished();
+
+    /// Replace the entries of @p lids with the classification of @p snapshot.
+    void applyPartial(const QSet<int> &lids, const FileAttributeSnapshot &snapshot);
+    void publishUpdate();
+
+    Entries m_entries;
+    mutable QList<DeletionCandidate> m_sortedCandidates;
+    mutable QList<DeletionCandidate> m_sortedLockedFiles;
+    mutable bool m_sortedValid = true;
     HybridDeletionClassifier &m_classifier;
     DeletionLockManager &m_lockManager;
     FactorWeightLearner &m_learner;
+    QFutureWatcher<Classification> m_watcher;
+    bool m_rebuildPending = false;
 };
 
 #endif // DELETIONQUEUE_H
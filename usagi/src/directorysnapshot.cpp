@@ -0,0 +1,341 @@
+#include "directorysnapshot.h"
+#include "logger.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <utility>
+
+namespace {
+
+QString joinPath(const QString &directory, const QString &name)
+{
+    return directory.endsWith('/') ? directory + name : directory + '/' + name;
+}
+
+// Persisted state of a row: changes when the directory was relisted with a different
+// result, or when its mtime (and so its trustworthiness) changed
+quint64 rowSignature(const DirectorySnapshot::DirectoryEntry &entry)
+{
+    return entry.entryHash ^ (static_cast<quint64>(entry.mtime) * 0x9E3779B97F4A7C15ULL);
+}
+
+QByteArray serializeEntries(const DirectorySnapshot::DirectoryEntry &entry)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << entry.subdirectories << static_cast<qint32>(entry.files.size());
+    for (const DirectorySnapshot::FileEntry &file : entry.files) {
+        out << file.name << file.size;
+    }
+    return data;
+}
+
+bool deserializeEntries(const QByteArray &data, DirectorySnapshot::DirectoryEntry &entry)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+    qint32 fileCount = 0;
+    in >> entry.subdirectories >> fileCount;
+    if (fileCount < 0) {
+        return false;
+    }
+    entry.files.reserve(fileCount);
+    for (qint32 i = 0; i < fileCount && in.status() == QDataStream::Ok; ++i) {
+        DirectorySnapshot::FileEntry file;
+        in >> file.name >> file.size;
+        entry.files.append(file);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Refresh
+// ---------------------------------------------------------------------------
+
+QHash<QString, qint64> DirectorySnapshot::refresh(const QString &root, qint64 nowMs)
+{
+    if (root != m_root) {
+        clear();
+        m_savedHashes.clear();
+        m_root = root;
+    }
+    m_stats = Stats();
+
+    QHash<QString, qint64> files;
+    QSet<QString> visited;
+    QStringList pending{root};
+    while (!pending.isEmpty()) {
+        const QString directory = pending.takeLast();
+        const QFileInfo info(directory);
+        ++m_stats.directoriesChecked;
+        if (!info.isDir() || (directory != root && info.isSymLink())) {
+            continue;
+        }
+        visited.insert(directory);
+
+        const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+        auto it = m_directories.find(directory);
+        if (it == m_directories.end() || it->mtime < 0 || it->mtime != mtime) {
+            const DirectoryEntry listed = listDirectory(directory, mtime, nowMs);
+            if (it == m_directories.end()) {
+                it = m_directories.insert(directory, listed);
+            } else {
+                *it = listed;
+            }
+        } else {
+            // Unchanged: sizes of files that were still empty may have grown
+            for (FileEntry &file : it->files) {
+                if (file.size == 0) {
+                    ++m_stats.filesChecked;
+                    file.size = QFileInfo(joinPath(directory, file.name)).size();
+                }
+            }
+        }
+
+        for (const FileEntry &file : std::as_const(it->files)) {
+            files.insert(joinPath(directory, file.name), file.size);
+        }
+        for (const QString &name : std::as_const(it->subdirectories)) {
+            const QString subdirectory = joinPath(directory, name);
+            if (!isExcluded(subdirectory)) {
+                pending.append(subdirectory);
+            }
+        }
+    }
+
+    // Directories that vanished (or were moved out) since the last refresh
+    for (auto it = m_directories.begin(); it != m_directories.end(); ) {
+        if (!visited.contains(it.key())) {
+            it = m_directories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return files;
+}
+
+DirectorySnapshot::DirectoryEntry DirectorySnapshot::listDirectory(const QString &directory, qint64 mtime, qint64 nowMs)
+{
+    ++m_stats.directoriesListed;
+
+    // Same entries as a QDirIterator walk with QDir::Files | QDir::NoSymLinks: no hidden
+    // entries, no symlinks, and hidden directories are not descended into
+    DirectoryEntry entry;
+    const QFileInfoList infos = QDir(directory).entryInfoList(
+        QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDir::Name);
+    for (const QFileInfo &info : infos) {
+        if (info.isDir()) {
+            entry.subdirectories.append(info.fileName());
+        } else {
+            ++m_stats.filesChecked;
+            entry.files.append(FileEntry{info.fileName(), info.size()});
+        }
+    }
+    entry.entryHash = hashEntries(entry.files, entry.subdirectories);
+    // A change later in the same mtime tick would go unnoticed; list it again next time
+    entry.mtime = (nowMs - mtime < MTIME_GRANULARITY_MS) ? -1 : mtime;
+    return entry;
+}
+
+void DirectorySnapshot::setExcludedDirectories(const QStringList &directories)
+{
+    m_excludedDirectories = directories;
+
+    // Rows below them belong to the nested root's snapshot now: forget them without
+    // deleting them from the table
+    for (auto it = m_directories.begin(); it != m_directories.end(); ) {
+        if (isExcluded(it.key())) {
+            it = m_directories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = m_savedHashes.begin(); it != m_savedHashes.end(); ) {
+        if (isExcluded(it.key())) {
+            it = m_savedHashes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool DirectorySnapshot::isExcluded(const QString &directory) const
+{
+    for (const QString &excluded : m_excludedDirectories) {
+        if (directory == excluded || directory.startsWith(joinPath(excluded, QString()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectorySnapshot::clear()
+{
+    m_directories.clear();
+    m_stats = Stats();
+}
+
+quint64 DirectorySnapshot::hashEntries(const QList<FileEntry> &files, const QStringList &subdirectories)
+{
+    // FNV-1a over the listing; order is the sorted listing order. The hash is persisted,
+    // so names are mixed byte by byte instead of with qHash(), which is seeded per process.
+    quint64 hash = 0xCBF29CE484222325ULL;
+    auto mix = [&hash](quint64 value) {
+        hash ^= value;
+        hash *= 0x100000001B3ULL;
+    };
+    auto mixName = [&mix](const QString &name) {
+        const QByteArray utf8 = name.toUtf8();
+        for (char byte : utf8) {
+            mix(static_cast<quint8>(byte));
+        }
+        mix(0);
+    };
+    for (const FileEntry &file : files) {
+        mixName(file.name);
+        mix(static_cast<quint64>(file.size));
+    }
+    mix(0xFFFFFFFFFFFFFFFFULL);
+    for (const QString &name : subdirectories) {
+        mixName(name);
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// Persistence
+// ---------------------------------------------------------------------------
+
+bool DirectorySnapshot::ensureTableExists()
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isValid() || !db.isOpen()) {
+        return false;
+    }
+    QSqlQuery q(db);
+    if (!q.exec("CREATE TABLE IF NOT EXISTS directory_snapshot ("
+                "path TEXT PRIMARY KEY,"
+                "mtime INTEGER NOT NULL,"
+                "entry_hash INTEGER NOT NULL,"
+                "entries BLOB"
+                ")")) {
+        LOG(QString("DirectorySnapshot: failed to create table: %1").arg(q.lastError().text()));
+        return false;
+    }
+    return true;
+}
+
+bool DirectorySnapshot::load(const QString &root)
+{
+    clear();
+    m_savedHashes.clear();
+    m_root = root;
+    if (!ensureTableExists()) {
+        return false;
+    }
+
+    QSqlQuery q(QSqlDatabase::database());
+    q.setForwardOnly(true);
+    if (!q.exec("SELECT path, mtime, entry_hash, entries FROM directory_snapshot")) {
+        LOG(QString("DirectorySnapshot: failed to load snapshot: %1").arg(q.lastError().text()));
+        return false;
+    }
+
+    // Rows of other roots stay in the table for when they are watched again
+    const QString prefix = joinPath(root, QString());
+    int broken = 0;
+    while (q.next()) {
+        const QString path = q.value(0).toString();
+        if ((path != root && !path.startsWith(prefix)) || isExcluded(path)) {
+            continue;
+        }
+        DirectoryEntry entry;
+        entry.mtime = q.value(1).toLongLong();
+        entry.entryHash = static_cast<quint64>(q.value(2).toLongLong());
+        if (!deserializeEntries(q.value(3).toByteArray(), entry)
+            || hashEntries(entry.files, entry.subdirectories) != entry.entryHash) {
+            // Listed again on the next refresh
+            ++broken;
+            continue;
+        }
+        m_savedHashes.insert(path, rowSignature(entry));
+        m_directories.insert(path, entry);
+    }
+    if (broken > 0) {
+        LOG(QString("DirectorySnapshot: ignored %1 unreadable row(s) below %2").arg(broken).arg(root));
+    }
+    LOG(QString("DirectorySnapshot: loaded %1 director%2 below %3")
+        .arg(m_directories.size()).arg(m_directories.size() == 1 ? "y" : "ies").arg(root));
+    return true;
+}
+
+bool DirectorySnapshot::save()
+{
+    if (m_root.isEmpty() || !ensureTableExists()) {
+        return false;
+    }
+    QSqlDatabase db = QSqlDatabase::database();
+
+    QStringList removed;
+    for (auto it = m_savedHashes.cbegin(); it != m_savedHashes.cend(); ++it) {
+        if (!m_directories.contains(it.key())) {
+            removed.append(it.key());
+        }
+    }
+    QStringList changed;
+    for (auto it = m_directories.cbegin(); it != m_directories.cend(); ++it) {
+        const auto saved = m_savedHashes.constFind(it.key());
+        if (saved == m_savedHashes.cend() || *saved != rowSignature(it.value())) {
+            changed.append(it.key());
+        }
+    }
+    if (removed.isEmpty() && changed.isEmpty()) {
+        return true;
+    }
+
+    const bool useTransaction = db.transaction();
+    QSqlQuery removeQuery(db);
+    removeQuery.prepare("DELETE FROM directory_snapshot WHERE path = ?");
+    QSqlQuery writeQuery(db);
+    writeQuery.prepare("INSERT OR REPLACE INTO directory_snapshot (path, mtime, entry_hash, entries) "
+                       "VALUES (?, ?, ?, ?)");
+
+    bool ok = true;
+    for (const QString &path : std::as_const(removed)) {
+        removeQuery.addBindValue(path);
+        if (removeQuery.exec()) {
+            m_savedHashes.remove(path);
+        } else {
+            ok = false;
+        }
+    }
+    for (const QString &path : std::as_const(changed)) {
+        const DirectoryEntry &entry = m_directories[path];
+        writeQuery.addBindValue(path);
+        writeQuery.addBindValue(entry.mtime);
+        writeQuery.addBindValue(static_cast<qint64>(entry.entryHash));
+        writeQuery.addBindValue(serializeEntries(entry));
+        if (writeQuery.exec()) {
+            m_savedHashes.insert(path, rowSignature(entry));
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        LOG(QString("DirectorySnapshot: failed to write snapshot rows: %1").arg(writeQuery.lastError().text()));
+    }
+    if (useTransaction && !db.commit()) {
+        LOG("DirectorySnapshot: failed to commit snapshot: " + db.lastError().text());
+        m_savedHashes.clear();
+        return false;
+    }
+    return ok;
+}
@@ -0,0 +1,101 @@
+#ifndef DIRECTORYSNAPSHOT_H
+#define DIRECTORYSNAPSHOT_H
+
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Persisted listing of a watched tree for incremental rescans.
+ *
+ * Stores, per directory, its mtime, its files (name and size), its
+ * subdirectories and a hash over those entries. refresh() stats every known
+ * directory but only lists the ones whose mtime changed since the snapshot;
+ * the files of unchanged directories are taken from the snapshot without
+ * touching them. Creating, deleting or renaming an entry updates the mtime of
+ * its parent directory, so a rescan of a large share costs one stat per
+ * directory plus a listing of the changed ones instead of a stat per file.
+ *
+ * Two cases are handled explicitly:
+ *   - Files recorded with size 0 (still being created) are re-stat'd on every
+ *     refresh, since writing to a file does not touch its directory.
+ *   - A directory modified within MTIME_GRANULARITY_MS of being listed is not
+ *     trusted next time (a later change in the same tick would keep its mtime).
+ *
+ * The snapshot lives in the directory_snapshot table, one row per directory;
+ * save() only writes rows whose mtime or entry hash changed. Value type: the
+ * scan worker refreshes a copy on its thread and hands it back.
+ */
+class DirectorySnapshot
+{
+public:
+    struct FileEntry {
+        QString name;
+        qint64 size = 0;
+    };
+
+    struct DirectoryEntry {
+        qint64 mtime = -1;              ///< ms since epoch; -1 forces a listing
+        QList<FileEntry> files;
+        QStringList subdirectories;     ///< names, not paths
+        quint64 entryHash = 0;          ///< over names and sizes; see hashEntries()
+    };
+
+    /// Work done by the last refresh().
+    struct Stats {
+        int directoriesChecked = 0;     ///< directories stat'd
+        int directoriesListed = 0;      ///< directories read because they changed
+        int filesChecked = 0;           ///< files stat'd (listings and size-0 entries)
+    };
+
+    static constexpr qint64 MTIME_GRANULARITY_MS = 2000;
+
+    QString root() const { return m_root; }
+    int directoryCount() const { return static_cast<int>(m_directories.size()); }
+    bool contains(const QString &directory) const { return m_directories.contains(directory); }
+    DirectoryEntry entry(const QString &directory) const { return m_directories.value(directory); }
+    Stats lastStats() const { return m_stats; }
+
+    /**
+     * @brief Bring the snapshot of @p root up to date and return its files.
+     * @param root Tree to scan; a different root than before discards the snapshot
+     * @param nowMs Current time, for the mtime granularity check
+     * @return Every non-hidden, non-symlink file below @p root with its size
+     */
+    QHash<QString, qint64> refresh(const QString &root, qint64 nowMs);
+
+    /// Forget all directories (the next refresh lists everything).
+    void clear();
+
+    /// Subtrees left to another snapshot (nested watch roots): not walked by refresh()
+    /// and not loaded, so save() leaves their rows alone.
+    void setExcludedDirectories(const QStringList &directories);
+    QStringList excludedDirectories() const { return m_excludedDirectories; }
+
+    // ── Persistence (default database connection, caller's thread) ──
+
+    static bool ensureTableExists();
+    /// Load the rows of @p root; false leaves an empty snapshot of @p root.
+    bool load(const QString &root);
+    /// Write rows changed since load()/save() and delete rows of vanished directories.
+    bool save();
+
+    static quint64 hashEntries(const QList<FileEntry> &files, const QStringList &subdirectories);
+
+private:
+    DirectoryEntry listDirectory(const QString &directory, qint64 mtime, qint64 nowMs);
+    bool isExcluded(const QString &directory) const;
+
+    QString m_root;
+    QStringList m_excludedDirectories;
+    QHash<QString, DirectoryEntry> m_directories;
+    QHash<QString, quint64> m_savedHashes;      ///< entryHash ^ mtime as last persisted
+    Stats m_stats;
+};
+
+Q_DECLARE_METATYPE(DirectorySnapshot)
+
+#endif // DIRECTORYSNAPSHOT_H
@@ -1,55 +1,80 @@
 #include "directorywatcher.h"
+#include "inotifywatcher.h"
 #include "logger.h"
 #include <QDir>
 #include <QFileInfo>
-#include <QDirIterator>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QMutexLocker>
 #include <QElapsedTimer>
+#include <QDateTime>
+#include <utility>
 
 // DirectoryScanWorker implementation
 DirectoryScanWorker::DirectoryScanWorker(const QString &directory, const QSet<QString> &processedFiles,
-                                         const QSet<QString> &knownFiles, QObject *parent)
+                                         const QSet<QString> &knownFiles, const DirectorySnapshot &snapshot,
+                                         bool statNewFiles, QObject *parent)
     : QObject(parent)
     , m_directory(directory)
     , m_processedFiles(processedFiles)
     , m_knownFiles(knownFiles)
+    , m_snapshot(snapshot)
+    , m_statNewFiles(statNewFiles)
 {
 }
 
 void DirectoryScanWorker::scan()
 {
     QStringList newFiles;
+    QList<FileStabilityTracker::Observation> newFileStates;
     QStringList deletedFiles;
     
     if (m_directory.isEmpty() || !QDir(m_directory).exists()) {
-        emit scanComplete(newFiles, deletedFiles);
+        emit scanComplete(newFiles, newFileStates, deletedFiles, m_snapshot);
         return;
     }
     
-    // Scan for all files in the directory (no extension filtering - let API decide)
-    QSet<QString> currentFiles;
-    QDirIterator it(m_directory, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
-    
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        QFileInfo fileInfo(filePath);
-        currentFiles.insert(filePath);
-        
+    // All files in the tree (no extension filtering - let API decide). Only directories
+    // whose mtime changed since the snapshot are listed; the rest come from the snapshot.
+    QElapsedTimer timer;
+    timer.start();
+    const QHash<QString, qint64> currentFiles = m_snapshot.refresh(m_directory, QDateTime::currentMSecsSinceEpoch());
+    const DirectorySnapshot::Stats stats = m_snapshot.lastStats();
+    LOG(QString("DirectoryWatcher: Scanned %1 files in %2 ms (%3 of %4 directories listed)")
+        .arg(currentFiles.size()).arg(timer.elapsed())
+        .arg(stats.directoriesListed).arg(stats.directoriesChecked));
+    
+    for (auto it = currentFiles.cbegin(); it != currentFiles.cend(); ++it) {
         // Skip if already processed
-        if (m_processedFiles.contains(filePath)) {
+        if (m_processedFiles.contains(it.key())) {
             continue;
         }
         
         // Skip empty files
-        if (fileInfo.size() == 0) {
+        if (it.value() == 0) {
             continue;
         }
         
-        newFiles.append(filePath);
+        // First look for the stability check, taken here so the GUI thread does not stat
+        // every new file; without a quiet period the size from the listing is enough
+        FileStabilityTracker::Observation state;
+        if (m_statNewFiles) {
+            const QFileInfo info(it.key());
+            state.exists = info.exists() && info.isFile();
+            state.size = info.size();
+            state.mtime = info.lastModified().toMSecsSinceEpoch();
+        } else {
+            state.exists = true;
+            state.size = it.value();
+        }
+        if (!state.exists || state.size == 0) {
+            continue;
+        }
+        
+        newFiles.append(it.key());
+        newFileStates.append(state);
     }
     
     // Detect deleted files: known files that no longer exist on disk
@@ -59,15 +84,18 @@ void DirectoryScanWorker::scan()
         }
     }
     
-    emit scanComplete(newFiles, deletedFiles);
+    emit scanComplete(newFiles, newFileStates, deletedFiles, m_snapshot);
 }
 
 // DirectoryWatcher implementation
 DirectoryWatcher::DirectoryWatcher(QObject *parent)
     : QObject(parent)
     , m_watcher(new QFileSystemWatcher(this))
+    , m_nativeWatcher(InotifyWatcher::isSupported() ? new InotifyWatcher(this) : nullptr)
     , m_debounceTimer(new QTimer(this))
     , m_initialScanTimer(new QTimer(this))
+    , m_stabilityTimer(new QTimer(this))
+    , m_rescanTimer(new QTimer(this))
     , m_isWatching(false)
     , m_scanThread(nullptr)
     , m_scanInProgress(false)
@@ -80,6 +108,10 @@ DirectoryWatcher::DirectoryWatcher(QObject *parent)
     m_initialScanTimer->setSingleShot(true);
     m_initialScanTimer->setInterval(100); // Short delay to avoid UI freeze
     
+    // Files are held back until they are completely written (see FileStabilityTracker)
+    m_stabilityTimer->setSingleShot(true);
+    m_stability.setQuietPeriod(0);
+    
     connect(m_watcher, &QFileSystemWatcher::directoryChanged,
             this, &DirectoryWatcher::onDirectoryChanged);
     connect(m_watcher, &QFileSystemWatcher::fileChanged,
@@ -88,6 +120,16 @@ DirectoryWatcher::DirectoryWatcher(QObject *parent)
             this, &DirectoryWatcher::checkForNewFiles);
     connect(m_initialScanTimer, &QTimer::timeout,
             this, &DirectoryWatcher::checkForNewFiles);
+    connect(m_stabilityTimer, &QTimer::timeout,
+            this, &DirectoryWatcher::releaseStableFiles);
+    connect(m_rescanTimer, &QTimer::timeout,
+            this, &DirectoryWatcher::checkForNewFiles);
+    if (m_nativeWatcher) {
+        connect(m_nativeWatcher, &InotifyWatcher::changesReady,
+                this, &DirectoryWatcher::onNativeChanges);
+        connect(m_nativeWatcher, &InotifyWatcher::treeWatched,
+                this, &DirectoryWatcher::onNativeTreeWatched);
+    }
 }
 
 DirectoryWatcher::~DirectoryWatcher()
@@ -116,14 +158,30 @@ void DirectoryWatcher::startWatching(const QString &directory)
     stopWatching();
     
     m_watchedDirectory = directory;
-    m_watcher->addPath(directory);
     m_isWatching = true;
     
+    // Prefer exact per-file events; fall back to QFileSystemWatcher + full rescans.
+    // The native backend registers the tree in the background (see onNativeTreeWatched)
+    if (m_nativeWatcher && m_nativeWatcher->start(directory)) {
+        LOG("DirectoryWatcher: Using inotify backend");
+    } else {
+        m_watcher->addPath(directory);
+    }
+    
     // Load previously processed files
     loadProcessedFiles();
     
-    // Defer initial scan to avoid UI freeze
-    m_initialScanTimer->start();
+    // Load the last listing of the tree so the initial scan only lists changed directories
+    m_snapshot.load(directory);
+    
+    // Defer initial scan to avoid UI freeze; with inotify it waits until every
+    // directory is watched, so nothing changes unseen between the scan and the watches
+    if (!usesNativeBackend()) {
+        m_initialScanTimer->start();
+    }
+    if (m_rescanTimer->interval() > 0) {
+        m_rescanTimer->start();
+    }
 }
 
 void DirectoryWatcher::stopWatching()
@@ -142,10 +200,26 @@ void DirectoryWatcher::stopWatching()
         m_watcher->removePaths(files);
     }
     
+    if (m_nativeWatcher) {
+        m_nativeWatcher->stop();
+    }
+    
     m_watchedDirectory.clear();
     m_isWatching = false;
     m_debounceTimer->stop();
     m_initialScanTimer->stop();
+    m_stabilityTimer->stop();
+    m_rescanTimer->stop();
+    
+    // Files still being written are detected again by the next scan
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &filePath : m_stability.pendingFiles()) {
+            m_processedFiles.remove(filePath);
+            m_knownFiles.remove(filePath);
+        }
+    }
+    m_stability.clear();
     
     LOG("DirectoryWatcher: Stopped watching");
 }
@@ -160,6 +234,98 @@ QString DirectoryWatcher::watchedDirectory() const
     return m_watchedDirectory;
 }
 
+bool DirectoryWatcher::usesNativeBackend() const
+{
+    return m_nativeWatcher && m_nativeWatcher->isActive();
+}
+
+void DirectoryWatcher::setStabilityDelay(int ms)
+{
+    m_stability.setQuietPeriod(ms);
+    scheduleStabilityCheck();
+}
+
+int DirectoryWatcher::stabilityDelay() const
+{
+    return static_cast<int>(m_stability.quietPeriod());
+}
+
+int DirectoryWatcher::pendingStabilityCount() const
+{
+    return m_stability.pendingCount();
+}
+
+void DirectoryWatcher::setScanInterval(int ms)
+{
+    m_rescanTimer->setInterval(qMax(0, ms));
+    if (m_isWatching && ms > 0) {
+        m_rescanTimer->start();
+    } else {
+        m_rescanTimer->stop();
+    }
+}
+
+int DirectoryWatcher::scanInterval() const
+{
+    return m_rescanTimer->interval();
+}
+
+void DirectoryWatcher::setExcludedDirectories(const QStringList &directories)
+{
+    if (directories == m_excludedDirectories) {
+        return;
+    }
+    m_excludedDirectories = directories;
+    m_snapshot.setExcludedDirectories(directories);
+    if (!m_isWatching) {
+        return;
+    }
+    
+    // Files below a newly nested root are the nested root's watcher's now; without
+    // this the next scan would report them as deleted
+    for (const QString &filePath : m_stability.pendingFiles()) {
+        if (isExcluded(filePath)) {
+            m_stability.remove(filePath);
+        }
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_processedFiles.begin(); it != m_processedFiles.end(); ) {
+            if (isExcluded(*it)) {
+                it = m_processedFiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = m_knownFiles.begin(); it != m_knownFiles.end(); ) {
+            if (isExcluded(*it)) {
+                it = m_knownFiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // Files of a subtree that is no longer excluded were reported by the removed root
+    loadProcessedFiles();
+    scheduleStabilityCheck();
+}
+
+QStringList DirectoryWatcher::excludedDirectories() const
+{
+    return m_excludedDirectories;
+}
+
+bool DirectoryWatcher::isExcluded(const QString &filePath) const
+{
+    for (const QString &directory : m_excludedDirectories) {
+        const QString prefix = directory.endsWith('/') ? directory : directory + '/';
+        if (filePath.startsWith(prefix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void DirectoryWatcher::onDirectoryChanged(const QString &path)
 {
     LOG(QString("DirectoryWatcher: Directory changed: %1").arg(path));
@@ -219,14 +385,25 @@ void DirectoryWatcher::scanDirectory()
     
     // Create new thread and worker
     m_scanThread = new QThread(this);
-    DirectoryScanWorker *worker = new DirectoryScanWorker(m_watchedDirectory, processedFilesCopy, knownFilesCopy);
+    DirectoryScanWorker *worker = new DirectoryScanWorker(m_watchedDirectory, processedFilesCopy, knownFilesCopy, m_snapshot,
+                                                          m_stability.quietPeriod() > 0);
     worker->moveToThread(m_scanThread);
     
     // Connect signals
     connect(m_scanThread, &QThread::started, worker, &DirectoryScanWorker::scan);
-    connect(worker, &DirectoryScanWorker::scanComplete, this, [this](const QStringList &newFiles, const QStringList &deletedFiles) {
+    connect(worker, &DirectoryScanWorker::scanComplete, this,
+            [this](const QStringList &newFiles, const QList<FileStabilityTracker::Observation> &newFileStates,
+                   const QStringList &deletedFiles, const DirectorySnapshot &snapshot) {
         m_scanInProgress = false;
-        onScanComplete(newFiles, deletedFiles);
+        // Ignore the listing if the watched directory changed while scanning
+        if (snapshot.root() == m_watchedDirectory) {
+            m_snapshot = snapshot;
+            if (m_snapshot.excludedDirectories() != m_excludedDirectories) {
+                m_snapshot.setExcludedDirectories(m_excludedDirectories);
+            }
+            m_snapshot.save();
+        }
+        onScanComplete(newFiles, newFileStates, deletedFiles);
     });
     connect(worker, &DirectoryScanWorker::scanComplete, m_scanThread, &QThread::quit);
     connect(m_scanThread, &QThread::finished, worker, &QObject::deleteLater);
@@ -235,8 +412,127 @@ void DirectoryWatcher::scanDirectory()
     m_scanThread->start();
 }
 
-void DirectoryWatcher::onScanComplete(const QStringList &newFiles, const QStringList &deletedFiles)
+void DirectoryWatcher::onNativeChanges()
+{
+    if (!m_isWatching || !m_nativeWatcher) {
+        return;
+    }
+    
+    const FileChangeQueue::Batch batch = m_nativeWatcher->takeChanges();
+    if (batch.overflow) {
+        // Events were lost: fall back to one full rescan
+        scanDirectory();
+        return;
+    }
+    
+    // Only the changed paths are looked at; no walk of the tree
+    QStringList newFiles;
+    QList<FileStabilityTracker::Observation> newFileStates;
+    QStringList deletedFiles;
+    QStringList closedFiles;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QStringList *present : {&batch.createdFiles, &batch.completedFiles}) {
+            for (const QString &filePath : *present) {
+                if (present == &batch.completedFiles) {
+                    // Close-write: the fast path to "completely written"
+                    closedFiles.append(filePath);
+                }
+                if (m_processedFiles.contains(filePath)) {
+                    continue;
+                }
+                QFileInfo fileInfo(filePath);
+                // Same rules as the full scan: skip symlinks and (still) empty files
+                if (!fileInfo.exists() || fileInfo.isSymLink() || fileInfo.size() == 0) {
+                    continue;
+                }
+                FileStabilityTracker::Observation state;
+                state.exists = true;
+                state.size = fileInfo.size();
+                state.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+                newFiles.append(filePath);
+                newFileStates.append(state);
+            }
+        }
+        for (const QString &filePath : batch.removedFiles) {
+            if (m_knownFiles.contains(filePath)) {
+                deletedFiles.append(filePath);
+            }
+        }
+        for (const QString &directory : batch.removedDirectories) {
+            const QString prefix = directory.endsWith('/') ? directory : directory + '/';
+            for (const QString &knownFile : std::as_const(m_knownFiles)) {
+                if (knownFile.startsWith(prefix) && !deletedFiles.contains(knownFile)) {
+                    deletedFiles.append(knownFile);
+                }
+            }
+        }
+    }
+    
+    if (!newFiles.isEmpty() || !deletedFiles.isEmpty()) {
+        onScanComplete(newFiles, newFileStates, deletedFiles);
+    }
+    
+    if (!closedFiles.isEmpty()) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (const QString &filePath : std::as_const(closedFiles)) {
+            if (m_stability.contains(filePath)) {
+                m_stability.noteClosed(filePath, now);
+            }
+        }
+        scheduleStabilityCheck();
+    }
+}
+
+void DirectoryWatcher::onNativeTreeWatched(bool complete)
+{
+    if (!m_isWatching) {
+        return;
+    }
+    
+    if (!complete) {
+        // Watch limit too low for the tree: the inotify watcher stopped itself
+        LOG("DirectoryWatcher: Falling back to QFileSystemWatcher");
+        m_watcher->addPath(m_watchedDirectory);
+    }
+    m_initialScanTimer->start();
+}
+
+void DirectoryWatcher::onScanComplete(const QStringList &scannedNewFiles,
+                                      const QList<FileStabilityTracker::Observation> &scannedNewFileStates,
+                                      const QStringList &scannedDeletedFiles)
 {
+    // A scan works on a copy of the sets; drop what the native backend already reported meanwhile.
+    // The native backend also sees the trees of nested roots, which their own watchers report.
+    QStringList newFiles;
+    QList<FileStabilityTracker::Observation> newFileStates;
+    QStringList deletedFiles;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < scannedNewFiles.size(); ++i) {
+            if (!m_processedFiles.contains(scannedNewFiles.at(i)) && !isExcluded(scannedNewFiles.at(i))) {
+                newFiles.append(scannedNewFiles.at(i));
+                newFileStates.append(scannedNewFileStates.value(i));
+            }
+        }
+        for (const QString &filePath : scannedDeletedFiles) {
+            if (m_knownFiles.contains(filePath)) {
+                deletedFiles.append(filePath);
+            }
+        }
+    }
+    
+    // Files that vanish while still being written were never reported
+    for (int i = deletedFiles.size() - 1; i >= 0; --i) {
+        if (m_stability.contains(deletedFiles.at(i))) {
+            m_stability.remove(deletedFiles.at(i));
+            QMutexLocker locker(&m_mutex);
+            m_knownFiles.remove(deletedFiles.at(i));
+            m_processedFiles.remove(deletedFiles.at(i));
+            deletedFiles.removeAt(i);
+        }
+    }
+    
     // Handle deleted files
     if (!deletedFiles.isEmpty()) {
         LOG(QString("DirectoryWatcher: Detected %1 deleted file(s)").arg(deletedFiles.size()));
@@ -250,9 +546,11 @@ void DirectoryWatcher::onScanComplete(const QStringList &newFiles, const QString
         }
         
         // Remove deleted files from file watcher
-        for (const QString &filePath : deletedFiles) {
-            if (m_watcher->files().contains(filePath)) {
-                m_watcher->removePath(filePath);
+        if (!usesNativeBackend()) {
+            for (const QString &filePath : deletedFiles) {
+                if (m_watcher->files().contains(filePath)) {
+                    m_watcher->removePath(filePath);
+                }
             }
         }
         
@@ -279,15 +577,48 @@ void DirectoryWatcher::onScanComplete(const QStringList &newFiles, const QString
     }
     LOG("DirectoryWatcher: Finished adding files to m_processedFiles set");
     
-    // Add files to watcher to monitor for changes
-    QStringList watchedFilesList = m_watcher->files();
-    QSet<QString> currentlyWatchedFiles(watchedFilesList.begin(), watchedFilesList.end());
-    for (const QString &filePath : newFiles) {
-        if (!currentlyWatchedFiles.contains(filePath)) {
-            m_watcher->addPath(filePath);
+    // Add files to watcher to monitor for changes (the native backend already sees them)
+    if (!usesNativeBackend()) {
+        QStringList watchedFilesList = m_watcher->files();
+        QSet<QString> currentlyWatchedFiles(watchedFilesList.begin(), watchedFilesList.end());
+        for (const QString &filePath : newFiles) {
+            if (!currentlyWatchedFiles.contains(filePath)) {
+                m_watcher->addPath(filePath);
+            }
         }
     }
     
+    // Hold the files back until they are completely written; files already quiet in
+    // the state seen by the scan are released without another stat
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < newFiles.size(); ++i) {
+        m_stability.add(newFiles.at(i), now, newFileStates.at(i));
+    }
+    releaseStableFiles();
+}
+
+void DirectoryWatcher::releaseStableFiles()
+{
+    QStringList vanished;
+    const QStringList newFiles = m_stability.poll(QDateTime::currentMSecsSinceEpoch(), &vanished);
+    
+    // Gone before being complete (e.g. a renamed temporary file): forget it quietly
+    for (const QString &filePath : std::as_const(vanished)) {
+        QMutexLocker locker(&m_mutex);
+        m_knownFiles.remove(filePath);
+        m_processedFiles.remove(filePath);
+    }
+    scheduleStabilityCheck();
+    
+    if (newFiles.isEmpty()) {
+        return;
+    }
+    
+    if (m_stability.pendingCount() > 0) {
+        LOG(QString("DirectoryWatcher: %1 file(s) complete, %2 still being written")
+            .arg(newFiles.size()).arg(m_stability.pendingCount()));
+    }
+    
     // Save to database if available
     QSqlDatabase db = QSqlDatabase::database();
     if (db.isValid() && db.isOpen()) {
@@ -317,6 +648,17 @@ void DirectoryWatcher::onScanComplete(const QStringList &newFiles, const QString
     emit newFilesDetected(newFiles);
 }
 
+void DirectoryWatcher::scheduleStabilityCheck()
+{
+    const qint64 next = m_stability.nextCheckMs();
+    if (next < 0) {
+        m_stabilityTimer->stop();
+        return;
+    }
+    const qint64 delay = next - QDateTime::currentMSecsSinceEpoch();
+    m_stabilityTimer->start(static_cast<int>(qBound<qint64>(0, delay, FileStabilityTracker::MAX_POLL_MS)));
+}
+
 void DirectoryWatcher::loadProcessedFiles()
 {
     QSqlDatabase db = QSqlDatabase::database();
@@ -325,6 +667,10 @@ void DirectoryWatcher::loadProcessedFiles()
         return;
     }
     
+    // Only files below the watched directory and outside nested roots; files of other
+    // roots (or added by hand) would otherwise be reported as deleted by the first scan
+    const QString prefix = m_watchedDirectory.endsWith('/') ? m_watchedDirectory : m_watchedDirectory + '/';
+    
     QSqlQuery query(db);
     
     // Query only files that have been checked by API (status >= 2)
@@ -340,7 +686,7 @@ void DirectoryWatcher::loadProcessedFiles()
     
     while (query.next()) {
         QString filePath = query.value(0).toString();
-        if (!filePath.isEmpty()) {
+        if (filePath.startsWith(prefix) && !isExcluded(filePath)) {
             m_processedFiles.insert(filePath);
             m_knownFiles.insert(filePath);
         }
@@ -360,7 +706,7 @@ void DirectoryWatcher::loadProcessedFiles()
     
     while (knownQuery.next()) {
         QString filePath = knownQuery.value(0).toString();
-        if (!filePath.isEmpty()) {
+        if (filePath.startsWith(prefix) && !isExcluded(filePath)) {
             m_knownFiles.insert(filePath);
         }
     }
@@ -9,6 +9,10 @@
 #include <QTimer>
 #include <QThread>
 #include <QMutex>
+#include "directorysnapshot.h"
+#include "filestabilitytracker.h"
+
+class InotifyWatcher;
 
 // Worker class for background directory scanning
 class DirectoryScanWorker : public QObject
@@ -16,19 +20,26 @@ class DirectoryScanWorker : public QObject
     Q_OBJECT
     
 public:
+    // statNewFiles: also read the mtime of new files (for a stability quiet period)
     DirectoryScanWorker(const QString &directory, const QSet<QString> &processedFiles,
-                        const QSet<QString> &knownFiles, QObject *parent = nullptr);
+                        const QSet<QString> &knownFiles, const DirectorySnapshot &snapshot,
+                        bool statNewFiles, QObject *parent = nullptr);
     
 public slots:
     void scan();
     
 signals:
-    void scanComplete(const QStringList &newFiles, const QStringList &deletedFiles);
+    // snapshot is the refreshed copy, handed back for persisting on the watcher's thread;
+    // newFileStates holds the size and mtime seen for each of newFiles
+    void scanComplete(const QStringList &newFiles, const QList<FileStabilityTracker::Observation> &newFileStates,
+                      const QStringList &deletedFiles, const DirectorySnapshot &snapshot);
     
 private:
     QString m_directory;
     QSet<QString> m_processedFiles;
     QSet<QString> m_knownFiles;
+    DirectorySnapshot m_snapshot;
+    bool m_statNewFiles;
 };
 
 class DirectoryWatcher : public QObject
@@ -47,6 +58,26 @@ public:
     // Get current watched directory
     QString watchedDirectory() const;
     
+    // True when changes come from the native recursive backend (inotify) instead of
+    // QFileSystemWatcher plus a full rescan per change
+    bool usesNativeBackend() const;
+    
+    // Quiet period before a new file counts as completely written and is reported
+    // (0 = report at once); close-write events shorten the wait on Linux
+    void setStabilityDelay(int ms);
+    int stabilityDelay() const;
+    // Detected files still waiting to be completely written
+    int pendingStabilityCount() const;
+    
+    // Full rescan of the tree every ms milliseconds in addition to change notifications
+    // (0 = off); for mounts that deliver no notifications, such as network shares
+    void setScanInterval(int ms);
+    int scanInterval() const;
+    
+    // Subtrees of nested watch roots; their own watchers report the files below them
+    void setExcludedDirectories(const QStringList &directories);
+    QStringList excludedDirectories() const;
+    
 signals:
     // Emitted when new files are detected and ready to be hashed
     void newFilesDetected(const QStringList &filePaths);
@@ -57,21 +88,35 @@ private slots:
     void onDirectoryChanged(const QString &path);
     void onFileChanged(const QString &path);
     void checkForNewFiles();
-    void onScanComplete(const QStringList &newFiles, const QStringList &deletedFiles);
+    void onScanComplete(const QStringList &newFiles, const QList<FileStabilityTracker::Observation> &newFileStates,
+                        const QStringList &deletedFiles);
+    void onNativeChanges();
+    void onNativeTreeWatched(bool complete);
+    void releaseStableFiles();
     
 private:
     QFileSystemWatcher *m_watcher;
+    InotifyWatcher *m_nativeWatcher;
     QString m_watchedDirectory;
     QSet<QString> m_processedFiles;
     QSet<QString> m_knownFiles;
+    QStringList m_excludedDirectories;
     QTimer *m_debounceTimer;
     QTimer *m_initialScanTimer;
+    QTimer *m_stabilityTimer;
+    QTimer *m_rescanTimer;
     bool m_isWatching;
     QThread *m_scanThread;
     bool m_scanInProgress;
     QMutex m_mutex;
+    // Last listing of the watched tree; lets scans skip directories whose mtime is unchanged
+    DirectorySnapshot m_snapshot;
+    // New files not yet reported because they may still be written
+    FileStabilityTracker m_stability;
     
     void scanDirectory();
+    void scheduleStabilityCheck();
+    bool isExcluded(const QString &filePath) const;
     void loadProcessedFiles();
     void saveProcessedFile(const QString &filePath);
 };
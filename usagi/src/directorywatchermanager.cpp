@@ -2,38 +2,65 @@
 
 #include <QDir>
 #include <QFileDialog>
+#include <QHeaderView>
 #include <QSignalBlocker>
+#include <QSpinBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <utility>
 
 #include "anidbapi.h"
 #include "directorywatcher.h"
 #include "logger.h"
 #include "watchsessionmanager.h"
 
+namespace {
+
+enum RootColumn {
+    ColumnPath,
+    ColumnScanInterval,
+    ColumnStabilityDelay,
+    ColumnMaxHashers,
+    ColumnPriority,
+    ColumnCount
+};
+
+QSpinBox *createSpinBox(int minimum, int maximum, int value, const QString &suffix,
+                        const QString &specialValueText = QString())
+{
+    QSpinBox *spinBox = new QSpinBox;
+    spinBox->setRange(minimum, maximum);
+    spinBox->setValue(value);
+    spinBox->setSuffix(suffix);
+    spinBox->setSpecialValueText(specialValueText);
+    return spinBox;
+}
+
+} // namespace
+
 DirectoryWatcherManager::DirectoryWatcherManager(AniDBApi *api, QObject *parent)
     : QObject(parent),
       m_api(api),
-      m_directoryWatcher(new DirectoryWatcher(this)),
       m_watchSessionManager(nullptr),
+      m_roots(),
+      m_watchers(),
       m_settingsGroup(nullptr),
       m_watcherEnabled(nullptr),
       m_watcherAutoStart(nullptr),
       m_watcherStatusLabel(nullptr),
-      m_watcherDirectory(nullptr),
-      m_watcherBrowseButton(nullptr),
+      m_rootsTable(nullptr),
+      m_addRootButton(nullptr),
+      m_removeRootButton(nullptr),
       m_pendingWatchPath()
 {
     createUi();
 
     connect(m_watcherEnabled, &QCheckBox::checkStateChanged,
             this, &DirectoryWatcherManager::onWatcherEnabledChanged);
-    connect(m_watcherBrowseButton, &QPushButton::clicked,
-            this, &DirectoryWatcherManager::onWatcherBrowseClicked);
-    connect(m_directoryWatcher, &DirectoryWatcher::newFilesDetected,
-            this, &DirectoryWatcherManager::newFilesDetected);
-    connect(m_directoryWatcher, &DirectoryWatcher::filesDeleted,
-            this, &DirectoryWatcherManager::filesDeleted);
+    connect(m_addRootButton, &QPushButton::clicked,
+            this, &DirectoryWatcherManager::onAddRootClicked);
+    connect(m_removeRootButton, &QPushButton::clicked,
+            this, &DirectoryWatcherManager::onRemoveRootClicked);
 }
 
 DirectoryWatcherManager::~DirectoryWatcherManager() = default;
@@ -47,40 +74,159 @@ void DirectoryWatcherManager::createUi()
     m_watcherAutoStart = new QCheckBox("Auto-start on application launch");
     m_watcherStatusLabel = new QLabel("Status: Not watching");
 
-    QHBoxLayout *watcherDirLayout = new QHBoxLayout();
-    m_watcherDirectory = new QLineEdit;
-    m_watcherBrowseButton = new QPushButton("Browse...");
-
-    watcherDirLayout->addWidget(new QLabel("Watch Directory:"));
-    watcherDirLayout->addWidget(m_watcherDirectory, 1);
-    watcherDirLayout->addWidget(m_watcherBrowseButton);
+    // One row per watched root; the numeric columns are edited in place
+    m_rootsTable = new QTableWidget(0, ColumnCount);
+    m_rootsTable->setHorizontalHeaderLabels({"Directory", "Rescan every", "Wait for writes",
+                                             "Max hashers", "Priority"});
+    m_rootsTable->horizontalHeaderItem(ColumnScanInterval)->setToolTip(
+        "Full rescan interval for mounts without change notifications (network shares). Off: only on changes.");
+    m_rootsTable->horizontalHeaderItem(ColumnStabilityDelay)->setToolTip(
+        "New files are hashed once they have not changed for this long. "
+        "On Linux, files closed after writing are hashed sooner.");
+    m_rootsTable->horizontalHeaderItem(ColumnMaxHashers)->setToolTip(
+        "Files of this directory hashed at the same time. Limit slow mounts so they leave threads to the others.");
+    m_rootsTable->horizontalHeaderItem(ColumnPriority)->setToolTip(
+        "Files of directories with a higher priority are hashed first.");
+    m_rootsTable->horizontalHeader()->setSectionResizeMode(ColumnPath, QHeaderView::Stretch);
+    for (int column = ColumnScanInterval; column < ColumnCount; ++column) {
+        m_rootsTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+    }
+    m_rootsTable->verticalHeader()->setVisible(false);
+    m_rootsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_rootsTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_rootsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QHBoxLayout *rootButtonsLayout = new QHBoxLayout();
+    m_addRootButton = new QPushButton("Add Directory...");
+    m_removeRootButton = new QPushButton("Remove");
+    rootButtonsLayout->addWidget(new QLabel("Watch Directories:"));
+    rootButtonsLayout->addStretch(1);
+    rootButtonsLayout->addWidget(m_addRootButton);
+    rootButtonsLayout->addWidget(m_removeRootButton);
 
     watcherLayout->addWidget(m_watcherEnabled);
-    watcherLayout->addLayout(watcherDirLayout);
+    watcherLayout->addLayout(rootButtonsLayout);
+    watcherLayout->addWidget(m_rootsTable);
     watcherLayout->addWidget(m_watcherAutoStart);
     watcherLayout->addWidget(m_watcherStatusLabel);
 }
 
+void DirectoryWatcherManager::populateRootsTable()
+{
+    m_rootsTable->setRowCount(0);
+    for (const WatchRoot &root : std::as_const(m_roots)) {
+        addRootRow(root);
+    }
+}
+
+void DirectoryWatcherManager::addRootRow(const WatchRoot &root)
+{
+    const int row = m_rootsTable->rowCount();
+    m_rootsTable->insertRow(row);
+
+    QTableWidgetItem *pathItem = new QTableWidgetItem(root.path);
+    pathItem->setToolTip(root.path);
+    m_rootsTable->setItem(row, ColumnPath, pathItem);
+
+    QSpinBox *scanInterval = createSpinBox(0, 24 * 3600, root.scanIntervalSecs, " s", "Off");
+    QSpinBox *stabilityDelay = createSpinBox(0, 3600, root.stabilityDelaySecs, " s");
+    QSpinBox *maxHashers = createSpinBox(0, 16, root.maxHashers, QString(), "No limit");
+    QSpinBox *priority = createSpinBox(-100, 100, root.priority, QString());
+
+    const QString path = root.path;
+    const QList<std::pair<int, QSpinBox *>> cells = {
+        {ColumnScanInterval, scanInterval},
+        {ColumnStabilityDelay, stabilityDelay},
+        {ColumnMaxHashers, maxHashers},
+        {ColumnPriority, priority},
+    };
+    for (const auto &cell : cells) {
+        m_rootsTable->setCellWidget(row, cell.first, cell.second);
+        const int column = cell.first;
+        connect(cell.second, QOverload<int>::of(&QSpinBox::valueChanged), this, [this, path, column](int value) {
+            setRootValue(path, column, value);
+        });
+    }
+}
+
+void DirectoryWatcherManager::setRootValue(const QString &path, int column, int value)
+{
+    const int index = indexOfRoot(path);
+    if (index < 0) {
+        return;
+    }
+    WatchRoot &root = m_roots[index];
+    switch (column) {
+    case ColumnScanInterval:
+        root.scanIntervalSecs = value;
+        break;
+    case ColumnStabilityDelay:
+        root.stabilityDelaySecs = value;
+        break;
+    case ColumnMaxHashers:
+        root.maxHashers = value;
+        break;
+    case ColumnPriority:
+        root.priority = value;
+        break;
+    default:
+        return;
+    }
+
+    if (DirectoryWatcher *watcher = m_watchers.value(path)) {
+        applyRootPolicy(watcher, root);
+    }
+    emit watchRootsChanged(m_roots);
+}
+
+int DirectoryWatcherManager::indexOfRoot(const QString &path) const
+{
+    for (int i = 0; i < m_roots.size(); ++i) {
+        if (m_roots.at(i).path == path) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DirectoryWatcherManager::rootsChanged()
+{
+    if (m_watcherEnabled->isChecked()) {
+        startWatching();
+    } else if (!m_roots.isEmpty()) {
+        syncWatchSessionPath(m_roots.first().path);
+    }
+    emit watchRootsChanged(m_roots);
+}
+
 void DirectoryWatcherManager::loadSettingsFromApi()
 {
     const bool watcherEnabledSetting = m_api ? m_api->getWatcherEnabled() : false;
-    const QString watcherDir = m_api ? m_api->getWatcherDirectory() : QString();
     const bool watcherAutoStartSetting = m_api ? m_api->getWatcherAutoStart() : false;
 
+    m_roots = m_api ? WatchRoot::fromJson(m_api->getWatcherRoots()) : QList<WatchRoot>();
+    if (m_roots.isEmpty() && m_api && !m_api->getWatcherDirectory().isEmpty()) {
+        // Settings from before multiple roots: the single directory becomes the first root
+        WatchRoot root;
+        root.path = QDir::cleanPath(m_api->getWatcherDirectory());
+        root.stabilityDelaySecs = m_api->getWatcherStabilityDelay();
+        m_roots.append(root);
+    }
+
     const QSignalBlocker blockEnabled(m_watcherEnabled);
-    const QSignalBlocker blockDirectory(m_watcherDirectory);
     const QSignalBlocker blockAutoStart(m_watcherAutoStart);
 
     m_watcherEnabled->setChecked(watcherEnabledSetting);
-    m_watcherDirectory->setText(watcherDir);
     m_watcherAutoStart->setChecked(watcherAutoStartSetting);
+    populateRootsTable();
+    emit watchRootsChanged(m_roots);
 
     // Keep WatchSessionManager in sync with current path even before auto-start.
-    if (watcherEnabledSetting && !watcherDir.isEmpty()) {
-        syncWatchSessionPath(watcherDir);
+    if (watcherEnabledSetting && !m_roots.isEmpty()) {
+        syncWatchSessionPath(m_roots.first().path);
     }
 
-    if (watcherEnabledSetting && watcherDir.isEmpty()) {
+    if (watcherEnabledSetting && m_roots.isEmpty()) {
         setStatusText("Status: Enabled (no directory set)");
     } else {
         setStatusText("Status: Not watching");
@@ -94,22 +240,23 @@ void DirectoryWatcherManager::saveSettingsToApi()
     }
 
     m_api->setWatcherEnabled(m_watcherEnabled->isChecked());
-    m_api->setWatcherDirectory(m_watcherDirectory->text());
+    m_api->setWatcherRoots(WatchRoot::toJson(m_roots));
+    // Older readers of the single directory setting see the primary root
+    m_api->setWatcherDirectory(watchedDirectory());
     m_api->setWatcherAutoStart(m_watcherAutoStart->isChecked());
 }
 
 void DirectoryWatcherManager::applyStartupBehavior()
 {
     const bool watcherEnabledSetting = m_watcherEnabled->isChecked();
-    const QString watcherDir = m_watcherDirectory->text();
     const bool watcherAutoStartSetting = m_watcherAutoStart->isChecked();
 
-    if (watcherEnabledSetting && watcherAutoStartSetting && !watcherDir.isEmpty()) {
-        startWatching(watcherDir);
-    } else if (watcherEnabledSetting && !watcherDir.isEmpty()) {
+    if (watcherEnabledSetting && watcherAutoStartSetting && !m_roots.isEmpty()) {
+        startWatching();
+    } else if (watcherEnabledSetting && !m_roots.isEmpty()) {
         setStatusText("Status: Enabled (not auto-started)");
-        syncWatchSessionPath(watcherDir);
-    } else if (watcherEnabledSetting && watcherDir.isEmpty()) {
+        syncWatchSessionPath(m_roots.first().path);
+    } else if (watcherEnabledSetting && m_roots.isEmpty()) {
         setStatusText("Status: Enabled (no directory set)");
     } else {
         setStatusText("Status: Not watching");
@@ -128,54 +275,144 @@ void DirectoryWatcherManager::setWatchSessionManager(WatchSessionManager *manage
 
 QString DirectoryWatcherManager::watchedDirectory() const
 {
-    return m_watcherDirectory->text();
+    return m_roots.isEmpty() ? QString() : m_roots.first().path;
 }
 
 void DirectoryWatcherManager::onWatcherEnabledChanged(Qt::CheckState state)
 {
     if (state == Qt::CheckState::Checked) {
-        const QString dir = m_watcherDirectory->text();
-        if (!dir.isEmpty() && QDir(dir).exists()) {
-            startWatching(dir);
-        } else if (dir.isEmpty()) {
+        if (!m_roots.isEmpty()) {
+            startWatching();
+        } else {
             setStatusText("Status: Enabled (no directory set)");
             LOG("Directory watcher enabled but no directory specified");
-        } else {
-            setStatusText("Status: Enabled (invalid directory)");
-            LOG("Directory watcher enabled but directory is invalid: " + dir);
         }
     } else {
-        m_directoryWatcher->stopWatching();
+        stopWatching();
         setStatusText("Status: Not watching");
         LOG("Directory watcher stopped");
     }
 }
 
-void DirectoryWatcherManager::onWatcherBrowseClicked()
+void DirectoryWatcherManager::onAddRootClicked()
 {
     const QString dir = QFileDialog::getExistingDirectory(
         m_settingsGroup,
         "Select Directory to Watch",
-        m_watcherDirectory->text().isEmpty() ? QDir::homePath() : m_watcherDirectory->text());
+        m_roots.isEmpty() ? QDir::homePath() : m_roots.last().path);
 
     if (dir.isEmpty()) {
         return;
     }
 
-    m_watcherDirectory->setText(dir);
+    WatchRoot root;
+    root.path = QDir::cleanPath(dir);
+    if (indexOfRoot(root.path) >= 0) {
+        return;
+    }
 
-    if (m_watcherEnabled->isChecked()) {
-        startWatching(dir);
+    m_roots.append(root);
+    addRootRow(root);
+    rootsChanged();
+}
+
+void DirectoryWatcherManager::onRemoveRootClicked()
+{
+    const int row = m_rootsTable->currentRow();
+    if (row < 0 || row >= m_roots.size()) {
+        return;
     }
 
-    syncWatchSessionPath(dir);
+    // Cell widgets hold the path they edit, so removing a row needs no renumbering
+    m_roots.removeAt(row);
+    m_rootsTable->removeRow(row);
+    rootsChanged();
 }
 
-void DirectoryWatcherManager::startWatching(const QString &dir)
+void DirectoryWatcherManager::startWatching()
 {
-    m_directoryWatcher->startWatching(dir);
-    setStatusText("Status: Watching " + dir);
-    syncWatchSessionPath(dir);
+    // Watchers of roots that were removed
+    for (auto it = m_watchers.begin(); it != m_watchers.end(); ) {
+        if (indexOfRoot(it.key()) < 0) {
+            it.value()->stopWatching();
+            it.value()->deleteLater();
+            it = m_watchers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (int i = 0; i < m_roots.size(); ++i) {
+        const WatchRoot &root = m_roots.at(i);
+        if (!QDir(root.path).exists()) {
+            LOG("Directory watcher: skipping missing directory " + root.path);
+            continue;
+        }
+        DirectoryWatcher *watcher = m_watchers.value(root.path);
+        if (!watcher) {
+            watcher = createWatcher();
+            m_watchers.insert(root.path, watcher);
+        }
+        applyRootPolicy(watcher, root);
+        // Nested roots (/media/anime inside /media) are reported by their own watcher only
+        watcher->setExcludedDirectories(WatchRoot::nestedRoots(m_roots, i));
+        if (!watcher->isWatching()) {
+            watcher->startWatching(root.path);
+        }
+    }
+
+    updateWatchingStatus();
+    if (!m_roots.isEmpty()) {
+        syncWatchSessionPath(m_roots.first().path);
+    }
+}
+
+void DirectoryWatcherManager::stopWatching()
+{
+    for (DirectoryWatcher *watcher : std::as_const(m_watchers)) {
+        watcher->stopWatching();
+    }
+}
+
+DirectoryWatcher *DirectoryWatcherManager::createWatcher()
+{
+    DirectoryWatcher *watcher = new DirectoryWatcher(this);
+    connect(watcher, &DirectoryWatcher::newFilesDetected,
+            this, &DirectoryWatcherManager::newFilesDetected);
+    connect(watcher, &DirectoryWatcher::filesDeleted,
+            this, &DirectoryWatcherManager::filesDeleted);
+    return watcher;
+}
+
+void DirectoryWatcherManager::applyRootPolicy(DirectoryWatcher *watcher, const WatchRoot &root)
+{
+    watcher->setStabilityDelay(root.stabilityDelaySecs * 1000);
+    watcher->setScanInterval(root.scanIntervalSecs * 1000);
+}
+
+void DirectoryWatcherManager::updateWatchingStatus()
+{
+    QStringList watching;
+    for (const WatchRoot &root : std::as_const(m_roots)) {
+        const DirectoryWatcher *watcher = m_watchers.value(root.path);
+        if (watcher && watcher->isWatching()) {
+            watching.append(root.path);
+        }
+    }
+
+    QString text;
+    if (watching.isEmpty()) {
+        text = "Status: Enabled (invalid directory)";
+    } else if (watching.size() == 1) {
+        text = "Status: Watching " + watching.first();
+    } else {
+        text = QString("Status: Watching %1 directories").arg(watching.size());
+    }
+    const int missing = static_cast<int>(m_roots.size() - watching.size());
+    if (!watching.isEmpty() && missing > 0) {
+        text += QString(" (%1 missing)").arg(missing);
+    }
+    setStatusText(text);
 }
 
 void DirectoryWatcherManager::syncWatchSessionPath(const QString &dir)
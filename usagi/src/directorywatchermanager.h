@@ -4,10 +4,14 @@
 #include <QObject>
 #include <QGroupBox>
 #include <QCheckBox>
-#include <QLineEdit>
+#include <QHash>
 #include <QPushButton>
 #include <QLabel>
+#include <QList>
 #include <QStringList>
+#include <QTableWidget>
+
+#include "watchroot.h"
 
 class AniDBApi;
 class DirectoryWatcher;
@@ -19,10 +23,14 @@ class WatchSessionManager;
  *
  * Responsibilities:
  * - Build and expose the directory watcher settings UI group.
- * - Persist watcher settings through AniDBApi.
- * - Start/stop DirectoryWatcher based on UI state.
- * - Keep WatchSessionManager in sync with the watched path.
+ * - Persist the watched roots and their policies through AniDBApi.
+ * - Run one DirectoryWatcher per root, each with the root's scan interval and
+ *   stability delay, so a slow mount never holds up the scans of the others.
+ *   A root nested in another is left out of the outer watcher, so its files are
+ *   reported once, with the nested root's policy.
+ * - Keep WatchSessionManager in sync with the primary (first) root.
  * - Re-emit newFilesDetected to decouple Window from watcher implementation.
+ * - Publish the roots (watchRootsChanged) for per-root hashing priority and caps.
  */
 class DirectoryWatcherManager : public QObject
 {
@@ -40,32 +48,49 @@ public:
 
     void setWatchSessionManager(WatchSessionManager *manager);
 
+    QList<WatchRoot> watchRoots() const { return m_roots; }
+    /// Path of the primary root, or an empty string without roots.
     QString watchedDirectory() const;
 
 signals:
     void newFilesDetected(const QStringList &filePaths);
     void filesDeleted(const QStringList &filePaths);
+    void watchRootsChanged(const QList<WatchRoot> &roots);
 
 public slots:
     void onWatcherEnabledChanged(Qt::CheckState state);
-    void onWatcherBrowseClicked();
+    void onAddRootClicked();
+    void onRemoveRootClicked();
 
 private:
     void createUi();
-    void startWatching(const QString &dir);
+    void populateRootsTable();
+    void addRootRow(const WatchRoot &root);
+    void setRootValue(const QString &path, int column, int value);
+    int indexOfRoot(const QString &path) const;
+    void rootsChanged();
+
+    void startWatching();
+    void stopWatching();
+    DirectoryWatcher *createWatcher();
+    static void applyRootPolicy(DirectoryWatcher *watcher, const WatchRoot &root);
+    void updateWatchingStatus();
     void syncWatchSessionPath(const QString &dir);
     void setStatusText(const QString &text);
 
     AniDBApi *m_api;
-    DirectoryWatcher *m_directoryWatcher;
     WatchSessionManager *m_watchSessionManager;
 
+    QList<WatchRoot> m_roots;
+    QHash<QString, DirectoryWatcher *> m_watchers;  ///< Keyed by root path
+
     QGroupBox *m_settingsGroup;
     QCheckBox *m_watcherEnabled;
     QCheckBox *m_watcherAutoStart;
     QLabel *m_watcherStatusLabel;
-    QLineEdit *m_watcherDirectory;
-    QPushButton *m_watcherBrowseButton;
+    QTableWidget *m_rootsTable;
+    QPushButton *m_addRootButton;
+    QPushButton *m_removeRootButton;
 
     QString m_pendingWatchPath;
 };
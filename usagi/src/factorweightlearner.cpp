@@ -21,9 +21,15 @@ const QStringList &FactorWeightLearner::factorNames()
         QStringLiteral("watch_recency"),
         QStringLiteral("view_percentage")
     };
+    Q_ASSERT(names.size() == DeletionFactor::Count);
     return names;
 }
 
+int FactorWeightLearner::factorIndex(const QString &name)
+{
+    return static_cast<int>(factorNames().indexOf(name));
+}
+
 // ---------------------------------------------------------------------------
 // Construction
 // ---------------------------------------------------------------------------
@@ -31,9 +37,6 @@ const QStringList &FactorWeightLearner::factorNames()
 FactorWeightLearner::FactorWeightLearner(QObject *parent)
     : QObject(parent)
 {
-    for (const QString &f : factorNames()) {
-        m_weights[f] = 0.0;
-    }
 }
 
 // ---------------------------------------------------------------------------
@@ -73,12 +76,18 @@ void FactorWeightLearner::ensureTablesExist()
 // Weight access
 // ---------------------------------------------------------------------------
 
+double FactorWeightLearner::getWeight(DeletionFactor::Index factor) const
+{
+    return m_weights[factor];
+}
+
 double FactorWeightLearner::getWeight(const QString &factor) const
 {
-    return m_weights.value(factor, 0.0);
+    const int index = factorIndex(factor);
+    return index < 0 ? 0.0 : m_weights[index];
 }
 
-QMap<QString, double> FactorWeightLearner::allWeights() const
+FactorVector FactorWeightLearner::allWeights() const
 {
     return m_weights;
 }
@@ -97,31 +106,54 @@ bool FactorWeightLearner::isTrained() const
 // Score computation
 // ---------------------------------------------------------------------------
 
-double FactorWeightLearner::computeScore(const QMap<QString, double> &normalizedFactors) const
+double FactorWeightLearner::computeScore(const FactorVector &normalizedFactors) const
+{
+    return computeScore(m_weights, normalizedFactors);
+}
+
+double FactorWeightLearner::computeScore(const FactorVector &weights, const FactorVector &normalizedFactors)
 {
     double score = 0.0;
-    for (auto it = m_weights.constBegin(); it != m_weights.constEnd(); ++it) {
-        score += it.value() * normalizedFactors.value(it.key(), 0.0);
+    for (int f = 0; f < DeletionFactor::Count; ++f) {
+        score += weights[f] * normalizedFactors[f];
     }
     return score;
 }
 
+std::vector<double> FactorWeightLearner::computeScores(const FactorVector &weights,
+                                                       const std::vector<FactorVector> &normalizedFactors)
+{
+    // Factor-major: each pass is a scaled add over contiguous scores with a
+    // loop-invariant weight, which the compiler can vectorize
+    const std::size_t count = normalizedFactors.size();
+    std::vector<double> scores(count, 0.0);
+    double *out = scores.data();
+    const FactorVector *in = normalizedFactors.data();
+    for (int f = 0; f < DeletionFactor::Count; ++f) {
+        const double w = weights[f];
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] += w * in[i][f];
+        }
+    }
+    return scores;
+}
+
 // ---------------------------------------------------------------------------
 // A vs B choice processing
 // ---------------------------------------------------------------------------
 
 void FactorWeightLearner::recordChoice(int keptLid, int deletedLid,
-                                       const QMap<QString, double> &keptFactors,
-                                       const QMap<QString, double> &deletedFactors)
+                                       const FactorVector &keptFactors,
+                                       const FactorVector &deletedFactors)
 {
     // 1. Adjust weights
-    for (const QString &f : factorNames()) {
-        double diff = keptFactors.value(f, 0.0) - deletedFactors.value(f, 0.0);
+    for (int f = 0; f < DeletionFactor::Count; ++f) {
+        double diff = keptFactors[f] - deletedFactors[f];
         if (std::abs(diff) < MIN_FACTOR_DIFFERENCE) {
             continue;
         }
         double direction = (diff > 0.0) ? 1.0 : -1.0;
-        adjustWeight(f, LEARNING_RATE * direction);
+        adjustWeight(static_cast<DeletionFactor::Index>(f), LEARNING_RATE * direction);
     }
 
     // 2. Store choice in history
@@ -129,10 +161,10 @@ void FactorWeightLearner::recordChoice(int keptLid, int deletedLid,
     QSqlQuery q(db);
 
     QJsonObject keptObj, deletedObj;
-    for (auto it = keptFactors.constBegin(); it != keptFactors.constEnd(); ++it)
-        keptObj[it.key()] = it.value();
-    for (auto it = deletedFactors.constBegin(); it != deletedFactors.constEnd(); ++it)
-        deletedObj[it.key()] = it.value();
+    for (int f = 0; f < DeletionFactor::Count; ++f) {
+        keptObj[factorNames().at(f)] = keptFactors[f];
+        deletedObj[factorNames().at(f)] = deletedFactors[f];
+    }
 
     q.prepare("INSERT INTO deletion_choices (kept_lid, deleted_lid, kept_factors, deleted_factors, chosen_at) "
               "VALUES (:kl, :dl, :kf, :df, :ts)");
@@ -156,9 +188,7 @@ void FactorWeightLearner::recordChoice(int keptLid, int deletedLid,
 
 void FactorWeightLearner::resetAllWeights()
 {
-    for (auto it = m_weights.begin(); it != m_weights.end(); ++it) {
-        it.value() = 0.0;
-    }
+    m_weights.fill(0.0);
     m_totalChoices = 0;
 
     QSqlDatabase db = QSqlDatabase::database();
@@ -174,8 +204,8 @@ void FactorWeightLearner::resetAllWeights()
 // Confidence
 // ---------------------------------------------------------------------------
 
-double FactorWeightLearner::scoreDifference(const QMap<QString, double> &factors1,
-                                             const QMap<QString, double> &factors2) const
+double FactorWeightLearner::scoreDifference(const FactorVector &factors1,
+                                             const FactorVector &factors2) const
 {
     return std::abs(computeScore(factors1) - computeScore(factors2));
 }
@@ -190,9 +220,9 @@ void FactorWeightLearner::loadWeights()
     QSqlQuery q(db);
     q.exec("SELECT factor, weight FROM deletion_factor_weights");
     while (q.next()) {
-        QString factor = q.value(0).toString();
-        if (m_weights.contains(factor)) {
-            m_weights[factor] = q.value(1).toDouble();
+        const int index = factorIndex(q.value(0).toString());
+        if (index >= 0) {
+            m_weights[index] = q.value(1).toDouble();
         }
     }
 
@@ -206,12 +236,12 @@ void FactorWeightLearner::saveWeights()
 {
     QSqlDatabase db = QSqlDatabase::database();
     QSqlQuery q(db);
-    for (auto it = m_weights.constBegin(); it != m_weights.constEnd(); ++it) {
+    for (int f = 0; f < DeletionFactor::Count; ++f) {
         q.prepare("INSERT OR REPLACE INTO deletion_factor_weights (factor, weight, total_adjustments) "
                   "VALUES (:f, :w, COALESCE((SELECT total_adjustments FROM deletion_factor_weights WHERE factor = :f2), 0))");
-        q.bindValue(":f",  it.key());
-        q.bindValue(":w",  it.value());
-        q.bindValue(":f2", it.key());
+        q.bindValue(":f",  factorNames().at(f));
+        q.bindValue(":w",  m_weights[f]);
+        q.bindValue(":f2", factorNames().at(f));
         q.exec();
     }
 }
@@ -220,9 +250,10 @@ void FactorWeightLearner::saveWeights()
 // Private helpers
 // ---------------------------------------------------------------------------
 
-void FactorWeightLearner::adjustWeight(const QString &factor, double delta)
+void FactorWeightLearner::adjustWeight(DeletionFactor::Index factor, double delta)
 {
     m_weights[factor] += delta;
+    const QString name = factorNames().at(factor);
 
     QSqlDatabase db = QSqlDatabase::database();
     QSqlQuery q(db);
@@ -231,9 +262,9 @@ void FactorWeightLearner::adjustWeight(const QString &factor, double delta)
               "  COALESCE((SELECT weight FROM deletion_factor_weights WHERE factor = :f2), 0.0) + :d, "
               "  COALESCE((SELECT total_adjustments FROM deletion_factor_weights WHERE factor = :f3), 0) + 1"
               ")");
-    q.bindValue(":f",  factor);
-    q.bindValue(":f2", factor);
-    q.bindValue(":f3", factor);
+    q.bindValue(":f",  name);
+    q.bindValue(":f2", name);
+    q.bindValue(":f3", name);
     q.bindValue(":d",  delta);
     q.exec();
 }
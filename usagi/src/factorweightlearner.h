@@ -2,18 +2,23 @@
 #define FACTORWEIGHTLEARNER_H
 
 #include <QObject>
-#include <QMap>
 #include <QString>
+#include <QStringList>
+#include <vector>
+#include "deletioncandidate.h"
 
 /**
  * @brief Manages learned factor weights and processes A vs B choices.
  *
- * Learnable factors:
+ * Learnable factors (see DeletionFactor):
  *   anime_rating, size_weighted_distance, group_status,
  *   watch_recency, view_percentage
  *
  * All weights start at 0.  Each A vs B choice adjusts the weights of
  * factors that meaningfully differ between the two files.
+ *
+ * Weights and factors are FactorVectors; a score is their dot product.
+ * Factor names only appear in the database and the UI.
  */
 class FactorWeightLearner : public QObject
 {
@@ -26,25 +31,31 @@ public:
     void ensureTablesExist();
 
     // ── Weight access ──
-    double getWeight(const QString &factor) const;
-    QMap<QString, double> allWeights() const;
+    double getWeight(DeletionFactor::Index factor) const;
+    double getWeight(const QString &factor) const;   ///< 0.0 for unknown names
+    FactorVector allWeights() const;
     int totalChoicesMade() const;
     bool isTrained() const;   ///< totalChoicesMade >= MIN_CHOICES
 
     // ── Score computation ──
-    double computeScore(const QMap<QString, double> &normalizedFactors) const;
+    double computeScore(const FactorVector &normalizedFactors) const;
+    /// Same, with a copy of the weights (for classification off the GUI thread)
+    static double computeScore(const FactorVector &weights, const FactorVector &normalizedFactors);
+    /// Score many files in one pass; result[i] is the score of normalizedFactors[i]
+    static std::vector<double> computeScores(const FactorVector &weights,
+                                             const std::vector<FactorVector> &normalizedFactors);
 
     // ── A vs B choice processing ──
     void recordChoice(int keptLid, int deletedLid,
-                      const QMap<QString, double> &keptFactors,
-                      const QMap<QString, double> &deletedFactors);
+                      const FactorVector &keptFactors,
+                      const FactorVector &deletedFactors);
 
     // ── Reset ──
     void resetAllWeights();
 
     // ── Confidence ──
-    double scoreDifference(const QMap<QString, double> &factors1,
-                           const QMap<QString, double> &factors2) const;
+    double scoreDifference(const FactorVector &factors1,
+                           const FactorVector &factors2) const;
 
     // ── Persistence ──
     void loadWeights();
@@ -57,15 +68,18 @@ public:
     static constexpr double CONFIDENCE_THRESHOLD   = 0.1;
 
     // ── Factor names ──
+    /// Names in DeletionFactor order
     static const QStringList &factorNames();
+    /// DeletionFactor index of a name, -1 if unknown
+    static int factorIndex(const QString &name);
 
 signals:
     void weightsUpdated();
 
 private:
-    void adjustWeight(const QString &factor, double delta);
+    void adjustWeight(DeletionFactor::Index factor, double delta);
 
-    QMap<QString, double> m_weights;
+    FactorVector m_weights{};
     int m_totalChoices = 0;
 };
 
@@ -0,0 +1,268 @@
+#include "fileattributesnapshot.h"
+#include "logger.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+
+int FileAttributeSnapshot::File::version() const
+{
+    if (fileState & 32) return 5;
+    if (fileState & 16) return 4;
+    if (fileState & 8) return 3;
+    if (fileState & 4) return 2;
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// Loading
+// ---------------------------------------------------------------------------
+
+bool FileAttributeSnapshot::load()
+{
+    return loadWhere(QString(), QVariantList());
+}
+
+bool FileAttributeSnapshot::loadAnime(int aid)
+{
+    return loadWhere("AND m.aid = ? ", QVariantList{aid});
+}
+
+bool FileAttributeSnapshot::loadEpisodes(const QList<int> &eids)
+{
+    if (eids.isEmpty()) {
+        clear();
+        return true;
+    }
+
+    QStringList placeholders;
+    QVariantList values;
+    for (int eid : eids) {
+        placeholders.append("?");
+        values.append(eid);
+    }
+    return loadWhere(QString("AND m.eid IN (%1) ").arg(placeholders.join(',')), values);
+}
+
+bool FileAttributeSnapshot::loadWhere(const QString &filter, const QVariantList &values)
+{
+    clear();
+
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isValid() || !db.isOpen()) {
+        LOG("FileAttributeSnapshot: database not open");
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare("SELECT m.lid, m.aid, m.eid, m.state, m.viewed, m.deletion_locked, lf.path, "
+              "f.fid, f.state, f.quality, f.lang_dub, f.lang_sub, f.codec_video, f.bitrate_video, "
+              "f.resolution, f.gid, g.status, "
+              "a.aid, a.nameromaji, a.rating, a.hidden "
+              "FROM mylist m "
+              "JOIN local_files lf ON lf.id = m.local_file "
+              "LEFT JOIN file f ON f.fid = m.fid "
+              "LEFT JOIN `group` g ON g.gid = f.gid "
+              "LEFT JOIN anime a ON a.aid = m.aid "
+              "WHERE lf.path IS NOT NULL " + filter +
+              "ORDER BY m.lid");
+    for (const QVariant &value : values) {
+        q.addBindValue(value);
+    }
+    if (!q.exec()) {
+        LOG(QString("FileAttributeSnapshot: query failed: %1").arg(q.lastError().text()));
+        return false;
+    }
+
+    while (q.next()) {
+        File file;
+        file.lid              = q.value(0).toInt();
+        file.aid              = q.value(1).toInt();
+        file.eid              = q.value(2).toInt();
+        file.mylistState      = q.value(3).toInt();
+        file.viewed           = q.value(4).toInt();
+        file.deletionLocked   = q.value(5).toInt();
+        file.path             = q.value(6).toString();
+        file.hasFile          = !q.value(7).isNull();
+        file.fileState        = q.value(8).toInt();
+        file.quality          = q.value(9).isNull() ? QString() : q.value(9).toString();
+        file.audioLanguage    = q.value(10).toString();
+        file.subtitleLanguage = q.value(11).toString();
+        file.videoCodec       = q.value(12).toString();
+        file.videoBitrate     = q.value(13).toInt();
+        file.resolution       = q.value(14).toString();
+        file.gid              = q.value(15).toInt();
+        file.groupStatus      = q.value(16).toInt();
+        file.hasAnime         = !q.value(17).isNull();
+        file.animeName        = q.value(18).toString();
+        file.animeRating      = q.value(19).toInt();
+        file.animeRatingText  = q.value(19).toString();
+        file.animeHidden      = q.value(20).toInt() == 1;
+        addFile(file);
+    }
+    loadEpisodeNumbers(filter, values);
+
+    m_preferredAudio     = loadLanguageSetting("preferredAudioLanguages");
+    m_preferredSubtitles = loadLanguageSetting("preferredSubtitleLanguages");
+    m_preferredBitrate   = loadSetting("preferredBitrate").toDouble();
+    m_lockedAnime        = loadLockedAnime();
+
+    if (filter.isEmpty()) {
+        LOG(QString("FileAttributeSnapshot: loaded %1 local file(s) in %2 ms")
+            .arg(m_files.size()).arg(timer.elapsed()));
+    }
+    return true;
+}
+
+void FileAttributeSnapshot::loadEpisodeNumbers(const QString &filter, const QVariantList &values)
+{
+    // Separate from the main join so a missing episode table only loses episode numbers
+    QSqlQuery q(QSqlDatabase::database());
+    q.setForwardOnly(true);
+    q.prepare("SELECT m.lid, e.epno "
+              "FROM mylist m "
+              "JOIN local_files lf ON lf.id = m.local_file "
+              "JOIN episode e ON e.eid = m.eid "
+              "WHERE lf.path IS NOT NULL " + filter);
+    for (const QVariant &value : values) {
+        q.addBindValue(value);
+    }
+    if (!q.exec()) {
+        return;
+    }
+
+    while (q.next()) {
+        auto it = m_indexOfLid.constFind(q.value(0).toInt());
+        if (it != m_indexOfLid.constEnd()) {
+            File &file = m_files[it.value()];
+            file.hasEpisode = true;
+            file.epno = q.value(1).toString();
+        }
+    }
+}
+
+void FileAttributeSnapshot::clear()
+{
+    m_files.clear();
+    m_indexOfLid.clear();
+    m_lidsOfEpisode.clear();
+    m_lidsOfAnime.clear();
+    m_groupStatus.clear();
+    m_preferredAudio.clear();
+    m_preferredSubtitles.clear();
+    m_preferredBitrate = 0.0;
+    m_lockedAnime.clear();
+}
+
+void FileAttributeSnapshot::addFile(const File &file)
+{
+    m_indexOfLid.insert(file.lid, static_cast<int>(m_files.size()));
+    m_lidsOfEpisode[file.eid].append(file.lid);
+    m_lidsOfAnime[file.aid].append(file.lid);
+    if (file.hasFile) {
+        m_groupStatus.insert(file.gid, file.groupStatus);
+    }
+    m_files.push_back(file);
+}
+
+QString FileAttributeSnapshot::loadSetting(const QString &name)
+{
+    QSqlQuery q(QSqlDatabase::database());
+    q.prepare("SELECT value FROM settings WHERE name = ?");
+    q.addBindValue(name);
+    if (!q.exec() || !q.next()) {
+        return QString();
+    }
+    return q.value(0).toString();
+}
+
+QStringList FileAttributeSnapshot::loadLanguageSetting(const QString &name)
+{
+    QStringList languages;
+    for (const QString &language : loadSetting(name).toLower().split(',', Qt::SkipEmptyParts)) {
+        languages.append(language.trimmed());
+    }
+    return languages;
+}
+
+QSet<int> FileAttributeSnapshot::loadLockedAnime()
+{
+    // Same source as DeletionLockManager::reloadCaches(); no table means no locks
+    QSet<int> aids;
+    QSqlQuery q(QSqlDatabase::database());
+    if (q.exec("SELECT aid FROM deletion_locks WHERE aid IS NOT NULL")) {
+        while (q.next()) {
+            aids.insert(q.value(0).toInt());
+        }
+    }
+    return aids;
+}
+
+// ---------------------------------------------------------------------------
+// Lookups
+// ---------------------------------------------------------------------------
+
+const FileAttributeSnapshot::File *FileAttributeSnapshot::file(int lid) const
+{
+    auto it = m_indexOfLid.constFind(lid);
+    return it == m_indexOfLid.constEnd() ? nullptr : &m_files[it.value()];
+}
+
+QList<int> FileAttributeSnapshot::deletionCandidates() const
+{
+    QList<int> lids;
+    lids.reserve(static_cast<qsizetype>(m_files.size()));
+    for (const File &file : m_files) {
+        if (file.mylistState != 3) {
+            lids.append(file.lid);
+        }
+    }
+    return lids;
+}
+
+// ---------------------------------------------------------------------------
+// Language preferences
+// ---------------------------------------------------------------------------
+
+void FileAttributeSnapshot::setPreferredLanguages(const QStringList &audio, const QStringList &subtitles)
+{
+    m_preferredAudio.clear();
+    for (const QString &language : audio) {
+        m_preferredAudio.append(language.toLower().trimmed());
+    }
+    m_preferredSubtitles.clear();
+    for (const QString &language : subtitles) {
+        m_preferredSubtitles.append(language.toLower().trimmed());
+    }
+}
+
+bool FileAttributeSnapshot::matchesPreferredAudioLanguage(int lid) const
+{
+    const File *f = file(lid);
+    return f && f->hasFile && matchesLanguage(f->audioLanguage, m_preferredAudio);
+}
+
+bool FileAttributeSnapshot::matchesPreferredSubtitleLanguage(int lid) const
+{
+    const File *f = file(lid);
+    return f && f->hasFile && matchesLanguage(f->subtitleLanguage, m_preferredSubtitles);
+}
+
+bool FileAttributeSnapshot::matchesLanguage(const QString &fileLanguages, const QStringList &preferred)
+{
+    if (fileLanguages.isEmpty()) {
+        return false;
+    }
+    // lang_dub / lang_sub use ' as delimiter (e.g. "japanese'english")
+    const QStringList languages = fileLanguages.toLower().trimmed().split('\'', Qt::SkipEmptyParts);
+    for (const QString &language : languages) {
+        if (preferred.contains(language.trimmed())) {
+            return true;
+        }
+    }
+    return false;
+}
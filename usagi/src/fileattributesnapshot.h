@@ -0,0 +1,147 @@
+#ifndef FILEATTRIBUTESNAPSHOT_H
+#define FILEATTRIBUTESNAPSHOT_H
+
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <vector>
+
+/**
+ * @brief FileAttributeSnapshot - Attributes of every local file, loaded in one joined query
+ *
+ * Deletion classification asks a dozen questions per file (version bits, quality,
+ * languages, rating, hidden flag, group status, lock state, ...), each of which used
+ * to be its own SQL query. The snapshot loads all of them for every mylist entry with
+ * a local file using a single mylist/local_files/file/anime/group join, plus one query
+ * for episode numbers and a few for settings, and answers them from memory.
+ * WatchSessionManager's per-file helpers read the same snapshot during a scan.
+ *
+ * Files are kept in lid order and indexed by lid and by episode, so "other local files
+ * of the same episode" lookups see the same candidates, in the same order, as the
+ * per-file queries did.
+ *
+ * The snapshot is a value: load() it at the start of a cycle and discard it afterwards.
+ * It never touches the database after load(), so a loaded snapshot can be classified
+ * on worker threads while the GUI thread keeps changing the tables.
+ *
+ * Follows SOLID principles:
+ * - Single Responsibility: Loads and indexes file attributes; no classification rules
+ * - Dependency Inversion: Classifiers read attributes instead of issuing queries
+ *
+ * Usage:
+ *   FileAttributeSnapshot snapshot;
+ *   if (snapshot.load()) {
+ *       for (int lid : snapshot.deletionCandidates())
+ *           classifier.classify(lid, snapshot);
+ *   }
+ */
+class FileAttributeSnapshot
+{
+public:
+    struct File {
+        int lid = 0;
+        int aid = 0;
+        int eid = 0;
+        int mylistState = 0;            // mylist.state (3 = deleted)
+        int viewed = 0;
+        int deletionLocked = 0;         // 0 = not locked, 1 = episode lock, 2 = anime lock
+        QString path;
+
+        // file table (hasFile = false if the file row is missing)
+        bool hasFile = false;
+        int fileState = 0;
+        QString quality;                // null if unknown
+        QString audioLanguage;          // lang_dub, ' separated
+        QString subtitleLanguage;       // lang_sub, ' separated
+        QString videoCodec;
+        int videoBitrate = 0;
+        QString resolution;
+        int gid = 0;
+        int groupStatus = 0;            // 0 = unknown, 1 = ongoing, 2 = stalled, 3 = disbanded
+
+        // anime table (hasAnime = false if the anime row is missing)
+        bool hasAnime = false;
+        QString animeName;
+        int animeRating = 0;            // 0-1000
+        QString animeRatingText;        // anime.rating as stored (AniDB "8.23")
+        bool animeHidden = false;
+
+        // episode table (hasEpisode = false if the episode row is missing)
+        bool hasEpisode = false;
+        QString epno;                   // "1", "S1", "C1", ...
+
+        // Revision from the state bits (v2 = 4, v3 = 8, v4 = 16, v5 = 32, none = v1)
+        int version() const;
+    };
+
+    FileAttributeSnapshot() = default;
+
+    // Load every mylist entry with a local file path from the default connection.
+    // Returns false (and leaves the snapshot empty) if the database is unavailable.
+    bool load();
+
+    // Load only the files of one anime / of the given episodes. Whole episodes are
+    // always loaded, so per-episode rules (revisions, duplicates) see every sibling.
+    bool loadAnime(int aid);
+    bool loadEpisodes(const QList<int> &eids);
+
+    void clear();
+
+    int size() const { return static_cast<int>(m_files.size()); }
+    bool isEmpty() const { return m_files.empty(); }
+
+    // nullptr if the lid has no local file
+    const File *file(int lid) const;
+
+    // Local files of an episode / an anime, in lid order
+    QList<int> lidsForEpisode(int eid) const { return m_lidsOfEpisode.value(eid); }
+    QList<int> lidsForAnime(int aid) const { return m_lidsOfAnime.value(aid); }
+
+    // Status of a group referenced by a loaded file (0 if the group row is missing)
+    bool containsGroup(int gid) const { return m_groupStatus.contains(gid); }
+    int groupStatus(int gid) const { return m_groupStatus.value(gid); }
+
+    // Local files that are not marked deleted (mylist.state != 3), in lid order
+    QList<int> deletionCandidates() const;
+
+    // ── Language preferences (settings table) ──
+    const QStringList &preferredAudioLanguages() const { return m_preferredAudio; }
+    const QStringList &preferredSubtitleLanguages() const { return m_preferredSubtitles; }
+    void setPreferredLanguages(const QStringList &audio, const QStringList &subtitles);
+
+    // preferredBitrate setting in Mbps (0 if not set)
+    double preferredBitrate() const { return m_preferredBitrate; }
+
+    // Anime locked as a whole (deletion_locks rows with an aid)
+    bool isAnimeLocked(int aid) const { return m_lockedAnime.contains(aid); }
+
+    // Same rules as WatchSessionManager::matchesPreferred*Language()
+    bool matchesPreferredAudioLanguage(int lid) const;
+    bool matchesPreferredSubtitleLanguage(int lid) const;
+
+    // Append one file (for loaders and tests); files must be added in lid order
+    void addFile(const File &file);
+
+private:
+    bool loadWhere(const QString &filter, const QVariantList &values);
+    void loadEpisodeNumbers(const QString &filter, const QVariantList &values);
+    static bool matchesLanguage(const QString &fileLanguages, const QStringList &preferred);
+    static QString loadSetting(const QString &name);
+    static QStringList loadLanguageSetting(const QString &name);
+    static QSet<int> loadLockedAnime();
+
+    std::vector<File> m_files;
+    QHash<int, int> m_indexOfLid;               // lid -> index into m_files
+    QHash<int, QList<int>> m_lidsOfEpisode;     // eid -> lids
+    QHash<int, QList<int>> m_lidsOfAnime;       // aid -> lids
+    QHash<int, int> m_groupStatus;              // gid -> group.status
+    QStringList m_preferredAudio;               // lower case, trimmed
+    QStringList m_preferredSubtitles;
+    double m_preferredBitrate = 0.0;
+    QSet<int> m_lockedAnime;
+};
+
+#endif // FILEATTRIBUTESNAPSHOT_H
@@ -0,0 +1,67 @@
+#include "filechangequeue.h"
+#include <utility>
+
+bool FileChangeQueue::Batch::isEmpty() const
+{
+    return createdFiles.isEmpty() && completedFiles.isEmpty() && removedFiles.isEmpty()
+           && removedDirectories.isEmpty() && !overflow;
+}
+
+void FileChangeQueue::addFile(Change change, const QString &path)
+{
+    State state = State::Removed;
+    switch (change) {
+    case Change::Created:
+        state = State::Created;
+        break;
+    case Change::Written:
+    case Change::MovedIn:
+        state = State::Completed;
+        break;
+    case Change::MovedOut:
+    case Change::Deleted:
+        state = State::Removed;
+        break;
+    }
+
+    auto it = m_state.find(path);
+    if (it == m_state.end()) {
+        m_state.insert(path, state);
+        m_order.append(path);
+    } else {
+        it.value() = state;
+    }
+}
+
+void FileChangeQueue::addRemovedDirectory(const QString &path)
+{
+    if (!m_removedDirectories.contains(path)) {
+        m_removedDirectories.append(path);
+    }
+}
+
+FileChangeQueue::Batch FileChangeQueue::take()
+{
+    Batch batch;
+    for (const QString &path : std::as_const(m_order)) {
+        switch (m_state.value(path)) {
+        case State::Created:
+            batch.createdFiles.append(path);
+            break;
+        case State::Completed:
+            batch.completedFiles.append(path);
+            break;
+        case State::Removed:
+            batch.removedFiles.append(path);
+            break;
+        }
+    }
+    batch.removedDirectories = m_removedDirectories;
+    batch.overflow = m_overflow;
+
+    m_state.clear();
+    m_order.clear();
+    m_removedDirectories.clear();
+    m_overflow = false;
+    return batch;
+}
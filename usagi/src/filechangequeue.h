@@ -0,0 +1,59 @@
+#ifndef FILECHANGEQUEUE_H
+#define FILECHANGEQUEUE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Coalesces file system events into one batch of per-path outcomes.
+ *
+ * Filled by a native watcher backend (see InotifyWatcher) and drained by
+ * DirectoryWatcher. Several events for the same path collapse into the final
+ * state at the time the batch is taken, so a file that is created, written and
+ * renamed within one batch costs one entry, and a temporary file that is created
+ * and removed again costs nothing downstream.
+ */
+class FileChangeQueue
+{
+public:
+    enum class Change {
+        Created,    ///< New file, possibly still being written
+        Written,    ///< Closed after writing
+        MovedIn,    ///< Renamed into the tree (complete)
+        MovedOut,   ///< Renamed away or out of the tree
+        Deleted
+    };
+
+    struct Batch {
+        QStringList createdFiles;        ///< Present, not yet closed after writing
+        QStringList completedFiles;      ///< Present and closed after writing, or moved in
+        QStringList removedFiles;        ///< Gone: deleted or moved out
+        QStringList removedDirectories;  ///< Deleted or moved out, with everything below them
+        bool overflow = false;           ///< Events were lost; the whole tree must be rescanned
+
+        bool isEmpty() const;
+    };
+
+    void addFile(Change change, const QString &path);
+    void addRemovedDirectory(const QString &path);
+    /// The kernel dropped events; the next batch asks for a full rescan.
+    void setOverflow() { m_overflow = true; }
+
+    bool isEmpty() const { return m_order.isEmpty() && m_removedDirectories.isEmpty() && !m_overflow; }
+    /// Distinct paths queued.
+    int size() const { return static_cast<int>(m_order.size()); }
+
+    /// Take the coalesced batch (paths in first-seen order) and clear the queue.
+    Batch take();
+
+private:
+    enum class State { Created, Completed, Removed };
+
+    QHash<QString, State> m_state;
+    QStringList m_order;
+    QStringList m_removedDirectories;
+    bool m_overflow = false;
+};
+
+#endif // FILECHANGEQUEUE_H
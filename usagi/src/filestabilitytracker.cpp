@@ -0,0 +1,182 @@
+#include "filestabilitytracker.h"
+#include <QFileInfo>
+#include <QDateTime>
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+FileStabilityTracker::Observation statFile(const QString &path)
+{
+    FileStabilityTracker::Observation observation;
+    const QFileInfo info(path);
+    observation.exists = info.exists() && info.isFile();
+    if (observation.exists) {
+        observation.size = info.size();
+        observation.mtime = info.lastModified().toMSecsSinceEpoch();
+    }
+    return observation;
+}
+
+} // namespace
+
+FileStabilityTracker::FileStabilityTracker()
+    : FileStabilityTracker(statFile)
+{
+}
+
+FileStabilityTracker::FileStabilityTracker(StatFunction stat)
+    : m_stat(std::move(stat))
+    , m_quietPeriodMs(DEFAULT_QUIET_PERIOD_MS)
+    , m_nextSequence(0)
+{
+}
+
+void FileStabilityTracker::add(const QString &path, qint64 nowMs)
+{
+    if (m_pending.contains(path)) {
+        return;
+    }
+    Pending pending;
+    pending.sequence = m_nextSequence++;
+    pending.nextCheckMs = nowMs;
+    m_pending.insert(path, pending);
+}
+
+void FileStabilityTracker::add(const QString &path, qint64 nowMs, const Observation &observation)
+{
+    if (m_pending.contains(path)) {
+        return;
+    }
+    Pending pending;
+    pending.sequence = m_nextSequence++;
+    pending.nextCheckMs = nowMs;
+    if (observation.exists) {
+        observe(pending, observation, nowMs);
+        pending.ready = settle(pending, true, nowMs);
+        if (pending.ready) {
+            pending.nextCheckMs = nowMs;
+        }
+    }
+    m_pending.insert(path, pending);
+}
+
+void FileStabilityTracker::noteClosed(const QString &path, qint64 nowMs)
+{
+    add(path, nowMs);
+    Pending &pending = m_pending[path];
+    pending.ready = false;
+    const Observation observation = m_stat(path);
+    if (observation.exists) {
+        observe(pending, observation, nowMs);
+    }
+    pending.closedAtMs = nowMs;
+    pending.backoffMs = MIN_POLL_MS;
+    pending.nextCheckMs = nowMs + CLOSE_SETTLE_MS;
+}
+
+void FileStabilityTracker::remove(const QString &path)
+{
+    m_pending.remove(path);
+}
+
+void FileStabilityTracker::clear()
+{
+    m_pending.clear();
+}
+
+bool FileStabilityTracker::observe(Pending &pending, const Observation &observation, qint64 nowMs)
+{
+    if (observation.size == pending.size && observation.mtime == pending.mtime) {
+        return false;
+    }
+    pending.size = observation.size;
+    pending.mtime = observation.mtime;
+    // The last write happened at mtime; a future mtime (clock skew on a share) counts from now
+    pending.quietSinceMs = (observation.mtime > 0 && observation.mtime <= nowMs) ? observation.mtime : nowMs;
+    return true;
+}
+
+QStringList FileStabilityTracker::poll(qint64 nowMs, QStringList *vanished)
+{
+    QList<std::pair<quint64, QString>> released;
+    for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+        Pending &pending = it.value();
+        if (pending.nextCheckMs > nowMs) {
+            ++it;
+            continue;
+        }
+
+        if (pending.ready) {
+            released.append({pending.sequence, it.key()});
+            it = m_pending.erase(it);
+            continue;
+        }
+
+        const Observation observation = m_stat(it.key());
+        if (!observation.exists) {
+            // Deleted or renamed; the watcher reports the new name on its own
+            if (vanished) {
+                vanished->append(it.key());
+            }
+            it = m_pending.erase(it);
+            continue;
+        }
+
+        const bool firstCheck = pending.size < 0;
+        const bool changed = observe(pending, observation, nowMs);
+        if (changed && !firstCheck) {
+            // Written after the close: wait for the next one (or for quiet)
+            pending.closedAtMs = -1;
+        }
+
+        if (settle(pending, changed, nowMs)) {
+            released.append({pending.sequence, it.key()});
+            it = m_pending.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    std::sort(released.begin(), released.end());
+    QStringList paths;
+    paths.reserve(released.size());
+    for (const auto &entry : std::as_const(released)) {
+        paths.append(entry.second);
+    }
+    return paths;
+}
+
+bool FileStabilityTracker::settle(Pending &pending, bool changed, qint64 nowMs) const
+{
+    const bool settledAfterClose = pending.closedAtMs >= 0 && !changed
+                                   && nowMs - pending.closedAtMs >= CLOSE_SETTLE_MS;
+    const bool quiet = nowMs - pending.quietSinceMs >= m_quietPeriodMs;
+    if (pending.size > 0 && (settledAfterClose || quiet)) {
+        return true;
+    }
+
+    // Not complete yet: back off, but not past the moment it could be released
+    qint64 next = nowMs + pending.backoffMs;
+    const qint64 quietEnd = pending.quietSinceMs + m_quietPeriodMs;
+    if (quietEnd > nowMs) {
+        next = qMin(next, quietEnd);
+    }
+    if (pending.closedAtMs >= 0 && pending.closedAtMs + CLOSE_SETTLE_MS > nowMs) {
+        next = qMin(next, pending.closedAtMs + CLOSE_SETTLE_MS);
+    }
+    pending.nextCheckMs = next;
+    pending.backoffMs = qMin(pending.backoffMs * 2, MAX_POLL_MS);
+    return false;
+}
+
+qint64 FileStabilityTracker::nextCheckMs() const
+{
+    qint64 next = -1;
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (next < 0 || it->nextCheckMs < next) {
+            next = it->nextCheckMs;
+        }
+    }
+    return next;
+}
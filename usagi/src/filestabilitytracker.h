@@ -0,0 +1,105 @@
+#ifndef FILESTABILITYTRACKER_H
+#define FILESTABILITYTRACKER_H
+
+#include <QHash>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+/**
+ * @brief Holds newly detected files back until they are completely written.
+ *
+ * DirectoryWatcher reports files as soon as they appear, which for a running
+ * download means a partial file. The tracker sits between the watcher and the
+ * hasher and releases a file only once it is complete:
+ *   - Close-write (or moved-in) seen: released when size and mtime are still the
+ *     same CLOSE_SETTLE_MS after the close.
+ *   - Otherwise: released once size and mtime have not changed for the quiet
+ *     period, measured from the file's mtime (or from when the current state
+ *     was first seen, if the mtime lies in the future). Files that have not been
+ *     touched for a quiet period already, such as the library at startup, are
+ *     released on their first check.
+ * Empty files are never released. Each check that does not release a file
+ * doubles its poll interval (MIN_POLL_MS up to MAX_POLL_MS), so long downloads
+ * cost a handful of stats; a check is never scheduled later than the moment the
+ * quiet period or the settle time would end.
+ *
+ * A file added together with its first observation (taken by whoever found
+ * it, e.g. the scan worker) is not stat'd again if it is already complete.
+ *
+ * Not a QObject and time is passed in: DirectoryWatcher drives poll() from a
+ * timer at nextCheckMs().
+ */
+class FileStabilityTracker
+{
+public:
+    struct Observation {
+        bool exists = false;
+        qint64 size = 0;
+        qint64 mtime = 0;   ///< ms since epoch
+    };
+    using StatFunction = std::function<Observation(const QString &path)>;
+
+    static constexpr qint64 DEFAULT_QUIET_PERIOD_MS = 10 * 1000;
+    static constexpr qint64 CLOSE_SETTLE_MS = 2000;
+    static constexpr qint64 MIN_POLL_MS = 1000;
+    static constexpr qint64 MAX_POLL_MS = 30 * 1000;
+
+    /// Uses QFileInfo to look at files.
+    FileStabilityTracker();
+    explicit FileStabilityTracker(StatFunction stat);
+
+    void setQuietPeriod(qint64 ms) { m_quietPeriodMs = qMax<qint64>(0, ms); }
+    qint64 quietPeriod() const { return m_quietPeriodMs; }
+
+    /// Start tracking @p path; its first check is due immediately.
+    void add(const QString &path, qint64 nowMs);
+    /// Start tracking @p path as seen in @p observation; released by the next
+    /// poll() without a stat if that already makes it complete.
+    void add(const QString &path, qint64 nowMs, const Observation &observation);
+    /// The file was closed after writing (or moved in complete); tracked if new.
+    void noteClosed(const QString &path, qint64 nowMs);
+    void remove(const QString &path);
+    void clear();
+
+    bool contains(const QString &path) const { return m_pending.contains(path); }
+    int pendingCount() const { return static_cast<int>(m_pending.size()); }
+    QStringList pendingFiles() const { return m_pending.keys(); }
+
+    /**
+     * @brief Check the files that are due.
+     * @param vanished Receives tracked files that no longer exist (dropped)
+     * @return Files that are complete, in the order they were added
+     */
+    QStringList poll(qint64 nowMs, QStringList *vanished = nullptr);
+
+    /// When the next check is due (ms since epoch), or -1 with nothing pending.
+    qint64 nextCheckMs() const;
+
+private:
+    struct Pending {
+        quint64 sequence = 0;
+        qint64 size = -1;           ///< -1 until first observed
+        qint64 mtime = -1;
+        qint64 quietSinceMs = 0;
+        qint64 closedAtMs = -1;     ///< -1 unless closed since the last change
+        qint64 nextCheckMs = 0;
+        qint64 backoffMs = MIN_POLL_MS;
+        bool ready = false;         ///< Complete when added; released without a stat
+    };
+
+    /// Record @p observation; true if it differs from the previous one.
+    static bool observe(Pending &pending, const Observation &observation, qint64 nowMs);
+    /// True if @p pending is complete; otherwise schedules its next check.
+    bool settle(Pending &pending, bool changed, qint64 nowMs) const;
+
+    StatFunction m_stat;
+    qint64 m_quietPeriodMs;
+    quint64 m_nextSequence;
+    QHash<QString, Pending> m_pending;
+};
+
+Q_DECLARE_METATYPE(FileStabilityTracker::Observation)
+
+#endif // FILESTABILITYTRACKER_H
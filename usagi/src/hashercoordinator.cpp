@@ -2,6 +2,7 @@
 #include "window.h"
 #include "anidbapi.h"
 #include "hasherthreadpool.h"
+#include "hashingjobmodel.h"
 #include "logger.h"
 #include <QFileDialog>
 #include <QListView>
@@ -16,6 +17,14 @@
 // External hasher thread pool
 extern HasherThreadPool *hasherThreadPool;
 
+namespace {
+    // Key of a file in AniDBApi::batchLocalIdentify results
+    QString identifyKey(qint64 size, const QString &hash)
+    {
+        return QString("%1:%2").arg(size).arg(hash);
+    }
+}
+
 // Define static const members
 const int HasherCoordinator::HASHED_FILES_BATCH_SIZE;
 const int HasherCoordinator::HASHED_FILES_TIMER_INTERVAL;
@@ -27,10 +36,9 @@ HasherCoordinator::HasherCoordinator(AniDBApi *adbapi, QWidget *parent)
     , m_completedHashParts(0)
     , m_hasherThreadPool(hasherThreadPool)
 {
-    m_hashedFileColor = QColor(Qt::yellow);
-    
-    // Create timer for deferred processing
+    // Create timer for deferred processing (armed by queueHashedFileForProcessing)
     m_hashedFilesProcessingTimer = new QTimer(this);
+    m_hashedFilesProcessingTimer->setSingleShot(true);
     m_hashedFilesProcessingTimer->setInterval(HASHED_FILES_TIMER_INTERVAL);
     connect(m_hashedFilesProcessingTimer, &QTimer::timeout, this, &HasherCoordinator::processPendingHashedFiles);
     
@@ -55,6 +63,8 @@ void HasherCoordinator::createUI(QWidget *parent)
     m_button2 = new QPushButton("Add directories...");
     m_button3 = new QPushButton("Last directory");
     m_hashes = new hashes_();
+    m_hashingJobs = new HashingJobModel(this);
+    m_hashes->setModel(m_hashingJobs);
     m_hasherOutput = new QTextEdit;
     m_hasherFileState = new QComboBox;
     m_hasherFileState->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
@@ -91,38 +101,12 @@ void HasherCoordinator::createUI(QWidget *parent)
     m_progressTotal = new QProgressBar;
     m_progressTotalLabel = new QLabel;
     
-    // Setup hashes table
-    m_hashes->setColumnCount(10);
-    QStringList headers;
-    headers << "Filename" << "Status" << "Path" << "LF" << "LL" << "RF" << "RL" << "Move" << "Rename" << "Hash";
-    m_hashes->setHorizontalHeaderLabels(headers);
-    m_hashes->hideColumn(2); // Hide path column
-    m_hashes->hideColumn(9); // Hide hash column
+    // Setup hashes table (columns, titles and tooltips come from the model)
+    m_hashes->hideColumn(HashingJobModel::PathColumn);
+    m_hashes->hideColumn(HashingJobModel::HashColumn);
     m_hashes->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_hashes->horizontalHeader()->setStretchLastSection(true);
     
-    // Set tooltips for column headers (including hidden columns for completeness)
-    if (m_hashes->horizontalHeaderItem(0))
-        m_hashes->horizontalHeaderItem(0)->setToolTip("Name of the file");
-    if (m_hashes->horizontalHeaderItem(1))
-        m_hashes->horizontalHeaderItem(1)->setToolTip("Hashing progress (0=pending, 1=completed)");
-    if (m_hashes->horizontalHeaderItem(2))
-        m_hashes->horizontalHeaderItem(2)->setToolTip("Full path to the file (hidden)");
-    if (m_hashes->horizontalHeaderItem(3))
-        m_hashes->horizontalHeaderItem(3)->setToolTip("LF (Local File): Whether file info is in local database (0=no, 1=yes)");
-    if (m_hashes->horizontalHeaderItem(4))
-        m_hashes->horizontalHeaderItem(4)->setToolTip("LL (Local List/MyList): Whether file is in your MyList (0=no, 1=yes)");
-    if (m_hashes->horizontalHeaderItem(5))
-        m_hashes->horizontalHeaderItem(5)->setToolTip("RF (Remote File): AniDB FILE command API tag");
-    if (m_hashes->horizontalHeaderItem(6))
-        m_hashes->horizontalHeaderItem(6)->setToolTip("RL (Remote List): AniDB MYLIST command API tag");
-    if (m_hashes->horizontalHeaderItem(7))
-        m_hashes->horizontalHeaderItem(7)->setToolTip("Whether to move the file");
-    if (m_hashes->horizontalHeaderItem(8))
-        m_hashes->horizontalHeaderItem(8)->setToolTip("Whether to rename the file");
-    if (m_hashes->horizontalHeaderItem(9))
-        m_hashes->horizontalHeaderItem(9)->setToolTip("ED2K hash of the file (hidden)");
-    
     // Set minimum heights and size policies
     m_hashes->setMinimumHeight(100);
     m_hashes->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);  // Allow table to expand
@@ -342,77 +326,38 @@ void HasherCoordinator::updateFilterCache()
 
 void HasherCoordinator::hashesInsertRow(QFileInfo file, Qt::CheckState /*renameState*/, const QString& preloadedHash)
 {
-    int row = m_hashes->rowCount();
-    m_hashes->insertRow(row);
-    
-    QTableWidgetItem *item;
-    
-    // Filename
-    item = new QTableWidgetItem(file.fileName());
-    m_hashes->setItem(row, 0, item);
-    
-    // Status
-    item = new QTableWidgetItem(preloadedHash.isEmpty() ? "0" : "1");
-    m_hashes->setItem(row, 1, item);
-    
-    // Path
-    item = new QTableWidgetItem(file.absoluteFilePath());
-    m_hashes->setItem(row, 2, item);
-    
-    // LF, LL, RF, RL, Move, Rename columns - all start with "?"
-    for(int i = 3; i < 9; i++)
-    {
-        item = new QTableWidgetItem("?");
-        m_hashes->setItem(row, i, item);
-    }
-    
-    // Hash column
-    item = new QTableWidgetItem(preloadedHash);
-    if(!preloadedHash.isEmpty())
-    {
-        item->setBackground(QBrush(m_hashedFileColor));
-    }
-    m_hashes->setItem(row, 9, item);
+    m_hashingJobs->addJob(file, preloadedHash);
 }
 
 // Continuation in next message due to length...
 
 void HasherCoordinator::startHashing()
 {
-    QList<int> rowsWithHashes; // Rows that already have hashes
+    QList<int> jobsWithHashes; // Jobs that already have hashes
     int filesToHashCount = 0;
     
-    for(int i=0; i<m_hashes->rowCount(); i++)
+    for(int i=0; i<m_hashingJobs->rowCount(); i++)
     {
-        QString progress = m_hashes->item(i, 1)->text();
-        QString existingHash = m_hashes->item(i, 9)->text(); // Check hash column
+        const HashingJobModel::Job &job = m_hashingJobs->jobAt(i);
         
-        // Process files with progress="0" or progress="1" (already hashed but not yet API-processed)
-        if(progress == "0" || progress == "1")
+        // Process pending files and files already hashed but not yet API-processed
+        if(job.state == HashingJobModel::State::Pending || job.state == HashingJobModel::State::Hashed)
         {
-            // Check if file has pending API calls (tags in columns 5 or 6)
-            // Tags are "?" initially, set to actual tag when API call is queued, and "0" when completed/not needed
-            QString fileTag = m_hashes->item(i, 5)->text();
-            QString mylistTag = m_hashes->item(i, 6)->text();
-            bool hasPendingAPICalls = (!fileTag.isEmpty() && fileTag != "?" && fileTag != "0") || 
-                                      (!mylistTag.isEmpty() && mylistTag != "?" && mylistTag != "0");
-            
-            if (!existingHash.isEmpty())
+            if (!job.hash.isEmpty())
             {
-                // Skip files with pending API calls to avoid duplicate processing
-                if (!hasPendingAPICalls)
+                // Skip files with pending API calls (FILE/MYLISTADD tag set) to avoid duplicate processing
+                if (!job.hasPendingApiCall())
                 {
                     // File already has a hash - queue for deferred processing
-                    rowsWithHashes.append(i);
+                    jobsWithHashes.append(job.id);
                 }
             }
             else
             {
                 // File needs to be hashed
-                // Note: If progress="1" but no hash, this is an inconsistent state
-                if (progress == "1")
+                if (job.state == HashingJobModel::State::Hashed)
                 {
-                    LOG(QString("Warning: File at row %1 has progress=1 but no hash - inconsistent state").arg(i));
+                    LOG(QString("Warning: File at row %1 is hashed but has no hash - inconsistent state").arg(i));
                 }
                 filesToHashCount++;
             }
@@ -420,21 +365,15 @@ void HasherCoordinator::startHashing()
     }
     
     // Queue files with existing hashes for deferred processing to prevent UI freeze
-    for (int rowIndex : rowsWithHashes)
+    for (int jobId : jobsWithHashes)
     {
-        QString filename = m_hashes->item(rowIndex, 0)->text();
-        QString filePath = m_hashes->item(rowIndex, 2)->text();
-        QString hexdigest = m_hashes->item(rowIndex, 9)->text();
-        
-        LOG(QString("Queueing already-hashed file for processing: %1").arg(filename));
+        const HashingJobModel::Job *job = m_hashingJobs->job(jobId);
         
-        // Get file size
-        QFileInfo fileInfo(filePath);
-        qint64 fileSize = fileInfo.size();
+        LOG(QString("Queueing already-hashed file for processing: %1").arg(job->filename));
         
         // Queue for deferred processing using HashingTask class
-        HashingTask task(filePath, filename, hexdigest, fileSize);
-        task.setRowIndex(rowIndex);
+        HashingTask task(job->filePath, job->filename, job->hash, job->size);
+        task.setJobId(jobId);
         task.setUseUserSettings(true);
         task.setAddToMylist(m_addToMyList->checkState() > 0);
         task.setMarkWatchedState(m_markWatched->checkState());
@@ -443,9 +382,9 @@ void HasherCoordinator::startHashing()
     }
     
     // Start timer to process queued files in batches (keeps UI responsive)
-    if (!rowsWithHashes.isEmpty())
+    if (!jobsWithHashes.isEmpty())
     {
-        LOG(QString("Queued %1 already-hashed file(s) for deferred processing").arg(rowsWithHashes.size()));
+        LOG(QString("Queued %1 already-hashed file(s) for deferred processing").arg(jobsWithHashes.size()));
         m_hashedFilesProcessingTimer->start();
     }
     
@@ -462,7 +401,7 @@ void HasherCoordinator::startHashing()
             m_hasherThreadPool->start(filesToHashCount);
         }
     }
-    else if (rowsWithHashes.isEmpty())
+    else if (jobsWithHashes.isEmpty())
     {
         // No files to process at all
         LOG("No files to process");
@@ -470,7 +409,7 @@ void HasherCoordinator::startHashing()
     else
     {
         // Only had pre-hashed files, queued for processing
-        LOG(QString("Queued %1 already-hashed file(s) for processing").arg(rowsWithHashes.size()));
+        LOG(QString("Queued %1 already-hashed file(s) for processing").arg(jobsWithHashes.size()));
     }
 }
 
@@ -490,17 +429,9 @@ void HasherCoordinator::stopHashing()
         bar->setVisible(false); // Hide progress bars when stopping
     }
     
-    // Reset progress of files that were assigned but not completed
-    // Files with progress "0.1" were assigned to threads but stopped before completion
-    // Reset them to "0" so they can be picked up again on next start
-    for (int i = 0; i < m_hashes->rowCount(); i++)
-    {
-        QString progress = m_hashes->item(i, 1)->text();
-        if (progress == "0.1")
-        {
-            m_hashes->item(i, 1)->setText("0");
-        }
-    }
+    // Files assigned to threads but stopped before completion go back to pending
+    // so they can be picked up again on next start
+    m_hashingJobs->resetAssigned();
     
     // Notify all worker threads to stop hashing
     // 1. First, notify ed2k instances in all worker threads to interrupt current hashing
@@ -520,115 +451,41 @@ void HasherCoordinator::stopHashing()
 
 void HasherCoordinator::clearHasher()
 {
-    m_hashes->setRowCount(0);
+    m_hashingJobs->clear();
 }
 
 void HasherCoordinator::onFileHashed(int /*threadId*/, ed2k::ed2kfilestruct fileData)
 {
-    for(int i=0; i<m_hashes->rowCount(); i++)
+    // Pending or assigned job of that name and size; several files can share a name
+    const int jobId = m_hashingJobs->findUnhashed(fileData.filename, fileData.size);
+    const HashingJobModel::Job *job = m_hashingJobs->job(jobId);
+    if (!job)
     {
-        // Match by filename AND verify it's the file being hashed (progress starts with "0" - either "0" or "0.1" for assigned)
-        // This prevents matching wrong file when there are multiple files with the same name
-        QString progress = m_hashes->item(i, 1)->text();
-        if(m_hashes->item(i, 0)->text() == fileData.filename && progress.startsWith("0"))
-        {
-            // Additional check: verify file size matches to ensure we have the right file
-            QString filePath = m_hashes->item(i, 2)->text();
-            QFileInfo fileInfo(filePath);
-            if(!fileInfo.exists() || fileInfo.size() != fileData.size)
-            {
-                // Size mismatch or file doesn't exist - this is not the right file, continue searching
-                continue;
-            }
-            
-            // Mark as hashed in UI (use pre-allocated color object)
-            m_hashes->item(i, 0)->setBackground(m_hashedFileColor);
-            QTableWidgetItem *itemprogress = new QTableWidgetItem(QString("1"));
-            m_hashes->setItem(i, 1, itemprogress);
-            
-            // Generate and output ed2k link (no encoding)
-            QString ed2kLink = QString("ed2k://|file|%1|%2|%3|/")
-                .arg(fileData.filename)
-                .arg(fileData.size)
-                .arg(fileData.hexdigest);
-            m_hasherOutput->append(ed2kLink);
-            
-            emit logMessage(QString("File hashed: %1").arg(fileData.filename));
-            
-            // Update the hash column (column 9) in the UI to reflect the newly computed hash
-            if (QTableWidgetItem* hashItem = m_hashes->item(i, 9))
-            {
-                hashItem->setText(fileData.hexdigest);
-            }
-            else
-            {
-                // Column 9 doesn't exist, create it
-                QTableWidgetItem* newHashItem = new QTableWidgetItem(fileData.hexdigest);
-                m_hashes->setItem(i, 9, newHashItem);
-            }
-            
-            // Process file identification immediately instead of batching
-            if (m_addToMyList->checkState() > 0)
-            {
-                // Update hash in database with status=1 immediately
-                m_adbapi->updateLocalFileHash(filePath, fileData.hexdigest, 1);
-                
-                // Perform LocalIdentify immediately
-                // Note: This is done per-file instead of batching to provide immediate feedback
-                // LocalIdentify is a fast indexed database query, so the performance difference
-                // is negligible compared to the user experience improvement of seeing results
-                // immediately after each file is hashed rather than waiting for the entire batch
-                std::bitset<2> li = m_adbapi->LocalIdentify(fileData.size, fileData.hexdigest);
-                
-                // Update UI with LocalIdentify results
-                m_hashes->item(i, 3)->setText(QString((li[AniDBApi::LI_FILE_IN_DB])?"1":"0")); // File in database
-                
-                QString tag;
-                if(li[AniDBApi::LI_FILE_IN_DB] == 0)
-                {
-                    tag = m_adbapi->File(fileData.size, fileData.hexdigest);
-                    m_hashes->item(i, 5)->setText(tag);
-                    // File info not in local DB yet - File() API call queued to fetch from AniDB
-                }
-                else
-                {
-                    m_hashes->item(i, 5)->setText("0");
-                    // File is in local DB (previously fetched from AniDB)
-                    // Update status to 2 (in anidb) to prevent re-detection
-                    m_adbapi->UpdateLocalFileStatus(filePath, 2);
-                }
-
-                m_hashes->item(i, 4)->setText(QString((li[AniDBApi::LI_FILE_IN_MYLIST])?"1":"0")); // File in mylist
-                if(li[AniDBApi::LI_FILE_IN_MYLIST] == 0)
-                {
-                    tag = m_adbapi->MylistAdd(fileData.size, fileData.hexdigest, m_markWatched->checkState(), m_hasherFileState->currentIndex(), m_storage->text());
-                    m_hashes->item(i, 6)->setText(tag);
-                    // Status will be updated when MylistAdd completes (via UpdateLocalPath)
-                }
-                else
-                {
-                    m_hashes->item(i, 6)->setText("0");
-                    // File already in mylist - link the local_file and update status
-                    int lid = m_adbapi->LinkLocalFileToMylist(fileData.size, fileData.hexdigest, filePath);
-                    
-                    // Emit signal to notify that a file was linked to mylist (for card updates)
-                    if (lid > 0) {
-                        LOG(QString("File linked to mylist, emitting signal for lid=%1").arg(lid));
-                        emit fileLinkedToMylist(lid);
-                    } else {
-                        LOG(QString("WARNING: Failed to link file to mylist: %1 (size=%2, hash=%3)")
-                            .arg(filePath).arg(fileData.size).arg(fileData.hexdigest));
-                    }
-                }
-            }
-            else
-            {
-                LOG(QString("Skipping API processing for freshly hashed file: %1 (addToMylist=false)").arg(fileData.filename));
-            }
-            
-            break; // Found the file, no need to continue
-        }
+        return;
     }
+    const QString filePath = job->filePath;
+    
+    m_hashingJobs->setState(jobId, HashingJobModel::State::Hashed);
+    m_hashingJobs->setHash(jobId, fileData.hexdigest);
+    
+    // Generate and output ed2k link (no encoding)
+    QString ed2kLink = QString("ed2k://|file|%1|%2|%3|/")
+        .arg(fileData.filename)
+        .arg(fileData.size)
+        .arg(fileData.hexdigest);
+    m_hasherOutput->append(ed2kLink);
+    
+    emit logMessage(QString("File hashed: %1").arg(fileData.filename));
+    
+    // Database updates, identification and API calls run in batches
+    // (see processPendingHashedFiles) instead of once per file on the GUI thread
+    HashingTask task(filePath, fileData.filename, fileData.hexdigest, fileData.size);
+    task.setJobId(jobId);
+    task.setUseUserSettings(true);
+    task.setAddToMylist(m_addToMyList->checkState() > 0);
+    task.setMarkWatchedState(m_markWatched->checkState());
+    task.setFileState(m_hasherFileState->currentIndex());
+    queueHashedFileForProcessing(task);
 }
 
 void HasherCoordinator::onProgressUpdate(int threadId, int total, int done)
@@ -687,35 +544,41 @@ void HasherCoordinator::provideNextFileToHash()
     // Thread-safe file assignment: only one thread can request a file at a time
     QMutexLocker locker(&m_fileRequestMutex);
     
-    // Look through the hashes widget for the next file that needs hashing (progress="0" and no hash)
-    for(int i=0; i<m_hashes->rowCount(); i++)
+    if (m_hashingJobs->pendingCount() == 0)
     {
-        QString progress = m_hashes->item(i, 1)->text();
-        QString existingHash = m_hashes->item(i, 9)->text();
-        
-        if(progress == "0" && existingHash.isEmpty())
-        {
-            QString filePath = m_hashes->item(i, 2)->text();
-            
-            // Try to assign the file to a waiting thread
-            // addFile() will return true if a thread was waiting and received the file
-            if (m_hasherThreadPool && m_hasherThreadPool->addFile(filePath))
-            {
-                // File was successfully assigned to a waiting thread
-                // Now mark it as 0.1 to show it's being processed
-                QTableWidgetItem *itemProgressAssigned = new QTableWidgetItem(QString("0.1"));
-                m_hashes->setItem(i, 1, itemProgressAssigned);
-            }
-            return;
+        // No more files to hash, send empty string to signal completion
+        if (m_hasherThreadPool) {
+            m_hasherThreadPool->addFile(QString());
         }
+        return;
     }
     
-    // No more files to hash, send empty string to signal completion
-    if (m_hasherThreadPool) {
-        m_hasherThreadPool->addFile(QString());
+    // Highest watch root priority first, skipping roots at their hasher cap
+    const QStringList hashingFiles = m_hasherThreadPool ? m_hasherThreadPool->filesInProgress() : QStringList();
+    const int jobId = m_hashingJobs->nextToHash(hashingFiles);
+    if (jobId == 0)
+    {
+        // Every waiting file belongs to a root at its cap: the worker stays queued
+        // and gets a file when one of those finishes (it asks for its next file then)
+        return;
+    }
+    
+    // Try to assign the file to a waiting thread
+    // addFile() will return true if a thread was waiting and received the file
+    if (m_hasherThreadPool && m_hasherThreadPool->addFile(m_hashingJobs->job(jobId)->filePath))
+    {
+        // File was successfully assigned to a waiting thread
+        // Now mark it as 0.1 to show it's being processed
+        m_hashingJobs->setState(jobId, HashingJobModel::State::Assigned);
     }
 }
 
+void HasherCoordinator::setWatchRoots(const QList<WatchRoot> &roots)
+{
+    QMutexLocker locker(&m_fileRequestMutex);
+    m_hashingJobs->setWatchRoots(roots);
+}
+
 void HasherCoordinator::onMarkWatchedStateChanged(Qt::CheckState state)
 {
     switch(state)
@@ -768,17 +631,7 @@ int HasherCoordinator::calculateTotalHashParts(const QStringList &files)
 
 QStringList HasherCoordinator::getFilesNeedingHash()
 {
-    // TODO: Implement - extracted from Window::getFilesNeedingHash
-    QStringList files;
-    for(int i = 0; i < m_hashes->rowCount(); i++)
-    {
-        QString progress = m_hashes->item(i, 1)->text();
-        if(progress == "0")
-        {
-            files.append(m_hashes->item(i, 2)->text());
-        }
-    }
-    return files;
+    return m_hashingJobs->pendingFilePaths();
 }
 
 void HasherCoordinator::queueHashedFileForProcessing(const HashingTask &task)
@@ -788,10 +641,12 @@ void HasherCoordinator::queueHashedFileForProcessing(const HashingTask &task)
     QMutexLocker locker(&m_deferredProcessingMutex);
     m_pendingHashedFilesQueue.append(task);
     
-    // Start timer if not already running (protected by mutex to prevent race conditions)
+    // Flush once a full batch is waiting, otherwise HASHED_FILES_TIMER_INTERVAL after the first file
     // QTimer is thread-affine and must be accessed from the thread that created it
-    if (!m_hashedFilesProcessingTimer->isActive()) {
-        m_hashedFilesProcessingTimer->start();
+    if (m_pendingHashedFilesQueue.size() >= HASHED_FILES_BATCH_SIZE) {
+        m_hashedFilesProcessingTimer->start(0);
+    } else if (!m_hashedFilesProcessingTimer->isActive()) {
+        m_hashedFilesProcessingTimer->start(HASHED_FILES_TIMER_INTERVAL);
     }
 }
 
@@ -802,77 +657,100 @@ void HasherCoordinator::processPendingHashedFiles()
     {
         QMutexLocker locker(&m_deferredProcessingMutex);
         
-        // Take up to HASHED_FILES_BATCH_SIZE tasks from the queue
-        // Use takeLast() to avoid O(n) shifting on each removal (LIFO instead of FIFO)
-        // Processing order doesn't matter - all tasks are independent API calls
-        int batchSize = qMin(HASHED_FILES_BATCH_SIZE, m_pendingHashedFilesQueue.size());
-        tasksToProcess.reserve(batchSize);
-        for (int i = 0; i < batchSize; ++i) {
-            tasksToProcess.append(m_pendingHashedFilesQueue.takeLast());
+        const int batchSize = qMin(HASHED_FILES_BATCH_SIZE, static_cast<int>(m_pendingHashedFilesQueue.size()));
+        tasksToProcess = m_pendingHashedFilesQueue.mid(0, batchSize);
+        m_pendingHashedFilesQueue.remove(0, batchSize);
+        
+        // A backlog (e.g. thousands of pre-hashed files) is drained batch by batch
+        // without blocking the event loop in between
+        if (m_pendingHashedFilesQueue.size() >= HASHED_FILES_BATCH_SIZE) {
+            m_hashedFilesProcessingTimer->start(0);
+        } else if (!m_pendingHashedFilesQueue.isEmpty()) {
+            m_hashedFilesProcessingTimer->start(HASHED_FILES_TIMER_INTERVAL);
+        } else {
+            LOG("Finished processing all hashed files");
         }
     }
     
-    // Process tasks outside the mutex lock
-    // Order doesn't matter - each task is an independent set of API calls (LocalIdentify, File, MylistAdd)
+    if (tasksToProcess.isEmpty()) {
+        return;
+    }
+    
+    // One LocalIdentify batch for all files going to mylist
+    QList<QPair<qint64, QString>> sizeHashPairs;
     for (const HashingTask &task : tasksToProcess) {
-        // Mark as hashed in UI (use pre-allocated color object)
-        m_hashes->item(task.rowIndex(), 0)->setBackground(m_hashedFileColor);
-        m_hashes->item(task.rowIndex(), 1)->setText("1");
+        if (task.addToMylist()) {
+            sizeHashPairs.append(qMakePair(task.fileSize(), task.hash()));
+        }
+    }
+    const QMap<QString, std::bitset<2>> identified = m_adbapi->batchLocalIdentify(sizeHashPairs);
+    
+    // Store the hashes in one transaction per status:
+    // 2 (in anidb) for files already in the local file table, 1 (hashed, not checked by API) otherwise
+    QList<QPair<QString, QString>> hashedFiles;
+    QList<QPair<QString, QString>> knownFiles;
+    for (const HashingTask &task : tasksToProcess) {
+        // Mark as hashed in UI
+        m_hashingJobs->setState(task.jobId(), HashingJobModel::State::Hashed);
         
-        // Update hash in database with status=1
-        m_adbapi->updateLocalFileHash(task.filePath(), task.hash(), 1);
+        const std::bitset<2> li = identified.value(identifyKey(task.fileSize(), task.hash()));
+        if (task.addToMylist() && li[AniDBApi::LI_FILE_IN_DB]) {
+            knownFiles.append(qMakePair(task.filePath(), task.hash()));
+        } else {
+            hashedFiles.append(qMakePair(task.filePath(), task.hash()));
+        }
+    }
+    m_adbapi->batchUpdateLocalFileHashes(hashedFiles, 1);
+    m_adbapi->batchUpdateLocalFileHashes(knownFiles, 2);
+    
+    // Queue the API calls; the table is updated once for the whole batch
+    QList<HashingJobModel::Identification> results;
+    results.reserve(tasksToProcess.size());
+    for (const HashingTask &task : tasksToProcess) {
+        if (!task.addToMylist()) {
+            LOG(QString("Skipping API processing for hashed file: %1 (addToMylist=false)").arg(task.filename()));
+            continue;
+        }
         
-        // If adding to mylist, perform API calls (API methods handle auth internally)
-        if (task.addToMylist()) {
-            // Perform LocalIdentify
-            std::bitset<2> li = m_adbapi->LocalIdentify(task.fileSize(), task.hash());
-            
-            // Update UI with LocalIdentify results
-            m_hashes->item(task.rowIndex(), 3)->setText(QString((li[AniDBApi::LI_FILE_IN_DB])?"1":"0"));
+        const std::bitset<2> li = identified.value(identifyKey(task.fileSize(), task.hash()));
+        HashingJobModel::Identification result;
+        result.id = task.jobId();
+        result.inLocalDatabase = li[AniDBApi::LI_FILE_IN_DB];
+        result.inLocalMylist = li[AniDBApi::LI_FILE_IN_MYLIST];
+        
+        if (li[AniDBApi::LI_FILE_IN_DB] == 0) {
+            // File info not in local DB yet - File() API call queued to fetch from AniDB
+            // Status will be updated to 2 when subsequent MylistAdd completes (via UpdateLocalPath)
+            result.fileTag = m_adbapi->File(task.fileSize(), task.hash());
+        } else {
+            result.fileTag = "0";
+        }
+        
+        if (li[AniDBApi::LI_FILE_IN_MYLIST] == 0) {
+            // Use settings from the task
+            int markWatched = task.useUserSettings() ? task.markWatchedState() : Qt::Unchecked;
+            int fileState = task.useUserSettings() ? task.fileState() : 1;
+            result.mylistTag = m_adbapi->MylistAdd(task.fileSize(), task.hash(), markWatched, fileState, m_storage->text());
+            // Status will be updated when MylistAdd completes (via UpdateLocalPath)
+        } else {
+            result.mylistTag = "0";
+            // File already in mylist - link the local_file (sets status and binding_status)
+            int lid = m_adbapi->LinkLocalFileToMylist(task.fileSize(), task.hash(), task.filePath());
             
-            QString tag;
-            if(li[AniDBApi::LI_FILE_IN_DB] == 0) {
-                tag = m_adbapi->File(task.fileSize(), task.hash());
-                m_hashes->item(task.rowIndex(), 5)->setText(tag);
-                // File info not in local DB yet - File() API call queued to fetch from AniDB
-                // Status will be updated to 2 when subsequent MylistAdd completes (via UpdateLocalPath)
+            // Emit signal to notify that a file was linked to mylist (for card updates)
+            if (lid > 0) {
+                LOG(QString("File linked to mylist, emitting signal for lid=%1").arg(lid));
+                emit fileLinkedToMylist(lid);
             } else {
-                m_hashes->item(task.rowIndex(), 5)->setText("0");
-                // File is in local DB (previously fetched from AniDB)
-                // Update status to 2 (in anidb) to prevent re-detection
+                LOG(QString("WARNING: Failed to link file to mylist: %1 (size=%2, hash=%3)")
+                    .arg(task.filePath()).arg(task.fileSize()).arg(task.hash()));
+                // Still mark it as in anidb so that it is not detected again
                 m_adbapi->UpdateLocalFileStatus(task.filePath(), 2);
             }
-
-            m_hashes->item(task.rowIndex(), 4)->setText(QString((li[AniDBApi::LI_FILE_IN_MYLIST])?"1":"0"));
-            if(li[AniDBApi::LI_FILE_IN_MYLIST] == 0) {
-                // Use settings from the task
-                int markWatched = task.useUserSettings() ? task.markWatchedState() : Qt::Unchecked;
-                int fileState = task.useUserSettings() ? task.fileState() : 1;
-                tag = m_adbapi->MylistAdd(task.fileSize(), task.hash(), markWatched, fileState, m_storage->text());
-                m_hashes->item(task.rowIndex(), 6)->setText(tag);
-                // Status will be updated when MylistAdd completes (via UpdateLocalPath)
-            } else {
-                m_hashes->item(task.rowIndex(), 6)->setText("0");
-                // File already in mylist - link the local_file and update status
-                int lid = m_adbapi->LinkLocalFileToMylist(task.fileSize(), task.hash(), task.filePath());
-                if (lid > 0) {
-                    LOG(QString("Already-hashed file linked to mylist, emitting signal for lid=%1").arg(lid));
-                    emit fileLinkedToMylist(lid);
-                } else {
-                    m_adbapi->UpdateLocalFileStatus(task.filePath(), 2);
-                }
-            }
-        } else {
-            LOG(QString("Skipping API processing for already-hashed file: %1 (addToMylist=false)").arg(task.filename()));
         }
+        results.append(result);
     }
+    m_hashingJobs->setIdentified(results);
     
-    // Check if queue is empty and stop timer if so
-    {
-        QMutexLocker locker(&m_deferredProcessingMutex);
-        if (m_pendingHashedFilesQueue.isEmpty()) {
-            m_hashedFilesProcessingTimer->stop();
-            LOG("Finished processing all already-hashed files");
-        }
-    }
+    LOG(QString("Processed a batch of %1 hashed file(s), %2 identified").arg(tasksToProcess.size()).arg(results.size()));
 }
@@ -19,16 +19,18 @@
 #include <QStringList>
 #include <QList>
 #include <QRegularExpression>
-#include <QTableWidget>
+#include <QTableView>
 #include <QUrl>
 #include "hash/ed2k.h"
 #include "hashingtask.h"
 #include "progresstracker.h"
+#include "watchroot.h"
 
 // Forward declarations
 class AniDBApi;
 class HasherThreadPool;
 class hashes_;
+class HashingJobModel;
 
 /**
  * HasherCoordinator - Manages the file hashing UI and coordination
@@ -39,6 +41,7 @@ class hashes_;
  * - Coordination with HasherThreadPool
  * - Progress tracking and display
  * - File filtering based on masks
+ * - The hasher queue (HashingJobModel), shown in the hashes_ table view
  * 
  * Design principles:
  * - Single Responsibility: Only handles hasher coordination
@@ -56,9 +59,12 @@ public:
     // Get the hasher page widget to add to Window's tab widget
     QWidget* getHasherPageWidget() const { return m_pageHasherParent; }
     
-    // Get the hashes table widget for external access
+    // Get the hashes table view for external access
     hashes_* getHashesTable() const { return m_hashes; }
     
+    // Get the hasher queue shown in the hashes table
+    HashingJobModel* getHashingJobs() const { return m_hashingJobs; }
+    
     // Get hasher output widget
     QTextEdit* getHasherOutput() const { return m_hasherOutput; }
     
@@ -85,6 +91,9 @@ public:
     void setupHashingProgress(const QStringList &files);
     void queueHashedFileForProcessing(const HashingTask &task);
     
+    // Per-root hashing priority and concurrency cap (see WatchRoot)
+    void setWatchRoots(const QList<WatchRoot> &roots);
+    
 signals:
     // Signal to notify when hashing is finished
     void hashingFinished();
@@ -155,7 +164,8 @@ private:
     QLineEdit *m_moveToDir;
     QLineEdit *m_renameToPattern;
     
-    hashes_ *m_hashes;  // Hash table widget
+    hashes_ *m_hashes;  // Hash table view
+    HashingJobModel *m_hashingJobs;  // Hasher queue shown in m_hashes
     
     // Reference to AniDBApi (not owned)
     AniDBApi *m_adbapi;
@@ -169,12 +179,12 @@ private:
     // File management
     QMutex m_fileRequestMutex;
     
-    // Deferred processing
-    static const int HASHED_FILES_BATCH_SIZE = 5;
-    static const int HASHED_FILES_TIMER_INTERVAL = 10;
+    // Deferred processing: hashed files are stored, identified and sent to the API in batches,
+    // flushed every HASHED_FILES_BATCH_SIZE files or HASHED_FILES_TIMER_INTERVAL ms
+    static const int HASHED_FILES_BATCH_SIZE = 50;
+    static const int HASHED_FILES_TIMER_INTERVAL = 250;
     QList<HashingTask> m_pendingHashedFilesQueue;
     QTimer *m_hashedFilesProcessingTimer;
-    QColor m_hashedFileColor;
     QMutex m_deferredProcessingMutex;  // Protects m_pendingHashedFilesQueue
     
     // Filter cache
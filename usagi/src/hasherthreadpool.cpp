@@ -75,6 +75,7 @@ bool HasherThreadPool::addFile(const QString &filePath)
         {
             // A worker is waiting for work - give it the file
             targetWorker = requestQueue.dequeue();
+            currentFiles.insert(targetWorker, filePath);
         }
     }
     
@@ -205,6 +206,12 @@ bool HasherThreadPool::isRunning() const
     return false;
 }
 
+QStringList HasherThreadPool::filesInProgress() const
+{
+    QMutexLocker locker(&requestMutex);
+    return currentFiles.values();
+}
+
 void HasherThreadPool::onThreadRequestNextFile()
 {
     // Track which worker is requesting the next file in a FIFO queue
@@ -213,6 +220,8 @@ void HasherThreadPool::onThreadRequestNextFile()
     if (requestingWorker != nullptr)
     {
         QMutexLocker locker(&requestMutex);
+        // Asking for the next file means the previous one is done (hashed or failed)
+        currentFiles.remove(requestingWorker);
         if (noMoreFiles) {
             requestingWorker->addFile(QString());
             return;
@@ -342,6 +351,7 @@ void HasherThreadPool::cleanupFinishedThreads()
     {
         QMutexLocker locker(&requestMutex);
         requestQueue.clear();
+        currentFiles.clear();
     }
     
     // Now delete all worker threads
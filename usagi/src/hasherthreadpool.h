@@ -2,9 +2,11 @@
 #define HASHERTHREADPOOL_H
 
 #include <QObject>
+#include <QHash>
 #include <QMutex>
 #include <QQueue>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QThread>
 #include "hash/ed2k.h"
@@ -78,6 +80,12 @@ public:
      */
     bool isRunning() const;
     
+    /**
+     * Returns the files handed to workers that have not asked for their next file yet,
+     * i.e. the files being hashed right now.
+     */
+    QStringList filesInProgress() const;
+    
 signals:
     /**
      * Emitted when a file has been successfully hashed.
@@ -132,8 +140,9 @@ private:
     
     QVector<HasherThread*> workers;
     QMutex mutex;
-    QMutex requestMutex;  // Protects requestQueue
+    mutable QMutex requestMutex;  // Protects requestQueue and currentFiles
     QQueue<HasherThread*> requestQueue;  // FIFO queue of workers requesting files
+    QHash<HasherThread*, QString> currentFiles;  // File each busy worker is hashing
     int maxThreads;  // Maximum number of concurrent threads
     int nextThreadId;  // Counter for assigning unique thread IDs
     int activeThreads;  // Number of threads currently running
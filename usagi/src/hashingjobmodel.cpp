@@ -0,0 +1,464 @@
+#include "hashingjobmodel.h"
+#include <QBrush>
+#include <QColor>
+#include <algorithm>
+
+namespace {
+    const char *const COLUMN_TITLES[HashingJobModel::ColumnCount] = {
+        "Filename", "Progress", "path", "LF", "LL", "RF", "RL", "Ren", "FP", "Hash"
+    };
+
+    const char *const COLUMN_TOOLTIPS[HashingJobModel::ColumnCount] = {
+        "Name of the file",
+        "Hashing progress (0=pending, 1=completed)",
+        "Full path to the file (hidden)",
+        "LF (Local File): Whether file info is in local database (0=no, 1=yes)",
+        "LL (Local List/MyList): Whether file is in your MyList (0=no, 1=yes)",
+        "RF (Remote File): AniDB FILE command API tag",
+        "RL (Remote List): AniDB MYLIST command API tag",
+        "Whether to move the file",
+        "Whether to rename the file",
+        "ED2K hash of the file (hidden)"
+    };
+
+    QString flagText(HashingJobModel::Flag flag)
+    {
+        switch (flag) {
+            case HashingJobModel::Flag::No:
+                return "0";
+            case HashingJobModel::Flag::Yes:
+                return "1";
+            default:
+                return "?";
+        }
+    }
+
+    bool isUnhashed(HashingJobModel::State state)
+    {
+        return state == HashingJobModel::State::Pending || state == HashingJobModel::State::Assigned;
+    }
+}
+
+bool HashingJobModel::Job::hasPendingApiCall() const
+{
+    return (!fileTag.isEmpty() && fileTag != "0") || (!mylistTag.isEmpty() && mylistTag != "0");
+}
+
+HashingJobModel::HashingJobModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pendingByRoot(1)
+    , m_nextId(1)
+{
+}
+
+int HashingJobModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_jobs.size());
+}
+
+int HashingJobModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant HashingJobModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_jobs.size()) {
+        return QVariant();
+    }
+    const Job &job = m_jobs.at(index.row());
+
+    if (role == Qt::BackgroundRole && index.column() == FilenameColumn) {
+        switch (job.state) {
+            case State::Hashed:
+                return QBrush(Qt::yellow);
+            case State::AlreadyInMylist:
+                return QBrush(QColor(0, 255, 0));
+            case State::AddedToMylist:
+                return QBrush(QColor(0, 140, 0));
+            case State::NotInAniDB:
+                return QBrush(QColor(255, 0, 0));
+            default:
+                return QVariant();
+        }
+    }
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole) {
+        return QVariant();
+    }
+
+    switch (index.column()) {
+        case FilenameColumn:
+            return role == Qt::ToolTipRole ? job.filePath : job.filename;
+        case StatusColumn:
+            return stateText(job.state);
+        case PathColumn:
+            return job.filePath;
+        case LocalFileColumn:
+            return flagText(job.inLocalDatabase);
+        case LocalListColumn:
+            return flagText(job.inLocalMylist);
+        case RemoteFileColumn:
+            return job.fileTag.isEmpty() ? QString("?") : job.fileTag;
+        case RemoteListColumn:
+            return job.mylistTag.isEmpty() ? QString("?") : job.mylistTag;
+        case MoveColumn:
+        case RenameColumn:
+            return QString("?");
+        case HashColumn:
+            return job.hash;
+        default:
+            return QVariant();
+    }
+}
+
+QVariant HashingJobModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || section < 0 || section >= ColumnCount) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    if (role == Qt::DisplayRole) {
+        return QString(COLUMN_TITLES[section]);
+    }
+    if (role == Qt::ToolTipRole) {
+        return QString(COLUMN_TOOLTIPS[section]);
+    }
+    return QVariant();
+}
+
+bool HashingJobModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > m_jobs.size()) {
+        return false;
+    }
+    QList<int> rows;
+    rows.reserve(count);
+    for (int i = row; i < row + count; ++i) {
+        rows.append(i);
+    }
+    removeRowsAt(rows);
+    return true;
+}
+
+int HashingJobModel::addJob(const QFileInfo &file, const QString &preloadedHash)
+{
+    Job job;
+    job.id = m_nextId++;
+    job.filename = file.fileName();
+    job.filePath = file.absoluteFilePath();
+    job.size = file.size();
+    job.hash = preloadedHash;
+    job.state = preloadedHash.isEmpty() ? State::Pending : State::Hashed;
+    job.rootIndex = WatchRoot::indexOf(m_roots, job.filePath);
+
+    const int row = static_cast<int>(m_jobs.size());
+    beginInsertRows(QModelIndex(), row, row);
+    m_jobs.append(job);
+    m_rowById.insert(job.id, row);
+    m_idByPath.insert(job.filePath, job.id);
+    indexState(job);
+    endInsertRows();
+    return job.id;
+}
+
+void HashingJobModel::removeRowsAt(QList<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    // Contiguous ranges from the bottom up; the id -> row index is rebuilt once
+    int end = static_cast<int>(rows.size()) - 1;
+    while (end >= 0) {
+        int begin = end;
+        while (begin > 0 && rows.at(begin - 1) == rows.at(begin) - 1) {
+            --begin;
+        }
+        const int first = rows.at(begin);
+        const int last = rows.at(end);
+        if (first >= 0 && last < m_jobs.size()) {
+            beginRemoveRows(QModelIndex(), first, last);
+            for (int row = first; row <= last; ++row) {
+                const Job &job = m_jobs.at(row);
+                unindexState(job);
+                m_rowById.remove(job.id);
+                if (m_idByPath.value(job.filePath) == job.id) {
+                    m_idByPath.remove(job.filePath);
+                }
+                if (m_idByTag.value(job.fileTag) == job.id) {
+                    m_idByTag.remove(job.fileTag);
+                }
+                if (m_idByTag.value(job.mylistTag) == job.id) {
+                    m_idByTag.remove(job.mylistTag);
+                }
+            }
+            m_jobs.remove(first, last - first + 1);
+            endRemoveRows();
+        }
+        end = begin - 1;
+    }
+    rebuildRows();
+}
+
+void HashingJobModel::clear()
+{
+    beginResetModel();
+    m_jobs.clear();
+    m_rowById.clear();
+    m_idByTag.clear();
+    m_idByPath.clear();
+    m_unhashedByFilename.clear();
+    m_pending.clear();
+    for (std::set<int> &pending : m_pendingByRoot) {
+        pending.clear();
+    }
+    endResetModel();
+}
+
+const HashingJobModel::Job* HashingJobModel::job(int id) const
+{
+    const int row = rowOf(id);
+    return row >= 0 ? &m_jobs.at(row) : nullptr;
+}
+
+int HashingJobModel::findUnhashed(const QString &filename, qint64 size) const
+{
+    int pendingMatch = 0;
+    int assignedByName = 0;
+    int assignedByNameCount = 0;
+    for (auto it = m_unhashedByFilename.constFind(filename);
+         it != m_unhashedByFilename.constEnd() && it.key() == filename; ++it) {
+        const Job *candidate = job(it.value());
+        if (!candidate) {
+            continue;
+        }
+        if (candidate->state == State::Assigned) {
+            if (candidate->size == size) {
+                return candidate->id;
+            }
+            assignedByName = candidate->id;
+            ++assignedByNameCount;
+        } else if (candidate->size == size && (pendingMatch == 0 || candidate->id < pendingMatch)) {
+            // Stopped while hashing: the job went back to pending
+            pendingMatch = candidate->id;
+        }
+    }
+    if (pendingMatch == 0 && assignedByNameCount == 1) {
+        // The file grew or shrank after it was queued
+        return assignedByName;
+    }
+    return pendingMatch;
+}
+
+QStringList HashingJobModel::pendingFilePaths() const
+{
+    QStringList paths;
+    paths.reserve(static_cast<qsizetype>(m_pending.size()));
+    for (int id : m_pending) {
+        paths.append(m_jobs.at(rowOf(id)).filePath);
+    }
+    return paths;
+}
+
+int HashingJobModel::nextToHash(const QStringList &hashing) const
+{
+    // Files in flight per root; only capped roots need counting
+    QVector<int> inFlight(m_roots.size(), 0);
+    for (const QString &filePath : hashing) {
+        const Job *inProgress = job(m_idByPath.value(filePath, 0));
+        const int index = inProgress ? inProgress->rootIndex : WatchRoot::indexOf(m_roots, filePath);
+        if (index >= 0 && index < inFlight.size()) {
+            ++inFlight[index];
+        }
+    }
+
+    int best = 0;
+    int bestPriority = 0;
+    for (int slot = 0; slot < m_pendingByRoot.size(); ++slot) {
+        const std::set<int> &pending = m_pendingByRoot.at(slot);
+        if (pending.empty()) {
+            continue;
+        }
+        int priority = 0;
+        if (slot < m_roots.size()) {
+            const WatchRoot &root = m_roots.at(slot);
+            if (root.maxHashers > 0 && inFlight.at(slot) >= root.maxHashers) {
+                continue;
+            }
+            priority = root.priority;
+        }
+        // Equal priorities: the earlier row wins
+        const int first = *pending.begin();
+        if (best == 0 || priority > bestPriority || (priority == bestPriority && first < best)) {
+            best = first;
+            bestPriority = priority;
+        }
+    }
+    return best;
+}
+
+void HashingJobModel::setWatchRoots(const QList<WatchRoot> &roots)
+{
+    for (const Job &job : std::as_const(m_jobs)) {
+        unindexState(job);
+    }
+    m_roots = roots;
+    m_pendingByRoot = QVector<std::set<int>>(m_roots.size() + 1);
+    for (Job &job : m_jobs) {
+        job.rootIndex = WatchRoot::indexOf(m_roots, job.filePath);
+        indexState(job);
+    }
+}
+
+void HashingJobModel::setState(int id, State state)
+{
+    const int row = rowOf(id);
+    if (row < 0 || m_jobs.at(row).state == state) {
+        return;
+    }
+    Job &job = m_jobs[row];
+    unindexState(job);
+    job.state = state;
+    indexState(job);
+    emitRowChanged(id, FilenameColumn, StatusColumn);
+}
+
+void HashingJobModel::setHash(int id, const QString &hash)
+{
+    const int row = rowOf(id);
+    if (row < 0) {
+        return;
+    }
+    m_jobs[row].hash = hash;
+    emitRowChanged(id, HashColumn, HashColumn);
+}
+
+void HashingJobModel::setLocalIdentify(int id, bool inLocalDatabase, bool inLocalMylist)
+{
+    const int row = rowOf(id);
+    if (row < 0) {
+        return;
+    }
+    m_jobs[row].inLocalDatabase = inLocalDatabase ? Flag::Yes : Flag::No;
+    m_jobs[row].inLocalMylist = inLocalMylist ? Flag::Yes : Flag::No;
+    emitRowChanged(id, LocalFileColumn, LocalListColumn);
+}
+
+void HashingJobModel::setFileTag(int id, const QString &tag)
+{
+    const int row = rowOf(id);
+    if (row >= 0) {
+        setTag(m_jobs[row].fileTag, id, tag);
+        emitRowChanged(id, RemoteFileColumn, RemoteFileColumn);
+    }
+}
+
+void HashingJobModel::setMylistTag(int id, const QString &tag)
+{
+    const int row = rowOf(id);
+    if (row >= 0) {
+        setTag(m_jobs[row].mylistTag, id, tag);
+        emitRowChanged(id, RemoteListColumn, RemoteListColumn);
+    }
+}
+
+void HashingJobModel::setIdentified(const QList<Identification> &results)
+{
+    int firstRow = -1;
+    int lastRow = -1;
+    for (const Identification &result : results) {
+        const int row = rowOf(result.id);
+        if (row < 0) {
+            continue;
+        }
+        Job &job = m_jobs[row];
+        job.inLocalDatabase = result.inLocalDatabase ? Flag::Yes : Flag::No;
+        job.inLocalMylist = result.inLocalMylist ? Flag::Yes : Flag::No;
+        setTag(job.fileTag, result.id, result.fileTag);
+        setTag(job.mylistTag, result.id, result.mylistTag);
+        firstRow = firstRow < 0 ? row : qMin(firstRow, row);
+        lastRow = qMax(lastRow, row);
+    }
+    if (firstRow >= 0) {
+        emit dataChanged(index(firstRow, LocalFileColumn), index(lastRow, RemoteListColumn));
+    }
+}
+
+void HashingJobModel::resetAssigned()
+{
+    for (Job &job : m_jobs) {
+        if (job.state == State::Assigned) {
+            unindexState(job);
+            job.state = State::Pending;
+            indexState(job);
+            emitRowChanged(job.id, FilenameColumn, StatusColumn);
+        }
+    }
+}
+
+QString HashingJobModel::stateText(State state)
+{
+    switch (state) {
+        case State::Pending:
+            return "0";
+        case State::Assigned:
+            return "0.1";
+        case State::Hashed:
+            return "1";
+        case State::AlreadyInMylist:
+            return "2";
+        case State::AddedToMylist:
+            return "3";
+        case State::NotInAniDB:
+            return "4";
+    }
+    return QString();
+}
+
+void HashingJobModel::indexState(const Job &job)
+{
+    if (isUnhashed(job.state)) {
+        m_unhashedByFilename.insert(job.filename, job.id);
+    }
+    if (job.state == State::Pending) {
+        m_pending.insert(job.id);
+        m_pendingByRoot[rootSlot(job.rootIndex)].insert(job.id);
+    }
+}
+
+void HashingJobModel::unindexState(const Job &job)
+{
+    if (isUnhashed(job.state)) {
+        m_unhashedByFilename.remove(job.filename, job.id);
+    }
+    if (job.state == State::Pending) {
+        m_pending.erase(job.id);
+        m_pendingByRoot[rootSlot(job.rootIndex)].erase(job.id);
+    }
+}
+
+void HashingJobModel::setTag(QString &field, int id, const QString &tag)
+{
+    if (m_idByTag.value(field) == id) {
+        m_idByTag.remove(field);
+    }
+    field = tag;
+    if (!tag.isEmpty() && tag != "0") {
+        m_idByTag.insert(tag, id);
+    }
+}
+
+void HashingJobModel::rebuildRows()
+{
+    m_rowById.clear();
+    m_rowById.reserve(m_jobs.size());
+    for (int row = 0; row < m_jobs.size(); ++row) {
+        m_rowById.insert(m_jobs.at(row).id, row);
+    }
+}
+
+void HashingJobModel::emitRowChanged(int id, int firstColumn, int lastColumn)
+{
+    const int row = rowOf(id);
+    if (row >= 0) {
+        emit dataChanged(index(row, firstColumn), index(row, lastColumn));
+    }
+}
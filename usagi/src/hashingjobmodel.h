@@ -0,0 +1,157 @@
+#ifndef HASHINGJOBMODEL_H
+#define HASHINGJOBMODEL_H
+
+#include <QAbstractTableModel>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMultiHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <set>
+#include "watchroot.h"
+
+/**
+ * HashingJobModel - The hasher queue: one job per file, shown in the hasher table
+ *
+ * Every job has a stable id (rows move when rows above them are removed) and a
+ * typed state instead of the status text of the old table widget. The lookups
+ * the hasher does per file go through indexes kept alongside the rows:
+ *   - id -> row, API tag -> job (FILE/MYLISTADD replies)
+ *   - filename -> unhashed jobs (a finished hash names the file, not the path)
+ *   - pending jobs per watch root, in row order (the next file to hash)
+ * so queuing tens of thousands of files keeps each hashed file cheap and never
+ * touches the disk.
+ */
+class HashingJobModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        FilenameColumn = 0,
+        StatusColumn,
+        PathColumn,             // Hidden
+        LocalFileColumn,        // LF: file known in the local database
+        LocalListColumn,        // LL: file in the local mylist
+        RemoteFileColumn,       // RF: FILE API tag, "0" when not needed
+        RemoteListColumn,       // RL: MYLISTADD API tag, "0" when not needed
+        MoveColumn,
+        RenameColumn,
+        HashColumn,             // Hidden
+        ColumnCount
+    };
+
+    // Status column: 0, 0.1, 1, 2, 3 and 4 in the order below
+    enum class State {
+        Pending,                // Waiting for a hasher thread
+        Assigned,               // Given to a hasher thread
+        Hashed,                 // Hash known, API not done yet
+        AlreadyInMylist,        // MYLISTADD 310
+        AddedToMylist,          // MYLISTADD 311/210
+        NotInAniDB              // MYLISTADD 320
+    };
+
+    // "?" until LocalIdentify ran for the file
+    enum class Flag { Unknown, No, Yes };
+
+    struct Job {
+        int id = 0;
+        QString filename;
+        QString filePath;
+        qint64 size = 0;
+        State state = State::Pending;
+        QString hash;
+        Flag inLocalDatabase = Flag::Unknown;
+        Flag inLocalMylist = Flag::Unknown;
+        QString fileTag;        // Empty until the FILE call was decided
+        QString mylistTag;      // Empty until the MYLISTADD call was decided
+        int rootIndex = -1;     // Watch root of the file, -1 if none
+
+        // A FILE or MYLISTADD reply is still outstanding
+        bool hasPendingApiCall() const;
+    };
+
+    // LocalIdentify result and the API calls queued for one hashed file
+    struct Identification {
+        int id = 0;
+        bool inLocalDatabase = false;
+        bool inLocalMylist = false;
+        QString fileTag;        // "0" when no FILE call was needed
+        QString mylistTag;      // "0" when no MYLISTADD call was needed
+    };
+
+    explicit HashingJobModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    // Append a job; a preloaded hash makes it Hashed. Returns the job id.
+    int addJob(const QFileInfo &file, const QString &preloadedHash = QString());
+
+    // Remove the jobs in the given rows (any order, duplicates allowed)
+    void removeRowsAt(QList<int> rows);
+    void clear();
+
+    const Job& jobAt(int row) const { return m_jobs.at(row); }
+    const Job* job(int id) const;
+    int rowOf(int id) const { return m_rowById.value(id, -1); }
+
+    // Job waiting on an API reply with this tag, 0 if none
+    int jobIdForTag(const QString &tag) const { return m_idByTag.value(tag, 0); }
+
+    // Job a finished hash belongs to: a pending or assigned job of that file name
+    // and size, preferring assigned ones. 0 if none.
+    int findUnhashed(const QString &filename, qint64 size) const;
+
+    // Pending files in row order
+    QStringList pendingFilePaths() const;
+    int pendingCount() const { return static_cast<int>(m_pending.size()); }
+
+    // Pending job a free hasher thread should get: the first in row order of the
+    // highest priority root that is below its hasher cap (see WatchRoot).
+    // hashing: files on hasher threads right now. 0 if every pending job waits on a cap.
+    int nextToHash(const QStringList &hashing) const;
+
+    // Watch roots the jobs are grouped by; regroups all jobs
+    void setWatchRoots(const QList<WatchRoot> &roots);
+
+    void setState(int id, State state);
+    void setHash(int id, const QString &hash);
+    void setLocalIdentify(int id, bool inLocalDatabase, bool inLocalMylist);
+    void setFileTag(int id, const QString &tag);
+    void setMylistTag(int id, const QString &tag);
+
+    // Results of one identification batch, reported with a single dataChanged
+    void setIdentified(const QList<Identification> &results);
+
+    // Assigned jobs go back to pending (hashing was stopped)
+    void resetAssigned();
+
+    static QString stateText(State state);
+
+private:
+    // Pending and assigned jobs are indexed by file name, pending ones per root
+    void indexState(const Job &job);
+    void unindexState(const Job &job);
+    void setTag(QString &field, int id, const QString &tag);
+    void rebuildRows();
+    void emitRowChanged(int id, int firstColumn, int lastColumn);
+    int rootSlot(int rootIndex) const { return rootIndex < 0 ? static_cast<int>(m_roots.size()) : rootIndex; }
+
+    QList<Job> m_jobs;
+    QHash<int, int> m_rowById;
+    QHash<QString, int> m_idByTag;
+    QHash<QString, int> m_idByPath;
+    QMultiHash<QString, int> m_unhashedByFilename;
+    std::set<int> m_pending;                        // Ids; ids grow with the row order
+    QVector<std::set<int>> m_pendingByRoot;         // Per root, last slot: files below no root
+    QList<WatchRoot> m_roots;
+    int m_nextId;
+};
+
+#endif // HASHINGJOBMODEL_H
@@ -2,7 +2,7 @@
 #include <QFileInfo>
 
 HashingTask::HashingTask()
-    : m_rowIndex(-1)
+    : m_jobId(0)
     , m_fileSize(0)
     , m_useUserSettings(true)
     , m_addToMylist(false)
@@ -13,7 +13,7 @@ HashingTask::HashingTask()
 
 HashingTask::HashingTask(const QString& filePath, const QString& filename, 
                          const QString& hexdigest, qint64 fileSize)
-    : m_rowIndex(-1)
+    : m_jobId(0)
     , m_filePath(filePath)
     , m_filename(filename)
     , m_hexdigest(hexdigest)
@@ -44,14 +44,14 @@ public:
                 const QString& hexdigest, qint64 fileSize);
     
     // File information getters
-    int rowIndex() const { return m_rowIndex; }
+    int jobId() const { return m_jobId; }  // HashingJobModel job of the hasher row
     QString filePath() const { return m_filePath; }
     QString filename() const { return m_filename; }
     QString hash() const { return m_hexdigest; }
     qint64 fileSize() const { return m_fileSize; }
     
     // File information setters
-    void setRowIndex(int index) { m_rowIndex = index; }
+    void setJobId(int id) { m_jobId = id; }
     void setFilePath(const QString& path);
     void setFilename(const QString& name) { m_filename = name; }
     void setHash(const QString& hash);
@@ -78,7 +78,7 @@ public:
     
 private:
     // File information
-    int m_rowIndex;
+    int m_jobId;
     QString m_filePath;
     QString m_filename;
     QString m_hexdigest;  // ED2K hash
@@ -6,6 +6,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QtConcurrent/QtConcurrentMap>
 #include <cmath>
 
 HybridDeletionClassifier::HybridDeletionClassifier(
@@ -117,9 +118,93 @@ DeletionCandidate HybridDeletionClassifier::classify(int lid) const
     return c;
 }
 
-QMap<QString, double> HybridDeletionClassifier::normalizeFactors(int lid) const
+DeletionCandidate HybridDeletionClassifier::classify(int lid, const FileAttributeSnapshot &snapshot) const
 {
-    QMap<QString, double> factors;
+    return classify(lid, snapshot, m_learner.allWeights());
+}
+
+DeletionCandidate HybridDeletionClassifier::classify(int lid, const FileAttributeSnapshot &snapshot,
+                                                     const FactorVector &weights)
+{
+    DeletionCandidate c;
+    c.lid = lid;
+
+    const FileAttributeSnapshot::File *file = snapshot.file(lid);
+    if (!file) {
+        c.tier = DeletionTier::PROTECTED;
+        c.reason = "File not found in database";
+        return c;
+    }
+    c.aid       = file->aid;
+    c.eid       = file->eid;
+    c.filePath  = file->path;
+    c.animeName = file->animeName;
+
+    // ── Absolute protections ──
+    if (file->deletionLocked > 0) {
+        c.tier   = DeletionTier::PROTECTED;
+        c.locked = true;
+        c.reason = snapshot.isAnimeLocked(c.aid)
+                   ? "Anime locked (highest rated kept)"
+                   : "Episode locked (highest rated kept)";
+        return c;
+    }
+
+    // ── Tier 0: hidden anime ──
+    if (file->hasAnime && file->animeHidden) {
+        c.tier = DeletionTier::HIDDEN_ANIME;
+        c.learnedScore = 0.0;
+        c.reason = "Hidden anime";
+        return c;
+    }
+
+    // ── Tier 1: superseded revision ──
+    DeletionCandidate t0 = classifyTier0(*file, snapshot);
+    if (t0.tier == DeletionTier::SUPERSEDED_REVISION) {
+        t0.aid = c.aid; t0.eid = c.eid; t0.filePath = c.filePath; t0.animeName = c.animeName;
+        return t0;
+    }
+
+    // ── Tier 2: low-quality duplicate ──
+    DeletionCandidate t1 = classifyTier1(*file, snapshot);
+    if (t1.tier == DeletionTier::LOW_QUALITY_DUPLICATE) {
+        t1.aid = c.aid; t1.eid = c.eid; t1.filePath = c.filePath; t1.animeName = c.animeName;
+        return t1;
+    }
+
+    // ── Tier 3: language mismatch ──
+    DeletionCandidate t2 = classifyTier2(*file, snapshot);
+    if (t2.tier == DeletionTier::LANGUAGE_MISMATCH) {
+        t2.aid = c.aid; t2.eid = c.eid; t2.filePath = c.filePath; t2.animeName = c.animeName;
+        return t2;
+    }
+
+    // ── Tier 4: learned preference ──
+    if (file->viewed > 0) {
+        c.tier = DeletionTier::LEARNED_PREFERENCE;
+        c.factorValues = normalizeFactors(*file);
+        c.learnedScore = FactorWeightLearner::computeScore(weights, c.factorValues);
+        c.reason = QString("Score: %1").arg(c.learnedScore, 0, 'f', 2);
+        return c;
+    }
+
+    // ── Protected ──
+    c.tier   = DeletionTier::PROTECTED;
+    c.reason = "Protected (not eligible for deletion)";
+    return c;
+}
+
+QList<DeletionCandidate> HybridDeletionClassifier::classifyAll(const FileAttributeSnapshot &snapshot,
+                                                               const FactorVector &weights)
+{
+    return QtConcurrent::blockingMapped<QList<DeletionCandidate>>(
+        snapshot.deletionCandidates(),
+        [&snapshot, &weights](int lid) { return classify(lid, snapshot, weights); });
+}
+
+FactorVector HybridDeletionClassifier::normalizeFactors(int lid) const
+{
+    FactorVector factors{};
     QSqlDatabase db = QSqlDatabase::database();
     QSqlQuery q(db);
 
@@ -127,42 +212,61 @@ QMap<QString, double> HybridDeletionClassifier::normalizeFactors(int lid) const
     q.prepare("SELECT a.rating FROM mylist m JOIN anime a ON a.aid = m.aid WHERE m.lid = :lid");
     q.bindValue(":lid", lid);
     if (q.exec() && q.next()) {
-        int rating = q.value(0).toInt();
-        factors["anime_rating"] = qBound(0.0, rating / 1000.0, 1.0);
+        factors[DeletionFactor::AnimeRating] = ratingFactor(q.value(0).toInt());
     } else {
-        factors["anime_rating"] = 0.5;
+        factors[DeletionFactor::AnimeRating] = 0.5;
     }
 
     // size_weighted_distance: simplified — use episode distance × file size,
     // normalized to 0-1 with per-anime max.
     // For now: use a placeholder 0.5 (full implementation needs session context).
-    factors["size_weighted_distance"] = 0.5;
+    factors[DeletionFactor::SizeWeightedDistance] = 0.5;
 
     // group_status: active=1.0, stalled=0.5, disbanded=0.0
     q.prepare("SELECT g.status FROM mylist m "
               "JOIN file f ON f.fid = m.fid "
-              "LEFT JOIN anidb_groups g ON g.gid = f.gid "
+              "LEFT JOIN `group` g ON g.gid = f.gid "
               "WHERE m.lid = :lid");
     q.bindValue(":lid", lid);
     if (q.exec() && q.next()) {
-        int status = q.value(0).toInt();
-        if (status == 1) factors["group_status"] = 1.0;       // ongoing/active
-        else if (status == 2) factors["group_status"] = 0.5;   // stalled
-        else if (status == 3) factors["group_status"] = 0.0;   // disbanded
-        else factors["group_status"] = 0.5;
+        factors[DeletionFactor::GroupStatus] = groupStatusFactor(q.value(0).toInt());
     } else {
-        factors["group_status"] = 0.5;
+        factors[DeletionFactor::GroupStatus] = 0.5;
     }
 
     // watch_recency: placeholder 0.5 (full implementation needs watch timestamps)
-    factors["watch_recency"] = 0.5;
+    factors[DeletionFactor::WatchRecency] = 0.5;
 
     // view_percentage: default 0.5 for no-session anime (Q5/Q11)
-    factors["view_percentage"] = 0.5;
+    factors[DeletionFactor::ViewPercentage] = 0.5;
 
     return factors;
 }
 
+FactorVector HybridDeletionClassifier::normalizeFactors(const FileAttributeSnapshot::File &file)
+{
+    FactorVector factors{};
+    factors[DeletionFactor::AnimeRating]          = file.hasAnime ? ratingFactor(file.animeRating) : 0.5;
+    factors[DeletionFactor::SizeWeightedDistance] = 0.5;
+    factors[DeletionFactor::GroupStatus]          = file.hasFile ? groupStatusFactor(file.groupStatus) : 0.5;
+    factors[DeletionFactor::WatchRecency]         = 0.5;
+    factors[DeletionFactor::ViewPercentage]       = 0.5;
+    return factors;
+}
+
+double HybridDeletionClassifier::ratingFactor(int rating)
+{
+    return qBound(0.0, rating / 1000.0, 1.0);
+}
+
+double HybridDeletionClassifier::groupStatusFactor(int status)
+{
+    if (status == 1) return 1.0;    // ongoing/active
+    if (status == 2) return 0.5;    // stalled
+    if (status == 3) return 0.0;    // disbanded
+    return 0.5;
+}
+
 // ---------------------------------------------------------------------------
 // Tier 0: hidden anime
 // ---------------------------------------------------------------------------
@@ -376,3 +480,97 @@ bool HybridDeletionClassifier::isEligibleForDeletion(int lid) const
     // Full session-distance logic would be added with per-chain session migration.
     return viewed > 0;
 }
+
+// ---------------------------------------------------------------------------
+// Snapshot variants of tiers 1-3 (same rules as the query-based versions)
+// ---------------------------------------------------------------------------
+
+DeletionCandidate HybridDeletionClassifier::classifyTier0(const FileAttributeSnapshot::File &file,
+                                                          const FileAttributeSnapshot &snapshot)
+{
+    DeletionCandidate c;
+    c.lid = file.lid;
+    if (!file.hasFile) return c;
+
+    const int version = file.version();
+    for (int altLid : snapshot.lidsForEpisode(file.eid)) {
+        const FileAttributeSnapshot::File *alt = snapshot.file(altLid);
+        if (altLid == file.lid || !alt->hasFile) continue;
+        const int state = alt->fileState;
+        if (((state & 32) && version < 5) || ((state & 16) && version < 4)
+            || ((state & 8) && version < 3) || ((state & 4) && version < 2)) {
+            c.tier = DeletionTier::SUPERSEDED_REVISION;
+            c.replacementLid  = altLid;
+            c.replacementPath = alt->path;
+            c.reason = "Superseded by newer local revision";
+            c.learnedScore = 0.0;
+            break;
+        }
+    }
+    return c;
+}
+
+DeletionCandidate HybridDeletionClassifier::classifyTier1(const FileAttributeSnapshot::File &file,
+                                                          const FileAttributeSnapshot &snapshot)
+{
+    DeletionCandidate c;
+    c.lid = file.lid;
+    if (!file.hasFile || file.viewed > 0) return c;
+    if (file.quality.isNull()) return c;  // NULL never compares greater in SQL
+
+    for (int altLid : snapshot.lidsForEpisode(file.eid)) {
+        const FileAttributeSnapshot::File *alt = snapshot.file(altLid);
+        if (altLid == file.lid || !alt->hasFile || alt->quality.isNull()) continue;
+        if (alt->quality > file.quality) {
+            c.tier = DeletionTier::LOW_QUALITY_DUPLICATE;
+            c.replacementLid  = altLid;
+            c.replacementPath = alt->path;
+            c.reason = QString("Lower quality duplicate (quality: %1)").arg(file.quality);
+            c.learnedScore = 0.0;
+            break;
+        }
+    }
+    return c;
+}
+
+DeletionCandidate HybridDeletionClassifier::classifyTier2(const FileAttributeSnapshot::File &file,
+                                                          const FileAttributeSnapshot &snapshot)
+{
+    DeletionCandidate c;
+    c.lid = file.lid;
+
+    const bool audioMatch = snapshot.matchesPreferredAudioLanguage(file.lid);
+    const bool subMatch   = snapshot.matchesPreferredSubtitleLanguage(file.lid);
+    if (audioMatch && subMatch) return c;
+
+    for (int altLid : snapshot.lidsForEpisode(file.eid)) {
+        if (altLid == file.lid) continue;
+        const bool altAudio = snapshot.matchesPreferredAudioLanguage(altLid);
+        const bool altSub   = snapshot.matchesPreferredSubtitleLanguage(altLid);
+        // Alternative is better if it matches at least as well and better on at least one
+        if ((altAudio || !audioMatch) && (altSub || !subMatch)
+            && (altAudio > audioMatch || altSub > subMatch)) {
+            const FileAttributeSnapshot::File *alt = snapshot.file(altLid);
+            c.tier = DeletionTier::LANGUAGE_MISMATCH;
+            c.replacementLid  = altLid;
+            c.replacementPath = alt->path;
+            c.learnedScore = 0.0;
+
+            const QString myAudio      = file.hasFile ? file.audioLanguage : QString();
+            const QString mySub        = file.hasFile ? file.subtitleLanguage : QString();
+            const QString altAudioLang = alt->hasFile ? alt->audioLanguage : QString();
+            const QString altSubLang   = alt->hasFile ? alt->subtitleLanguage : QString();
+
+            QStringList parts;
+            if (!audioMatch)
+                parts << QString("dub: %1 → %2").arg(myAudio.isEmpty() ? "none" : myAudio,
+                                                       altAudioLang.isEmpty() ? "none" : altAudioLang);
+            if (!subMatch)
+                parts << QString("sub: %1 → %2").arg(mySub.isEmpty() ? "none" : mySub,
+                                                       altSubLang.isEmpty() ? "none" : altSubLang);
+            c.reason = QString("Language mismatch (%1)").arg(parts.join(", "));
+            return c;
+        }
+    }
+    return c;
+}
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include "deletioncandidate.h"
+#include "fileattributesnapshot.h"
 
 class DeletionLockManager;
 class FactorWeightLearner;
@@ -31,10 +32,39 @@ public:
      */
     DeletionCandidate classify(int lid) const;
 
+    /**
+     * @brief Classify a single file from a preloaded attribute snapshot.
+     *
+     * Same rules as classify(int), answered from memory instead of per-file queries.
+     * @param lid       MyList ID of the file.
+     * @param snapshot  Attributes of all local files (see FileAttributeSnapshot::load()).
+     * @return          DeletionCandidate with tier and score filled in; PROTECTED if the
+     *                  file is not in the snapshot.
+     */
+    DeletionCandidate classify(int lid, const FileAttributeSnapshot &snapshot) const;
+
+    /**
+     * @brief Same, scored with a copy of the factor weights.
+     *
+     * Touches no shared state, so it is safe to call from worker threads.
+     */
+    static DeletionCandidate classify(int lid, const FileAttributeSnapshot &snapshot,
+                                      const FactorVector &weights);
+
+    /**
+     * @brief Classify every deletion candidate of a snapshot in parallel.
+     *
+     * Runs on the global thread pool and blocks until done. Results are in
+     * FileAttributeSnapshot::deletionCandidates() order. Used by DeletionQueue::rebuild().
+     */
+    static QList<DeletionCandidate> classifyAll(const FileAttributeSnapshot &snapshot,
+                                                const FactorVector &weights);
+
     /**
      * @brief Compute normalized learnable factors for a file.
      */
-    QMap<QString, double> normalizeFactors(int lid) const;
+    FactorVector normalizeFactors(int lid) const;
+    static FactorVector normalizeFactors(const FileAttributeSnapshot::File &file);
 
 private:
     DeletionCandidate classifyHiddenAnime(int lid) const;
@@ -44,6 +74,16 @@ private:
     DeletionCandidate classifyTier3(int lid) const;
     bool isEligibleForDeletion(int lid) const;
 
+    static DeletionCandidate classifyTier0(const FileAttributeSnapshot::File &file,
+                                           const FileAttributeSnapshot &snapshot);
+    static DeletionCandidate classifyTier1(const FileAttributeSnapshot::File &file,
+                                           const FileAttributeSnapshot &snapshot);
+    static DeletionCandidate classifyTier2(const FileAttributeSnapshot::File &file,
+                                           const FileAttributeSnapshot &snapshot);
+
+    static double ratingFactor(int rating);
+    static double groupStatusFactor(int status);
+
     const DeletionLockManager &m_lockManager;
     const FactorWeightLearner &m_learner;
     const WatchSessionManager &m_sessionManager;
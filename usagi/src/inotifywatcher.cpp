@@ -0,0 +1,326 @@
+#include "inotifywatcher.h"
+#include "logger.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+InotifyWatcher::InotifyWatcher(QObject *parent)
+    : QObject(parent)
+    , m_fd(-1)
+    , m_notifier(nullptr)
+{
+    m_coalesceTimer.setSingleShot(true);
+    m_coalesceTimer.setInterval(COALESCE_MS);
+    connect(&m_coalesceTimer, &QTimer::timeout, this, &InotifyWatcher::changesReady);
+    m_walkTimer.setInterval(0);
+    connect(&m_walkTimer, &QTimer::timeout, this, &InotifyWatcher::registerNextChunk);
+}
+
+InotifyWatcher::~InotifyWatcher()
+{
+    stop();
+}
+
+#ifdef Q_OS_LINUX
+
+namespace {
+
+constexpr quint32 WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO
+                               | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF
+                               | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+QString joinPath(const QString &directory, const QString &name)
+{
+    return directory.endsWith('/') ? directory + name : directory + '/' + name;
+}
+
+// Same entries as the full scan in DirectoryScanWorker (no hidden files or symlinks)
+bool isHiddenName(const QString &name)
+{
+    return name.startsWith('.');
+}
+
+} // namespace
+
+bool InotifyWatcher::isSupported()
+{
+    return true;
+}
+
+bool InotifyWatcher::start(const QString &root)
+{
+    stop();
+
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        LOG(QString("InotifyWatcher: inotify_init1 failed: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        return false;
+    }
+
+    m_root = root;
+    if (!addWatch(root) || watchCount() == 0) {
+        LOG(QString("InotifyWatcher: cannot watch %1").arg(root));
+        stop();
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &InotifyWatcher::readEvents);
+
+    // The rest of the tree is walked a chunk per event-loop turn
+    m_walk.reset(new QDirIterator(root, QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks,
+                                  QDirIterator::Subdirectories));
+    m_walkTimer.start();
+    return true;
+}
+
+void InotifyWatcher::registerNextChunk()
+{
+    if (!m_walk) {
+        m_walkTimer.stop();
+        return;
+    }
+
+    for (int i = 0; i < WATCH_CHUNK && m_walk->hasNext(); ++i) {
+        if (!addWatch(m_walk->next())) {
+            LOG(QString("InotifyWatcher: could not watch every directory below %1").arg(m_root));
+            stop();
+            emit treeWatched(false);
+            return;
+        }
+    }
+    if (m_walk->hasNext()) {
+        return;
+    }
+
+    m_walk.reset();
+    m_walkTimer.stop();
+    LOG(QString("InotifyWatcher: watching %1 director%2 below %3")
+        .arg(watchCount()).arg(watchCount() == 1 ? "y" : "ies").arg(m_root));
+    emit treeWatched(true);
+}
+
+void InotifyWatcher::stop()
+{
+    delete m_notifier;
+    m_notifier = nullptr;
+    if (m_fd >= 0) {
+        // Closing the descriptor drops all of its watches
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_coalesceTimer.stop();
+    m_walkTimer.stop();
+    m_walk.reset();
+    m_wdPaths.clear();
+    m_pathWds.clear();
+    m_queue.take();
+    m_root.clear();
+}
+
+void InotifyWatcher::readEvents()
+{
+    // Large enough for many events per read; aligned for inotify_event
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    for (;;) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: drained
+            break;
+        }
+        for (const char *p = buffer; p < buffer + length; ) {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(p);
+            const QString name = event->len > 0 ? QFile::decodeName(event->name) : QString();
+            handleEvent(event->wd, event->mask, name);
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (!m_queue.isEmpty() && !m_coalesceTimer.isActive()) {
+        m_coalesceTimer.start();
+    }
+}
+
+void InotifyWatcher::handleEvent(int wd, quint32 mask, const QString &name)
+{
+    if (mask & IN_Q_OVERFLOW) {
+        LOG("InotifyWatcher: event queue overflowed, a full rescan is needed");
+        m_queue.setOverflow();
+        return;
+    }
+
+    const QString directory = m_wdPaths.value(wd);
+    if (directory.isEmpty()) {
+        return;
+    }
+    if (mask & IN_IGNORED) {
+        // Watch removed (directory deleted, or removeTree())
+        m_wdPaths.remove(wd);
+        if (m_pathWds.value(directory, -1) == wd) {
+            m_pathWds.remove(directory);
+        }
+        return;
+    }
+    if (mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+        // Subdirectories are reported by their parent; only the root itself matters
+        if (directory == m_root) {
+            m_queue.setOverflow();
+        }
+        return;
+    }
+    if (name.isEmpty() || isHiddenName(name)) {
+        return;
+    }
+
+    const QString path = joinPath(directory, name);
+    if (mask & IN_ISDIR) {
+        if (mask & (IN_CREATE | IN_MOVED_TO)) {
+            // Files can land in the directory before its watch exists; report what is there
+            const FileChangeQueue::Change change = (mask & IN_CREATE) ? FileChangeQueue::Change::Created
+                                                                       : FileChangeQueue::Change::MovedIn;
+            if (!addTree(path, true, change)) {
+                m_queue.setOverflow();
+            }
+        } else if (mask & (IN_DELETE | IN_MOVED_FROM)) {
+            removeTree(path);
+            m_queue.addRemovedDirectory(path);
+        }
+        return;
+    }
+
+    if (mask & IN_CREATE) {
+        m_queue.addFile(FileChangeQueue::Change::Created, path);
+    } else if (mask & IN_CLOSE_WRITE) {
+        m_queue.addFile(FileChangeQueue::Change::Written, path);
+    } else if (mask & IN_MOVED_TO) {
+        m_queue.addFile(FileChangeQueue::Change::MovedIn, path);
+    } else if (mask & IN_MOVED_FROM) {
+        m_queue.addFile(FileChangeQueue::Change::MovedOut, path);
+    } else if (mask & IN_DELETE) {
+        m_queue.addFile(FileChangeQueue::Change::Deleted, path);
+    }
+}
+
+bool InotifyWatcher::addWatch(const QString &directory)
+{
+    const int wd = inotify_add_watch(m_fd, QFile::encodeName(directory).constData(), WATCH_MASK);
+    if (wd < 0) {
+        const int error = errno;
+        if (error == ENOSPC) {
+            LOG("InotifyWatcher: inotify watch limit reached (fs.inotify.max_user_watches)");
+            return false;
+        }
+        // Unreadable directories are skipped like in the full scan
+        LOG(QString("InotifyWatcher: cannot watch %1: %2")
+            .arg(directory, QString::fromLocal8Bit(strerror(error))));
+        return true;
+    }
+
+    // The same directory seen under a new name (moved within the tree) keeps its descriptor
+    const QString previous = m_wdPaths.value(wd);
+    if (!previous.isEmpty() && previous != directory) {
+        m_pathWds.remove(previous);
+    }
+    m_wdPaths.insert(wd, directory);
+    m_pathWds.insert(directory, wd);
+    return true;
+}
+
+bool InotifyWatcher::addTree(const QString &directory, bool reportFiles, FileChangeQueue::Change fileChange)
+{
+    if (!addWatch(directory)) {
+        return false;
+    }
+
+    QDir::Filters filters = QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks;
+    if (reportFiles) {
+        filters |= QDir::Files;
+    }
+    QDirIterator it(directory, filters, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (it.fileInfo().isDir()) {
+            if (!addWatch(path)) {
+                return false;
+            }
+        } else {
+            m_queue.addFile(fileChange, path);
+        }
+    }
+    return true;
+}
+
+void InotifyWatcher::removeTree(const QString &directory)
+{
+    const QString prefix = joinPath(directory, QString());
+    for (auto it = m_pathWds.begin(); it != m_pathWds.end(); ) {
+        if (it.key() == directory || it.key().startsWith(prefix)) {
+            inotify_rm_watch(m_fd, it.value());
+            m_wdPaths.remove(it.value());
+            it = m_pathWds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+#else // !Q_OS_LINUX
+
+bool InotifyWatcher::isSupported()
+{
+    return false;
+}
+
+bool InotifyWatcher::start(const QString &root)
+{
+    Q_UNUSED(root);
+    return false;
+}
+
+void InotifyWatcher::stop()
+{
+}
+
+void InotifyWatcher::readEvents()
+{
+}
+
+void InotifyWatcher::registerNextChunk()
+{
+}
+
+void InotifyWatcher::handleEvent(int wd, quint32 mask, const QString &name)
+{
+    Q_UNUSED(wd);
+    Q_UNUSED(mask);
+    Q_UNUSED(name);
+}
+
+bool InotifyWatcher::addWatch(const QString &directory)
+{
+    Q_UNUSED(directory);
+    return false;
+}
+
+bool InotifyWatcher::addTree(const QString &directory, bool reportFiles, FileChangeQueue::Change fileChange)
+{
+    Q_UNUSED(directory);
+    Q_UNUSED(reportFiles);
+    Q_UNUSED(fileChange);
+    return false;
+}
+
+void InotifyWatcher::removeTree(const QString &directory)
+{
+    Q_UNUSED(directory);
+}
+
+#endif // Q_OS_LINUX
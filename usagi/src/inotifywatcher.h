@@ -0,0 +1,96 @@
+#ifndef INOTIFYWATCHER_H
+#define INOTIFYWATCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QTimer>
+#include <memory>
+#include "filechangequeue.h"
+
+class QDirIterator;
+class QSocketNotifier;
+
+/**
+ * @brief Recursive inotify watcher (Linux backend of DirectoryWatcher).
+ *
+ * Puts an inotify watch on every directory below the root and turns create,
+ * close-write, move and delete events into exact per-path changes in a
+ * FileChangeQueue. Directories that appear later are watched as they are
+ * created, and files already inside them are reported as created. Events are
+ * read on the owning thread when the descriptor becomes readable; changesReady()
+ * is emitted once per short burst, so a change costs O(changed files) instead
+ * of a walk of the whole tree.
+ *
+ * start() only watches the root; the directories below it are registered in
+ * chunks of WATCH_CHUNK per event-loop turn, so a large tree does not block the
+ * owning thread. treeWatched() tells when every directory is watched.
+ *
+ * inotify only sees changes made through the local kernel: changes made by
+ * other hosts on a network mount are not reported, and a full rescan is still
+ * needed after an overflow (FileChangeQueue::Batch::overflow).
+ *
+ * On other platforms isSupported() is false and start() always fails.
+ */
+class InotifyWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InotifyWatcher(QObject *parent = nullptr);
+    ~InotifyWatcher();
+
+    static bool isSupported();
+
+    /// Watch @p root recursively. False (and nothing watched) if inotify is
+    /// unavailable or the root cannot be watched; subdirectories follow
+    /// asynchronously, see treeWatched().
+    bool start(const QString &root);
+    void stop();
+    bool isActive() const { return m_fd >= 0; }
+
+    /// Subdirectories of the root are still being registered.
+    bool isRegistering() const { return m_walk != nullptr; }
+
+    /// Number of watched directories.
+    int watchCount() const { return static_cast<int>(m_wdPaths.size()); }
+
+    /// Coalesced changes since the last call.
+    FileChangeQueue::Batch takeChanges() { return m_queue.take(); }
+
+    /// Delay between the first event of a burst and changesReady()
+    static constexpr int COALESCE_MS = 250;
+
+    /// Directories registered per event-loop turn after start()
+    static constexpr int WATCH_CHUNK = 256;
+
+signals:
+    /// Changes are waiting in takeChanges().
+    void changesReady();
+
+    /// Registration started by start() finished. False if the watch limit was
+    /// too low for the tree; the watcher is stopped then.
+    void treeWatched(bool complete);
+
+private slots:
+    void readEvents();
+    void registerNextChunk();
+
+private:
+    void handleEvent(int wd, quint32 mask, const QString &name);
+    bool addTree(const QString &directory, bool reportFiles, FileChangeQueue::Change fileChange);
+    bool addWatch(const QString &directory);
+    void removeTree(const QString &directory);
+
+    int m_fd;
+    QSocketNotifier *m_notifier;
+    QTimer m_coalesceTimer;
+    QTimer m_walkTimer;
+    std::unique_ptr<QDirIterator> m_walk;   ///< Directories below the root not yet watched
+    QString m_root;
+    QHash<int, QString> m_wdPaths;      ///< watch descriptor -> directory
+    QHash<QString, int> m_pathWds;      ///< directory -> watch descriptor
+    FileChangeQueue m_queue;
+};
+
+#endif // INOTIFYWATCHER_H
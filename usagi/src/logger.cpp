@@ -1,20 +1,265 @@
 #include "logger.h"
 #include <QDebug>
 #include <QDateTime>
+#include <QFile>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+#include <memory>
+
+namespace {
+
+struct LogRecord
+{
+    qint64 msecsSinceEpoch = 0;
+    Logger::Level level = Logger::Info;
+    const char *file = nullptr;
+    int line = 0;
+    QString msg;
+};
+
+/**
+ * Bounded multi-producer, single-consumer queue of log records.
+ *
+ * Every slot carries a sequence number: a producer claims a position with one
+ * compare-and-swap on the enqueue counter and publishes its record by bumping the
+ * slot's sequence; the writer thread takes records in position order. Nothing
+ * blocks - a full buffer makes tryPush() fail.
+ */
+class LogRingBuffer
+{
+public:
+    LogRingBuffer()
+        : m_slots(new Slot[Logger::RING_CAPACITY])
+        , m_enqueuePos(0)
+        , m_dequeuePos(0)
+    {
+        for (quint64 i = 0; i < static_cast<quint64>(Logger::RING_CAPACITY); ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(LogRecord &&record)
+    {
+        quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &m_slots[pos & MASK];
+            const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+            const qint64 diff = static_cast<qint64>(sequence) - static_cast<qint64>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full: the writer has not freed this slot yet
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record = std::move(record);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Writer thread only
+    bool tryPop(LogRecord &record)
+    {
+        Slot &slot = m_slots[m_dequeuePos & MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+            return false;
+        }
+        record = std::move(slot.record);
+        slot.record = LogRecord();
+        slot.sequence.store(m_dequeuePos + Logger::RING_CAPACITY, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    // Positions claimed so far; a record below it is taken once dequeued() passes it
+    quint64 enqueued() const { return m_enqueuePos.load(std::memory_order_acquire); }
+    quint64 dequeued() const { return m_dequeuePos; }
+
+private:
+    static constexpr quint64 MASK = Logger::RING_CAPACITY - 1;
+    static_assert((Logger::RING_CAPACITY & (Logger::RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two");
+
+    struct Slot {
+        std::atomic<quint64> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<quint64> m_enqueuePos;
+    alignas(64) quint64 m_dequeuePos;
+};
+
+// Everything the writer thread owns; created with the Logger instance and never deleted
+struct LoggerBackend
+{
+    LogRingBuffer ring;
+    std::atomic<bool> running{false};
+    std::atomic<int> producers{0};      // log() calls between the running check and the push
+    std::atomic<quint64> dropped{0};
+    quint64 reportedDropped = 0;        // Writer thread only
+    std::atomic<quint64> drained{0};    // Ring positions written out and delivered
+
+    QThread *writer = nullptr;
+    QMutex wakeMutex;
+    QWaitCondition wake;                // Writer: flush requested or shutting down
+    QWaitCondition flushed;             // flush(): the writer finished a pass
+    bool stopRequested = false;         // Protected by wakeMutex
+
+    QMutex fileMutex;
+    QFile file;                         // Protected by fileMutex
+};
+
+} // namespace
 
 // Static instance pointer and mutex for thread safety
 // Note: The instance is intentionally never deleted as it should live for the
 // application's lifetime. This is standard practice for application-level singletons.
 static Logger* s_instance = nullptr;
+static LoggerBackend* s_backend = nullptr;
 // Using Q_GLOBAL_STATIC ensures proper construction and destruction order
 Q_GLOBAL_STATIC(QMutex, s_instanceMutex)
 
+namespace {
+
+const char *levelTag(Logger::Level level)
+{
+    switch (level) {
+        case Logger::Debug:
+            return "[Debug] ";
+        case Logger::Warning:
+            return "[Warning] ";
+        case Logger::Error:
+            return "[Error] ";
+        default:
+            return "";
+    }
+}
+
+// The formatting the old synchronous logger did per call, now on the writer thread
+QString formatRecord(const LogRecord &record)
+{
+    //timestamp
+    const QString timestamp = QDateTime::fromMSecsSinceEpoch(record.msecsSinceEpoch).toString("HH:mm:ss.zzz");
+
+    // Extract just the filename from the full path
+    QString filename = QString::fromUtf8(record.file);
+    int lastSlash = filename.lastIndexOf('/');
+    if (lastSlash == -1)
+    {
+        lastSlash = filename.lastIndexOf('\\');
+    }
+    if (lastSlash >= 0)
+    {
+        filename = filename.mid(lastSlash + 1);
+    }
+    const QString safeMsg = record.msg.contains("AUTH", Qt::CaseInsensitive)
+                                ? "[REDACTED AUTH MESSAGE]"
+                                : record.msg;
+
+    return QString("[%1] [%2:%3] %4%5")
+        .arg(timestamp, filename, QString::number(record.line), QString::fromLatin1(levelTag(record.level)), safeMsg);
+}
+
+// Console and log file
+void writeLines(LoggerBackend *backend, const QStringList &lines)
+{
+    for (const QString &line : lines) {
+        qDebug().noquote() << line;
+    }
+
+    QMutexLocker locker(&backend->fileMutex);
+    if (backend->file.isOpen()) {
+        for (const QString &line : lines) {
+            backend->file.write(line.toUtf8());
+            backend->file.write("\n");
+        }
+        backend->file.flush();
+    }
+}
+
+// One writer pass: take everything queued, write it out, hand a capped batch to the UI
+void drainOnce(LoggerBackend *backend)
+{
+    QStringList lines;
+    LogRecord record;
+    while (backend->ring.tryPop(record)) {
+        lines.append(formatRecord(record));
+    }
+
+    const quint64 dropped = backend->dropped.load(std::memory_order_relaxed);
+    if (dropped != backend->reportedDropped) {
+        lines.append(QString("[Logger] %1 message(s) dropped, the log buffer was full")
+                         .arg(dropped - backend->reportedDropped));
+        backend->reportedDropped = dropped;
+    }
+
+    if (!lines.isEmpty()) {
+        writeLines(backend, lines);
+
+        QStringList uiLines = lines;
+        if (uiLines.size() > Logger::MAX_UI_LINES_PER_BATCH) {
+            const qsizetype hidden = uiLines.size() - Logger::MAX_UI_LINES_PER_BATCH;
+            uiLines = uiLines.mid(hidden);
+            uiLines.prepend(QString("[Logger] %1 earlier line(s) only written to the console/log file").arg(hidden));
+        }
+        emit s_instance->logMessages(uiLines);
+    }
+
+    QMutexLocker locker(&backend->wakeMutex);
+    backend->drained.store(backend->ring.dequeued(), std::memory_order_release);
+    backend->flushed.wakeAll();
+}
+
+void writerLoop(LoggerBackend *backend)
+{
+    for (;;) {
+        {
+            QMutexLocker locker(&backend->wakeMutex);
+            if (!backend->stopRequested) {
+                backend->wake.wait(&backend->wakeMutex, Logger::FLUSH_INTERVAL_MS);
+            }
+        }
+        drainOnce(backend);
+
+        QMutexLocker locker(&backend->wakeMutex);
+        if (backend->stopRequested) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+std::atomic<int> Logger::s_minimumLevel{Logger::Debug};
+
 Logger::Logger() : QObject(nullptr)
 {
 }
 
+Logger::Level Logger::levelFromName(const QString &name, Level fallback)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "debug" || key == "0") {
+        return Debug;
+    }
+    if (key == "info" || key == "1") {
+        return Info;
+    }
+    if (key == "warning" || key == "2") {
+        return Warning;
+    }
+    if (key == "error" || key == "3") {
+        return Error;
+    }
+    return fallback;
+}
+
 Logger* Logger::instance()
 {
     // Double-checked locking pattern for thread-safe singleton
@@ -25,49 +270,108 @@ Logger* Logger::instance()
         QMutexLocker locker(s_instanceMutex());
         if (!s_instance)
         {
+            // The backend is complete before other threads can see the instance;
+            // records pushed before the writer runs wait in the ring buffer
+            s_backend = new LoggerBackend;
+            s_backend->writer = QThread::create(writerLoop, s_backend);
+            s_backend->writer->setObjectName("LoggerWriter");
+            s_backend->running.store(true, std::memory_order_release);
             s_instance = new Logger();
+            s_backend->writer->start(QThread::LowPriority);
+
+            // Stop the writer with the application, before statics are torn down
+            qAddPostRoutine(&Logger::shutdown);
         }
     }
     return s_instance;
 }
 
-void Logger::log(const QString &msg, const QString &file, int line)
+void Logger::log(Level level, const QString &msg, const char *file, int line)
 {
     // MANDATORY: file and line parameters MUST be valid.
     // These assertions enforce correct usage of Logger::log.
     // If these assertions are hit at runtime, it means Logger::log is being called
     // INCORRECTLY and needs to be fixed. Use the LOG(msg) macro instead, which
     // automatically provides __FILE__ and __LINE__.
-    assert(!file.isEmpty() && "Logger::log: file parameter is MANDATORY - use LOG(msg) macro instead");
+    assert(file && *file && "Logger::log: file parameter is MANDATORY - use LOG(msg) macro instead");
     assert(line > 0 && "Logger::log: line parameter is MANDATORY - use LOG(msg) macro instead");
-    // Build the full message
-    QString fullMessage;
+    if (!isEnabled(level)) {
+        return;
+    }
+    instance();
 
-    //timestamp
-    QString timestamp = QDateTime::currentDateTime().toString("HH:mm:ss.zzz");
+    LogRecord record;
+    record.msecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.file = file;
+    record.line = line;
+    record.msg = msg;
 
-    // If file and line are provided, include them in the message
-    // Extract just the filename from the full path
-    QString filename = file;
-    int lastSlash = filename.lastIndexOf('/');
-    if (lastSlash == -1)
-    {
-        lastSlash = filename.lastIndexOf('\\');
+    // Announced before running is read, so shutdown() can wait for pushes in flight
+    s_backend->producers.fetch_add(1);
+    if (!s_backend->running.load()) {
+        s_backend->producers.fetch_sub(1);
+        // Writer stopped (application shutting down): write synchronously
+        writeLines(s_backend, QStringList{formatRecord(record)});
+        return;
+    }
+    if (!s_backend->ring.tryPush(std::move(record))) {
+        s_backend->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    s_backend->producers.fetch_sub(1);
+}
+
+bool Logger::setLogFile(const QString &path)
+{
+    instance();
+    QMutexLocker locker(&s_backend->fileMutex);
+    if (s_backend->file.isOpen()) {
+        s_backend->file.close();
+    }
+    if (path.isEmpty()) {
+        return true;
+    }
+    s_backend->file.setFileName(path);
+    return s_backend->file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+}
+
+void Logger::flush()
+{
+    instance();
+    if (!s_backend->running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    const quint64 target = s_backend->ring.enqueued();
+    QMutexLocker locker(&s_backend->wakeMutex);
+    while (s_backend->drained.load(std::memory_order_acquire) < target && s_backend->running.load(std::memory_order_acquire)) {
+        s_backend->wake.wakeAll();
+        s_backend->flushed.wait(&s_backend->wakeMutex, FLUSH_INTERVAL_MS);
+    }
+}
+
+void Logger::shutdown()
+{
+    // Producers that read running after this write synchronously; flush() returns at once
+    if (!s_backend || !s_backend->running.exchange(false)) {
+        return;
     }
-    if (lastSlash >= 0)
     {
-        filename = filename.mid(lastSlash + 1);
+        QMutexLocker locker(&s_backend->wakeMutex);
+        s_backend->stopRequested = true;
+        s_backend->wake.wakeAll();
+    }
+    s_backend->writer->wait();
+
+    // Producers that saw running == true may still be pushing; wait for them, then take
+    // every record they published (and report drops) on this thread
+    while (s_backend->producers.load() > 0) {
+        QThread::yieldCurrentThread();
     }
-    QString safeMsg = msg.contains("AUTH", Qt::CaseInsensitive)
-                          ? "[REDACTED AUTH MESSAGE]"
-                          : msg;
-
-    fullMessage = QString("[%1] [%2:%3] %4")
-                      .arg(timestamp, filename, QString::number(line), safeMsg);
-    
-    // 1. Output to console (for development and debugging)
-    qDebug().noquote() << fullMessage;
-    
-    // 2. Emit signal for UI log tab
-    emit instance()->logMessage(fullMessage);
+    drainOnce(s_backend);
+}
+
+quint64 Logger::droppedCount()
+{
+    return s_backend ? s_backend->dropped.load(std::memory_order_relaxed) : 0;
 }
@@ -2,61 +2,132 @@
 #define LOGGER_H
 
 #include <QString>
+#include <QStringList>
 #include <QObject>
+#include <atomic>
 
 /**
  * Unified logging system for Usagi-dono
- * 
+ *
  * This class provides a centralized logging mechanism that:
- * - Outputs to console (qDebug) for development
- * - Emits signal to update the Log tab in the UI
- * 
+ * - Outputs to console (qDebug) for development, and to a log file once setLogFile() was called
+ * - Emits batches of lines to update the Log tab in the UI
+ *
+ * Logging is asynchronous: Logger::log only stores the message, timestamp and source
+ * location in a lock-free ring buffer (any thread may log). A writer thread formats the
+ * records, writes them out and hands them to the UI at most every FLUSH_INTERVAL_MS,
+ * MAX_UI_LINES_PER_BATCH lines at a time (the console and file get every line).
+ * When the buffer is full, messages are dropped and the drop count is logged.
+ *
+ * Messages have a severity level. The LOG macros check the level before the message is
+ * built, so a filtered LOG_DEBUG(QString(...).arg(...)) costs one comparison:
+ * - at compile time, levels below USAGI_LOG_MIN_LEVEL are removed entirely
+ * - at run time, levels below setMinimumLevel() are skipped; the application starts at
+ *   Info, or at the level named by the USAGI_LOG_LEVEL environment variable
+ *
  * Note: CrashLog is intentionally kept separate for emergency crash situations only.
- * 
+ *
  * Usage:
- *   Logger::log("Your message here");
- *   Logger::log(QString("Formatted %1 message %2").arg(var1).arg(var2));
+ *   LOG("Your message here");                              // Info
+ *   LOG_DEBUG(QString("Formatted %1 message %2").arg(var1).arg(var2));
+ *   LOG_WARNING("Something looks wrong");
+ *   LOG_ERROR("Something failed");
  */
 class Logger : public QObject
 {
     Q_OBJECT
-    
+
 public:
+    enum Level {
+        Debug = 0,
+        Info,
+        Warning,
+        Error
+    };
+
+    static constexpr int RING_CAPACITY = 8192;          // Records; a power of two
+    static constexpr int FLUSH_INTERVAL_MS = 100;       // Writer wake-up and UI batch interval
+    static constexpr int MAX_UI_LINES_PER_BATCH = 200;  // Further lines of a batch only go to console/file
+
     /**
      * Main unified logging function
-     * Logs a message to console and UI log tab
-     * 
+     * Queues a message for the console, log file and UI log tab
+     *
+     * @param level Severity of the message
      * @param msg The message to log
      * @param file MANDATORY source file name (must not be empty) - prefer using LOG macro over __FILE__
      * @param line MANDATORY source line number (must be > 0) - prefer using LOG macro over __LINE__
-     * 
+     *
      * IMPORTANT: The file and line parameters are MANDATORY and enforced by assertions.
      * If the application hits these assertions at runtime, it means Logger::log is being
      * called INCORRECTLY. Use the LOG(msg) macro instead (preferred), which automatically
      * provides file and line information.
+     *
+     * @p file must outlive the logger (a string literal such as __FILE__).
      */
-    static void log(const QString &msg, const QString &file, int line);
-    
+    static void log(Level level, const QString &msg, const char *file, int line);
+
+    // Info message (kept for direct Logger::log(msg, __FILE__, __LINE__) calls)
+    static void log(const QString &msg, const char *file, int line) { log(Info, msg, file, line); }
+
+    // Runtime filter; messages below the level are neither built (macros) nor queued
+    static void setMinimumLevel(Level level) { s_minimumLevel.store(level, std::memory_order_relaxed); }
+    static Level minimumLevel() { return static_cast<Level>(s_minimumLevel.load(std::memory_order_relaxed)); }
+    static bool isEnabled(Level level) { return level >= s_minimumLevel.load(std::memory_order_relaxed); }
+
+    // "debug", "info", "warning" or "error" (any case) or their number; anything else gives fallback
+    static Level levelFromName(const QString &name, Level fallback);
+
+    // Also write every line to this file (truncated on open); empty path closes it
+    static bool setLogFile(const QString &path);
+
+    // Block until everything logged so far was written and handed to the UI
+    static void flush();
+
+    // Flush and stop the writer thread; later messages go straight to the console
+    static void shutdown();
+
+    // Messages dropped because the ring buffer was full
+    static quint64 droppedCount();
+
     /**
      * Get the singleton instance of the Logger
      */
     static Logger* instance();
-    
+
 signals:
     /**
-     * Signal emitted when a message is logged
+     * Signal emitted from the writer thread with the lines logged since the last batch
      * The Window class should connect to this to update the Log tab
      */
-    void logMessage(QString message);
-    
+    void logMessages(const QStringList &messages);
+
 private:
     Logger();
+
+    static std::atomic<int> s_minimumLevel;
 };
 
+// Levels below this are compiled out (0 = Debug ... 3 = Error)
+#ifndef USAGI_LOG_MIN_LEVEL
+#define USAGI_LOG_MIN_LEVEL 0
+#endif
+
 /**
- * Convenience macro for logging with file and line info
+ * Convenience macros for logging with file and line info
+ * The message expression is only evaluated when the level is enabled.
  * Usage: LOG("Your message")
  */
-#define LOG(msg) Logger::log(msg, __FILE__, __LINE__)
+#define LOG_AT(level, msg) \
+    do { \
+        if (static_cast<int>(level) >= USAGI_LOG_MIN_LEVEL && Logger::isEnabled(level)) { \
+            Logger::log(level, msg, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+#define LOG(msg) LOG_AT(Logger::Info, msg)
+#define LOG_DEBUG(msg) LOG_AT(Logger::Debug, msg)
+#define LOG_WARNING(msg) LOG_AT(Logger::Warning, msg)
+#define LOG_ERROR(msg) LOG_AT(Logger::Error, msg)
 
 #endif // LOGGER_H
@@ -2,6 +2,8 @@
 #include "window.h"
 #include "crashlog.h"
 #include "logger.h"
+#include <QDir>
+#include <QStandardPaths>
 //#include "main.h"
 
 //myAniDBApi *adbapi;
@@ -18,8 +20,20 @@ int main(int argc, char *argv[])
     // Install crash log handler
     CrashLog::install();
     
+    // Debug messages only when asked for (USAGI_LOG_LEVEL=debug)
+    Logger::setMinimumLevel(Logger::levelFromName(qEnvironmentVariable("USAGI_LOG_LEVEL"), Logger::Info));
+    
+    // Everything logged this session, next to the crash logs
+    QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(logDir);
+    Logger::setLogFile(logDir + "/usagi_debug.log");
+    
     app.addLibraryPath(".\\plugins");
     window = new Window;
     window->show();
-    return app.exec();
+    const int result = app.exec();
+    
+    // Write out what is still queued before the application objects go away
+    Logger::shutdown();
+    return result;
 }
@@ -4,13 +4,14 @@
 #include "logger.h"
 #include "main.h"
 #include "watchsessionmanager.h"
+#include "postercache.h"
+#include "posterdownloader.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QElapsedTimer>
 #include <QDateTime>
-#include <QNetworkRequest>
 #include <algorithm>
 #include <numeric>
 #include <atomic>
@@ -28,24 +29,34 @@ std::atomic<quint64> s_buildChainsFromCacheSequence{0};
 
 MyListCardManager::MyListCardManager(QObject *parent)
     : QObject(parent)
+    , m_cardEvictionScheduled(false)
     , m_layout(nullptr)
     , m_virtualLayout(nullptr)
     , m_watchSessionManager(nullptr)
+    , m_chainRevision(0)
     , m_chainModeEnabled(false)  // Initialize chain mode as disabled
     , m_chainsBuilt(false)  // Chains not built yet
     , m_chainBuildInProgress(false)  // No build in progress initially
     , m_dataReady(false)  // Data not ready initially
     , m_lastChainBuildAnimeCount(0)  // No chains built yet
-    , m_networkManager(nullptr)
+    , m_posterCache(nullptr)
+    , m_posterDownloader(nullptr)
     , m_initialLoadComplete(false)
 {
     LOG(QString("[MyListCardManager] Constructed manager instance=%1 adbapi=%2")
         .arg(reinterpret_cast<quintptr>(this), 0, 16)
         .arg(reinterpret_cast<quintptr>(adbapi), 0, 16));
-    // Initialize network manager for poster downloads
-    m_networkManager = new QNetworkAccessManager(this);
-    connect(m_networkManager, &QNetworkAccessManager::finished,
-            this, &MyListCardManager::onPosterDownloadFinished);
+    // Posters are decoded and scaled on worker threads
+    m_posterCache = new PosterCache(this);
+    connect(m_posterCache, &PosterCache::posterReady,
+            this, &MyListCardManager::onPosterThumbnailReady);
+    
+    // Poster downloads: a few at a time, cards on screen first
+    m_posterDownloader = new PosterDownloader(this);
+    connect(m_posterDownloader, &PosterDownloader::posterDownloaded,
+            this, &MyListCardManager::onPosterDownloaded);
+    connect(m_posterDownloader, &PosterDownloader::posterNotModified,
+            this, [this](int aid, const QString &) { onPosterNotModified(aid); });
     
     // Initialize batch update timer
     m_batchUpdateTimer = new QTimer(this);
@@ -79,6 +90,10 @@ void MyListCardManager::setVirtualLayout(VirtualFlowLayout *layout)
         
         // Set the item size to match anime card size
         m_virtualLayout->setItemSize(AnimeCard::getCardSize());
+        
+        // Cards that scroll out of view become candidates for eviction
+        connect(m_virtualLayout, &VirtualFlowLayout::widgetRecycled,
+                this, &MyListCardManager::onCardWidgetRecycled, Qt::UniqueConnection);
     }
 }
 
@@ -107,10 +122,11 @@ void MyListCardManager::setAnimeIdList(const QList<int>& aids, bool chainModeEna
     {
         QMutexLocker locker(&m_mutex);
         
-        // Wait for ALL data to be ready (preload + chain building complete)
-        while (!m_dataReady) {
-            LOG("[MyListCardManager] Waiting for data to be ready (preload + chain building)...");
-            m_dataReadyCondition.wait(&m_mutex);
+        // Never wait for the preload: while it runs the list is shown without chains
+        // (as skeleton cards where data is missing) and is set again once it finished
+        if (!m_dataReady && chainModeEnabled) {
+            LOG("[MyListCardManager] setAnimeIdList: data still loading, chain mode deferred");
+            chainModeEnabled = false;
         }
         
         m_chainModeEnabled = chainModeEnabled;
@@ -149,9 +165,8 @@ void MyListCardManager::setAnimeIdList(const QList<int>& aids, bool chainModeEna
                 QList<AnimeChain> filteredChains;
                 
                 // Create relation lookup function for standalone chains
-                // NOTE: We're already holding m_mutex here, so we cannot call loadRelationDataForAnime
-                // (it would try to acquire the mutex again, causing a deadlock)
-                // Instead, directly access the cache which is already populated
+                // NOTE: We're already holding m_mutex here, so directly access the cache
+                // which is already populated
                 auto relationLookup = [this](int aid) -> QPair<int,int> {
                     // Direct cache access - mutex already held by caller (setAnimeIdList)
                     auto it = m_cardCreationDataCache.find(aid);
@@ -182,6 +197,7 @@ void MyListCardManager::setAnimeIdList(const QList<int>& aids, bool chainModeEna
                 // Use filteredChains (local variable) - never modify m_chainList
                 // Store filtered chains (including standalone ones) for use by sortChains
                 m_displayedChains = filteredChains;
+                m_chainSortIndex.clear();
                 m_aidToChainIndex.clear();
                 finalAnimeIds.clear();
                 for (int i = 0; i < filteredChains.size(); ++i) {
@@ -202,6 +218,7 @@ void MyListCardManager::setAnimeIdList(const QList<int>& aids, bool chainModeEna
             // IMPORTANT: Do NOT clear m_chainList - it's the master list from cache and is reused
             m_aidToChainIndex.clear();
             m_displayedChains.clear();  // Clear displayed chains when not in chain mode
+            m_chainSortIndex.clear();
             finalAnimeIds = aids;
         }
         
@@ -229,117 +246,13 @@ QList<AnimeChain> MyListCardManager::buildChainsFromAnimeIds(const QList<int>& a
     LOG(QString("[MyListCardManager] buildChainsFromAnimeIds: input has %1 anime, %2 unique, expansion=ALWAYS ON")
         .arg(aids.size()).arg(availableAids.size()));
     
-    // Create relation lookup function
-    auto relationLookup = [this](int aid) -> QPair<int,int> {
-        const_cast<MyListCardManager*>(this)->loadRelationDataForAnime(aid);
-        return QPair<int,int>(findPrequelAid(aid), findSequelAid(aid));
-    };
-    
-    // Map: anime ID -> chain index (which chain this anime belongs to)
-    QMap<int, int> animeToChainIdx;
-    QList<AnimeChain> chains;
-    
-    // Create initial chains - one per anime
-    int idx = 0;
-    for (int aid : availableAids) {
-        AnimeChain chain(aid, relationLookup);
-        chains.append(chain);
-        animeToChainIdx[aid] = idx;
-        idx++;
-    }
-    
-    LOG(QString("[MyListCardManager] Created %1 initial chains").arg(chains.size()));
-    
-    // Track which chain indices have been merged (deleted)
-    QSet<int> deletedChains;
-    
-    // Process each chain: expand and merge as needed
-    for (int i = 0; i < chains.size(); i++) {
-        if (deletedChains.contains(i)) {
-            continue;  // This chain was already merged into another
-        }
-        
-        // Expand this chain to include all related anime
-        // The expand method will add related anime not yet in the chain
-        QSet<int> processed;
-        bool changed = true;
-        int iterations = 0;
-        const int MAX_ITERATIONS = 100;
-        
-        while (changed && iterations < MAX_ITERATIONS) {
-            changed = false;
-            iterations++;
-            
-            QList<int> currentAnime = chains[i].getAnimeIds();
-            for (int aid : currentAnime) {
-                if (processed.contains(aid)) {
-                    continue;
-                }
-                processed.insert(aid);
-                
-                auto unbound = chains[i].getUnboundRelations(aid);
-                
-                // Process prequel
-                if (unbound.first > 0) {
-                    if (animeToChainIdx.contains(unbound.first)) {
-                        // Prequel is in another chain - merge that chain into this one
-                        int otherIdx = animeToChainIdx[unbound.first];
-                        if (otherIdx != i && !deletedChains.contains(otherIdx)) {
-                            chains[i].mergeWith(chains[otherIdx], relationLookup);
-                            deletedChains.insert(otherIdx);
-                            
-                            // Rebuild map for all anime in merged chain to ensure consistency
-                            for (int aid2 : chains[i].getAnimeIds()) {
-                                animeToChainIdx[aid2] = i;
-                            }
-                            changed = true;
-                        }
-                    } else {
-                        // Prequel not in any chain yet - add it via expanding
-                        AnimeChain prequelChain(unbound.first, relationLookup);
-                        chains[i].mergeWith(prequelChain, relationLookup);
-                        animeToChainIdx[unbound.first] = i;
-                        changed = true;
-                    }
-                }
-                
-                // Process sequel
-                if (unbound.second > 0) {
-                    if (animeToChainIdx.contains(unbound.second)) {
-                        // Sequel is in another chain - merge that chain into this one
-                        int otherIdx = animeToChainIdx[unbound.second];
-                        if (otherIdx != i && !deletedChains.contains(otherIdx)) {
-                            chains[i].mergeWith(chains[otherIdx], relationLookup);
-                            deletedChains.insert(otherIdx);
-                            
-                            // Rebuild map for all anime in merged chain to ensure consistency
-                            for (int aid2 : chains[i].getAnimeIds()) {
-                                animeToChainIdx[aid2] = i;
-                            }
-                            changed = true;
-                        }
-                    } else {
-                        // Sequel not in any chain yet - add it via expanding
-                        AnimeChain sequelChain(unbound.second, relationLookup);
-                        chains[i].mergeWith(sequelChain, relationLookup);
-                        animeToChainIdx[unbound.second] = i;
-                        changed = true;
-                    }
-                }
-            }
-        }
-        
-        if (iterations >= MAX_ITERATIONS) {
-            LOG(QString("[MyListCardManager] [DEBUG] WARNING: Chain %1 hit MAX_ITERATIONS limit!").arg(i));
-        }
-    }
-    
-    // Remove deleted chains
+    // The graph already holds chain membership (fed by updateMetadataStore), so each
+    // chain is looked up once instead of being expanded and merged pairwise
     QList<AnimeChain> finalChains;
-    for (int i = 0; i < chains.size(); i++) {
-        if (!deletedChains.contains(i)) {
-            finalChains.append(chains[i]);
-        }
+    const QList<QList<int>> chainIds = m_relationGraph.chainsOf(aids);
+    finalChains.reserve(chainIds.size());
+    for (const QList<int>& animeIds : chainIds) {
+        finalChains.append(AnimeChain(animeIds));
     }
     
     LOG(QString("[MyListCardManager] Final chain count: %1").arg(finalChains.size()));
@@ -400,236 +313,6 @@ QList<AnimeChain> MyListCardManager::buildChainsFromAnimeIds(const QList<int>& a
     return finalChains;
 }
 
-QList<int> MyListCardManager::buildChainFromAid(int startAid, const QSet<int>& availableAids, bool expandChain) const
-{
-    QList<int> chain;
-    QSet<int> visited;
-    QSet<int> backwardTraversedAnime;  // Track anime found during backward traversal
-    const int MAX_CHAIN_LENGTH = 20;  // Safety limit to prevent infinite loops
-    
-    // Find the original prequel (first in chain)
-    int currentAid = startAid;
-    
-    // Only traverse backward if startAid is in our filtered set
-    if (!expandChain && !availableAids.contains(startAid)) {
-        return QList<int>();  // Return empty chain - anime not in filtered list
-    }
-    
-    // Ensure relation data is loaded for startAid
-    loadRelationDataForAnime(startAid);
-    
-    // Track the last anime we found that's in our filtered set
-    int lastAvailableAid = startAid;
-    
-    // Traverse backward to find the first prequel
-    while (true) {
-        if (visited.contains(currentAid)) {
-            break;  // Cycle detected
-        }
-        visited.insert(currentAid);
-        
-        // Track all anime found during backward traversal when expanding
-        if (expandChain) {
-            backwardTraversedAnime.insert(currentAid);
-        }
-        
-        if (visited.size() > MAX_CHAIN_LENGTH) {
-            LOG(QString("[MyListCardManager] WARNING: Chain too long (>%1), stopping backward traversal").arg(MAX_CHAIN_LENGTH));
-            break;
-        }
-        
-        int prequelAid = findPrequelAid(currentAid);
-        if (prequelAid == 0) {
-            break;  // No prequel
-        }
-        
-        // Load relation data for the prequel
-        if (expandChain) {
-            loadRelationDataForAnime(prequelAid);
-        }
-        
-        // If not expanding, stop at prequels not in available set
-        if (!expandChain && !availableAids.contains(prequelAid)) {
-            break;
-        }
-        
-        // Update last available anime
-        if (expandChain || availableAids.contains(prequelAid)) {
-            lastAvailableAid = prequelAid;
-        }
-        
-        currentAid = prequelAid;
-    }
-    
-    // Ensure the final anime from backward traversal is also tracked
-    if (expandChain && currentAid > 0 && !backwardTraversedAnime.contains(currentAid)) {
-        backwardTraversedAnime.insert(currentAid);
-    }
-    
-    // Now build chain forward from the last anime in our filtered set
-    // (or from the first prequel if expanding)
-    visited.clear();
-    int chainStart = expandChain ? currentAid : lastAvailableAid;
-    currentAid = chainStart;
-    
-    while (currentAid > 0 && !visited.contains(currentAid)) {
-        // When expanding, include all anime in chain
-        // When not expanding, only include anime in availableAids
-        if (expandChain || availableAids.contains(currentAid)) {
-            chain.append(currentAid);
-            visited.insert(currentAid);
-            
-            if (visited.size() > MAX_CHAIN_LENGTH) {
-                LOG(QString("[MyListCardManager] WARNING: Chain too long (>%1), stopping forward traversal").arg(MAX_CHAIN_LENGTH));
-                break;
-            }
-            
-            int sequelAid = findSequelAid(currentAid);
-            if (sequelAid == 0) {
-                break;  // No sequel
-            }
-            
-            // Load relation data for the sequel (only when expanding)
-            if (expandChain) {
-                loadRelationDataForAnime(sequelAid);
-            }
-            
-            // If not expanding, stop at sequels not in available set
-            if (!expandChain && !availableAids.contains(sequelAid)) {
-                break;
-            }
-            
-            currentAid = sequelAid;
-        } else {
-            // Current anime not in available set and not expanding - stop traversing
-            break;
-        }
-    }
-    
-    // CRITICAL FIX: Ensure all anime from backward traversal and availableAids are in the chain
-    // If we couldn't reach some anime via sequel relationships due to database inconsistencies,
-    // append them in the correct order based on their prequel relationships
-    if (expandChain || !availableAids.isEmpty()) {
-        QSet<int> chainSet;
-        for (int aid : chain) {
-            chainSet.insert(aid);
-        }
-        
-        // Collect all anime that should be in the chain
-        QSet<int> shouldBeInChain;
-        
-        // Add anime from backward traversal (when expanding)
-        if (expandChain) {
-            for (int aid : backwardTraversedAnime) {
-                shouldBeInChain.insert(aid);
-            }
-        }
-        
-        // Add anime from availableAids
-        for (int aid : availableAids) {
-            shouldBeInChain.insert(aid);
-        }
-        
-        // Find anime that should be in chain but are not
-        QList<int> missingAnime;
-        for (int aid : shouldBeInChain) {
-            if (!chainSet.contains(aid)) {
-                missingAnime.append(aid);
-            }
-        }
-        
-        // If there are missing anime, try to add them in the correct order
-        if (!missingAnime.isEmpty()) {
-            LOG(QString("[MyListCardManager] WARNING: %1 anime should be in chain but not reachable from chainStart=%2 via sequel relationships")
-                .arg(missingAnime.size()).arg(chainStart));
-            
-            // Sort missing anime by their position in the chain (using prequel/sequel relationships)
-            // For each missing anime, traverse to find where it should be inserted
-            for (int missingAid : missingAnime) {
-                loadRelationDataForAnime(missingAid);
-                
-                // Find the position to insert this anime
-                // Check both directions: is any anime in chain its sequel, or is missing anime a prequel of any in chain
-                int insertAfterIndex = -1;
-                int insertBeforeIndex = -1;
-                
-                for (int i = 0; i < chain.size(); ++i) {
-                    // Check if chain[i] is the prequel of missing anime (missing should come after chain[i])
-                    if (findSequelAid(chain[i]) == missingAid) {
-                        insertAfterIndex = i;
-                        break;
-                    }
-                    // Check if missing anime is the prequel of chain[i] (missing should come before chain[i])
-                    if (findSequelAid(missingAid) == chain[i]) {
-                        insertBeforeIndex = i;
-                        break;
-                    }
-                }
-                
-                if (insertAfterIndex >= 0) {
-                    // Insert after the prequel
-                    chain.insert(insertAfterIndex + 1, missingAid);
-                    LOG(QString("[MyListCardManager] Inserted aid=%1 after aid=%2 (sequel relationship)")
-                        .arg(missingAid).arg(chain[insertAfterIndex]));
-                } else if (insertBeforeIndex >= 0) {
-                    // Insert before the sequel
-                    chain.insert(insertBeforeIndex, missingAid);
-                    LOG(QString("[MyListCardManager] Inserted aid=%1 before aid=%2 (prequel relationship)")
-                        .arg(missingAid).arg(chain[insertBeforeIndex]));
-                } else {
-                    // Couldn't find a good position, append at the end
-                    chain.append(missingAid);
-                    LOG(QString("[MyListCardManager] Appended aid=%1 at end (no relationship found)")
-                        .arg(missingAid));
-                }
-            }
-        }
-    }
-    
-    return chain;
-}
-
-int MyListCardManager::findPrequelAid(int aid) const
-{
-    // Use cached relation data
-    if (!m_cardCreationDataCache.contains(aid)) {
-        return 0;
-    }
-    
-    const CardCreationData& data = m_cardCreationDataCache[aid];
-    return data.getPrequel();
-}
-
-int MyListCardManager::findSequelAid(int aid) const
-{
-    // Use cached relation data
-    if (!m_cardCreationDataCache.contains(aid)) {
-        return 0;
-    }
-    
-    const CardCreationData& data = m_cardCreationDataCache[aid];
-    return data.getSequel();
-}
-
-
-
-void MyListCardManager::loadRelationDataForAnime(int aid) const
-{
-    // This function now ONLY reads from the preloaded cache
-    // All relation data must be preloaded via preloadRelationDataForChainExpansion() before chain building
-    // Database calls are NOT permitted here to avoid performance issues during chain expansion
-    
-    QMutexLocker locker(&m_mutex);
-    
-    // If already in cache, nothing to do
-    if (m_cardCreationDataCache.contains(aid)) {
-        return;
-    }
-    
-    // If not in cache, it means preloading didn't include this anime
-    // This is expected for anime that are not in the database or were filtered out
-}
-
 void MyListCardManager::sortChains(AnimeChain::SortCriteria criteria, bool ascending)
 {
     QMutexLocker locker(&m_mutex);
@@ -644,14 +327,27 @@ void MyListCardManager::sortChains(AnimeChain::SortCriteria criteria, bool ascen
     LOG(QString("[MyListCardManager] Sorting chains by criteria %2, ascending=%3 (current ordered list has %4 anime)")
         .arg(static_cast<int>(criteria)).arg(ascending).arg(inputAnimeCount));
     
-    // Sort the displayed chains (includes both pre-built and standalone chains)
-    QList<AnimeChain> displayedChains = m_displayedChains;  // Work with a copy
+    QElapsedTimer timer;
+    timer.start();
+    
+    // Reduce the displayed chains (pre-built and standalone) to sort keys once; the index
+    // keeps them until the chains or the cached data change
+    if (m_chainSortIndex.isEmpty()) {
+        QList<ChainSortIndex::ChainData> chainData;
+        chainData.reserve(m_displayedChains.size());
+        for (const AnimeChain& chain : std::as_const(m_displayedChains)) {
+            chainData.append(ChainSortIndex::chainData(chain, m_cardCreationDataCache));
+        }
+        m_chainSortIndex.setChains(chainData);
+        m_sortBaseChains = m_displayedChains;
+    }
+    const bool keysCached = m_chainSortIndex.isCached(criteria);
     
-    // Sort the displayed chains
-    std::sort(displayedChains.begin(), displayedChains.end(),
-              [this, criteria, ascending](const AnimeChain& a, const AnimeChain& b) {
-                  return a.compareWith(b, m_cardCreationDataCache, criteria, ascending) < 0;
-              });
+    QList<AnimeChain> displayedChains;
+    displayedChains.reserve(m_sortBaseChains.size());
+    for (int index : m_chainSortIndex.order(criteria, ascending)) {
+        displayedChains.append(m_sortBaseChains[index]);
+    }
     
     // Rebuild flattened anime ID list from sorted displayed chains
     m_orderedAnimeIds.clear();
@@ -672,8 +368,9 @@ void MyListCardManager::sortChains(AnimeChain::SortCriteria criteria, bool ascen
             .arg(inputAnimeCount).arg(m_orderedAnimeIds.size()));
     }
     
-    LOG(QString("[MyListCardManager] Rebuilt ordered list: %1 anime in %2 chains (master list unchanged with %3 chains)")
-        .arg(m_orderedAnimeIds.size()).arg(displayedChains.size()).arg(m_chainList.size()));
+    LOG(QString("[MyListCardManager] Rebuilt ordered list: %1 anime in %2 chains (master list unchanged with %3 chains) in %4 ms (%5 sort keys)")
+        .arg(m_orderedAnimeIds.size()).arg(displayedChains.size()).arg(m_chainList.size())
+        .arg(timer.elapsed()).arg(keysCached ? "cached" : "computed"));
     
     // Note: We don't call refresh() here because it causes re-entrancy issues
     // when called synchronously during sorting. The caller (window.cpp) will
@@ -732,13 +429,6 @@ AnimeCard* MyListCardManager::createCardForIndex(int index)
 {
     QMutexLocker locker(&m_mutex);
     
-    // Wait for ALL data to be ready before creating cards
-    while (!m_dataReady) {
-        LOG(QString("[MyListCardManager] createCardForIndex: index=%1 waiting for data (chainsBuilt=%2, chainBuildInProgress=%3)")
-            .arg(index).arg(m_chainsBuilt).arg(m_chainBuildInProgress));
-        m_dataReadyCondition.wait(&m_mutex);
-    }
-    
     if (index < 0 || index >= m_orderedAnimeIds.size()) {
         LOG(QString("[MyListCardManager] createCardForIndex: index %1 out of range (size=%2)")
             .arg(index).arg(m_orderedAnimeIds.size()));
@@ -769,7 +459,13 @@ void MyListCardManager::clearAllCards()
         m_virtualLayout->clear();
     }
     
-    if (m_layout) {
+    if (m_virtualLayout) {
+        // The virtual layout only hides its widgets; the cards are ours to delete
+        const auto cardValues = m_cards.values();
+        for (AnimeCard* const card : cardValues) {
+            card->deleteLater();
+        }
+    } else if (m_layout) {
         // Remove cards from layout and delete them
         const auto cardValues = m_cards.values();
         for (AnimeCard* const card : cardValues) {
@@ -779,8 +475,14 @@ void MyListCardManager::clearAllCards()
     }
     
     m_cards.clear();
+    m_cardCache.clear();
+    m_loadingCardAids.clear();
     m_orderedAnimeIds.clear();
     m_cardCreationDataCache.clear();  // Clear the comprehensive card creation data cache
+    m_metadataStore.clear();
+    m_filterIndex.clear();
+    m_chainSortIndex.clear();
+    m_relationGraph.clear();
     m_episodesNeedingData.clear();
     m_animeNeedingMetadata.clear();
     m_animeNeedingPoster.clear();
@@ -807,6 +509,103 @@ QList<AnimeCard*> MyListCardManager::getAllCards() const
     return m_cards.values();
 }
 
+void MyListCardManager::setCardCacheBudget(int maxCards, qint64 maxBytes)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cardCache.setBudget(maxCards, maxBytes);
+    }
+    scheduleCardEviction();
+}
+
+CardCache::Stats MyListCardManager::cardCacheStats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cardCache.stats();
+}
+
+void MyListCardManager::onCardWidgetRecycled(int /*oldIndex*/, int /*newIndex*/, QWidget* /*widget*/)
+{
+    scheduleCardEviction();
+}
+
+void MyListCardManager::scheduleCardEviction()
+{
+    QMutexLocker locker(&m_mutex);
+    
+    // Only virtual scrolling rebuilds a deleted card when it is needed again
+    if (!m_virtualLayout || m_cardEvictionScheduled) {
+        return;
+    }
+    m_cardEvictionScheduled = true;
+    
+    // Queued so a scroll step that recycles and creates many cards is evicted once,
+    // with all of its new cards already on screen
+    QMetaObject::invokeMethod(this, &MyListCardManager::evictCards, Qt::QueuedConnection);
+}
+
+void MyListCardManager::evictCards()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cardEvictionScheduled = false;
+    
+    if (!m_virtualLayout) {
+        return;
+    }
+    
+    // Posters are set after a card is created, so sizes are measured again here
+    for (auto it = m_cards.constBegin(); it != m_cards.constEnd(); ++it) {
+        m_cardCache.updateSize(it.key(), it.value()->estimatedMemoryBytes());
+    }
+    
+    // Poster downloads follow the viewport
+    const QSet<int> visibleAids = visibleCardAids();
+    for (int aid : std::as_const(m_posterVisibleAids)) {
+        if (!visibleAids.contains(aid)) {
+            m_posterDownloader->setPriority(aid, PosterDownloader::Nearby);
+        }
+    }
+    for (int aid : visibleAids) {
+        m_posterDownloader->setPriority(aid, PosterDownloader::Visible);
+    }
+    m_posterVisibleAids = visibleAids;
+    
+    // Cards on screen are never evicted
+    const QList<int> evictedAids = m_cardCache.evict(visibleAids);
+    QList<AnimeCard*> evictedCards;
+    for (int aid : evictedAids) {
+        m_loadingCardAids.remove(aid);
+        // A standalone card of the same anime still waits for the thumbnail
+        if (!m_standaloneCards.contains(aid)) {
+            m_posterCache->cancel(aid);
+        }
+        m_posterDownloader->cancel(aid);
+        AnimeCard *card = m_cards.take(aid);
+        if (card) {
+            evictedCards.append(card);
+        }
+    }
+    const CardCache::Stats stats = m_cardCache.stats();
+    locker.unlock();
+    
+    if (evictedCards.isEmpty()) {
+        return;
+    }
+    
+    for (AnimeCard *card : std::as_const(evictedCards)) {
+        emit cardEvicted(card->getAnimeId(), card);
+        card->deleteLater();
+    }
+    
+    LOG(QString("[MyListCardManager] Evicted %1 off-screen cards: %2 resident (%3 MB), hit rate %4% over %5 lookups, %6 rebinds")
+        .arg(evictedCards.size())
+        .arg(stats.residentCards)
+        .arg(stats.residentBytes / (1024 * 1024))
+        .arg(stats.hitRate() * 100.0, 0, 'f', 1)
+        .arg(stats.hits + stats.misses)
+        .arg(stats.rebinds));
+}
+
 MyListCardManager::CachedAnimeData MyListCardManager::getCachedAnimeData(int aid) const
 {
     QMutexLocker locker(&m_mutex);
@@ -862,6 +661,196 @@ bool MyListCardManager::hasCachedData(int aid) const
     return m_cardCreationDataCache.contains(aid) && m_cardCreationDataCache[aid].hasData;
 }
 
+QList<int> MyListCardManager::sortAnimeIds(const QList<int>& aids, AnimeChain::SortCriteria criteria, bool ascending) const
+{
+    QMutexLocker locker(&m_mutex);
+    QElapsedTimer timer;
+    timer.start();
+    
+    QList<int> result = m_metadataStore.sorted(aids, criteria, ascending);
+    
+    LOG(QString("[MyListCardManager] Sorted %1 anime by criteria %2 in %3 ms")
+        .arg(aids.size()).arg(static_cast<int>(criteria)).arg(timer.elapsed()));
+    return result;
+}
+
+QList<int> MyListCardManager::filterAnimeIds(const QList<int>& aids, const AnimeFilterIndex::Criteria& criteria,
+                                             const AnimeMetadataCache* alternativeTitles) const
+{
+    QMutexLocker locker(&m_mutex);
+    QElapsedTimer timer;
+    timer.start();
+    
+    const RoaringBitmap matches = m_filterIndex.matching(criteria, alternativeTitles);
+    QList<int> result;
+    result.reserve(static_cast<qsizetype>(matches.cardinality()));
+    for (int aid : aids) {
+        if (aid > 0 && matches.contains(static_cast<quint32>(aid))) {
+            result.append(aid);
+        }
+    }
+    
+    LOG(QString("[MyListCardManager] Filtered %1 anime to %2 in %3 ms")
+        .arg(aids.size()).arg(result.size()).arg(timer.elapsed()));
+    return result;
+}
+
+void MyListCardManager::updateMetadataStore(const QList<int>& aids)
+{
+    // Chain sort keys are derived from the same data
+    if (!aids.isEmpty()) {
+        m_chainSortIndex.clear();
+    }
+    
+    QSet<int> chainsAffected;
+    for (int aid : aids) {
+        auto it = m_cardCreationDataCache.constFind(aid);
+        if (it == m_cardCreationDataCache.constEnd()) {
+            m_metadataStore.remove(aid);
+            m_filterIndex.remove(aid);
+            continue;
+        }
+        const CardCreationData& data = it.value();
+        
+        for (int changedAid : m_relationGraph.setRelations(aid, data.getPrequel(), data.getSequel())) {
+            chainsAffected.insert(changedAid);
+        }
+        
+        AnimeMetadataStore::Row row;
+        row.aid = aid;
+        row.title = AnimeUtils::determineAnimeName(data.nameRomaji, data.nameEnglish, data.animeTitle, aid);
+        row.typeName = data.typeName;
+        row.startDate = data.startDate;
+        row.endDate = data.endDate;
+        row.rating = data.rating;
+        row.eptotal = data.eptotal;
+        row.normalEpisodes = data.stats.normalEpisodes();
+        row.normalViewed = data.stats.normalViewed();
+        row.otherEpisodes = data.stats.otherEpisodes();
+        row.otherViewed = data.stats.otherViewed();
+        row.lastPlayed = data.lastPlayed;
+        row.recentEpisodeAirDate = data.recentEpisodeAirDate;
+        row.hidden = data.isHidden;
+        row.adult = data.is18Restricted;
+        m_metadataStore.upsert(row);
+        
+        // Anime without anime/title data are indexed with their default keys so that they
+        // stay in the filtered list like their (skeleton) cards did before
+        AnimeFilterIndex::Entry entry;
+        entry.title = row.title;
+        entry.typeName = data.typeName;
+        entry.is18Restricted = data.is18Restricted;
+        entry.normalEpisodes = data.stats.normalEpisodes();
+        entry.normalViewed = data.stats.normalViewed();
+        entry.otherEpisodes = data.stats.otherEpisodes();
+        entry.otherViewed = data.stats.otherViewed();
+        entry.totalEpisodes = data.eptotal > 0 ? data.eptotal : data.stats.totalNormalEpisodes();
+        m_filterIndex.update(aid, entry);
+    }
+    
+    // Before the first build the chains are created from the graph as a whole
+    if (m_chainsBuilt && !chainsAffected.isEmpty()) {
+        updateChains(chainsAffected);
+    }
+}
+
+void MyListCardManager::updateChains(const QSet<int>& aids)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    // Current graph chains of every affected anime, and the anime they now cover
+    const QList<QList<int>> chainIds = m_relationGraph.chainsOf(QList<int>(aids.cbegin(), aids.cend()));
+    QHash<int, int> newChainOf;
+    for (int i = 0; i < chainIds.size(); ++i) {
+        for (int aid : chainIds[i]) {
+            newChainOf.insert(aid, i);
+        }
+    }
+    auto touchesCovered = [&newChainOf](const AnimeChain& chain) {
+        const QList<int> animeIds = chain.getAnimeIds();
+        return std::any_of(animeIds.cbegin(), animeIds.cend(), [&newChainOf](int aid) { return newChainOf.contains(aid); });
+    };
+    
+    // Master list: drop the old chains, append the new ones
+    m_chainList.erase(std::remove_if(m_chainList.begin(), m_chainList.end(), touchesCovered), m_chainList.end());
+    for (const QList<int>& animeIds : chainIds) {
+        m_chainList.append(AnimeChain(animeIds));
+    }
+    
+    // Displayed chains: replace in place so the current order is kept; a chain that merged
+    // several displayed chains takes the position of the first of them
+    if (!m_displayedChains.isEmpty()) {
+        QList<AnimeChain> displayedChains;
+        displayedChains.reserve(m_displayedChains.size());
+        QSet<int> placed;
+        for (const AnimeChain& chain : std::as_const(m_displayedChains)) {
+            if (!touchesCovered(chain)) {
+                displayedChains.append(chain);
+                continue;
+            }
+            for (int aid : chain.getAnimeIds()) {
+                const int i = newChainOf.value(aid, -1);
+                if (i >= 0 && !placed.contains(i)) {
+                    placed.insert(i);
+                    displayedChains.append(AnimeChain(chainIds[i]));
+                }
+            }
+        }
+        // m_orderedAnimeIds is rebuilt from these by the next sortChains()
+        m_displayedChains = displayedChains;
+    }
+    
+    // m_aidToChainIndex follows the displayed chains once a list is shown, the master list before
+    const QList<AnimeChain>& indexedChains = m_displayedChains.isEmpty() ? m_chainList : m_displayedChains;
+    m_aidToChainIndex.clear();
+    for (int i = 0; i < indexedChains.size(); ++i) {
+        for (int aid : indexedChains[i].getAnimeIds()) {
+            m_aidToChainIndex[aid] = i;
+        }
+    }
+    
+    m_chainSortIndex.clear();
+    ++m_chainRevision;
+    
+    LOG(QString("[MyListCardManager] Updated %1 chains for %2 changed anime in %3 ms (%4 chains total)")
+        .arg(chainIds.size()).arg(aids.size()).arg(timer.elapsed()).arg(m_chainList.size()));
+}
+
+void MyListCardManager::refreshRelations(int aid)
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen()) {
+        return;
+    }
+    QSqlQuery q(db);
+    q.prepare("SELECT relaidlist, relaidtype FROM anime WHERE aid = ?");
+    q.addBindValue(aid);
+    if (!q.exec() || !q.next()) {
+        return;
+    }
+    const QString relaidlist = q.value(0).toString();
+    const QString relaidtype = q.value(1).toString();
+    
+    QMutexLocker locker(&m_mutex);
+    auto it = m_cardCreationDataCache.find(aid);
+    if (it != m_cardCreationDataCache.end()) {
+        if (it->getRelationAidList() != relaidlist || it->getRelationTypeList() != relaidtype) {
+            it->setRelations(relaidlist, relaidtype);
+            updateMetadataStore(QList<int>{aid});
+        }
+        return;
+    }
+    
+    // Not a card of ours, but it may link cached anime into one chain
+    RelationData relations;
+    relations.setRelations(relaidlist, relaidtype);
+    const QList<int> affected = m_relationGraph.setRelations(aid, relations.getPrequel(), relations.getSequel());
+    if (m_chainsBuilt && !affected.isEmpty()) {
+        updateChains(QSet<int>(affected.cbegin(), affected.cend()));
+    }
+}
+
 void MyListCardManager::updateCardAnimeInfo(int aid)
 {
     QMutexLocker locker(&m_mutex);
@@ -891,28 +880,18 @@ void MyListCardManager::refreshAllCards()
 {
     LOG("[MyListCardManager] Refreshing all cards to update file markings");
     
-    // Get all current aids and recreate cards to pick up new file marks
+    // Get all current aids and rebind cards to pick up new file marks
     QList<int> aids = m_orderedAnimeIds;
     
-    // Clear and recreate all cards
+    // Existing cards are rebound in place. With virtual scrolling the others are
+    // bound when they scroll into view; without it every anime needs a card
     for (int aid : aids) {
-        if (m_cards.contains(aid)) {
-            // Remove the old card
-            AnimeCard* oldCard = m_cards.take(aid);
-            if (oldCard) {
-                oldCard->deleteLater();
-            }
+        if (!rebindCard(aid) && !m_virtualLayout) {
+            createCard(aid);
         }
     }
     
-    // Recreate cards with updated file marks
-    for (int aid : aids) {
-        createCard(aid);
-    }
-    
-    // Notify the virtual layout to refresh its widget references
-    // This is critical because the old widgets are now scheduled for deletion
-    // and the layout must fetch the new widgets from the factory
+    // Rebinding may have changed hidden states (and with them card sizes)
     if (m_virtualLayout) {
         LOG("[MyListCardManager] Refreshing virtual layout after all cards refresh");
         m_virtualLayout->refresh();
@@ -965,25 +944,14 @@ void MyListCardManager::refreshCardsForLids(const QSet<int>& lids)
     LOG(QString("[MyListCardManager] Refreshing %1 cards for %2 updated lids")
         .arg(aidsToRefresh.size()).arg(lids.size()));
     
-    // Refresh only the affected cards
+    // Refresh only the affected cards; cards that don't exist are bound with
+    // the updated data when they are next needed
     for (int aid : aidsToRefresh) {
-        if (m_cards.contains(aid)) {
-            // Remove the old card
-            AnimeCard* oldCard = m_cards.take(aid);
-            if (oldCard) {
-                oldCard->deleteLater();
-            }
-            // Recreate with updated data
-            AnimeCard* newCard = createCard(aid);
-            if (!newCard) {
-                LOG(QString("[MyListCardManager] WARNING: createCard returned null for aid=%1 during refresh").arg(aid));
-            }
-        }
+        rebindCard(aid);
+        emit cardUpdated(aid);
     }
     
-    // Notify the virtual layout to refresh its widget references
-    // This is critical because the old widgets are now scheduled for deletion
-    // and the layout must fetch the new widgets from the factory
+    // Rebinding may have changed hidden states (and with them card sizes)
     if (m_virtualLayout) {
         LOG("[MyListCardManager] Refreshing virtual layout after card updates");
         m_virtualLayout->refresh();
@@ -1053,11 +1021,9 @@ void MyListCardManager::updateOrAddMylistEntry(int lid)
     
     if (isNewAnime) {
         // If the initial data load hasn't completed yet (m_dataReady=false and
-        // chains not built), skip card creation.  createCard() blocks on
-        // m_dataReadyCondition which would deadlock the main thread because
-        // the initial load that sets m_dataReady=true also runs on the main
-        // thread.  The anime will be picked up by the initial load when it
-        // completes.
+        // chains not built), skip card creation.  The initial load creates the
+        // cards of its anime list itself (as skeletons until their data is
+        // loaded), and the anime will be picked up by it when it completes.
         if (!dataReady && !chainsBuilt) {
             LOG(QString("[MyListCardManager] updateOrAddMylistEntry: initial load not complete "
                         "(dataReady=%1, chainsBuilt=%2), deferring card creation for aid=%3")
@@ -1099,6 +1065,9 @@ void MyListCardManager::onAnimeUpdated(int aid)
     // Schedule card update
     updateCardAnimeInfo(aid);
     
+    // New relations may merge or split chains
+    refreshRelations(aid);
+    
     // Remove from tracking
     QMutexLocker locker(&m_mutex);
     m_animeNeedingMetadata.remove(aid);
@@ -1124,7 +1093,7 @@ void MyListCardManager::onAnimeUpdated(int aid)
 
 void MyListCardManager::onFetchDataRequested(int aid)
 {
-    LOG(QString("[MyListCardManager] Fetch data requested for anime %1").arg(aid));
+    LOG_DEBUG(QString("[MyListCardManager] Fetch data requested for anime %1").arg(aid));
     
     QMutexLocker locker(&m_mutex);
     
@@ -1146,10 +1115,10 @@ void MyListCardManager::onFetchDataRequested(int aid)
                  "WHERE m.aid = ? AND m.eid > 0 AND (e.eid IS NULL OR e.name IS NULL OR e.name = '' OR e.epno IS NULL OR e.epno = '')");
         q.addBindValue(aid);
         if (q.exec()) {
-            LOG(QString("[MyListCardManager] Checking episodes for aid=%1").arg(aid));
+            LOG_DEBUG(QString("[MyListCardManager] Checking episodes for aid=%1").arg(aid));
             while (q.next()) {
                 int eid = q.value(0).toInt();
-                LOG(QString("[MyListCardManager]   Found episode needing data: eid=%1").arg(eid));
+                LOG_DEBUG(QString("[MyListCardManager]   Found episode needing data: eid=%1").arg(eid));
                 if (eid > 0) {
                     hasEpisodesNeedingData = true;
                     episodesNeedingData.insert(eid);
@@ -1160,7 +1129,7 @@ void MyListCardManager::onFetchDataRequested(int aid)
         }
     }
     
-    LOG(QString("[MyListCardManager] Data check for aid=%1: needsMetadata=%2, needsPoster=%3, hasEpisodesNeedingData=%4 (count=%5), alreadyRequested=%6")
+    LOG_DEBUG(QString("[MyListCardManager] Data check for aid=%1: needsMetadata=%2, needsPoster=%3, hasEpisodesNeedingData=%4 (count=%5), alreadyRequested=%6")
         .arg(aid).arg(needsMetadata).arg(needsPoster).arg(hasEpisodesNeedingData).arg(episodesNeedingData.size()).arg(m_animeMetadataRequested.contains(aid)));
     
     bool requestedAnything = false;
@@ -1184,7 +1153,7 @@ void MyListCardManager::onFetchDataRequested(int aid)
             requestAnimeMetadata(aid, "fetch-data-request: metadata missing");
         }
         if (needsPoster) {
-            downloadPoster(aid, picname);
+            downloadPoster(aid, picname, true);
         }
     } else {
         locker.unlock();
@@ -1197,7 +1166,7 @@ void MyListCardManager::onFetchDataRequested(int aid)
     if (hasEpisodesNeedingData) {
         LOG(QString("[MyListCardManager] Requesting episode data for %1 episodes of aid=%2").arg(episodesNeedingData.size()).arg(aid));
         for (int eid : episodesNeedingData) {
-            LOG(QString("[MyListCardManager] Emitting episodeDataRequested signal for eid=%1").arg(eid));
+            LOG_DEBUG(QString("[MyListCardManager] Emitting episodeDataRequested signal for eid=%1").arg(eid));
             emit episodeDataRequested(eid);
         }
         requestedAnything = true;
@@ -1208,76 +1177,66 @@ void MyListCardManager::onFetchDataRequested(int aid)
     }
 }
 
-void MyListCardManager::onPosterDownloadFinished(QNetworkReply *reply)
+void MyListCardManager::onPosterDownloaded(int aid, const QString &picname, const QByteArray &imageData)
 {
-    // Get the anime ID for this download
-    QMutexLocker locker(&m_mutex);
+    if (imageData.isEmpty()) {
+        LOG(QString("[MyListCardManager] Empty poster data for aid=%1").arg(aid));
+        return;
+    }
     
-    if (!m_posterDownloadRequests.contains(reply)) {
-        reply->deleteLater();
+    // Only keep data that decodes; the thumbnail is made from it later
+    QImage poster;
+    if (!poster.loadFromData(imageData)) {
+        LOG(QString("[MyListCardManager] Failed to load poster image for aid=%1 (%2)").arg(aid).arg(picname));
         return;
     }
     
-    int aid = m_posterDownloadRequests.take(reply);
-    AnimeCard *card = m_cards.value(aid, nullptr);
+    // Store in database for future use, also when the card was evicted meanwhile
+    QSqlDatabase db = QSqlDatabase::database();
+    if (db.isOpen()) {
+        QSqlQuery q(db);
+        q.prepare("UPDATE anime SET poster_image = ? WHERE aid = ?");
+        q.addBindValue(imageData);
+        q.addBindValue(aid);
+        if (!q.exec()) {
+            LOG(QString("[MyListCardManager] Failed to store poster for aid=%1: %2")
+                .arg(aid).arg(q.lastError().text()));
+        }
+    }
     
-    locker.unlock();
+    // Thumbnails of a previous poster are out of date
+    m_posterCache->invalidate(aid);
     
-    if (!card) {
-        LOG(QString("[MyListCardManager] Card not found for poster download aid=%1").arg(aid));
-        reply->deleteLater();
-        return;
+    QMutexLocker locker(&m_mutex);
+    auto cacheIt = m_cardCreationDataCache.find(aid);
+    if (cacheIt != m_cardCreationDataCache.end()) {
+        cacheIt->hasPosterImage = true;
     }
+    AnimeCard *card = m_cards.value(aid, nullptr);
+    locker.unlock();
     
-    if (reply->error() != QNetworkReply::NoError) {
-        LOG(QString("[MyListCardManager] Poster download error for aid=%1: %2")
-            .arg(aid).arg(reply->errorString()));
-        reply->deleteLater();
-        return;
+    if (card) {
+        requestPosterThumbnail(aid, AnimeCard::getPosterSize(), card->devicePixelRatioF(), true);
     }
+    onPosterNotModified(aid);
     
-    QByteArray imageData = reply->readAll();
-    reply->deleteLater();
+    emit cardUpdated(aid);
+    LOG(QString("[MyListCardManager] Updated poster for aid=%1").arg(aid));
+}
+
+void MyListCardManager::onPosterNotModified(int aid)
+{
+    // The stored poster is current
+    QMutexLocker locker(&m_mutex);
+    m_animeNeedingPoster.remove(aid);
     
-    if (imageData.isEmpty()) {
-        LOG(QString("[MyListCardManager] Empty poster data for aid=%1").arg(aid));
-        return;
-    }
+    // Hide warning if metadata is also no longer needed
+    bool stillNeedsData = m_animeNeedingMetadata.contains(aid);
+    AnimeCard *card = m_cards.value(aid, nullptr);
+    locker.unlock();
     
-    // Load and set poster
-    QPixmap poster;
-    if (poster.loadFromData(imageData)) {
-        card->setPoster(poster);
-        
-        // Remove from tracking
-        QMutexLocker locker(&m_mutex);
-        m_animeNeedingPoster.remove(aid);
-        
-        // Hide warning if metadata is also no longer needed
-        bool stillNeedsData = m_animeNeedingMetadata.contains(aid);
-        locker.unlock();
-        
-        if (!stillNeedsData) {
-            card->setNeedsFetch(false);
-        }
-        
-        // Store in database for future use
-        QSqlDatabase db = QSqlDatabase::database();
-        if (db.isOpen()) {
-            QSqlQuery q(db);
-            q.prepare("UPDATE anime SET poster_image = ? WHERE aid = ?");
-            q.addBindValue(imageData);
-            q.addBindValue(aid);
-            if (!q.exec()) {
-                LOG(QString("[MyListCardManager] Failed to store poster for aid=%1: %2")
-                    .arg(aid).arg(q.lastError().text()));
-            }
-        }
-        
-        emit cardUpdated(aid);
-        LOG(QString("[MyListCardManager] Updated poster for aid=%1").arg(aid));
-    } else {
-        LOG(QString("[MyListCardManager] Failed to load poster image for aid=%1").arg(aid));
+    if (card && !stillNeedsData) {
+        card->setNeedsFetch(false);
     }
 }
 
@@ -1336,72 +1295,195 @@ QString MyListCardManager::determineAnimeName(const QString& nameRomaji, const Q
     return AnimeUtils::determineAnimeName(nameRomaji, nameEnglish, animeTitle, aid);
 }
 
-QList<AnimeCard::TagInfo> MyListCardManager::getTagsOrCategoryFallback(const QString& tagNames, const QString& tagIds, const QString& tagWeights, const QString& category)
+QList<AnimeCard::TagInfo> MyListCardManager::getTagsOrCategoryFallback(const QString& tagNames, const QString& tagIds, const QString& tagWeights, const QString& category)
+{
+    QList<AnimeCard::TagInfo> tags = parseTags(tagNames, tagIds, tagWeights);
+    
+    if (!tags.isEmpty()) {
+        return tags;
+    }
+    
+    // Fallback to category if no tag data
+    if (category.isEmpty()) {
+        return tags;  // Empty list
+    }
+    
+    QList<AnimeCard::TagInfo> categoryTags;
+    QStringList categoryNames = category.split(',');
+    int weight = 1000;  // Arbitrary high weight for category fallback
+    
+    for (const QString& catName : std::as_const(categoryNames)) {
+        AnimeCard::TagInfo tag(catName.trimmed(), 0, weight--);
+        categoryTags.append(tag);
+    }
+    
+    return categoryTags;
+}
+
+void MyListCardManager::updateCardAiredDates(AnimeCard* card, const QString& startDate, const QString& endDate)
+{
+    if (!startDate.isEmpty()) {
+        aired airedDates(startDate, endDate);
+        card->setAired(airedDates);
+    } else {
+        card->setAiredText("Unknown");
+        
+        // Track that this anime needs metadata if we have access to aid
+        int aid = card->getAnimeId();
+        if (aid > 0) {
+            QMutexLocker locker(&m_mutex);
+            m_animeNeedingMetadata.insert(aid);
+        }
+    }
+}
+
+AnimeCard* MyListCardManager::createCard(int aid)
+{
+    // Check if card already exists - prevent duplicates
+    bool hasData = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cardCache.touch(aid);
+        AnimeCard *existing = m_cards.value(aid, nullptr);
+        if (existing) {
+            return existing;
+        }
+        hasData = m_cardCreationDataCache.contains(aid);
+    }
+    
+    // Once the card pool is full, an off-screen card is rebound instead of constructing a widget
+    AnimeCard *card = takeRecyclableCard();
+    const bool isNewCard = (card == nullptr);
+    if (isNewCard) {
+        card = new AnimeCard(nullptr);
+    }
+    
+    // Get data from comprehensive cache - NO SQL QUERIES HERE. Without preloaded data
+    // the card is a skeleton until preloadCardCreationData() delivers it (fillLoadingCards)
+    if (hasData) {
+        bindCard(card, aid);
+    } else {
+        card->showLoadingPlaceholder(aid);
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_cards[aid] = card;
+    m_cardCache.insert(aid, card->estimatedMemoryBytes());
+    if (!hasData) {
+        m_loadingCardAids.insert(aid);
+    }
+    
+    // Add to layout only if not using virtual scrolling
+    // In virtual scrolling mode, the VirtualFlowLayout handles widget positioning
+    if (isNewCard && m_layout && !m_virtualLayout) {
+        m_layout->addWidget(card);
+    }
+    locker.unlock();
+    
+    if (isNewCard) {
+        connectCardSignals(card);
+        emit cardCreated(aid, card);
+    }
+    if (hasData) {
+        emit cardBound(aid, card);
+    }
+    
+    scheduleCardEviction();
+    
+    return card;
+}
+
+void MyListCardManager::connectCardSignals(AnimeCard *card)
+{
+    // Connect fetch data request signal from card
+    connect(card, &AnimeCard::fetchDataRequested, this, &MyListCardManager::onFetchDataRequested);
+    
+    // Connect hide card request signal
+    connect(card, &AnimeCard::hideCardRequested, this, &MyListCardManager::onHideCardRequested);
+    
+    // Connect mark episode watched signal
+    connect(card, &AnimeCard::markEpisodeWatchedRequested, this, &MyListCardManager::onMarkEpisodeWatchedRequested);
+    
+    // Connect mark file watched signal
+    connect(card, &AnimeCard::markFileWatchedRequested, this, &MyListCardManager::onMarkFileWatchedRequested);
+    
+    // Connect lock/unlock signals (relay to Window/DeletionLockManager)
+    connect(card, &AnimeCard::lockAnimeRequested, this, &MyListCardManager::lockAnimeRequested);
+    connect(card, &AnimeCard::unlockAnimeRequested, this, &MyListCardManager::unlockAnimeRequested);
+    connect(card, &AnimeCard::lockEpisodeRequested, this, &MyListCardManager::lockEpisodeRequested);
+    connect(card, &AnimeCard::unlockEpisodeRequested, this, &MyListCardManager::unlockEpisodeRequested);
+}
+
+AnimeCard* MyListCardManager::takeRecyclableCard()
 {
-    QList<AnimeCard::TagInfo> tags = parseTags(tagNames, tagIds, tagWeights);
+    QMutexLocker locker(&m_mutex);
     
-    if (!tags.isEmpty()) {
-        return tags;
+    // Only virtual scrolling positions cards by index; a FlowLayout keeps one card per anime
+    if (!m_virtualLayout) {
+        return nullptr;
     }
     
-    // Fallback to category if no tag data
-    if (category.isEmpty()) {
-        return tags;  // Empty list
+    // Pool: the viewport plus buffer rows, bounded by the card cache budget
+    int poolSize = m_virtualLayout->visibleCapacity();
+    if (m_cardCache.maxCards() > 0) {
+        poolSize = qMin(poolSize, m_cardCache.maxCards());
+    }
+    if (poolSize <= 0 || m_cardCache.size() < poolSize) {
+        return nullptr;
     }
     
-    QList<AnimeCard::TagInfo> categoryTags;
-    QStringList categoryNames = category.split(',');
-    int weight = 1000;  // Arbitrary high weight for category fallback
+    const int oldAid = m_cardCache.takeForRebind(visibleCardAids());
+    if (oldAid < 0) {
+        // Every pooled card is on screen - the viewport grew
+        return nullptr;
+    }
+    m_loadingCardAids.remove(oldAid);
+    if (!m_standaloneCards.contains(oldAid)) {
+        m_posterCache->cancel(oldAid);
+    }
+    m_posterDownloader->cancel(oldAid);
+    return m_cards.take(oldAid);
+}
+
+bool MyListCardManager::rebindCard(int aid)
+{
+    QMutexLocker locker(&m_mutex);
+    AnimeCard *card = m_cards.value(aid, nullptr);
+    locker.unlock();
     
-    for (const QString& catName : std::as_const(categoryNames)) {
-        AnimeCard::TagInfo tag(catName.trimmed(), 0, weight--);
-        categoryTags.append(tag);
+    if (!card || !m_cardCreationDataCache.contains(aid)) {
+        return false;
     }
     
-    return categoryTags;
+    bindCard(card, aid);
+    
+    locker.relock();
+    m_cardCache.updateSize(aid, card->estimatedMemoryBytes());
+    m_loadingCardAids.remove(aid);
+    locker.unlock();
+    
+    emit cardBound(aid, card);
+    return true;
 }
 
-void MyListCardManager::updateCardAiredDates(AnimeCard* card, const QString& startDate, const QString& endDate)
+QSet<int> MyListCardManager::visibleCardAids() const
 {
-    if (!startDate.isEmpty()) {
-        aired airedDates(startDate, endDate);
-        card->setAired(airedDates);
-    } else {
-        card->setAiredText("Unknown");
-        
-        // Track that this anime needs metadata if we have access to aid
-        int aid = card->getAnimeId();
-        if (aid > 0) {
-            QMutexLocker locker(&m_mutex);
-            m_animeNeedingMetadata.insert(aid);
+    QSet<int> aids;
+    if (!m_virtualLayout) {
+        return aids;
+    }
+    const QMap<int, QWidget*>& visibleWidgets = m_virtualLayout->getVisibleWidgets();
+    for (QWidget *widget : visibleWidgets) {
+        AnimeCard *card = qobject_cast<AnimeCard*>(widget);
+        if (card) {
+            aids.insert(card->getAnimeId());
         }
     }
+    return aids;
 }
 
-AnimeCard* MyListCardManager::createCard(int aid)
+void MyListCardManager::bindCard(AnimeCard *card, int aid)
 {
-    // Wait for ALL data to be ready before creating cards
-    {
-        QMutexLocker locker(&m_mutex);
-        LOG(QString("[MyListCardManager] createCard: aid=%1 m_dataReady=%2 chainsBuilt=%3 chainBuildInProgress=%4")
-            .arg(aid).arg(m_dataReady).arg(m_chainsBuilt).arg(m_chainBuildInProgress));
-        while (!m_dataReady) {
-            LOG("[MyListCardManager] createCard: Waiting for data to be ready...");
-            m_dataReadyCondition.wait(&m_mutex);
-        }
-    }
-    
-    // Check if card already exists - prevent duplicates
-    if (hasCard(aid)) {
-        return m_cards[aid];
-    }
-    
-    // Get data from comprehensive cache - NO SQL QUERIES HERE
-    if (!m_cardCreationDataCache.contains(aid)) {
-        LOG(QString("[MyListCardManager] ERROR: No card creation data for aid=%1 - data must be preloaded first!").arg(aid));
-        return nullptr;
-    }
-    
     const CardCreationData& data = m_cardCreationDataCache[aid];
     
     // Determine anime name
@@ -1410,8 +1492,11 @@ AnimeCard* MyListCardManager::createCard(int aid)
         animeName = QString("Anime %1").arg(aid);
     }
     
-    // Create card
-    AnimeCard *card = new AnimeCard(nullptr);
+    // A recycled card still shows its previous anime
+    if (card->getAnimeId() != 0) {
+        card->resetContent();
+    }
+    
     card->setAnimeId(aid);
     card->setAnimeTitle(animeName);
     card->setHidden(data.isHidden);
@@ -1439,16 +1524,11 @@ AnimeCard* MyListCardManager::createCard(int aid)
         card->setRating(data.rating);
     }
     
-    // Load poster asynchronously
-    if (!data.posterData.isEmpty()) {
-        // Defer poster loading to avoid blocking
-        QByteArray posterDataCopy = data.posterData; // Copy for lambda capture
-        QMetaObject::invokeMethod(this, [card, posterDataCopy]() {
-            QPixmap poster;
-            if (poster.loadFromData(posterDataCopy)) {
-                card->setPoster(poster);
-            }
-        }, Qt::QueuedConnection);
+    // Load poster asynchronously: decoded and scaled on the poster workers, set in
+    // onPosterThumbnailReady() if the card still shows this anime then.
+    // With virtual scrolling the cards bound last are the ones on screen, so they go first
+    if (data.hasPosterImage) {
+        requestPosterThumbnail(aid, AnimeCard::getPosterSize(), card->devicePixelRatioF(), m_virtualLayout != nullptr);
     } else if (!data.picname.isEmpty()) {
         m_animePicnames[aid] = data.picname;
         m_animeNeedingPoster.insert(aid);
@@ -1487,42 +1567,10 @@ AnimeCard* MyListCardManager::createCard(int aid)
         }
     }
     
-    // Add to cache (mutex already locked above)
-    m_cards[aid] = card;
-    
-    // Add to layout only if not using virtual scrolling
-    // In virtual scrolling mode, the VirtualFlowLayout handles widget positioning
-    if (m_layout && !m_virtualLayout) {
-        m_layout->addWidget(card);
-    }
-    locker.unlock();
-    
-    // Connect fetch data request signal from card
-    connect(card, &AnimeCard::fetchDataRequested, this, &MyListCardManager::onFetchDataRequested);
-    
-    // Connect hide card request signal
-    connect(card, &AnimeCard::hideCardRequested, this, &MyListCardManager::onHideCardRequested);
-    
-    // Connect mark episode watched signal
-    connect(card, &AnimeCard::markEpisodeWatchedRequested, this, &MyListCardManager::onMarkEpisodeWatchedRequested);
-    
-    // Connect mark file watched signal
-    connect(card, &AnimeCard::markFileWatchedRequested, this, &MyListCardManager::onMarkFileWatchedRequested);
-    
-    // Connect lock/unlock signals (relay to Window/DeletionLockManager)
-    connect(card, &AnimeCard::lockAnimeRequested, this, &MyListCardManager::lockAnimeRequested);
-    connect(card, &AnimeCard::unlockAnimeRequested, this, &MyListCardManager::unlockAnimeRequested);
-    connect(card, &AnimeCard::lockEpisodeRequested, this, &MyListCardManager::lockEpisodeRequested);
-    connect(card, &AnimeCard::unlockEpisodeRequested, this, &MyListCardManager::unlockEpisodeRequested);
-    
     // Show warning indicator if metadata or poster is missing (instead of auto-fetching)
     if (m_animeNeedingMetadata.contains(aid) || m_animeNeedingPoster.contains(aid)) {
         card->setNeedsFetch(true);
     }
-    
-    emit cardCreated(aid, card);
-    
-    return card;
 }
 
 AnimeCard* MyListCardManager::createStandaloneCard(int aid, QWidget *parent)
@@ -1556,10 +1604,13 @@ AnimeCard* MyListCardManager::createStandaloneCard(int aid, QWidget *parent)
     if (!data.rating.isEmpty())
         card->setRating(data.rating);
 
-    if (!data.posterData.isEmpty()) {
-        QPixmap poster;
-        if (poster.loadFromData(data.posterData))
-            card->setPoster(poster);
+    // The poster is set in onPosterThumbnailReady() while the card is alive
+    if (data.hasPosterImage) {
+        m_standaloneCards.insert(aid, card);
+        connect(card, &QObject::destroyed, this, [this, aid, card]() {
+            m_standaloneCards.remove(aid, card);
+        });
+        requestPosterThumbnail(aid, AnimeCard::getPosterSize(), card->devicePixelRatioF(), true);
     }
 
     if (!data.episodes.isEmpty())
@@ -1572,6 +1623,88 @@ AnimeCard* MyListCardManager::createStandaloneCard(int aid, QWidget *parent)
     return card;
 }
 
+MyListCardManager::CardDisplayData MyListCardManager::getCardDisplayData(int aid)
+{
+    CardDisplayData display;
+    auto it = m_cardCreationDataCache.find(aid);
+    if (it == m_cardCreationDataCache.end()) {
+        return display;
+    }
+    
+    const CardCreationData &data = *it;
+    display.valid = true;
+    display.title = determineAnimeName(data.nameRomaji, data.nameEnglish, data.animeTitle, aid);
+    if (display.title.isEmpty()) {
+        display.title = QString("Anime %1").arg(aid);
+    }
+    display.typeName = data.typeName.isEmpty() ? QString("Unknown") : data.typeName;
+    display.airedText = data.startDate.isEmpty() ? QString("Unknown")
+                                                 : aired(data.startDate, data.endDate).toDisplayString();
+    display.rating = data.rating;
+    
+    const QList<AnimeCard::TagInfo> tags = getTagsOrCategoryFallback(
+        data.tagNameList, data.tagIdList, data.tagWeightList, data.category);
+    for (const AnimeCard::TagInfo &tag : tags) {
+        display.tagNames.append(tag.name());
+    }
+    
+    int totalNormal = data.eptotal > 0 ? data.eptotal : data.stats.normalEpisodes();
+    display.statistics = AnimeCard::formatStatistics(data.stats.normalEpisodes(), totalNormal,
+                                                     data.stats.normalViewed(), data.stats.otherEpisodes(),
+                                                     data.stats.otherViewed());
+    display.hasUnwatchedEpisodes = data.stats.normalViewed() < data.stats.normalEpisodes()
+                                || data.stats.otherViewed() < data.stats.otherEpisodes();
+    display.isHidden = data.isHidden;
+    display.hasPoster = data.hasPosterImage;
+    return display;
+}
+
+void MyListCardManager::requestPosterThumbnail(int aid, const QSize &size, qreal devicePixelRatio, bool onScreen)
+{
+    // The database is opened after the manager is constructed
+    if (m_posterCache->databaseName().isEmpty()) {
+        m_posterCache->setDatabaseName(QSqlDatabase::database().databaseName());
+        m_posterCache->setDirectory(PosterCache::defaultDirectory());
+    }
+    m_posterCache->request(aid, size, devicePixelRatio, onScreen);
+}
+
+void MyListCardManager::onPosterThumbnailReady(int aid, const QImage &thumbnail)
+{
+    if (thumbnail.isNull()) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    AnimeCard *card = m_cards.value(aid, nullptr);
+    locker.unlock();
+    
+    if (card && card->getAnimeId() == aid) {
+        card->setPosterThumbnail(QPixmap::fromImage(thumbnail));
+        locker.relock();
+        m_cardCache.updateSize(aid, card->estimatedMemoryBytes());
+        locker.unlock();
+    }
+    const QList<AnimeCard*> standaloneCards = m_standaloneCards.values(aid);
+    for (AnimeCard *standaloneCard : standaloneCards) {
+        standaloneCard->setPosterThumbnail(QPixmap::fromImage(thumbnail));
+    }
+    emit posterThumbnailReady(aid, thumbnail);
+}
+
+AnimeCard* MyListCardManager::createInteractiveCard(int aid, QWidget *parent)
+{
+    AnimeCard *card = createStandaloneCard(aid, parent);
+    if (!card) {
+        return nullptr;
+    }
+    
+    connectCardSignals(card);
+    emit cardCreated(aid, card);
+    emit cardBound(aid, card);
+    return card;
+}
+
 void MyListCardManager::updateCardFromDatabase(int aid)
 {
     QMutexLocker locker(&m_mutex);
@@ -1593,7 +1726,8 @@ void MyListCardManager::updateCardFromDatabase(int aid)
     QSqlQuery q(db);
     q.prepare("SELECT a.nameromaji, a.nameenglish, "
               "at.title as anime_title, "
-              "a.eps, a.typename, a.startdate, a.enddate, a.picname, a.poster_image, a.category, "
+              "a.eps, a.typename, a.startdate, a.enddate, a.picname, "
+              "(a.poster_image IS NOT NULL AND length(a.poster_image) > 0) AS has_poster, a.category, "
               "a.rating, a.tag_name_list, a.tag_id_list, a.tag_weight_list "
               "FROM anime a "
               "LEFT JOIN anime_titles at ON a.aid = at.aid AND at.type = 1 "
@@ -1614,7 +1748,7 @@ void MyListCardManager::updateCardFromDatabase(int aid)
     QString startDate = q.value(5).toString();
     QString endDate = q.value(6).toString();
     QString picname = q.value(7).toString();
-    QByteArray posterData = q.value(8).toByteArray();
+    bool hasPosterImage = q.value(8).toBool();
     QString category = q.value(9).toString();
     QString rating = q.value(10).toString();
     QString tagNameList = q.value(11).toString();
@@ -1649,12 +1783,9 @@ void MyListCardManager::updateCardFromDatabase(int aid)
         card->setRating(rating);
     }
     
-    // Update poster if available
-    if (!posterData.isEmpty()) {
-        QPixmap poster;
-        if (poster.loadFromData(posterData)) {
-            card->setPoster(poster);
-        }
+    // Update poster if available (decoded off the GUI thread, usually a thumbnail file read)
+    if (hasPosterImage) {
+        requestPosterThumbnail(aid, AnimeCard::getPosterSize(), card->devicePixelRatioF(), true);
     } else if (!picname.isEmpty() && !m_animePicnames.contains(aid)) {
         m_animePicnames[aid] = picname;
         downloadPoster(aid, picname);
@@ -1670,6 +1801,25 @@ void MyListCardManager::updateCardFromDatabase(int aid)
     card->setStatistics(stats.normalEpisodes(), totalNormalEpisodes,
                        stats.normalViewed(), stats.otherEpisodes(), stats.otherViewed());
     
+    // Keep the cached data (and the sort/filter indexes built from it) in step with the card
+    {
+        QMutexLocker cacheLocker(&m_mutex);
+        auto cacheIt = m_cardCreationDataCache.find(aid);
+        if (cacheIt != m_cardCreationDataCache.end()) {
+            cacheIt->nameRomaji = q.value(0).toString();
+            cacheIt->nameEnglish = animeNameEnglish;
+            cacheIt->animeTitle = animeTitle;
+            cacheIt->eptotal = eps;
+            cacheIt->typeName = typeName;
+            cacheIt->startDate = startDate;
+            cacheIt->endDate = endDate;
+            cacheIt->rating = rating;
+            cacheIt->hasPosterImage = hasPosterImage;
+            cacheIt->stats = stats;
+            updateMetadataStore(QList<int>{aid});
+        }
+    }
+    
     emit cardUpdated(aid);
     emit cardNeedsSorting(aid);
 }
@@ -1821,9 +1971,8 @@ void MyListCardManager::loadEpisodesForCardFromCache(AnimeCard *card, int /*aid*
         return false;
     });
     
-    for (const AnimeCard::EpisodeInfo& episodeInfo : std::as_const(episodeList)) {
-        card->addEpisode(episodeInfo);
-    }
+    // Rows are built when the card's episode tree is first used
+    card->setEpisodes(episodeList);
 }
 
 void MyListCardManager::requestAnimeMetadata(int aid, const QString& reason)
@@ -1847,7 +1996,7 @@ void MyListCardManager::requestAnimeMetadata(int aid, const QString& reason)
     
     {
         QMutexLocker locker(&m_mutex);
-        LOG(QString("[MyListCardManager] requestAnimeMetadata[%1] state before local dedupe: aid=%2, requestedContains=%3, requestedSize=%4")
+        LOG_DEBUG(QString("[MyListCardManager] requestAnimeMetadata[%1] state before local dedupe: aid=%2, requestedContains=%3, requestedSize=%4")
             .arg(requestSeq)
             .arg(aid)
             .arg(m_animeMetadataRequested.contains(aid) ? "true" : "false")
@@ -1865,7 +2014,7 @@ void MyListCardManager::requestAnimeMetadata(int aid, const QString& reason)
     
     {
         QMutexLocker globalLocker(&s_metadataDispatchMutex);
-        LOG(QString("[MyListCardManager] requestAnimeMetadata[%1] state before global dedupe: aid=%2, inFlightContains=%3, inFlightSize=%4")
+        LOG_DEBUG(QString("[MyListCardManager] requestAnimeMetadata[%1] state before global dedupe: aid=%2, inFlightContains=%3, inFlightSize=%4")
             .arg(requestSeq)
             .arg(aid)
             .arg(s_metadataDispatchInFlight.contains(aid) ? "true" : "false")
@@ -1896,24 +2045,28 @@ void MyListCardManager::requestAnimeMetadata(int aid, const QString& reason)
     }
 }
 
-void MyListCardManager::downloadPoster(int aid, const QString &picname)
+void MyListCardManager::downloadPoster(int aid, const QString &picname, bool userRequested)
 {
     if (picname.isEmpty()) {
         return;
     }
     
-    // AniDB CDN URL for anime posters
-    QString url = QString("http://img7.anidb.net/pics/anime/%1").arg(picname);
-    
-    LOG(QString("[MyListCardManager] Downloading poster for anime %1 from %2").arg(aid).arg(url));
-    
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::UserAgentHeader, "Usagi/1");
+    QMutexLocker locker(&m_mutex);
+    PosterDownloader::Priority priority = PosterDownloader::Background;
+    if (userRequested || visibleCardAids().contains(aid)) {
+        priority = PosterDownloader::Visible;
+    } else if (m_cards.contains(aid)) {
+        priority = PosterDownloader::Nearby;
+    }
     
-    QNetworkReply *reply = m_networkManager->get(request);
+    // A stored poster is only revalidated (304 if the server still has the same one)
+    auto cacheIt = m_cardCreationDataCache.constFind(aid);
+    const bool conditional = cacheIt != m_cardCreationDataCache.constEnd() && cacheIt->hasPosterImage;
+    locker.unlock();
     
-    QMutexLocker locker(&m_mutex);
-    m_posterDownloadRequests[reply] = aid;
+    LOG(QString("[MyListCardManager] Queueing poster download for anime %1 (%2, priority %3%4)")
+        .arg(aid).arg(picname).arg(priority).arg(conditional ? ", conditional" : ""));
+    m_posterDownloader->request(aid, picname, priority, conditional);
 }
 
 MyListCardManager::AnimeStats MyListCardManager::calculateStatistics(int aid)
@@ -2036,7 +2189,8 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
     qint64 step1Start = timer.elapsed();
     QString animeQuery = QString("SELECT a.aid, a.nameromaji, a.nameenglish, a.eptotal, "
                                 "at.title as anime_title, "
-                                "a.typename, a.startdate, a.enddate, a.picname, a.poster_image, a.category, "
+                                "a.typename, a.startdate, a.enddate, a.picname, "
+                                "(a.poster_image IS NOT NULL AND length(a.poster_image) > 0) AS has_poster, a.category, "
                                 "a.rating, a.tag_name_list, a.tag_id_list, a.tag_weight_list, a.hidden, a.is_18_restricted, "
                                 "a.relaidlist, a.relaidtype "
                                 "FROM anime a "
@@ -2057,7 +2211,7 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
             data.startDate = q.value(6).toString();
             data.endDate = q.value(7).toString();
             data.picname = q.value(8).toString();
-            data.posterData = q.value(9).toByteArray();
+            data.hasPosterImage = q.value(9).toBool();
             data.category = q.value(10).toString();
             data.rating = q.value(11).toString();
             data.tagNameList = q.value(12).toString();
@@ -2100,6 +2254,16 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
     qint64 step2Elapsed = timer.elapsed() - step2Start;
     LOG(QString("[MyListCardManager] Step 2: Loaded anime titles in %1 ms").arg(step2Elapsed));
     
+    // Reset aggregated data for the requested anime before steps 3 and 4 append to it,
+    // so re-preloading an already cached anime (e.g. snapshot deltas) doesn't duplicate episodes
+    for (int aid : aids) {
+        auto it = m_cardCreationDataCache.find(aid);
+        if (it != m_cardCreationDataCache.end()) {
+            it->stats.reset();
+            it->episodes.clear();
+        }
+    }
+    
     // Step 3: Load statistics
     qint64 step3Start = timer.elapsed();
     QString statsQuery = QString("SELECT m.aid, e.epno, m.viewed, m.eid "
@@ -2221,8 +2385,14 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
         }
     }
     qint64 step4Elapsed = timer.elapsed() - step4Start;
+    // Only the anime of this call; chunked loads would otherwise revisit the whole cache each time
     int totalEpisodes = 0;
-    for (CardCreationData& data : m_cardCreationDataCache) {
+    for (int aid : aids) {
+        auto dataIt = m_cardCreationDataCache.find(aid);
+        if (dataIt == m_cardCreationDataCache.end()) {
+            continue;
+        }
+        CardCreationData& data = dataIt.value();
         totalEpisodes += data.episodes.size();
         
         // Calculate lastPlayed as the maximum timestamp from all episodes
@@ -2260,6 +2430,11 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
     LOG(QString("[MyListCardManager] Step 4: Loaded %1 episodes in %2 ms").arg(totalEpisodes).arg(step4Elapsed));
     emit progressUpdate(QString("Loaded episodes (%1 of 3)...").arg(3));
     
+    {
+        QMutexLocker locker(&m_mutex);
+        updateMetadataStore(aids);
+    }
+    
     qint64 totalElapsed = timer.elapsed();
     LOG(QString("[MyListCardManager] Comprehensive preload complete: %1 anime with full data in %2 ms")
         .arg(m_cardCreationDataCache.size()).arg(totalElapsed));
@@ -2272,7 +2447,7 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
     // SPECIAL CASE: Handle FINAL PRELOAD scenario to prevent deadlock
     // When chains are already built (m_chainsBuilt=true) but data not ready (m_dataReady=false),
     // it means we're in FINAL PRELOAD loading missing anime after chains were already built.
-    // In this case, mark data ready without rebuilding chains to prevent createCardForIndex() deadlock.
+    // In this case, mark data ready without rebuilding chains so setAnimeIdList() uses them again.
     {
         QMutexLocker locker(&m_mutex);
         if (m_chainsBuilt && !m_dataReady) {
@@ -2285,6 +2460,53 @@ void MyListCardManager::preloadCardCreationData(const QList<int>& aids)
                 .arg(m_chainsBuilt).arg(m_chainBuildInProgress));
         }
     }
+    
+    // Skeleton cards of the anime just loaded get their content
+    fillLoadingCards(aids);
+}
+
+void MyListCardManager::fillLoadingCards(const QList<int>& aids)
+{
+    QList<int> loadedAids;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_loadingCardAids.isEmpty()) {
+            return;
+        }
+        for (int aid : aids) {
+            if (m_loadingCardAids.contains(aid) && m_cardCreationDataCache.contains(aid)) {
+                loadedAids.append(aid);
+            }
+        }
+    }
+    
+    int filled = 0;
+    for (int aid : std::as_const(loadedAids)) {
+        if (rebindCard(aid)) {
+            ++filled;
+        }
+    }
+    if (filled == 0) {
+        return;
+    }
+    
+    // Hidden anime have a compact card; the layout has to place the cards again
+    if (m_virtualLayout) {
+        m_virtualLayout->refresh();
+    }
+    LOG(QString("[MyListCardManager] Filled %1 skeleton cards").arg(filled));
+}
+
+QList<int> MyListCardManager::getLoadingCardAnimeIds() const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<int> aids;
+    for (int aid : m_orderedAnimeIds) {
+        if (m_loadingCardAids.contains(aid)) {
+            aids.append(aid);
+        }
+    }
+    return aids;
 }
 
 void MyListCardManager::preloadRelationDataForChainExpansion(const QList<int>& baseAids)
@@ -2346,7 +2568,8 @@ void MyListCardManager::preloadRelationDataForChainExpansion(const QList<int>& b
     
     QString query = QString("SELECT a.aid, a.nameromaji, a.nameenglish, a.eptotal, "
                             "at.title as anime_title, "
-                            "a.typename, a.startdate, a.enddate, a.picname, a.poster_image, a.category, "
+                            "a.typename, a.startdate, a.enddate, a.picname, "
+                            "(a.poster_image IS NOT NULL AND length(a.poster_image) > 0) AS has_poster, a.category, "
                             "a.rating, a.tag_name_list, a.tag_id_list, a.tag_weight_list, a.hidden, a.is_18_restricted, "
                             "a.relaidlist, a.relaidtype "
                             "FROM anime a "
@@ -2369,7 +2592,7 @@ void MyListCardManager::preloadRelationDataForChainExpansion(const QList<int>& b
             data.startDate = q.value(6).toString();
             data.endDate = q.value(7).toString();
             data.picname = q.value(8).toString();
-            data.posterData = q.value(9).toByteArray();
+            data.hasPosterImage = q.value(9).toBool();
             data.category = q.value(10).toString();
             data.rating = q.value(11).toString();
             data.tagNameList = q.value(12).toString();
@@ -2380,6 +2603,7 @@ void MyListCardManager::preloadRelationDataForChainExpansion(const QList<int>& b
             data.setRelations(q.value(17).toString(), q.value(18).toString());
             data.hasData = true;
         }
+        updateMetadataStore(QList<int>(loadedAids.cbegin(), loadedAids.cend()));
     }
     
     QList<int> missingAids;
@@ -2530,21 +2754,241 @@ void MyListCardManager::buildChainsFromCache()
     m_dataReadyCondition.wakeAll();
 }
 
+bool MyListCardManager::isSnapshotable() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dataReady && m_chainsBuilt && !m_chainBuildInProgress && !m_cardCreationDataCache.isEmpty();
+}
+
+bool MyListCardManager::writeSnapshot(QDataStream& out, const QSet<int>& keepAids) const
+{
+    QMutexLocker locker(&m_mutex);
+    
+    qint32 animeCount = 0;
+    for (auto it = m_cardCreationDataCache.constBegin(); it != m_cardCreationDataCache.constEnd(); ++it) {
+        if (keepAids.contains(it.key())) {
+            ++animeCount;
+        }
+    }
+    
+    out << qint32(SNAPSHOT_VERSION);
+    out << animeCount;
+    for (auto it = m_cardCreationDataCache.constBegin(); it != m_cardCreationDataCache.constEnd(); ++it) {
+        if (!keepAids.contains(it.key())) {
+            continue;
+        }
+        const CardCreationData& data = it.value();
+        out << qint32(it.key())
+            << data.nameRomaji << data.nameEnglish << data.animeTitle << data.typeName
+            << data.startDate << data.endDate << data.picname << data.category << data.rating
+            << data.tagNameList << data.tagIdList << data.tagWeightList
+            << data.isHidden << data.is18Restricted << qint32(data.eptotal)
+            << data.lastPlayed << data.recentEpisodeAirDate
+            << data.hasPosterImage
+            << data.hasData
+            << data.getRelationAidList() << data.getRelationTypeList()
+            << qint32(data.stats.normalEpisodes()) << qint32(data.stats.totalNormalEpisodes())
+            << qint32(data.stats.normalViewed()) << qint32(data.stats.otherEpisodes())
+            << qint32(data.stats.otherViewed());
+        
+        out << qint32(data.episodes.size());
+        for (const EpisodeCacheEntry& entry : data.episodes) {
+            out << qint32(entry.lid) << qint32(entry.eid) << qint32(entry.fid)
+                << qint32(entry.state) << qint32(entry.fileState) << qint32(entry.viewed)
+                << entry.storage << entry.episodeName << entry.epno << entry.filename
+                << entry.lastPlayed << entry.localFilePath << entry.resolution
+                << entry.quality << entry.groupName
+                << qint32(entry.localWatched) << qint32(entry.episodeWatched) << entry.airDate;
+        }
+    }
+    
+    // A dropped anime breaks the prequel/sequel line it was part of
+    QList<QList<int>> chains;
+    for (const AnimeChain& chain : m_chainList) {
+        QList<int> part;
+        for (int aid : chain.getAnimeIds()) {
+            if (keepAids.contains(aid)) {
+                part.append(aid);
+            } else if (!part.isEmpty()) {
+                chains.append(part);
+                part.clear();
+            }
+        }
+        if (!part.isEmpty()) {
+            chains.append(part);
+        }
+    }
+    out << qint32(chains.size());
+    for (const QList<int>& chain : std::as_const(chains)) {
+        out << chain;
+    }
+    
+    return out.status() == QDataStream::Ok;
+}
+
+bool MyListCardManager::readSnapshot(QDataStream& in)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    qint32 version = 0;
+    in >> version;
+    if (version != SNAPSHOT_VERSION) {
+        LOG(QString("[MyListCardManager] Snapshot version %1 not supported (expected %2)").arg(version).arg(SNAPSHOT_VERSION));
+        return false;
+    }
+    
+    // Deserialize into locals first so a truncated or corrupt payload leaves the manager untouched
+    QMap<int, CardCreationData> cache;
+    qint32 animeCount = 0;
+    in >> animeCount;
+    for (qint32 i = 0; i < animeCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 aid = 0;
+        qint32 eptotal = 0;
+        QString relationAidList;
+        QString relationTypeList;
+        qint32 normalEpisodes = 0, totalNormalEpisodes = 0, normalViewed = 0, otherEpisodes = 0, otherViewed = 0;
+        
+        in >> aid;
+        CardCreationData& data = cache[aid];
+        in >> data.nameRomaji >> data.nameEnglish >> data.animeTitle >> data.typeName
+           >> data.startDate >> data.endDate >> data.picname >> data.category >> data.rating
+           >> data.tagNameList >> data.tagIdList >> data.tagWeightList
+           >> data.isHidden >> data.is18Restricted >> eptotal
+           >> data.lastPlayed >> data.recentEpisodeAirDate
+           >> data.hasPosterImage >> data.hasData
+           >> relationAidList >> relationTypeList
+           >> normalEpisodes >> totalNormalEpisodes >> normalViewed >> otherEpisodes >> otherViewed;
+        data.eptotal = eptotal;
+        data.setRelations(relationAidList, relationTypeList);
+        data.stats.setNormalEpisodes(normalEpisodes);
+        data.stats.setTotalNormalEpisodes(totalNormalEpisodes);
+        data.stats.setNormalViewed(normalViewed);
+        data.stats.setOtherEpisodes(otherEpisodes);
+        data.stats.setOtherViewed(otherViewed);
+        
+        qint32 episodeCount = 0;
+        in >> episodeCount;
+        if (episodeCount < 0) {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+        data.episodes.reserve(episodeCount);
+        for (qint32 e = 0; e < episodeCount && in.status() == QDataStream::Ok; ++e) {
+            EpisodeCacheEntry entry;
+            qint32 lid = 0, eid = 0, fid = 0, state = 0, fileState = 0, viewed = 0, localWatched = 0, episodeWatched = 0;
+            in >> lid >> eid >> fid >> state >> fileState >> viewed
+               >> entry.storage >> entry.episodeName >> entry.epno >> entry.filename
+               >> entry.lastPlayed >> entry.localFilePath >> entry.resolution
+               >> entry.quality >> entry.groupName
+               >> localWatched >> episodeWatched >> entry.airDate;
+            entry.lid = lid;
+            entry.eid = eid;
+            entry.fid = fid;
+            entry.state = state;
+            entry.fileState = fileState;
+            entry.viewed = viewed;
+            entry.localWatched = localWatched;
+            entry.episodeWatched = episodeWatched;
+            data.episodes.append(entry);
+        }
+    }
+    
+    QList<AnimeChain> chains;
+    qint32 chainCount = 0;
+    in >> chainCount;
+    for (qint32 i = 0; i < chainCount && in.status() == QDataStream::Ok; ++i) {
+        QList<int> animeIds;
+        in >> animeIds;
+        chains.append(AnimeChain(animeIds));
+    }
+    
+    if (in.status() != QDataStream::Ok) {
+        LOG("[MyListCardManager] Snapshot payload is truncated or corrupt, ignoring it");
+        return false;
+    }
+    
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cardCreationDataCache = cache;
+        m_chainList = chains;
+        m_metadataStore.clear();
+        m_filterIndex.clear();
+        m_relationGraph.clear();
+        m_chainsBuilt = false;  // Restored chains already match the relations fed to the graph here
+        updateMetadataStore(m_cardCreationDataCache.keys());
+        
+        m_aidToChainIndex.clear();
+        for (int i = 0; i < m_chainList.size(); ++i) {
+            for (int aid : m_chainList[i].getAnimeIds()) {
+                m_aidToChainIndex[aid] = i;
+            }
+        }
+        
+        m_chainsBuilt = !m_chainList.isEmpty();
+        m_chainBuildInProgress = false;
+        m_dataReady = true;
+        m_lastChainBuildAnimeCount = m_cardCreationDataCache.size();
+    }
+    m_dataReadyCondition.wakeAll();
+    
+    LOG(QString("[MyListCardManager] Restored %1 anime and %2 chains from snapshot in %3 ms")
+        .arg(cache.size()).arg(chains.size()).arg(timer.elapsed()));
+    return true;
+}
+
+bool MyListCardManager::applySnapshotDeltas(const QList<int>& aids)
+{
+    if (aids.isEmpty()) {
+        return false;
+    }
+    
+    // Changed relations and new anime update their chains through updateMetadataStore()
+    quint64 revision = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        revision = m_chainRevision;
+    }
+    
+    preloadCardCreationData(aids);
+    
+    bool chainsChanged = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        chainsChanged = (m_chainRevision != revision);
+    }
+    
+    LOG(QString("[MyListCardManager] Applied snapshot deltas for %1 anime (chains %2)")
+        .arg(aids.size()).arg(chainsChanged ? "updated" : "unchanged"));
+    return chainsChanged;
+}
+
 void MyListCardManager::onHideCardRequested(int aid)
 {
     LOG(QString("[MyListCardManager] Hide card requested for anime %1").arg(aid));
     
     QMutexLocker locker(&m_mutex);
     AnimeCard *card = m_cards.value(aid, nullptr);
+    auto cacheIt = m_cardCreationDataCache.find(aid);
     
-    if (!card) {
+    // The painted card grid has no managed card; its state lives in the cached data
+    if (!card && cacheIt == m_cardCreationDataCache.end()) {
         LOG(QString("[MyListCardManager] Card not found for hide request aid=%1").arg(aid));
         return;
     }
     
     // Toggle hidden state
-    bool isHidden = card->isHidden();
-    card->setHidden(!isHidden);
+    bool isHidden = card ? card->isHidden() : cacheIt->isHidden;
+    if (card) {
+        card->setHidden(!isHidden);
+    }
+    
+    // Keep cached data in sync so sorting sees the new state without a reload
+    if (cacheIt != m_cardCreationDataCache.end()) {
+        cacheIt->isHidden = !isHidden;
+    }
+    m_metadataStore.setHidden(aid, !isHidden);
+    m_chainSortIndex.clear();
     
     // Update database to persist hidden state
     locker.unlock();
@@ -2562,6 +3006,7 @@ void MyListCardManager::onHideCardRequested(int aid)
                 .arg(aid).arg(q.lastError().text()));
         } else {
             LOG(QString("[MyListCardManager] Updated hidden state for aid=%1 to %2").arg(aid).arg(!isHidden));
+            emit cardUpdated(aid);
             // Trigger card sorting/repositioning
             emit cardNeedsSorting(aid);
         }
@@ -3,22 +3,30 @@
 
 #include <QObject>
 #include <QMap>
+#include <QMultiHash>
 #include <QSet>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QTimer>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QtNetwork/QNetworkReply>
+#include <QDataStream>
+#include <QImage>
 #include "animecard.h"
+#include "cardcache.h"
 #include "flowlayout.h"
 #include "animestats.h"
 #include "cachedanimedata.h"
 #include "animechain.h"
+#include "animemetadatastore.h"
+#include "animefilterindex.h"
+#include "chainsortindex.h"
+#include "relationgraph.h"
 #include "relationdata.h"
 
 // Forward declarations
 class VirtualFlowLayout;
 class WatchSessionManager;
+class PosterCache;
+class PosterDownloader;
 
 /**
  * MyListCardManager - Manages the lifecycle and updates of anime cards
@@ -56,6 +64,9 @@ public:
     // Set the watch session manager for file mark queries
     void setWatchSessionManager(WatchSessionManager *manager) { m_watchSessionManager = manager; }
     
+    // Prequel/sequel graph fed from the card data cache (shared with WatchSessionManager)
+    RelationGraph* relationGraph() { return &m_relationGraph; }
+    
     // Get the list of anime IDs in the current order (for virtual scrolling)
     QList<int> getAnimeIdList() const;
     
@@ -65,7 +76,7 @@ public:
     // Set anime IDs with chain mode enabled (builds chains before sorting)
     void setAnimeIdList(const QList<int>& aids, bool chainModeEnabled);
     
-    // Build chains from anime IDs using cached relation data
+    // Build chains from anime IDs using the relation graph
     // Chains are always expanded to include related anime not in the original list
     QList<AnimeChain> buildChainsFromAnimeIds(const QList<int>& aids) const;
     
@@ -88,9 +99,13 @@ public:
     bool isChainModeEnabled() const { return m_chainModeEnabled; }
     
     // Create a card for a specific index in the ordered list (for virtual scrolling)
-    // This is the factory method called by VirtualFlowLayout
+    // This is the factory method called by VirtualFlowLayout; it never waits for data
     AnimeCard* createCardForIndex(int index);
     
+    // Anime whose cards are still skeletons waiting for their data, in display order
+    // (the cards the virtual layout shows, so their data can be preloaded first)
+    QList<int> getLoadingCardAnimeIds() const;
+    
     // Check if virtual scrolling is enabled
     bool isVirtualScrollingEnabled() const { return m_virtualLayout != nullptr; }
     
@@ -109,6 +124,15 @@ public:
     // Get all cards (for sorting operations)
     QList<AnimeCard*> getAllCards() const;
     
+    // Budget for the cards kept alive with virtual scrolling (0 = no limit).
+    // Cards form a pool of about the viewport plus buffer rows (at most maxCards):
+    // once it is full, the least recently used off-screen card is rebound to the
+    // anime that scrolls into view. Cards beyond the budget are deleted.
+    void setCardCacheBudget(int maxCards, qint64 maxBytes);
+    
+    // Hit rate, evictions and resident size of the card cache
+    CardCache::Stats cardCacheStats() const;
+    
     // Individual update methods (asynchronous)
     void updateCardAnimeInfo(int aid);
     void updateCardEpisode(int aid, int eid);
@@ -149,13 +173,41 @@ public:
     // This prevents race conditions by bulk-loading data before chain building starts
     void preloadRelationDataForChainExpansion(const QList<int>& baseAids);
     
-    // Create a card for an anime (data must be preloaded first via preloadCardCreationData)
+    // Create a card for an anime. Without preloaded data (preloadCardCreationData) a
+    // skeleton card is returned, which is filled in when the data has been preloaded
     AnimeCard* createCard(int aid);
     
-    // Create a standalone card for display purposes (not tracked or added to layout).
-    // The caller owns the returned widget. No signals are connected.
+    // Create a standalone card for display purposes (not cached or added to layout).
+    // The caller owns the returned widget. No signals are connected; the poster
+    // thumbnail is requested asynchronously and set when it is ready.
     AnimeCard* createStandaloneCard(int aid, QWidget *parent);
     
+    // Everything a painted card shows (see AnimeCardModel); valid is false without cached data
+    struct CardDisplayData {
+        bool valid = false;
+        QString title;
+        QString typeName;
+        QString airedText;
+        QString rating;
+        QStringList tagNames;     // Highest weight first, category fallback applied
+        QString statistics;       // As AnimeCard::formatStatistics()
+        bool hasUnwatchedEpisodes = false;
+        bool isHidden = false;
+        bool hasPoster = false;   // Thumbnail via requestPosterThumbnail()
+    };
+    
+    // Display data from the card creation cache (without the poster)
+    CardDisplayData getCardDisplayData(int aid);
+    
+    // Queue a poster thumbnail of size (logical pixels) at the device pixel ratio on the
+    // poster workers; posterThumbnailReady() delivers it. onScreen requests are served first
+    void requestPosterThumbnail(int aid, const QSize &size, qreal devicePixelRatio, bool onScreen);
+    
+    // Create a standalone card that behaves like a managed one: its requests reach the manager
+    // and cardCreated/cardBound are emitted, but it is neither cached nor laid out.
+    // Used as the editor of the painted card grid; the caller owns the returned widget.
+    AnimeCard* createInteractiveCard(int aid, QWidget *parent);
+    
     // Get cached anime data for filtering/sorting without needing card widgets
     // This is essential for virtual scrolling where cards don't exist until visible
     CachedAnimeData getCachedAnimeData(int aid) const;
@@ -163,13 +215,47 @@ public:
     // Check if cached data exists for an anime
     bool hasCachedData(int aid) const;
     
+    // Sort anime IDs without chain grouping using the columnar metadata store
+    // (hidden anime last, ties broken by title; anime without cached data keep their order at the end)
+    QList<int> sortAnimeIds(const QList<int>& aids, AnimeChain::SortCriteria criteria, bool ascending) const;
+    
+    // Filter anime IDs (order preserved) with the bitmap filter index; anime without cached data are dropped
+    QList<int> filterAnimeIds(const QList<int>& aids, const AnimeFilterIndex::Criteria& criteria,
+                              const AnimeMetadataCache* alternativeTitles) const;
+    
+    // Startup snapshot support (see CardDataSnapshot)
+    // Serialize the card creation cache and chain list (poster images are not included).
+    // Only anime in keepAids are written; chains are split where a dropped anime was
+    bool writeSnapshot(QDataStream& out, const QSet<int>& keepAids) const;
+    
+    // Restore data written by writeSnapshot(); on success chains are built and data is ready
+    bool readSnapshot(QDataStream& in);
+    
+    // True once preload and chain building have completed and there is data worth saving
+    bool isSnapshotable() const;
+    
+    // Re-read anime changed since the snapshot was written. Only chains touched by a
+    // changed relation or a new anime are rebuilt.
+    // Returns true if any chain changed.
+    bool applySnapshotDeltas(const QList<int>& aids);
+    
 signals:
-    // Emitted when a card is created
+    // Emitted when a card is created (once per widget; connect card signals here)
     void cardCreated(int aid, AnimeCard *card);
     
+    // Emitted whenever a card is bound to an anime's data: after creation, when a
+    // pooled card is reused for another anime and when a card is refreshed
+    void cardBound(int aid, AnimeCard *card);
+    
     // Emitted when a card is updated
     void cardUpdated(int aid);
     
+    // Emitted when a requested poster thumbnail is ready (after it was set on the anime's card)
+    void posterThumbnailReady(int aid, const QImage &thumbnail);
+    
+    // Emitted when an off-screen card is dropped from the card cache; the card is deleted later
+    void cardEvicted(int aid, AnimeCard *card);
+    
     // Emitted when all cards are loaded
     void allCardsLoaded(int count);
     
@@ -201,8 +287,9 @@ public slots:
     // Slot to handle anime updates from API
     void onAnimeUpdated(int aid);
     
-    // Slot to handle poster download completion
-    void onPosterDownloadFinished(QNetworkReply *reply);
+    // Slots to handle poster download results (stored even if the card was evicted meanwhile)
+    void onPosterDownloaded(int aid, const QString &picname, const QByteArray &imageData);
+    void onPosterNotModified(int aid);
     
     // Slot to handle manual data fetch request
     void onFetchDataRequested(int aid);
@@ -220,6 +307,15 @@ private slots:
     // Timer slot for batched updates
     void processBatchedUpdates();
     
+    // A card left the viewport of the virtual layout
+    void onCardWidgetRecycled(int oldIndex, int newIndex, QWidget *widget);
+    
+    // A poster thumbnail arrived from the poster workers
+    void onPosterThumbnailReady(int aid, const QImage &thumbnail);
+    
+    // Delete off-screen cards until the card cache is within budget
+    void evictCards();
+    
 private:
     // Structure to cache episode data for an anime
     struct EpisodeCacheEntry {
@@ -254,7 +350,7 @@ private:
     class CardCreationData {
     public:
         CardCreationData() 
-            : isHidden(false), is18Restricted(false), eptotal(0), lastPlayed(0), recentEpisodeAirDate(0), hasData(false) {}
+            : isHidden(false), is18Restricted(false), eptotal(0), lastPlayed(0), recentEpisodeAirDate(0), hasPosterImage(false), hasData(false) {}
         
         // Anime basic info - public members for direct access (struct-like interface)
         QString nameRomaji;
@@ -264,7 +360,6 @@ private:
         QString startDate;
         QString endDate;
         QString picname;
-        QByteArray posterData;
         QString category;
         QString rating;
         QString tagNameList;
@@ -276,6 +371,10 @@ private:
         qint64 lastPlayed;
         qint64 recentEpisodeAirDate;
         
+        // True if anime.poster_image is set; the image itself is never preloaded
+        // (PosterCache decodes thumbnails from it on demand)
+        bool hasPosterImage;
+        
         // Statistics
         AnimeStats stats;
         
@@ -367,36 +466,74 @@ private:
     // Request missing anime metadata
     void requestAnimeMetadata(int aid, const QString& reason = QString());
     
-    // Download poster for anime
-    void downloadPoster(int aid, const QString &picname);
+    // Queue the poster download of an anime, prioritized by where its card is.
+    // userRequested: asked for from the card, served like a card on screen
+    void downloadPoster(int aid, const QString &picname, bool userRequested = false);
     
     AnimeStats calculateStatistics(int aid);
     
-    // Chain building helpers
-    QList<int> buildChainFromAid(int startAid, const QSet<int>& availableAids, bool expandChain = false) const;
-    int findPrequelAid(int aid) const;
-    int findSequelAid(int aid) const;
-
-    
-    // Load relation data for anime not in cache (for chain expansion)
-    void loadRelationDataForAnime(int aid) const;
-    
     // Helper functions for common operations
     QString determineAnimeName(const QString& nameRomaji, const QString& nameEnglish, const QString& animeTitle, int aid);
     QList<AnimeCard::TagInfo> getTagsOrCategoryFallback(const QString& tagNames, const QString& tagIds, const QString& tagWeights, const QString& category);
     void updateCardAiredDates(AnimeCard* card, const QString& startDate, const QString& endDate);
     
+    // Mirror the sort/filter fields of cached anime into m_metadataStore and m_filterIndex (caller must hold m_mutex)
+    void updateMetadataStore(const QList<int>& aids);
+    
+    // Replace the chains containing the given anime with their current graph chains (caller must hold m_mutex)
+    void updateChains(const QSet<int>& aids);
+    
+    // Re-read the relations of an updated anime from the database
+    void refreshRelations(int aid);
+    
     // Cache anime titles for bulk loading (aid -> title)
     void preloadAnimeTitlesCache(const QList<int>& aids);
     void clearAnimeTitlesCache();
     
+    // Fill a new or recycled card from m_cardCreationDataCache (data must exist)
+    void bindCard(AnimeCard *card, int aid);
+    
+    // Route the requests of a card to the manager slots and relay signals
+    void connectCardSignals(AnimeCard *card);
+    
+    // Bind the existing card of an anime again with current data; false if it has none
+    bool rebindCard(int aid);
+    
+    // Bind the skeleton cards of the given anime whose data is cached now
+    void fillLoadingCards(const QList<int>& aids);
+    
+    // Take the least recently used off-screen card once the pool is full (virtual scrolling only)
+    AnimeCard* takeRecyclableCard();
+    
+    // Anime IDs of the cards the virtual layout shows (caller must hold m_mutex)
+    QSet<int> visibleCardAids() const;
+    
+    // Queue evictCards() once, after the current layout pass
+    void scheduleCardEviction();
+    
     // Card cache indexed by anime ID
     QMap<int, AnimeCard*> m_cards;
     
+    // Live standalone cards waiting for or showing a poster thumbnail (see createStandaloneCard)
+    QMultiHash<int, AnimeCard*> m_standaloneCards;
+    
+    // Anime of m_cards whose card is a skeleton (created before their data was preloaded)
+    QSet<int> m_loadingCardAids;
+    
+    // Use order and estimated size of m_cards (virtual scrolling only)
+    CardCache m_cardCache;
+    bool m_cardEvictionScheduled;
+    
     // Comprehensive card creation data cache - contains ALL data needed for card creation
     // This is populated once before any cards are created
     QMap<int, CardCreationData> m_cardCreationDataCache;
     
+    // Columnar copy of the scalar fields of m_cardCreationDataCache used by sort kernels
+    AnimeMetadataStore m_metadataStore;
+    
+    // Bitmap index over m_cardCreationDataCache entries with data, used by filtering
+    AnimeFilterIndex m_filterIndex;
+    
     // Layout where cards are displayed
     FlowLayout *m_layout;
     
@@ -412,7 +549,11 @@ private:
     // Chain support
     QList<AnimeChain> m_chainList;          // List of chains (built once from complete cache)
     QList<AnimeChain> m_displayedChains;    // Currently displayed chains (includes standalone chains from filtering)
+    QList<AnimeChain> m_sortBaseChains;     // m_displayedChains as passed to m_chainSortIndex (its chain indices refer here)
+    ChainSortIndex m_chainSortIndex;        // Cached chain sort keys; cleared when chains or cached data change
     QMap<int, int> m_aidToChainIndex;       // Anime ID -> chain index mapping
+    RelationGraph m_relationGraph;          // Prequel/sequel graph with chain membership (fed by updateMetadataStore)
+    quint64 m_chainRevision;                // Incremented whenever updateChains() changes chains
     bool m_chainModeEnabled;                // Is chain mode active
     QSet<int> m_expandedChainAnimeIds;      // Anime IDs added by chain expansion (not in original mylist)
     bool m_chainsBuilt;                     // Flag to track if chains have been built from cache
@@ -420,8 +561,12 @@ private:
     bool m_dataReady;                       // Flag to track if ALL data is loaded and processed (preload + chains)
     int m_lastChainBuildAnimeCount;         // Number of anime used in last chain build (to detect when rebuild is needed)
     
-    // Network manager for poster downloads
-    QNetworkAccessManager *m_networkManager;
+    // Off-thread poster decoding with the on-disk thumbnail cache
+    PosterCache *m_posterCache;
+    
+    // Bounded, prioritized poster downloads
+    PosterDownloader *m_posterDownloader;
+    QSet<int> m_posterVisibleAids;          // Cards on screen at the last download re-prioritization
     
     // Tracking for pending operations
     QSet<int> m_episodesNeedingData;
@@ -429,7 +574,6 @@ private:
     QSet<int> m_animeMetadataRequested;
     QSet<int> m_animeNeedingPoster;
     QMap<int, QString> m_animePicnames;
-    QMap<QNetworkReply*, int> m_posterDownloadRequests;
     
     // Batched updates for efficiency
     QSet<int> m_pendingCardUpdates;
@@ -444,6 +588,7 @@ private:
     
     // Constants
     static const int BATCH_UPDATE_DELAY = 50; // ms
+    static const int SNAPSHOT_VERSION = 1;    // MyListCardManager payload version inside CardDataSnapshot
 };
 
 #endif // MYLISTCARDMANAGER_H
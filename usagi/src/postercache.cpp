@@ -0,0 +1,386 @@
+#include "postercache.h"
+#include "logger.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadStorage>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+    // Raw thumbnail file: magic, version, width, height, bytes per line, then the scan lines
+    constexpr quint32 THUMBNAIL_MAGIC = 0x55505448;  // "UPTH"
+    constexpr quint16 THUMBNAIL_VERSION = 1;
+    constexpr QImage::Format THUMBNAIL_FORMAT = QImage::Format_ARGB32_Premultiplied;
+
+    // Decoding is memory bound; a few workers keep up with scrolling
+    constexpr int MAX_WORKERS = 4;
+
+    QSize pixelSize(const QSize &size, qreal devicePixelRatio)
+    {
+        return QSize(qRound(size.width() * devicePixelRatio), qRound(size.height() * devicePixelRatio));
+    }
+
+    // Database connection of one worker thread, opened on its first job and removed
+    // when the pool retires the thread
+    class WorkerConnection
+    {
+    public:
+        WorkerConnection()
+            : m_name(QString("PosterCache_%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId())))
+        {
+        }
+
+        ~WorkerConnection()
+        {
+            {
+                QSqlDatabase db = QSqlDatabase::database(m_name, false);
+                db.close();
+            }
+            QSqlDatabase::removeDatabase(m_name);
+        }
+
+        QSqlDatabase database(const QString &databaseName)
+        {
+            QSqlDatabase db = QSqlDatabase::database(m_name, false);
+            if (!db.isValid()) {
+                db = QSqlDatabase::addDatabase("QSQLITE", m_name);
+            }
+            if (db.isOpen() && db.databaseName() == databaseName) {
+                return db;
+            }
+            db.close();
+            db.setDatabaseName(databaseName);
+            // Wait for a writer on the GUI thread instead of failing with SQLITE_BUSY
+            db.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(PosterCache::BUSY_TIMEOUT_MS));
+            if (!db.open()) {
+                LOG(QString("[PosterCache] Failed to open worker database connection: %1").arg(db.lastError().text()));
+            }
+            return db;
+        }
+
+    private:
+        QString m_name;
+    };
+
+    QThreadStorage<WorkerConnection*> s_workerConnections;
+}
+
+PosterCache::PosterCache(QObject *parent)
+    : QObject(parent)
+    , m_maxDirectoryBytes(DEFAULT_MAX_DIRECTORY_BYTES)
+    , m_writesSincePrune(0)
+    , m_pruneRunning(false)
+{
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, MAX_WORKERS));
+}
+
+PosterCache::~PosterCache()
+{
+    // Results of running jobs are dropped with this object
+    m_queue.clear();
+    m_pool.waitForDone();
+}
+
+void PosterCache::setDirectory(const QString &directory)
+{
+    m_directory = directory;
+    if (!m_directory.isEmpty() && !QDir().mkpath(m_directory)) {
+        LOG(QString("[PosterCache] Cannot create thumbnail directory %1, keeping thumbnails in memory only")
+            .arg(m_directory));
+        m_directory.clear();
+    }
+    // Left over from earlier sessions
+    schedulePrune();
+}
+
+QString PosterCache::defaultDirectory()
+{
+    QSqlDatabase db = QSqlDatabase::database();
+    QString dbName = db.databaseName();
+    if (dbName.isEmpty() || dbName == ":memory:") {
+        return QString();
+    }
+    return dbName + ".posters";
+}
+
+void PosterCache::request(int aid, const QSize &size, qreal devicePixelRatio, bool onScreen)
+{
+    cancel(aid);
+
+    const Request queued{aid, size, devicePixelRatio, 0};
+    if (onScreen) {
+        m_queue.prepend(queued);
+    } else {
+        m_queue.append(queued);
+    }
+    startJobs();
+}
+
+void PosterCache::cancel(int aid)
+{
+    m_queue.removeIf([aid](const Request &queued) { return queued.aid == aid; });
+}
+
+void PosterCache::invalidate(int aid)
+{
+    cancel(aid);
+    if (m_running.contains(aid)) {
+        m_invalidated.insert(aid);
+    }
+    if (m_directory.isEmpty()) {
+        return;
+    }
+
+    QDir dir(m_directory);
+    const QStringList files = dir.entryList({QString("%1_*.thumb").arg(aid)}, QDir::Files);
+    for (const QString &file : files) {
+        dir.remove(file);
+    }
+}
+
+QString PosterCache::thumbnailFileName(int aid, const QSize &pixelSize)
+{
+    return QString("%1_%2x%3.thumb").arg(aid).arg(pixelSize.width()).arg(pixelSize.height());
+}
+
+QImage PosterCache::scaleToFit(const QImage &poster, const QSize &size, qreal devicePixelRatio)
+{
+    if (poster.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+    QImage thumbnail = poster.scaled(pixelSize(size, devicePixelRatio), Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                           .convertToFormat(THUMBNAIL_FORMAT);
+    thumbnail.setDevicePixelRatio(devicePixelRatio);
+    return thumbnail;
+}
+
+bool PosterCache::writeThumbnail(const QString &path, const QImage &thumbnail)
+{
+    if (thumbnail.isNull() || thumbnail.format() != THUMBNAIL_FORMAT) {
+        return false;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    out << THUMBNAIL_MAGIC << THUMBNAIL_VERSION
+        << qint32(thumbnail.width()) << qint32(thumbnail.height()) << qint32(thumbnail.bytesPerLine());
+    const qsizetype bytes = thumbnail.sizeInBytes();
+    if (out.writeRawData(reinterpret_cast<const char*>(thumbnail.constBits()), static_cast<int>(bytes)) != bytes) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+QImage PosterCache::readThumbnail(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 width = 0;
+    qint32 height = 0;
+    qint32 bytesPerLine = 0;
+    in >> magic >> version >> width >> height >> bytesPerLine;
+    if (in.status() != QDataStream::Ok || magic != THUMBNAIL_MAGIC || version != THUMBNAIL_VERSION
+        || width <= 0 || height <= 0) {
+        return QImage();
+    }
+
+    QImage thumbnail(width, height, THUMBNAIL_FORMAT);
+    const qsizetype bytes = thumbnail.sizeInBytes();
+    if (thumbnail.isNull() || thumbnail.bytesPerLine() != bytesPerLine
+        || in.readRawData(reinterpret_cast<char*>(thumbnail.bits()), static_cast<int>(bytes)) != bytes) {
+        return QImage();
+    }
+    return thumbnail;
+}
+
+void PosterCache::startJobs()
+{
+    const int workers = m_pool.maxThreadCount();
+    for (int i = 0; i < m_queue.size() && m_running.size() < workers; ) {
+        // One job per anime at a time; a newer request for it waits its turn
+        if (m_running.contains(m_queue.at(i).aid)) {
+            ++i;
+            continue;
+        }
+        const Request job = m_queue.takeAt(i);
+        m_running.insert(job.aid);
+
+        const QString directory = m_directory;
+        const QString databaseName = m_databaseName;
+        m_pool.start([this, job, directory, databaseName]() {
+            const JobResult result = produceThumbnail(job, directory, databaseName);
+            QMetaObject::invokeMethod(this, [this, job, result]() {
+                onJobFinished(job, result);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void PosterCache::onJobFinished(const Request &request, const JobResult &result)
+{
+    const int aid = request.aid;
+    m_running.remove(aid);
+    if (m_invalidated.remove(aid)) {
+        // Made from the previous poster; drop the file it may have written
+        invalidate(aid);
+    } else if (result.readFailed) {
+        retry(request);
+    } else {
+        emit posterReady(aid, result.thumbnail);
+    }
+
+    if (result.fileWritten && ++m_writesSincePrune >= PRUNE_EVERY_WRITES) {
+        schedulePrune();
+    }
+    startJobs();
+}
+
+void PosterCache::retry(const Request &request)
+{
+    Request again = request;
+    if (++again.attempt >= READ_ATTEMPTS) {
+        LOG(QString("[PosterCache] Giving up on the poster of aid=%1 after %2 failed reads")
+            .arg(request.aid).arg(again.attempt));
+        emit posterReady(request.aid, QImage());
+        return;
+    }
+    QTimer::singleShot(RETRY_DELAY_MS * again.attempt, this, [this, again]() {
+        // A newer request (or a running job) for the anime takes precedence
+        const bool queued = std::any_of(m_queue.cbegin(), m_queue.cend(),
+                                        [&again](const Request &queued) { return queued.aid == again.aid; });
+        if (queued || m_running.contains(again.aid)) {
+            return;
+        }
+        m_queue.append(again);
+        startJobs();
+    });
+}
+
+void PosterCache::schedulePrune()
+{
+    if (m_directory.isEmpty() || m_pruneRunning) {
+        return;
+    }
+    m_pruneRunning = true;
+    m_writesSincePrune = 0;
+
+    const QString directory = m_directory;
+    const qint64 maxBytes = m_maxDirectoryBytes;
+    m_pool.start([this, directory, maxBytes]() {
+        const int removed = pruneDirectory(directory, maxBytes);
+        if (removed > 0) {
+            LOG(QString("[PosterCache] Pruned %1 old thumbnail file(s)").arg(removed));
+        }
+        QMetaObject::invokeMethod(this, [this]() {
+            m_pruneRunning = false;
+        }, Qt::QueuedConnection);
+    });
+}
+
+int PosterCache::pruneDirectory(const QString &directory, qint64 maxBytes)
+{
+    QDir dir(directory);
+    const QFileInfoList files = dir.entryInfoList({"*.thumb"}, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 total = 0;
+    for (const QFileInfo &file : files) {
+        total += file.size();
+    }
+    if (total <= maxBytes) {
+        return 0;
+    }
+
+    // Oldest first, down to 3/4 of the cap so the next prune is not due right away
+    const qint64 target = maxBytes / 4 * 3;
+    int removed = 0;
+    for (const QFileInfo &file : files) {
+        if (total <= target) {
+            break;
+        }
+        if (dir.remove(file.fileName())) {
+            total -= file.size();
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+PosterCache::JobResult PosterCache::produceThumbnail(const Request &request, const QString &directory,
+                                                     const QString &databaseName)
+{
+    JobResult result;
+    const QSize pixels = pixelSize(request.size, request.devicePixelRatio);
+    const QString path = directory.isEmpty()
+        ? QString() : QDir(directory).filePath(thumbnailFileName(request.aid, pixels));
+
+    if (!path.isEmpty()) {
+        result.thumbnail = readThumbnail(path);
+        if (!result.thumbnail.isNull()) {
+            result.thumbnail.setDevicePixelRatio(request.devicePixelRatio);
+            return result;
+        }
+    }
+
+    QByteArray posterData;
+    if (!readPosterImage(request.aid, databaseName, posterData)) {
+        result.readFailed = true;
+        return result;
+    }
+    QImage poster;
+    if (posterData.isEmpty() || !poster.loadFromData(posterData)) {
+        return result;
+    }
+
+    result.thumbnail = scaleToFit(poster, request.size, request.devicePixelRatio);
+    if (!path.isEmpty()) {
+        result.fileWritten = writeThumbnail(path, result.thumbnail);
+        if (!result.fileWritten) {
+            LOG(QString("[PosterCache] Failed to write thumbnail %1").arg(path));
+        }
+    }
+    return result;
+}
+
+bool PosterCache::readPosterImage(int aid, const QString &databaseName, QByteArray &posterData)
+{
+    // An in-memory database can't be opened a second time
+    if (databaseName.isEmpty() || databaseName == ":memory:") {
+        return true;
+    }
+
+    // Connections belong to the thread that opened them; each worker keeps its own
+    if (!s_workerConnections.hasLocalData()) {
+        s_workerConnections.setLocalData(new WorkerConnection);
+    }
+    QSqlDatabase db = s_workerConnections.localData()->database(databaseName);
+    if (!db.isOpen()) {
+        return false;
+    }
+
+    QSqlQuery q(db);
+    q.prepare("SELECT poster_image FROM anime WHERE aid = ?");
+    q.addBindValue(aid);
+    if (!q.exec()) {
+        LOG(QString("[PosterCache] Failed to read the poster of aid=%1: %2").arg(aid).arg(q.lastError().text()));
+        return false;
+    }
+    if (q.next()) {
+        posterData = q.value(0).toByteArray();
+    }
+    return true;
+}
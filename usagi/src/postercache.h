@@ -0,0 +1,130 @@
+#ifndef POSTERCACHE_H
+#define POSTERCACHE_H
+
+#include <QObject>
+#include <QImage>
+#include <QList>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+/**
+ * PosterCache - Decodes anime posters off the GUI thread into card-sized thumbnails
+ *
+ * The encoded posters stay in anime.poster_image; nothing is preloaded. A
+ * request names the anime, the size of the poster area and the device pixel
+ * ratio. A worker thread (with a database connection it keeps open) reads the BLOB,
+ * decodes it, scales it to exactly that size in device pixels and hands the
+ * image back through posterReady() on the GUI thread, ready to be blitted.
+ *
+ * Thumbnails are also written to a directory next to the database, one raw
+ * ARGB32 (premultiplied) file per anime and pixel size, so later requests only
+ * read the file back. invalidate() drops them when a poster changes, and the
+ * directory is pruned to maximumDirectorySize(), oldest files first.
+ *
+ * A BLOB that cannot be read (e.g. the database stayed locked for longer than
+ * BUSY_TIMEOUT_MS) is requested again up to READ_ATTEMPTS times.
+ *
+ * At most one job per worker thread runs at a time; the rest wait in a queue.
+ * Requests for cards on screen go to the front of it, so a scroll or the first
+ * paint is served before posters requested earlier for cards off screen.
+ */
+class PosterCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PosterCache(QObject *parent = nullptr);
+    ~PosterCache() override;
+
+    // Database the workers read anime.poster_image from (file name, one connection per worker)
+    void setDatabaseName(const QString &databaseName) { m_databaseName = databaseName; }
+    QString databaseName() const { return m_databaseName; }
+
+    // Directory of the thumbnail files; empty keeps thumbnails in memory only
+    void setDirectory(const QString &directory);
+    QString directory() const { return m_directory; }
+
+    // Thumbnail directory next to the main database, empty for an in-memory database
+    static QString defaultDirectory();
+
+    // Bytes of thumbnail files kept in the directory; older files are deleted beyond it
+    void setMaximumDirectorySize(qint64 bytes) { m_maxDirectoryBytes = bytes; }
+    qint64 maximumDirectorySize() const { return m_maxDirectoryBytes; }
+
+    static constexpr qint64 DEFAULT_MAX_DIRECTORY_BYTES = 512LL * 1024 * 1024;
+    static constexpr int PRUNE_EVERY_WRITES = 256;   // New thumbnail files between two prunes
+    static constexpr int BUSY_TIMEOUT_MS = 5000;     // Wait of a worker for a locked database
+    static constexpr int READ_ATTEMPTS = 3;
+    static constexpr int RETRY_DELAY_MS = 1000;
+
+    // Queue a thumbnail of size (logical pixels) at the device pixel ratio.
+    // onScreen requests are served before all others; a queued request is replaced.
+    void request(int aid, const QSize &size, qreal devicePixelRatio, bool onScreen);
+
+    // Drop a queued request (the card was evicted or bound to another anime)
+    void cancel(int aid);
+
+    // Delete the thumbnails of an anime whose poster changed
+    void invalidate(int aid);
+
+    // Requests waiting for a worker
+    int pendingCount() const { return static_cast<int>(m_queue.size()); }
+
+    // Thumbnail file of an anime at a size in device pixels
+    static QString thumbnailFileName(int aid, const QSize &pixelSize);
+
+    // Scale a decoded poster to fit size (logical pixels) at the device pixel ratio
+    static QImage scaleToFit(const QImage &poster, const QSize &size, qreal devicePixelRatio);
+
+    // Raw thumbnail files: header plus the scan lines, read back without decoding
+    static bool writeThumbnail(const QString &path, const QImage &thumbnail);
+    static QImage readThumbnail(const QString &path);
+
+    // Delete the oldest thumbnail files until at most 3/4 of maxBytes are left,
+    // if the directory holds more than maxBytes. Returns the number of files deleted.
+    static int pruneDirectory(const QString &directory, qint64 maxBytes);
+
+signals:
+    // Thumbnail for a request, with its device pixel ratio set; null if the anime has no poster
+    void posterReady(int aid, const QImage &thumbnail);
+
+private:
+    struct Request {
+        int aid;
+        QSize size;
+        qreal devicePixelRatio;
+        int attempt;                 // Reads of the poster that failed so far
+    };
+
+    struct JobResult {
+        QImage thumbnail;
+        bool readFailed = false;     // The poster could not be read; try again later
+        bool fileWritten = false;    // A new thumbnail file was written
+    };
+
+    // Hand queued requests to idle workers
+    void startJobs();
+    void onJobFinished(const Request &request, const JobResult &result);
+    void retry(const Request &request);
+    void schedulePrune();
+
+    // Worker: thumbnail file, or decode and scale the poster BLOB (and write the file)
+    static JobResult produceThumbnail(const Request &request, const QString &directory,
+                                      const QString &databaseName);
+    // False if the database could not be read; an anime without a poster is not a failure
+    static bool readPosterImage(int aid, const QString &databaseName, QByteArray &posterData);
+
+    QList<Request> m_queue;          // Front first; on-screen requests are prepended
+    QSet<int> m_running;             // Anime with a job on a worker
+    QSet<int> m_invalidated;         // Running jobs whose poster changed meanwhile
+    QThreadPool m_pool;
+    QString m_directory;
+    QString m_databaseName;
+    qint64 m_maxDirectoryBytes;
+    int m_writesSincePrune;
+    bool m_pruneRunning;
+};
+
+#endif // POSTERCACHE_H
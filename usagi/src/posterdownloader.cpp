@@ -0,0 +1,283 @@
+#include "posterdownloader.h"
+#include "logger.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+    const char *const ANIDB_POSTER_BASE_URL = "http://img7.anidb.net/pics/anime/";
+}
+
+PosterDownloader::PosterDownloader(QObject *parent)
+    : QObject(parent)
+    , m_network(new QNetworkAccessManager(this))
+    , m_baseUrl(QString(ANIDB_POSTER_BASE_URL))
+    , m_maxConcurrent(DEFAULT_MAX_CONCURRENT)
+    , m_sequence(0)
+    , m_validatorTableReady(false)
+{
+}
+
+PosterDownloader::~PosterDownloader()
+{
+    // Aborting emits finished(); nobody is left to handle it
+    const QList<QNetworkReply*> replies = m_running.keys();
+    for (QNetworkReply *reply : replies) {
+        reply->disconnect(this);
+        reply->abort();
+    }
+}
+
+void PosterDownloader::setMaxConcurrent(int maxConcurrent)
+{
+    m_maxConcurrent = qMax(1, maxConcurrent);
+    startDownloads();
+}
+
+void PosterDownloader::request(int aid, const QString &picname, Priority priority, bool conditional)
+{
+    if (picname.isEmpty()) {
+        return;
+    }
+    if (m_picnameByAid.value(aid) != picname) {
+        cancel(aid);
+    }
+
+    auto it = m_jobs.find(picname);
+    if (it == m_jobs.end()) {
+        it = m_jobs.insert(picname, Job());
+    }
+    Job &job = it.value();
+    job.aids.insert(aid);
+    if (job.reply && job.conditional && !conditional) {
+        // The running request may end in a 304, which gives this anime nothing
+        job.refetchAids.insert(aid);
+    } else {
+        job.conditional = job.conditional && conditional;
+    }
+    m_picnameByAid.insert(aid, picname);
+    m_priorityByAid.insert(aid, priority);
+
+    if (!job.reply) {
+        job.priority = jobPriority(job);
+        job.sequence = ++m_sequence;
+    }
+    startDownloads();
+}
+
+void PosterDownloader::setPriority(int aid, Priority priority)
+{
+    auto it = m_jobs.find(m_picnameByAid.value(aid));
+    if (it == m_jobs.end()) {
+        return;
+    }
+    m_priorityByAid.insert(aid, priority);
+    if (!it->reply) {
+        it->priority = jobPriority(it.value());
+    }
+}
+
+void PosterDownloader::cancel(int aid)
+{
+    const QString picname = m_picnameByAid.take(aid);
+    m_priorityByAid.remove(aid);
+    auto it = m_jobs.find(picname);
+    if (it == m_jobs.end()) {
+        return;
+    }
+
+    it->aids.remove(aid);
+    it->refetchAids.remove(aid);
+    if (!it->aids.isEmpty()) {
+        it->priority = jobPriority(it.value());
+        return;
+    }
+
+    QNetworkReply *reply = it->reply;
+    m_jobs.erase(it);
+    if (reply) {
+        LOG(QString("[PosterDownloader] Aborting poster download %1, no card waits for it").arg(picname));
+        m_running.remove(reply);
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+        startDownloads();
+    }
+}
+
+int PosterDownloader::queuedCount() const
+{
+    return static_cast<int>(m_jobs.size() - m_running.size());
+}
+
+PosterDownloader::Validators PosterDownloader::validators(const QString &picname)
+{
+    auto it = m_validators.constFind(picname);
+    if (it != m_validators.constEnd()) {
+        return it.value();
+    }
+
+    Validators stored;
+    if (ensureValidatorTable()) {
+        QSqlQuery q(QSqlDatabase::database());
+        q.prepare("SELECT etag, last_modified FROM poster_validators WHERE picname = ?");
+        q.addBindValue(picname);
+        if (q.exec() && q.next()) {
+            stored.etag = q.value(0).toByteArray();
+            stored.lastModified = q.value(1).toByteArray();
+        }
+    }
+    m_validators.insert(picname, stored);
+    return stored;
+}
+
+void PosterDownloader::setValidators(const QString &picname, const Validators &validators)
+{
+    m_validators.insert(picname, validators);
+    if (!ensureValidatorTable()) {
+        return;
+    }
+
+    QSqlQuery q(QSqlDatabase::database());
+    q.prepare("INSERT OR REPLACE INTO poster_validators (picname, etag, last_modified) VALUES (?, ?, ?)");
+    q.addBindValue(picname);
+    q.addBindValue(QString::fromLatin1(validators.etag));
+    q.addBindValue(QString::fromLatin1(validators.lastModified));
+    if (!q.exec()) {
+        LOG(QString("[PosterDownloader] Failed to store validators of %1: %2").arg(picname, q.lastError().text()));
+    }
+}
+
+void PosterDownloader::startDownloads()
+{
+    while (m_running.size() < m_maxConcurrent) {
+        // Thousands of anime can wait; a linear pick per started download is cheap next to the download
+        auto best = m_jobs.end();
+        for (auto it = m_jobs.begin(); it != m_jobs.end(); ++it) {
+            if (it->reply) {
+                continue;
+            }
+            if (best == m_jobs.end() || it->priority > best->priority
+                || (it->priority == best->priority && it->sequence > best->sequence)) {
+                best = it;
+            }
+        }
+        if (best == m_jobs.end()) {
+            return;
+        }
+        startDownload(best.key(), best.value());
+    }
+}
+
+void PosterDownloader::startDownload(const QString &picname, Job &job)
+{
+    const QUrl url = m_baseUrl.resolved(QUrl(picname));
+    LOG(QString("[PosterDownloader] Downloading poster %1 for %2 anime (priority %3)")
+        .arg(url.toString()).arg(job.aids.size()).arg(job.priority));
+
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::UserAgentHeader, "Usagi/1");
+    if (job.conditional) {
+        const Validators known = validators(picname);
+        if (!known.etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", known.etag);
+        }
+        if (!known.lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", known.lastModified);
+        }
+    }
+
+    QNetworkReply *reply = m_network->get(request);
+    job.reply = reply;
+    m_running.insert(reply, picname);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        onReplyFinished(reply);
+    });
+}
+
+void PosterDownloader::onReplyFinished(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    const QString picname = m_running.take(reply);
+    auto it = m_jobs.find(picname);
+    if (picname.isEmpty() || it == m_jobs.end()) {
+        startDownloads();
+        return;
+    }
+
+    // Taken out first: handlers may queue or cancel other posters
+    const Job job = it.value();
+    m_jobs.erase(it);
+    QHash<int, int> refetchPriorities;
+    for (int aid : job.aids) {
+        m_picnameByAid.remove(aid);
+        const int priority = m_priorityByAid.take(aid);
+        if (job.refetchAids.contains(aid)) {
+            refetchPriorities.insert(aid, priority);
+        }
+    }
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 304) {
+        // Queued before the signals go out: a handler may request the same anime
+        for (auto refetch = refetchPriorities.cbegin(); refetch != refetchPriorities.cend(); ++refetch) {
+            request(refetch.key(), picname, static_cast<Priority>(refetch.value()), false);
+        }
+        for (int aid : job.aids) {
+            if (!job.refetchAids.contains(aid)) {
+                emit posterNotModified(aid, picname);
+            }
+        }
+    } else if (reply->error() != QNetworkReply::NoError) {
+        LOG(QString("[PosterDownloader] Poster download %1 failed: %2").arg(picname, reply->errorString()));
+        for (int aid : job.aids) {
+            emit downloadFailed(aid, picname, reply->errorString());
+        }
+    } else {
+        const QByteArray imageData = reply->readAll();
+        Validators received;
+        received.etag = reply->rawHeader("ETag");
+        received.lastModified = reply->rawHeader("Last-Modified");
+        if (!received.isEmpty()) {
+            setValidators(picname, received);
+        }
+        for (int aid : job.aids) {
+            emit posterDownloaded(aid, picname, imageData);
+        }
+    }
+    startDownloads();
+}
+
+int PosterDownloader::jobPriority(const Job &job) const
+{
+    int priority = Background;
+    for (int aid : job.aids) {
+        priority = qMax(priority, m_priorityByAid.value(aid, Background));
+    }
+    return priority;
+}
+
+bool PosterDownloader::ensureValidatorTable()
+{
+    if (m_validatorTableReady) {
+        return true;
+    }
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen()) {
+        return false;
+    }
+
+    QSqlQuery q(db);
+    m_validatorTableReady = q.exec("CREATE TABLE IF NOT EXISTS poster_validators ("
+                                   "picname TEXT PRIMARY KEY,"
+                                   "etag TEXT,"
+                                   "last_modified TEXT"
+                                   ")");
+    if (!m_validatorTableReady) {
+        LOG(QString("[PosterDownloader] Failed to create poster_validators: %1").arg(q.lastError().text()));
+    }
+    return m_validatorTableReady;
+}
@@ -0,0 +1,117 @@
+#ifndef POSTERDOWNLOADER_H
+#define POSTERDOWNLOADER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QUrl>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/**
+ * PosterDownloader - Bounded, prioritized poster downloads from the AniDB image server
+ *
+ * Posters are requested per anime and downloaded per picname: anime sharing a
+ * picname wait on one download. At most maxConcurrent() downloads run at a time;
+ * the rest are queued and started by priority (cards on screen, then cards near
+ * it, then everything else), the newest request first within a priority.
+ * cancel() drops an anime's request, and the download itself once no anime waits
+ * on it, aborting it if it already runs.
+ *
+ * ETag and Last-Modified of every downloaded poster are kept in the
+ * poster_validators table. A conditional request (the caller still has the
+ * poster) sends them back and ends in posterNotModified() on a 304. Anime
+ * without a copy that join a running conditional download are requested
+ * again, unconditionally, when it ends in a 304.
+ */
+class PosterDownloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Background = 0,     // Cards off screen, or no card at all
+        Nearby,             // Cards created in the buffer around the viewport
+        Visible             // Cards on screen and explicit user requests
+    };
+
+    struct Validators {
+        QByteArray etag;
+        QByteArray lastModified;
+        bool isEmpty() const { return etag.isEmpty() && lastModified.isEmpty(); }
+    };
+
+    static constexpr int DEFAULT_MAX_CONCURRENT = 4;
+
+    explicit PosterDownloader(QObject *parent = nullptr);
+    ~PosterDownloader() override;
+
+    // Directory URL the picnames are resolved against (default: AniDB's image server)
+    void setBaseUrl(const QUrl &baseUrl) { m_baseUrl = baseUrl; }
+    QUrl baseUrl() const { return m_baseUrl; }
+
+    // Downloads running at the same time
+    void setMaxConcurrent(int maxConcurrent);
+    int maxConcurrent() const { return m_maxConcurrent; }
+
+    // Queue the poster of an anime. A queued request is re-prioritized; a request for
+    // another picname replaces it. conditional: the caller has a copy to revalidate.
+    void request(int aid, const QString &picname, Priority priority, bool conditional = false);
+
+    // Change the priority of a queued request (no-op if the anime has none)
+    void setPriority(int aid, Priority priority);
+
+    // Drop the request of an anime (the card was evicted or bound to another anime)
+    void cancel(int aid);
+
+    bool isPending(int aid) const { return m_picnameByAid.contains(aid); }
+    int queuedCount() const;
+    int activeCount() const { return static_cast<int>(m_running.size()); }
+
+    // Validators of a picname: memory first, then the poster_validators table
+    Validators validators(const QString &picname);
+    void setValidators(const QString &picname, const Validators &validators);
+
+signals:
+    // One per waiting anime
+    void posterDownloaded(int aid, const QString &picname, const QByteArray &imageData);
+    void posterNotModified(int aid, const QString &picname);
+    void downloadFailed(int aid, const QString &picname, const QString &error);
+
+private:
+    struct Job {
+        QSet<int> aids;
+        int priority = Background;      // Highest priority of the waiting anime
+        quint64 sequence = 0;           // Newer requests are started first
+        bool conditional = true;        // All waiting anime have a copy
+        QSet<int> refetchAids;          // Joined the running conditional download without a copy
+        QNetworkReply *reply = nullptr;
+    };
+
+    // Start the best queued jobs while slots are free
+    void startDownloads();
+    void startDownload(const QString &picname, Job &job);
+    void onReplyFinished(QNetworkReply *reply);
+
+    // Highest priority of the anime waiting on a job
+    int jobPriority(const Job &job) const;
+
+    bool ensureValidatorTable();
+
+    QNetworkAccessManager *m_network;
+    QUrl m_baseUrl;
+    int m_maxConcurrent;
+    quint64 m_sequence;
+    bool m_validatorTableReady;
+
+    QHash<QString, Job> m_jobs;                 // picname -> queued or running download
+    QHash<int, QString> m_picnameByAid;
+    QHash<int, int> m_priorityByAid;
+    QHash<QNetworkReply*, QString> m_running;   // reply -> picname
+    QHash<QString, Validators> m_validators;
+};
+
+#endif // POSTERDOWNLOADER_H
@@ -0,0 +1,373 @@
+#include "relationgraph.h"
+#include <QSet>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <algorithm>
+
+// ---------------------------------------------------------------------------
+// Relations
+// ---------------------------------------------------------------------------
+
+QPair<int, int> RelationGraph::parseRelations(const QString &relaidlist, const QString &relaidtype)
+{
+    int prequelAid = 0;
+    int sequelAid = 0;
+    if (relaidlist.isEmpty() || relaidtype.isEmpty()) {
+        return qMakePair(prequelAid, sequelAid);
+    }
+
+    const QStringList aidList = relaidlist.split('\'', Qt::SkipEmptyParts);
+    const QStringList typeList = relaidtype.split('\'', Qt::SkipEmptyParts);
+    const int count = qMin(aidList.size(), typeList.size());
+    for (int i = 0; i < count; ++i) {
+        const int relAid = aidList[i].toInt();
+        if (relAid <= 0) {
+            continue;
+        }
+        const QString type = typeList[i].trimmed().toLower();
+        if (type == "2" || type.contains("prequel")) {
+            prequelAid = (prequelAid == 0) ? relAid : qMin(prequelAid, relAid);
+        } else if (type == "1" || type.contains("sequel")) {
+            sequelAid = (sequelAid == 0) ? relAid : qMin(sequelAid, relAid);
+        }
+    }
+    return qMakePair(prequelAid, sequelAid);
+}
+
+QList<int> RelationGraph::setRelations(int aid, const QString &relaidlist, const QString &relaidtype)
+{
+    const QPair<int, int> relations = parseRelations(relaidlist, relaidtype);
+    return setRelations(aid, relations.first, relations.second);
+}
+
+QList<int> RelationGraph::setRelations(int aid, int prequelAid, int sequelAid)
+{
+    if (aid <= 0) {
+        return QList<int>();
+    }
+    QMutexLocker locker(&m_mutex);
+
+    const int node = nodeFor(aid);
+    const int prequel = (prequelAid > 0 && prequelAid != aid) ? nodeFor(prequelAid) : NONE;
+    const int sequel = (sequelAid > 0 && sequelAid != aid) ? nodeFor(sequelAid) : NONE;
+
+    if (m_loaded[node] && m_prequel[node] == prequel && m_sequel[node] == sequel) {
+        return QList<int>();
+    }
+    ++m_revision;
+
+    // Every chain that can change: the anime's own and those of its new neighbours
+    QSet<int> roots{findRoot(node)};
+    if (prequel != NONE) {
+        roots.insert(findRoot(prequel));
+    }
+    if (sequel != NONE) {
+        roots.insert(findRoot(sequel));
+    }
+    QList<int> affected;
+    for (int root : std::as_const(roots)) {
+        affected.append(membersOf(root));
+        m_orderCache.remove(root);
+    }
+
+    const bool edgeRemoved = (m_prequel[node] != NONE && m_prequel[node] != prequel)
+                          || (m_sequel[node] != NONE && m_sequel[node] != sequel);
+    m_prequel[node] = prequel;
+    m_sequel[node] = sequel;
+    m_loaded[node] = 1;
+
+    if (prequel != NONE) {
+        unite(node, prequel);
+    }
+    if (sequel != NONE) {
+        unite(node, sequel);
+    }
+    if (edgeRemoved) {
+        // Union-find cannot delete an edge; re-derive just this set from its edges
+        rebuildSet(findRoot(node));
+    }
+    return affected;
+}
+
+void RelationGraph::ensureLoaded(int aid)
+{
+    if (aid <= 0 || isLoaded(aid)) {
+        return;
+    }
+
+    QString relaidlist;
+    QString relaidtype;
+    QSqlDatabase db = QSqlDatabase::database();
+    if (!db.isOpen()) {
+        return;
+    }
+    QSqlQuery q(db);
+    q.prepare("SELECT relaidlist, relaidtype FROM anime WHERE aid = ?");
+    q.addBindValue(aid);
+    if (!q.exec()) {
+        return;
+    }
+    if (q.next()) {
+        relaidlist = q.value(0).toString();
+        relaidtype = q.value(1).toString();
+    }
+    setRelations(aid, relaidlist, relaidtype);
+}
+
+void RelationGraph::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_aid.clear();
+    m_prequel.clear();
+    m_sequel.clear();
+    m_loaded.clear();
+    m_parent.clear();
+    m_nodeOf.clear();
+    m_members.clear();
+    m_orderCache.clear();
+    ++m_revision;
+}
+
+bool RelationGraph::isLoaded(int aid) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int node = m_nodeOf.value(aid, NONE);
+    return node != NONE && m_loaded[node];
+}
+
+int RelationGraph::prequelOf(int aid) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int node = m_nodeOf.value(aid, NONE);
+    return (node != NONE && m_prequel[node] != NONE) ? m_aid[m_prequel[node]] : 0;
+}
+
+int RelationGraph::sequelOf(int aid) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int node = m_nodeOf.value(aid, NONE);
+    return (node != NONE && m_sequel[node] != NONE) ? m_aid[m_sequel[node]] : 0;
+}
+
+int RelationGraph::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_aid.size());
+}
+
+int RelationGraph::chainCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_members.size();
+}
+
+quint64 RelationGraph::revision() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_revision;
+}
+
+// ---------------------------------------------------------------------------
+// Chains
+// ---------------------------------------------------------------------------
+
+bool RelationGraph::sameChain(int aid, int otherAid) const
+{
+    if (aid == otherAid) {
+        return true;
+    }
+    QMutexLocker locker(&m_mutex);
+    const int node = m_nodeOf.value(aid, NONE);
+    const int otherNode = m_nodeOf.value(otherAid, NONE);
+    return node != NONE && otherNode != NONE && findRoot(node) == findRoot(otherNode);
+}
+
+QList<int> RelationGraph::chainOf(int aid) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int node = m_nodeOf.value(aid, NONE);
+    if (node == NONE) {
+        return QList<int>{aid};
+    }
+    return orderedChain(findRoot(node));
+}
+
+QList<QList<int>> RelationGraph::chainsOf(const QList<int> &aids) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<QList<int>> chains;
+    QSet<int> seenRoots;
+    QSet<int> seenUnknown;
+    for (int aid : aids) {
+        const int node = m_nodeOf.value(aid, NONE);
+        if (node == NONE) {
+            if (!seenUnknown.contains(aid)) {
+                seenUnknown.insert(aid);
+                chains.append(QList<int>{aid});
+            }
+            continue;
+        }
+        const int root = findRoot(node);
+        if (!seenRoots.contains(root)) {
+            seenRoots.insert(root);
+            chains.append(orderedChain(root));
+        }
+    }
+    return chains;
+}
+
+// ---------------------------------------------------------------------------
+// Union-find (caller holds m_mutex)
+// ---------------------------------------------------------------------------
+
+int RelationGraph::nodeFor(int aid)
+{
+    auto it = m_nodeOf.constFind(aid);
+    if (it != m_nodeOf.constEnd()) {
+        return it.value();
+    }
+    const int node = static_cast<int>(m_aid.size());
+    m_aid.push_back(aid);
+    m_prequel.push_back(NONE);
+    m_sequel.push_back(NONE);
+    m_loaded.push_back(0);
+    m_parent.push_back(node);
+    m_nodeOf.insert(aid, node);
+    m_members.insert(node, QList<int>{node});
+    return node;
+}
+
+int RelationGraph::findRoot(int node) const
+{
+    while (m_parent[node] != node) {
+        m_parent[node] = m_parent[m_parent[node]];
+        node = m_parent[node];
+    }
+    return node;
+}
+
+void RelationGraph::unite(int node, int otherNode)
+{
+    int root = findRoot(node);
+    int otherRoot = findRoot(otherNode);
+    if (root == otherRoot) {
+        return;
+    }
+    // Union by size: the smaller member list moves
+    if (m_members[root].size() < m_members[otherRoot].size()) {
+        std::swap(root, otherRoot);
+    }
+    m_parent[otherRoot] = root;
+    m_members[root].append(m_members.take(otherRoot));
+    m_orderCache.remove(root);
+    m_orderCache.remove(otherRoot);
+}
+
+void RelationGraph::rebuildSet(int root)
+{
+    const QList<int> members = m_members.take(root);
+    m_orderCache.remove(root);
+    for (int member : members) {
+        m_parent[member] = member;
+        m_members.insert(member, QList<int>{member});
+    }
+    for (int member : members) {
+        if (m_prequel[member] != NONE) {
+            unite(member, m_prequel[member]);
+        }
+        if (m_sequel[member] != NONE) {
+            unite(member, m_sequel[member]);
+        }
+    }
+}
+
+QList<int> RelationGraph::orderedChain(int root) const
+{
+    auto cached = m_orderCache.constFind(root);
+    if (cached != m_orderCache.constEnd()) {
+        return cached.value();
+    }
+
+    const QList<int> members = m_members.value(root);
+    const int count = members.size();
+    QHash<int, int> localIndex;
+    localIndex.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        localIndex.insert(members[i], i);
+    }
+
+    // prequel -> anime and anime -> sequel edges (deduplicated), as AnimeChain::orderChain()
+    std::vector<QList<int>> next(count);
+    std::vector<int> inDegree(count, 0);
+    auto addEdge = [&](int from, int to) {
+        if (!next[from].contains(to)) {
+            next[from].append(to);
+            ++inDegree[to];
+        }
+    };
+    for (int i = 0; i < count; ++i) {
+        const int node = members[i];
+        if (m_sequel[node] != NONE) {
+            addEdge(i, localIndex.value(m_sequel[node]));
+        }
+        if (m_prequel[node] != NONE) {
+            addEdge(localIndex.value(m_prequel[node]), i);
+        }
+    }
+
+    // Sort every list by aid so the order does not depend on how the set was merged
+    auto byAid = [&](int a, int b) { return m_aid[members[a]] < m_aid[members[b]]; };
+    for (QList<int> &sequels : next) {
+        std::sort(sequels.begin(), sequels.end(), byAid);
+    }
+
+    // Kahn's algorithm, roots in aid order
+    QList<int> queue;
+    for (int i = 0; i < count; ++i) {
+        if (inDegree[i] == 0) {
+            queue.append(i);
+        }
+    }
+    std::sort(queue.begin(), queue.end(), byAid);
+
+    QList<int> ordered;
+    ordered.reserve(count);
+    std::vector<quint8> placed(count, 0);
+    for (qsizetype head = 0; head < queue.size(); ++head) {
+        const int current = queue[head];
+        ordered.append(m_aid[members[current]]);
+        placed[current] = 1;
+        for (int sequel : next[current]) {
+            if (--inDegree[sequel] == 0) {
+                queue.append(sequel);
+            }
+        }
+    }
+
+    // Anime on a relation cycle go last, in aid order
+    if (ordered.size() < count) {
+        QList<int> remaining;
+        for (int i = 0; i < count; ++i) {
+            if (!placed[i]) {
+                remaining.append(i);
+            }
+        }
+        std::sort(remaining.begin(), remaining.end(), byAid);
+        for (int i : remaining) {
+            ordered.append(m_aid[members[i]]);
+        }
+    }
+
+    m_orderCache.insert(root, ordered);
+    return ordered;
+}
+
+QList<int> RelationGraph::membersOf(int root) const
+{
+    QList<int> aids;
+    for (int member : m_members.value(root)) {
+        aids.append(m_aid[member]);
+    }
+    return aids;
+}
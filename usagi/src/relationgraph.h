@@ -0,0 +1,113 @@
+#ifndef RELATIONGRAPH_H
+#define RELATIONGRAPH_H
+
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QMutex>
+#include <vector>
+
+/**
+ * @brief RelationGraph - Shared prequel/sequel graph with union-find chain membership
+ *
+ * Holds the prequel and sequel relation of every known anime in flat arrays indexed
+ * by a dense node number, and keeps series-chain membership in a disjoint-set forest
+ * (union by size, path halving). Each set also keeps its member list so a chain can be
+ * listed or rebuilt without touching the rest of the graph.
+ *
+ * Relation updates are incremental:
+ *   - a new edge unions the two chains it connects
+ *   - a removed or changed edge rebuilds only the chain that contained it, which may
+ *     split it into several chains
+ * setRelations() returns the anime whose chain may have changed, so callers can
+ * refresh just those chains.
+ *
+ * Chains are ordered prequel -> sequel with the same rules as AnimeChain::orderChain()
+ * (topological order, ties by aid). Ordered chains are cached per set until it changes.
+ *
+ * MyListCardManager feeds the graph from its card data cache and shares it with
+ * WatchSessionManager, which walks the prequel/sequel links itself. Anime not fed yet
+ * can be loaded lazily from the database. All methods are thread-safe.
+ *
+ * Follows SOLID principles:
+ * - Single Responsibility: Relation storage and chain membership only
+ * - Dependency Inversion: Consumers query chains instead of walking relations themselves
+ *
+ * Usage:
+ *   RelationGraph graph;
+ *   graph.setRelations(2, 1, 3);            // aid 2: prequel 1, sequel 3
+ *   graph.chainOf(3);                       // {1, 2, 3}
+ *   QList<int> changed = graph.setRelations(2, 1, 0);
+ *   graph.chainOf(3);                       // {3}
+ */
+class RelationGraph
+{
+public:
+    RelationGraph() = default;
+    Q_DISABLE_COPY(RelationGraph)
+
+    // ── Relations ──
+
+    // Set the prequel/sequel of an anime (0 = none). Returns the anime whose chain may
+    // have changed (empty if the relations were already known and unchanged).
+    QList<int> setRelations(int aid, int prequelAid, int sequelAid);
+
+    // Same, from AniDB's apostrophe-separated relaidlist/relaidtype columns
+    QList<int> setRelations(int aid, const QString &relaidlist, const QString &relaidtype);
+
+    // Load the relations of an anime from the database unless already known.
+    // Anime without a database row are recorded as having no relations.
+    void ensureLoaded(int aid);
+
+    void clear();
+
+    bool isLoaded(int aid) const;
+    int prequelOf(int aid) const;
+    int sequelOf(int aid) const;
+    int size() const;
+    int chainCount() const;
+
+    // Incremented whenever a relation changes or the graph is cleared
+    quint64 revision() const;
+
+    // ── Chains ──
+
+    bool sameChain(int aid, int otherAid) const;
+
+    // Ordered chain containing the anime ({aid} for unknown anime)
+    QList<int> chainOf(int aid) const;
+
+    // Distinct chains containing the given anime, in order of first appearance
+    QList<QList<int>> chainsOf(const QList<int> &aids) const;
+
+    // Prequel and sequel aid from AniDB relation columns. Accepts type codes (2 = prequel,
+    // 1 = sequel) and type names; the lowest aid wins if several are listed.
+    static QPair<int, int> parseRelations(const QString &relaidlist, const QString &relaidtype);
+
+private:
+    static constexpr int NONE = -1;
+
+    int nodeFor(int aid);
+    int findRoot(int node) const;
+    void unite(int node, int otherNode);
+    void rebuildSet(int root);
+    QList<int> orderedChain(int root) const;
+    QList<int> membersOf(int root) const;
+
+    // Node columns
+    std::vector<int> m_aid;
+    std::vector<int> m_prequel;             // node index or NONE
+    std::vector<int> m_sequel;              // node index or NONE
+    std::vector<quint8> m_loaded;           // relations of this anime are known
+    mutable std::vector<int> m_parent;      // union-find parent (path halving in findRoot)
+
+    QHash<int, int> m_nodeOf;               // aid -> node
+    QHash<int, QList<int>> m_members;       // set root -> member nodes
+    mutable QHash<int, QList<int>> m_orderCache;  // set root -> ordered aids
+    quint64 m_revision = 0;
+
+    mutable QMutex m_mutex;
+};
+
+#endif // RELATIONGRAPH_H
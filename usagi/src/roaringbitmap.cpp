@@ -0,0 +1,368 @@
+#include "roaringbitmap.h"
+#include <algorithm>
+#include <iterator>
+
+// ---------------------------------------------------------------------------
+// Container helpers
+// ---------------------------------------------------------------------------
+
+void RoaringBitmap::toBitmap(Container &c)
+{
+    c.bits.assign(BITMAP_WORDS, 0);
+    for (quint16 low : c.array) {
+        c.bits[low >> 6] |= quint64(1) << (low & 63);
+    }
+    c.array.clear();
+    c.array.shrink_to_fit();
+}
+
+void RoaringBitmap::toArray(Container &c)
+{
+    std::vector<quint16> values;
+    values.reserve(c.cardinality);
+    for (int w = 0; w < BITMAP_WORDS; ++w) {
+        quint64 word = c.bits[w];
+        while (word) {
+            values.push_back(static_cast<quint16>(w * 64 + qCountTrailingZeroBits(word)));
+            word &= word - 1;
+        }
+    }
+    c.array = std::move(values);
+    c.bits.clear();
+    c.bits.shrink_to_fit();
+}
+
+// Pick the representation that matches the cardinality
+void RoaringBitmap::normalize(Container &c)
+{
+    if (c.isBitmap() && c.cardinality <= ARRAY_MAX) {
+        toArray(c);
+    } else if (!c.isBitmap() && c.cardinality > ARRAY_MAX) {
+        toBitmap(c);
+    }
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container &a, const Container &b)
+{
+    Container out;
+    out.key = a.key;
+
+    if (a.isBitmap() && b.isBitmap()) {
+        out.bits.resize(BITMAP_WORDS);
+        quint32 count = 0;
+        for (int w = 0; w < BITMAP_WORDS; ++w) {
+            out.bits[w] = a.bits[w] & b.bits[w];
+            count += qPopulationCount(out.bits[w]);
+        }
+        out.cardinality = count;
+        normalize(out);
+        return out;
+    }
+
+    if (a.isBitmap() || b.isBitmap()) {
+        const Container &arr = a.isBitmap() ? b : a;
+        const Container &bmp = a.isBitmap() ? a : b;
+        out.array.reserve(arr.array.size());
+        for (quint16 low : arr.array) {
+            if (bmp.bits[low >> 6] & (quint64(1) << (low & 63))) {
+                out.array.push_back(low);
+            }
+        }
+    } else {
+        out.array.reserve(std::min(a.array.size(), b.array.size()));
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(out.array));
+    }
+    out.cardinality = static_cast<quint32>(out.array.size());
+    return out;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container &a, const Container &b)
+{
+    Container out;
+    out.key = a.key;
+
+    if (!a.isBitmap() && !b.isBitmap() && a.array.size() + b.array.size() <= ARRAY_MAX) {
+        out.array.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(out.array));
+        out.cardinality = static_cast<quint32>(out.array.size());
+        return out;
+    }
+
+    out.bits.assign(BITMAP_WORDS, 0);
+    for (const Container *src : {&a, &b}) {
+        if (src->isBitmap()) {
+            for (int w = 0; w < BITMAP_WORDS; ++w) {
+                out.bits[w] |= src->bits[w];
+            }
+        } else {
+            for (quint16 low : src->array) {
+                out.bits[low >> 6] |= quint64(1) << (low & 63);
+            }
+        }
+    }
+    quint32 count = 0;
+    for (int w = 0; w < BITMAP_WORDS; ++w) {
+        count += qPopulationCount(out.bits[w]);
+    }
+    out.cardinality = count;
+    normalize(out);
+    return out;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container &a, const Container &b)
+{
+    Container out;
+    out.key = a.key;
+
+    if (!a.isBitmap()) {
+        out.array.reserve(a.array.size());
+        if (b.isBitmap()) {
+            for (quint16 low : a.array) {
+                if (!(b.bits[low >> 6] & (quint64(1) << (low & 63)))) {
+                    out.array.push_back(low);
+                }
+            }
+        } else {
+            std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                std::back_inserter(out.array));
+        }
+        out.cardinality = static_cast<quint32>(out.array.size());
+        return out;
+    }
+
+    out.bits = a.bits;
+    if (b.isBitmap()) {
+        for (int w = 0; w < BITMAP_WORDS; ++w) {
+            out.bits[w] &= ~b.bits[w];
+        }
+    } else {
+        for (quint16 low : b.array) {
+            out.bits[low >> 6] &= ~(quint64(1) << (low & 63));
+        }
+    }
+    quint32 count = 0;
+    for (int w = 0; w < BITMAP_WORDS; ++w) {
+        count += qPopulationCount(out.bits[w]);
+    }
+    out.cardinality = count;
+    normalize(out);
+    return out;
+}
+
+int RoaringBitmap::findContainer(quint16 key) const
+{
+    auto it = std::lower_bound(m_containers.begin(), m_containers.end(), key,
+                               [](const Container &c, quint16 k) { return c.key < k; });
+    if (it != m_containers.end() && it->key == key) {
+        return static_cast<int>(it - m_containers.begin());
+    }
+    return -1;
+}
+
+// ---------------------------------------------------------------------------
+// Point operations
+// ---------------------------------------------------------------------------
+
+RoaringBitmap RoaringBitmap::fromList(const QList<int> &values)
+{
+    RoaringBitmap bitmap;
+    for (int value : values) {
+        if (value >= 0) {
+            bitmap.add(static_cast<quint32>(value));
+        }
+    }
+    return bitmap;
+}
+
+void RoaringBitmap::add(quint32 value)
+{
+    const quint16 key = static_cast<quint16>(value >> 16);
+    const quint16 low = static_cast<quint16>(value & 0xFFFF);
+
+    // Fast path for ascending inserts (bulk loading by aid)
+    auto it = (!m_containers.empty() && m_containers.back().key <= key)
+        ? m_containers.end() - (m_containers.back().key == key ? 1 : 0)
+        : std::lower_bound(m_containers.begin(), m_containers.end(), key,
+                           [](const Container &c, quint16 k) { return c.key < k; });
+    if (it == m_containers.end() || it->key != key) {
+        Container c;
+        c.key = key;
+        it = m_containers.insert(it, std::move(c));
+    }
+
+    Container &c = *it;
+    if (c.isBitmap()) {
+        quint64 &word = c.bits[low >> 6];
+        const quint64 mask = quint64(1) << (low & 63);
+        if (!(word & mask)) {
+            word |= mask;
+            ++c.cardinality;
+        }
+        return;
+    }
+
+    auto pos = (c.array.empty() || c.array.back() < low)
+        ? c.array.end()
+        : std::lower_bound(c.array.begin(), c.array.end(), low);
+    if (pos != c.array.end() && *pos == low) {
+        return;
+    }
+    c.array.insert(pos, low);
+    ++c.cardinality;
+    normalize(c);
+}
+
+bool RoaringBitmap::remove(quint32 value)
+{
+    const int index = findContainer(static_cast<quint16>(value >> 16));
+    if (index < 0) {
+        return false;
+    }
+    Container &c = m_containers[index];
+    const quint16 low = static_cast<quint16>(value & 0xFFFF);
+
+    if (c.isBitmap()) {
+        quint64 &word = c.bits[low >> 6];
+        const quint64 mask = quint64(1) << (low & 63);
+        if (!(word & mask)) {
+            return false;
+        }
+        word &= ~mask;
+        --c.cardinality;
+    } else {
+        auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (pos == c.array.end() || *pos != low) {
+            return false;
+        }
+        c.array.erase(pos);
+        --c.cardinality;
+    }
+
+    if (c.cardinality == 0) {
+        m_containers.erase(m_containers.begin() + index);
+    } else {
+        normalize(c);
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(quint32 value) const
+{
+    const int index = findContainer(static_cast<quint16>(value >> 16));
+    if (index < 0) {
+        return false;
+    }
+    const Container &c = m_containers[index];
+    const quint16 low = static_cast<quint16>(value & 0xFFFF);
+    if (c.isBitmap()) {
+        return c.bits[low >> 6] & (quint64(1) << (low & 63));
+    }
+    return std::binary_search(c.array.begin(), c.array.end(), low);
+}
+
+quint64 RoaringBitmap::cardinality() const
+{
+    quint64 total = 0;
+    for (const Container &c : m_containers) {
+        total += c.cardinality;
+    }
+    return total;
+}
+
+int RoaringBitmap::bitmapContainerCount() const
+{
+    return static_cast<int>(std::count_if(m_containers.begin(), m_containers.end(),
+                                          [](const Container &c) { return c.isBitmap(); }));
+}
+
+QList<int> RoaringBitmap::toList() const
+{
+    QList<int> values;
+    values.reserve(static_cast<qsizetype>(cardinality()));
+    forEach([&values](quint32 value) { values.append(static_cast<int>(value)); });
+    return values;
+}
+
+// ---------------------------------------------------------------------------
+// Set operations
+// ---------------------------------------------------------------------------
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap &other) const
+{
+    RoaringBitmap result;
+    auto a = m_containers.begin();
+    auto b = other.m_containers.begin();
+    while (a != m_containers.end() && b != other.m_containers.end()) {
+        if (a->key < b->key) {
+            ++a;
+        } else if (b->key < a->key) {
+            ++b;
+        } else {
+            Container c = intersect(*a, *b);
+            if (c.cardinality > 0) {
+                result.m_containers.push_back(std::move(c));
+            }
+            ++a;
+            ++b;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap &other) const
+{
+    RoaringBitmap result;
+    result.m_containers.reserve(m_containers.size() + other.m_containers.size());
+    auto a = m_containers.begin();
+    auto b = other.m_containers.begin();
+    while (a != m_containers.end() || b != other.m_containers.end()) {
+        if (b == other.m_containers.end() || (a != m_containers.end() && a->key < b->key)) {
+            result.m_containers.push_back(*a++);
+        } else if (a == m_containers.end() || b->key < a->key) {
+            result.m_containers.push_back(*b++);
+        } else {
+            result.m_containers.push_back(unite(*a, *b));
+            ++a;
+            ++b;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::andNot(const RoaringBitmap &other) const
+{
+    RoaringBitmap result;
+    auto b = other.m_containers.begin();
+    for (const Container &a : m_containers) {
+        while (b != other.m_containers.end() && b->key < a.key) {
+            ++b;
+        }
+        if (b == other.m_containers.end() || b->key != a.key) {
+            result.m_containers.push_back(a);
+            continue;
+        }
+        Container c = subtract(a, *b);
+        if (c.cardinality > 0) {
+            result.m_containers.push_back(std::move(c));
+        }
+    }
+    return result;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap &other) const
+{
+    if (m_containers.size() != other.m_containers.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < m_containers.size(); ++i) {
+        const Container &a = m_containers[i];
+        const Container &b = other.m_containers[i];
+        // Containers are always normalized, so equal sets share a representation
+        if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array || a.bits != b.bits) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,107 @@
+#ifndef ROARINGBITMAP_H
+#define ROARINGBITMAP_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QtAlgorithms>
+#include <vector>
+
+/**
+ * @brief RoaringBitmap - Compressed set of non-negative 32-bit integers (anime IDs)
+ *
+ * Follows the Roaring bitmap layout: values are split into a 16-bit high part
+ * selecting a container and a 16-bit low part stored inside it. A container is
+ *   - an array container (sorted quint16 values) while it holds <= 4096 values, or
+ *   - a bitmap container (65536 bits = 1024 x quint64) above that.
+ * Sparse sets stay small, dense sets get word-at-a-time AND/OR/ANDNOT.
+ *
+ * Only the operations the filter index needs are implemented: point updates,
+ * membership, cardinality, intersection, union, difference and ordered iteration.
+ *
+ * Usage:
+ *   RoaringBitmap tv;  tv.add(1); tv.add(42);
+ *   RoaringBitmap adult; adult.add(42);
+ *   RoaringBitmap result = tv.andNot(adult);   // {1}
+ *   result.forEach([](quint32 aid) { ... });
+ */
+class RoaringBitmap
+{
+public:
+    RoaringBitmap() = default;
+
+    static RoaringBitmap fromList(const QList<int> &values);
+
+    // ── Point operations ──
+    void add(quint32 value);
+    bool remove(quint32 value);
+    bool contains(quint32 value) const;
+    void clear() { m_containers.clear(); }
+
+    bool isEmpty() const { return m_containers.empty(); }
+    quint64 cardinality() const;
+
+    // ── Set operations ──
+    RoaringBitmap operator&(const RoaringBitmap &other) const;
+    RoaringBitmap operator|(const RoaringBitmap &other) const;
+    RoaringBitmap andNot(const RoaringBitmap &other) const;
+    RoaringBitmap &operator&=(const RoaringBitmap &other) { return *this = *this & other; }
+    RoaringBitmap &operator|=(const RoaringBitmap &other) { return *this = *this | other; }
+
+    bool operator==(const RoaringBitmap &other) const;
+    bool operator!=(const RoaringBitmap &other) const { return !(*this == other); }
+
+    // ── Iteration (ascending order) ──
+    template<typename Func>
+    void forEach(Func func) const
+    {
+        for (const Container &c : m_containers) {
+            const quint32 base = quint32(c.key) << 16;
+            if (c.isBitmap()) {
+                for (int w = 0; w < BITMAP_WORDS; ++w) {
+                    quint64 word = c.bits[w];
+                    while (word) {
+                        func(base | quint32(w * 64 + qCountTrailingZeroBits(word)));
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (quint16 low : c.array) {
+                    func(base | low);
+                }
+            }
+        }
+    }
+
+    QList<int> toList() const;
+
+    // Number of containers (exposed for tests)
+    int containerCount() const { return static_cast<int>(m_containers.size()); }
+    int bitmapContainerCount() const;
+
+    static constexpr quint32 ARRAY_MAX = 4096;
+    static constexpr int BITMAP_WORDS = 1024;
+
+private:
+    struct Container {
+        quint16 key = 0;
+        quint32 cardinality = 0;
+        std::vector<quint16> array;   // sorted; used while cardinality <= ARRAY_MAX
+        std::vector<quint64> bits;    // BITMAP_WORDS words otherwise
+
+        bool isBitmap() const { return !bits.empty(); }
+    };
+
+    static void toBitmap(Container &c);
+    static void toArray(Container &c);
+    static void normalize(Container &c);
+
+    static Container intersect(const Container &a, const Container &b);
+    static Container unite(const Container &a, const Container &b);
+    static Container subtract(const Container &a, const Container &b);
+
+    int findContainer(quint16 key) const;
+
+    std::vector<Container> m_containers;  // sorted by key
+};
+
+#endif // ROARINGBITMAP_H
@@ -0,0 +1,85 @@
+#include "spaceforecast.h"
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// Events
+// ---------------------------------------------------------------------------
+
+void SpaceForecast::recordInflow(qint64 nowMs, qint64 bytes)
+{
+    m_pendingInflow += qMax<qint64>(bytes, 0);
+    noteActivity(nowMs);
+}
+
+void SpaceForecast::recordOutflow(qint64 nowMs, qint64 bytes)
+{
+    Q_UNUSED(nowMs);
+    m_pendingOutflow += qMax<qint64>(bytes, 0);
+}
+
+void SpaceForecast::noteActivity(qint64 nowMs)
+{
+    m_lastActivityMs = qMax(m_lastActivityMs, nowMs);
+}
+
+// ---------------------------------------------------------------------------
+// Rates
+// ---------------------------------------------------------------------------
+
+void SpaceForecast::advance(qint64 nowMs)
+{
+    if (m_lastAdvanceMs < 0) {
+        // First tick only starts the clock; pending bytes are counted in the next window
+        m_lastAdvanceMs = nowMs;
+        return;
+    }
+    const qint64 elapsedMs = nowMs - m_lastAdvanceMs;
+    if (elapsedMs <= 0) {
+        return;
+    }
+
+    // Irregular intervals: weight the window by how much of the time constant it covers
+    const double alpha = 1.0 - std::exp(-static_cast<double>(elapsedMs) / RATE_TIME_CONSTANT_MS);
+    const double seconds = elapsedMs / 1000.0;
+    m_inflowRate  += alpha * (m_pendingInflow / seconds - m_inflowRate);
+    m_outflowRate += alpha * (m_pendingOutflow / seconds - m_outflowRate);
+
+    m_pendingInflow = 0;
+    m_pendingOutflow = 0;
+    m_lastAdvanceMs = nowMs;
+}
+
+// ---------------------------------------------------------------------------
+// Forecast
+// ---------------------------------------------------------------------------
+
+bool SpaceForecast::isIdle(qint64 nowMs) const
+{
+    if (m_playbackActive) {
+        return false;
+    }
+    return m_lastActivityMs < 0 || nowMs - m_lastActivityMs >= IDLE_AFTER_MS;
+}
+
+qint64 SpaceForecast::secondsUntilThreshold(qint64 availableBytes, qint64 thresholdBytes) const
+{
+    if (availableBytes < thresholdBytes) {
+        return 0;
+    }
+    const double rate = netRate();
+    if (rate <= 0.0) {
+        return -1;
+    }
+    // Capped so a near-zero rate cannot overflow the conversion
+    const double seconds = (availableBytes - thresholdBytes) / rate;
+    return static_cast<qint64>(qMin(seconds, 1e15));
+}
+
+bool SpaceForecast::shouldDeleteAhead(qint64 nowMs, qint64 availableBytes, qint64 thresholdBytes) const
+{
+    if (availableBytes < thresholdBytes || !isIdle(nowMs)) {
+        return false;
+    }
+    const qint64 seconds = secondsUntilThreshold(availableBytes, thresholdBytes);
+    return seconds >= 0 && seconds <= HORIZON_SECS;
+}
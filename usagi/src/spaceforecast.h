@@ -0,0 +1,65 @@
+#ifndef SPACEFORECAST_H
+#define SPACEFORECAST_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Forecast of when free space on the watched drive crosses the deletion threshold.
+ *
+ * Tracks the rate at which new files arrive (directory watcher) and space is
+ * freed (deletions) as exponentially weighted averages, and when the drive was
+ * last busy (new files, hashing, playback). WatchSessionManager uses it to start
+ * small deletion batches while the drive is idle, before the threshold is reached,
+ * instead of only after the disk is full.
+ *
+ * Plain value type; every call takes the current time in milliseconds so the
+ * model can be driven from a timer or from a test.
+ */
+class SpaceForecast
+{
+public:
+    /// Time constant of the rate averages: an hour of history dominates
+    static constexpr qint64 RATE_TIME_CONSTANT_MS = 60 * 60 * 1000;
+    /// The drive counts as idle after this long without activity
+    static constexpr qint64 IDLE_AFTER_MS = 5 * 60 * 1000;
+    /// Delete ahead when the threshold is expected within this many seconds
+    static constexpr qint64 HORIZON_SECS = 12 * 60 * 60;
+
+    /// New files of @p bytes arrived (also counts as activity).
+    void recordInflow(qint64 nowMs, qint64 bytes);
+    /// A deletion freed @p bytes.
+    void recordOutflow(qint64 nowMs, qint64 bytes);
+    /// Disk I/O that deletion should not compete with (hashing, scanning).
+    void noteActivity(qint64 nowMs);
+    void setPlaybackActive(bool active) { m_playbackActive = active; }
+    bool isPlaybackActive() const { return m_playbackActive; }
+
+    /// Fold the bytes recorded since the last call into the rate averages.
+    void advance(qint64 nowMs);
+
+    /// Averaged rates in bytes per second.
+    double inflowRate() const { return m_inflowRate; }
+    double outflowRate() const { return m_outflowRate; }
+    double netRate() const { return m_inflowRate - m_outflowRate; }
+
+    /// No playback and no activity for IDLE_AFTER_MS.
+    bool isIdle(qint64 nowMs) const;
+
+    /// Seconds until @p availableBytes drops to @p thresholdBytes at the net rate;
+    /// 0 if already below, -1 if space is not shrinking.
+    qint64 secondsUntilThreshold(qint64 availableBytes, qint64 thresholdBytes) const;
+
+    /// Above the threshold, idle, and the threshold is expected within HORIZON_SECS.
+    bool shouldDeleteAhead(qint64 nowMs, qint64 availableBytes, qint64 thresholdBytes) const;
+
+private:
+    double m_inflowRate = 0.0;
+    double m_outflowRate = 0.0;
+    qint64 m_pendingInflow = 0;     ///< Bytes since the last advance()
+    qint64 m_pendingOutflow = 0;
+    qint64 m_lastAdvanceMs = -1;
+    qint64 m_lastActivityMs = -1;   ///< -1: no activity seen yet
+    bool m_playbackActive = false;
+};
+
+#endif // SPACEFORECAST_H
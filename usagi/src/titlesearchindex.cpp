@@ -0,0 +1,135 @@
+#include "titlesearchindex.h"
+#include <QSet>
+#include <algorithm>
+
+QList<quint64> TitleSearchIndex::trigramsOf(const QString &lowerText)
+{
+    QSet<quint64> unique;
+    for (qsizetype i = 0; i + 3 <= lowerText.size(); ++i) {
+        // Three UTF-16 code units packed into 48 bits
+        const quint64 trigram = (quint64(lowerText.at(i).unicode()) << 32)
+                              | (quint64(lowerText.at(i + 1).unicode()) << 16)
+                              | quint64(lowerText.at(i + 2).unicode());
+        unique.insert(trigram);
+    }
+    return QList<quint64>(unique.cbegin(), unique.cend());
+}
+
+bool TitleSearchIndex::anyContains(const QStringList &lowerTitles, const QString &lowerText)
+{
+    for (const QString &title : lowerTitles) {
+        if (title.contains(lowerText)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TitleSearchIndex::setTitles(int aid, const QStringList &titles)
+{
+    if (aid <= 0) {
+        return;
+    }
+    remove(aid);
+
+    QStringList lowerTitles;
+    lowerTitles.reserve(titles.size());
+    QSet<quint64> trigrams;
+    for (const QString &title : titles) {
+        const QString lower = title.toLower();
+        for (quint64 trigram : trigramsOf(lower)) {
+            trigrams.insert(trigram);
+        }
+        lowerTitles.append(lower);
+    }
+
+    for (quint64 trigram : std::as_const(trigrams)) {
+        m_trigrams[trigram].add(static_cast<quint32>(aid));
+    }
+    m_titles.insert(aid, lowerTitles);
+    m_all.add(static_cast<quint32>(aid));
+}
+
+void TitleSearchIndex::remove(int aid)
+{
+    auto it = m_titles.find(aid);
+    if (it == m_titles.end()) {
+        return;
+    }
+
+    for (const QString &title : std::as_const(it.value())) {
+        for (quint64 trigram : trigramsOf(title)) {
+            auto bitmap = m_trigrams.find(trigram);
+            if (bitmap != m_trigrams.end()) {
+                bitmap->remove(static_cast<quint32>(aid));
+                if (bitmap->isEmpty()) {
+                    m_trigrams.erase(bitmap);
+                }
+            }
+        }
+    }
+    m_titles.erase(it);
+    m_all.remove(static_cast<quint32>(aid));
+}
+
+void TitleSearchIndex::clear()
+{
+    m_titles.clear();
+    m_trigrams.clear();
+    m_all.clear();
+}
+
+bool TitleSearchIndex::matches(int aid, const QString &text) const
+{
+    if (text.isEmpty()) {
+        return true;
+    }
+    auto it = m_titles.constFind(aid);
+    if (it == m_titles.constEnd()) {
+        return false;
+    }
+    return anyContains(it.value(), text.toLower());
+}
+
+RoaringBitmap TitleSearchIndex::search(const QString &text, const RoaringBitmap *within) const
+{
+    if (text.isEmpty()) {
+        return within ? (m_all & *within) : m_all;
+    }
+    const QString lower = text.toLower();
+
+    RoaringBitmap candidates;
+    const QList<quint64> trigrams = trigramsOf(lower);
+    if (trigrams.isEmpty()) {
+        // Too short for the trigram index
+        candidates = within ? (m_all & *within) : m_all;
+    } else {
+        // Intersect the rarest trigrams first to keep intermediate sets small
+        QList<const RoaringBitmap*> bitmaps;
+        bitmaps.reserve(trigrams.size());
+        for (quint64 trigram : trigrams) {
+            auto it = m_trigrams.constFind(trigram);
+            if (it == m_trigrams.constEnd()) {
+                return RoaringBitmap();
+            }
+            bitmaps.append(&it.value());
+        }
+        std::sort(bitmaps.begin(), bitmaps.end(), [](const RoaringBitmap *a, const RoaringBitmap *b) {
+            return a->cardinality() < b->cardinality();
+        });
+
+        candidates = within ? (*bitmaps.first() & *within) : *bitmaps.first();
+        for (qsizetype i = 1; i < bitmaps.size() && !candidates.isEmpty(); ++i) {
+            candidates &= *bitmaps.at(i);
+        }
+    }
+
+    // Trigram hits are only candidates (trigrams may appear in different titles or order)
+    RoaringBitmap result;
+    candidates.forEach([&](quint32 aid) {
+        if (anyContains(m_titles.value(static_cast<int>(aid)), lower)) {
+            result.add(aid);
+        }
+    });
+    return result;
+}
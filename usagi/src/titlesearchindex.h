@@ -0,0 +1,55 @@
+#ifndef TITLESEARCHINDEX_H
+#define TITLESEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include "roaringbitmap.h"
+
+/**
+ * @brief TitleSearchIndex - Trigram index for case-insensitive substring search over anime titles
+ *
+ * Each anime has a list of titles. Every 3-character sequence (trigram) of every
+ * lowercased title maps to a RoaringBitmap of the anime IDs containing it. A search
+ * for text of at least three characters intersects the bitmaps of the text's
+ * trigrams to get a small candidate set and then verifies each candidate with a
+ * plain substring check, so results are exact. Shorter text verifies every anime
+ * (optionally restricted to a caller-provided set).
+ *
+ * Matching uses QString::toLower() on both sides, as AnimeMetadataCache always did.
+ *
+ * Usage:
+ *   TitleSearchIndex index;
+ *   index.setTitles(1, {"Cowboy Bebop", "Kauboi Bibappu"});
+ *   RoaringBitmap hits = index.search("bebop");   // {1}
+ */
+class TitleSearchIndex
+{
+public:
+    TitleSearchIndex() = default;
+
+    // Add or replace the titles of an anime
+    void setTitles(int aid, const QStringList &titles);
+    void remove(int aid);
+    void clear();
+
+    bool contains(int aid) const { return m_titles.contains(aid); }
+    int size() const { return m_titles.size(); }
+    const RoaringBitmap &all() const { return m_all; }
+
+    // True if any title of the anime contains the text (empty text matches everything)
+    bool matches(int aid, const QString &text) const;
+
+    // Anime whose titles contain the text. If 'within' is given, only those anime are considered.
+    RoaringBitmap search(const QString &text, const RoaringBitmap *within = nullptr) const;
+
+private:
+    static QList<quint64> trigramsOf(const QString &lowerText);
+    static bool anyContains(const QStringList &lowerTitles, const QString &lowerText);
+
+    QHash<int, QStringList> m_titles;           // aid -> lowercased titles
+    QHash<quint64, RoaringBitmap> m_trigrams;   // trigram -> anime IDs
+    RoaringBitmap m_all;
+};
+
+#endif // TITLESEARCHINDEX_H
@@ -538,7 +538,8 @@ void VirtualFlowLayout::updateVisibleItems()
     // 2. updateVisibleItems is typically called right after calculateLayout from the same entry point
     // 3. If called from a recursive event, calculateLayout's guard will block the chain
     
-    if (!m_itemFactory || m_itemCount == 0) {
+    // An explicitly hidden layout (replaced by the painted card grid) creates no widgets
+    if (!m_itemFactory || m_itemCount == 0 || isHidden()) {
         return;
     }
     
@@ -633,6 +634,17 @@ void VirtualFlowLayout::getVisibleRange(int &firstVisible, int &lastVisible) con
     lastVisible = qMin(m_itemCount - 1, (lastRow + 1) * m_columnsPerRow - 1);
 }
 
+int VirtualFlowLayout::visibleCapacity() const
+{
+    if (m_columnsPerRow == 0 || m_rowHeight <= 0) {
+        return 0;
+    }
+    
+    // A viewport can show a partial row at the top and at the bottom
+    int viewportRows = visibleRect().height() / m_rowHeight + 2;
+    return (viewportRows + 2 * BUFFER_ROWS) * m_columnsPerRow;
+}
+
 QWidget* VirtualFlowLayout::createOrReuseWidget(int index)
 {
     if (index < 0 || index >= m_itemCount || !m_itemFactory) {
@@ -681,8 +693,9 @@ void VirtualFlowLayout::recycleWidget(int index)
     
     if (widget) {
         // Just hide the widget - don't delete it
-        // The card manager keeps it in its cache and we'll reuse it when scrolling back
+        // The card manager keeps it in its cache and may reuse it when scrolling back
         widget->hide();
+        emit widgetRecycled(index, -1, widget);
     }
 }
 
@@ -84,11 +84,15 @@ public:
     // Get visible widgets (for arrow overlay)
     const QMap<int, QWidget*>& getVisibleWidgets() const { return m_visibleWidgets; }
     
+    // Number of widgets that fill the viewport plus the buffer rows (0 before the first layout)
+    int visibleCapacity() const;
+    
 signals:
     // Emitted when a visible item's widget is created
     void widgetCreated(int index, QWidget *widget);
     
-    // Emitted when a widget is about to be recycled (reused for another item)
+    // Emitted when a widget is recycled (reused for another item);
+    // newIndex is -1 when the widget only left the visible range and was hidden
     void widgetRecycled(int oldIndex, int newIndex, QWidget *widget);
     
 protected:
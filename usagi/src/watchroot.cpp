@@ -0,0 +1,95 @@
+#include "watchroot.h"
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+bool WatchRoot::operator==(const WatchRoot &other) const
+{
+    return path == other.path
+        && scanIntervalSecs == other.scanIntervalSecs
+        && stabilityDelaySecs == other.stabilityDelaySecs
+        && maxHashers == other.maxHashers
+        && priority == other.priority;
+}
+
+QString WatchRoot::toJson(const QList<WatchRoot> &roots)
+{
+    QJsonArray array;
+    for (const WatchRoot &root : roots) {
+        QJsonObject object;
+        object["path"] = root.path;
+        object["scanInterval"] = root.scanIntervalSecs;
+        object["stabilityDelay"] = root.stabilityDelaySecs;
+        object["maxHashers"] = root.maxHashers;
+        object["priority"] = root.priority;
+        array.append(object);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+
+QList<WatchRoot> WatchRoot::fromJson(const QString &json)
+{
+    QList<WatchRoot> roots;
+    const QJsonDocument document = QJsonDocument::fromJson(json.toUtf8());
+    if (!document.isArray()) {
+        return roots;
+    }
+    const QJsonArray array = document.array();
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        const QString path = object.value("path").toString();
+        if (path.isEmpty()) {
+            continue;
+        }
+        WatchRoot root;
+        root.path = QDir::cleanPath(path);
+        root.scanIntervalSecs = qMax(0, object.value("scanInterval").toInt(0));
+        root.stabilityDelaySecs = qMax(0, object.value("stabilityDelay").toInt(DEFAULT_STABILITY_DELAY_SECS));
+        root.maxHashers = qMax(0, object.value("maxHashers").toInt(0));
+        root.priority = object.value("priority").toInt(0);
+        roots.append(root);
+    }
+    return roots;
+}
+
+namespace {
+
+// True if @p path lies below @p rootPath (not for name-prefix siblings such as /a/bc of /a/b)
+bool isBelow(const QString &path, const QString &rootPath)
+{
+    if (rootPath.isEmpty()) {
+        return false;
+    }
+    return rootPath.endsWith('/')
+        ? path.startsWith(rootPath) && path.size() > rootPath.size()
+        : path.startsWith(rootPath) && path.size() > rootPath.size() && path.at(rootPath.size()) == '/';
+}
+
+} // namespace
+
+int WatchRoot::indexOf(const QList<WatchRoot> &roots, const QString &filePath)
+{
+    int best = -1;
+    for (int i = 0; i < roots.size(); ++i) {
+        const QString &rootPath = roots.at(i).path;
+        if (isBelow(filePath, rootPath) && (best < 0 || rootPath.size() > roots.at(best).path.size())) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+QStringList WatchRoot::nestedRoots(const QList<WatchRoot> &roots, int index)
+{
+    QStringList nested;
+    if (index < 0 || index >= roots.size()) {
+        return nested;
+    }
+    for (const WatchRoot &root : roots) {
+        if (isBelow(root.path, roots.at(index).path) && !nested.contains(root.path)) {
+            nested.append(root.path);
+        }
+    }
+    return nested;
+}
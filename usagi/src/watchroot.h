@@ -0,0 +1,47 @@
+#ifndef WATCHROOT_H
+#define WATCHROOT_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief One watched directory tree and how its files are scanned and hashed.
+ *
+ * DirectoryWatcherManager runs one DirectoryWatcher per root, so a slow network
+ * mount scans on its own thread and at its own interval. HashingJobModel::nextToHash()
+ * uses the same list to decide which waiting file a free hasher thread gets:
+ *   - A root with maxHashers > 0 never has more files than that hashed at once;
+ *     a NAS root limited to one thread leaves the others to the local roots.
+ *   - Among the files whose root is below its cap, the highest priority wins;
+ *     equal priorities keep the hasher table order.
+ * Files that are not below any root (added by hand) have priority 0 and no cap.
+ *
+ * Persisted as a JSON array in the "watcherRoots" setting.
+ */
+struct WatchRoot
+{
+    static constexpr int DEFAULT_STABILITY_DELAY_SECS = 10;
+
+    QString path;
+    int scanIntervalSecs = 0;       ///< Periodic rescan; 0 = only on change notifications
+    int stabilityDelaySecs = DEFAULT_STABILITY_DELAY_SECS;
+    int maxHashers = 0;             ///< Files of this root hashed at once; 0 = no limit
+    int priority = 0;               ///< Higher is hashed first
+
+    bool operator==(const WatchRoot &other) const;
+    bool operator!=(const WatchRoot &other) const { return !(*this == other); }
+
+    static QString toJson(const QList<WatchRoot> &roots);
+    /// Entries without a path are skipped; malformed text gives an empty list.
+    static QList<WatchRoot> fromJson(const QString &json);
+
+    /// Root that contains @p filePath (the deepest one if roots are nested), or -1.
+    static int indexOf(const QList<WatchRoot> &roots, const QString &filePath);
+
+    /// Paths of the roots below roots[@p index]. Their own watchers report those files,
+    /// so the watcher of roots[@p index] leaves their trees out.
+    static QStringList nestedRoots(const QList<WatchRoot> &roots, int index);
+};
+
+#endif // WATCHROOT_H
@@ -7,6 +7,7 @@
 #include <QCoreApplication>
 #include <QRegularExpression>
 #include <QFileInfo>
+#include <QDateTime>
 #include <algorithm>
 
 // Static regex for episode number extraction (shared across functions)
@@ -14,6 +15,8 @@ const QRegularExpression WatchSessionManager::s_epnoNumericRegex(R"(\d+)");
 
 WatchSessionManager::WatchSessionManager(QObject *parent)
     : QObject(parent)
+    , m_relationGraph(&m_ownRelationGraph)
+    , m_proactiveDeletionsLeft(0)
     , m_aheadBuffer(DEFAULT_AHEAD_BUFFER)
     , m_thresholdType(DeletionThresholdType::FixedGB)
     , m_thresholdValue(DEFAULT_THRESHOLD_VALUE)
@@ -25,6 +28,9 @@ WatchSessionManager::WatchSessionManager(QObject *parent)
     ensureTablesExist();
     loadSettings();
     loadFromDatabase();
+    
+    m_forecastTimer.setInterval(FORECAST_INTERVAL_MS);
+    connect(&m_forecastTimer, &QTimer::timeout, this, &WatchSessionManager::checkSpaceForecast);
 }
 
 WatchSessionManager::~WatchSessionManager()
@@ -330,30 +336,28 @@ void WatchSessionManager::markEpisodeWatched(int aid, int episodeNumber)
 
 int WatchSessionManager::getOriginalPrequel(int aid) const
 {
-    // Check cache first
-    if (m_prequelCache.contains(aid)) {
-        return m_prequelCache[aid];
+    const QList<int> chain = getSeriesChain(aid);
+    return chain.isEmpty() ? aid : chain.first();
+}
+
+QList<int> WatchSessionManager::getSeriesChain(int aid) const
+{
+    // Cached chains are valid until a relation in the graph changes
+    if (m_seriesChainRevision != m_relationGraph->revision()) {
+        m_seriesChainCache.clear();
+    }
+    auto cached = m_seriesChainCache.constFind(aid);
+    if (cached != m_seriesChainCache.constEnd()) {
+        return cached.value();
     }
     
-    loadAnimeRelations(aid);
-    
+    // Follow prequel links back to the original prequel
     int currentAid = aid;
     QSet<int> visited;
-    
-    // Follow prequel chain until we find the first anime
     while (!visited.contains(currentAid)) {
         visited.insert(currentAid);
-        
-        if (!m_relationsCache.contains(currentAid)) {
-            loadAnimeRelations(currentAid);
-        }
-        
-        if (!m_relationsCache.contains(currentAid)) {
-            break;
-        }
-        
-        // Look for prequel relation
-        int prequelAid = findPrequelAid(currentAid, "prequel");
+        m_relationGraph->ensureLoaded(currentAid);
+        int prequelAid = m_relationGraph->prequelOf(currentAid);
         if (prequelAid > 0 && !visited.contains(prequelAid)) {
             currentAid = prequelAid;
         } else {
@@ -361,124 +365,26 @@ int WatchSessionManager::getOriginalPrequel(int aid) const
         }
     }
     
-    // Cache result for all visited AIDs (they all have the same original prequel)
-    for (int visitedAid : visited) {
-        m_prequelCache[visitedAid] = currentAid;
-    }
-    
-    return currentAid;
-}
-
-QList<int> WatchSessionManager::getSeriesChain(int aid) const
-{
-    // Check cache first
-    if (m_seriesChainCache.contains(aid)) {
-        return m_seriesChainCache[aid];
-    }
-    
+    // Follow sequel links from there
     QList<int> chain;
-    QSet<int> visited;
-    
-    // Start from original prequel
-    int currentAid = getOriginalPrequel(aid);
-    
-    // Follow sequel chain
+    visited.clear();
     while (currentAid > 0 && !visited.contains(currentAid)) {
         chain.append(currentAid);
         visited.insert(currentAid);
-        
-        loadAnimeRelations(currentAid);
-        
-        // Look for sequel (type code 1 or string "sequel")
-        int sequelAid = 0;
-        if (m_relationsCache.contains(currentAid)) {
-            for (const auto& rel : m_relationsCache[currentAid]) {
-                int relCode = rel.second.toInt();
-                if (relCode == RELATION_SEQUEL || rel.second.contains("sequel", Qt::CaseInsensitive)) {
-                    sequelAid = rel.first;
-                    break;
-                }
-            }
-        }
-        
-        currentAid = sequelAid;
+        m_relationGraph->ensureLoaded(currentAid);
+        currentAid = m_relationGraph->sequelOf(currentAid);
     }
     
-    // Cache result for all AIDs in the chain (they share the same chain)
+    // Lazy loads above only add anime, so the walked chains stay valid at the new revision
+    m_seriesChainRevision = m_relationGraph->revision();
     for (int chainAid : chain) {
         m_seriesChainCache[chainAid] = chain;
     }
+    m_seriesChainCache[aid] = chain;
     
     return chain;
 }
 
-void WatchSessionManager::loadAnimeRelations(int aid) const
-{
-    if (m_relationsCache.contains(aid)) {
-        return;
-    }
-    
-    QSqlDatabase db = QSqlDatabase::database();
-    if (!db.isOpen()) {
-        return;
-    }
-    
-    QSqlQuery q(db);
-    q.prepare("SELECT relaidlist, relaidtype FROM anime WHERE aid = ?");
-    q.addBindValue(aid);
-    
-    if (!q.exec() || !q.next()) {
-        return;
-    }
-    
-    QString relatedAids = q.value(0).toString();
-    QString relatedTypes = q.value(1).toString();
-    
-    QList<QPair<int, QString>> relations;
-    
-    if (!relatedAids.isEmpty() && !relatedTypes.isEmpty()) {
-        QStringList aidList = relatedAids.split("'", Qt::SkipEmptyParts);
-        QStringList typeList = relatedTypes.split("'", Qt::SkipEmptyParts);
-        
-        int count = qMin(aidList.size(), typeList.size());
-        for (int i = 0; i < count; i++) {
-            int relAid = aidList[i].toInt();
-            QString relType = typeList[i].toLower();
-            if (relAid > 0) {
-                relations.append(qMakePair(relAid, relType));
-            }
-        }
-    }
-    
-    m_relationsCache[aid] = relations;
-}
-
-int WatchSessionManager::findPrequelAid(int aid, const QString& relationType) const
-{
-    if (!m_relationsCache.contains(aid)) {
-        return 0;
-    }
-    
-    // Map string relation type to numeric code for comparison
-    int targetCode = -1;
-    if (relationType.toLower() == "prequel") {
-        targetCode = RELATION_PREQUEL;
-    } else if (relationType.toLower() == "sequel") {
-        targetCode = RELATION_SEQUEL;
-    }
-    
-    const QList<QPair<int, QString>>& relations = m_relationsCache[aid];
-    for (const auto& rel : relations) {
-        // Check both numeric code and string match (for backwards compatibility with tests)
-        int relCode = rel.second.toInt();
-        if (relCode == targetCode || rel.second.contains(relationType, Qt::CaseInsensitive)) {
-            return rel.first;
-        }
-    }
-    
-    return 0;
-}
-
 // ========== File Marking ==========
 
 std::tuple<int, int, int> WatchSessionManager::findActiveSessionInSeriesChain(int aid) const
@@ -539,25 +445,30 @@ bool WatchSessionManager::isDeletionNeeded() const
         return false;
     }
     
+    qint64 availableBytes = 0;
+    qint64 thresholdBytes = 0;
+    readSpace(availableBytes, thresholdBytes);
+    
+    // Return true if below threshold
+    return availableBytes < thresholdBytes;
+}
+
+void WatchSessionManager::readSpace(qint64& availableBytes, qint64& thresholdBytes) const
+{
     // Get available space on the watched drive (or application directory if not set)
     QString pathToMonitor = m_watchedPath.isEmpty() ? QCoreApplication::applicationDirPath() : m_watchedPath;
     QStorageInfo storage(pathToMonitor);
-    qint64 availableBytes = storage.bytesAvailable();
+    availableBytes = storage.bytesAvailable();
     qint64 totalBytes = storage.bytesTotal();
     
-    double availableGB = availableBytes / (1024.0 * 1024.0 * 1024.0);
-    double totalGB = totalBytes / (1024.0 * 1024.0 * 1024.0);
-    
     double threshold = 0;
     if (m_thresholdType == DeletionThresholdType::FixedGB) {
-        threshold = m_thresholdValue;
+        threshold = m_thresholdValue * (1024.0 * 1024.0 * 1024.0);
     } else {
-        // Percentage threshold type: use totalGB to calculate threshold
-        threshold = (m_thresholdValue / 100.0) * totalGB;
+        // Percentage threshold type: use the drive size to calculate threshold
+        threshold = (m_thresholdValue / 100.0) * totalBytes;
     }
-    
-    // Return true if below threshold
-    return availableGB < threshold;
+    thresholdBytes = static_cast<qint64>(threshold);
 }
 
 bool WatchSessionManager::deleteFile(int lid, bool deleteFromDisk)
@@ -630,6 +541,10 @@ void WatchSessionManager::onFileDeletionResult(int lid, int aid, bool success)
         if (m_enableActualDeletion && isDeletionNeeded()) {
             LOG("[WatchSessionManager] Space still below threshold after deletion, requesting next deletion cycle");
             emit deletionCycleRequested();
+        } else if (continueProactiveDeletion()) {
+            LOG(QString("[WatchSessionManager] Deleting ahead of threshold, %1 file(s) left in batch")
+                .arg(m_proactiveDeletionsLeft));
+            emit deletionCycleRequested();
         } else {
             LOG(QString("[WatchSessionManager] No further deletion needed: enableActualDeletion=%1, deletionNeeded=%2")
                 .arg(m_enableActualDeletion).arg(isDeletionNeeded()));
@@ -637,6 +552,7 @@ void WatchSessionManager::onFileDeletionResult(int lid, int aid, bool success)
     } else {
         LOG(QString("[WatchSessionManager] File deletion failed for lid=%1, aid=%2").arg(lid).arg(aid));
         m_failedDeletions.insert(lid);
+        stopProactiveDeletion();
         
         // Request next deletion cycle even after failure so DeletionQueue picks a different candidate
         if (m_enableActualDeletion && isDeletionNeeded()) {
@@ -659,6 +575,100 @@ void WatchSessionManager::autoMarkFilesForDeletion()
     }
 }
 
+// ========== Space Forecast ==========
+
+void WatchSessionManager::recordNewFiles(const QStringList& filePaths)
+{
+    qint64 bytes = 0;
+    for (const QString& path : filePaths) {
+        bytes += QFileInfo(path).size();
+    }
+    m_spaceForecast.recordInflow(QDateTime::currentMSecsSinceEpoch(), bytes);
+    stopProactiveDeletion();
+}
+
+void WatchSessionManager::recordFreedBytes(qint64 bytes)
+{
+    m_spaceForecast.recordOutflow(QDateTime::currentMSecsSinceEpoch(), bytes);
+}
+
+void WatchSessionManager::noteDiskActivity()
+{
+    m_spaceForecast.noteActivity(QDateTime::currentMSecsSinceEpoch());
+    stopProactiveDeletion();
+}
+
+void WatchSessionManager::setPlaybackActive(bool active)
+{
+    m_spaceForecast.setPlaybackActive(active);
+    if (active) {
+        stopProactiveDeletion();
+    }
+}
+
+qint64 WatchSessionManager::secondsUntilDeletionNeeded() const
+{
+    qint64 availableBytes = 0;
+    qint64 thresholdBytes = 0;
+    readSpace(availableBytes, thresholdBytes);
+    return m_spaceForecast.secondsUntilThreshold(availableBytes, thresholdBytes);
+}
+
+void WatchSessionManager::stopProactiveDeletion()
+{
+    if (m_proactiveDeletionsLeft > 0) {
+        LOG(QString("[WatchSessionManager] Ahead-of-threshold deletion batch stopped (%1 file(s) left)")
+            .arg(m_proactiveDeletionsLeft));
+    }
+    m_proactiveDeletionsLeft = 0;
+}
+
+void WatchSessionManager::checkSpaceForecast()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_spaceForecast.advance(now);
+    
+    if (!m_autoMarkDeletionEnabled || !m_enableActualDeletion || isProactiveDeletionRunning()) {
+        return;
+    }
+    
+    qint64 availableBytes = 0;
+    qint64 thresholdBytes = 0;
+    readSpace(availableBytes, thresholdBytes);
+    // Below the threshold the regular cycle (new files, deletion results) is in charge
+    if (!m_spaceForecast.shouldDeleteAhead(now, availableBytes, thresholdBytes)) {
+        return;
+    }
+    
+    LOG(QString("[WatchSessionManager] Threshold expected in %1 min (inflow %2 KB/s, outflow %3 KB/s), "
+                "deleting up to %4 file(s) while idle")
+        .arg(m_spaceForecast.secondsUntilThreshold(availableBytes, thresholdBytes) / 60)
+        .arg(m_spaceForecast.inflowRate() / 1024.0, 0, 'f', 1)
+        .arg(m_spaceForecast.outflowRate() / 1024.0, 0, 'f', 1)
+        .arg(PROACTIVE_BATCH_SIZE));
+    m_proactiveDeletionsLeft = PROACTIVE_BATCH_SIZE;
+    emit deletionCycleRequested();
+}
+
+bool WatchSessionManager::continueProactiveDeletion()
+{
+    if (m_proactiveDeletionsLeft <= 0) {
+        return false;
+    }
+    --m_proactiveDeletionsLeft;
+    
+    // Stop early once the freed space pushes the threshold past the horizon,
+    // or when the drive got busy in the meantime
+    qint64 availableBytes = 0;
+    qint64 thresholdBytes = 0;
+    readSpace(availableBytes, thresholdBytes);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (!m_enableActualDeletion || !m_spaceForecast.shouldDeleteAhead(now, availableBytes, thresholdBytes)) {
+        m_proactiveDeletionsLeft = 0;
+    }
+    return m_proactiveDeletionsLeft > 0;
+}
+
 void WatchSessionManager::autoMarkFilesForDownload()
 {
     // Removed: Marking system has been eliminated
@@ -805,6 +815,9 @@ void WatchSessionManager::performInitialScan()
     // Mark that initial scan is complete - this enables space checks on path changes
     m_initialScanComplete = true;
     
+    // Answer the per-file helpers from one bulk load for the whole scan
+    loadFileAttributes();
+    
     // Auto-start sessions for anime that have local files but no active session
     // This ensures WatchSessionManager works for existing anime collections
     autoStartSessionsForExistingAnime();
@@ -822,6 +835,12 @@ void WatchSessionManager::performInitialScan()
     // Save the marks to database
     saveToDatabase();
     
+    releaseFileAttributes();
+    
+    // From now on free space is forecast and deletion may start ahead of the threshold
+    m_spaceForecast.advance(QDateTime::currentMSecsSinceEpoch());
+    m_forecastTimer.start();
+    
     // Note: markingsUpdated signal is emitted by autoMarkFilesForDownload/autoMarkFilesForDeletion
 }
 
@@ -839,10 +858,39 @@ void WatchSessionManager::onNewAnimeAdded(int aid)
     }
 }
 
+// ========== Bulk File Attributes ==========
+
+bool WatchSessionManager::loadFileAttributes()
+{
+    auto snapshot = std::make_unique<FileAttributeSnapshot>();
+    if (!snapshot->load()) {
+        LOG("[WatchSessionManager] File attribute snapshot unavailable, helpers use per-file queries");
+        m_fileAttributes.reset();
+        return false;
+    }
+    m_fileAttributes = std::move(snapshot);
+    return true;
+}
+
+void WatchSessionManager::releaseFileAttributes()
+{
+    m_fileAttributes.reset();
+}
+
+const FileAttributeSnapshot::File *WatchSessionManager::attributesOf(int lid) const
+{
+    return m_fileAttributes ? m_fileAttributes->file(lid) : nullptr;
+}
+
 // ========== Helper Methods ==========
 
 int WatchSessionManager::getEpisodeNumber(int lid) const
 {
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        QRegularExpressionMatch match = s_epnoNumericRegex.match(file->epno);
+        return (file->hasEpisode && match.hasMatch()) ? match.captured(0).toInt() : 0;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -869,6 +917,10 @@ int WatchSessionManager::getEpisodeNumber(int lid) const
 
 int WatchSessionManager::getAnimeIdForFile(int lid) const
 {
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->aid;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -916,6 +968,10 @@ int WatchSessionManager::getFileVersion(int lid) const
     //   Bit 6 (64): FILE_UNC - uncensored
     //   Bit 7 (128): FILE_CEN - censored
     // If no version bits are set, the file is version 1
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->version() : 1;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 1;  // Default to version 1
@@ -952,6 +1008,16 @@ int WatchSessionManager::getFileVersion(int lid) const
 int WatchSessionManager::getFileCountForEpisode(int lid) const
 {
     // Count how many files exist for the same episode (same eid)
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        int count = 0;
+        for (int other : m_fileAttributes->lidsForEpisode(file->eid)) {
+            if (!m_fileAttributes->file(other)->path.isEmpty()) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 1;
@@ -977,6 +1043,19 @@ int WatchSessionManager::getFileCountForEpisode(int lid) const
 int WatchSessionManager::getHigherVersionFileCount(int lid) const
 {
     // Count how many local files for the same episode have a higher version than this file
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        const int myVersion = getFileVersion(lid);
+        int count = 0;
+        for (int other : m_fileAttributes->lidsForEpisode(file->eid)) {
+            const FileAttributeSnapshot::File *otherFile = m_fileAttributes->file(other);
+            if (other != lid && otherFile->hasFile && !otherFile->path.isEmpty()
+                && otherFile->version() > myVersion) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -1020,6 +1099,10 @@ int WatchSessionManager::getHigherVersionFileCount(int lid) const
 // Helper methods for new marking criteria
 bool WatchSessionManager::matchesPreferredAudioLanguage(int lid) const
 {
+    if (attributesOf(lid)) {
+        return m_fileAttributes->matchesPreferredAudioLanguage(lid);
+    }
+    
     QString audioLang = getFileAudioLanguage(lid);
     if (audioLang.isEmpty()) {
         return false;
@@ -1055,6 +1138,10 @@ bool WatchSessionManager::matchesPreferredAudioLanguage(int lid) const
 
 bool WatchSessionManager::matchesPreferredSubtitleLanguage(int lid) const
 {
+    if (attributesOf(lid)) {
+        return m_fileAttributes->matchesPreferredSubtitleLanguage(lid);
+    }
+    
     QString subLang = getFileSubtitleLanguage(lid);
     if (subLang.isEmpty()) {
         return false;
@@ -1107,6 +1194,10 @@ int WatchSessionManager::getQualityScore(const QString& quality) const
 
 QString WatchSessionManager::getFileQuality(int lid) const
 {
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->quality : QString();
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return QString();
@@ -1125,6 +1216,10 @@ QString WatchSessionManager::getFileQuality(int lid) const
 
 QString WatchSessionManager::getFileAudioLanguage(int lid) const
 {
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->audioLanguage : QString();
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return QString();
@@ -1143,6 +1238,10 @@ QString WatchSessionManager::getFileAudioLanguage(int lid) const
 
 QString WatchSessionManager::getFileSubtitleLanguage(int lid) const
 {
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->subtitleLanguage : QString();
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return QString();
@@ -1162,36 +1261,45 @@ QString WatchSessionManager::getFileSubtitleLanguage(int lid) const
 int WatchSessionManager::getFileRating(int lid) const
 {
     // Get anime rating for this file (0-1000 scale, where 800+ is excellent)
-    QSqlDatabase db = QSqlDatabase::database();
-    if (!db.isOpen()) {
-        return RATING_HIGH_THRESHOLD;  // Treat as high rating if DB unavailable
-    }
-    
-    QSqlQuery q(db);
     // Extract numeric rating from anime.rating field (format: "8.23" -> 823)
-    q.prepare("SELECT a.rating FROM mylist m JOIN anime a ON m.aid = a.aid WHERE m.lid = ?");
-    q.addBindValue(lid);
-    
-    if (q.exec() && q.next()) {
-        QString ratingStr = q.value(0).toString();
-        if (!ratingStr.isEmpty()) {
-            // Convert "8.23" to 823 using qRound for predictable rounding
-            double rating = ratingStr.toDouble() * 100.0;
-            int ratingValue = qRound(rating);
-            // Treat zero or invalid rating as high rating to preserve content
-            // Zero occurs when: (1) rating field is explicitly "0" or "0.00",
-            // (2) toDouble() returns 0.0 (e.g., for non-numeric strings)
-            // In both cases, assume the anime is worth keeping (optimistic approach)
-            return (ratingValue == 0) ? RATING_HIGH_THRESHOLD : ratingValue;
+    QString ratingStr;
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        ratingStr = file->hasAnime ? file->animeRatingText : QString();
+    } else {
+        QSqlDatabase db = QSqlDatabase::database();
+        if (!db.isOpen()) {
+            return RATING_HIGH_THRESHOLD;  // Treat as high rating if DB unavailable
+        }
+        
+        QSqlQuery q(db);
+        q.prepare("SELECT a.rating FROM mylist m JOIN anime a ON m.aid = a.aid WHERE m.lid = ?");
+        q.addBindValue(lid);
+        if (q.exec() && q.next()) {
+            ratingStr = q.value(0).toString();
         }
     }
     
+    if (!ratingStr.isEmpty()) {
+        // Convert "8.23" to 823 using qRound for predictable rounding
+        double rating = ratingStr.toDouble() * 100.0;
+        int ratingValue = qRound(rating);
+        // Treat zero or invalid rating as high rating to preserve content
+        // Zero occurs when: (1) rating field is explicitly "0" or "0.00",
+        // (2) toDouble() returns 0.0 (e.g., for non-numeric strings)
+        // In both cases, assume the anime is worth keeping (optimistic approach)
+        return (ratingValue == 0) ? RATING_HIGH_THRESHOLD : ratingValue;
+    }
+    
     return RATING_HIGH_THRESHOLD;  // No rating available - treat as high rating
 }
 
 int WatchSessionManager::getFileGroupId(int lid) const
 {
     // Get group ID for this file
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->gid : 0;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -1212,6 +1320,10 @@ int WatchSessionManager::getGroupStatus(int gid) const
 {
     // Get group status from database
     // Status values: 0=unknown, 1=ongoing, 2=stalled, 3=disbanded
+    if (m_fileAttributes && m_fileAttributes->containsGroup(gid)) {
+        return m_fileAttributes->groupStatus(gid);
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -1231,6 +1343,10 @@ int WatchSessionManager::getGroupStatus(int gid) const
 int WatchSessionManager::getFileBitrate(int lid) const
 {
     // Get video bitrate for this file (in Kbps)
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->videoBitrate : 0;
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -1250,6 +1366,10 @@ int WatchSessionManager::getFileBitrate(int lid) const
 QString WatchSessionManager::getFileResolution(int lid) const
 {
     // Get resolution for this file
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->resolution : QString();
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return QString();
@@ -1269,6 +1389,10 @@ QString WatchSessionManager::getFileResolution(int lid) const
 QString WatchSessionManager::getFileCodec(int lid) const
 {
     // Get video codec for this file
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        return file->hasFile ? file->videoCodec : QString();
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return QString();
@@ -1332,7 +1456,11 @@ double WatchSessionManager::calculateExpectedBitrate(const QString& resolution,
     double baselineBitrate = 3.5;
     
     QSqlDatabase db = QSqlDatabase::database();
-    if (db.isOpen()) {
+    if (m_fileAttributes) {
+        if (m_fileAttributes->preferredBitrate() > 0) {
+            baselineBitrate = m_fileAttributes->preferredBitrate();
+        }
+    } else if (db.isOpen()) {
         QSqlQuery q(db);
         q.prepare("SELECT value FROM settings WHERE name = 'preferredBitrate'");
         if (q.exec() && q.next()) {
@@ -1396,6 +1524,14 @@ int WatchSessionManager::getEpisodeIdForFile(int lid) const
 {
     // Get a unique episode identifier (aid + episode number)
     // Used for gap tracking across deletions
+    if (const FileAttributeSnapshot::File *file = attributesOf(lid)) {
+        QRegularExpressionMatch match = s_epnoNumericRegex.match(file->epno);
+        if (!file->hasEpisode || !match.hasMatch()) {
+            return 0;
+        }
+        return file->aid * EPISODE_ID_MULTIPLIER + match.captured(0).toInt();
+    }
+    
     QSqlDatabase db = QSqlDatabase::database();
     if (!db.isOpen()) {
         return 0;
@@ -1427,27 +1563,40 @@ int WatchSessionManager::getEpisodeIdForFile(int lid) const
 bool WatchSessionManager::wouldCreateGap(int lid, const QSet<int>& deletedEpisodes) const
 {
     // Get anime ID and episode number for this file
+    const FileAttributeSnapshot::File *file = attributesOf(lid);
     QSqlDatabase db = QSqlDatabase::database();
-    if (!db.isOpen()) {
+    if (!file && !db.isOpen()) {
         return false;  // Can't determine, assume no gap
     }
     
-    // Note: We also retrieve m.eid here (in addition to aid and epno) to use later
-    // for checking if multiple files exist for the same episode
-    QSqlQuery q(db);
-    q.prepare("SELECT m.aid, e.epno, m.eid FROM mylist m "
-              "JOIN episode e ON m.eid = e.eid "
-              "WHERE m.lid = ?");
-    q.addBindValue(lid);
-    
-    if (!q.exec() || !q.next()) {
-        return false;  // Can't determine, assume no gap
+    int aid = 0;
+    QString epnoStr;
+    int eid = 0;
+    if (file) {
+        if (!file->hasEpisode) {
+            return false;  // Can't determine, assume no gap
+        }
+        aid = file->aid;
+        epnoStr = file->epno;
+        eid = file->eid;
+    } else {
+        // Note: We also retrieve m.eid here (in addition to aid and epno) to use later
+        // for checking if multiple files exist for the same episode
+        QSqlQuery q(db);
+        q.prepare("SELECT m.aid, e.epno, m.eid FROM mylist m "
+                  "JOIN episode e ON m.eid = e.eid "
+                  "WHERE m.lid = ?");
+        q.addBindValue(lid);
+        
+        if (!q.exec() || !q.next()) {
+            return false;  // Can't determine, assume no gap
+        }
+        
+        aid = q.value(0).toInt();
+        epnoStr = q.value(1).toString();
+        eid = q.value(2).toInt();
     }
     
-    int aid = q.value(0).toInt();
-    QString epnoStr = q.value(1).toString();
-    int eid = q.value(2).toInt();
-    
     // Parse episode number from epno string using shared static regex
     QRegularExpressionMatch match = s_epnoNumericRegex.match(epnoStr);
     if (!match.hasMatch()) {
@@ -1459,25 +1608,38 @@ bool WatchSessionManager::wouldCreateGap(int lid, const QSet<int>& deletedEpisod
     // IMPORTANT: Check if there are other files for this same episode
     // If there are other files, deleting this one won't remove the episode entirely,
     // so it cannot create a gap
-    QSqlQuery fileCountQuery(db);
-    fileCountQuery.prepare(
-        "SELECT m.lid, lf.path FROM mylist m "
-        "JOIN local_files lf ON m.local_file = lf.id "
-        "WHERE m.eid = ? AND m.lid != ? AND lf.path IS NOT NULL AND lf.path != ''"
-    );
-    fileCountQuery.addBindValue(eid);
-    fileCountQuery.addBindValue(lid);
-    
-    if (fileCountQuery.exec()) {
-        while (fileCountQuery.next()) {
-            QFileInfo otherFile(fileCountQuery.value(1).toString());
-            if (otherFile.exists() && otherFile.isFile()) {
-                // Another real file exists for this episode, so deleting this file
-                // won't remove the episode and thus cannot create a gap
-                return false;
+    QStringList otherPaths;
+    if (file) {
+        for (int other : m_fileAttributes->lidsForEpisode(eid)) {
+            const QString &path = m_fileAttributes->file(other)->path;
+            if (other != lid && !path.isEmpty()) {
+                otherPaths.append(path);
+            }
+        }
+    } else {
+        QSqlQuery fileCountQuery(db);
+        fileCountQuery.prepare(
+            "SELECT m.lid, lf.path FROM mylist m "
+            "JOIN local_files lf ON m.local_file = lf.id "
+            "WHERE m.eid = ? AND m.lid != ? AND lf.path IS NOT NULL AND lf.path != ''"
+        );
+        fileCountQuery.addBindValue(eid);
+        fileCountQuery.addBindValue(lid);
+        
+        if (fileCountQuery.exec()) {
+            while (fileCountQuery.next()) {
+                otherPaths.append(fileCountQuery.value(1).toString());
             }
         }
     }
+    for (const QString &path : otherPaths) {
+        QFileInfo otherFile(path);
+        if (otherFile.exists() && otherFile.isFile()) {
+            // Another real file exists for this episode, so deleting this file
+            // won't remove the episode and thus cannot create a gap
+            return false;
+        }
+    }
     
     // Check if this file, when deleted, would leave episodes on both sides
     // creating a gap in the series
@@ -1495,21 +1657,33 @@ bool WatchSessionManager::wouldCreateGap(int lid, const QSet<int>& deletedEpisod
     // 1. It would do string sorting which is incorrect for multi-digit episodes ("10" < "2")
     // 2. We extract episode numbers numerically and process them in code anyway
     // 3. This avoids the performance cost of sorting when we don't need it
-    QSqlQuery q2(db);
-    q2.prepare("SELECT DISTINCT e.epno FROM mylist m "
-               "JOIN episode e ON m.eid = e.eid "
-               "JOIN local_files lf ON m.local_file = lf.id "
-               "WHERE m.aid = ? AND lf.path IS NOT NULL AND lf.path != ''");
-    q2.addBindValue(aid);
-    
-    if (!q2.exec()) {
-        return false;  // Query failed, assume no gap
+    QSet<QString> existingEpnos;
+    if (file) {
+        for (int other : m_fileAttributes->lidsForAnime(aid)) {
+            const FileAttributeSnapshot::File *otherFile = m_fileAttributes->file(other);
+            if (otherFile->hasEpisode && !otherFile->path.isEmpty()) {
+                existingEpnos.insert(otherFile->epno);
+            }
+        }
+    } else {
+        QSqlQuery q2(db);
+        q2.prepare("SELECT DISTINCT e.epno FROM mylist m "
+                   "JOIN episode e ON m.eid = e.eid "
+                   "JOIN local_files lf ON m.local_file = lf.id "
+                   "WHERE m.aid = ? AND lf.path IS NOT NULL AND lf.path != ''");
+        q2.addBindValue(aid);
+        
+        if (!q2.exec()) {
+            return false;  // Query failed, assume no gap
+        }
+        while (q2.next()) {
+            existingEpnos.insert(q2.value(0).toString());
+        }
     }
     
     // Build list of existing episode numbers (excluding those marked for deletion)
     QList<int> existingEpisodes;
-    while (q2.next()) {
-        QString existingEpnoStr = q2.value(0).toString();
+    for (const QString &existingEpnoStr : existingEpnos) {
         QRegularExpressionMatch existingMatch = s_epnoNumericRegex.match(existingEpnoStr);
         if (existingMatch.hasMatch()) {
             int existingEpno = existingMatch.captured(0).toInt();
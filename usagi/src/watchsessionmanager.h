@@ -6,8 +6,14 @@
 #include <QSet>
 #include <QList>
 #include <QPair>
+#include <QStringList>
+#include <QTimer>
 #include <tuple>
+#include <memory>
 #include "sessioninfo.h"
+#include "relationgraph.h"
+#include "fileattributesnapshot.h"
+#include "spaceforecast.h"
 
 /**
  * @brief Deletion threshold type for automatic file cleanup
@@ -39,6 +45,7 @@ class WatchSessionManager : public QObject
     // Allow test class to access private methods
     friend class TestBitratePreferences;
     friend class TestWatchSessionManager;
+    friend class TestDeletionClassification;
     friend class HybridDeletionClassifier;
     
 public:
@@ -98,11 +105,21 @@ public:
     
     /**
      * @brief Get the complete series chain for an anime
+     *
+     * Walks prequel links back to the original prequel, then sequel links forward.
+     * Side branches of the relation graph (a second sequel, spin-offs) are not part of it.
+     *
      * @param aid Anime ID
      * @return Ordered list of anime IDs in the series (from prequel to final sequel)
      */
     QList<int> getSeriesChain(int aid) const;
     
+    /**
+     * @brief Use a shared relation graph for series chains
+     * @param graph Graph owned by the caller (e.g. MyListCardManager), or nullptr for the private one
+     */
+    void setRelationGraph(RelationGraph *graph) { m_relationGraph = graph ? graph : &m_ownRelationGraph; }
+    
     // ========== File Marking ==========
     
     /**
@@ -137,6 +154,49 @@ public:
      */
     void autoMarkFilesForDeletion();
     
+    // ========== Space Forecast ==========
+    
+    /**
+     * @brief Record files that appeared in the watched directory
+     * 
+     * Their sizes feed the inflow rate of the space forecast, and the drive
+     * counts as busy (no deletion ahead of time) for a while.
+     */
+    void recordNewFiles(const QStringList& filePaths);
+    
+    /**
+     * @brief Record space freed by a deletion (feeds the outflow rate)
+     */
+    void recordFreedBytes(qint64 bytes);
+    
+    /**
+     * @brief Note disk activity deletion should not compete with (e.g. hashing)
+     */
+    void noteDiskActivity();
+    
+    /**
+     * @brief Tell the forecast whether a file is playing (no deletion ahead of time meanwhile)
+     */
+    void setPlaybackActive(bool active);
+    
+    /**
+     * @brief Forecast seconds until free space drops below the deletion threshold
+     * @return 0 if already below, -1 if free space is not shrinking
+     */
+    qint64 secondsUntilDeletionNeeded() const;
+    
+    /**
+     * @brief True while a deletion batch started ahead of the threshold is running
+     * 
+     * Window does not ask for A vs B choices during such a batch.
+     */
+    bool isProactiveDeletionRunning() const { return m_proactiveDeletionsLeft > 0; }
+    
+    /**
+     * @brief Stop the current ahead-of-time deletion batch
+     */
+    void stopProactiveDeletion();
+    
     /**
      * @brief Placeholder for download marking (removed)
      * 
@@ -169,6 +229,26 @@ public:
      */
     void onNewAnimeAdded(int aid);
     
+    /**
+     * @brief Load a bulk snapshot of local file attributes for the per-file helpers
+     * 
+     * While loaded, the per-file helpers (version, quality, languages, codec, bitrate,
+     * resolution, group, rating, episode counts, gap detection) answer local files from
+     * a FileAttributeSnapshot instead of one query per call. Entries without a local
+     * file are not in the snapshot and still use the per-lid queries.
+     * performInitialScan() holds one for the duration of the scan.
+     * 
+     * @return true if the snapshot was loaded
+     */
+    bool loadFileAttributes();
+    
+    /**
+     * @brief Drop the snapshot; the helpers query the database again
+     */
+    void releaseFileAttributes();
+    
+    bool hasFileAttributes() const { return m_fileAttributes != nullptr; }
+    
     // ========== Settings ==========
     
     /**
@@ -317,14 +397,14 @@ private:
     // Static regex for episode number extraction (shared across functions)
     static const QRegularExpression s_epnoNumericRegex;
     
-    // Cache for anime relations
-    mutable QMap<int, QList<QPair<int, QString>>> m_relationsCache; // aid -> [(related_aid, relation_type), ...]
-    
-    // Cache for prequel lookups (optimization to avoid redundant chain traversal)
-    mutable QMap<int, int> m_prequelCache; // aid -> original prequel aid
+    // Relations: the card manager's graph once shared, otherwise a private one
+    // loaded lazily from the database
+    RelationGraph m_ownRelationGraph;
+    RelationGraph *m_relationGraph;
     
-    // Cache for series chains (optimization to avoid redundant chain building)
+    // Cache for series chains walked over the graph, valid while its revision is unchanged
     mutable QMap<int, QList<int>> m_seriesChainCache; // aid -> chain of aids
+    mutable quint64 m_seriesChainRevision = 0;
     
     // Active sessions by anime ID
     QMap<int, SessionInfo> m_sessions;
@@ -332,6 +412,11 @@ private:
     // Track failed deletions to avoid retrying immediately
     QSet<int> m_failedDeletions;
     
+    // Free space forecast, re-evaluated by m_forecastTimer after the initial scan
+    SpaceForecast m_spaceForecast;
+    QTimer m_forecastTimer;
+    int m_proactiveDeletionsLeft;               // Files left in the running ahead-of-time batch
+    
     // Settings
     int m_aheadBuffer;                          // Episodes to keep ahead
     DeletionThresholdType m_thresholdType;      // Threshold type
@@ -342,9 +427,11 @@ private:
     QString m_watchedPath;                      // Path for space monitoring (uses directory watcher path)
     bool m_initialScanComplete;                 // True after performInitialScan() is called
     
+    // Attributes of all local files while a scan runs (nullptr otherwise)
+    std::unique_ptr<FileAttributeSnapshot> m_fileAttributes;
+    const FileAttributeSnapshot::File *attributesOf(int lid) const;
+    
     // Helper methods
-    void loadAnimeRelations(int aid) const;
-    int findPrequelAid(int aid, const QString& relationType) const;
     int getEpisodeNumber(int lid) const;
     int getAnimeIdForFile(int lid) const;
     bool isCardHidden(int aid) const;
@@ -355,6 +442,11 @@ private:
     void saveSettings();
     void ensureTablesExist();
     
+    // Space forecast helpers
+    void readSpace(qint64& availableBytes, qint64& thresholdBytes) const;  // Free space and threshold of the watched drive
+    void checkSpaceForecast();  // Timer tick: update rates, start a batch ahead of the threshold when idle
+    bool continueProactiveDeletion();  // Whether the running batch should delete another file
+    
     // Helper methods for new marking criteria
     bool matchesPreferredAudioLanguage(int lid) const;
     bool matchesPreferredSubtitleLanguage(int lid) const;
@@ -395,10 +487,6 @@ private:
     // Episode ID multiplier for unique identification (aid * multiplier + epno)
     static constexpr int EPISODE_ID_MULTIPLIER = 100000;
     
-    // AniDB relation type codes
-    static const int RELATION_SEQUEL = 1;
-    static const int RELATION_PREQUEL = 2;
-    
     // Quality thresholds (based on AniDB quality field)
     static constexpr int QUALITY_HIGH_THRESHOLD = 60;
     static constexpr int QUALITY_LOW_THRESHOLD = 40;
@@ -411,6 +499,10 @@ private:
     static constexpr int DEFAULT_AHEAD_BUFFER = 3;
     static constexpr double DEFAULT_THRESHOLD_VALUE = 50.0; // 50 GB or 50%
     static constexpr int DEFAULT_EPISODE_COUNT = 12;  // Default episode count when unknown (typical anime cour)
+    
+    // Space forecast
+    static constexpr int FORECAST_INTERVAL_MS = 60 * 1000;  // How often free space is re-evaluated
+    static constexpr int PROACTIVE_BATCH_SIZE = 3;          // Files deleted per idle period ahead of the threshold
 };
 
 #endif // WATCHSESSIONMANAGER_H
@@ -3,12 +3,16 @@
 #include "animeutils.h"
 #include "hasherthreadpool.h"
 #include "hasherthread.h"
+#include "hashingjobmodel.h"
 #include "crashlog.h"
 #include "logger.h"
 #include "aired.h"
 #include "directorywatchermanager.h"
 #include "autofetchmanager.h"
 #include "traysettingsmanager.h"
+#include "carddatasnapshot.h"
+#include "animecardmodel.h"
+#include "animecarddelegate.h"
 #include <QElapsedTimer>
 #include <QThread>
 #include <QSqlDatabase>
@@ -427,6 +431,7 @@ Window::Window()
     exitingFromTray = false;
     playbackManager = nullptr;
     watchSessionManager = nullptr;
+    m_deletionCyclePending = false;
     directoryWatcherManager = nullptr;
     autoFetchManager = nullptr;
     traySettingsManager = nullptr;
@@ -563,7 +568,11 @@ Window::Window()
         LOG(QString("HasherCoordinator: File linked to mylist, updating anime card for lid=%1").arg(lid));
         updateOrAddMylistEntry(lid);
         if (deletionQueue) {
-            deletionQueue->rebuild();
+            deletionQueue->refreshFile(lid);
+        }
+        // Hashing keeps the drive busy; hold off deleting ahead of the threshold
+        if (watchSessionManager) {
+            watchSessionManager->noteDiskActivity();
         }
     });
     
@@ -612,7 +621,7 @@ Window::Window()
         }
     });
     
-    connect(cardManager, &MyListCardManager::cardCreated, this, [this](int aid, AnimeCard *card) {
+    connect(cardManager, &MyListCardManager::cardCreated, this, [this](int, AnimeCard *card) {
         // Connect individual card signals
         connect(card, &AnimeCard::cardClicked, this, &Window::onCardClicked);
         connect(card, &AnimeCard::episodeClicked, this, &Window::onCardEpisodeClicked);
@@ -646,8 +655,11 @@ Window::Window()
                 }
             }
         });
-        
-        // Apply deletion lock state from database on card creation
+    });
+    
+    // Cards are reused for other anime, so lock state is applied on every bind
+    connect(cardManager, &MyListCardManager::cardBound, this, [this](int aid, AnimeCard *card) {
+        // Apply deletion lock state from database
         if (deletionLockManager) {
             if (deletionLockManager->isAnimeLocked(aid)) {
                 card->setAnimeLocked(true);
@@ -661,6 +673,11 @@ Window::Window()
     connect(cardManager, &MyListCardManager::cardUpdated, this, [](int) {
         // Card was updated in place - no need to resort the entire list
     });
+
+    // Off-screen card dropped from the card cache - don't keep a pointer to it
+    connect(cardManager, &MyListCardManager::cardEvicted, this, [this](int, AnimeCard *card) {
+        animeCards.removeAll(card);
+    });
     
     // Connect episode data request signal to fetch missing episode data
     connect(cardManager, &MyListCardManager::episodeDataRequested, this, [this](int eid) {
@@ -702,7 +719,8 @@ Window::Window()
                 AnimeCard *card = cardManager->getCard(aid);
                 if (card) card->setAnimeLocked(true);
             }
-            if (deletionQueue) deletionQueue->rebuild();
+            refreshMylistGridEditor(aid);
+            if (deletionQueue) deletionQueue->refreshAnime(aid);
         }
     });
     connect(cardManager, &MyListCardManager::unlockAnimeRequested, this, [this](int aid) {
@@ -713,19 +731,20 @@ Window::Window()
                 AnimeCard *card = cardManager->getCard(aid);
                 if (card) card->setAnimeLocked(false);
             }
-            if (deletionQueue) deletionQueue->rebuild();
+            refreshMylistGridEditor(aid);
+            if (deletionQueue) deletionQueue->refreshAnime(aid);
         }
     });
     connect(cardManager, &MyListCardManager::lockEpisodeRequested, this, [this](int eid) {
         if (deletionLockManager) {
             deletionLockManager->lockEpisode(eid);
-            if (deletionQueue) deletionQueue->rebuild();
+            if (deletionQueue) deletionQueue->refreshEpisodes({eid});
         }
     });
     connect(cardManager, &MyListCardManager::unlockEpisodeRequested, this, [this](int eid) {
         if (deletionLockManager) {
             deletionLockManager->unlockEpisode(eid);
-            if (deletionQueue) deletionQueue->rebuild();
+            if (deletionQueue) deletionQueue->refreshEpisodes({eid});
         }
     });
     
@@ -794,6 +813,55 @@ Window::Window()
     mylistCardLayout = nullptr;
     
     cardViewLayout->addWidget(mylistCardScrollArea, 1);  // Give card area stretch factor of 1
+    
+    // Optional delegate-painted grid: cards are painted from the card data cache and only
+    // the card under the mouse is a real widget. The virtual layout stays attached to the
+    // card manager for the anime order but is hidden, so it creates no cards.
+    mylistCardGridView = nullptr;
+    mylistCardModel = nullptr;
+    if (adbapi->getPaintedCardGrid()) {
+        mylistCardModel = new AnimeCardModel(cardManager, this);
+        AnimeCardDelegate *cardDelegate = new AnimeCardDelegate(this);
+        cardDelegate->setEditorFactory([this](int aid, QWidget *parent) -> QWidget* {
+            return cardManager->createInteractiveCard(aid, parent);
+        });
+        
+        mylistCardGridView = new QListView(this);
+        mylistCardGridView->setViewMode(QListView::IconMode);
+        mylistCardGridView->setFlow(QListView::LeftToRight);
+        mylistCardGridView->setWrapping(true);
+        mylistCardGridView->setResizeMode(QListView::Adjust);
+        mylistCardGridView->setMovement(QListView::Static);
+        mylistCardGridView->setUniformItemSizes(true);
+        mylistCardGridView->setSpacing(10);
+        mylistCardGridView->setSelectionMode(QAbstractItemView::NoSelection);
+        mylistCardGridView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        mylistCardGridView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+        mylistCardGridView->verticalScrollBar()->setSingleStep(20);
+        mylistCardGridView->setMouseTracking(true);
+        mylistCardGridView->setModel(mylistCardModel);
+        mylistCardGridView->setItemDelegate(cardDelegate);
+        
+        // Open a real card on the row under the mouse; the previous one goes back to being painted
+        connect(mylistCardGridView, &QListView::entered, this, [this](const QModelIndex &index) {
+            if (mylistCardGridEditorIndex == index) {
+                return;
+            }
+            if (mylistCardGridEditorIndex.isValid()) {
+                mylistCardGridView->closePersistentEditor(mylistCardGridEditorIndex);
+            }
+            mylistCardGridEditorIndex = index;
+            mylistCardGridView->openPersistentEditor(index);
+        });
+        
+        // The open card is a snapshot of the cached data; rebuild it when its anime changes
+        connect(cardManager, &MyListCardManager::cardUpdated, this, &Window::refreshMylistGridEditor);
+        
+        mylistCardScrollArea->hide();
+        mylistVirtualLayout->hide();
+        cardViewLayout->addWidget(mylistCardGridView, 1);
+        LOG("[Window] MyList uses the painted card grid");
+    }
     mylistContentLayout->addLayout(cardViewLayout, 1);  // Give card view layout stretch factor of 1
     
     pageMylist->addLayout(mylistContentLayout);
@@ -810,19 +878,16 @@ Window::Window()
 	connect(adbapi, SIGNAL(notifyMylistAdd(QString,int)), this, SLOT(getNotifyMylistAdd(QString,int)));
 	
 	// Connect unified Logger to log tab using modern Qt5+ syntax for type safety
-	connect(Logger::instance(), &Logger::logMessage, this, &Window::getNotifyLogAppend);
+	// (batches come from the logger's writer thread, so this is a queued connection)
+	connect(Logger::instance(), &Logger::logMessages, this, &Window::getNotifyLogBatch);
 
     // page hasher - hashes
-	hashes->setColumnCount(10);
-    hashes->setRowCount(0);
-    hashes->setRowHeight(0, 20);
     hashes->verticalHeader()->setDefaultSectionSize(20);
     hashes->setSelectionBehavior(QAbstractItemView::SelectRows);
     hashes->setEditTriggers(QAbstractItemView::NoEditTriggers);
     hashes->verticalHeader()->hide();
     hashes->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
     hashes->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-	hashes->setHorizontalHeaderLabels((QStringList() << "Filename" << "Progress" << "path" << "LF" << "LL" << "RF" << "RL" << "Ren" << "FP" << "Hash"));
     hashes->setColumnWidth(0, 600);
     hashes->setColumnWidth(9, 250); // Hash column width
     // Note: All other hasher UI setup is now handled by HasherCoordinator
@@ -935,6 +1000,16 @@ Window::Window()
     autoStartLayout->addWidget(autoStartEnabled);
     settingsMainLayout->addWidget(autoStartGroup);
     
+    // MyList View Group
+    QGroupBox *mylistViewGroup = new QGroupBox("MyList View");
+    QVBoxLayout *mylistViewLayout = new QVBoxLayout(mylistViewGroup);
+    paintedCardGridEnabled = new QCheckBox("Paint cards in a lightweight grid (applies after restart)");
+    paintedCardGridEnabled->setToolTip("Draw anime cards directly instead of creating a widget per card.\n"
+                                       "Scrolls smoothly through very large lists; the card under the mouse\n"
+                                       "becomes a full card with its episode list.");
+    mylistViewLayout->addWidget(paintedCardGridEnabled);
+    settingsMainLayout->addWidget(mylistViewGroup);
+    
     // File Marking Preferences Group
     QGroupBox *fileMarkingGroup = new QGroupBox("File Marking Preferences");
     QGridLayout *fileMarkingLayout = new QGridLayout(fileMarkingGroup);
@@ -1055,6 +1130,8 @@ Window::Window()
             this, &Window::onWatcherNewFilesDetected);
     connect(directoryWatcherManager, &DirectoryWatcherManager::filesDeleted,
             this, &Window::onWatcherFilesDeleted);
+    connect(directoryWatcherManager, &DirectoryWatcherManager::watchRootsChanged,
+            hasherCoordinator, &HasherCoordinator::setWatchRoots);
     
     // Session manager settings signals - update WatchSessionManager when settings change
     connect(sessionAheadBufferSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int value) {
@@ -1144,6 +1221,8 @@ Window::Window()
     
     // Connect card manager to watch session manager for file marks
     cardManager->setWatchSessionManager(watchSessionManager);
+    // Series chains come from the card manager's relation graph
+    watchSessionManager->setRelationGraph(cardManager->relationGraph());
     
     // Load session settings from WatchSessionManager into Settings tab UI
     sessionAheadBufferSpinBox->blockSignals(true);
@@ -1189,6 +1268,9 @@ Window::Window()
     deletionHistoryManager = new DeletionHistoryManager(this);
     deletionHistoryManager->ensureTablesExist();
     
+    // Change counter + dirty anime tracking that validates the startup card data snapshot
+    CardDataSnapshot::ensureChangeTracking();
+    
     // Create Current Choice widget and add to tab page
     currentChoiceWidget = new CurrentChoiceWidget(
         *deletionQueue, *deletionHistoryManager, *factorWeightLearner,
@@ -1200,16 +1282,13 @@ Window::Window()
             this, [this](int lid) {
         if (!watchSessionManager) return;
         // Store candidate info from the queue for history recording
-        for (const DeletionCandidate &c : deletionQueue->candidates()) {
-            if (c.lid == lid) {
-                DeletionCandidate info = c;
-                info.reason = info.reason.isEmpty() ? "user_avsb" : info.reason;
-                // Capture file size now before the file is deleted
-                QFileInfo fi(info.filePath);
-                info.fileSize = fi.exists() ? fi.size() : 0;
-                m_pendingDeletionInfo[lid] = info;
-                break;
-            }
+        if (const DeletionCandidate *c = deletionQueue->candidate(lid)) {
+            DeletionCandidate info = *c;
+            info.reason = info.reason.isEmpty() ? "user_avsb" : info.reason;
+            // Capture file size now before the file is deleted
+            QFileInfo fi(info.filePath);
+            info.fileSize = fi.exists() ? fi.size() : 0;
+            m_pendingDeletionInfo[lid] = info;
         }
         watchSessionManager->deleteFile(lid, watchSessionManager->isActualDeletionEnabled());
     });
@@ -1217,14 +1296,21 @@ Window::Window()
     connect(currentChoiceWidget, &CurrentChoiceWidget::runNowRequested,
             this, [this]() {
         if (deletionQueue) {
-            deletionQueue->rebuild();
-            currentChoiceWidget->refresh();
+            deletionQueue->rebuild();  // refreshed on queueRebuilt
         }
     });
     
     // Refresh Current Choice tab when queue changes
     connect(deletionQueue, &DeletionQueue::queueRebuilt, this, [this]() {
         if (currentChoiceWidget) currentChoiceWidget->refresh();
+        if (m_deletionCyclePending) {
+            m_deletionCyclePending = false;
+            runDeletionCycle();
+        }
+    });
+    
+    connect(deletionQueue, &DeletionQueue::queueUpdated, this, [this]() {
+        if (currentChoiceWidget) currentChoiceWidget->refresh();
     });
     
     // Wire tray icon ❗ to deletion queue choice needed
@@ -1238,6 +1324,10 @@ Window::Window()
     // Also record deletion in history for the Deletion tab.
     connect(watchSessionManager, &WatchSessionManager::fileDeleted, this, [this](int lid, int aid) {
         Q_UNUSED(aid);
+        // Freed space feeds the free-space forecast
+        if (m_pendingDeletionInfo.contains(lid)) {
+            watchSessionManager->recordFreedBytes(m_pendingDeletionInfo[lid].fileSize);
+        }
         // Record deletion history if we have candidate info
         if (deletionHistoryManager && m_pendingDeletionInfo.contains(lid)) {
             const DeletionCandidate &info = m_pendingDeletionInfo[lid];
@@ -1259,7 +1349,7 @@ Window::Window()
             currentChoiceWidget->setPreviewMode(!watchSessionManager->isDeletionNeeded());
         }
         if (deletionQueue) {
-            deletionQueue->rebuild();
+            deletionQueue->removeFile(lid);
         }
     });
     
@@ -1270,42 +1360,10 @@ Window::Window()
             .arg(deletionQueue != nullptr).arg(watchSessionManager != nullptr));
         if (!deletionQueue || !watchSessionManager) return;
         
+        // Classification runs in the background; the cycle continues in runDeletionCycle()
+        // once the rebuilt queue is published
+        m_deletionCyclePending = true;
         deletionQueue->rebuild();
-        
-        const DeletionCandidate *candidate = deletionQueue->next();
-        if (!candidate) {
-            LOG(QString("[Deletion] No deletion candidate available after rebuild"));
-            return;
-        }
-        
-        LOG(QString("[Deletion] Top candidate: lid=%1 tier=%2 score=%3 path='%4'")
-            .arg(candidate->lid).arg(candidate->tier).arg(candidate->learnedScore).arg(candidate->filePath));
-
-        // Procedural tiers (0-3) are auto-deleted without user interaction
-        if (candidate->tier < DeletionTier::LEARNED_PREFERENCE) {
-            LOG(QString("[Deletion] Auto-delete T%1 lid=%2").arg(candidate->tier).arg(candidate->lid));
-            DeletionCandidate info = *candidate;
-            QFileInfo fi(info.filePath);
-            info.fileSize = fi.exists() ? fi.size() : 0;
-            m_pendingDeletionInfo[candidate->lid] = info;
-            watchSessionManager->deleteFile(candidate->lid, watchSessionManager->isActualDeletionEnabled());
-            return;
-        }
-        
-        // Tier 4 (learned preference): show A vs B if untrained/low-confidence
-        if (deletionQueue->needsUserChoice()) {
-            LOG(QString("[Deletion] User choice needed for lid=%1").arg(candidate->lid));
-            if (trayIconManager) trayIconManager->setDeletionAlertVisible(true);
-            return;
-        }
-        
-        // Trained and confident — auto-delete the top candidate
-        LOG(QString("[Deletion] Auto-delete T4 lid=%1 score=%2").arg(candidate->lid).arg(candidate->learnedScore));
-        DeletionCandidate info = *candidate;
-        QFileInfo fi(info.filePath);
-        info.fileSize = fi.exists() ? fi.size() : 0;
-        m_pendingDeletionInfo[candidate->lid] = info;
-        watchSessionManager->deleteFile(candidate->lid, watchSessionManager->isActualDeletionEnabled());
     });
     
     
@@ -1427,6 +1485,9 @@ Window::Window()
     
     // Load auto-start setting
     autoStartEnabled->setChecked(adbapi->getAutoStartEnabled());
+    
+    // Load mylist view setting
+    paintedCardGridEnabled->setChecked(adbapi->getPaintedCardGrid());
 
     // end
     this->setLayout(layout);
@@ -1445,6 +1506,55 @@ Window::~Window()
     }
 }
 
+// Act on the top candidate of a freshly rebuilt deletion queue (requested by
+// WatchSessionManager::deletionCycleRequested)
+void Window::runDeletionCycle()
+{
+    if (!deletionQueue || !watchSessionManager) return;
+
+    const DeletionCandidate *candidate = deletionQueue->next();
+    if (!candidate) {
+        LOG(QString("[Deletion] No deletion candidate available after rebuild"));
+        watchSessionManager->stopProactiveDeletion();
+        return;
+    }
+
+    LOG(QString("[Deletion] Top candidate: lid=%1 tier=%2 score=%3 path='%4'")
+        .arg(candidate->lid).arg(candidate->tier).arg(candidate->learnedScore).arg(candidate->filePath));
+
+    // Procedural tiers (0-3) are auto-deleted without user interaction
+    if (candidate->tier < DeletionTier::LEARNED_PREFERENCE) {
+        LOG(QString("[Deletion] Auto-delete T%1 lid=%2").arg(candidate->tier).arg(candidate->lid));
+        DeletionCandidate info = *candidate;
+        QFileInfo fi(info.filePath);
+        info.fileSize = fi.exists() ? fi.size() : 0;
+        m_pendingDeletionInfo[candidate->lid] = info;
+        watchSessionManager->deleteFile(candidate->lid, watchSessionManager->isActualDeletionEnabled());
+        return;
+    }
+
+    // Tier 4 (learned preference): show A vs B if untrained/low-confidence
+    if (deletionQueue->needsUserChoice()) {
+        // Space is not short yet when deleting ahead of the threshold; don't ask
+        if (watchSessionManager->isProactiveDeletionRunning()) {
+            LOG(QString("[Deletion] Ahead-of-threshold batch needs a user choice for lid=%1, stopping").arg(candidate->lid));
+            watchSessionManager->stopProactiveDeletion();
+            return;
+        }
+        LOG(QString("[Deletion] User choice needed for lid=%1").arg(candidate->lid));
+        if (trayIconManager) trayIconManager->setDeletionAlertVisible(true);
+        return;
+    }
+
+    // Trained and confident — auto-delete the top candidate
+    LOG(QString("[Deletion] Auto-delete T4 lid=%1 score=%2").arg(candidate->lid).arg(candidate->learnedScore));
+    DeletionCandidate info = *candidate;
+    QFileInfo fi(info.filePath);
+    info.fileSize = fi.exists() ? fi.size() : 0;
+    m_pendingDeletionInfo[candidate->lid] = info;
+    watchSessionManager->deleteFile(candidate->lid, watchSessionManager->isActualDeletionEnabled());
+}
+
 bool Window::validateDatabaseConnection(const QSqlDatabase& db, const QString& methodName)
 {
 	if(!db.isValid() || !db.isOpen())
@@ -1927,22 +2037,175 @@ void Window::onMylistLoadingFinished(const QList<int> &aids)
     // Set the virtual layout for virtual scrolling (this sets the item factory)
     cardManager->setVirtualLayout(mylistVirtualLayout);
     
-    // Comprehensive preload of ALL data needed for card creation
-    // This eliminates ALL SQL queries from createCard()
-    if (!aids.isEmpty()) {
-        LOG(QString("[Virtual Scrolling] Preloading comprehensive card data for %1 anime...").arg(aids.size()));
-        cardManager->preloadCardCreationData(aids);
-        LOG("[Virtual Scrolling] Comprehensive card data preload complete");
+    // Restore card data, chains and the title index from the startup snapshot if it
+    // matches the database; anime changed since it was written are applied afterwards
+    pendingMylistPreloadAids.clear();
+    mylistPreloadQueue.clear();
+    ++mylistPreloadGeneration;
+    cardDataSyncedGeneration = -1;
+    bool titlesRestored = false;
+    bool restoredFromSnapshot = !aids.isEmpty() && loadCardDataSnapshot(titlesRestored);
+    
+    if (restoredFromSnapshot) {
+        // Mylist entries the snapshot doesn't know about are loaded with the deltas
+        for (int aid : aids) {
+            if (!cardManager->hasCachedData(aid) && !pendingSnapshotDeltaAids.contains(aid)) {
+                pendingSnapshotDeltaAids.append(aid);
+            }
+        }
+    } else if (!aids.isEmpty()) {
+        // Everything is read from the database from here on
+        cardDataSyncedGeneration = CardDataSnapshot::currentGeneration();
+        
+        // Show the mylist right away as skeleton cards (unsorted, without chains) and load
+        // the data of the cards on screen first, so they are filled before the first paint.
+        // The rest is loaded in chunks by preloadNextMylistChunk(), one per event-loop turn
+        cardManager->setAnimeIdList(aids, false);
+        if (mylistCardModel) {
+            mylistCardModel->reload();
+        }
+        const QList<int> loadingAids = onScreenAnimeIdsWithoutData();
+        if (!loadingAids.isEmpty()) {
+            LOG(QString("[Virtual Scrolling] Preloading card data for %1 visible anime first...").arg(loadingAids.size()));
+            cardManager->preloadCardCreationData(loadingAids);
+        }
+        pendingMylistPreloadAids = aids;
+        for (int aid : aids) {
+            if (!cardManager->hasCachedData(aid)) {
+                mylistPreloadQueue.append(aid);
+            }
+        }
+        LOG(QString("[Virtual Scrolling] Preloading card data for %1 more anime in chunks of %2...")
+            .arg(mylistPreloadQueue.size()).arg(MYLIST_PRELOAD_CHUNK));
+        scheduleMylistPreloadChunk();
+        return;
+    } else {
+        // Empty mylist: nothing to load, chains are still reset
+        buildChainsWithLogging();
     }
     
+    completeMylistLoading(aids.size(), titlesRestored);
+}
+
+// Queue the next preload chunk behind the events already pending (paints, scrolling)
+void Window::scheduleMylistPreloadChunk()
+{
+    const int generation = mylistPreloadGeneration;
+    QTimer::singleShot(0, this, [this, generation]() {
+        // A newer mylist load has taken over
+        if (generation == mylistPreloadGeneration) {
+            preloadNextMylistChunk();
+        }
+    });
+}
+
+// Load the card data of up to MYLIST_PRELOAD_CHUNK anime; skeleton cards on screen go first
+void Window::preloadNextMylistChunk()
+{
+    if (pendingMylistPreloadAids.isEmpty()) {
+        return;
+    }
+    
+    QList<int> chunk;
+    QSet<int> chunkAids;
+    for (int aid : onScreenAnimeIdsWithoutData()) {
+        if (chunk.size() >= MYLIST_PRELOAD_CHUNK) {
+            break;
+        }
+        if (!cardManager->hasCachedData(aid) && !chunkAids.contains(aid)) {
+            chunk.append(aid);
+            chunkAids.insert(aid);
+        }
+    }
+    qsizetype consumed = 0;
+    while (consumed < mylistPreloadQueue.size() && chunk.size() < MYLIST_PRELOAD_CHUNK) {
+        const int aid = mylistPreloadQueue.at(consumed++);
+        if (!cardManager->hasCachedData(aid) && !chunkAids.contains(aid)) {
+            chunk.append(aid);
+            chunkAids.insert(aid);
+        }
+    }
+    mylistPreloadQueue.remove(0, consumed);
+    mylistPreloadQueue.removeIf([&chunkAids](int aid) { return chunkAids.contains(aid); });
+    
+    // Fills the skeleton cards of the chunk (see MyListCardManager::fillLoadingCards);
+    // painted grid rows have no card and are repainted from the new data
+    if (!chunk.isEmpty()) {
+        cardManager->preloadCardCreationData(chunk);
+        if (mylistCardModel) {
+            for (int aid : std::as_const(chunk)) {
+                mylistCardModel->onCardDataChanged(aid);
+            }
+        }
+    }
+    
+    if (!mylistPreloadQueue.isEmpty()) {
+        scheduleMylistPreloadChunk();
+        return;
+    }
+    finishMylistPreload();
+}
+
+// Anime shown on screen whose data is still missing: the skeleton cards, or the visible
+// rows of the painted grid, which has no cards
+QList<int> Window::onScreenAnimeIdsWithoutData() const
+{
+    if (!mylistCardGridView || !mylistCardModel) {
+        return cardManager->getLoadingCardAnimeIds();
+    }
+    
+    // Rows flow left to right, top to bottom: find the first row reaching into the viewport
+    const int viewportHeight = mylistCardGridView->viewport()->height();
+    const int rowCount = mylistCardModel->rowCount();
+    int first = 0;
+    int last = rowCount;
+    while (first < last) {
+        const int middle = first + (last - first) / 2;
+        if (mylistCardGridView->visualRect(mylistCardModel->index(middle)).bottom() < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    
+    QList<int> aids;
+    for (int row = first; row < rowCount; ++row) {
+        const QModelIndex index = mylistCardModel->index(row);
+        const QRect rect = mylistCardGridView->visualRect(index);
+        if (!rect.isValid() || rect.top() >= viewportHeight) {
+            break;
+        }
+        const int aid = index.data(AnimeCardModel::AnimeIdRole).toInt();
+        if (!cardManager->hasCachedData(aid)) {
+            aids.append(aid);
+        }
+    }
+    return aids;
+}
+
+// All card data is loaded: build chains, then sort and filter
+void Window::finishMylistPreload()
+{
+    const QList<int> aids = pendingMylistPreloadAids;
+    pendingMylistPreloadAids.clear();
+    LOG("[Virtual Scrolling] Comprehensive card data preload complete");
+    
     // Build chains from all cached data BEFORE applying any filters
     buildChainsWithLogging();
     
+    completeMylistLoading(aids.size(), false);
+}
+
+// Second half of the mylist load, once card data and chains are available
+void Window::completeMylistLoading(int animeCount, bool titlesRestored)
+{
     // Get all cards for backward compatibility (will be empty initially with virtual scrolling)
     animeCards = cardManager->getAllCards();
     
     // Reload alternative titles for filtering
-    loadAnimeAlternativeTitlesForFiltering();
+    if (!titlesRestored) {
+        loadAnimeAlternativeTitlesForFiltering();
+    }
     
     // Restore filter settings first
     restoreMylistSorting();
@@ -1956,8 +2219,8 @@ void Window::onMylistLoadingFinished(const QList<int> &aids)
     sortMylistCards(filterSidebar->getSortIndex());
     LOG("[Window] sortMylistCards() returned");
     
-    mylistStatusLabel->setText(QString("MyList Status: %1 anime (virtual scrolling)").arg(aids.size()));
-    LOG(QString("[Virtual Scrolling] Ready to display %1 anime").arg(aids.size()));
+    mylistStatusLabel->setText(QString("MyList Status: %1 anime (virtual scrolling)").arg(animeCount));
+    LOG(QString("[Virtual Scrolling] Ready to display %1 anime").arg(animeCount));
     
     // Mark initial loading as complete so new anime can be detected
     LOG("[Window] Setting initial load complete");
@@ -1977,7 +2240,156 @@ void Window::onMylistLoadingFinished(const QList<int> &aids)
         deletionQueue->rebuild();
     }
     
-    LOG("[Window] onMylistLoadingFinished complete");
+    // Cards from the snapshot are on screen now; fold in changes made since it was written
+    if (!pendingSnapshotDeltaAids.isEmpty()) {
+        QTimer::singleShot(0, this, &Window::applyCardSnapshotDeltas);
+    }
+    
+    LOG("[Window] Mylist loading complete");
+}
+
+// Restore card data from the startup snapshot. Returns false (leaving the card manager
+// untouched) if there is no snapshot or it doesn't match the current database.
+bool Window::loadCardDataSnapshot(bool &titlesRestored)
+{
+    titlesRestored = false;
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    CardDataSnapshot snapshot(CardDataSnapshot::defaultPath());
+    if (!snapshot.open()) {
+        LOG(QString("[Window] Card data snapshot not used: %1").arg(snapshot.errorString()));
+        return false;
+    }
+    if (!CardDataSnapshot::isCurrent(snapshot.generation())) {
+        LOG(QString("[Window] Card data snapshot generation %1 does not match database (%2), ignoring it")
+            .arg(snapshot.generation()).arg(CardDataSnapshot::snapshotGeneration()));
+        return false;
+    }
+    
+    QDataStream in(snapshot.payload());
+    in.setVersion(snapshot.streamVersion());
+    
+    bool titlesMylistOnly = false;
+    AnimeMetadataCache titles;
+    in >> titlesMylistOnly >> titles;
+    if (in.status() != QDataStream::Ok || !cardManager->readSnapshot(in)) {
+        LOG("[Window] Card data snapshot could not be read, removing it");
+        snapshot.remove();
+        return false;
+    }
+    
+    // The title index only covers mylist anime; "all anime" mode rebuilds it anyway
+    if (titlesMylistOnly && filterSidebar->getInMyListOnly()) {
+        animeAlternativeTitlesCache = titles;
+        titlesRestored = true;
+    }
+    
+    pendingSnapshotDeltaGeneration = CardDataSnapshot::currentGeneration();
+    pendingSnapshotDeltaAids = CardDataSnapshot::dirtyAnimeIds();
+    
+    LOG(QString("[Window] Restored card data snapshot (generation %1) in %2 ms, %3 anime changed since")
+        .arg(snapshot.generation()).arg(timer.elapsed()).arg(pendingSnapshotDeltaAids.size()));
+    return true;
+}
+
+// Re-read anime that changed since the snapshot was written and refresh the view
+void Window::refreshMylistGridEditor(int aid)
+{
+    // The grid's real card is not one of the manager's cards (getCard() does not return it);
+    // a new one picks up the current data and lock state through cardBound
+    if (!mylistCardGridView || !mylistCardGridEditorIndex.isValid()
+        || mylistCardGridEditorIndex.data(AnimeCardModel::AnimeIdRole).toInt() != aid) {
+        return;
+    }
+    mylistCardGridView->closePersistentEditor(mylistCardGridEditorIndex);
+    mylistCardGridView->openPersistentEditor(mylistCardGridEditorIndex);
+}
+
+void Window::applyCardSnapshotDeltas()
+{
+    if (pendingSnapshotDeltaAids.isEmpty()) {
+        return;
+    }
+    
+    QList<int> aids = pendingSnapshotDeltaAids;
+    pendingSnapshotDeltaAids.clear();
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    cardManager->applySnapshotDeltas(aids);
+    for (int aid : std::as_const(aids)) {
+        updateAnimeAlternativeTitlesInCache(aid);
+    }
+    cardManager->updateMultipleCards(QSet<int>(aids.cbegin(), aids.cend()));
+    
+    // Every change listed when the snapshot was restored is in the cache now
+    cardDataSyncedGeneration = pendingSnapshotDeltaGeneration;
+    
+    applyMylistFilters();
+    sortMylistCards(filterSidebar->getSortIndex());
+    
+    LOG(QString("[Window] Applied card data snapshot deltas for %1 anime in %2 ms")
+        .arg(aids.size()).arg(timer.elapsed()));
+}
+
+// Write the startup snapshot (called on shutdown)
+void Window::saveCardDataSnapshot()
+{
+    if (!cardManager || !cardManager->isSnapshotable()) {
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    CardDataSnapshot snapshot(CardDataSnapshot::defaultPath());
+    if (snapshot.path().isEmpty()) {
+        return;
+    }
+    
+    // Capture the generation first: anything changed after this point stays dirty
+    qint64 generation = CardDataSnapshot::currentGeneration();
+    if (generation < 0) {
+        return;
+    }
+    
+    // Anime that left the mylist during the session would come back with the snapshot
+    QSet<int> mylistAids;
+    QSqlQuery q(QSqlDatabase::database());
+    if (!q.exec("SELECT DISTINCT aid FROM mylist")) {
+        LOG(QString("[Window] Failed to list mylist anime for the snapshot: %1").arg(q.lastError().text()));
+        return;
+    }
+    while (q.next()) {
+        mylistAids.insert(q.value(0).toInt());
+    }
+    
+    // The cache is written as it is, without re-reading anything on the way out. The
+    // in-memory cache is not updated for every database write during a session, so
+    // anime changed after cardDataSyncedGeneration stay dirty and are re-read as deltas
+    // after the first paint of the next startup
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(CardDataSnapshot::STREAM_VERSION);
+        out << !allAnimeTitlesLoaded << animeAlternativeTitlesCache;
+        if (!cardManager->writeSnapshot(out, mylistAids)) {
+            LOG("[Window] Failed to serialize card data snapshot");
+            return;
+        }
+    }
+    
+    if (!snapshot.write(payload, generation)) {
+        LOG(QString("[Window] Failed to write card data snapshot: %1").arg(snapshot.errorString()));
+        return;
+    }
+    CardDataSnapshot::markSnapshotWritten(generation, cardDataSyncedGeneration);
+    
+    LOG(QString("[Window] Wrote card data snapshot (%1 KB, generation %2, current up to %3) in %4 ms")
+        .arg(payload.size() / 1024).arg(generation).arg(cardDataSyncedGeneration).arg(timer.elapsed()));
 }
 
 
@@ -2143,6 +2555,11 @@ void Window::restoreMylistSorting()
 
 void Window::hasherFinished()
 {
+	// The idle period before deleting ahead of the threshold starts now
+	if (watchSessionManager) {
+		watchSessionManager->noteDiskActivity();
+	}
+	
 	// Batch update all accumulated hashes to database for files not already updated
 	// (files where addtomylist was unchecked are updated here)
 	if (!pendingHashUpdates.isEmpty())
@@ -2152,7 +2569,7 @@ void Window::hasherFinished()
 	}
 	
 	// Note: All UI updates are handled by HasherCoordinator::onHashingFinished()
-	// File identification happens immediately in HasherCoordinator::onFileHashed()
+	// File identification is batched by HasherCoordinator::processPendingHashedFiles()
 	
 	// Rebuild deletion queue after hashing so newly identified files are classified
 	if (deletionQueue) {
@@ -2184,43 +2601,30 @@ bool hashes_::event(QEvent *e)
 		QKeyEvent *keyEvent = static_cast<QKeyEvent*>(e);
 		if(keyEvent->key() == Qt::Key_Delete)
 		{
-			if(!hasherThreadPool->isRunning())
+			HashingJobModel *jobs = qobject_cast<HashingJobModel*>(this->model());
+			if(jobs && !hasherThreadPool->isRunning())
 			{
 				this->setUpdatesEnabled(0);
-				QList<QTableWidgetItem *> selitems = this->selectedItems();
 				QList<int> selrows;
-				while(!selitems.isEmpty())
+				const QModelIndexList selected = this->selectionModel()->selectedRows();
+				for(const QModelIndex &index : selected)
 				{
-					if(!selrows.contains(selitems.first()->row()))
-					{
-						selrows.append(selitems.first()->row());
-						selitems.pop_front();
-					}
-					else
-					{
-						selitems.pop_front();
-					}
-				}
-//                qsort(selrows.begin(), selrows.end());
-                std::sort(selrows.begin(), selrows.end());
-				while(!selrows.isEmpty())
-				{
-				int item = selrows.last();
-					selrows.pop_back();
-					this->removeRow(item);
+					selrows.append(index.row());
 				}
+				// One removal per contiguous block of rows
+				jobs->removeRowsAt(selrows);
 				this->setUpdatesEnabled(1);
 			}
 			return 1;
 		}
 		else
 		{
-			return QTableWidget::event(e);
+			return QTableView::event(e);
 		}
 	}
 	else
 	{
-		return QTableWidget::event(e);
+		return QTableView::event(e);
 	}
 }
 
@@ -2384,6 +2788,21 @@ void Window::getNotifyLogAppend(QString str)
 	// CrashLog is kept separate for emergency crash situations only
 }
 
+void Window::getNotifyLogBatch(const QStringList &lines)
+{
+	if (!logOutput || lines.isEmpty()) {
+		return;
+	}
+	// One append per batch: the log tab lays out the text once, not once per line
+	const QString time = QTime::currentTime().toString();
+	QStringList stamped;
+	stamped.reserve(lines.size());
+	for (const QString &line : lines) {
+		stamped.append(QString("%1: %2").arg(time, line));
+	}
+	logOutput->append(stamped.join('\n'));
+}
+
 void Window::getNotifyLoginChagned(QString login)
 {
 	adbapi->setUsername(login);
@@ -2498,6 +2917,9 @@ void Window::saveSettings()
 		setAutoStartEnabled(autoStartNowEnabled);
 	}
 	
+	// Save mylist view setting (the view is built at startup)
+	adbapi->setPaintedCardGrid(paintedCardGridEnabled->isChecked());
+	
 	// Save file marking preferences
 	QLineEdit *audioEdit = this->findChild<QLineEdit*>("preferredAudioLanguagesEdit");
 	if (audioEdit) {
@@ -2596,135 +3018,130 @@ void Window::getNotifyMylistAdd(QString tag, int code)
         return;
     }
     
-	for(int i=0; i<hashes->rowCount(); i++)
+	// The hasher job waiting on this FILE/MYLISTADD reply
+	HashingJobModel *jobs = hasherCoordinator->getHashingJobs();
+	const int jobId = jobs->jobIdForTag(tag);
+	if(const HashingJobModel::Job *waiting = jobs->job(jobId))
 	{
-        if(hashes->item(i, 5)->text() == tag || hashes->item(i, 6)->text() == tag)
-		{
-			QColor green_light; green_light.setRgb(0, 255, 0);
-			QColor green_dark; green_dark.setRgb(0, 140, 0);
-            QColor red; red.setRgb(255, 0, 0);
-            if(code == 310) // already in mylist
+		const HashingJobModel::Job job = *waiting;
+        if(code == 310) // already in mylist
+        {
+            jobs->setState(jobId, HashingJobModel::State::AlreadyInMylist);
+            QString msg310 = "310-2";
+            LOG(msg310);
+            
+            // Store local file path for already existing entry
+            QString localPath = job.filePath;
+            int lid = adbapi->UpdateLocalPath(tag, localPath);
+            
+            // Update only the specific mylist entry instead of reloading entire tree
+            if(lid > 0)
             {
-                hashes->item(i, 0)->setBackground(green_light.toRgb());
-                hashes->item(i, 1)->setText("2");
-                QString msg310 = "310-2";
-                LOG(msg310);
+                LOG(QString("Updating anime card for lid=%1 after successful mylist add (code 310)").arg(lid));
+                updateOrAddMylistEntry(lid);
                 
-                // Store local file path for already existing entry
-                QString localPath = hashes->item(i, 2)->text();
-                int lid = adbapi->UpdateLocalPath(tag, localPath);
-                
-                // Update only the specific mylist entry instead of reloading entire tree
-                if(lid > 0)
-                {
-                    LOG(QString("Updating anime card for lid=%1 after successful mylist add (code 310)").arg(lid));
-                    updateOrAddMylistEntry(lid);
-                    
-                    // Note: Deletion mechanism now uses on-demand file selection
-                    // autoMarkFilesForDeletion() is simplified to just trigger deletion when space is low
-                    if (watchSessionManager && watchSessionManager->isAutoMarkDeletionEnabled()) {
-                        watchSessionManager->autoMarkFilesForDeletion();
-                    }
-                }
-                else
-                {
-                    LOG(QString("WARNING: UpdateLocalPath returned lid=%1 for path=%2 (code 310 - already in mylist). Card may not be created/updated.")
-                        .arg(lid).arg(localPath));
-                    
-                    // Even if we couldn't find the mylist entry in the local database,
-                    // we know the file is in AniDB's mylist (310 response), so update binding_status
-                    // to prevent the file from reappearing in unknown files list on restart
-                    adbapi->UpdateLocalFileBindingStatus(localPath, 1); // 1 = bound_to_anime
-                    adbapi->UpdateLocalFileStatus(localPath, 2); // 2 = in anidb
+                // Note: Deletion mechanism now uses on-demand file selection
+                // autoMarkFilesForDeletion() is simplified to just trigger deletion when space is low
+                if (watchSessionManager && watchSessionManager->isAutoMarkDeletionEnabled()) {
+                    watchSessionManager->autoMarkFilesForDeletion();
                 }
-                
-                // Remove from unknown files widget if present (re-check succeeded)
-                unknownFilesManager->removeFileByPath(localPath);
-                return;
             }
-            if(code == 320)
+            else
             {
-                hashes->item(i, 0)->setBackground(red.toRgb());
-                hashes->item(i, 1)->setText("4"); // no such file
-                QString msg320 = "320-4";
-                LOG(msg320);
-                
-                // Update status in local_files to 3 (not in anidb)
-                QString localPath = hashes->item(i, 2)->text();
-                adbapi->UpdateLocalFileStatus(localPath, 3);
-                
-                // Add to unknown files widget for manual binding (only if not already there)
-                QString filename = hashes->item(i, 0)->text();
-                QString filepath = hashes->item(i, 2)->text();
-                QString hash = hashes->item(i, 9)->text();
-                
-                // Check if file is already in unknown files widget (avoid duplicates)
-                QTableWidget *unknownFilesTable = unknownFilesManager->getTableWidget();
-                bool alreadyExists = false;
-                for(int row = 0; row < unknownFilesTable->rowCount(); ++row)
-                {
-                    QTableWidgetItem *item = unknownFilesTable->item(row, 0);
-                    if(item && item->toolTip() == filepath)
-                    {
-                        alreadyExists = true;
-                        break;
-                    }
-                }
+                LOG(QString("WARNING: UpdateLocalPath returned lid=%1 for path=%2 (code 310 - already in mylist). Card may not be created/updated.")
+                    .arg(lid).arg(localPath));
                 
-                if(!alreadyExists)
-                {
-                    // Get file size
-                    QFileInfo fileInfo(filepath);
-                    qint64 fileSize = fileInfo.size();
-                    
-                    unknownFilesManager->insertFile(filename, filepath, hash, fileSize);
-                    LOG(QString("Added unknown file to manual binding widget: %1").arg(filename));
-                }
-                else
+                // Even if we couldn't find the mylist entry in the local database,
+                // we know the file is in AniDB's mylist (310 response), so update binding_status
+                // to prevent the file from reappearing in unknown files list on restart
+                adbapi->UpdateLocalFileBindingStatus(localPath, 1); // 1 = bound_to_anime
+                adbapi->UpdateLocalFileStatus(localPath, 2); // 2 = in anidb
+            }
+            
+            // Remove from unknown files widget if present (re-check succeeded)
+            unknownFilesManager->removeFileByPath(localPath);
+            return;
+        }
+        if(code == 320)
+        {
+            jobs->setState(jobId, HashingJobModel::State::NotInAniDB); // no such file
+            QString msg320 = "320-4";
+            LOG(msg320);
+            
+            // Update status in local_files to 3 (not in anidb)
+            QString localPath = job.filePath;
+            adbapi->UpdateLocalFileStatus(localPath, 3);
+            
+            // Add to unknown files widget for manual binding (only if not already there)
+            QString filename = job.filename;
+            QString filepath = job.filePath;
+            QString hash = job.hash;
+            
+            // Check if file is already in unknown files widget (avoid duplicates)
+            QTableWidget *unknownFilesTable = unknownFilesManager->getTableWidget();
+            bool alreadyExists = false;
+            for(int row = 0; row < unknownFilesTable->rowCount(); ++row)
+            {
+                QTableWidgetItem *item = unknownFilesTable->item(row, 0);
+                if(item && item->toolTip() == filepath)
                 {
-                    LOG(QString("File already in unknown files widget, skipping: %1").arg(filename));
+                    alreadyExists = true;
+                    break;
                 }
+            }
+            
+            if(!alreadyExists)
+            {
+                // Get file size
+                QFileInfo fileInfo(filepath);
+                qint64 fileSize = fileInfo.size();
                 
-                return;
+                unknownFilesManager->insertFile(filename, filepath, hash, fileSize);
+                LOG(QString("Added unknown file to manual binding widget: %1").arg(filename));
             }
-            else if(code == 311 || code == 210)
+            else
+            {
+                LOG(QString("File already in unknown files widget, skipping: %1").arg(filename));
+            }
+            
+            return;
+        }
+        else if(code == 311 || code == 210)
+		{
+            jobs->setState(jobId, HashingJobModel::State::AddedToMylist);
+            QString msg311 = "311/210-3";
+            LOG(msg311);
+			
+			// Store local file path for newly added entry
+			QString localPath = job.filePath;
+			int lid = adbapi->UpdateLocalPath(tag, localPath);
+			
+			if(hasherCoordinator->getRenameTo()->checkState() > 0)
 			{
-                hashes->item(i, 0)->setBackground(green_dark.toRgb());
-				hashes->item(i, 1)->setText("3");
-                QString msg311 = "311/210-3";
-                LOG(msg311);
-				
-				// Store local file path for newly added entry
-				QString localPath = hashes->item(i, 2)->text();
-				int lid = adbapi->UpdateLocalPath(tag, localPath);
-				
-				if(hasherCoordinator->getRenameTo()->checkState() > 0)
-				{
-					// TODO: rename
-				}
+				// TODO: rename
+			}
+			
+			// Update only the specific mylist entry instead of reloading entire tree
+			if(lid > 0)
+			{
+				LOG(QString("Updating anime card for lid=%1 after successful mylist add (code %2)").arg(lid).arg(code));
+				updateOrAddMylistEntry(lid);
 				
-				// Update only the specific mylist entry instead of reloading entire tree
-				if(lid > 0)
-				{
-					LOG(QString("Updating anime card for lid=%1 after successful mylist add (code %2)").arg(lid).arg(code));
-					updateOrAddMylistEntry(lid);
-					
-					// Note: Deletion mechanism now uses on-demand file selection
-					if (watchSessionManager && watchSessionManager->isAutoMarkDeletionEnabled()) {
-						watchSessionManager->autoMarkFilesForDeletion();
-					}
-				}
-				else
-				{
-					LOG(QString("WARNING: UpdateLocalPath returned lid=%1 for path=%2 (code %3 - newly added). Card may not be created/updated.")
-						.arg(lid).arg(localPath).arg(code));
+				// Note: Deletion mechanism now uses on-demand file selection
+				if (watchSessionManager && watchSessionManager->isAutoMarkDeletionEnabled()) {
+					watchSessionManager->autoMarkFilesForDeletion();
 				}
-				
-				// Remove from unknown files widget if present (file was successfully added)
-				unknownFilesManager->removeFileByPath(localPath);
-				
-				return;
 			}
+			else
+			{
+				LOG(QString("WARNING: UpdateLocalPath returned lid=%1 for path=%2 (code %3 - newly added). Card may not be created/updated.")
+					.arg(lid).arg(localPath).arg(code));
+			}
+			
+			// Remove from unknown files widget if present (file was successfully added)
+			unknownFilesManager->removeFileByPath(localPath);
+			
+			return;
 		}
 	}
 }
@@ -3380,6 +3797,11 @@ void Window::onWatcherNewFilesDetected(const QStringList &filePaths)
 		return;
 	}
 	
+	// New downloads feed the free-space forecast and mark the drive as busy
+	if (watchSessionManager) {
+		watchSessionManager->recordNewFiles(filePaths);
+	}
+	
 	// Start overall timing
 	QElapsedTimer overallTimer;
 	overallTimer.start();
@@ -3433,32 +3855,24 @@ void Window::onWatcherNewFilesDetected(const QStringList &filePaths)
 		// Separate files with existing hashes from those that need hashing
 		// Check ALL files with progress="0" or "1", not just newly added ones
 		int filesToHashCount = 0;
-		QList<QPair<int, QString>> filesWithHashes; // row index, file path
+		HashingJobModel *jobs = hasherCoordinator->getHashingJobs();
+		QList<int> filesWithHashes; // job ids
 		
-		for (int i = 0; i < hashes->rowCount(); i++) {
-			QString progress = hashes->item(i, 1)->text();
-			QString filePath = hashes->item(i, 2)->text();
-			QString existingHash = hashes->item(i, 9)->text();
+		for (int i = 0; i < jobs->rowCount(); i++) {
+			const HashingJobModel::Job &job = jobs->jobAt(i);
 			
-			// Process files with progress="0" or progress="1" (already hashed but not yet API-processed)
-			if (progress == "0" || progress == "1") {
-				// Check if file has pending API calls (tags in columns 5 or 6)
-				// Tags are "?" initially, set to actual tag when API call is queued, and "0" when completed/not needed
-				QString fileTag = hashes->item(i, 5)->text();
-				QString mylistTag = hashes->item(i, 6)->text();
-				bool hasPendingAPICalls = (!fileTag.isEmpty() && fileTag != "?" && fileTag != "0") || 
-				                          (!mylistTag.isEmpty() && mylistTag != "?" && mylistTag != "0");
-				
-				if (!existingHash.isEmpty()) {
-					// Skip files with pending API calls to avoid duplicate processing
-					if (!hasPendingAPICalls) {
-						filesWithHashes.append(qMakePair(i, filePath));
+			// Process pending files and files already hashed but not yet API-processed
+			if (job.state == HashingJobModel::State::Pending || job.state == HashingJobModel::State::Hashed) {
+				if (!job.hash.isEmpty()) {
+					// Skip files with pending API calls (FILE/MYLISTADD tag set) to avoid duplicate processing
+					if (!job.hasPendingApiCall()) {
+						filesWithHashes.append(job.id);
 					}
 				} else {
 					// File needs to be hashed
-					// Note: If progress="1" but no hash, this is an inconsistent state
-					if (progress == "1") {
-						LOG(QString("Warning: File at row %1 has progress=1 but no hash - inconsistent state").arg(i));
+					// Note: If hashed but no hash, this is an inconsistent state
+					if (job.state == HashingJobModel::State::Hashed) {
+						LOG(QString("Warning: File at row %1 is hashed but has no hash - inconsistent state").arg(i));
 					}
 					filesToHashCount++;
 				}
@@ -3468,19 +3882,12 @@ void Window::onWatcherNewFilesDetected(const QStringList &filePaths)
 		// Queue files with existing hashes for deferred processing to prevent UI freeze
 		// Instead of processing them all synchronously (which blocks the UI), we queue them
 		// and process in small batches using a timer
-		for (const auto& pair : filesWithHashes) {
-			int rowIndex = pair.first;
-			QString filePath = pair.second;
-			QString filename = hashes->item(rowIndex, 0)->text();
-			QString hexdigest = hashes->item(rowIndex, 9)->text();
-			
-			// Get file size
-			QFileInfo fileInfo(filePath);
-			qint64 fileSize = fileInfo.size();
+		for (int jobId : filesWithHashes) {
+			const HashingJobModel::Job *job = jobs->job(jobId);
 			
 			// Queue for deferred processing using HasherCoordinator
-			HashingTask task(filePath, filename, hexdigest, fileSize);
-			task.setRowIndex(rowIndex);
+			HashingTask task(job->filePath, job->filename, job->hash, job->size);
+			task.setJobId(jobId);
 			task.setUseUserSettings(false);  // Use auto-watcher defaults
 			task.setAddToMylist(true);  // Auto-watcher always adds to mylist when logged in
 			task.setMarkWatchedState(Qt::Unchecked);  // Default for auto-watcher
@@ -3511,7 +3918,9 @@ void Window::onWatcherNewFilesDetected(const QStringList &filePaths)
 			}
 		}
 	} else {
-		LOG("Files added to hasher. Hasher is busy - click Start to hash queued files.");
+		// Workers held back by a root's hasher cap can take files of other roots right away
+		hasherCoordinator->provideNextFileToHash();
+		LOG("Files added to hasher. Hasher is busy - queued files are hashed as threads become free.");
 	}
 	
 	// Log total time for the entire function
@@ -3678,6 +4087,11 @@ void Window::onPlaybackStateChanged(int lid, bool isPlaying)
 			m_animationTimer->stop();
 		}
 	}
+	
+	// No deletion ahead of the threshold during playback
+	if (watchSessionManager) {
+		watchSessionManager->setPlaybackActive(!m_playingItems.isEmpty());
+	}
 }
 
 void Window::onAnimationTimerTimeout()
@@ -3782,65 +4196,44 @@ void Window::sortMylistCards(int sortIndex)
 	// - Within each chain, maintain sequential order (prequel -> sequel)
 	// This happens in applyMylistFilters(), but sortMylistCards() needs to re-sort when user changes criteria
 	
-	// For sorting, we need to access card data. Build a combined map from all sources.
-	QMap<int, AnimeCard*> cardsMap;
-	
-	// First add cards from the card manager
-	for (AnimeCard* card : cardManager->getAllCards()) {
-		cardsMap[card->getAnimeId()] = card;
-	}
-	
-	// Also include cards from the legacy animeCards list (for backward compatibility)
-	for (AnimeCard* card : std::as_const(animeCards)) {
-		if (!cardsMap.contains(card->getAnimeId())) {
-			cardsMap[card->getAnimeId()] = card;
-		}
+	// Map UI sortIndex to AnimeChain::SortCriteria
+	AnimeChain::SortCriteria sortCriteria;
+	switch (sortIndex) {
+		case 0:  // Anime Title
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeTitle;
+			break;
+		case 1:  // Type
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeType;
+			break;
+		case 2:  // Aired Date
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeDate;
+			break;
+		case 3:  // Episodes (Count)
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeEpisodeCount;
+			break;
+		case 4:  // Completion %
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeCompletion;
+			break;
+		case 5:  // Last Played
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeLastPlayed;
+			break;
+		case 6:  // Recent Episode Air Date
+			sortCriteria = AnimeChain::SortCriteria::ByRecentEpisodeAirDate;
+			break;
+		default:
+			sortCriteria = AnimeChain::SortCriteria::ByRepresentativeDate;
+			break;
 	}
 	
-	// Helper lambda to get cached data for an anime
-	// This allows sorting to work with virtual scrolling where cards may not exist
-	auto getCachedData = [this](int aid) -> MyListCardManager::CachedAnimeData {
-		return cardManager->getCachedAnimeData(aid);
-	};
-	
 	// Handle nested sorting when series chain is enabled
 	if (seriesChainEnabled) {
 		LOG("[Window] Series chain enabled - delegating to MyListCardManager for chain sorting");
 		
-		// Map UI sortIndex to AnimeChain::SortCriteria
-		AnimeChain::SortCriteria chainCriteria;
-		switch (sortIndex) {
-			case 0:  // Anime Title
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeTitle;
-				break;
-			case 1:  // Type
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeType;
-				break;
-			case 2:  // Aired Date
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeDate;
-				break;
-			case 3:  // Episodes (Count)
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeEpisodeCount;
-				break;
-			case 4:  // Completion %
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeCompletion;
-				break;
-			case 5:  // Last Played
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeLastPlayed;
-				break;
-			case 6:  // Recent Episode Air Date
-				chainCriteria = AnimeChain::SortCriteria::ByRecentEpisodeAirDate;
-				break;
-			default:
-				chainCriteria = AnimeChain::SortCriteria::ByRepresentativeDate;
-				break;
-		}
-		
 		LOG(QString("[Window] Sorting chains by criteria %1 (sortIndex=%2), ascending=%3")
-			.arg(static_cast<int>(chainCriteria)).arg(sortIndex).arg(sortAscending));
+			.arg(static_cast<int>(sortCriteria)).arg(sortIndex).arg(sortAscending));
 		
 		// Sort chains using the selected criteria and sort order
-		cardManager->sortChains(chainCriteria, sortAscending);
+		cardManager->sortChains(sortCriteria, sortAscending);
 		
 		// Get the updated anime ID list from card manager (already reordered)
 		animeIds = cardManager->getAnimeIdList();
@@ -3851,6 +4244,9 @@ void Window::sortMylistCards(int sortIndex)
 		if (mylistVirtualLayout) {
 			mylistVirtualLayout->refresh();
 		}
+		if (mylistCardModel) {
+			mylistCardModel->reload();
+		}
 		
 		// Also update the legacy animeCards list order for backward compatibility
 		animeCards.clear();
@@ -3879,288 +4275,9 @@ void Window::sortMylistCards(int sortIndex)
 	}
 	
 	// Regular sorting (no series chain grouping)
-	// Sort based on criterion
-	// Use cached data when card widgets don't exist (virtual scrolling)
-	switch (sortIndex) {
-		case 0: // Anime Title
-			std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending](int aidA, int aidB) {
-				AnimeCard* a = cardsMap.value(aidA);
-				AnimeCard* b = cardsMap.value(aidB);
-				
-				// Get data from cards or cache
-				bool hiddenA = a ? a->isHidden() : getCachedData(aidA).isHidden();
-				bool hiddenB = b ? b->isHidden() : getCachedData(aidB).isHidden();
-				QString titleA = a ? a->getAnimeTitle() : getCachedData(aidA).animeName();
-				QString titleB = b ? b->getAnimeTitle() : getCachedData(aidB).animeName();
-				
-				// Hidden cards always go to the bottom
-				if (hiddenA != hiddenB) {
-					return hiddenB;  // non-hidden comes before hidden
-				}
-				
-				if (sortAscending) {
-					return titleA < titleB;
-				} else {
-					return titleA > titleB;
-				}
-			});
-			break;
-		case 1: // Type
-			std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending](int aidA, int aidB) {
-				AnimeCard* a = cardsMap.value(aidA);
-				AnimeCard* b = cardsMap.value(aidB);
-				
-				// Get data from cards or cache
-				bool hiddenA = a ? a->isHidden() : getCachedData(aidA).isHidden();
-				bool hiddenB = b ? b->isHidden() : getCachedData(aidB).isHidden();
-				QString titleA = a ? a->getAnimeTitle() : getCachedData(aidA).animeName();
-				QString titleB = b ? b->getAnimeTitle() : getCachedData(aidB).animeName();
-				QString typeA = a ? a->getAnimeType() : getCachedData(aidA).typeName();
-				QString typeB = b ? b->getAnimeType() : getCachedData(aidB).typeName();
-				
-				// Hidden cards always go to the bottom
-				if (hiddenA != hiddenB) {
-					return hiddenB;  // non-hidden comes before hidden
-				}
-				
-				if (typeA == typeB) {
-					return titleA < titleB;
-				}
-				if (sortAscending) {
-					return typeA < typeB;
-				} else {
-					return typeA > typeB;
-				}
-			});
-			break;
-		case 2: // Aired Date
-			std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending](int aidA, int aidB) {
-				AnimeCard* a = cardsMap.value(aidA);
-				AnimeCard* b = cardsMap.value(aidB);
-				
-				// Get data from cards or cache
-				bool hiddenA = a ? a->isHidden() : getCachedData(aidA).isHidden();
-				bool hiddenB = b ? b->isHidden() : getCachedData(aidB).isHidden();
-				QString titleA = a ? a->getAnimeTitle() : getCachedData(aidA).animeName();
-				QString titleB = b ? b->getAnimeTitle() : getCachedData(aidB).animeName();
-				
-				// Hidden cards always go to the bottom
-				if (hiddenA != hiddenB) {
-					return hiddenB;  // non-hidden comes before hidden
-				}
-				
-				// Get aired dates
-				aired airedA, airedB;
-				if (a) {
-					airedA = a->getAired();
-				} else {
-					MyListCardManager::CachedAnimeData cachedA = getCachedData(aidA);
-					airedA = aired(cachedA.startDate(), cachedA.endDate());
-				}
-				if (b) {
-					airedB = b->getAired();
-				} else {
-					MyListCardManager::CachedAnimeData cachedB = getCachedData(aidB);
-					airedB = aired(cachedB.startDate(), cachedB.endDate());
-				}
-				
-				// Handle invalid dates (put at end)
-				if (!airedA.isValid() && !airedB.isValid()) {
-					return titleA < titleB;
-				}
-				if (!airedA.isValid()) {
-					return false;  // a goes after b
-				}
-				if (!airedB.isValid()) {
-					return true;   // a goes before b
-				}
-				
-				// Use aired class comparison operators
-				if (airedA == airedB) {
-					return titleA < titleB;
-				}
-				if (sortAscending) {
-					return airedA < airedB;
-				} else {
-					return airedA > airedB;
-				}
-			});
-			break;
-		case 3: // Episodes (Count)
-			std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending](int aidA, int aidB) {
-				AnimeCard* a = cardsMap.value(aidA);
-				AnimeCard* b = cardsMap.value(aidB);
-				
-				// Get data from cards or cache
-				bool hiddenA = a ? a->isHidden() : getCachedData(aidA).isHidden();
-				bool hiddenB = b ? b->isHidden() : getCachedData(aidB).isHidden();
-				QString titleA = a ? a->getAnimeTitle() : getCachedData(aidA).animeName();
-				QString titleB = b ? b->getAnimeTitle() : getCachedData(aidB).animeName();
-				
-				// Hidden cards always go to the bottom
-				if (hiddenA != hiddenB) {
-					return hiddenB;  // non-hidden comes before hidden
-				}
-				
-				int episodesA, episodesB;
-				if (a) {
-					episodesA = a->getNormalEpisodes() + a->getOtherEpisodes();
-				} else {
-					MyListCardManager::CachedAnimeData cachedA = getCachedData(aidA);
-					episodesA = cachedA.stats().normalEpisodes() + cachedA.stats().otherEpisodes();
-				}
-				if (b) {
-					episodesB = b->getNormalEpisodes() + b->getOtherEpisodes();
-				} else {
-					MyListCardManager::CachedAnimeData cachedB = getCachedData(aidB);
-					episodesB = cachedB.stats().normalEpisodes() + cachedB.stats().otherEpisodes();
-				}
-				
-				if (episodesA == episodesB) {
-					return titleA < titleB;
-				}
-				if (sortAscending) {
-					return episodesA < episodesB;
-				} else {
-					return episodesA > episodesB;
-				}
-			});
-			break;
-		case 4: // Completion %
-			std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending](int aidA, int aidB) {
-				AnimeCard* a = cardsMap.value(aidA);
-				AnimeCard* b = cardsMap.value(aidB);
-				
-				// Get data from cards or cache
-				bool hiddenA = a ? a->isHidden() : getCachedData(aidA).isHidden();
-				bool hiddenB = b ? b->isHidden() : getCachedData(aidB).isHidden();
-				QString titleA = a ? a->getAnimeTitle() : getCachedData(aidA).animeName();
-				QString titleB = b ? b->getAnimeTitle() : getCachedData(aidB).animeName();
-				
-				// Hidden cards always go to the bottom
-				if (hiddenA != hiddenB) {
-					return hiddenB;  // non-hidden comes before hidden
-				}
-				
-				int totalEpisodesA, totalEpisodesB, viewedA, viewedB;
-				if (a) {
-					totalEpisodesA = a->getNormalEpisodes() + a->getOtherEpisodes();
-					viewedA = a->getNormalViewed() + a->getOtherViewed();
-				} else {
-					MyListCardManager::CachedAnimeData cachedA = getCachedData(aidA);
-					totalEpisodesA = cachedA.stats().normalEpisodes() + cachedA.stats().otherEpisodes();
-					viewedA = cachedA.stats().normalViewed() + cachedA.stats().otherViewed();
-				}
-				if (b) {
-					totalEpisodesB = b->getNormalEpisodes() + b->getOtherEpisodes();
-					viewedB = b->getNormalViewed() + b->getOtherViewed();
-				} else {
-					MyListCardManager::CachedAnimeData cachedB = getCachedData(aidB);
-					totalEpisodesB = cachedB.stats().normalEpisodes() + cachedB.stats().otherEpisodes();
-					viewedB = cachedB.stats().normalViewed() + cachedB.stats().otherViewed();
-				}
-				
-				double completionA = (totalEpisodesA > 0) ? static_cast<double>(viewedA) / totalEpisodesA : 0.0;
-				double completionB = (totalEpisodesB > 0) ? static_cast<double>(viewedB) / totalEpisodesB : 0.0;
-				if (completionA == completionB) {
-					return titleA < titleB;
-				}
-				if (sortAscending) {
-					return completionA < completionB;
-				} else {
-					return completionA > completionB;
-				}
-			});
-			break;
-		case 5: // Last Played
-			std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending](int aidA, int aidB) {
-				AnimeCard* a = cardsMap.value(aidA);
-				AnimeCard* b = cardsMap.value(aidB);
-				
-				// Get data from cards or cache
-				bool hiddenA = a ? a->isHidden() : getCachedData(aidA).isHidden();
-				bool hiddenB = b ? b->isHidden() : getCachedData(aidB).isHidden();
-				QString titleA = a ? a->getAnimeTitle() : getCachedData(aidA).animeName();
-				QString titleB = b ? b->getAnimeTitle() : getCachedData(aidB).animeName();
-				
-				// Hidden cards always go to the bottom
-				if (hiddenA != hiddenB) {
-					return hiddenB;  // non-hidden comes before hidden
-				}
-				
-				qint64 lastPlayedA = a ? a->getLastPlayed() : getCachedData(aidA).lastPlayed();
-				qint64 lastPlayedB = b ? b->getLastPlayed() : getCachedData(aidB).lastPlayed();
-				
-				// Never played items (0) go to the end regardless of sort order
-				if (lastPlayedA == 0 && lastPlayedB == 0) {
-					return titleA < titleB;
-				}
-				if (lastPlayedA == 0) {
-					return false;  // a goes after b
-				}
-				if (lastPlayedB == 0) {
-					return true;   // a goes before b
-				}
-				
-				if (sortAscending) {
-					return lastPlayedA < lastPlayedB;
-				} else {
-					return lastPlayedA > lastPlayedB;
-				}
-			});
-			break;
-		case 6: // Recent Episode Air Date
-			{
-				// Get current timestamp once to avoid repeated system calls during sorting
-				const qint64 currentTimestamp = QDateTime::currentSecsSinceEpoch();
-				
-				std::sort(animeIds.begin(), animeIds.end(), [&cardsMap, &getCachedData, sortAscending, currentTimestamp](int aidA, int aidB) {
-					// Get data from cache (cards don't directly expose air date)
-					const MyListCardManager::CachedAnimeData cachedA = getCachedData(aidA);
-					const MyListCardManager::CachedAnimeData cachedB = getCachedData(aidB);
-					
-					const bool hiddenA = cachedA.isHidden();
-					const bool hiddenB = cachedB.isHidden();
-					
-					// Hidden cards always go to the bottom
-					if (hiddenA != hiddenB) {
-						return hiddenB;  // non-hidden comes before hidden
-					}
-					
-					const qint64 airDateA = cachedA.recentEpisodeAirDate();
-					const qint64 airDateB = cachedB.recentEpisodeAirDate();
-					
-					// Check if anime haven't aired yet (air date is in the future)
-					bool notYetAiredA = (airDateA > 0 && airDateA > currentTimestamp);
-					bool notYetAiredB = (airDateB > 0 && airDateB > currentTimestamp);
-					
-					// Not-yet-aired anime go to the end regardless of sort order
-					if (notYetAiredA != notYetAiredB) {
-						return notYetAiredB;  // aired comes before not-yet-aired
-					}
-					
-					// Episodes with no air date (0) go to the end regardless of sort order
-					if (airDateA == 0 && airDateB == 0) {
-						const QString titleA = cachedA.animeName();
-						const QString titleB = cachedB.animeName();
-						return titleA < titleB;
-					}
-					if (airDateA == 0) {
-						return false;  // a goes after b
-					}
-					if (airDateB == 0) {
-						return true;   // a goes before b
-					}
-					
-					if (sortAscending) {
-						return airDateA < airDateB;
-					} else {
-						return airDateA > airDateB;
-					}
-				});
-			}
-			break;
-	}
+	// Sort keys come from the card manager's columnar metadata store, so this works with
+	// virtual scrolling where card widgets may not exist
+	animeIds = cardManager->sortAnimeIds(animeIds, sortCriteria, sortAscending);
 	
 	// Update the card manager with the new order
 	cardManager->setAnimeIdList(animeIds, false);  // Chain mode is disabled when in regular sorting mode
@@ -4169,6 +4286,9 @@ void Window::sortMylistCards(int sortIndex)
 	if (mylistVirtualLayout) {
 		mylistVirtualLayout->refresh();
 	}
+	if (mylistCardModel) {
+		mylistCardModel->reload();
+	}
 	
 	// Also update the legacy animeCards list order for backward compatibility
 	animeCards.clear();
@@ -4716,67 +4836,33 @@ void Window::applyMylistFilters()
 		}
 	}
 	
-	QList<int> filteredAnimeIds;
 	int totalCount = allAnimeIds.size();
 	
-	// Build composite filter using new filter classes
-	CompositeFilter composite;
-	
-	// Add search filter if text is provided
-	if (!searchText.isEmpty()) {
-		composite.addFilter(new SearchFilter(searchText, &animeAlternativeTitlesCache));
-	}
-	
-	// Add type filter if specified
-	if (!typeFilter.isEmpty()) {
-		composite.addFilter(new TypeFilter(typeFilter));
-	}
-	
-	// Add completion filter if specified
-	if (!completionFilter.isEmpty()) {
-		composite.addFilter(new CompletionFilter(completionFilter));
+	// Apply "In My List" filter first - this is a quick check using the set
+	QList<int> candidateAnimeIds;
+	if (inMyListOnly) {
+		candidateAnimeIds.reserve(allAnimeIds.size());
+		for (int aid : std::as_const(allAnimeIds)) {
+			if (mylistAnimeIdSet.contains(aid)) {
+				candidateAnimeIds.append(aid);
+			}
+		}
+	} else {
+		candidateAnimeIds = allAnimeIds;
 	}
 	
-	// Add unwatched filter if enabled
-	if (showOnlyUnwatched) {
-		composite.addFilter(new UnwatchedFilter(true));
-	}
+	// The remaining filters are answered by the card manager's bitmap index
+	// (built from cached data, so it works with virtual scrolling where cards may not exist)
+	AnimeFilterIndex::Criteria filterCriteria;
+	filterCriteria.searchText = searchText;
+	filterCriteria.typeFilter = typeFilter;
+	filterCriteria.completionFilter = completionFilter;
+	filterCriteria.showOnlyUnwatched = showOnlyUnwatched;
+	filterCriteria.adultContentFilter = adultContentFilter;
 	
-	// Add adult content filter
-	composite.addFilter(new AdultContentFilter(adultContentFilter));
+	LOG(QString("[Window] Applying filters: %1").arg(filterCriteria.description()));
 	
-	LOG(QString("[Window] Applying filters: %1").arg(composite.description()));
-	
-	// Apply filters to determine which anime to show
-	// Use cached data when card widgets don't exist (virtual scrolling)
-	for (int aid : allAnimeIds) {
-		// Apply "In My List" filter first - this is a quick check using the set
-		if (inMyListOnly && !mylistAnimeIdSet.contains(aid)) {
-			// This anime is not in mylist, skip it
-			continue;
-		}
-		
-		// Try to get data from existing card first, then fall back to cached data
-		AnimeCard* card = cardsMap.value(aid);
-		MyListCardManager::CachedAnimeData cachedData;
-		
-		// Get cached data for filtering - essential for virtual scrolling
-		if (!card) {
-			cachedData = cardManager->getCachedAnimeData(aid);
-			if (!cachedData.hasData()) {
-				// No card and no cached data - skip it (can't apply filters properly)
-				continue;
-			}
-		}
-		
-		// Create data accessor for unified access to card/cached data
-		AnimeDataAccessor accessor(aid, card, cachedData);
-		
-		// Apply all filters at once using composite filter
-		if (composite.matches(accessor)) {
-			filteredAnimeIds.append(aid);
-		}
-	}
+	QList<int> filteredAnimeIds = cardManager->filterAnimeIds(candidateAnimeIds, filterCriteria, &animeAlternativeTitlesCache);
 	
 	// Update the card manager with the filtered list and chain mode flag
 	// This will build chains if showSeriesChain is true and expand them as needed
@@ -4808,6 +4894,9 @@ void Window::applyMylistFilters()
 		// Trigger repaint for arrow drawing
 		mylistVirtualLayout->update();
 	}
+	if (mylistCardModel) {
+		mylistCardModel->reload();
+	}
 	
 	// For backward compatibility with non-virtual scrolling
 	if (!mylistVirtualLayout && mylistCardLayout) {
@@ -5082,6 +5171,8 @@ void Window::onApplicationAboutToQuit()
     // This handles external termination (e.g., Qt Creator stop button, kill signals)
     // where closeEvent might be bypassed or ignored due to close-to-tray logic
     
+    saveCardDataSnapshot();
+    
     if (adbapi && adbapi->LoggedIn()) {
         LOG("Application terminating while logged in, sending LOGOUT command");
         adbapi->Logout();
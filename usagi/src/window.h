@@ -16,6 +16,7 @@
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 #include <QtWidgets/QTableWidget>
+#include <QtWidgets/QTableView>
 #include <QtWidgets/QBoxLayout>
 #include <QtWidgets/QTextEdit>
 #include <QtWidgets/QProgressBar>
@@ -71,6 +72,7 @@
 // Forward declarations
 class MyListCardManager;
 class VirtualFlowLayout;
+class AnimeCardModel;
 class WatchSessionManager;
 class HasherCoordinator;
 class TrayIconManager;
@@ -86,7 +88,7 @@ class DeletionHistoryManager;
 class CurrentChoiceWidget;
 class Window;  // Forward declaration for friend access
 
-class hashes_ : public QTableWidget
+class hashes_ : public QTableView
 {
 	Q_OBJECT
 public:
@@ -304,6 +306,10 @@ private:
     QWidget *mylistCardContainer;
     FlowLayout *mylistCardLayout;
     VirtualFlowLayout *mylistVirtualLayout;  // Virtual scrolling layout for efficient rendering
+    QListView *mylistCardGridView;  // Delegate-painted card grid, replaces the virtual layout when enabled (null otherwise)
+    AnimeCardModel *mylistCardModel;  // Model of mylistCardGridView
+    QPersistentModelIndex mylistCardGridEditorIndex;  // Grid row currently shown as a real card
+    void refreshMylistGridEditor(int aid);  // Rebuild the real card of the grid if it shows this anime
     QLabel *mylistStatusLabel;
     bool mylistSortAscending;  // Deprecated: moved to MyListFilterSidebar::getSortAscending() - still used at window.cpp:334 (migration incomplete)
     bool lastInMyListState;  // Track previous "In MyList" filter state for reload detection
@@ -333,6 +339,9 @@ private:
     // Auto-start settings
     QCheckBox *autoStartEnabled;
     
+    // MyList view settings
+    QCheckBox *paintedCardGridEnabled;
+    
     // Playback settings
     QLineEdit *mediaPlayerPath;
     QPushButton *mediaPlayerBrowseButton;
@@ -388,6 +397,7 @@ private:
 	FactorWeightLearner *factorWeightLearner;
 	HybridDeletionClassifier *hybridDeletionClassifier;
 	DeletionQueue *deletionQueue;
+	bool m_deletionCyclePending;  // deletionCycleRequested waits for the next queueRebuilt
 	DeletionHistoryManager *deletionHistoryManager;
 	CurrentChoiceWidget *currentChoiceWidget;
 	QWidget *pageCurrentChoiceParent;
@@ -421,6 +431,7 @@ private:
 
 public slots:
     void getNotifyLogAppend(QString);
+    void getNotifyLogBatch(const QStringList &lines);
     void getNotifyLoginChagned(QString);
     void getNotifyPasswordChagned(QString);
     void hasherFinished();
@@ -520,10 +531,31 @@ private:
     AnimeMetadataCache animeAlternativeTitlesCache;  // aid -> alternative titles
     void loadAnimeAlternativeTitlesForFiltering();
     void updateAnimeAlternativeTitlesInCache(int aid);  // Update single anime in cache
+    
+    // Binary startup snapshot of card data, chains and the title index (see CardDataSnapshot)
+    bool loadCardDataSnapshot(bool &titlesRestored);
+    void saveCardDataSnapshot();
+    void applyCardSnapshotDeltas();
+    QList<int> pendingSnapshotDeltaAids;  // Anime changed since the snapshot was written, applied after first paint
+    qint64 pendingSnapshotDeltaGeneration = -1;  // Database generation the pending deltas were listed at
+    qint64 cardDataSyncedGeneration = -1;  // Generation the whole card cache was read at, -1 while deltas are pending
+    
+    // Mylist load without snapshot: cards on screen are loaded first, the rest in chunks of
+    // MYLIST_PRELOAD_CHUNK anime, one per event-loop turn, so the skeleton cards stay usable
+    static constexpr int MYLIST_PRELOAD_CHUNK = 200;
+    void scheduleMylistPreloadChunk();
+    void preloadNextMylistChunk();
+    QList<int> onScreenAnimeIdsWithoutData() const;
+    void finishMylistPreload();
+    void completeMylistLoading(int animeCount, bool titlesRestored);
+    QList<int> pendingMylistPreloadAids;  // Mylist of the load waiting for finishMylistPreload()
+    QList<int> mylistPreloadQueue;        // Anime of that load whose data is not loaded yet
+    int mylistPreloadGeneration = 0;      // Bumped per mylist load; stale chunks stop
     void addAnimeTitlesToList(QStringList& titles, const QString& romaji, const QString& english,
                               const QString& other, const QString& shortNames, const QString& synonyms);  // Helper for title parsing
     
     bool validateDatabaseConnection(const QSqlDatabase& db, const QString& methodName);
+    void runDeletionCycle();
     void debugPrintDatabaseInfoForLid(int lid);
     
     // Helper methods for playback